@@ -24,35 +24,256 @@
 *
 **********************************************************************************************************************/
 
-/* generic includes for the NodeStateAccess library        */
-#include "gio/gio.h"         /* glib types                 */
-#include "NodeStateAccess.h" /* own header                 */
-#include "NodeStateTypes.h"  /* Type defintions of the NSM */
-#include <glib-unix.h>       /* Catch SIGTERM              */
+/* generic includes for the NodeStateAccess library              */
+#include "gio/gio.h"             /* glib types                 */
+#include "NodeStateAccess.h"     /* own header                 */
+#include "NodeStateTypes.h"      /* Type defintions of the NSM */
+#include "NodeStateStatistics.h" /* Method and signal counters */
+#include <glib-unix.h>           /* Catch SIGTERM              */
 
 /* additional includes to use D-Bus                                            */
 #include "string.h"                      /* memcpy, memset, etc.               */
+#ifdef NSMA_P2P_SOCKET
+#include <glib/gstdio.h>                 /* g_unlink, g_chmod                  */
+#include <sys/socket.h>                  /* getsockopt(SO_PEERCRED)            */
+#include <unistd.h>                      /* geteuid                            */
+#endif
 #include "NodeStateConsumer.h"           /* generated NodeStateConsumer object */
 #include "NodeStateLifecycleControl.h"   /* generated LifecycleControl  object */
 #include "NodeStateLifecycleConsumer.h"  /* generated LifecycleConsumer object */
 
 
+/**********************************************************************************************************************
+*
+* Local defines, macros and type definitions.
+*
+**********************************************************************************************************************/
+
+/* Resolution of the "WaitForNodeState" timeouts. Deadlines are rounded up, so that close timeouts share a sweep */
+#define NSMA__WAITER_RESOLUTION_US 50000
+
+/* NSM_NODESTATE_MASK bits of all valid NodeStates (StartUp to Suspended) */
+#define NSMA__NODESTATE_VALID_MASK (NSM_NODESTATE_MASK(NsmNodeState_Last) - NSM_NODESTATE_MASK(NsmNodeState_StartUp))
+
+/* Default token bucket of a D-Bus caller (see NSMA_boSetRateLimit). The limit is disabled, until it is configured */
+#define NSMA__RATE_LIMIT_DEFAULT 0
+#define NSMA__RATE_BURST_DEFAULT 0
+
+/* Priorities of the work dispatched in the core context. GLib only dispatches the sources of the highest ready
+ * priority. Like this, lifecycle traffic (lifecycle control, answers and timeouts of lifecycle clients) always runs
+ * before the registration of clients, which again runs before session traffic. Calls of one class keep their order.
+ * Replies of lifecycle clients to "LifecycleRequest" are dispatched by GIO with G_PRIORITY_DEFAULT.
+ */
+#define NSMA__PRIORITY_LIFECYCLE G_PRIORITY_HIGH
+#define NSMA__PRIORITY_CLIENT    G_PRIORITY_DEFAULT
+#define NSMA__PRIORITY_SESSION   G_PRIORITY_LOW
+
+/* Size of the key of a peer-to-peer caller ("peer@<connection>"). Peers have no unique bus name. */
+#define NSMA__PEER_KEY_LENGTH 32
+
+/* The type defines the structure for a pending call of a life cycle clients "LifecycleRequest" method */
+typedef struct
+{
+  NodeStateLifeCycleConsumer *pConsumer;  /* Proxy of the called lifecycle client              */
+  guint                       u32TimerId; /* Timer started, if client returned ResponsePending */
+} NSMA__tstLcRequest;
+
+/* The type defines a pending check, whether a bus name has an owner */
+typedef struct
+{
+  gchar                  *sBusName;   /* Checked bus name                 */
+  NSMA_tpfBusNameCheckCb  pfCallback; /* Callback that receives the result */
+  gpointer                pUserData;  /* User data of the callback         */
+} NSMA__tstBusNameCheck;
+
+/* The type defines a method handler, which is called in the core context. It is the data of the queue closure. */
+typedef struct
+{
+  GClosure *pCoreClosure;   /* Closure of the method handler that will be invoked in the core context */
+  gint      i32Priority;    /* Priority, with which calls of the method are dispatched in the core    */
+} NSMA__tstCoreHandler;
+
+/* The type defines a D-Bus method call, which has been received by the D-Bus thread and is queued for the core */
+typedef struct
+{
+  GClosure *pCoreClosure;   /* Closure of the method handler that will be invoked in the core context */
+  guint     u32ParamCount;  /* Number of parameters in 'pParams'                                      */
+  GValue   *pParams;        /* Copy of the signal parameters (object, invocation, method arguments)  */
+} NSMA__tstCoreCall;
+
+/* The type defines a method call, which has been queued for the core and has not been dispatched yet */
+typedef struct
+{
+  GSource     *pSource;     /* Idle source in the core context, which invokes the method handler */
+  GSourceFunc  pfCallback;  /* Function that invokes the method handler                          */
+  gpointer     pUserData;   /* Queued call (NSMA__tstCoreCall or GDBusMethodInvocation)          */
+  GList       *pLink;       /* Entry of the call in NSMA__stCoreCalls. Removed without a search  */
+} NSMA__tstQueuedCall;
+
+/* The type defines a client, which waits with "WaitForNodeState" until the NodeState is one of a set of states */
+typedef struct
+{
+  GDBusMethodInvocation *pInvocation;      /* Deferred method invocation, returned when done          */
+  guint32                u32NodeStateMask; /* NSM_NODESTATE_MASK bits of the states the client waits for */
+  gint64                 i64Deadline;      /* Monotonic time (us), when the call times out              */
+} NSMA__tstNodeStateWaiter;
+
+/* The type defines the accounting of a caller. Callers are identified by their unique bus name (or connection) */
+typedef struct
+{
+  gchar   *sName;         /* Unique bus name or "peer@<connection>". Key of NSMA__pSenders */
+  guint    u32Pid;        /* PID of the caller. 0 until it has been received               */
+  guint    u32Uid;        /* UID of the caller. G_MAXUINT until it has been received       */
+  guint    u32Calls;      /* Number of admitted calls                                      */
+  guint    u32Rejected;   /* Number of calls rejected, because the caller was over quota   */
+  guint64  u64HandlingNs; /* Time spent in the method handlers for the caller              */
+  gdouble  dTokens;       /* Tokens left in the bucket of the caller. A call costs 1 token */
+  gint64   i64Refill;     /* Monotonic time (us), when the bucket has been refilled        */
+} NSMA__tstSender;
+
+/* The type defines a measured method call. The invocation is referenced, to account the time to its caller. */
+typedef struct
+{
+  NSMA_tstStatProbe      stProbe;     /* Latency and CPU time of the handler */
+  GDBusMethodInvocation *pInvocation; /* Invocation of the measured call     */
+} NSMA__tstCallStat;
+
+/* The type defines the methods and signals, for which statistics are collected. See NSMA__asStatNames. */
+typedef enum
+{
+  NSMA__enStat_SetBootMode,
+  NSMA__enStat_SetNodeState,
+  NSMA__enStat_SetApplicationMode,
+  NSMA__enStat_RequestNodeRestart,
+  NSMA__enStat_CheckLucRequired,
+  NSMA__enStat_SetAppHealthStatus,
+  NSMA__enStat_RequestSeatLifecycle,
+  NSMA__enStat_Reexec,
+  NSMA__enStat_GetNodeState,
+  NSMA__enStat_WaitForNodeState,
+  NSMA__enStat_SetSessionState,
+  NSMA__enStat_GetSessionState,
+  NSMA__enStat_GetApplicationMode,
+  NSMA__enStat_RegisterShutdownClient,
+  NSMA__enStat_RegisterSeatShutdownClient,
+  NSMA__enStat_RegisterLoadSheddingClient,
+  NSMA__enStat_UnRegisterShutdownClient,
+  NSMA__enStat_RegisterSession,
+  NSMA__enStat_UnRegisterSession,
+  NSMA__enStat_GetAppHealthCount,
+  NSMA__enStat_GetInterfaceVersion,
+  NSMA__enStat_GetStatistics,
+  NSMA__enStat_GetClientStatistics,
+  NSMA__enStat_LifecycleRequestComplete,
+  NSMA__enStat_SignalNodeState,
+  NSMA__enStat_SignalNodeApplicationMode,
+  NSMA__enStat_SignalSessionStateChanged,
+  NSMA__enStat_LucRunup,
+  NSMA__enStat_Last
+} NSMA__tenStatId;
+
+#ifdef NSMA_P2P_SOCKET
+/* The type defines a peer that is connected directly to the NSM via the UNIX socket NSMA_P2P_SOCKET */
+typedef struct
+{
+  GDBusConnection *pConnection;      /* Peer-to-peer connection                                        */
+  guint            u32ConsumerRegId; /* Registration of the Consumer vtable. 0 if the skeleton is used */
+} NSMA__tstPeer;
+#endif
+
+
 /**********************************************************************************************************************
 *
 * Local variables
 *
 **********************************************************************************************************************/
 
-/* Variables to handle main loop and bus connection */
+/* Variables to handle main loop and bus connection. The core (NSM, NSMC, lifecycle calls) runs in the default
+ * context. D-Bus I/O and the dispatch of incoming method calls run in a separate thread with an own context.
+ */
 static GMainLoop                  *NSMA__pMainLoop             = NULL;
+static GMainContext               *NSMA__pDbusContext          = NULL;
+static GMainLoop                  *NSMA__pDbusLoop             = NULL;
+static GThread                    *NSMA__pDbusThread           = NULL;
 static GDBusConnection            *NSMA__pBusConnection        = NULL;
 static gboolean                    NSMA__boLoopEndByUser       = FALSE;
 static guint                       NSMA__u32ConnectionId       = 0;
 static gboolean                    NSMA__boInitialized         = FALSE;
-
-/* Variables to handle life cycle client calls */
-static guint                       NSMA__u32TimerId            = 0;
-static NodeStateLifeCycleConsumer *NSMA__pCurrentLcConsumer    = NULL;
+static gboolean                    NSMA__boReplaceBusName      = FALSE;
+
+/* Method calls queued by the D-Bus thread for the core (NSMA__tstQueuedCall). When the core loop has ended, the calls
+ * that have not been dispatched are rejected. Like this, every caller gets an answer before the NSM stops.
+ */
+static GMutex                     *NSMA__pCoreCallsMutex       = NULL;
+static GQueue                      NSMA__stCoreCalls           = G_QUEUE_INIT;
+static gboolean                    NSMA__boRejectCoreCalls     = FALSE; /* Only accessed in the core context */
+
+/* Variables to handle life cycle client calls. Several clients can be called in parallel */
+static GSList                     *NSMA__pLcRequests           = NULL;
+
+/* Clients waiting with "WaitForNodeState" (NSMA__tstNodeStateWaiter). Waiters are added and timed out in the D-Bus
+ * thread and completed by the core, therefore the table is protected by a mutex. The number of waiters per NodeState
+ * allows the core to skip the table, if nobody waits for the new state. One timer is armed for the earliest deadline.
+ */
+static GMutex                     *NSMA__pWaitersMutex         = NULL;
+static GList                      *NSMA__pWaiters              = NULL;
+static guint                       NSMA__au32WaitersPerState[NsmNodeState_Last];
+static GSource                    *NSMA__pWaiterTimer          = NULL;
+static gint64                      NSMA__i64WaiterTimerDeadline = 0;
+
+/* Statistics of the method handlers and signal emissions. The counters are only accessed with atomic operations */
+static NSMA_tstStatCounter         NSMA__astStatCounters[NSMA__enStat_Last];
+
+/* Names of the statistics entries. Methods are named like the D-Bus methods, signals get the prefix "Signal" */
+static const gchar * const         NSMA__asStatNames[NSMA__enStat_Last] =
+{
+  [NSMA__enStat_SetBootMode]                = "SetBootMode",
+  [NSMA__enStat_SetNodeState]               = "SetNodeState",
+  [NSMA__enStat_SetApplicationMode]         = "SetApplicationMode",
+  [NSMA__enStat_RequestNodeRestart]         = "RequestNodeRestart",
+  [NSMA__enStat_CheckLucRequired]           = "CheckLucRequired",
+  [NSMA__enStat_SetAppHealthStatus]         = "SetAppHealthStatus",
+  [NSMA__enStat_RequestSeatLifecycle]       = "RequestSeatLifecycle",
+  [NSMA__enStat_Reexec]                     = "Reexec",
+  [NSMA__enStat_GetNodeState]               = "GetNodeState",
+  [NSMA__enStat_WaitForNodeState]           = "WaitForNodeState",
+  [NSMA__enStat_SetSessionState]            = "SetSessionState",
+  [NSMA__enStat_GetSessionState]            = "GetSessionState",
+  [NSMA__enStat_GetApplicationMode]         = "GetApplicationMode",
+  [NSMA__enStat_RegisterShutdownClient]     = "RegisterShutdownClient",
+  [NSMA__enStat_RegisterSeatShutdownClient] = "RegisterSeatShutdownClient",
+  [NSMA__enStat_RegisterLoadSheddingClient] = "RegisterLoadSheddingClient",
+  [NSMA__enStat_UnRegisterShutdownClient]   = "UnRegisterShutdownClient",
+  [NSMA__enStat_RegisterSession]            = "RegisterSession",
+  [NSMA__enStat_UnRegisterSession]          = "UnRegisterSession",
+  [NSMA__enStat_GetAppHealthCount]          = "GetAppHealthCount",
+  [NSMA__enStat_GetInterfaceVersion]        = "GetInterfaceVersion",
+  [NSMA__enStat_GetStatistics]              = "GetStatistics",
+  [NSMA__enStat_GetClientStatistics]        = "GetClientStatistics",
+  [NSMA__enStat_LifecycleRequestComplete]   = "LifecycleRequestComplete",
+  [NSMA__enStat_SignalNodeState]            = "SignalNodeState",
+  [NSMA__enStat_SignalNodeApplicationMode]  = "SignalNodeApplicationMode",
+  [NSMA__enStat_SignalSessionStateChanged]  = "SignalSessionStateChanged",
+  [NSMA__enStat_LucRunup]                   = "LucRunup"
+};
+
+/* Accounting of the callers (NSMA__tstSender). Calls are admitted in the D-Bus thread and accounted in the thread
+ * that handled them, therefore the table and the rate limit are protected by a mutex. A rate of 0 disables the limit.
+ */
+static GMutex                     *NSMA__pSendersMutex         = NULL;
+static GHashTable                 *NSMA__pSenders              = NULL;
+static guint                       NSMA__u32RateLimit          = NSMA__RATE_LIMIT_DEFAULT;
+static guint                       NSMA__u32RateBurst          = NSMA__RATE_BURST_DEFAULT;
+static guint                       NSMA__u32NameOwnerSubId     = 0;
+
+/* Consumer methods that are not rate limited. Lifecycle clients must always be able to register and answer.
+ * Methods of the LifecycleControl interface are never limited.
+ */
+static const gchar * const         NSMA__asRateLimitExempt[]   = {"RegisterShutdownClient",
+                                                                   "RegisterSeatShutdownClient",
+                                                                   "RegisterLoadSheddingClient",
+                                                                   "UnRegisterShutdownClient",
+                                                                   "LifecycleRequestComplete"};
 
 /* Variables for D-Bus objects */
 static NodeStateConsumer          *NSMA__pNodeStateConsumerObj = NULL;
@@ -61,6 +282,18 @@ static NodeStateLifecycleControl  *NSMA__pLifecycleControlObj  = NULL;
 /* Structure with callback functions to the NSM */
 static NSMA_tstObjectCallbacks     NSMA__stObjectCallbacks     = {0};
 
+/* Registration of the Consumer interface on the bus, if it is dispatched via the hand-written vtable */
+static guint                       NSMA__u32ConsumerRegId      = 0;
+
+#ifdef NSMA_P2P_SOCKET
+/* Server for peer-to-peer connections and list of connected peers (NSMA__tstPeer). The list is changed in the
+ * D-Bus thread and read by the core to send signals, therefore it is protected by a mutex.
+ */
+static GDBusServer                *NSMA__pPeerServer           = NULL;
+static GSList                     *NSMA__pPeers                = NULL;
+static GMutex                     *NSMA__pPeersMutex           = NULL;
+#endif
+
 
 /**********************************************************************************************************************
 *
@@ -89,6 +322,14 @@ static gboolean NSMA__boOnHandleRequestNodeRestart       (NodeStateLifecycleCont
 static gboolean NSMA__boOnHandleCheckLucRequired         (NodeStateLifecycleControl *pLifecycleControl,
                                                           GDBusMethodInvocation     *pInvocation,
                                                           gpointer                  pUserData);
+static gboolean NSMA__boOnHandleRequestSeatLifecycle     (NodeStateLifecycleControl *pLifecycleControl,
+                                                          GDBusMethodInvocation     *pInvocation,
+                                                          const gint                 i32SeatId,
+                                                          const guint                u32RequestType,
+                                                          gpointer                   pUserData);
+static gboolean NSMA__boOnHandleReexec                   (NodeStateLifecycleControl *pLifecycleControl,
+                                                          GDBusMethodInvocation     *pInvocation,
+                                                          gpointer                   pUserData);
 static gboolean NSMA__boOnHandleRegisterSession          (NodeStateConsumer         *pConsumer,
                                                           GDBusMethodInvocation     *pInvocation,
                                                           const gchar               *sSessionName,
@@ -109,6 +350,21 @@ static gboolean NSMA__boOnHandleRegisterLifecycleClient  (NodeStateConsumer
                                                           const guint                u32ShutdownMode,
                                                           const guint                u32TimeoutMs,
                                                           gpointer                   pUserData);
+static gboolean NSMA__boOnHandleRegisterSeatLifecycleClient(NodeStateConsumer       *pConsumer,
+                                                            GDBusMethodInvocation   *pInvocation,
+                                                            const gchar*             sBusName,
+                                                            const gchar*             sObjName,
+                                                            const guint              u32ShutdownMode,
+                                                            const guint              u32TimeoutMs,
+                                                            const gint               i32SeatId,
+                                                            gpointer                 pUserData);
+static gboolean NSMA__boOnHandleRegisterLoadSheddingClient(NodeStateConsumer       *pConsumer,
+                                                            GDBusMethodInvocation   *pInvocation,
+                                                            const gchar*             sBusName,
+                                                            const gchar*             sObjName,
+                                                            const guint              u32ShedLevel,
+                                                            const guint              u32TimeoutMs,
+                                                            gpointer                 pUserData);
 static gboolean NSMA__boOnHandleUnRegisterLifecycleClient(NodeStateConsumer         *pConsumer,
                                                           GDBusMethodInvocation     *pInvocation,
                                                           const gchar*               sBusName,
@@ -149,18 +405,157 @@ static gboolean NSMA__boOnHandleGetAppHealthCount        (NodeStateConsumer
 static gboolean NSMA__boOnHandleGetInterfaceVersion      (NodeStateConsumer         *pConsumer,
                                                           GDBusMethodInvocation     *pInvocation,
                                                           gpointer                   pUserData);
+static gboolean NSMA__boOnHandleWaitForNodeState         (NodeStateConsumer         *pConsumer,
+                                                          GDBusMethodInvocation     *pInvocation,
+                                                          const guint                u32NodeStateMask,
+                                                          const guint                u32TimeoutMs,
+                                                          gpointer                   pUserData);
+static gboolean NSMA__boOnHandleGetStatistics            (NodeStateConsumer         *pConsumer,
+                                                          GDBusMethodInvocation     *pInvocation,
+                                                          const gboolean             boReset,
+                                                          gpointer                   pUserData);
+static gboolean NSMA__boOnHandleGetClientStatistics      (NodeStateConsumer         *pConsumer,
+                                                          GDBusMethodInvocation     *pInvocation,
+                                                          gpointer                   pUserData);
 
 /* Internal bus connection callbacks */
 static void NSMA__vOnBusAcquired (GDBusConnection *pConnection, const gchar* sName, gpointer pUserData);
 static void NSMA__vOnNameAcquired(GDBusConnection *pConnection, const gchar* sName, gpointer pUserData);
 static void NSMA__vOnNameLost    (GDBusConnection *pConnection, const gchar* sName, gpointer pUserData);
 
-/* Linux signal callback */
+/* Internal function to export the interfaces on the bus or a peer-to-peer connection */
+static gboolean NSMA__boExportObjects(GDBusConnection *pConnection, guint *pu32ConsumerRegId, gboolean boLifecycleControl);
+
+#ifdef NSMA_P2P_SOCKET
+/* Internal functions to offer the interfaces peer-to-peer on a UNIX socket */
+static void     NSMA__vStartPeerServer   (void);
+static void     NSMA__vStopPeerServer    (void);
+static gboolean NSMA__boOnAuthorizePeer  (GDBusAuthObserver *pObserver,
+                                          GIOStream         *pStream,
+                                          GCredentials      *pCredentials,
+                                          gpointer           pUserData);
+static gboolean NSMA__boOnPeerConnection (GDBusServer       *pServer,
+                                          GDBusConnection   *pConnection,
+                                          gpointer           pUserData);
+static void     NSMA__vOnPeerClosed      (GDBusConnection   *pConnection,
+                                          gboolean           boRemotePeerVanished,
+                                          GError            *pError,
+                                          gpointer           pUserData);
+#endif
+
+/* Internal functions to hand method calls from the D-Bus thread to the core */
+static void     NSMA__vConnectCoreHandler  (gpointer     pInstance,
+                                            const gchar *sSignal,
+                                            GCallback    pfHandler,
+                                            const gint   i32Priority);
+static void     NSMA__vQueueCoreCall       (GClosure     *pClosure,
+                                            GValue       *pReturnValue,
+                                            guint         u32ParamCount,
+                                            const GValue *pParams,
+                                            gpointer      pInvocationHint,
+                                            gpointer      pMarshalData);
+static void     NSMA__vAttachIdle          (GMainContext *pContext,
+                                            const gint    i32Priority,
+                                            GSourceFunc   pfCallback,
+                                            gpointer      pUserData);
+static void     NSMA__vQueueForCore        (const gint    i32Priority,
+                                            GSourceFunc   pfCallback,
+                                            gpointer      pUserData);
+static gboolean NSMA__boDispatchCoreCall   (gpointer pUserData);
+static void     NSMA__vRejectCoreCalls     (void);
+static void     NSMA__vRejectInvocation    (GDBusMethodInvocation *pInvocation);
+static gboolean NSMA__boInvokeCoreCall     (gpointer pUserData);
+static gboolean NSMA__boOnCoreNameAcquired (gpointer pUserData);
+static gboolean NSMA__boQuitDbusLoop       (gpointer pUserData);
+static gpointer NSMA__pvDbusThread         (gpointer pUserData);
+
+#ifdef NSMA_VTABLE_DISPATCH
+/* Internal functions to dispatch the Consumer interface via a hand-written vtable */
+static void      NSMA__vOnConsumerMethodCall    (GDBusConnection       *pConnection,
+                                                 const gchar           *sSender,
+                                                 const gchar           *sObjectPath,
+                                                 const gchar           *sInterfaceName,
+                                                 const gchar           *sMethodName,
+                                                 GVariant              *pParameters,
+                                                 GDBusMethodInvocation *pInvocation,
+                                                 gpointer               pUserData);
+static GVariant* NSMA__pOnConsumerGetProperty   (GDBusConnection       *pConnection,
+                                                 const gchar           *sSender,
+                                                 const gchar           *sObjectPath,
+                                                 const gchar           *sInterfaceName,
+                                                 const gchar           *sPropertyName,
+                                                 GError               **ppError,
+                                                 gpointer               pUserData);
+static gboolean  NSMA__boInvokeConsumerMethod   (gpointer               pUserData);
+static gint      NSMA__i32GetConsumerPriority   (const gchar           *sMethodName);
+static void      NSMA__vOnConsumerPropertyNotify(GObject               *pObject,
+                                                 GParamSpec            *pParamSpec,
+                                                 gpointer               pUserData);
+static void      NSMA__vEmitConsumerSignal      (const gchar           *sInterfaceName,
+                                                 const gchar           *sSignalName,
+                                                 GVariant              *pParameters);
+
+/* Vtable of the Consumer interface. Properties are read only. */
+static const GDBusInterfaceVTable NSMA__stConsumerVTable = {&NSMA__vOnConsumerMethodCall,
+                                                            &NSMA__pOnConsumerGetProperty,
+                                                            NULL};
+#endif
+
+/* Internal helper functions to manage the clients waiting with "WaitForNodeState" */
+static void     NSMA__vCountNodeStateWaiter    (const guint32          u32NodeStateMask,
+                                                const gboolean         boAdd);
+static void     NSMA__vArmNodeStateWaiterTimer (const gint64           i64Deadline);
+static gboolean NSMA__boOnNodeStateWaiterTimer (gpointer               pUserData);
+static void     NSMA__vReturnNodeStateWaiters  (GList                 *pWaiters,
+                                                const NsmNodeState_e   enNodeState,
+                                                const NsmErrorStatus_e enErrorStatus);
+static void     NSMA__vFlushNodeStateWaiters   (void);
+
+/* Internal helper functions to account and rate limit the callers */
+static const gchar*     NSMA__sGetSenderKey           (GDBusMethodInvocation  *pInvocation,
+                                                       gchar                  *sPeerKey);
+static NSMA__tstSender* NSMA__pstGetSender            (GDBusMethodInvocation  *pInvocation,
+                                                       const gboolean          boCreate);
+static void             NSMA__vFreeSender             (gpointer                pSender);
+static void             NSMA__vRequestSenderCreds     (NSMA__tstSender        *pstSender,
+                                                       GDBusMethodInvocation  *pInvocation);
+static void             NSMA__vOnSenderPidReceived    (GObject                *pSrcObject,
+                                                       GAsyncResult           *pRes,
+                                                       gpointer                pUserData);
+static void             NSMA__vOnSenderUidReceived    (GObject                *pSrcObject,
+                                                       GAsyncResult           *pRes,
+                                                       gpointer                pUserData);
+static void             NSMA__vOnNameOwnerChanged     (GDBusConnection        *pConnection,
+                                                       const gchar            *sSenderName,
+                                                       const gchar            *sObjectPath,
+                                                       const gchar            *sInterfaceName,
+                                                       const gchar            *sSignalName,
+                                                       GVariant               *pParameters,
+                                                       gpointer                pUserData);
+static gboolean         NSMA__boAdmitCall             (GDBusMethodInvocation  *pInvocation);
+static gboolean         NSMA__boOnAuthorizeMethod     (GDBusInterfaceSkeleton *pSkeleton,
+                                                       GDBusMethodInvocation  *pInvocation,
+                                                       gpointer                pUserData);
+static void             NSMA__vBeginCallStat          (NSMA__tstCallStat      *pstCall,
+                                                       GDBusMethodInvocation  *pInvocation);
+static void             NSMA__vEndCallStat            (NSMA__tstCallStat      *pstCall,
+                                                       const NSMA__tenStatId   enStatId);
+
+/* Linux signal callbacks */
 static gboolean NSMA__boOnHandleSigterm(gpointer pUserData);
+static gboolean NSMA__boOnHandleSighup (gpointer pUserData);
 
 /* Internal callback for async. life cycle client returns */
 static void NSMA__vOnLifecycleRequestFinish(GObject *pSrcObject, GAsyncResult *pRes, gpointer pUserData);
 
+/* Internal callback for the result of a bus name check */
+static void NSMA__vOnBusNameChecked(GObject *pSrcObject, GAsyncResult *pRes, gpointer pUserData);
+
+/* Internal helper functions to manage pending life cycle requests */
+static NSMA__tstLcRequest* NSMA__pstFindLcRequest  (NodeStateLifeCycleConsumer *pConsumer);
+static void                NSMA__vFinishLcRequest  (NSMA__tstLcRequest         *pstRequest,
+                                                    const NsmErrorStatus_e      enErrorStatus);
+
 
 /**********************************************************************************************************************
 *
@@ -187,12 +582,17 @@ static gboolean NSMA__boOnHandleSetBootMode(NodeStateLifecycleControl *pLifecycl
                                             const gint                 i32BootMode,
                                             gpointer                   pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfSetBootModeCb(i32BootMode);
 
   node_state_lifecycle_control_complete_set_boot_mode(pLifecycleControl, pInvocation, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_SetBootMode);
+
   return TRUE;
 }
 
@@ -215,12 +615,17 @@ static gboolean NSMA__boOnHandleSetNodeState(NodeStateLifecycleControl *pLifecyc
                                              const gint                 i32NodeStateId,
                                              gpointer                   pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfSetNodeStateCb((NsmNodeState_e) i32NodeStateId);
 
   node_state_lifecycle_control_complete_set_node_state(pLifecycleControl, pInvocation, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_SetNodeState);
+
   return TRUE;
 }
 
@@ -243,12 +648,17 @@ static gboolean NSMA__boOnHandleSetApplicationMode(NodeStateLifecycleControl *pL
                                                    const gint                 i32ApplicationModeId,
                                                    gpointer                   pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfSetAppModeCb((NsmApplicationMode_e) i32ApplicationModeId);
 
   node_state_lifecycle_control_complete_set_application_mode(pLifecycleControl, pInvocation, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_SetApplicationMode);
+
   return TRUE;
 }
 
@@ -273,12 +683,17 @@ static gboolean NSMA__boOnHandleRequestNodeRestart(NodeStateLifecycleControl *pL
                                                    const guint                u32RestartType,
                                                    gpointer                   pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfRequestNodeRestartCb((NsmRestartReason_e) i32RestartReason, u32RestartType);
 
   node_state_lifecycle_control_complete_request_node_restart(pLifecycleControl, pInvocation, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_RequestNodeRestart);
+
   return TRUE;
 }
 
@@ -299,12 +714,17 @@ static gboolean NSMA__boOnHandleCheckLucRequired(NodeStateLifecycleControl *pLif
                                                  GDBusMethodInvocation     *pInvocation,
                                                  gpointer                  pUserData)
 {
-  gboolean boLucRequired = FALSE;
+  gboolean          boLucRequired = FALSE;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   boLucRequired = NSMA__stObjectCallbacks.pfCheckLucRequiredCb();
 
   node_state_lifecycle_control_complete_check_luc_required(pLifecycleControl, pInvocation, boLucRequired);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_CheckLucRequired);
+
   return TRUE;
 }
 
@@ -329,12 +749,84 @@ static gboolean NSMA__boOnHandleSetAppHealthStatus(NodeStateLifecycleControl *pL
                                                    const gboolean             boAppState,
                                                    gpointer                   pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfSetAppHealthStatusCb(sAppName, boAppState);
 
   node_state_lifecycle_control_complete_set_app_health_status(pLifecycleControl, pInvocation, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_SetAppHealthStatus);
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called from the g_main_loop, when the lifecycle clients of a seat should be shut down or run up.
+*
+* @param pLifecycleControl: Pointer to a LifecycleControl object
+* @param pInvocation:       Pointer to method invocation object
+* @param i32SeatId:         Seat whose lifecycle clients should be informed
+* @param u32RequestType:    Request type (NSM_SHUTDOWNTYPE_NORMAL, NSM_SHUTDOWNTYPE_FAST or NSM_SHUTDOWNTYPE_RUNUP)
+* @param pUserData:         Optionally user data (not used)
+*
+* @return:                  TRUE:  Tell D-Bus that method succeeded.
+*                           FALSE: Let  D-Bus send an error.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnHandleRequestSeatLifecycle(NodeStateLifecycleControl *pLifecycleControl,
+                                                     GDBusMethodInvocation     *pInvocation,
+                                                     const gint                 i32SeatId,
+                                                     const guint                u32RequestType,
+                                                     gpointer                   pUserData)
+{
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
+
+  enErrorStatus = NSMA__stObjectCallbacks.pfRequestSeatLifecycleCb((NsmSeat_e) i32SeatId, u32RequestType);
+
+  node_state_lifecycle_control_complete_request_seat_lifecycle(pLifecycleControl, pInvocation, (gint) enErrorStatus);
+
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_RequestSeatLifecycle);
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called from the g_main_loop, when the NSM should re-execute its binary. The NSM answers before it
+* hands its state over, so that the caller gets the reply from the old instance.
+*
+* @param pLifecycleControl: Pointer to a LifecycleControl object
+* @param pInvocation:       Pointer to method invocation object
+* @param pUserData:         Optionally user data (not used)
+*
+* @return:                  TRUE:  Tell D-Bus that method succeeded.
+*                           FALSE: Let  D-Bus send an error.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnHandleReexec(NodeStateLifecycleControl *pLifecycleControl,
+                                       GDBusMethodInvocation     *pInvocation,
+                                       gpointer                   pUserData)
+{
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
+
+  enErrorStatus = NSMA__stObjectCallbacks.pfReexecCb();
+
+  node_state_lifecycle_control_complete_reexec(pLifecycleControl, pInvocation, (gint) enErrorStatus);
+
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_Reexec);
+
   return TRUE;
 }
 
@@ -361,7 +853,10 @@ static gboolean NSMA__boOnHandleRegisterSession(NodeStateConsumer     *pConsumer
                                                 const gint             i32SessionState,
                                                 gpointer               pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfRegisterSessionCb(sSessionName,
                                                               sSessionOwner,
@@ -370,6 +865,8 @@ static gboolean NSMA__boOnHandleRegisterSession(NodeStateConsumer     *pConsumer
 
   node_state_consumer_complete_register_session(pConsumer, pInvocation, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_RegisterSession);
+
   return TRUE;
 }
 
@@ -394,12 +891,17 @@ static gboolean NSMA__boOnHandleUnRegisterSession        (NodeStateConsumer
                                                           const gint             i32SeatId,
                                                           gpointer               pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfUnRegisterSessionCb(sSessionName, sSessionOwner, (NsmSeat_e) i32SeatId);
 
   node_state_consumer_complete_un_register_session(pConsumer, pInvocation, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_UnRegisterSession);
+
   return TRUE;
 }
 
@@ -427,15 +929,108 @@ static gboolean NSMA__boOnHandleRegisterLifecycleClient  (NodeStateConsumer
                                                           const guint            u32TimeoutMs,
                                                           gpointer               pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfRegisterLifecycleClientCb(sBusName,
                                                                       sObjName,
                                                                       u32ShutdownMode,
-                                                                      u32TimeoutMs);
+                                                                      u32TimeoutMs,
+                                                                      NsmSeat_NotSet);
 
   node_state_consumer_complete_register_shutdown_client(pConsumer, pInvocation, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_RegisterShutdownClient);
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called from the g_main_loop, when a lifecycle client of a seat should be registered.
+*
+* @param pConsumer:       Pointer to a NodeStateConsumer object
+* @param pInvocation:     Pointer to method invocation object
+* @param sBusName:        Bus name of the remote application that hosts the lifecycle client interface
+* @param sObjName:        Object name of the lifecycle client
+* @param u32ShutdownMode: Shutdown mode for which the client wants to be informed
+* @param u32TimeoutMs:    Timeout in ms for the calls of the lifecycle client
+* @param i32SeatId:       Seat the lifecycle client belongs to
+* @param pUserData:       Optionally user data (not used)
+*
+* @return:                TRUE:  Tell D-Bus that method succeeded.
+*                         FALSE: Let  D-Bus send an error.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnHandleRegisterSeatLifecycleClient(NodeStateConsumer     *pConsumer,
+                                                            GDBusMethodInvocation *pInvocation,
+                                                            const gchar           *sBusName,
+                                                            const gchar           *sObjName,
+                                                            const guint            u32ShutdownMode,
+                                                            const guint            u32TimeoutMs,
+                                                            const gint             i32SeatId,
+                                                            gpointer               pUserData)
+{
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
+
+  enErrorStatus = NSMA__stObjectCallbacks.pfRegisterLifecycleClientCb(sBusName,
+                                                                      sObjName,
+                                                                      u32ShutdownMode,
+                                                                      u32TimeoutMs,
+                                                                      (NsmSeat_e) i32SeatId);
+
+  node_state_consumer_complete_register_seat_shutdown_client(pConsumer, pInvocation, (gint) enErrorStatus);
+
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_RegisterSeatShutdownClient);
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called from the g_main_loop, when a lifecycle client should be registered for load shedding.
+*
+* @param pConsumer:       Pointer to a NodeStateConsumer object
+* @param pInvocation:     Pointer to method invocation object
+* @param sBusName:        Bus name of the remote application that hosts the lifecycle client interface
+* @param sObjName:        Object name of the lifecycle client
+* @param u32ShedLevel:    Level in which the client is shed, when the node enters "DegradedPower"
+* @param u32TimeoutMs:    Timeout in ms for the calls of the lifecycle client
+* @param pUserData:       Optionally user data (not used)
+*
+* @return:                TRUE:  Tell D-Bus that method succeeded.
+*                         FALSE: Let  D-Bus send an error.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnHandleRegisterLoadSheddingClient(NodeStateConsumer     *pConsumer,
+                                                           GDBusMethodInvocation *pInvocation,
+                                                           const gchar           *sBusName,
+                                                           const gchar           *sObjName,
+                                                           const guint            u32ShedLevel,
+                                                           const guint            u32TimeoutMs,
+                                                           gpointer               pUserData)
+{
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
+
+  enErrorStatus = NSMA__stObjectCallbacks.pfRegisterLoadSheddingClientCb(sBusName,
+                                                                         sObjName,
+                                                                         u32ShedLevel,
+                                                                         u32TimeoutMs);
+
+  node_state_consumer_complete_register_load_shedding_client(pConsumer, pInvocation, (gint) enErrorStatus);
+
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_RegisterLoadSheddingClient);
+
   return TRUE;
 }
 
@@ -463,12 +1058,17 @@ static gboolean NSMA__boOnHandleUnRegisterLifecycleClient(NodeStateConsumer
                                                           const guint            u32ShutdownMode,
                                                           gpointer               pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfUnRegisterLifecycleClientCb(sBusName, sObjName, u32ShutdownMode);
 
   node_state_consumer_complete_un_register_shutdown_client(pConsumer, pInvocation, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_UnRegisterShutdownClient);
+
   return TRUE;
 }
 
@@ -491,6 +1091,9 @@ static gboolean NSMA__boOnHandleGetApplicationMode(NodeStateConsumer     *pConsu
 {
   NsmErrorStatus_e     enErrorStatus     = NsmErrorStatus_NotSet;
   NsmApplicationMode_e enApplicationMode = NsmApplicationMode_NotSet;
+  NSMA__tstCallStat    stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfGetAppModeCb(&enApplicationMode);
 
@@ -499,6 +1102,8 @@ static gboolean NSMA__boOnHandleGetApplicationMode(NodeStateConsumer     *pConsu
                                                     (gint) enApplicationMode,
                                                     (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_GetApplicationMode);
+
   return TRUE;
 }
 
@@ -526,11 +1131,16 @@ static gboolean NSMA__boOnHandleGetSessionState(NodeStateConsumer     *pConsumer
 {
   NsmErrorStatus_e  enErrorStatus  = NsmErrorStatus_NotSet;
   NsmSessionState_e enSessionState = NsmSessionState_Unregistered;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfGetSessionStateCb(sSessionName, (NsmSeat_e) i32SeatId, &enSessionState);
 
   node_state_consumer_complete_get_session_state(pConsumer, pInvocation, (gint) enSessionState, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_GetSessionState);
+
   return TRUE;
 }
 
@@ -557,7 +1167,10 @@ static gboolean NSMA__boOnHandleSetSessionState(NodeStateConsumer     *pConsumer
                                                 const gint             i32SessionState,
                                                 gpointer               pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfSetSessionStateCb(sSessionName,
                                                               sSessionOwner,
@@ -566,6 +1179,8 @@ static gboolean NSMA__boOnHandleSetSessionState(NodeStateConsumer     *pConsumer
 
   node_state_consumer_complete_set_session_state(pConsumer, pInvocation, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_SetSessionState);
+
   return TRUE;
 }
 
@@ -586,39 +1201,101 @@ static gboolean NSMA__boOnHandleGetNodeState(NodeStateConsumer     *pConsumer,
                                              GDBusMethodInvocation *pInvocation,
                                              gpointer               pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
-  NsmNodeState_e   enNodeState   = NsmNodeState_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  NsmNodeState_e    enNodeState   = NsmNodeState_NotSet;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
   enErrorStatus = NSMA__stObjectCallbacks.pfGetNodeStateCb(&enNodeState);
 
   node_state_consumer_complete_get_node_state(pConsumer, pInvocation, (gint) enNodeState, (gint) enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_GetNodeState);
+
   return TRUE;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is called from the g_main_loop when the AppHealthCount (number of failed applications) needs to
-* be retrieved.
+* The function is called in the D-Bus thread, when a client wants to wait until the NodeState is one of the passed
+* states. If the NodeState already is one of them, the call returns immediately. Otherwise, the invocation is
+* stored in the waiter table and returned by the core (NSMA_boCompleteNodeStateWaiters) or by the waiter timer.
 *
-* @param pConsumer:   Pointer to a NodeStateConsumer object
-* @param pInvocation: Pointer to a method invocation object
-* @param pUserData:   Pointer to optional user data (not used)
+* @param pConsumer:        Pointer to a NodeStateConsumer object
+* @param pInvocation:      Pointer to a method invocation object
+* @param u32NodeStateMask: NSM_NODESTATE_MASK bits of the NodeStates to wait for
+* @param u32TimeoutMs:     Max. time to wait in ms. 0 to only check the NodeState.
+* @param pUserData:        Pointer to optional user data (not used)
 *
 * @return             TRUE:  Tell D-Bus that method succeeded.
 *                     FALSE: Let  D-Bus send an error.
 *
 **********************************************************************************************************************/
-static gboolean NSMA__boOnHandleGetAppHealthCount(NodeStateConsumer     *pConsumer,
-                                                  GDBusMethodInvocation *pInvocation,
-                                                  gpointer               pUserData)
+static gboolean NSMA__boOnHandleWaitForNodeState(NodeStateConsumer     *pConsumer,
+                                                 GDBusMethodInvocation *pInvocation,
+                                                 const guint            u32NodeStateMask,
+                                                 const guint            u32TimeoutMs,
+                                                 gpointer               pUserData)
 {
-  guint u32AppHealthCount = 0;
+  NsmErrorStatus_e         enErrorStatus = NsmErrorStatus_NotSet;
+  NsmNodeState_e           enNodeState   = NsmNodeState_NotSet;
+  NSMA__tstNodeStateWaiter *pstWaiter    = NULL;
+  gint64                   i64Deadline   = 0;
+  NSMA__tstCallStat        stCall;
 
-  u32AppHealthCount = NSMA__stObjectCallbacks.pfGetAppHealthCountCb();
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
-  node_state_consumer_complete_get_app_health_count(pConsumer, pInvocation, u32AppHealthCount);
+  /* Only valid NodeStates can be waited for */
+  if(   ( u32NodeStateMask                                != 0)
+     && ((u32NodeStateMask & ~NSMA__NODESTATE_VALID_MASK) == 0))
+  {
+    /* Read the NodeState under the lock. Like this, a change can not get lost between the check and the insertion */
+    g_mutex_lock(NSMA__pWaitersMutex);
+
+    (void) NSMA__stObjectCallbacks.pfGetNodeStateCb(&enNodeState);
+
+    if((u32NodeStateMask & NSM_NODESTATE_MASK(enNodeState)) != 0)
+    {
+      enErrorStatus = NsmErrorStatus_Ok;
+    }
+    else if(u32TimeoutMs == 0)
+    {
+      enErrorStatus = NsmErrorStatus_Error;
+    }
+    else
+    {
+      /* Round the deadline up. Waiters with close timeouts are then returned by the same timer event */
+      i64Deadline  = g_get_monotonic_time() + ((gint64) u32TimeoutMs * 1000);
+      i64Deadline += NSMA__WAITER_RESOLUTION_US - (i64Deadline % NSMA__WAITER_RESOLUTION_US);
+
+      pstWaiter                   = g_new(NSMA__tstNodeStateWaiter, 1);
+      pstWaiter->pInvocation      = pInvocation;
+      pstWaiter->u32NodeStateMask = u32NodeStateMask;
+      pstWaiter->i64Deadline      = i64Deadline;
+
+      NSMA__pWaiters = g_list_prepend(NSMA__pWaiters, pstWaiter);
+      NSMA__vCountNodeStateWaiter(u32NodeStateMask, TRUE);
+      NSMA__vArmNodeStateWaiterTimer(i64Deadline);
+
+      enErrorStatus = NsmErrorStatus_ResponsePending;
+    }
+
+    g_mutex_unlock(NSMA__pWaitersMutex);
+  }
+  else
+  {
+    enErrorStatus = NsmErrorStatus_Parameter;
+  }
+
+  /* If the call is not deferred, return it immediately */
+  if(enErrorStatus != NsmErrorStatus_ResponsePending)
+  {
+    node_state_consumer_complete_wait_for_node_state(pConsumer, pInvocation, (gint) enNodeState, (gint) enErrorStatus);
+  }
+
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_WaitForNodeState);
 
   return TRUE;
 }
@@ -626,115 +1303,1807 @@ static gboolean NSMA__boOnHandleGetAppHealthCount(NodeStateConsumer     *pConsum
 
 /**********************************************************************************************************************
 *
-* The function is called from the g_main_loop when the interface version needs to be retrieved.
-*
-* @param pConsumer:   Pointer to a NodeStateConsumer object
-* @param pInvocation: Pointer to a method invocation object
-* @param pUserData:   Pointer to optional user data (not used)
+* The function updates the number of waiters for every NodeState in the passed mask. Called with the waiter lock.
 *
-* @return             TRUE:  Tell D-Bus that method succeeded.
-*                     FALSE: Let  D-Bus send an error.
+* @param u32NodeStateMask: NSM_NODESTATE_MASK bits of the NodeStates the waiter waits for
+* @param boAdd:            TRUE, if a waiter is added. FALSE, if it is removed.
 *
 **********************************************************************************************************************/
-static gboolean NSMA__boOnHandleGetInterfaceVersion(NodeStateConsumer     *pConsumer,
-                                                    GDBusMethodInvocation *pInvocation,
-                                                    gpointer               pUserData)
+static void NSMA__vCountNodeStateWaiter(const guint32 u32NodeStateMask, const gboolean boAdd)
 {
-  guint u32InterfaceVersion = 0;
+  NsmNodeState_e enNodeState = NsmNodeState_NotSet;
 
-  u32InterfaceVersion = NSMA__stObjectCallbacks.pfGetInterfaceVersionCb();
-
-  node_state_consumer_complete_get_interface_version(pConsumer, pInvocation, u32InterfaceVersion);
-
-  return TRUE;
+  for(enNodeState = NsmNodeState_NotSet + 1; enNodeState < NsmNodeState_Last; enNodeState++)
+  {
+    if((u32NodeStateMask & NSM_NODESTATE_MASK(enNodeState)) != 0)
+    {
+      if(boAdd == TRUE)
+      {
+        NSMA__au32WaitersPerState[enNodeState]++;
+      }
+      else
+      {
+        NSMA__au32WaitersPerState[enNodeState]--;
+      }
+    }
+  }
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is called when a connection to the D-Bus could be established.
-*
-* @param pConnection: Connection, which was acquired
-* @param sName:       Bus name
-* @param pUserData:   Optionally user data
+* The function arms the waiter timer for the passed deadline, if no earlier timeout is pending.
+* Called in the D-Bus thread with the waiter lock. All waiters share this one timer.
 *
-* @return void
+* @param i64Deadline: Monotonic time (us), when the timer should expire.
 *
 **********************************************************************************************************************/
-static void NSMA__vOnBusAcquired(GDBusConnection *pConnection, const gchar* sName, gpointer pUserData)
+static void NSMA__vArmNodeStateWaiterTimer(const gint64 i64Deadline)
 {
-  /* Store the connection. Needed later, to create life cycle clients. */
-  NSMA__pBusConnection = pConnection;
-
-  /* Do not automatically exit the main loop when connection is lost.
-   * The program terminates nevertheless, but will give useful traces.
-   */
-  g_dbus_connection_set_exit_on_close(NSMA__pBusConnection, FALSE);
-
-  /* Register the callbacks */
-  (void) g_signal_connect(NSMA__pLifecycleControlObj, "handle-set-boot-mode", G_CALLBACK(NSMA__boOnHandleSetBootMode), NULL);
-  (void) g_signal_connect(NSMA__pLifecycleControlObj, "handle-set-node-state", G_CALLBACK(NSMA__boOnHandleSetNodeState), NULL);
-  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-node-state", G_CALLBACK(NSMA__boOnHandleGetNodeState), NULL);
-  (void) g_signal_connect(NSMA__pLifecycleControlObj, "handle-set-application-mode", G_CALLBACK(NSMA__boOnHandleSetApplicationMode), NULL);
-  (void) g_signal_connect(NSMA__pLifecycleControlObj, "handle-request-node-restart", G_CALLBACK(NSMA__boOnHandleRequestNodeRestart), NULL);
-  (void) g_signal_connect(NSMA__pLifecycleControlObj, "handle-check-luc-required", G_CALLBACK(NSMA__boOnHandleCheckLucRequired), NULL);
-  (void) g_signal_connect(NSMA__pLifecycleControlObj, "handle-set-app-health-status", G_CALLBACK(NSMA__boOnHandleSetAppHealthStatus), NULL);
-  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-register-session", G_CALLBACK(NSMA__boOnHandleRegisterSession), NULL);
-  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-un-register-session", G_CALLBACK(NSMA__boOnHandleUnRegisterSession), NULL);
-  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-register-shutdown-client", G_CALLBACK(NSMA__boOnHandleRegisterLifecycleClient), NULL);
-  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-un-register-shutdown-client", G_CALLBACK(NSMA__boOnHandleUnRegisterLifecycleClient), NULL);
-  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-application-mode", G_CALLBACK(NSMA__boOnHandleGetApplicationMode), NULL);
-  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-session-state", G_CALLBACK(NSMA__boOnHandleGetSessionState), NULL);
-  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-set-session-state", G_CALLBACK(NSMA__boOnHandleSetSessionState), NULL);
-  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-app-health-count", G_CALLBACK(NSMA__boOnHandleGetAppHealthCount), NULL);
-  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-interface-version", G_CALLBACK(NSMA__boOnHandleGetInterfaceVersion), NULL);
-  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-lifecycle-request-complete",  G_CALLBACK(NSMA__boOnHandleLifecycleRequestComplete), NULL);
+  gint64 i64TimeoutUs = 0;
 
-  /* Export the interfaces */
-  if(g_dbus_interface_skeleton_export(G_DBUS_INTERFACE_SKELETON(NSMA__pNodeStateConsumerObj),
-                                      NSMA__pBusConnection,
-                                      NSM_CONSUMER_OBJECT,
-                                      NULL) == TRUE)
-  {
-    if(g_dbus_interface_skeleton_export(G_DBUS_INTERFACE_SKELETON(NSMA__pLifecycleControlObj),
-                                        NSMA__pBusConnection,
-                                        NSM_LIFECYCLE_OBJECT,
-                                        NULL) != TRUE)
+  if((NSMA__pWaiterTimer == NULL) || (i64Deadline < NSMA__i64WaiterTimerDeadline))
+  {
+    if(NSMA__pWaiterTimer != NULL)
     {
-      /* Error: The LifecycleControl interface could not be exported */
-      NSMA__boLoopEndByUser = FALSE;
-      g_main_loop_quit(NSMA__pMainLoop);
+      g_source_destroy(NSMA__pWaiterTimer);
+      g_source_unref(NSMA__pWaiterTimer);
     }
-  }
-  else
-  {
-    /* Error: The NodeStateConsumer interface could not be exported */
-    NSMA__boLoopEndByUser = FALSE;
-    g_main_loop_quit(NSMA__pMainLoop);
+
+    i64TimeoutUs = MAX(i64Deadline - g_get_monotonic_time(), 0);
+
+    NSMA__pWaiterTimer           = g_timeout_source_new((guint) ((i64TimeoutUs + 999) / 1000));
+    NSMA__i64WaiterTimerDeadline = i64Deadline;
+    g_source_set_callback(NSMA__pWaiterTimer, &NSMA__boOnNodeStateWaiterTimer, NULL, NULL);
+    (void) g_source_attach(NSMA__pWaiterTimer, NSMA__pDbusContext);
   }
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is called when the "bus name" could be acquired on the D-Bus.
+* The function is called in the D-Bus thread, when the waiter timer expired. Waiters whose deadline passed are
+* returned with NsmErrorStatus_Error and the current NodeState. The timer is re-armed for the next deadline.
 *
-* @param pConnection: Connection over which the bus name was acquired
-* @param sName:       Acquired bus name
-* @param pUserData:   Optionally user data
+* @param pUserData: Optional user data (not used)
 *
-* @return void
+* @return FALSE: The timer source is removed. A new one is armed, if there are further waiters.
 *
 **********************************************************************************************************************/
-static void NSMA__vOnNameAcquired(GDBusConnection *pConnection, const gchar* sName, gpointer pUserData)
+static gboolean NSMA__boOnNodeStateWaiterTimer(gpointer pUserData)
 {
-  /* There is nothing to do in this function, it is only need as callback function. */
-}
+  GList                    *pListEntry      = NULL;
+  GList                    *pNextEntry      = NULL;
+  GList                    *pExpired        = NULL;
+  NSMA__tstNodeStateWaiter *pstWaiter       = NULL;
+  gint64                    i64Now          = 0;
+  gint64                    i64NextDeadline = G_MAXINT64;
+  NsmNodeState_e            enNodeState     = NsmNodeState_NotSet;
 
+  g_mutex_lock(NSMA__pWaitersMutex);
 
-/**********************************************************************************************************************
-*
-* The function is called if either no connection to D-Bus could be established or the bus name could not be acquired.
+  /* The source is destroyed, when the callback returns. Forget it, so that a new timer can be armed */
+  g_source_unref(NSMA__pWaiterTimer);
+  NSMA__pWaiterTimer = NULL;
+
+  i64Now = g_get_monotonic_time();
+
+  for(pListEntry = NSMA__pWaiters; pListEntry != NULL; pListEntry = pNextEntry)
+  {
+    pNextEntry = g_list_next(pListEntry);
+    pstWaiter  = (NSMA__tstNodeStateWaiter*) pListEntry->data;
+
+    if(pstWaiter->i64Deadline <= i64Now)
+    {
+      NSMA__pWaiters = g_list_delete_link(NSMA__pWaiters, pListEntry);
+      NSMA__vCountNodeStateWaiter(pstWaiter->u32NodeStateMask, FALSE);
+      pExpired = g_list_prepend(pExpired, pstWaiter);
+    }
+    else
+    {
+      i64NextDeadline = MIN(i64NextDeadline, pstWaiter->i64Deadline);
+    }
+  }
+
+  if(i64NextDeadline != G_MAXINT64)
+  {
+    NSMA__vArmNodeStateWaiterTimer(i64NextDeadline);
+  }
+
+  g_mutex_unlock(NSMA__pWaitersMutex);
+
+  (void) NSMA__stObjectCallbacks.pfGetNodeStateCb(&enNodeState);
+  NSMA__vReturnNodeStateWaiters(pExpired, enNodeState, NsmErrorStatus_Error);
+
+  return FALSE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function returns the invocations of the passed waiters and frees the waiters and the list.
+*
+* @param pWaiters:      List of NSMA__tstNodeStateWaiter, which have been removed from the waiter table
+* @param enNodeState:   NodeState returned to the clients
+* @param enErrorStatus: Error status returned to the clients
+*
+**********************************************************************************************************************/
+static void NSMA__vReturnNodeStateWaiters(GList                 *pWaiters,
+                                          const NsmNodeState_e   enNodeState,
+                                          const NsmErrorStatus_e enErrorStatus)
+{
+  GList                    *pListEntry = NULL;
+  NSMA__tstNodeStateWaiter *pstWaiter  = NULL;
+
+  for(pListEntry = pWaiters; pListEntry != NULL; pListEntry = g_list_next(pListEntry))
+  {
+    pstWaiter = (NSMA__tstNodeStateWaiter*) pListEntry->data;
+    node_state_consumer_complete_wait_for_node_state(NSMA__pNodeStateConsumerObj,
+                                                     pstWaiter->pInvocation,
+                                                     (gint) enNodeState,
+                                                     (gint) enErrorStatus);
+    g_free(pstWaiter);
+  }
+
+  g_list_free(pWaiters);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread, when its loop ended. All waiters are returned with an error.
+*
+**********************************************************************************************************************/
+static void NSMA__vFlushNodeStateWaiters(void)
+{
+  GList          *pWaiters    = NULL;
+  NsmNodeState_e  enNodeState = NsmNodeState_NotSet;
+
+  g_mutex_lock(NSMA__pWaitersMutex);
+
+  pWaiters       = NSMA__pWaiters;
+  NSMA__pWaiters = NULL;
+  memset(NSMA__au32WaitersPerState, 0, sizeof(NSMA__au32WaitersPerState));
+
+  if(NSMA__pWaiterTimer != NULL)
+  {
+    g_source_destroy(NSMA__pWaiterTimer);
+    g_source_unref(NSMA__pWaiterTimer);
+    NSMA__pWaiterTimer = NULL;
+  }
+
+  g_mutex_unlock(NSMA__pWaitersMutex);
+
+  (void) NSMA__stObjectCallbacks.pfGetNodeStateCb(&enNodeState);
+  NSMA__vReturnNodeStateWaiters(pWaiters, enNodeState, NsmErrorStatus_Error);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called from the g_main_loop when the AppHealthCount (number of failed applications) needs to
+* be retrieved.
+*
+* @param pConsumer:   Pointer to a NodeStateConsumer object
+* @param pInvocation: Pointer to a method invocation object
+* @param pUserData:   Pointer to optional user data (not used)
+*
+* @return             TRUE:  Tell D-Bus that method succeeded.
+*                     FALSE: Let  D-Bus send an error.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnHandleGetAppHealthCount(NodeStateConsumer     *pConsumer,
+                                                  GDBusMethodInvocation *pInvocation,
+                                                  gpointer               pUserData)
+{
+  guint             u32AppHealthCount = 0;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
+
+  u32AppHealthCount = NSMA__stObjectCallbacks.pfGetAppHealthCountCb();
+
+  node_state_consumer_complete_get_app_health_count(pConsumer, pInvocation, u32AppHealthCount);
+
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_GetAppHealthCount);
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called from the g_main_loop when the interface version needs to be retrieved.
+*
+* @param pConsumer:   Pointer to a NodeStateConsumer object
+* @param pInvocation: Pointer to a method invocation object
+* @param pUserData:   Pointer to optional user data (not used)
+*
+* @return             TRUE:  Tell D-Bus that method succeeded.
+*                     FALSE: Let  D-Bus send an error.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnHandleGetInterfaceVersion(NodeStateConsumer     *pConsumer,
+                                                    GDBusMethodInvocation *pInvocation,
+                                                    gpointer               pUserData)
+{
+  guint             u32InterfaceVersion = 0;
+  NSMA__tstCallStat stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
+
+  u32InterfaceVersion = NSMA__stObjectCallbacks.pfGetInterfaceVersionCb();
+
+  node_state_consumer_complete_get_interface_version(pConsumer, pInvocation, u32InterfaceVersion);
+
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_GetInterfaceVersion);
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread, when a client requests the statistics of the NSMA. The counters are
+* read one by one with atomic operations. The values of different methods therefore can be taken at slightly
+* different times. Measurements ending between reading and resetting a counter are lost.
+*
+* @param pConsumer:   Pointer to a NodeStateConsumer object
+* @param pInvocation: Pointer to a method invocation object
+* @param boReset:     TRUE, if the counters should be reset after they have been read
+* @param pUserData:   Pointer to optional user data (not used)
+*
+* @return             TRUE:  Tell D-Bus that method succeeded.
+*                     FALSE: Let  D-Bus send an error.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnHandleGetStatistics(NodeStateConsumer     *pConsumer,
+                                              GDBusMethodInvocation *pInvocation,
+                                              const gboolean         boReset,
+                                              gpointer               pUserData)
+{
+  /* Function local variables                                                   */
+  GVariantBuilder      stStatistics;      /* Array of all entries              */
+  GVariantBuilder      stHistogram;       /* Histogram of one entry            */
+  NSMA_tstStatCounter *pstCounter = NULL;
+  guint                u32StatId  = 0;
+  guint                u32Bucket  = 0;
+  NSMA__tstCallStat    stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
+
+  g_variant_builder_init(&stStatistics, G_VARIANT_TYPE("a(sutttau)"));
+
+  for(u32StatId = 0; u32StatId < NSMA__enStat_Last; u32StatId++)
+  {
+    pstCounter = &NSMA__astStatCounters[u32StatId];
+
+    g_variant_builder_init(&stHistogram, G_VARIANT_TYPE("au"));
+
+    for(u32Bucket = 0; u32Bucket < NSMA_STAT_HISTOGRAM_BUCKETS; u32Bucket++)
+    {
+      g_variant_builder_add(&stHistogram, "u", (guint) g_atomic_int_get((volatile gint*) &pstCounter->au32Histogram[u32Bucket]));
+    }
+
+    /* The 64 bit values are read with an atomic add. Like this, they can not tear on 32 bit platforms */
+    g_variant_builder_add(&stStatistics,
+                          "(sutttau)",
+                          NSMA__asStatNames[u32StatId],
+                          (guint) g_atomic_int_get((volatile gint*) &pstCounter->u32Calls),
+                          __sync_fetch_and_add(&pstCounter->u64WallSumNs, 0),
+                          __sync_fetch_and_add(&pstCounter->u64WallMaxNs, 0),
+                          __sync_fetch_and_add(&pstCounter->u64CpuSumNs,  0),
+                          &stHistogram);
+
+    if(boReset == TRUE)
+    {
+      NSMA_vStatCounterReset(pstCounter);
+    }
+  }
+
+  node_state_consumer_complete_get_statistics(pConsumer,
+                                              pInvocation,
+                                              g_variant_builder_end(&stStatistics),
+                                              (gint) NsmErrorStatus_Ok);
+
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_GetStatistics);
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread, when the "GetClientStatistics" method has been called.
+* It returns the accounting of every caller, which has been seen by the NSMA and is still connected.
+*
+* @param pConsumer:   Pointer to the NodeStateConsumer object
+* @param pInvocation: Pointer to a method invocation object
+* @param pUserData:   Pointer to optional user data (not used)
+*
+* @return             TRUE:  Tell D-Bus that method succeeded.
+*                     FALSE: Let  D-Bus send an error.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnHandleGetClientStatistics(NodeStateConsumer     *pConsumer,
+                                                    GDBusMethodInvocation *pInvocation,
+                                                    gpointer               pUserData)
+{
+  /* Function local variables                                        */
+  GVariantBuilder    stClients;            /* Array of all callers  */
+  GHashTableIter     stIter;
+  gpointer           pValue    = NULL;
+  NSMA__tstSender   *pstSender = NULL;
+  NSMA__tstCallStat  stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
+
+  g_variant_builder_init(&stClients, G_VARIANT_TYPE("a(suuuut)"));
+
+  g_mutex_lock(NSMA__pSendersMutex);
+
+  g_hash_table_iter_init(&stIter, NSMA__pSenders);
+
+  while(g_hash_table_iter_next(&stIter, NULL, &pValue) == TRUE)
+  {
+    pstSender = (NSMA__tstSender*) pValue;
+
+    g_variant_builder_add(&stClients,
+                          "(suuuut)",
+                          pstSender->sName,
+                          pstSender->u32Pid,
+                          pstSender->u32Uid,
+                          pstSender->u32Calls,
+                          pstSender->u32Rejected,
+                          pstSender->u64HandlingNs);
+  }
+
+  g_mutex_unlock(NSMA__pSendersMutex);
+
+  node_state_consumer_complete_get_client_statistics(pConsumer,
+                                                     pInvocation,
+                                                     g_variant_builder_end(&stClients),
+                                                     (gint) NsmErrorStatus_Ok);
+
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_GetClientStatistics);
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function returns the key of the caller of a method in NSMA__pSenders. Callers on the bus are identified by
+* their unique bus name. Peer-to-peer callers have no bus name. They are identified by their connection.
+*
+* @param pInvocation: Method invocation of the caller
+* @param sPeerKey:    Buffer of NSMA__PEER_KEY_LENGTH characters, where the key of a peer can be stored
+*
+* @return Key of the caller
+*
+**********************************************************************************************************************/
+static const gchar* NSMA__sGetSenderKey(GDBusMethodInvocation *pInvocation, gchar *sPeerKey)
+{
+  const gchar *sKey = g_dbus_method_invocation_get_sender(pInvocation);
+
+  if(sKey == NULL)
+  {
+    (void) g_snprintf(sPeerKey,
+                      NSMA__PEER_KEY_LENGTH,
+                      "peer@%p",
+                      (void*) g_dbus_method_invocation_get_connection(pInvocation));
+    sKey = sPeerKey;
+  }
+
+  return sKey;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function looks up the caller of a method in NSMA__pSenders. It has to be called with NSMA__pSendersMutex locked.
+* If a new caller is created, its bucket is full and the request of its credentials is started.
+*
+* @param pInvocation: Method invocation of the caller
+* @param boCreate:    TRUE, if the caller should be created, when it is not known yet
+*
+* @return Pointer to the caller or NULL, if the caller is not known and has not been created.
+*
+**********************************************************************************************************************/
+static NSMA__tstSender* NSMA__pstGetSender(GDBusMethodInvocation *pInvocation, const gboolean boCreate)
+{
+  /* Function local variables                                   */
+  gchar            sPeerKey[NSMA__PEER_KEY_LENGTH];
+  const gchar     *sKey      = NSMA__sGetSenderKey(pInvocation, sPeerKey);
+  NSMA__tstSender *pstSender = (NSMA__tstSender*) g_hash_table_lookup(NSMA__pSenders, sKey);
+
+  if((pstSender == NULL) && (boCreate == TRUE))
+  {
+    pstSender            = g_new0(NSMA__tstSender, 1);
+    pstSender->sName     = g_strdup(sKey);
+    pstSender->u32Uid    = G_MAXUINT;
+    pstSender->dTokens   = (gdouble) NSMA__u32RateBurst;
+    pstSender->i64Refill = g_get_monotonic_time();
+
+    g_hash_table_insert(NSMA__pSenders, pstSender->sName, pstSender);
+
+    NSMA__vRequestSenderCreds(pstSender, pInvocation);
+  }
+
+  return pstSender;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called by the hash table NSMA__pSenders to free a caller.
+*
+* @param pSender: Caller (NSMA__tstSender) that should be freed. The key of the table is freed with it.
+*
+**********************************************************************************************************************/
+static void NSMA__vFreeSender(gpointer pSender)
+{
+  NSMA__tstSender *pstSender = (NSMA__tstSender*) pSender;
+
+  g_free(pstSender->sName);
+  g_free(pstSender);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function determines the PID and the UID of a new caller. The credentials of a peer-to-peer caller are known
+* from its socket. For callers on the bus, the bus daemon is asked asynchronously, so that the admission of the call
+* does not wait. The values are filled in, when the replies arrive in the D-Bus thread.
+*
+* @param pstSender:   New caller
+* @param pInvocation: Method invocation of the caller
+*
+**********************************************************************************************************************/
+static void NSMA__vRequestSenderCreds(NSMA__tstSender *pstSender, GDBusMethodInvocation *pInvocation)
+{
+  /* Function local variables                                                   */
+  GDBusConnection *pConnection  = g_dbus_method_invocation_get_connection(pInvocation);
+  const gchar     *sSender      = g_dbus_method_invocation_get_sender(pInvocation);
+#ifdef NSMA_P2P_SOCKET
+  GCredentials    *pCredentials = NULL; /* Credentials of a peer-to-peer caller */
+#endif
+
+  if(sSender != NULL)
+  {
+    g_dbus_connection_call(pConnection,
+                           "org.freedesktop.DBus",
+                           "/org/freedesktop/DBus",
+                           "org.freedesktop.DBus",
+                           "GetConnectionUnixProcessID",
+                           g_variant_new("(s)", sSender),
+                           G_VARIANT_TYPE("(u)"),
+                           G_DBUS_CALL_FLAGS_NONE,
+                           -1,
+                           NULL,
+                           &NSMA__vOnSenderPidReceived,
+                           g_strdup(sSender));
+
+    g_dbus_connection_call(pConnection,
+                           "org.freedesktop.DBus",
+                           "/org/freedesktop/DBus",
+                           "org.freedesktop.DBus",
+                           "GetConnectionUnixUser",
+                           g_variant_new("(s)", sSender),
+                           G_VARIANT_TYPE("(u)"),
+                           G_DBUS_CALL_FLAGS_NONE,
+                           -1,
+                           NULL,
+                           &NSMA__vOnSenderUidReceived,
+                           g_strdup(sSender));
+  }
+#ifdef NSMA_P2P_SOCKET
+  else
+  {
+    pCredentials = g_dbus_connection_get_peer_credentials(pConnection);
+
+    if(pCredentials != NULL)
+    {
+      pstSender->u32Pid = (guint) g_credentials_get_unix_pid(pCredentials, NULL);
+      pstSender->u32Uid = (guint) g_credentials_get_unix_user(pCredentials, NULL);
+    }
+  }
+#endif
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread, when the bus daemon returned the PID of a caller.
+*
+* @param pSrcObject: Bus connection
+* @param pRes:       Result of "GetConnectionUnixProcessID"
+* @param pUserData:  Unique bus name of the caller (allocated by NSMA__vRequestSenderCreds)
+*
+**********************************************************************************************************************/
+static void NSMA__vOnSenderPidReceived(GObject *pSrcObject, GAsyncResult *pRes, gpointer pUserData)
+{
+  /* Function local variables                                      */
+  gchar           *sSender   = (gchar*) pUserData;
+  GVariant        *pReply    = NULL;
+  NSMA__tstSender *pstSender = NULL;
+  guint            u32Pid    = 0;
+
+  pReply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(pSrcObject), pRes, NULL);
+
+  if(pReply != NULL)
+  {
+    g_variant_get(pReply, "(u)", &u32Pid);
+    g_variant_unref(pReply);
+
+    /* The caller may already have left the bus */
+    g_mutex_lock(NSMA__pSendersMutex);
+    pstSender = (NSMA__tstSender*) g_hash_table_lookup(NSMA__pSenders, sSender);
+
+    if(pstSender != NULL)
+    {
+      pstSender->u32Pid = u32Pid;
+    }
+
+    g_mutex_unlock(NSMA__pSendersMutex);
+  }
+
+  g_free(sSender);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread, when the bus daemon returned the UID of a caller.
+*
+* @param pSrcObject: Bus connection
+* @param pRes:       Result of "GetConnectionUnixUser"
+* @param pUserData:  Unique bus name of the caller (allocated by NSMA__vRequestSenderCreds)
+*
+**********************************************************************************************************************/
+static void NSMA__vOnSenderUidReceived(GObject *pSrcObject, GAsyncResult *pRes, gpointer pUserData)
+{
+  /* Function local variables                                      */
+  gchar           *sSender   = (gchar*) pUserData;
+  GVariant        *pReply    = NULL;
+  NSMA__tstSender *pstSender = NULL;
+  guint            u32Uid    = 0;
+
+  pReply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(pSrcObject), pRes, NULL);
+
+  if(pReply != NULL)
+  {
+    g_variant_get(pReply, "(u)", &u32Uid);
+    g_variant_unref(pReply);
+
+    g_mutex_lock(NSMA__pSendersMutex);
+    pstSender = (NSMA__tstSender*) g_hash_table_lookup(NSMA__pSenders, sSender);
+
+    if(pstSender != NULL)
+    {
+      pstSender->u32Uid = u32Uid;
+    }
+
+    g_mutex_unlock(NSMA__pSendersMutex);
+  }
+
+  g_free(sSender);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread, when the owner of a bus name changed. If a unique bus name vanished,
+* the accounting of the caller is removed. Like this, the table does not grow with every short-lived client.
+*
+* @param pConnection:    Bus connection
+* @param sSenderName:    Sender of the signal (org.freedesktop.DBus)
+* @param sObjectPath:    Object path of the signal
+* @param sInterfaceName: Interface of the signal
+* @param sSignalName:    Name of the signal (NameOwnerChanged)
+* @param pParameters:    Name, old owner and new owner
+* @param pUserData:      Optionally user data (not used)
+*
+**********************************************************************************************************************/
+static void NSMA__vOnNameOwnerChanged(GDBusConnection *pConnection,
+                                      const gchar     *sSenderName,
+                                      const gchar     *sObjectPath,
+                                      const gchar     *sInterfaceName,
+                                      const gchar     *sSignalName,
+                                      GVariant        *pParameters,
+                                      gpointer         pUserData)
+{
+  /* Function local variables       */
+  const gchar *sName     = NULL;
+  const gchar *sOldOwner = NULL;
+  const gchar *sNewOwner = NULL;
+
+  g_variant_get(pParameters, "(&s&s&s)", &sName, &sOldOwner, &sNewOwner);
+
+  if((sName[0] == ':') && (sNewOwner[0] == '\0'))
+  {
+    g_mutex_lock(NSMA__pSendersMutex);
+    (void) g_hash_table_remove(NSMA__pSenders, sName);
+    g_mutex_unlock(NSMA__pSendersMutex);
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread, before a method call is dispatched. The call is accounted for its
+* caller. Every caller has a token bucket, which is refilled with NSMA__u32RateLimit tokens per second up to
+* NSMA__u32RateBurst tokens. A call costs one token. If the bucket is empty, the call is answered at once with the
+* error "org.freedesktop.DBus.Error.LimitsExceeded". Like this, a misbehaving client can not flood the NSM.
+* Calls of the LifecycleControl interface and the registration and answers of lifecycle clients are never rejected.
+*
+* @param pInvocation: Method invocation of the call
+*
+* @return TRUE:  The call is admitted and should be dispatched.
+*         FALSE: The call has been rejected. The invocation already has been answered.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boAdmitCall(GDBusMethodInvocation *pInvocation)
+{
+  /* Function local variables                                                       */
+  gboolean         boRetVal   = TRUE;
+  gboolean         boExempt   = FALSE;  /* Call is not rate limited               */
+  NSMA__tstSender *pstSender  = NULL;
+  gint64           i64Now     = g_get_monotonic_time();
+  guint            u32Limit   = 0;      /* Limit at the time of the call          */
+  guint            u32Idx     = 0;
+
+  if(g_strcmp0(g_dbus_method_invocation_get_object_path(pInvocation), NSM_LIFECYCLE_OBJECT) == 0)
+  {
+    boExempt = TRUE;
+  }
+
+  for(u32Idx = 0; (u32Idx < G_N_ELEMENTS(NSMA__asRateLimitExempt)) && (boExempt == FALSE); u32Idx++)
+  {
+    boExempt = (g_strcmp0(g_dbus_method_invocation_get_method_name(pInvocation), NSMA__asRateLimitExempt[u32Idx]) == 0);
+  }
+
+  g_mutex_lock(NSMA__pSendersMutex);
+
+  u32Limit  = NSMA__u32RateLimit;
+  pstSender = NSMA__pstGetSender(pInvocation, TRUE);
+
+  if(u32Limit != 0)
+  {
+    /* Refill the bucket for the time since the last call */
+    pstSender->dTokens  += ((gdouble) (i64Now - pstSender->i64Refill) * (gdouble) u32Limit) / (gdouble) G_USEC_PER_SEC;
+    pstSender->dTokens   = MIN(pstSender->dTokens, (gdouble) NSMA__u32RateBurst);
+    pstSender->i64Refill = i64Now;
+
+    if(boExempt == FALSE)
+    {
+      if(pstSender->dTokens >= 1.0)
+      {
+        pstSender->dTokens -= 1.0;
+      }
+      else
+      {
+        boRetVal = FALSE;
+      }
+    }
+  }
+
+  if(boRetVal == TRUE)
+  {
+    pstSender->u32Calls++;
+  }
+  else
+  {
+    pstSender->u32Rejected++;
+  }
+
+  g_mutex_unlock(NSMA__pSendersMutex);
+
+  if(boRetVal == FALSE)
+  {
+    g_dbus_method_invocation_return_error(pInvocation,
+                                          G_DBUS_ERROR,
+                                          G_DBUS_ERROR_LIMITS_EXCEEDED,
+                                          "Rate limit of %u calls/s exceeded",
+                                          u32Limit);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread by the skeletons ("g-authorize-method"), before a method handler is
+* called. It admits or rejects the call (see NSMA__boAdmitCall).
+*
+* @param pSkeleton:   Skeleton object, which received the call
+* @param pInvocation: Method invocation of the call
+* @param pUserData:   Optionally user data (not used)
+*
+* @return TRUE:  The call is dispatched to the method handler.
+*         FALSE: The call has been rejected and answered with an error.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnAuthorizeMethod(GDBusInterfaceSkeleton *pSkeleton,
+                                          GDBusMethodInvocation  *pInvocation,
+                                          gpointer                pUserData)
+{
+  gboolean boRetVal = FALSE;
+
+  /* The skeleton keeps its reference to the invocation. Answering it with an error consumes an own reference. */
+  g_object_ref(pInvocation);
+
+  boRetVal = NSMA__boAdmitCall(pInvocation);
+
+  if(boRetVal == TRUE)
+  {
+    g_object_unref(pInvocation);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function starts the measurement of a method handler. The invocation is referenced, because the handler
+* releases it, when it returns the call.
+*
+* @param pstCall:     Measurement of the call
+* @param pInvocation: Method invocation of the call
+*
+**********************************************************************************************************************/
+static void NSMA__vBeginCallStat(NSMA__tstCallStat *pstCall, GDBusMethodInvocation *pInvocation)
+{
+  NSMA_vStatProbeBegin(&pstCall->stProbe);
+  pstCall->pInvocation = g_object_ref(pInvocation);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function ends the measurement of a method handler. The time is added to the statistics of the method and to
+* the handling time of the caller.
+*
+* @param pstCall:  Measurement started with NSMA__vBeginCallStat
+* @param enStatId: Statistics entry of the method
+*
+**********************************************************************************************************************/
+static void NSMA__vEndCallStat(NSMA__tstCallStat *pstCall, const NSMA__tenStatId enStatId)
+{
+  /* Function local variables                                   */
+  guint64          u64HandlingNs = 0;
+  NSMA__tstSender *pstSender     = NULL;
+
+  u64HandlingNs = NSMA_u64StatProbeEnd(&pstCall->stProbe, &NSMA__astStatCounters[enStatId]);
+
+  g_mutex_lock(NSMA__pSendersMutex);
+
+  /* Do not create the caller. It may have been removed while the call was queued. */
+  pstSender = NSMA__pstGetSender(pstCall->pInvocation, FALSE);
+
+  if(pstSender != NULL)
+  {
+    pstSender->u64HandlingNs += u64HandlingNs;
+  }
+
+  g_mutex_unlock(NSMA__pSendersMutex);
+
+  g_object_unref(pstCall->pInvocation);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the core context to invoke a method handler, which has been queued by the D-Bus thread.
+* The handler answers the method invocation. Afterwards the copied parameters are released. If the core loop has
+* ended, the invocation is rejected instead.
+*
+* @param pUserData: Pointer to the queued method call (NSMA__tstCoreCall)
+*
+* @return FALSE: Remove the idle source. The call is only executed once.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boInvokeCoreCall(gpointer pUserData)
+{
+  /* Function local variables                                                    */
+  NSMA__tstCoreCall *pstCall     = (NSMA__tstCoreCall*) pUserData; /* Queued call */
+  GValue             stRetVal    = G_VALUE_INIT;                   /* Unused      */
+  guint              u32ParamIdx = 0;
+
+  if(NSMA__boRejectCoreCalls == FALSE)
+  {
+    g_value_init(&stRetVal, G_TYPE_BOOLEAN);
+    g_closure_invoke(pstCall->pCoreClosure, &stRetVal, pstCall->u32ParamCount, pstCall->pParams, NULL);
+    g_value_unset(&stRetVal);
+  }
+  else
+  {
+    /* The second parameter of a "handle-*" signal is the invocation */
+    NSMA__vRejectInvocation((GDBusMethodInvocation*) g_value_get_object(&pstCall->pParams[1]));
+  }
+
+  for(u32ParamIdx = 0; u32ParamIdx < pstCall->u32ParamCount; u32ParamIdx++)
+  {
+    g_value_unset(&pstCall->pParams[u32ParamIdx]);
+  }
+
+  g_free(pstCall->pParams);
+  g_free(pstCall);
+
+  return FALSE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread to queue a method call for the core context. The call is remembered,
+* until it has been dispatched, so that it can be rejected, if the core loop ends before.
+*
+* @param i32Priority: Priority of the method
+* @param pfCallback:  Function that invokes the method handler in the core context
+* @param pUserData:   Queued call passed to the function
+*
+**********************************************************************************************************************/
+static void NSMA__vQueueForCore(const gint i32Priority, GSourceFunc pfCallback, gpointer pUserData)
+{
+  NSMA__tstQueuedCall *pstQueued = g_new0(NSMA__tstQueuedCall, 1);
+
+  pstQueued->pSource    = g_idle_source_new();
+  pstQueued->pfCallback = pfCallback;
+  pstQueued->pUserData  = pUserData;
+
+  g_source_set_priority(pstQueued->pSource, i32Priority);
+  g_source_set_callback(pstQueued->pSource, &NSMA__boDispatchCoreCall, pstQueued, NULL);
+
+  g_mutex_lock(NSMA__pCoreCallsMutex);
+  g_queue_push_tail(&NSMA__stCoreCalls, pstQueued);
+  pstQueued->pLink = g_queue_peek_tail_link(&NSMA__stCoreCalls);
+  (void) g_source_attach(pstQueued->pSource, NULL);
+  g_mutex_unlock(NSMA__pCoreCallsMutex);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the core context for a method call queued by NSMA__vQueueForCore.
+*
+* @param pUserData: Queued call (NSMA__tstQueuedCall)
+*
+* @return FALSE: Remove the idle source. The call is only executed once.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boDispatchCoreCall(gpointer pUserData)
+{
+  NSMA__tstQueuedCall *pstQueued = (NSMA__tstQueuedCall*) pUserData;
+
+  g_mutex_lock(NSMA__pCoreCallsMutex);
+  g_queue_delete_link(&NSMA__stCoreCalls, pstQueued->pLink);
+  g_mutex_unlock(NSMA__pCoreCallsMutex);
+
+  (void) pstQueued->pfCallback(pstQueued->pUserData);
+
+  g_source_unref(pstQueued->pSource);
+  g_free(pstQueued);
+
+  return FALSE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the core context, after the core loop and the D-Bus thread have ended. Method calls that
+* have been queued, but not dispatched anymore, are answered with an error. The state of the NSM is not changed.
+*
+**********************************************************************************************************************/
+static void NSMA__vRejectCoreCalls(void)
+{
+  GQueue               stCalls   = G_QUEUE_INIT;
+  NSMA__tstQueuedCall *pstQueued = NULL;
+
+  NSMA__boRejectCoreCalls = TRUE;
+
+  g_mutex_lock(NSMA__pCoreCallsMutex);
+  stCalls           = NSMA__stCoreCalls;
+  g_queue_init(&NSMA__stCoreCalls);
+  g_mutex_unlock(NSMA__pCoreCallsMutex);
+
+  /* Answer the calls in the order they were received */
+  while((pstQueued = (NSMA__tstQueuedCall*) g_queue_pop_head(&stCalls)) != NULL)
+  {
+    g_source_destroy(pstQueued->pSource);
+    (void) pstQueued->pfCallback(pstQueued->pUserData);
+
+    g_source_unref(pstQueued->pSource);
+    g_free(pstQueued);
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function answers a method call, which can not be handled anymore, because the NSM stops.
+*
+* @param pInvocation: Invocation of the method call. Its reference is passed to the function.
+*
+**********************************************************************************************************************/
+static void NSMA__vRejectInvocation(GDBusMethodInvocation *pInvocation)
+{
+  g_dbus_method_invocation_return_error(pInvocation,
+                                        G_DBUS_ERROR,
+                                        G_DBUS_ERROR_NO_SERVER,
+                                        "NodeStateManager is stopping. Method %s has not been executed",
+                                        g_dbus_method_invocation_get_method_name(pInvocation));
+}
+
+
+/**********************************************************************************************************************
+*
+* The function attaches an idle source to a main context. Unlike g_main_context_invoke, the callback is never called
+* inline by the calling thread, even if it could acquire the context. It is always dispatched by the loop of the
+* context. Like this, core calls are not executed in the D-Bus thread and a quit is not lost before the loop runs.
+*
+* @param pContext:    Context to attach the source to. NULL for the default context (core).
+* @param i32Priority: Priority of the source
+* @param pfCallback:  Function called by the loop of the context
+* @param pUserData:   Data passed to the function
+*
+**********************************************************************************************************************/
+static void NSMA__vAttachIdle(GMainContext *pContext,
+                              const gint    i32Priority,
+                              GSourceFunc   pfCallback,
+                              gpointer      pUserData)
+{
+  GSource *pSource = g_idle_source_new();
+
+  g_source_set_priority(pSource, i32Priority);
+  g_source_set_callback(pSource, pfCallback, pUserData, NULL);
+  (void) g_source_attach(pSource, pContext);
+  g_source_unref(pSource);
+}
+
+
+/**********************************************************************************************************************
+*
+* The marshaller is called in the D-Bus thread, when a method that changes the state of the NSM has been received.
+* Instead of calling the method handler, the parameters of the "handle-*" signal are copied and the call is queued
+* to the core context. Like this, a slow NSM or NSMC does not block the D-Bus thread.
+*
+* @param pClosure:        Queue closure. Its data is the method handler (NSMA__tstCoreHandler).
+* @param pReturnValue:    Return value of the signal. Set to TRUE, because the invocation is answered by the core.
+* @param u32ParamCount:   Number of signal parameters
+* @param pParams:         Signal parameters (object, invocation, method arguments)
+* @param pInvocationHint: Invocation hint (not used)
+* @param pMarshalData:    Marshal data (not used)
+*
+**********************************************************************************************************************/
+static void NSMA__vQueueCoreCall(GClosure     *pClosure,
+                                 GValue       *pReturnValue,
+                                 guint         u32ParamCount,
+                                 const GValue *pParams,
+                                 gpointer      pInvocationHint,
+                                 gpointer      pMarshalData)
+{
+  /* Function local variables                                                                          */
+  NSMA__tstCoreHandler *pstHandler  = (NSMA__tstCoreHandler*) pClosure->data; /* Handler of the method */
+  NSMA__tstCoreCall    *pstCall     = NULL;                                    /* Call queued for core  */
+  guint                 u32ParamIdx = 0;
+
+  pstCall                = g_new0(NSMA__tstCoreCall, 1);
+  pstCall->pCoreClosure  = pstHandler->pCoreClosure;
+  pstCall->u32ParamCount = u32ParamCount;
+  pstCall->pParams       = g_new0(GValue, u32ParamCount);
+
+  /* Copy the parameters. Objects (skeleton, invocation) are referenced, strings are duplicated */
+  for(u32ParamIdx = 0; u32ParamIdx < u32ParamCount; u32ParamIdx++)
+  {
+    g_value_init(&pstCall->pParams[u32ParamIdx], G_VALUE_TYPE(&pParams[u32ParamIdx]));
+    g_value_copy(&pParams[u32ParamIdx], &pstCall->pParams[u32ParamIdx]);
+  }
+
+  /* Queue the call to the core with the priority of its method. The default main context is owned by the core loop */
+  NSMA__vQueueForCore(pstHandler->i32Priority, &NSMA__boInvokeCoreCall, pstCall);
+
+  if(pReturnValue != NULL)
+  {
+    g_value_set_boolean(pReturnValue, TRUE);
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function connects a method handler of a skeleton object. The handler is not called in the D-Bus thread,
+* where the "handle-*" signal is emitted, but queued for the core context (see NSMA__vQueueCoreCall).
+*
+* @param pInstance:   Skeleton object that emits the signal
+* @param sSignal:     Name of the "handle-*" signal
+* @param pfHandler:   Method handler that will be called in the core context
+* @param i32Priority: Priority class of the method (NSMA__PRIORITY_*)
+*
+**********************************************************************************************************************/
+static void NSMA__vConnectCoreHandler(gpointer     pInstance,
+                                      const gchar *sSignal,
+                                      GCallback    pfHandler,
+                                      const gint   i32Priority)
+{
+  /* Function local variables                                                       */
+  NSMA__tstCoreHandler *pstHandler    = NULL; /* Handler and priority of the method  */
+  GClosure             *pQueueClosure = NULL; /* Queues the call in the D-Bus thread */
+
+  pstHandler               = g_new0(NSMA__tstCoreHandler, 1);
+  pstHandler->i32Priority  = i32Priority;
+  pstHandler->pCoreClosure = g_cclosure_new(pfHandler, NULL, NULL);
+  g_closure_set_marshal(pstHandler->pCoreClosure, &g_cclosure_marshal_generic);
+  g_closure_ref(pstHandler->pCoreClosure);
+  g_closure_sink(pstHandler->pCoreClosure);
+
+  pQueueClosure = g_closure_new_simple(sizeof(GClosure), pstHandler);
+  g_closure_set_marshal(pQueueClosure, &NSMA__vQueueCoreCall);
+
+  (void) g_signal_connect_closure(pInstance, sSignal, pQueueClosure, FALSE);
+}
+
+
+#ifdef NSMA_VTABLE_DISPATCH
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread for every method call on the Consumer interface, when the interface is
+* dispatched via the hand-written vtable. It replaces the "handle-*" signals of the generated skeleton, which cost a
+* signal emission, the unpacking of the parameters into GValues and a closure marshalling per call.
+* The typed method handlers of the skeleton dispatch are reused: they only return the invocation. Read-only queries
+* are answered directly. Methods that change the state of the NSM are queued for the core context.
+*
+* @param pConnection:    Connection the call has been received on
+* @param sSender:        Unique bus name of the caller
+* @param sObjectPath:    Object path of the call (NSM_CONSUMER_OBJECT)
+* @param sInterfaceName: Interface of the call (org.genivi.NodeStateManager.Consumer)
+* @param sMethodName:    Name of the called method
+* @param pParameters:    Parameters of the call. The signature has already been checked by GDBus.
+* @param pInvocation:    Method invocation. Ownership is passed to the function that returns the call.
+* @param pUserData:      Optionally user data (not used)
+*
+**********************************************************************************************************************/
+static void NSMA__vOnConsumerMethodCall(GDBusConnection       *pConnection,
+                                        const gchar           *sSender,
+                                        const gchar           *sObjectPath,
+                                        const gchar           *sInterfaceName,
+                                        const gchar           *sMethodName,
+                                        GVariant              *pParameters,
+                                        GDBusMethodInvocation *pInvocation,
+                                        gpointer               pUserData)
+{
+  /* Function local variables                          */
+  const gchar *sSessionName     = NULL;  /* GetSessionState  */
+  gint         i32SeatId        = 0;     /* GetSessionState  */
+  guint        u32NodeStateMask = 0;     /* WaitForNodeState */
+  guint        u32TimeoutMs     = 0;     /* WaitForNodeState */
+  gboolean     boReset          = FALSE; /* GetStatistics    */
+
+  if(NSMA__boAdmitCall(pInvocation) == FALSE)
+  {
+    /* The caller is over its rate limit. The invocation already has been answered with an error. */
+  }
+  else if(g_strcmp0(sMethodName, "GetNodeState") == 0)
+  {
+    (void) NSMA__boOnHandleGetNodeState(NSMA__pNodeStateConsumerObj, pInvocation, NULL);
+  }
+  else if(g_strcmp0(sMethodName, "GetSessionState") == 0)
+  {
+    g_variant_get(pParameters, "(&si)", &sSessionName, &i32SeatId);
+    (void) NSMA__boOnHandleGetSessionState(NSMA__pNodeStateConsumerObj, pInvocation, sSessionName, i32SeatId, NULL);
+  }
+  else if(g_strcmp0(sMethodName, "GetApplicationMode") == 0)
+  {
+    (void) NSMA__boOnHandleGetApplicationMode(NSMA__pNodeStateConsumerObj, pInvocation, NULL);
+  }
+  else if(g_strcmp0(sMethodName, "GetAppHealthCount") == 0)
+  {
+    (void) NSMA__boOnHandleGetAppHealthCount(NSMA__pNodeStateConsumerObj, pInvocation, NULL);
+  }
+  else if(g_strcmp0(sMethodName, "GetInterfaceVersion") == 0)
+  {
+    (void) NSMA__boOnHandleGetInterfaceVersion(NSMA__pNodeStateConsumerObj, pInvocation, NULL);
+  }
+  else if(g_strcmp0(sMethodName, "WaitForNodeState") == 0)
+  {
+    g_variant_get(pParameters, "(uu)", &u32NodeStateMask, &u32TimeoutMs);
+    (void) NSMA__boOnHandleWaitForNodeState(NSMA__pNodeStateConsumerObj, pInvocation, u32NodeStateMask, u32TimeoutMs, NULL);
+  }
+  else if(g_strcmp0(sMethodName, "GetStatistics") == 0)
+  {
+    g_variant_get(pParameters, "(b)", &boReset);
+    (void) NSMA__boOnHandleGetStatistics(NSMA__pNodeStateConsumerObj, pInvocation, boReset, NULL);
+  }
+  else if(g_strcmp0(sMethodName, "GetClientStatistics") == 0)
+  {
+    (void) NSMA__boOnHandleGetClientStatistics(NSMA__pNodeStateConsumerObj, pInvocation, NULL);
+  }
+  else
+  {
+    /* The method changes the state of the NSM. The invocation holds the parameters and is queued for the core */
+    NSMA__vQueueForCore(NSMA__i32GetConsumerPriority(sMethodName), &NSMA__boInvokeConsumerMethod, pInvocation);
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the core context for a method call on the Consumer interface, which has been queued by
+* NSMA__vOnConsumerMethodCall. The parameters are unpacked and the method handler, which is also used by the
+* skeleton dispatch, is called. The handler returns the invocation. If the core loop has ended, the invocation is rejected.
+*
+* @param pUserData: Method invocation (GDBusMethodInvocation) of the queued call
+*
+* @return FALSE: Remove the idle source. The call is only executed once.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boInvokeConsumerMethod(gpointer pUserData)
+{
+  /* Function local variables. The meaning of the arguments depends on the called method. */
+  GDBusMethodInvocation *pInvocation = (GDBusMethodInvocation*) pUserData;
+  const gchar           *sMethodName = NULL;
+  GVariant              *pParameters = NULL;
+  const gchar           *sArg1       = NULL;
+  const gchar           *sArg2       = NULL;
+  guint                  u32Arg1     = 0;
+  guint                  u32Arg2     = 0;
+  gint                   i32Arg1     = 0;
+  gint                   i32Arg2     = 0;
+
+  sMethodName = g_dbus_method_invocation_get_method_name(pInvocation);
+  pParameters = g_dbus_method_invocation_get_parameters(pInvocation);
+
+  if(NSMA__boRejectCoreCalls == TRUE)
+  {
+    NSMA__vRejectInvocation(pInvocation);
+  }
+  else if(g_strcmp0(sMethodName, "SetSessionState") == 0)
+  {
+    g_variant_get(pParameters, "(&s&sii)", &sArg1, &sArg2, &i32Arg1, &i32Arg2);
+    (void) NSMA__boOnHandleSetSessionState(NSMA__pNodeStateConsumerObj, pInvocation, sArg1, sArg2, i32Arg1, i32Arg2, NULL);
+  }
+  else if(g_strcmp0(sMethodName, "RegisterSession") == 0)
+  {
+    g_variant_get(pParameters, "(&s&sii)", &sArg1, &sArg2, &i32Arg1, &i32Arg2);
+    (void) NSMA__boOnHandleRegisterSession(NSMA__pNodeStateConsumerObj, pInvocation, sArg1, sArg2, i32Arg1, i32Arg2, NULL);
+  }
+  else if(g_strcmp0(sMethodName, "UnRegisterSession") == 0)
+  {
+    g_variant_get(pParameters, "(&s&si)", &sArg1, &sArg2, &i32Arg1);
+    (void) NSMA__boOnHandleUnRegisterSession(NSMA__pNodeStateConsumerObj, pInvocation, sArg1, sArg2, i32Arg1, NULL);
+  }
+  else if(g_strcmp0(sMethodName, "RegisterShutdownClient") == 0)
+  {
+    g_variant_get(pParameters, "(&s&suu)", &sArg1, &sArg2, &u32Arg1, &u32Arg2);
+    (void) NSMA__boOnHandleRegisterLifecycleClient(NSMA__pNodeStateConsumerObj,
+                                                   pInvocation,
+                                                   sArg1,
+                                                   sArg2,
+                                                   u32Arg1,
+                                                   u32Arg2,
+                                                   NULL);
+  }
+  else if(g_strcmp0(sMethodName, "RegisterSeatShutdownClient") == 0)
+  {
+    g_variant_get(pParameters, "(&s&suui)", &sArg1, &sArg2, &u32Arg1, &u32Arg2, &i32Arg1);
+    (void) NSMA__boOnHandleRegisterSeatLifecycleClient(NSMA__pNodeStateConsumerObj,
+                                                       pInvocation,
+                                                       sArg1,
+                                                       sArg2,
+                                                       u32Arg1,
+                                                       u32Arg2,
+                                                       i32Arg1,
+                                                       NULL);
+  }
+  else if(g_strcmp0(sMethodName, "RegisterLoadSheddingClient") == 0)
+  {
+    g_variant_get(pParameters, "(&s&suu)", &sArg1, &sArg2, &u32Arg1, &u32Arg2);
+    (void) NSMA__boOnHandleRegisterLoadSheddingClient(NSMA__pNodeStateConsumerObj,
+                                                      pInvocation,
+                                                      sArg1,
+                                                      sArg2,
+                                                      u32Arg1,
+                                                      u32Arg2,
+                                                      NULL);
+  }
+  else if(g_strcmp0(sMethodName, "UnRegisterShutdownClient") == 0)
+  {
+    g_variant_get(pParameters, "(&s&su)", &sArg1, &sArg2, &u32Arg1);
+    (void) NSMA__boOnHandleUnRegisterLifecycleClient(NSMA__pNodeStateConsumerObj,
+                                                     pInvocation,
+                                                     sArg1,
+                                                     sArg2,
+                                                     u32Arg1,
+                                                     NULL);
+  }
+  else if(g_strcmp0(sMethodName, "LifecycleRequestComplete") == 0)
+  {
+    g_variant_get(pParameters, "(ui)", &u32Arg1, &i32Arg1);
+    (void) NSMA__boOnHandleLifecycleRequestComplete(NSMA__pNodeStateConsumerObj, pInvocation, u32Arg1, i32Arg1, NULL);
+  }
+  else
+  {
+    /* Error: The method is part of the interface, but not handled */
+    g_dbus_method_invocation_return_error(pInvocation,
+                                          G_DBUS_ERROR,
+                                          G_DBUS_ERROR_UNKNOWN_METHOD,
+                                          "Method %s is not handled",
+                                          sMethodName);
+  }
+
+  return FALSE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function returns the priority, with which a queued method of the Consumer interface is dispatched in the core.
+* It assigns the same priority classes as the connections of the skeleton handlers in NSMA__vOnBusAcquired.
+*
+* @param sMethodName: Name of the queued method
+*
+* @return Priority of the method (NSMA__PRIORITY_*)
+*
+**********************************************************************************************************************/
+static gint NSMA__i32GetConsumerPriority(const gchar *sMethodName)
+{
+  gint i32Priority = NSMA__PRIORITY_CLIENT;
+
+  if(g_strcmp0(sMethodName, "LifecycleRequestComplete") == 0)
+  {
+    i32Priority = NSMA__PRIORITY_LIFECYCLE;
+  }
+  else if(   (g_strcmp0(sMethodName, "RegisterSession")   == 0)
+          || (g_strcmp0(sMethodName, "UnRegisterSession") == 0)
+          || (g_strcmp0(sMethodName, "SetSessionState")   == 0))
+  {
+    i32Priority = NSMA__PRIORITY_SESSION;
+  }
+
+  return i32Priority;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread, when a property of the Consumer interface is read and the interface is
+* dispatched via the hand-written vtable. The values are still stored in the (unexported) skeleton object.
+*
+* @param pConnection:    Connection the call has been received on
+* @param sSender:        Unique bus name of the caller
+* @param sObjectPath:    Object path of the call (NSM_CONSUMER_OBJECT)
+* @param sInterfaceName: Interface of the call (org.genivi.NodeStateManager.Consumer)
+* @param sPropertyName:  Name of the property
+* @param ppError:        Set, if the property is unknown
+* @param pUserData:      Optionally user data (not used)
+*
+* @return Floating value of the property or NULL, if the property is unknown
+*
+**********************************************************************************************************************/
+static GVariant* NSMA__pOnConsumerGetProperty(GDBusConnection  *pConnection,
+                                              const gchar      *sSender,
+                                              const gchar      *sObjectPath,
+                                              const gchar      *sInterfaceName,
+                                              const gchar      *sPropertyName,
+                                              GError          **ppError,
+                                              gpointer          pUserData)
+{
+  /* Function local variables                                         */
+  GVariant *pProperties = NULL; /* All properties of the skeleton      */
+  GVariant *pValue      = NULL; /* Value of the property. Return value */
+
+  pProperties = g_dbus_interface_skeleton_get_properties(G_DBUS_INTERFACE_SKELETON(NSMA__pNodeStateConsumerObj));
+  pValue      = g_variant_lookup_value(pProperties, sPropertyName, NULL);
+  g_variant_unref(pProperties);
+
+  if(pValue == NULL)
+  {
+    g_set_error(ppError, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS, "Unknown property %s", sPropertyName);
+  }
+
+  return pValue;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called, when a property of the skeleton object has been changed by the NSM and the Consumer
+* interface is dispatched via the hand-written vtable. The skeleton is not exported and does not send the
+* "PropertiesChanged" signal itself. The signal is sent with the current value of the changed property only.
+* The GObject property of the skeleton is named like the D-Bus property in lower case with hyphens
+* (e.g. "restart-reason" for "RestartReason").
+*
+* @param pObject:    Skeleton object whose property changed
+* @param pParamSpec: Specification of the changed property
+* @param pUserData:  Optionally user data (not used)
+*
+**********************************************************************************************************************/
+static void NSMA__vOnConsumerPropertyNotify(GObject *pObject, GParamSpec *pParamSpec, gpointer pUserData)
+{
+  /* Function local variables                                                 */
+  GDBusInterfaceInfo *pInterfaceInfo = node_state_consumer_interface_info();
+  GDBusPropertyInfo  *pPropertyInfo  = NULL; /* D-Bus property of pParamSpec  */
+  GVariant           *pProperties    = NULL; /* All properties of skeleton    */
+  GVariant           *pValue         = NULL; /* Value of the changed property */
+  GVariantBuilder     stChanged;             /* Changed properties a{sv}      */
+  GString            *sHyphenName    = NULL; /* Property name with hyphens    */
+  const gchar        *pChar          = NULL;
+  guint               u32Idx         = 0;
+
+  /* Find the D-Bus property, whose name converted to lower case with hyphens matches the GObject property */
+  sHyphenName = g_string_sized_new(32);
+
+  for(u32Idx = 0; (pPropertyInfo == NULL) && (pInterfaceInfo->properties[u32Idx] != NULL); u32Idx++)
+  {
+    g_string_truncate(sHyphenName, 0);
+
+    for(pChar = pInterfaceInfo->properties[u32Idx]->name; *pChar != '\0'; pChar++)
+    {
+      if((g_ascii_isupper(*pChar) == TRUE) && (pChar != pInterfaceInfo->properties[u32Idx]->name))
+      {
+        g_string_append_c(sHyphenName, '-');
+      }
+
+      g_string_append_c(sHyphenName, g_ascii_tolower(*pChar));
+    }
+
+    if(g_strcmp0(sHyphenName->str, g_param_spec_get_name(pParamSpec)) == 0)
+    {
+      pPropertyInfo = pInterfaceInfo->properties[u32Idx];
+    }
+  }
+
+  (void) g_string_free(sHyphenName, TRUE);
+
+  if(pPropertyInfo != NULL)
+  {
+    pProperties = g_dbus_interface_skeleton_get_properties(G_DBUS_INTERFACE_SKELETON(pObject));
+    pValue      = g_variant_lookup_value(pProperties, pPropertyInfo->name, NULL);
+    g_variant_unref(pProperties);
+  }
+
+  if(pValue != NULL)
+  {
+    g_variant_builder_init(&stChanged, G_VARIANT_TYPE("a{sv}"));
+    g_variant_builder_add(&stChanged, "{sv}", pPropertyInfo->name, pValue);
+    g_variant_unref(pValue);
+
+    NSMA__vEmitConsumerSignal("org.freedesktop.DBus.Properties",
+                              "PropertiesChanged",
+                              g_variant_new("(s@a{sv}@as)",
+                                            pInterfaceInfo->name,
+                                            g_variant_builder_end(&stChanged),
+                                            g_variant_new_strv(NULL, 0)));
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function sends a signal from the Consumer object, when the interface is dispatched via the hand-written
+* vtable. The signal is sent on the bus and to all peers, on which the vtable has been registered. If the interface
+* has not been registered yet, the signal is dropped like by an unexported skeleton.
+*
+* @param sInterfaceName: Interface of the signal
+* @param sSignalName:    Name of the signal
+* @param pParameters:    Floating tuple with the signal parameters
+*
+**********************************************************************************************************************/
+static void NSMA__vEmitConsumerSignal(const gchar *sInterfaceName, const gchar *sSignalName, GVariant *pParameters)
+{
+#ifdef NSMA_P2P_SOCKET
+  GSList        *pListEntry = NULL;
+  NSMA__tstPeer *pstPeer    = NULL;
+#endif
+
+  g_variant_ref_sink(pParameters);
+
+  if(NSMA__u32ConsumerRegId != 0)
+  {
+    (void) g_dbus_connection_emit_signal(NSMA__pBusConnection,
+                                         NULL,
+                                         NSM_CONSUMER_OBJECT,
+                                         sInterfaceName,
+                                         sSignalName,
+                                         pParameters,
+                                         NULL);
+  }
+
+#ifdef NSMA_P2P_SOCKET
+  g_mutex_lock(NSMA__pPeersMutex);
+
+  for(pListEntry = NSMA__pPeers; pListEntry != NULL; pListEntry = g_slist_next(pListEntry))
+  {
+    pstPeer = (NSMA__tstPeer*) pListEntry->data;
+
+    if(pstPeer->u32ConsumerRegId != 0)
+    {
+      (void) g_dbus_connection_emit_signal(pstPeer->pConnection,
+                                           NULL,
+                                           NSM_CONSUMER_OBJECT,
+                                           sInterfaceName,
+                                           sSignalName,
+                                           pParameters,
+                                           NULL);
+    }
+  }
+
+  g_mutex_unlock(NSMA__pPeersMutex);
+#endif
+
+  g_variant_unref(pParameters);
+}
+#endif
+
+
+/**********************************************************************************************************************
+*
+* The function is called when a connection to the D-Bus could be established.
+*
+* @param pConnection: Connection, which was acquired
+* @param sName:       Bus name
+* @param pUserData:   Optionally user data
+*
+* @return void
+*
+**********************************************************************************************************************/
+static void NSMA__vOnBusAcquired(GDBusConnection *pConnection, const gchar* sName, gpointer pUserData)
+{
+  /* Store the connection. Needed later, to create life cycle clients. */
+  NSMA__pBusConnection = pConnection;
+
+  /* Do not automatically exit the main loop when connection is lost.
+   * The program terminates nevertheless, but will give useful traces.
+   */
+  g_dbus_connection_set_exit_on_close(NSMA__pBusConnection, FALSE);
+
+#ifndef NSMA_VTABLE_DISPATCH
+  /* Register the callbacks. Read-only queries are answered directly in the D-Bus thread */
+  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-node-state", G_CALLBACK(NSMA__boOnHandleGetNodeState), NULL);
+  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-application-mode", G_CALLBACK(NSMA__boOnHandleGetApplicationMode), NULL);
+  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-session-state", G_CALLBACK(NSMA__boOnHandleGetSessionState), NULL);
+  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-app-health-count", G_CALLBACK(NSMA__boOnHandleGetAppHealthCount), NULL);
+  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-interface-version", G_CALLBACK(NSMA__boOnHandleGetInterfaceVersion), NULL);
+  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-wait-for-node-state", G_CALLBACK(NSMA__boOnHandleWaitForNodeState), NULL);
+  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-statistics", G_CALLBACK(NSMA__boOnHandleGetStatistics), NULL);
+  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "handle-get-client-statistics", G_CALLBACK(NSMA__boOnHandleGetClientStatistics), NULL);
+  (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "g-authorize-method", G_CALLBACK(NSMA__boOnAuthorizeMethod), NULL);
+#endif
+  (void) g_signal_connect(NSMA__pLifecycleControlObj, "g-authorize-method", G_CALLBACK(NSMA__boOnAuthorizeMethod), NULL);
+
+  /* Remove the accounting of callers, which left the bus */
+  NSMA__u32NameOwnerSubId = g_dbus_connection_signal_subscribe(NSMA__pBusConnection,
+                                                                "org.freedesktop.DBus",
+                                                                "org.freedesktop.DBus",
+                                                                "NameOwnerChanged",
+                                                                "/org/freedesktop/DBus",
+                                                                NULL,
+                                                                G_DBUS_SIGNAL_FLAGS_NONE,
+                                                                &NSMA__vOnNameOwnerChanged,
+                                                                NULL,
+                                                                NULL);
+
+  /* Methods that change the state of the NSM are queued for the core context with the priority of their class */
+  NSMA__vConnectCoreHandler(NSMA__pLifecycleControlObj, "handle-set-boot-mode", G_CALLBACK(NSMA__boOnHandleSetBootMode), NSMA__PRIORITY_LIFECYCLE);
+  NSMA__vConnectCoreHandler(NSMA__pLifecycleControlObj, "handle-set-node-state", G_CALLBACK(NSMA__boOnHandleSetNodeState), NSMA__PRIORITY_LIFECYCLE);
+  NSMA__vConnectCoreHandler(NSMA__pLifecycleControlObj, "handle-set-application-mode", G_CALLBACK(NSMA__boOnHandleSetApplicationMode), NSMA__PRIORITY_LIFECYCLE);
+  NSMA__vConnectCoreHandler(NSMA__pLifecycleControlObj, "handle-request-node-restart", G_CALLBACK(NSMA__boOnHandleRequestNodeRestart), NSMA__PRIORITY_LIFECYCLE);
+  NSMA__vConnectCoreHandler(NSMA__pLifecycleControlObj, "handle-check-luc-required", G_CALLBACK(NSMA__boOnHandleCheckLucRequired), NSMA__PRIORITY_LIFECYCLE);
+  NSMA__vConnectCoreHandler(NSMA__pLifecycleControlObj, "handle-set-app-health-status", G_CALLBACK(NSMA__boOnHandleSetAppHealthStatus), NSMA__PRIORITY_LIFECYCLE);
+  NSMA__vConnectCoreHandler(NSMA__pLifecycleControlObj, "handle-request-seat-lifecycle", G_CALLBACK(NSMA__boOnHandleRequestSeatLifecycle), NSMA__PRIORITY_LIFECYCLE);
+  NSMA__vConnectCoreHandler(NSMA__pLifecycleControlObj, "handle-reexec", G_CALLBACK(NSMA__boOnHandleReexec), NSMA__PRIORITY_LIFECYCLE);
+#ifndef NSMA_VTABLE_DISPATCH
+  NSMA__vConnectCoreHandler(NSMA__pNodeStateConsumerObj, "handle-register-session", G_CALLBACK(NSMA__boOnHandleRegisterSession), NSMA__PRIORITY_SESSION);
+  NSMA__vConnectCoreHandler(NSMA__pNodeStateConsumerObj, "handle-un-register-session", G_CALLBACK(NSMA__boOnHandleUnRegisterSession), NSMA__PRIORITY_SESSION);
+  NSMA__vConnectCoreHandler(NSMA__pNodeStateConsumerObj, "handle-set-session-state", G_CALLBACK(NSMA__boOnHandleSetSessionState), NSMA__PRIORITY_SESSION);
+  NSMA__vConnectCoreHandler(NSMA__pNodeStateConsumerObj, "handle-register-shutdown-client", G_CALLBACK(NSMA__boOnHandleRegisterLifecycleClient), NSMA__PRIORITY_CLIENT);
+  NSMA__vConnectCoreHandler(NSMA__pNodeStateConsumerObj, "handle-register-seat-shutdown-client", G_CALLBACK(NSMA__boOnHandleRegisterSeatLifecycleClient), NSMA__PRIORITY_CLIENT);
+  NSMA__vConnectCoreHandler(NSMA__pNodeStateConsumerObj, "handle-register-load-shedding-client", G_CALLBACK(NSMA__boOnHandleRegisterLoadSheddingClient), NSMA__PRIORITY_CLIENT);
+  NSMA__vConnectCoreHandler(NSMA__pNodeStateConsumerObj, "handle-un-register-shutdown-client", G_CALLBACK(NSMA__boOnHandleUnRegisterLifecycleClient), NSMA__PRIORITY_CLIENT);
+  NSMA__vConnectCoreHandler(NSMA__pNodeStateConsumerObj, "handle-lifecycle-request-complete", G_CALLBACK(NSMA__boOnHandleLifecycleRequestComplete), NSMA__PRIORITY_LIFECYCLE);
+#endif
+
+  /* Export the interfaces */
+  if(NSMA__boExportObjects(NSMA__pBusConnection, &NSMA__u32ConsumerRegId, TRUE) == TRUE)
+  {
+#ifdef NSMA_P2P_SOCKET
+    /* Additionally offer the Consumer interface to local peers. The NSM also works without, if this fails. */
+    NSMA__vStartPeerServer();
+#endif
+  }
+  else
+  {
+    /* Error: The interfaces could not be exported */
+    NSMA__boLoopEndByUser = FALSE;
+    g_main_loop_quit(NSMA__pMainLoop);
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function exports the Consumer and optionally the LifecycleControl interface on a connection. The Consumer
+* interface is either exported by its skeleton or registered with the hand-written vtable (NSMA_VTABLE_DISPATCH).
+*
+* @param pConnection:        Bus or peer-to-peer connection
+* @param pu32ConsumerRegId:  Returns the registration of the Consumer vtable. 0, if the skeleton has been exported.
+* @param boLifecycleControl: TRUE: Also export the LifecycleControl interface. Only done on the bus, where its
+*                            access is restricted by the bus policy.
+*
+* @return TRUE:  The interfaces have been exported
+*         FALSE: Error. The interfaces could not be exported.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boExportObjects(GDBusConnection *pConnection, guint *pu32ConsumerRegId, gboolean boLifecycleControl)
+{
+  gboolean boRetVal = FALSE;
+
+  *pu32ConsumerRegId = 0;
+
+#ifdef NSMA_VTABLE_DISPATCH
+  /* The Consumer interface is registered with the hand-written vtable. Its skeleton only stores the properties. */
+  *pu32ConsumerRegId = g_dbus_connection_register_object(pConnection,
+                                                         NSM_CONSUMER_OBJECT,
+                                                         node_state_consumer_interface_info(),
+                                                         &NSMA__stConsumerVTable,
+                                                         NULL,
+                                                         NULL,
+                                                         NULL);
+  boRetVal = (*pu32ConsumerRegId != 0);
+#else
+  boRetVal = g_dbus_interface_skeleton_export(G_DBUS_INTERFACE_SKELETON(NSMA__pNodeStateConsumerObj),
+                                              pConnection,
+                                              NSM_CONSUMER_OBJECT,
+                                              NULL);
+#endif
+
+  if((boRetVal == TRUE) && (boLifecycleControl == TRUE))
+  {
+    boRetVal = g_dbus_interface_skeleton_export(G_DBUS_INTERFACE_SKELETON(NSMA__pLifecycleControlObj),
+                                                pConnection,
+                                                NSM_LIFECYCLE_OBJECT,
+                                                NULL);
+  }
+
+  return boRetVal;
+}
+
+
+#ifdef NSMA_P2P_SOCKET
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread, when a local peer connected to the socket NSMA_P2P_SOCKET and passed
+* the authentication. The credentials of the socket (SO_PEERCRED) are checked. Only processes of root or of the user
+* of the NSM are accepted. Other peers have to use the bus and its policy.
+*
+* @param pObserver:    Authentication observer of the server
+* @param pStream:      Stream of the new connection
+* @param pCredentials: Credentials received during authentication (not used, SO_PEERCRED is read instead)
+* @param pUserData:    Optionally user data (not used)
+*
+* @return TRUE: The peer is authorized. FALSE: The connection is rejected.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnAuthorizePeer(GDBusAuthObserver *pObserver,
+                                        GIOStream         *pStream,
+                                        GCredentials      *pCredentials,
+                                        gpointer           pUserData)
+{
+  /* Function local variables                                      */
+  gboolean      boAuthorized = FALSE;              /* Return value */
+  struct ucred  stPeerCred;                        /* SO_PEERCRED  */
+  socklen_t     u32CredSize  = sizeof(stPeerCred);
+  gint          i32SocketFd  = -1;
+
+  if(G_IS_SOCKET_CONNECTION(pStream) == TRUE)
+  {
+    i32SocketFd = g_socket_get_fd(g_socket_connection_get_socket(G_SOCKET_CONNECTION(pStream)));
+
+    if(getsockopt(i32SocketFd, SOL_SOCKET, SO_PEERCRED, &stPeerCred, &u32CredSize) == 0)
+    {
+      boAuthorized = (stPeerCred.uid == 0) || (stPeerCred.uid == geteuid());
+    }
+  }
+
+  return boAuthorized;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread for a new authorized peer-to-peer connection. The Consumer interface is
+* exported on the connection and the peer is added to the list of peers, which receive the signals of the NSM.
+* The LifecycleControl interface is not offered to peers. It is only reachable via the bus and its policy.
+*
+* @param pServer:     Peer-to-peer server
+* @param pConnection: New connection
+* @param pUserData:   Optionally user data (not used)
+*
+* @return TRUE: The connection is kept. FALSE: The interface could not be exported. The connection is closed.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnPeerConnection(GDBusServer *pServer, GDBusConnection *pConnection, gpointer pUserData)
+{
+  gboolean       boRetVal = FALSE;
+  NSMA__tstPeer *pstPeer  = NULL;
+
+  pstPeer              = g_new0(NSMA__tstPeer, 1);
+  pstPeer->pConnection = g_object_ref(pConnection);
+
+  if(NSMA__boExportObjects(pConnection, &pstPeer->u32ConsumerRegId, FALSE) == TRUE)
+  {
+    boRetVal = TRUE;
+
+    (void) g_signal_connect(pConnection, "closed", G_CALLBACK(NSMA__vOnPeerClosed), pstPeer);
+
+    g_mutex_lock(NSMA__pPeersMutex);
+    NSMA__pPeers = g_slist_prepend(NSMA__pPeers, pstPeer);
+    g_mutex_unlock(NSMA__pPeersMutex);
+  }
+  else
+  {
+    /* Error: The interface could not be exported. Reject the connection. */
+    g_object_unref(pstPeer->pConnection);
+    g_free(pstPeer);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread, when a peer-to-peer connection has been closed. The interface is
+* removed from the connection and the peer is released.
+*
+* @param pConnection:          Closed connection
+* @param boRemotePeerVanished: TRUE, if the peer closed the connection
+* @param pError:               Reason why the connection has been closed (not used)
+* @param pUserData:            Peer (NSMA__tstPeer) of the connection
+*
+**********************************************************************************************************************/
+static void NSMA__vOnPeerClosed(GDBusConnection *pConnection,
+                                gboolean         boRemotePeerVanished,
+                                GError          *pError,
+                                gpointer         pUserData)
+{
+  NSMA__tstPeer *pstPeer = (NSMA__tstPeer*) pUserData;
+  gchar          sPeerKey[NSMA__PEER_KEY_LENGTH];
+
+  g_mutex_lock(NSMA__pPeersMutex);
+  NSMA__pPeers = g_slist_remove(NSMA__pPeers, pstPeer);
+  g_mutex_unlock(NSMA__pPeersMutex);
+
+  /* Remove the accounting of the peer (see NSMA__sGetSenderKey) */
+  (void) g_snprintf(sPeerKey, NSMA__PEER_KEY_LENGTH, "peer@%p", (void*) pConnection);
+  g_mutex_lock(NSMA__pSendersMutex);
+  (void) g_hash_table_remove(NSMA__pSenders, sPeerKey);
+  g_mutex_unlock(NSMA__pSendersMutex);
+
+  (void) g_signal_handlers_disconnect_by_func(pConnection, G_CALLBACK(NSMA__vOnPeerClosed), pstPeer);
+
+  if(pstPeer->u32ConsumerRegId != 0)
+  {
+    (void) g_dbus_connection_unregister_object(pConnection, pstPeer->u32ConsumerRegId);
+  }
+  else
+  {
+    g_dbus_interface_skeleton_unexport_from_connection(G_DBUS_INTERFACE_SKELETON(NSMA__pNodeStateConsumerObj),
+                                                       pConnection);
+  }
+
+  g_object_unref(pstPeer->pConnection);
+  g_free(pstPeer);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function starts the peer-to-peer server on the UNIX socket NSMA_P2P_SOCKET in the D-Bus thread. Like this,
+* chatty local clients do not need to go through the bus daemon. A stale socket file of a former NSM is removed.
+* The socket can only be opened by the user and the group of the NSM. The peers are additionally checked via
+* SO_PEERCRED (see NSMA__boOnAuthorizePeer).
+*
+**********************************************************************************************************************/
+static void NSMA__vStartPeerServer(void)
+{
+  /* Function local variables                                      */
+  gchar             *sAddress  = NULL; /* D-Bus address of socket  */
+  gchar             *sGuid     = NULL; /* Server GUID              */
+  GDBusAuthObserver *pObserver = NULL; /* Checks the peers         */
+
+  (void) g_unlink(NSMA_P2P_SOCKET);
+
+  sAddress  = g_strdup_printf("unix:path=%s", NSMA_P2P_SOCKET);
+  sGuid     = g_dbus_generate_guid();
+  pObserver = g_dbus_auth_observer_new();
+
+  (void) g_signal_connect(pObserver, "authorize-authenticated-peer", G_CALLBACK(NSMA__boOnAuthorizePeer), NULL);
+
+  NSMA__pPeerServer = g_dbus_server_new_sync(sAddress, G_DBUS_SERVER_FLAGS_NONE, sGuid, pObserver, NULL, NULL);
+
+  if(NSMA__pPeerServer != NULL)
+  {
+    (void) g_signal_connect(NSMA__pPeerServer, "new-connection", G_CALLBACK(NSMA__boOnPeerConnection), NULL);
+    g_dbus_server_start(NSMA__pPeerServer);
+    (void) g_chmod(NSMA_P2P_SOCKET, 0660);
+  }
+
+  g_object_unref(pObserver);
+  g_free(sGuid);
+  g_free(sAddress);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function stops the peer-to-peer server, closes the connections of all peers and removes the socket file.
+*
+**********************************************************************************************************************/
+static void NSMA__vStopPeerServer(void)
+{
+  NSMA__tstPeer *pstPeer = NULL;
+
+  if(NSMA__pPeerServer != NULL)
+  {
+    g_dbus_server_stop(NSMA__pPeerServer);
+    g_object_unref(NSMA__pPeerServer);
+    NSMA__pPeerServer = NULL;
+
+    /* Close the connections. NSMA__vOnPeerClosed removes the peer from the list. */
+    while(NSMA__pPeers != NULL)
+    {
+      pstPeer = (NSMA__tstPeer*) NSMA__pPeers->data;
+      (void) g_dbus_connection_close_sync(pstPeer->pConnection, NULL, NULL);
+      NSMA__vOnPeerClosed(pstPeer->pConnection, FALSE, NULL, pstPeer);
+    }
+
+    (void) g_unlink(NSMA_P2P_SOCKET);
+  }
+}
+#endif
+
+
+/**********************************************************************************************************************
+*
+* The function is called when the "bus name" could be acquired on the D-Bus.
+*
+* @param pConnection: Connection over which the bus name was acquired
+* @param sName:       Acquired bus name
+* @param pUserData:   Optionally user data
+*
+* @return void
+*
+**********************************************************************************************************************/
+static void NSMA__vOnNameAcquired(GDBusConnection *pConnection, const gchar* sName, gpointer pUserData)
+{
+  /* Inform the NSM in its own context. From now on it can call life cycle clients. */
+  NSMA__vAttachIdle(NULL, G_PRIORITY_DEFAULT, &NSMA__boOnCoreNameAcquired, NULL);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the core context, after the "bus name" has been acquired by the D-Bus thread.
+*
+* @param pUserData: Optionally user data (not used)
+*
+* @return FALSE: Remove the idle source. The NSM only is informed once.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnCoreNameAcquired(gpointer pUserData)
+{
+  NSMA__stObjectCallbacks.pfBusNameAcquiredCb();
+
+  return FALSE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called if either no connection to D-Bus could be established or the bus name could not be acquired.
 *
 * @param pConnection: Connection. If it is NULL, no D-Bus connection could be established.
 *                     Otherwise the bus name was lost.
@@ -755,19 +3124,110 @@ static void NSMA__vOnNameLost(GDBusConnection *pConnection, const gchar* sName,
 }
 
 
+/**********************************************************************************************************************
+*
+* The function is called, when the bus daemon answered a "NameHasOwner" call started by NSMA_boCheckBusName.
+* If the call failed, the name is reported to have an owner. Like this, a client is never dropped by mistake.
+*
+* @param pSrcObject: Bus connection
+* @param pRes:       Result of "NameHasOwner"
+* @param pUserData:  Pending check (allocated by NSMA_boCheckBusName)
+*
+**********************************************************************************************************************/
+static void NSMA__vOnBusNameChecked(GObject *pSrcObject, GAsyncResult *pRes, gpointer pUserData)
+{
+  /* Function local variables                                                */
+  NSMA__tstBusNameCheck *pstCheck   = (NSMA__tstBusNameCheck*) pUserData;
+  GVariant              *pReply     = NULL;
+  gboolean               boHasOwner = TRUE;
+
+  pReply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(pSrcObject), pRes, NULL);
+
+  if(pReply != NULL)
+  {
+    g_variant_get(pReply, "(b)", &boHasOwner);
+    g_variant_unref(pReply);
+  }
+
+  pstCheck->pfCallback(pstCheck->sBusName, boHasOwner, pstCheck->pUserData);
+
+  g_free(pstCheck->sBusName);
+  g_free(pstCheck);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function searches the list of pending life cycle requests for the request that has been sent to a client.
+*
+* @param pConsumer: Proxy of the life cycle client that has been called
+*
+* @return Pointer to the pending request or NULL, if no request is pending for the client.
+*
+**********************************************************************************************************************/
+static NSMA__tstLcRequest* NSMA__pstFindLcRequest(NodeStateLifeCycleConsumer *pConsumer)
+{
+  /* Function local variables */
+  GSList             *pListEntry = NULL; /* Iterator for the list of pending requests */
+  NSMA__tstLcRequest *pstRequest = NULL; /* Pending request. Return value             */
+
+  for(pListEntry = NSMA__pLcRequests;
+      (pListEntry != NULL) && (pstRequest == NULL);
+      pListEntry = g_slist_next(pListEntry))
+  {
+    if(((NSMA__tstLcRequest*) pListEntry->data)->pConsumer == pConsumer)
+    {
+      pstRequest = (NSMA__tstLcRequest*) pListEntry->data;
+    }
+  }
+
+  return pstRequest;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function finishes a pending life cycle request. The request is removed from the list of pending requests,
+* a possibly running timer is stopped and the result is passed to the NSM.
+*
+* @param pstRequest:    Pending request that has been finished
+* @param enErrorStatus: Result of the request, which will be passed to the NSM
+*
+**********************************************************************************************************************/
+static void NSMA__vFinishLcRequest(NSMA__tstLcRequest *pstRequest, const NsmErrorStatus_e enErrorStatus)
+{
+  NSMA_tLcConsumerHandle hLcClient = (NSMA_tLcConsumerHandle) pstRequest->pConsumer;
+
+  NSMA__pLcRequests = g_slist_remove(NSMA__pLcRequests, pstRequest);
+
+  if(pstRequest->u32TimerId != 0)
+  {
+    g_source_remove(pstRequest->u32TimerId);
+  }
+
+  g_free(pstRequest);
+
+  /* Inform the NSM after the request has been removed. It may immediately call the client again. */
+  NSMA__stObjectCallbacks.pfLcClientRequestFinish(hLcClient, enErrorStatus);
+}
+
+
 /**********************************************************************************************************************
 *
 * The function is called when the async. call to a life cycle clients "LifecycleRequest" method timed out.
 *
-* @param pUserData: Optionally user data (not used)
+* @param pUserData: Pending request that timed out
 *
 * @return FALSE: Tell the loop to detach and destroy the time out source.
 *
 **********************************************************************************************************************/
 static gboolean NSMA__boHandleRequestTimeout(gpointer pUserData)
 {
-  NSMA__pCurrentLcConsumer = NULL;
-  NSMA__stObjectCallbacks.pfLcClientRequestFinish(NsmErrorStatus_Error);
+  NSMA__tstLcRequest *pstRequest = (NSMA__tstLcRequest*) pUserData;
+
+  /* The timer source is destroyed by the main loop, when FALSE is returned */
+  pstRequest->u32TimerId = 0;
+  NSMA__vFinishLcRequest(pstRequest, NsmErrorStatus_Error);
 
   return FALSE;
 }
@@ -782,14 +3242,15 @@ static gboolean NSMA__boHandleRequestTimeout(gpointer pUserData)
 *
 * @param pSrcObject: Source object that delivered the async. value
 * @param pRes:       Result of the call.
-* @param pUserData:  Optionally user data (not used).
+* @param pUserData:  Pending request, which has been created when the client was called.
 *
 **********************************************************************************************************************/
 static void NSMA__vOnLifecycleRequestFinish(GObject *pSrcObject, GAsyncResult *pRes, gpointer pUserData)
 {
   /* Function local variables.                                                                  */
-  NsmErrorStatus_e  enErrorCode  = NsmErrorStatus_NotSet; /* Error returned by lifecycle client */
-  guint             u32Timeout   = 0;
+  NsmErrorStatus_e    enErrorCode  = NsmErrorStatus_NotSet;            /* Error returned by client */
+  guint               u32Timeout   = 0;
+  NSMA__tstLcRequest *pstRequest   = (NSMA__tstLcRequest*) pUserData;  /* Request that returned    */
 
   /* Pass proxy object and async. result to get the return value of the lifecycle client's method and D-Bus errors. */
 
@@ -803,21 +3264,23 @@ static void NSMA__vOnLifecycleRequestFinish(GObject *pSrcObject, GAsyncResult *p
     if(enErrorCode == NsmErrorStatus_ResponsePending)
     {
       /* The client returned response pending. Start timer to wait for final result. */
-      u32Timeout       = g_dbus_proxy_get_default_timeout(G_DBUS_PROXY(pSrcObject));
-      NSMA__u32TimerId = g_timeout_add_full(G_PRIORITY_DEFAULT, u32Timeout, &NSMA__boHandleRequestTimeout, NULL, NULL);
+      u32Timeout             = g_dbus_proxy_get_default_timeout(G_DBUS_PROXY(pSrcObject));
+      pstRequest->u32TimerId = g_timeout_add_full(NSMA__PRIORITY_LIFECYCLE,
+                                                  u32Timeout,
+                                                  &NSMA__boHandleRequestTimeout,
+                                                  pstRequest,
+                                                  NULL);
     }
     else
     {
       /* The client returned a final value. Pass it to the NSM */
-      NSMA__pCurrentLcConsumer = NULL;
-      NSMA__stObjectCallbacks.pfLcClientRequestFinish(enErrorCode);
+      NSMA__vFinishLcRequest(pstRequest, enErrorCode);
     }
   }
   else
   {
     /* The clients return value could not be read. Pass an error to the NSM. */
-    NSMA__pCurrentLcConsumer = NULL;
-    NSMA__stObjectCallbacks.pfLcClientRequestFinish(NsmErrorStatus_Dbus);
+    NSMA__vFinishLcRequest(pstRequest, NsmErrorStatus_Dbus);
   }
 }
 
@@ -841,17 +3304,20 @@ static gboolean NSMA__boOnHandleLifecycleRequestComplete(NodeStateConsumer     *
                                                          const gint             i32Status,
                                                          gpointer               pUserData)
 {
-  NsmErrorStatus_e enErrorStatus = NsmErrorStatus_NotSet;
+  NsmErrorStatus_e   enErrorStatus = NsmErrorStatus_NotSet;
+  NSMA__tstLcRequest *pstRequest   = NULL;
+  NSMA__tstCallStat  stCall;
+
+  NSMA__vBeginCallStat(&stCall, pInvocation);
 
-  /* Check if the client is the one, we are waiting for. */
-  if(NSMA__pCurrentLcConsumer == (NodeStateLifeCycleConsumer*) u32RequestId)
+  /* Check if the client is one, we are waiting for. */
+  pstRequest = NSMA__pstFindLcRequest((NodeStateLifeCycleConsumer*) u32RequestId);
+
+  if(pstRequest != NULL)
   {
     enErrorStatus = NsmErrorStatus_Ok;
-    /* The client is the expected one. Pass the status to the NSM. */
-    NSMA__stObjectCallbacks.pfLcClientRequestFinish((NsmErrorStatus_e) i32Status);
-
-    /* Remove the timeout timer (the expected client returned) */
-    g_source_remove(NSMA__u32TimerId);
+    /* The client is an expected one. Remove the timeout timer and pass the status to the NSM. */
+    NSMA__vFinishLcRequest(pstRequest, (NsmErrorStatus_e) i32Status);
   }
   else
   {
@@ -860,10 +3326,76 @@ static gboolean NSMA__boOnHandleLifecycleRequestComplete(NodeStateConsumer     *
 
   node_state_consumer_complete_lifecycle_request_complete(pConsumer, pInvocation, enErrorStatus);
 
+  NSMA__vEndCallStat(&stCall, NSMA__enStat_LifecycleRequestComplete);
+
   return TRUE;
 }
 
 
+/**********************************************************************************************************************
+*
+* The function is called in the D-Bus thread to stop its main loop, after the core loop has been left.
+*
+* @param pUserData: Optionally user data (not used)
+*
+* @return FALSE: Remove the idle source.
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boQuitDbusLoop(gpointer pUserData)
+{
+  g_main_loop_quit(NSMA__pDbusLoop);
+
+  return FALSE;
+}
+
+
+/**********************************************************************************************************************
+*
+* Entry of the D-Bus thread. The D-Bus context is made the thread default before the bus name is requested.
+* Like this, the bus callbacks and the method handlers of the exported skeleton objects are dispatched here.
+*
+* @param pUserData: Optionally user data (not used)
+*
+* @return NULL
+*
+**********************************************************************************************************************/
+static gpointer NSMA__pvDbusThread(gpointer pUserData)
+{
+  GBusNameOwnerFlags enFlags = G_BUS_NAME_OWNER_FLAGS_NONE;
+
+  g_main_context_push_thread_default(NSMA__pDbusContext);
+
+  /* Only a re-executed NSM replaces the owner. It is queued, until the connection of its old instance is closed */
+  if(NSMA__boReplaceBusName == TRUE)
+  {
+    enFlags = G_BUS_NAME_OWNER_FLAGS_REPLACE;
+  }
+
+  /* Start D-Bus connection sequence */
+  NSMA__u32ConnectionId =  g_bus_own_name((GBusType) NSM_BUS_TYPE,
+                                                     NSM_BUS_NAME,
+                                                     enFlags,
+                                                     &NSMA__vOnBusAcquired,
+                                                     &NSMA__vOnNameAcquired,
+                                                     &NSMA__vOnNameLost,
+                                                     NULL,
+                                                     NULL);
+
+  g_main_loop_run(NSMA__pDbusLoop);
+
+  /* Return pending "WaitForNodeState" calls, while the connections are still open */
+  NSMA__vFlushNodeStateWaiters();
+
+#ifdef NSMA_P2P_SOCKET
+  NSMA__vStopPeerServer();
+#endif
+
+  g_main_context_pop_thread_default(NSMA__pDbusContext);
+
+  return NULL;
+}
+
+
 /**********************************************************************************************************************
 *
 * The function is called when the SIGTERM signal is received
@@ -881,6 +3413,22 @@ static gboolean NSMA__boOnHandleSigterm(gpointer pUserData)
 }
 
 
+/**********************************************************************************************************************
+*
+* The function is called when the SIGHUP signal is received. The NSM re-executes its binary, like on a "Reexec" call.
+*
+* @param pUserData:    Optional user data (not used)
+* @return              TRUE: Keep callback installed
+*
+**********************************************************************************************************************/
+static gboolean NSMA__boOnHandleSighup(gpointer pUserData)
+{
+  (void) NSMA__stObjectCallbacks.pfReexecCb();
+
+  return TRUE;
+}
+
+
 /**********************************************************************************************************************
 *
 * Interfaces. Exported functions. See Header for detailed description.
@@ -889,20 +3437,27 @@ static gboolean NSMA__boOnHandleSigterm(gpointer pUserData)
 
 gboolean NSMA_boInit(const NSMA_tstObjectCallbacks *pstCallbacks)
 {
+  NsmNodeState_e       enNodeState       = NsmNodeState_NotSet;
+  NsmApplicationMode_e enApplicationMode = NsmApplicationMode_NotSet;
+
   /* Initialize glib types */
   g_type_init();
 
   /* Initialize file local variables */
   NSMA__pMainLoop             = NULL;
+  NSMA__pDbusContext          = NULL;
+  NSMA__pDbusLoop             = NULL;
+  NSMA__pDbusThread           = NULL;
   NSMA__pBusConnection        = NULL;
   NSMA__u32ConnectionId       = 0;
   NSMA__boLoopEndByUser       = FALSE;
   NSMA__boInitialized         = FALSE;
 
-  NSMA__pCurrentLcConsumer    = NULL;
+  NSMA__pLcRequests           = NULL;
 
   NSMA__pLifecycleControlObj  = NULL;
   NSMA__pNodeStateConsumerObj = NULL;
+  NSMA__u32ConsumerRegId      = 0;
 
   memset(&NSMA__stObjectCallbacks, 0, sizeof(NSMA_tstObjectCallbacks));
 
@@ -913,9 +3468,11 @@ gboolean NSMA_boInit(const NSMA_tstObjectCallbacks *pstCallbacks)
      && (pstCallbacks->pfRequestNodeRestartCb        != NULL)
      && (pstCallbacks->pfSetAppHealthStatusCb        != NULL)
      && (pstCallbacks->pfCheckLucRequiredCb          != NULL)
+     && (pstCallbacks->pfRequestSeatLifecycleCb      != NULL)
      && (pstCallbacks->pfRegisterSessionCb           != NULL)
      && (pstCallbacks->pfUnRegisterSessionCb         != NULL)
      && (pstCallbacks->pfRegisterLifecycleClientCb   != NULL)
+     && (pstCallbacks->pfRegisterLoadSheddingClientCb != NULL)
      && (pstCallbacks->pfUnRegisterLifecycleClientCb != NULL)
      && (pstCallbacks->pfGetAppModeCb                != NULL)
      && (pstCallbacks->pfGetSessionStateCb           != NULL)
@@ -924,7 +3481,9 @@ gboolean NSMA_boInit(const NSMA_tstObjectCallbacks *pstCallbacks)
      && (pstCallbacks->pfSetSessionStateCb           != NULL)
      && (pstCallbacks->pfGetAppHealthCountCb         != NULL)
      && (pstCallbacks->pfGetInterfaceVersionCb       != NULL)
-     && (pstCallbacks->pfLcClientRequestFinish       != NULL))
+     && (pstCallbacks->pfLcClientRequestFinish       != NULL)
+     && (pstCallbacks->pfBusNameAcquiredCb           != NULL)
+     && (pstCallbacks->pfReexecCb                    != NULL))
   {
     /* All callbacks are configured. */
     NSMA__boInitialized = TRUE;
@@ -932,12 +3491,57 @@ gboolean NSMA_boInit(const NSMA_tstObjectCallbacks *pstCallbacks)
     /* Store the passed callbacks. */
     memcpy(&NSMA__stObjectCallbacks, pstCallbacks, sizeof(NSMA_tstObjectCallbacks));
 
-    /* Create a new main loop */
-    NSMA__pMainLoop = g_main_loop_new(NULL, FALSE);
+    /* Create a new main loop for the core and a loop with an own context for the D-Bus thread */
+    NSMA__pMainLoop    = g_main_loop_new(NULL, FALSE);
+    NSMA__pDbusContext = g_main_context_new();
+    NSMA__pDbusLoop    = g_main_loop_new(NSMA__pDbusContext, FALSE);
+
+    /* Create the table for clients waiting for a NodeState */
+    NSMA__pWaitersMutex          = g_mutex_new();
+    NSMA__pWaiters               = NULL;
+    NSMA__pWaiterTimer           = NULL;
+    NSMA__i64WaiterTimerDeadline = 0;
+    memset(NSMA__au32WaitersPerState, 0, sizeof(NSMA__au32WaitersPerState));
+
+    /* Create the list of calls queued for the core */
+    NSMA__pCoreCallsMutex   = g_mutex_new();
+    g_queue_init(&NSMA__stCoreCalls);
+    NSMA__boRejectCoreCalls = FALSE;
+
+    /* Create the accounting of the callers. The rate limit is disabled by default */
+    NSMA__pSendersMutex     = g_mutex_new();
+    NSMA__pSenders          = g_hash_table_new_full(&g_str_hash, &g_str_equal, NULL, &NSMA__vFreeSender);
+    NSMA__u32RateLimit      = NSMA__RATE_LIMIT_DEFAULT;
+    NSMA__u32RateBurst      = NSMA__RATE_BURST_DEFAULT;
+    NSMA__u32NameOwnerSubId = 0;
+
+#ifdef NSMA_P2P_SOCKET
+    NSMA__pPeerServer  = NULL;
+    NSMA__pPeers       = NULL;
+    NSMA__pPeersMutex  = g_mutex_new();
+#endif
 
     /* Create D-Bus skeleton objects */
     NSMA__pNodeStateConsumerObj = node_state_consumer_skeleton_new();
     NSMA__pLifecycleControlObj  = node_state_lifecycle_control_skeleton_new();
+
+#ifdef NSMA_VTABLE_DISPATCH
+    /* The skeleton is not exported. Property changes have to be sent manually */
+    (void) g_signal_connect(NSMA__pNodeStateConsumerObj, "notify", G_CALLBACK(NSMA__vOnConsumerPropertyNotify), NULL);
+#endif
+
+    /* Initialize the properties, which mirror values of the NSM. Afterwards, they are updated with the signals */
+    if(NSMA__stObjectCallbacks.pfGetNodeStateCb(&enNodeState) == NsmErrorStatus_Ok)
+    {
+      node_state_consumer_set_node_state(NSMA__pNodeStateConsumerObj, (gint) enNodeState);
+    }
+
+    if(NSMA__stObjectCallbacks.pfGetAppModeCb(&enApplicationMode) == NsmErrorStatus_Ok)
+    {
+      node_state_consumer_set_application_mode(NSMA__pNodeStateConsumerObj, (gint) enApplicationMode);
+    }
+
+    node_state_consumer_set_sessions(NSMA__pNodeStateConsumerObj, g_variant_new_array(G_VARIANT_TYPE("(sii)"), NULL, 0));
   }
   else
   {
@@ -954,23 +3558,27 @@ gboolean NSMA_boWaitForEvents(void)
   /* Check if the library has been initialized (objects and callbacks are available) */
   if(NSMA__boInitialized == TRUE)
   {
-    /* Start D-Bus connection sequence */
-    NSMA__u32ConnectionId =  g_bus_own_name((GBusType) NSM_BUS_TYPE,
-                                                       NSM_BUS_NAME,
-                                                       G_BUS_NAME_OWNER_FLAGS_NONE,
-                                                       &NSMA__vOnBusAcquired,
-                                                       &NSMA__vOnNameAcquired,
-                                                       &NSMA__vOnNameLost,
-                                                       NULL,
-                                                       NULL);
+    /* Start the D-Bus thread. It gets the D-Bus connection and exports the objects */
+    NSMA__pDbusThread = g_thread_create(&NSMA__pvDbusThread, NULL, TRUE, NULL);
 
     /* Add source to catch SIGTERM signal (#15) */
     g_unix_signal_add(15, &NSMA__boOnHandleSigterm, NULL);
 
-    /* Run main loop to get D-Bus connection and export objects. The function will only return,
-     * if there was an internal error or it has been cancelled by the user.
+    /* Add source to catch SIGHUP signal (#1) */
+    g_unix_signal_add(1, &NSMA__boOnHandleSighup, NULL);
+
+    /* Run the core main loop. The function will only return, if there was an internal error
+     * or it has been cancelled by the user.
      */
     g_main_loop_run(NSMA__pMainLoop);
+
+    /* Stop the D-Bus thread. The quit is dispatched by its loop, in case the thread did not start the loop yet */
+    NSMA__vAttachIdle(NSMA__pDbusContext, G_PRIORITY_DEFAULT, &NSMA__boQuitDbusLoop, NULL);
+    (void) g_thread_join(NSMA__pDbusThread);
+    NSMA__pDbusThread = NULL;
+
+    /* No more calls are queued. Answer the calls, which the core did not dispatch anymore */
+    NSMA__vRejectCoreCalls();
   }
   else
   {
@@ -985,13 +3593,23 @@ gboolean NSMA_boWaitForEvents(void)
 
 gboolean NSMA_boSendNodeStateSignal(const NsmNodeState_e enNodeState)
 {
-  gboolean boRetVal = FALSE;
+  gboolean          boRetVal = FALSE;
+  NSMA_tstStatProbe stProbe;
 
   /* Check if library has been initialized (objects are available) */
   if(NSMA__boInitialized == TRUE)
   {
-    boRetVal = TRUE; /* Send the signal */
+    NSMA_vStatProbeBegin(&stProbe);
+
+    boRetVal = TRUE; /* Update the property and send the signal */
+    node_state_consumer_set_node_state(NSMA__pNodeStateConsumerObj, (gint) enNodeState);
+#ifdef NSMA_VTABLE_DISPATCH
+    NSMA__vEmitConsumerSignal(node_state_consumer_interface_info()->name, "NodeState", g_variant_new("(i)", (gint) enNodeState));
+#else
     node_state_consumer_emit_node_state(NSMA__pNodeStateConsumerObj, (gint) enNodeState);
+#endif
+
+    (void) NSMA_u64StatProbeEnd(&stProbe, &NSMA__astStatCounters[NSMA__enStat_SignalNodeState]);
   }
   else
   {
@@ -1003,18 +3621,81 @@ gboolean NSMA_boSendNodeStateSignal(const NsmNodeState_e enNodeState)
 }
 
 
+gboolean NSMA_boCompleteNodeStateWaiters(const NsmNodeState_e enNodeState)
+{
+  gboolean                  boRetVal   = FALSE;
+  GList                    *pListEntry = NULL;
+  GList                    *pNextEntry = NULL;
+  GList                    *pReached   = NULL;
+  NSMA__tstNodeStateWaiter *pstWaiter  = NULL;
+
+  /* Check if the library has been initialized and the NodeState is valid */
+  if(   (NSMA__boInitialized == TRUE                 )
+     && (enNodeState         >  NsmNodeState_NotSet)
+     && (enNodeState         <  NsmNodeState_Last  ))
+  {
+    boRetVal = TRUE;
+
+    g_mutex_lock(NSMA__pWaitersMutex);
+
+    /* Only walk through the table, if somebody waits for the new NodeState */
+    if(NSMA__au32WaitersPerState[enNodeState] != 0)
+    {
+      for(pListEntry = NSMA__pWaiters; pListEntry != NULL; pListEntry = pNextEntry)
+      {
+        pNextEntry = g_list_next(pListEntry);
+        pstWaiter  = (NSMA__tstNodeStateWaiter*) pListEntry->data;
+
+        if((pstWaiter->u32NodeStateMask & NSM_NODESTATE_MASK(enNodeState)) != 0)
+        {
+          NSMA__pWaiters = g_list_delete_link(NSMA__pWaiters, pListEntry);
+          NSMA__vCountNodeStateWaiter(pstWaiter->u32NodeStateMask, FALSE);
+          pReached = g_list_prepend(pReached, pstWaiter);
+        }
+      }
+    }
+
+    g_mutex_unlock(NSMA__pWaitersMutex);
+
+    /* Return the calls outside of the lock. The timer is left armed. It re-arms for the remaining waiters. */
+    NSMA__vReturnNodeStateWaiters(pReached, enNodeState, NsmErrorStatus_Ok);
+  }
+  else
+  {
+    /* Error: Library not initialized or invalid NodeState */
+    boRetVal = FALSE;
+  }
+
+  return boRetVal;
+}
+
+
 gboolean NSMA_boSendSessionSignal(const NsmSession_s *pstSession)
 {
-  gboolean boRetVal = FALSE;
+  gboolean          boRetVal = FALSE;
+  NSMA_tstStatProbe stProbe;
 
   /* Check if library has been initialized (objects are available) */
   if(NSMA__boInitialized == TRUE)
   {
+    NSMA_vStatProbeBegin(&stProbe);
+
     boRetVal = TRUE; /* Send the signal */
+#ifdef NSMA_VTABLE_DISPATCH
+    NSMA__vEmitConsumerSignal(node_state_consumer_interface_info()->name,
+                              "SessionStateChanged",
+                              g_variant_new("(sii)",
+                                            pstSession->sName,
+                                            (gint) pstSession->enSeat,
+                                            (gint) pstSession->enState));
+#else
     node_state_consumer_emit_session_state_changed(NSMA__pNodeStateConsumerObj,
                                                    pstSession->sName,
                                                    (gint) pstSession->enSeat,
                                                    (gint) pstSession->enState);
+#endif
+
+    (void) NSMA_u64StatProbeEnd(&stProbe, &NSMA__astStatCounters[NSMA__enStat_SignalSessionStateChanged]);
   }
   else
   {
@@ -1028,13 +3709,56 @@ gboolean NSMA_boSendSessionSignal(const NsmSession_s *pstSession)
 
 gboolean NSMA_boSendApplicationModeSignal(const NsmApplicationMode_e enApplicationMode)
 {
-  gboolean boRetVal = FALSE;
+  gboolean          boRetVal = FALSE;
+  NSMA_tstStatProbe stProbe;
 
   /* Check if the library has been initialized (objects are available) */
   if(NSMA__boInitialized == TRUE)
   {
-    boRetVal = TRUE; /* Send the signal */
+    NSMA_vStatProbeBegin(&stProbe);
+
+    boRetVal = TRUE; /* Update the property and send the signal */
+    node_state_consumer_set_application_mode(NSMA__pNodeStateConsumerObj, (gint) enApplicationMode);
+#ifdef NSMA_VTABLE_DISPATCH
+    NSMA__vEmitConsumerSignal(node_state_consumer_interface_info()->name, "NodeApplicationMode", g_variant_new("(i)", (gint) enApplicationMode));
+#else
     node_state_consumer_emit_node_application_mode(NSMA__pNodeStateConsumerObj, (gint) enApplicationMode);
+#endif
+
+    (void) NSMA_u64StatProbeEnd(&stProbe, &NSMA__astStatCounters[NSMA__enStat_SignalNodeApplicationMode]);
+  }
+  else
+  {
+    /* Error: Library not initialized. Objects are invalid. */
+    boRetVal = FALSE;
+  }
+
+  return boRetVal;
+}
+
+
+gboolean NSMA_boSetSessions(const NsmSession_s *pstSessions, const guint u32SessionCnt)
+{
+  gboolean         boRetVal     = FALSE;
+  GVariantBuilder  stBuilder;
+  guint            u32Idx       = 0;
+
+  /* Check if the library has been initialized (objects are available) */
+  if(NSMA__boInitialized == TRUE)
+  {
+    boRetVal = TRUE; /* Set the properties value */
+    g_variant_builder_init(&stBuilder, G_VARIANT_TYPE("a(sii)"));
+
+    for(u32Idx = 0; u32Idx < u32SessionCnt; u32Idx++)
+    {
+      g_variant_builder_add(&stBuilder,
+                            "(sii)",
+                            pstSessions[u32Idx].sName,
+                            (gint) pstSessions[u32Idx].enSeat,
+                            (gint) pstSessions[u32Idx].enState);
+    }
+
+    node_state_consumer_set_sessions(NSMA__pNodeStateConsumerObj, g_variant_builder_end(&stBuilder));
   }
   else
   {
@@ -1261,16 +3985,60 @@ NSMA_tLcConsumerHandle NSMA_hCreateLcConsumer(const gchar* sBusName,
 gboolean NSMA_boCallLcClientRequest(NSMA_tLcConsumerHandle hLcClient,
                                     guint                  u32ShutdownType)
 {
+  NSMA__tstLcRequest *pstRequest = NULL;
+  gboolean            boRetVal   = FALSE;
+
+  /* Only one request can be pending per client. The client's proxy is used as request ID */
+  if(NSMA__pstFindLcRequest((NodeStateLifeCycleConsumer*) hLcClient) == NULL)
+  {
+    pstRequest             = g_new0(NSMA__tstLcRequest, 1);
+    pstRequest->pConsumer  = (NodeStateLifeCycleConsumer*) hLcClient;
+    pstRequest->u32TimerId = 0;
+    NSMA__pLcRequests      = g_slist_append(NSMA__pLcRequests, pstRequest);
+
+    node_state_life_cycle_consumer_call_lifecycle_request(pstRequest->pConsumer,
+                                                          u32ShutdownType,
+                                                          (guint) pstRequest->pConsumer,
+                                                          NULL,
+                                                          &NSMA__vOnLifecycleRequestFinish,
+                                                          pstRequest);
+    boRetVal = TRUE;
+  }
 
-  NSMA__pCurrentLcConsumer = (NodeStateLifeCycleConsumer*) hLcClient;
+  return boRetVal;
+}
 
-  node_state_life_cycle_consumer_call_lifecycle_request(NSMA__pCurrentLcConsumer,
-                                                        u32ShutdownType,
-                                                        (guint) NSMA__pCurrentLcConsumer,
-                                                        NULL,
-                                                        &NSMA__vOnLifecycleRequestFinish,
-                                                        NULL);
-  return TRUE;
+
+gboolean NSMA_boCheckBusName(const gchar            *sBusName,
+                             NSMA_tpfBusNameCheckCb  pfCallback,
+                             gpointer                pUserData)
+{
+  NSMA__tstBusNameCheck *pstCheck = NULL;
+  gboolean               boRetVal = FALSE;
+
+  if((NSMA__pBusConnection != NULL) && (sBusName != NULL) && (pfCallback != NULL))
+  {
+    pstCheck             = g_new0(NSMA__tstBusNameCheck, 1);
+    pstCheck->sBusName   = g_strdup(sBusName);
+    pstCheck->pfCallback = pfCallback;
+    pstCheck->pUserData  = pUserData;
+
+    g_dbus_connection_call(NSMA__pBusConnection,
+                           "org.freedesktop.DBus",
+                           "/org/freedesktop/DBus",
+                           "org.freedesktop.DBus",
+                           "NameHasOwner",
+                           g_variant_new("(s)", sBusName),
+                           G_VARIANT_TYPE("(b)"),
+                           G_DBUS_CALL_FLAGS_NONE,
+                           -1,
+                           NULL,
+                           &NSMA__vOnBusNameChecked,
+                           pstCheck);
+    boRetVal = TRUE;
+  }
+
+  return boRetVal;
 }
 
 
@@ -1290,12 +4058,89 @@ gboolean NSMA_boGetLcClientTimeout(NSMA_tLcConsumerHandle hClient, guint *pu32Ti
 }
 
 
+gboolean NSMA_boAddLucRunupTime(const guint64 u64DurationNs)
+{
+  gboolean boRetVal = FALSE;
+
+  /* The counter is read by "GetStatistics". The CPU time of the run up is spread over the clients */
+  if(NSMA__boInitialized == TRUE)
+  {
+    NSMA_vStatCounterAdd(&NSMA__astStatCounters[NSMA__enStat_LucRunup], u64DurationNs, 0);
+    boRetVal = TRUE;
+  }
+
+  return boRetVal;
+}
+
+
+gboolean NSMA_boSetRateLimit(const guint u32CallsPerSec, const guint u32Burst)
+{
+  gboolean boRetVal = FALSE;
+
+  /* A bucket must hold at least one call. Otherwise no call would ever be admitted. */
+  if((u32CallsPerSec == 0) || (u32Burst != 0))
+  {
+    g_mutex_lock(NSMA__pSendersMutex);
+    NSMA__u32RateLimit = u32CallsPerSec;
+    NSMA__u32RateBurst = u32Burst;
+    g_mutex_unlock(NSMA__pSendersMutex);
+
+    boRetVal = TRUE;
+  }
+
+  return boRetVal;
+}
+
+
+gboolean NSMA_boSetReplaceBusName(const gboolean boReplace)
+{
+  gboolean boRetVal = FALSE;
+
+  /* The flag is used, when the D-Bus thread requests the name */
+  if(NSMA__boInitialized == FALSE)
+  {
+    NSMA__boReplaceBusName = boReplace;
+    boRetVal = TRUE;
+  }
+
+  return boRetVal;
+}
+
+
 gboolean NSMA_boDeInit(void)
 {
   NSMA__boInitialized = FALSE;
 
+  if(NSMA__u32ConsumerRegId != 0)
+  {
+    (void) g_dbus_connection_unregister_object(NSMA__pBusConnection, NSMA__u32ConsumerRegId);
+    NSMA__u32ConsumerRegId = 0;
+  }
+
+  if(NSMA__u32NameOwnerSubId != 0)
+  {
+    g_dbus_connection_signal_unsubscribe(NSMA__pBusConnection, NSMA__u32NameOwnerSubId);
+    NSMA__u32NameOwnerSubId = 0;
+  }
+
+  /* Send pending replies (e.g. of "Reexec"), before the bus name is released */
+  if(NSMA__pBusConnection != NULL)
+  {
+    (void) g_dbus_connection_flush_sync(NSMA__pBusConnection, NULL, NULL);
+  }
+
   g_bus_unown_name(NSMA__u32ConnectionId);
   g_main_loop_unref(NSMA__pMainLoop);
+  g_main_loop_unref(NSMA__pDbusLoop);
+  g_main_context_unref(NSMA__pDbusContext);
+  g_mutex_free(NSMA__pWaitersMutex);
+  g_mutex_free(NSMA__pCoreCallsMutex);
+  g_hash_table_destroy(NSMA__pSenders);
+  g_mutex_free(NSMA__pSendersMutex);
+
+#ifdef NSMA_P2P_SOCKET
+  g_mutex_free(NSMA__pPeersMutex);
+#endif
 
   /* Release the (created) skeleton objects */
   if(NSMA__pNodeStateConsumerObj != NULL)
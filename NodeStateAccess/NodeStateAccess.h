@@ -49,6 +49,8 @@ typedef NsmErrorStatus_e (*NSMA_tpfRequestNodeRestartCb)       (const NsmRestart
 typedef NsmErrorStatus_e (*NSMA_tpfSetAppHealthStatusCb)       (const gchar                *sAppName,
                                                                 const gboolean              boAppState);
 typedef gboolean         (*NSMA_tpfCheckLucRequiredCb)         (void);
+typedef NsmErrorStatus_e (*NSMA_tpfRequestSeatLifecycleCb)     (const NsmSeat_e             enSeatId,
+                                                                const guint                 u32RequestType);
 typedef NsmErrorStatus_e (*NSMA_tpfRegisterSessionCb)          (const gchar                *sSessionName,
                                                                 const gchar                *sSessionOwner,
                                                                 const NsmSeat_e             enSeatId,
@@ -59,7 +61,12 @@ typedef NsmErrorStatus_e (*NSMA_tpfUnRegisterSessionCb)        (const gchar
 typedef NsmErrorStatus_e (*NSMA_tpfRegisterLifecycleClientCb)  (const gchar                *sBusName,
                                                                 const gchar                *sObjName,
                                                                 const guint                 u32ShutdownMode,
-                                                                const guint                 u32TimeoutMs);
+                                                                const guint                 u32TimeoutMs,
+                                                                const NsmSeat_e             enSeatId);
+typedef NsmErrorStatus_e (*NSMA_tpfRegisterLoadSheddingClientCb)(const gchar              *sBusName,
+                                                                 const gchar              *sObjName,
+                                                                 const guint               u32ShedLevel,
+                                                                 const guint               u32TimeoutMs);
 typedef NsmErrorStatus_e (*NSMA_tpfUnRegisterLifecycleClientCb)(const gchar                *sBusName,
                                                                 const gchar                *sObjName,
                                                                 const guint                 u32ShutdownMode);
@@ -74,11 +81,18 @@ typedef NsmErrorStatus_e (*NSMA_tpfSetSessionStateCb)          (const gchar
                                                                 const NsmSessionState_e     enSessionState);
 typedef guint (*NSMA_tpfGetAppHealthCountCb)                   (void);
 typedef guint (*NSMA_tpfGetInterfaceVersionCb)                 (void);
+typedef NsmErrorStatus_e (*NSMA_tpfReexecCb)                   (void);
 
 
 /* Type definition for the management of Lifecycle clients */
 typedef gpointer NSMA_tLcConsumerHandle;
-typedef void (*NSMA_tpfLifecycleReqFinish)(const NsmErrorStatus_e enErrorStatus);
+typedef void (*NSMA_tpfLifecycleReqFinish)(NSMA_tLcConsumerHandle hLcClient, const NsmErrorStatus_e enErrorStatus);
+
+/* Type definition for the notification, that the bus name has been acquired and clients can be called */
+typedef void (*NSMA_tpfBusNameAcquiredCb)(void);
+
+/* Type definition for the result of a check, whether a bus name (still) has an owner */
+typedef void (*NSMA_tpfBusNameCheckCb)(const gchar *sBusName, gboolean boHasOwner, gpointer pUserData);
 
 /* Type definition to wrap all callbacks in a structure */
 typedef struct
@@ -89,9 +103,11 @@ typedef struct
   NSMA_tpfRequestNodeRestartCb        pfRequestNodeRestartCb;
   NSMA_tpfSetAppHealthStatusCb        pfSetAppHealthStatusCb;
   NSMA_tpfCheckLucRequiredCb          pfCheckLucRequiredCb;
+  NSMA_tpfRequestSeatLifecycleCb      pfRequestSeatLifecycleCb;
   NSMA_tpfRegisterSessionCb           pfRegisterSessionCb;
   NSMA_tpfUnRegisterSessionCb         pfUnRegisterSessionCb;
   NSMA_tpfRegisterLifecycleClientCb   pfRegisterLifecycleClientCb;
+  NSMA_tpfRegisterLoadSheddingClientCb pfRegisterLoadSheddingClientCb;
   NSMA_tpfUnRegisterLifecycleClientCb pfUnRegisterLifecycleClientCb;
   NSMA_tpfGetAppModeCb                pfGetAppModeCb;
   NSMA_tpfGetSessionStateCb           pfGetSessionStateCb;
@@ -100,6 +116,8 @@ typedef struct
   NSMA_tpfGetAppHealthCountCb         pfGetAppHealthCountCb;
   NSMA_tpfGetInterfaceVersionCb       pfGetInterfaceVersionCb;
   NSMA_tpfLifecycleReqFinish          pfLcClientRequestFinish;
+  NSMA_tpfBusNameAcquiredCb           pfBusNameAcquiredCb;
+  NSMA_tpfReexecCb                    pfReexecCb;
 } NSMA_tstObjectCallbacks;
 
 
@@ -132,7 +150,7 @@ gboolean NSMA_boInit(const NSMA_tstObjectCallbacks *pstCallbacks);
 
 /**********************************************************************************************************************
 *
-* The function is used to send the "NodeState" signal via the IPC.
+* The function is used to update the "NodeState" property and to send the "NodeState" signal via the IPC.
 *
 * @param enNodeState: NodeState to be send.
 *
@@ -143,6 +161,20 @@ gboolean NSMA_boInit(const NSMA_tstObjectCallbacks *pstCallbacks);
 gboolean NSMA_boSendNodeStateSignal(const NsmNodeState_e enNodeState);
 
 
+/**********************************************************************************************************************
+*
+* The function returns the pending "WaitForNodeState" calls, which wait for the passed NodeState.
+* It has to be called whenever the NodeState changed.
+*
+* @param enNodeState: New NodeState.
+*
+* @return TRUE:  The waiting calls have been checked.
+*         FALSE: Error. Library not initialized or invalid NodeState.
+*
+**********************************************************************************************************************/
+gboolean NSMA_boCompleteNodeStateWaiters(const NsmNodeState_e enNodeState);
+
+
 /**********************************************************************************************************************
 *
 * The function is used to send the "SessionChanged" signal via the IPC.
@@ -158,7 +190,7 @@ gboolean NSMA_boSendSessionSignal(const NsmSession_s *pstSession);
 
 /**********************************************************************************************************************
 *
-* The function is used to send the "ApplicationMode" signal via the IPC.
+* The function is used to update the "ApplicationMode" property and to send the "ApplicationMode" signal via the IPC.
 *
 * @param enApplicationMode: ApplicationMode to be send.
 *
@@ -169,6 +201,20 @@ gboolean NSMA_boSendSessionSignal(const NsmSession_s *pstSession);
 gboolean NSMA_boSendApplicationModeSignal(const NsmApplicationMode_e enApplicationMode);
 
 
+/**********************************************************************************************************************
+*
+* The function is used to set the value of the Sessions property.
+*
+* @param pstSessions:   Array with all sessions known by the NSM.
+* @param u32SessionCnt: Number of sessions in the array.
+*
+* @return TRUE:  Successfully set the properties value.
+*         FALSE: Error setting the properties value.
+*
+**********************************************************************************************************************/
+gboolean NSMA_boSetSessions(const NsmSession_s *pstSessions, const guint u32SessionCnt);
+
+
 /**********************************************************************************************************************
 *
 * The function is used to set the value of the BootMode property.
@@ -290,12 +336,14 @@ NSMA_tLcConsumerHandle NSMA_hCreateLcConsumer(const gchar* sBusName, const gchar
 /**********************************************************************************************************************
 *
 * The function is used to call the "LifecycleRequest" method of a client.
+* Several clients can be called in parallel, but only one request can be pending for a client at a time.
+* When the client returned, "pfLcClientRequestFinish" is called with the handle of the client.
 *
 * @param hLcClient:       Handle of the client (created with "NSMA_hCreateLcConsumer").
 * @param u32ShutdownType: Shutdown type.
 *
 * @return TRUE:  Successfully called client
-*         FALSE: Error calling the client.
+*         FALSE: Error calling the client. A request already is pending for the client.
 *
 **********************************************************************************************************************/
 gboolean NSMA_boCallLcClientRequest(NSMA_tLcConsumerHandle hLcClient, guint u32ShutdownType);
@@ -329,6 +377,51 @@ gboolean NSMA_boSetLcClientTimeout(NSMA_tLcConsumerHandle hClient, guint u32Time
 gboolean NSMA_boGetLcClientTimeout(NSMA_tLcConsumerHandle hClient, guint *pu32TimeoutMs);
 
 
+/**********************************************************************************************************************
+*
+* The function is called, when the last 'Last user context' client returned from its run up. The duration is
+* reported by "GetStatistics" in the entry "LucRunup".
+*
+* @param u64DurationNs: Time from the call of the first LUC client until the last one returned in ns
+*
+* @return TRUE:  Successfully added the duration.
+*         FALSE: Error. The NSMA is not initialized.
+*
+**********************************************************************************************************************/
+gboolean NSMA_boAddLucRunupTime(const guint64 u64DurationNs);
+
+
+/**********************************************************************************************************************
+*
+* The function is called to configure the rate limit of D-Bus callers. The limit is disabled, until it is configured.
+* Every caller may issue u32CallsPerSec calls per second on average and u32Burst calls at once. Calls beyond are answered with a "LimitsExceeded" error.
+* Calls of the LifecycleControl interface and of lifecycle clients are not limited.
+*
+* @param u32CallsPerSec: Average number of calls per second of one caller. 0 disables the limit.
+* @param u32Burst:       Max. number of calls of one caller at once. Must not be 0, if a limit is set.
+*
+* @return TRUE:  Successfully set the rate limit.
+*         FALSE: Error. Invalid burst size.
+*
+**********************************************************************************************************************/
+gboolean NSMA_boSetRateLimit(const guint u32CallsPerSec, const guint u32Burst);
+
+
+/**********************************************************************************************************************
+*
+* The function is called before "NSMA_boInit" to request the bus name with G_BUS_NAME_OWNER_FLAGS_REPLACE. A NSM
+* that has been re-executed uses it to take over the name from its old instance. Otherwise, the name is requested
+* with G_BUS_NAME_OWNER_FLAGS_NONE, so that no other process can replace the NSM.
+*
+* @param boReplace: TRUE: Replace the current owner of the bus name.
+*
+* @return TRUE:  Successfully set the flag.
+*         FALSE: Error. The NSMA is already initialized.
+*
+**********************************************************************************************************************/
+gboolean NSMA_boSetReplaceBusName(const gboolean boReplace);
+
+
 /**********************************************************************************************************************
 *
 * The function is used to delete a "LifecycleRequest".
@@ -342,6 +435,25 @@ gboolean NSMA_boGetLcClientTimeout(NSMA_tLcConsumerHandle hClient, guint *pu32Ti
 gboolean NSMA_boFreeLcConsumerProxy(NSMA_tLcConsumerHandle hLcConsumer);
 
 
+/**********************************************************************************************************************
+*
+* The function asynchronously asks the bus daemon, whether a bus name has an owner ("NameHasOwner"). It is used to
+* check, if the lifecycle clients restored after a restart are still there. The callback is called in the context,
+* from which the function was called. If the bus daemon can not be asked, the name is reported to have an owner.
+*
+* @param sBusName:   Bus name that should be checked
+* @param pfCallback: Function called with the result
+* @param pUserData:  User data passed to the callback
+*
+* @return TRUE:  The check has been started. The callback will be called.
+*         FALSE: Error starting the check. The callback will not be called.
+*
+**********************************************************************************************************************/
+gboolean NSMA_boCheckBusName(const gchar            *sBusName,
+                             NSMA_tpfBusNameCheckCb  pfCallback,
+                             gpointer                pUserData);
+
+
 /**********************************************************************************************************************
 *
 * The function is blocking. It waits in a loop for events and forwards them to the related callback functions.
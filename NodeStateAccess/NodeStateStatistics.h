@@ -0,0 +1,194 @@
+#ifndef NODESTATESTATISTICS_H_
+#define NODESTATESTATISTICS_H_
+
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Statistics of the NodeStateAccess library (NSMA)
+*
+* The header defines a counter, which collects the number of calls, the wall clock latency (monotonic clock), a
+* latency histogram and the CPU time of the executing thread (CLOCK_THREAD_CPUTIME_ID) for one method or signal.
+* A measurement is started with NSMA_vStatProbeBegin and added to a counter with NSMA_u64StatProbeEnd. The counters
+* are updated with atomic operations only. Like this, handlers running in the D-Bus thread and in the core context
+* can update them concurrently without a lock.
+*
+* The functions are inline, so that the NodeStateBenchmark can measure the cost of the probes that the NSMA uses.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+*  HEADER FILE INCLUDES
+*
+**********************************************************************************************************************/
+
+#include "gio/gio.h" /* glib types and atomic operations */
+#include <time.h>    /* clock_gettime                    */
+
+/**********************************************************************************************************************
+*
+*  CONSTANTS
+*
+**********************************************************************************************************************/
+
+/* Number of histogram buckets. Bucket 0 counts latencies below 1 us, bucket n latencies from 2^(n-1) to 2^n us.
+ * The last bucket counts all latencies from 2^(NSMA_STAT_HISTOGRAM_BUCKETS - 2) us (16 ms) on.
+ */
+#define NSMA_STAT_HISTOGRAM_BUCKETS 16
+
+/**********************************************************************************************************************
+*
+*  TYPE
+*
+**********************************************************************************************************************/
+
+/* Statistics of one method or signal */
+typedef struct
+{
+  volatile guint   u32Calls;                                   /* Number of measured calls                   */
+  volatile guint64 u64WallSumNs;                               /* Sum of the latencies (monotonic clock)     */
+  volatile guint64 u64WallMaxNs;                               /* Longest latency                            */
+  volatile guint64 u64CpuSumNs;                                /* Sum of the CPU time of the handling thread */
+  volatile guint   au32Histogram[NSMA_STAT_HISTOGRAM_BUCKETS]; /* Latencies in log2 buckets of us            */
+} NSMA_tstStatCounter;
+
+/* Start values of one measurement */
+typedef struct
+{
+  struct timespec stWallStart; /* CLOCK_MONOTONIC         */
+  struct timespec stCpuStart;  /* CLOCK_THREAD_CPUTIME_ID */
+} NSMA_tstStatProbe;
+
+
+/**********************************************************************************************************************
+*
+*  GLOBAL FUNCTIONS
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function returns the time between two time stamps.
+*
+* @param pstStart: Earlier time stamp
+* @param pstEnd:   Later time stamp
+*
+* @return Elapsed time in ns
+*
+**********************************************************************************************************************/
+static inline guint64 NSMA_u64StatElapsedNs(const struct timespec *pstStart, const struct timespec *pstEnd)
+{
+  return   (guint64) (((gint64) pstEnd->tv_sec - (gint64) pstStart->tv_sec) * 1000000000LL)
+         + (guint64)  ((gint64) pstEnd->tv_nsec - (gint64) pstStart->tv_nsec);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function starts a measurement.
+*
+* @param pstProbe: Probe, where the start values are stored
+*
+**********************************************************************************************************************/
+static inline void NSMA_vStatProbeBegin(NSMA_tstStatProbe *pstProbe)
+{
+  (void) clock_gettime(CLOCK_MONOTONIC,         &pstProbe->stWallStart);
+  (void) clock_gettime(CLOCK_THREAD_CPUTIME_ID, &pstProbe->stCpuStart);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function adds a measurement to a counter. It is used by NSMA_u64StatProbeEnd and for durations, which are not
+* measured with a probe.
+*
+* @param pstCounter: Counter of the measured method, signal or phase
+* @param u64WallNs:  Latency (monotonic clock) in ns
+* @param u64CpuNs:   CPU time of the handling thread in ns. 0, if it is not known.
+*
+**********************************************************************************************************************/
+static inline void NSMA_vStatCounterAdd(NSMA_tstStatCounter *pstCounter, const guint64 u64WallNs, const guint64 u64CpuNs)
+{
+  /* Function local variables                                   */
+  guint64 u64MaxNs  = 0;
+  guint64 u64Us     = 0;
+  guint   u32Bucket = 0; /* Histogram bucket of latency */
+
+  for(u64Us = u64WallNs / 1000; (u64Us != 0) && (u32Bucket < (NSMA_STAT_HISTOGRAM_BUCKETS - 1)); u64Us >>= 1)
+  {
+    u32Bucket++;
+  }
+
+  g_atomic_int_inc((volatile gint*) &pstCounter->u32Calls);
+  g_atomic_int_inc((volatile gint*) &pstCounter->au32Histogram[u32Bucket]);
+  (void) __sync_fetch_and_add(&pstCounter->u64WallSumNs, u64WallNs);
+  (void) __sync_fetch_and_add(&pstCounter->u64CpuSumNs,  u64CpuNs);
+
+  /* Raise the maximum. Retry, if another thread changed it in between */
+  do
+  {
+    u64MaxNs = pstCounter->u64WallMaxNs;
+  } while(   (u64WallNs > u64MaxNs)
+          && (__sync_bool_compare_and_swap(&pstCounter->u64WallMaxNs, u64MaxNs, u64WallNs) == FALSE));
+}
+
+
+/**********************************************************************************************************************
+*
+* The function ends a measurement and adds it to a counter. It has to be called in the thread, which started the
+* measurement, because the CPU time is measured for this thread.
+*
+* @param pstProbe:   Probe started with NSMA_vStatProbeBegin
+* @param pstCounter: Counter of the measured method or signal
+*
+* @return Latency of the measurement in ns
+*
+**********************************************************************************************************************/
+static inline guint64 NSMA_u64StatProbeEnd(const NSMA_tstStatProbe *pstProbe, NSMA_tstStatCounter *pstCounter)
+{
+  /* Function local variables                                   */
+  struct timespec stCpuEnd;
+  struct timespec stWallEnd;
+  guint64         u64WallNs = 0;
+
+  (void) clock_gettime(CLOCK_THREAD_CPUTIME_ID, &stCpuEnd);
+  (void) clock_gettime(CLOCK_MONOTONIC,         &stWallEnd);
+
+  u64WallNs = NSMA_u64StatElapsedNs(&pstProbe->stWallStart, &stWallEnd);
+  NSMA_vStatCounterAdd(pstCounter, u64WallNs, NSMA_u64StatElapsedNs(&pstProbe->stCpuStart, &stCpuEnd));
+
+  return u64WallNs;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function resets a counter. Measurements that end concurrently may be partially lost.
+*
+* @param pstCounter: Counter that should be reset
+*
+**********************************************************************************************************************/
+static inline void NSMA_vStatCounterReset(NSMA_tstStatCounter *pstCounter)
+{
+  guint u32Bucket = 0;
+
+  g_atomic_int_set((volatile gint*) &pstCounter->u32Calls, 0);
+  (void) __sync_and_and_fetch(&pstCounter->u64WallSumNs, 0);
+  (void) __sync_and_and_fetch(&pstCounter->u64WallMaxNs, 0);
+  (void) __sync_and_and_fetch(&pstCounter->u64CpuSumNs,  0);
+
+  for(u32Bucket = 0; u32Bucket < NSMA_STAT_HISTOGRAM_BUCKETS; u32Bucket++)
+  {
+    g_atomic_int_set((volatile gint*) &pstCounter->au32Histogram[u32Bucket], 0);
+  }
+}
+
+#endif /* NODESTATESTATISTICS_H_ */
@@ -0,0 +1,113 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the "null" NodeStateMachine plugin.
+*
+* The plugin does nothing and accepts everything. It is loaded via NSM_NSMC_PLUGIN to measure the overhead of the
+* NSM without any cost of a NSMC. The functions do not log, so that they do not add cost themselves.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+#include "NodeStateTypes.h"         /* Types of the NSM          */
+#include "NodeStateMachinePlugin.h" /* Plugin interface of NSMCs */
+
+
+/**********************************************************************************************************************
+*
+* Local defines, macros, constants and type definitions.
+*
+**********************************************************************************************************************/
+
+/* Version of the plugin structure. The build overrides it for a plugin, which the NSM has to reject. */
+#ifndef NSMC_NULL_PLUGIN_VERSION
+#define NSMC_NULL_PLUGIN_VERSION NSMC_PLUGIN_VERSION
+#endif
+
+
+/**********************************************************************************************************************
+*
+* Prototypes for file local functions (see implementation for description)
+*
+**********************************************************************************************************************/
+
+static unsigned char    NSMC__u8Init(void);
+static unsigned char    NSMC__u8LucRequired(void);
+static NsmErrorStatus_e NSMC__enSetData(NsmDataType_e enData, unsigned char *pData, unsigned int u32DataLen);
+static unsigned char    NSMC__u8RequestNodeRestart(NsmRestartReason_e enRestartReason, unsigned int u32RestartType);
+static unsigned int     NSMC__u32GetInterfaceVersion(void);
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+static unsigned char NSMC__u8Init(void)
+{
+  return 1;
+}
+
+
+static unsigned char NSMC__u8LucRequired(void)
+{
+  return 1;
+}
+
+
+static NsmErrorStatus_e NSMC__enSetData(NsmDataType_e enData, unsigned char *pData, unsigned int u32DataLen)
+{
+  (void) enData;
+  (void) pData;
+  (void) u32DataLen;
+
+  return NsmErrorStatus_Ok;
+}
+
+
+static unsigned char NSMC__u8RequestNodeRestart(NsmRestartReason_e enRestartReason, unsigned int u32RestartType)
+{
+  (void) enRestartReason;
+  (void) u32RestartType;
+
+  return 1;
+}
+
+
+static unsigned int NSMC__u32GetInterfaceVersion(void)
+{
+  return NSMC_PLUGIN_INTERFACE_VERSION;
+}
+
+
+/**********************************************************************************************************************
+*
+* Interfaces, exported functions. See NodeStateMachinePlugin.h for detailed description.
+*
+**********************************************************************************************************************/
+
+const NsmcPlugin_s NsmcPlugin =
+{
+  NSMC_NULL_PLUGIN_VERSION,
+  "NodeStateMachineNull",
+  &NSMC__u8Init,
+  &NSMC__u8LucRequired,
+  &NSMC__enSetData,
+  &NSMC__u8RequestNodeRestart,
+  &NSMC__u32GetInterfaceVersion,
+  NULL
+};
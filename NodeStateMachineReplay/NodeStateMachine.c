@@ -0,0 +1,254 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the replay NodeStateMachine.
+*
+* The NodeStateMachine is used for benchmarks with the NodeStateReplay tool. It has two tasks:
+*
+* - Capture: If the environment variable NSMC_REPLAY_CAPTURE names a file, every event the NSM passes to the NSMC is
+*            appended to it in the scenario format of NodeStateReplay. The time of an event is the time in ms since
+*            NsmcInit. Like this, the events of a vehicle's day can be captured once and replayed later. Names are URI
+*            escaped, so that names with white space stay one token. Changes the NSM makes on its own (the final
+*            "Shutdown" or "Suspended" NodeState and sessions dropped for a failed application) are written as
+*            comments ("# NSM: ..."), because the replay would cause them again.
+* - Replay:  Restart requests are accepted without restarting the node, so that a replayed scenario can continue.
+*
+* The NSMC does not change data in the NSM, so a replay only measures the NSM.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+#include "NodeStateMachine.h"       /* Own header file            */
+#include "NodeStateTypes.h"         /* Types of the NSM           */
+#include "NodeStateMachinePlugin.h" /* Loadable as NSMC plugin    */
+#include <glib.h>                   /* Monotonic time and mutex   */
+#include <stdio.h>                  /* Write the capture file     */
+
+
+/**********************************************************************************************************************
+*
+* Local defines, macros, constants and type definitions.
+*
+**********************************************************************************************************************/
+
+#define NSMC_REPLAY_ENV_CAPTURE "NSMC_REPLAY_CAPTURE"
+#define NSMC_REPLAY_INTERNAL    "# NSM: "  /* Prefix of changes the NSM made on its own */
+
+
+/**********************************************************************************************************************
+*
+* Local variables
+*
+**********************************************************************************************************************/
+
+static GMutex *NSMC__pCaptureMutex = NULL;  /* Serializes the lines of different threads   */
+static FILE   *NSMC__pCaptureFile  = NULL;  /* NULL, if no capture has been configured     */
+static gint64  NSMC__i64StartTime  = 0;     /* Monotonic time of NsmcInit in us            */
+
+/* State of the capture, protected by NSMC__pCaptureMutex */
+static NsmNodeState_e  NSMC__enNodeState   = NsmNodeState_NotSet; /* Last captured NodeState          */
+static GHashTable     *NSMC__pFailedApps   = NULL;                /* Names of apps that are not running */
+
+/* The replay NSMC can also be loaded via NSM_NSMC_PLUGIN */
+NSMC_PLUGIN_EXPORT("NodeStateMachineReplay", NULL);
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function escapes a name of the NSM for the capture file. The name does not need to be terminated.
+*
+* @param sName:     Name to escape
+* @param u32MaxLen: Size of the buffer of the name
+*
+* @return Escaped name. Has to be freed with g_free.
+*
+**********************************************************************************************************************/
+static gchar* NSMC__sEscape(const char *sName, gsize u32MaxLen)
+{
+  gchar *sTerminated = g_strndup(sName, u32MaxLen);
+  gchar *sEscaped    = g_uri_escape_string(sTerminated, G_URI_RESERVED_CHARS_ALLOWED_IN_PATH, TRUE);
+
+  g_free(sTerminated);
+
+  return sEscaped;
+}
+
+
+/**********************************************************************************************************************
+*
+* Interfaces, exported functions. See header for detailed description.
+*
+**********************************************************************************************************************/
+
+unsigned char NsmcInit(void)
+{
+  const gchar *sCapture = g_getenv(NSMC_REPLAY_ENV_CAPTURE);
+
+  NSMC__pCaptureMutex = g_mutex_new();
+  NSMC__i64StartTime  = g_get_monotonic_time();
+  NSMC__pFailedApps   = g_hash_table_new_full(&g_str_hash, &g_str_equal, &g_free, NULL);
+
+  if(sCapture != NULL)
+  {
+    NSMC__pCaptureFile = fopen(sCapture, "a");
+
+    if(NSMC__pCaptureFile != NULL)
+    {
+      fprintf(NSMC__pCaptureFile, "# Captured by NodeStateMachineReplay\n");
+      fflush(NSMC__pCaptureFile);
+    }
+    else
+    {
+      printf("NSMC: Failed to open capture file \"%s\".\n", sCapture);
+    }
+  }
+
+  return 1;
+}
+
+
+unsigned char NsmcLucRequired(void)
+{
+  return 1;
+}
+
+
+NsmErrorStatus_e NsmcSetData(NsmDataType_e enData, unsigned char *pData, unsigned int u32DataLen)
+{
+  NsmErrorStatus_e     enRetVal          = NsmErrorStatus_Ok;
+  NsmSession_s        *pstSession        = NULL;
+  NsmAppHealth_s      *pstAppHealth      = NULL;
+  NsmShutdownClient_s *pstShutdownClient = NULL;
+  NsmNodeState_e       enNodeState       = NsmNodeState_NotSet;
+  gchar               *sName             = NULL;
+  gchar               *sOwner            = NULL;
+  const gchar         *sPrefix           = "";     /* NSMC_REPLAY_INTERNAL for changes of the NSM */
+  gint64               i64TimeMs         = (g_get_monotonic_time() - NSMC__i64StartTime) / 1000;
+
+  if(NSMC__pCaptureFile != NULL)
+  {
+    g_mutex_lock(NSMC__pCaptureMutex);
+
+    if((enData == NsmDataType_NodeState) && (u32DataLen == sizeof(NsmNodeState_e)))
+    {
+      enNodeState = *((NsmNodeState_e*) pData);
+
+      /* The NSM enters the final state, when the last lifecycle client answered the shut down */
+      if(   (   (enNodeState == NsmNodeState_Shutdown)
+             && (   (NSMC__enNodeState == NsmNodeState_ShuttingDown)
+                 || (NSMC__enNodeState == NsmNodeState_FastShutdown)))
+         || (   (enNodeState       == NsmNodeState_Suspended )
+             && (NSMC__enNodeState == NsmNodeState_Suspending)))
+      {
+        sPrefix = NSMC_REPLAY_INTERNAL;
+      }
+
+      NSMC__enNodeState = enNodeState;
+      fprintf(NSMC__pCaptureFile, "%s%" G_GINT64_FORMAT " NodeState %d\n", sPrefix, i64TimeMs, enNodeState);
+    }
+    else if((enData == NsmDataType_AppMode) && (u32DataLen == sizeof(NsmApplicationMode_e)))
+    {
+      fprintf(NSMC__pCaptureFile, "%" G_GINT64_FORMAT " AppMode %d\n", i64TimeMs, *((NsmApplicationMode_e*) pData));
+    }
+    else if((enData == NsmDataType_SessionState) && (u32DataLen == sizeof(NsmSession_s)))
+    {
+      pstSession = (NsmSession_s*) pData;
+      sName      = NSMC__sEscape(pstSession->sName,  sizeof(pstSession->sName));
+      sOwner     = NSMC__sEscape(pstSession->sOwner, sizeof(pstSession->sOwner));
+
+      /* The NSM drops the sessions of a failed application */
+      if(   (pstSession->enState == NsmSessionState_Unregistered)
+         && (g_hash_table_lookup(NSMC__pFailedApps, sOwner) != NULL))
+      {
+        sPrefix = NSMC_REPLAY_INTERNAL;
+      }
+
+      fprintf(NSMC__pCaptureFile, "%s%" G_GINT64_FORMAT " Session %s %s %d %d\n",
+              sPrefix, i64TimeMs, sName, sOwner, pstSession->enSeat, pstSession->enState);
+
+      g_free(sName);
+      g_free(sOwner);
+    }
+    else if((enData == NsmDataType_AppHealth) && (u32DataLen == sizeof(NsmAppHealth_s)))
+    {
+      pstAppHealth = (NsmAppHealth_s*) pData;
+      sName        = NSMC__sEscape(pstAppHealth->sAppName, sizeof(pstAppHealth->sAppName));
+
+      if(pstAppHealth->u32Running == 0)
+      {
+        g_hash_table_insert(NSMC__pFailedApps, g_strdup(sName), GINT_TO_POINTER(1));
+      }
+      else
+      {
+        (void) g_hash_table_remove(NSMC__pFailedApps, sName);
+      }
+
+      fprintf(NSMC__pCaptureFile, "%" G_GINT64_FORMAT " AppHealth %s %u\n",
+              i64TimeMs, sName, (pstAppHealth->u32Running != 0) ? 1U : 0U);
+
+      g_free(sName);
+    }
+    else if((enData == NsmDataType_ShutdownClient) && (u32DataLen == sizeof(NsmShutdownClient_s)))
+    {
+      /* The client is replayed without delay. Its answer time is not known to the NSMC */
+      pstShutdownClient = (NsmShutdownClient_s*) pData;
+      sName             = NSMC__sEscape(pstShutdownClient->sObjName, sizeof(pstShutdownClient->sObjName));
+
+      fprintf(NSMC__pCaptureFile, "%" G_GINT64_FORMAT " Client %s %u %u 0\n",
+              i64TimeMs, sName, pstShutdownClient->u32ShutdownMode, pstShutdownClient->u32TimeoutMs);
+
+      g_free(sName);
+    }
+    else
+    {
+      /* Other data is not part of a scenario */
+    }
+
+    fflush(NSMC__pCaptureFile);
+    g_mutex_unlock(NSMC__pCaptureMutex);
+  }
+
+  return enRetVal;
+}
+
+
+unsigned char NsmcRequestNodeRestart(NsmRestartReason_e enRestartReason, unsigned int u32RestartType)
+{
+  gint64 i64TimeMs = (g_get_monotonic_time() - NSMC__i64StartTime) / 1000;
+
+  if(NSMC__pCaptureFile != NULL)
+  {
+    g_mutex_lock(NSMC__pCaptureMutex);
+    fprintf(NSMC__pCaptureFile, "%" G_GINT64_FORMAT " Restart %d %u\n", i64TimeMs, enRestartReason, u32RestartType);
+    fflush(NSMC__pCaptureFile);
+    g_mutex_unlock(NSMC__pCaptureMutex);
+  }
+
+  /* Accept the request, but do not restart. The replay continues */
+  return 1;
+}
+
+
+unsigned int NsmcGetInterfaceVersion(void)
+{
+  return NSMC_INTERFACE_VERSION;
+}
@@ -28,7 +28,11 @@
 #include "NodeStateMachine.h" /* own header file            */
 #include "NodeStateManager.h"
 #include "NodeStateTypes.h"
+#include "NodeStateMachineAsync.h" /* Optional async interface  */
+#include "NodeStateMachinePlugin.h" /* Loadable as NSMC plugin  */
 #include <stdio.h>
+#include <poll.h>
+#include <pthread.h>
 
 
 /**********************************************************************************************************************
@@ -46,7 +50,12 @@
 *
 **********************************************************************************************************************/
 
-/* There are currently no local variables */
+/* Rings of the asynchronous interface, passed by the NSM */
+static NsmcQueue_s *NSMC__pstEvents   = NULL;
+static NsmcQueue_s *NSMC__pstCommands = NULL;
+
+/* The stub can also be loaded via NSM_NSMC_PLUGIN */
+NSMC_PLUGIN_EXPORT("NodeStateMachineStub", &NsmcInitAsync);
 
 /**********************************************************************************************************************
 *
@@ -54,7 +63,7 @@
 *
 **********************************************************************************************************************/
 
-/* There are no file local functions */
+static void *NSMC__pvEventThread(void *pArg);
 
 /**********************************************************************************************************************
 *
@@ -62,7 +71,45 @@
 *
 **********************************************************************************************************************/
 
-/* There are no file local functions */
+/**********************************************************************************************************************
+*
+* The thread drains the events, which the NSM pushes into the event ring.
+*
+**********************************************************************************************************************/
+static void *NSMC__pvEventThread(void *pArg)
+{
+  struct pollfd stPollFd;
+  NsmcMessage_s stEvent;
+
+  stPollFd.fd     = NSMC__pstEvents->i32EventFd;
+  stPollFd.events = POLLIN;
+
+  for(;;)
+  {
+    if(poll(&stPollFd, 1, -1) > 0)
+    {
+      NsmcQueueAcknowledge(NSMC__pstEvents);
+
+      while(NsmcQueuePop(NSMC__pstEvents, &stEvent) == 1)
+      {
+        if(stEvent.enType == NsmcMessageType_SetData)
+        {
+          printf("NSMC: SetData event. enData: %d. u32DataLen: %d\n", stEvent.enData, stEvent.u32DataLen);
+        }
+        else
+        {
+          printf("NSMC: RequestNodeRestart event. Restart reason: %d. RestartType: 0x%02X\n",
+                 stEvent.unData.stRestart.enRestartReason, stEvent.unData.stRestart.u32RestartType);
+
+          /* Accept the request. The thread is the only producer of the command ring */
+          (void) NsmcQueuePush(NSMC__pstCommands, &stEvent);
+        }
+      }
+    }
+  }
+
+  return NULL;
+}
 
 /**********************************************************************************************************************
 *
@@ -78,6 +125,27 @@ unsigned char NsmcInit(void)
 }
 
 
+unsigned char NsmcInitAsync(NsmcQueue_s *pstEvents, NsmcQueue_s *pstCommands)
+{
+  unsigned char  u8RetVal = 0;
+  pthread_t      stThread;
+
+  printf("NSMC: NsmcInitAsync called.\n");
+
+  NSMC__pstEvents   = pstEvents;
+  NSMC__pstCommands = pstCommands;
+
+  /* Use the rings, if the thread to drain the events could be started */
+  if(pthread_create(&stThread, NULL, &NSMC__pvEventThread, NULL) == 0)
+  {
+    (void) pthread_detach(stThread);
+    u8RetVal = 1;
+  }
+
+  return u8RetVal;
+}
+
+
 unsigned char NsmcLucRequired(void)
 {
   printf("NSMC: NsmcLucRequired called.\n");
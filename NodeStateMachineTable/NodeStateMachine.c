@@ -0,0 +1,973 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the table driven NodeStateMachine.
+*
+* Instead of hand written code, the NodeStateMachine loads a declarative description of its states and transitions
+* from NSMC_TABLE_FILE (or the file set in the environment variable "NSMC_TABLE_FILE"). A transition is taken, when
+* an event occurs in its source state and its guards are fulfilled. Events are the changes of the NodeState, the
+* ApplicationMode, the ShutdownReason and the session states, that the NSM passes to NsmcSetData, and the restart
+* requests passed to NsmcRequestNodeRestart. Guards check the NodeState, the ShutdownReason and the state of a
+* session. Actions set the NodeState, the ApplicationMode or the ShutdownReason in the NSM or restart the node.
+*
+* The description is compiled by NsmcInit into a dense table, indexed by state and event. Handling an event is a
+* table lookup and a few mask checks. Only the name of a session has to be looked up (hashed) once per event.
+* Changes of the NodeState, which are not allowed by the [NodeStates] group of the description, are detected by a
+* mask check and rejected.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+#include "NodeStateMachine.h" /* Own header file                  */
+#include "NodeStateManager.h" /* Set data in the NSM              */
+#include "NodeStateTypes.h"   /* Types of the NSM                 */
+#include "NodeStateMachinePlugin.h" /* Loadable as NSMC plugin    */
+#include <glib.h>             /* Key file, hash table and mutex   */
+#include <stdio.h>            /* printf                           */
+#include <string.h>           /* strcmp                           */
+
+
+/**********************************************************************************************************************
+*
+* Local defines, macros, constants and type definitions.
+*
+**********************************************************************************************************************/
+
+/* Default location of the description. The build can override it, the environment variable at runtime. */
+#ifndef NSMC_TABLE_FILE
+#define NSMC_TABLE_FILE "/etc/NodeStateMachine.conf"
+#endif
+
+#define NSMC_TABLE_ENV_FILE          "NSMC_TABLE_FILE"
+#define NSMC_TABLE_GROUP_MACHINE     "Machine"
+#define NSMC_TABLE_GROUP_NODESTATES  "NodeStates"
+#define NSMC_TABLE_GROUP_TRANSITION  "Transition%u"
+
+#define NSMC_TABLE_ANY_STATE         "*"
+#define NSMC_TABLE_MAX_TRANSITIONS   0xFFFEU       /* Transitions are stored with an offset of 1 in a guint16 */
+#define NSMC_TABLE_ALL               0xFFFFFFFFU   /* Mask of a guard that is not configured                  */
+
+#define NSMC__SESSION_STATE_CNT      (NsmSessionState_Active + 1)
+
+/* The events are numbered densely. Every value of every event type gets an own number. */
+#define NSMC__EVENT_NODESTATE(enNodeState)      ((guint) (enNodeState))
+#define NSMC__EVENT_APPMODE(enAppMode)          (NSMC__EVENT_NODESTATE(NsmNodeState_Last) + (guint) (enAppMode))
+#define NSMC__EVENT_SHUTDOWNREASON(enReason)    (NSMC__EVENT_APPMODE(NsmApplicationMode_Last) + (guint) (enReason))
+#define NSMC__EVENT_RESTART(enReason)           (NSMC__EVENT_SHUTDOWNREASON(NsmShutdownReason_Last) + (guint) (enReason))
+#define NSMC__EVENT_SESSION(u32Session, enState) (  NSMC__EVENT_RESTART(NsmRestartReason_Last)                    \
+                                                  + ((u32Session) * NSMC__SESSION_STATE_CNT) + (guint) (enState))
+
+#define NSMC__MASK(u32Value)                    (1U << (guint) (u32Value))
+
+/* The type defines a compiled transition */
+typedef struct
+{
+  guint32              u32NodeStateMask;       /* Guard: NodeStates, in which the transition may be taken      */
+  guint32              u32ShutdownReasonMask;  /* Guard: ShutdownReasons, in which the transition may be taken */
+  gint                 i32Session;             /* Guard: Index of the checked session. -1 if there is none     */
+  guint32              u32SessionStateMask;    /* Guard: States of the session, in which it may be taken       */
+  guint                u32NextState;           /* State of the machine after the transition                    */
+  NsmNodeState_e       enNodeState;            /* Action: NodeState to set. NsmNodeState_NotSet for none       */
+  NsmApplicationMode_e enAppMode;              /* Action: AppMode to set. NsmApplicationMode_NotSet for none   */
+  NsmShutdownReason_e  enShutdownReason;       /* Action: ShutdownReason to set. NotSet for none               */
+} NSMC__tstTransition;
+
+/* The type defines the actions of a taken transition. They are set in the NSM, after the mutex has been released. */
+typedef struct
+{
+  gboolean             boTaken;                /* TRUE, if a transition has been taken                         */
+  guint                u32Transition;          /* Index of the taken transition                                */
+  NsmDataEntry_s       astEntries[3];          /* Actions of the transition, pointing into the transition      */
+  guint                u32Entries;             /* Number of actions                                            */
+  guint                u32Sequence;            /* Transition counter, after the transition has been taken      */
+  guint                u32PrevState;           /* Machine before the transition. Restored, if the NSM rejects  */
+  NsmNodeState_e       enPrevNodeState;        /* the actions and no other transition has been taken since.    */
+  NsmShutdownReason_e  enPrevShutdownReason;
+} NSMC__tstActions;
+
+
+/**********************************************************************************************************************
+*
+* Local variables
+*
+**********************************************************************************************************************/
+
+/* Names of the values, used in the description */
+static const gchar *NSMC__asNodeStates[NsmNodeState_Last] =
+{
+  "NotSet", "StartUp", "BaseRunning", "LucRunning", "FullyRunning", "FullyOperational", "ShuttingDown",
+  "ShutdownDelay", "FastShutdown", "DegradedPower", "Shutdown", "Suspending", "Suspended"
+};
+
+static const gchar *NSMC__asAppModes[NsmApplicationMode_Last] =
+{
+  "NotSet", "Parking", "Factory", "Transport", "Normal", "Swl"
+};
+
+static const gchar *NSMC__asShutdownReasons[NsmShutdownReason_Last] =
+{
+  "NotSet", "Normal", "SupplyBad", "SupplyPoor", "ThermalBad", "ThermalPoor", "SwlNotActive"
+};
+
+static const gchar *NSMC__asRestartReasons[NsmRestartReason_Last] =
+{
+  "NotSet", "ApplicationFailure", "Diagnosis", "Swl", "User"
+};
+
+static const gchar *NSMC__asSessionStates[NSMC__SESSION_STATE_CNT] =
+{
+  "Unregistered", "Inactive", "Active"
+};
+
+/* Compiled description */
+static gchar              **NSMC__asStates         = NULL;  /* Names of the states of the machine          */
+static guint                NSMC__u32StateCnt      = 0;
+static guint                NSMC__u32EventCnt      = 0;
+static guint16             *NSMC__pu16Table        = NULL;  /* [state * events + event]: Transition + 1    */
+static NSMC__tstTransition *NSMC__pstTransitions   = NULL;
+static GHashTable          *NSMC__pSessions        = NULL;  /* Session name -> index of the session + 1    */
+static guint32              NSMC__au32NodeStates[NsmNodeState_Last]; /* Allowed NodeStates per NodeState   */
+static gboolean             NSMC__boLucRequired    = TRUE;
+
+/* Runtime state */
+static GMutex              *NSMC__pMutex           = NULL;
+static guint                NSMC__u32State         = 0;
+static NsmNodeState_e       NSMC__enNodeState      = NsmNodeState_NotSet;
+static NsmShutdownReason_e  NSMC__enShutdownReason = NsmShutdownReason_NotSet;
+static NsmSessionState_e   *NSMC__penSessionStates = NULL;  /* Last state of every session of the description */
+static guint                NSMC__u32Sequence      = 0;     /* Number of transitions taken                    */
+
+/* The table driven NSMC can also be loaded via NSM_NSMC_PLUGIN */
+NSMC_PLUGIN_EXPORT("NodeStateMachineTable", NULL);
+
+
+/**********************************************************************************************************************
+*
+* Prototypes for file local functions (see implementation for description)
+*
+**********************************************************************************************************************/
+
+static gint     NSMC__i32FindName(const gchar * const *asNames, guint u32NameCnt, const gchar *sName);
+static gboolean NSMC__boLoadMask(GKeyFile *pKeyFile, const gchar *sGroup, const gchar *sKey,
+                                 const gchar * const *asNames, guint u32NameCnt, guint32 *pu32Mask);
+static gboolean NSMC__boLoadValue(GKeyFile *pKeyFile, const gchar *sGroup, const gchar *sKey,
+                                  const gchar * const *asNames, guint u32NameCnt, gint *pi32Value);
+static guint    NSMC__u32InternSession(const gchar *sSession);
+static gboolean NSMC__boLoadEvent(const gchar *sEvent, guint *pu32Event);
+static gboolean NSMC__boLoadTransition(GKeyFile *pKeyFile, const gchar *sGroup, NSMC__tstTransition *pstTransition,
+                                       gint *pi32From, guint *pu32Event);
+static void     NSMC__vFreeDescription(void);
+static gboolean NSMC__boLoadDescription(const gchar *sFile);
+static NsmErrorStatus_e NSMC__enHandleEvent(guint u32Event, NSMC__tstActions *pstActions);
+static NsmErrorStatus_e NSMC__enSetActions(NSMC__tstActions *pstActions);
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function searches a name in a table of names.
+*
+* @param asNames:    Table of names
+* @param u32NameCnt: Number of names in the table
+* @param sName:      Name to search
+*
+* @return Index of the name in the table or -1, if the name is unknown.
+*
+**********************************************************************************************************************/
+static gint NSMC__i32FindName(const gchar * const *asNames, guint u32NameCnt, const gchar *sName)
+{
+  gint  i32RetVal = -1;
+  guint u32Idx    = 0;
+
+  for(u32Idx = 0; (u32Idx < u32NameCnt) && (i32RetVal == -1); u32Idx++)
+  {
+    if(strcmp(asNames[u32Idx], sName) == 0)
+    {
+      i32RetVal = (gint) u32Idx;
+    }
+  }
+
+  return i32RetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function loads a list of names from the description and compiles it into a bit mask.
+*
+* @param pKeyFile:   Description
+* @param sGroup:     Group of the key
+* @param sKey:       Key with the list of names
+* @param asNames:    Table of the valid names
+* @param u32NameCnt: Number of valid names
+* @param pu32Mask:   Mask of the listed names. NSMC_TABLE_ALL, if the key does not exist.
+*
+* @return TRUE: Mask loaded. FALSE: The list contains an unknown name.
+*
+**********************************************************************************************************************/
+static gboolean NSMC__boLoadMask(GKeyFile *pKeyFile, const gchar *sGroup, const gchar *sKey,
+                                 const gchar * const *asNames, guint u32NameCnt, guint32 *pu32Mask)
+{
+  gboolean boRetVal   = TRUE;
+  gchar  **asList     = NULL;
+  gsize    u32ListLen = 0;
+  guint    u32Idx     = 0;
+  gint     i32Value   = 0;
+
+  *pu32Mask = NSMC_TABLE_ALL;
+
+  if(g_key_file_has_key(pKeyFile, sGroup, sKey, NULL) == TRUE)
+  {
+    *pu32Mask = 0;
+    asList    = g_key_file_get_string_list(pKeyFile, sGroup, sKey, &u32ListLen, NULL);
+
+    for(u32Idx = 0; (u32Idx < u32ListLen) && (boRetVal == TRUE); u32Idx++)
+    {
+      i32Value = NSMC__i32FindName(asNames, u32NameCnt, asList[u32Idx]);
+
+      if(i32Value >= 0)
+      {
+        *pu32Mask |= NSMC__MASK(i32Value);
+      }
+      else
+      {
+        printf("NSMC: Unknown value \"%s\" in [%s] %s.\n", asList[u32Idx], sGroup, sKey);
+        boRetVal = FALSE;
+      }
+    }
+
+    g_strfreev(asList);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function loads a single name from the description and compiles it into its value.
+*
+* @param pKeyFile:   Description
+* @param sGroup:     Group of the key
+* @param sKey:       Key with the name
+* @param asNames:    Table of the valid names
+* @param u32NameCnt: Number of valid names
+* @param pi32Value:  Value of the name. Not changed, if the key does not exist.
+*
+* @return TRUE: Value loaded or key does not exist. FALSE: The name is unknown.
+*
+**********************************************************************************************************************/
+static gboolean NSMC__boLoadValue(GKeyFile *pKeyFile, const gchar *sGroup, const gchar *sKey,
+                                  const gchar * const *asNames, guint u32NameCnt, gint *pi32Value)
+{
+  gboolean boRetVal = TRUE;
+  gchar   *sName    = NULL;
+  gint     i32Value = 0;
+
+  sName = g_key_file_get_string(pKeyFile, sGroup, sKey, NULL);
+
+  if(sName != NULL)
+  {
+    i32Value = NSMC__i32FindName(asNames, u32NameCnt, sName);
+
+    if(i32Value >= 0)
+    {
+      *pi32Value = i32Value;
+    }
+    else
+    {
+      printf("NSMC: Unknown value \"%s\" in [%s] %s.\n", sName, sGroup, sKey);
+      boRetVal = FALSE;
+    }
+
+    g_free(sName);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function returns the index of a session of the description. New sessions get the next free index.
+*
+* @param sSession: Name of the session
+*
+* @return Index of the session
+*
+**********************************************************************************************************************/
+static guint NSMC__u32InternSession(const gchar *sSession)
+{
+  guint u32Session = GPOINTER_TO_UINT(g_hash_table_lookup(NSMC__pSessions, sSession));
+
+  if(u32Session == 0)
+  {
+    u32Session = g_hash_table_size(NSMC__pSessions) + 1;
+    g_hash_table_insert(NSMC__pSessions, g_strdup(sSession), GUINT_TO_POINTER(u32Session));
+  }
+
+  return u32Session - 1;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function compiles the name of an event into its number. Events are named "<Type>:<Value>":
+* "NodeState:<NodeState>", "AppMode:<ApplicationMode>", "ShutdownReason:<ShutdownReason>",
+* "Restart:<RestartReason>" or "Session:<SessionName>:<SessionState>".
+*
+* @param sEvent:    Name of the event
+* @param pu32Event: Number of the event
+*
+* @return TRUE: Event compiled. FALSE: The event is unknown.
+*
+**********************************************************************************************************************/
+static gboolean NSMC__boLoadEvent(const gchar *sEvent, guint *pu32Event)
+{
+  gboolean boRetVal   = FALSE;
+  gchar  **asParts    = NULL;
+  guint    u32PartCnt = 0;
+  gint     i32Value   = -1;
+
+  asParts    = g_strsplit(sEvent, ":", 3);
+  u32PartCnt = g_strv_length(asParts);
+
+  if(u32PartCnt == 2)
+  {
+    if(strcmp(asParts[0], "NodeState") == 0)
+    {
+      i32Value   = NSMC__i32FindName(NSMC__asNodeStates, NsmNodeState_Last, asParts[1]);
+      *pu32Event = NSMC__EVENT_NODESTATE(i32Value);
+    }
+    else if(strcmp(asParts[0], "AppMode") == 0)
+    {
+      i32Value   = NSMC__i32FindName(NSMC__asAppModes, NsmApplicationMode_Last, asParts[1]);
+      *pu32Event = NSMC__EVENT_APPMODE(i32Value);
+    }
+    else if(strcmp(asParts[0], "ShutdownReason") == 0)
+    {
+      i32Value   = NSMC__i32FindName(NSMC__asShutdownReasons, NsmShutdownReason_Last, asParts[1]);
+      *pu32Event = NSMC__EVENT_SHUTDOWNREASON(i32Value);
+    }
+    else if(strcmp(asParts[0], "Restart") == 0)
+    {
+      i32Value   = NSMC__i32FindName(NSMC__asRestartReasons, NsmRestartReason_Last, asParts[1]);
+      *pu32Event = NSMC__EVENT_RESTART(i32Value);
+    }
+  }
+  else if((u32PartCnt == 3) && (strcmp(asParts[0], "Session") == 0))
+  {
+    i32Value = NSMC__i32FindName(NSMC__asSessionStates, NSMC__SESSION_STATE_CNT, asParts[2]);
+
+    if(i32Value >= 0)
+    {
+      *pu32Event = NSMC__EVENT_SESSION(NSMC__u32InternSession(asParts[1]), i32Value);
+    }
+  }
+
+  boRetVal = (i32Value >= 0);
+
+  if(boRetVal == FALSE)
+  {
+    printf("NSMC: Unknown event \"%s\".\n", sEvent);
+  }
+
+  g_strfreev(asParts);
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function compiles a transition group of the description.
+*
+* @param pKeyFile:      Description
+* @param sGroup:        Group of the transition
+* @param pstTransition: Compiled transition
+* @param pi32From:      Source state of the transition. -1 for every state.
+* @param pu32Event:     Event of the transition
+*
+* @return TRUE: Transition compiled. FALSE: The transition is invalid.
+*
+**********************************************************************************************************************/
+static gboolean NSMC__boLoadTransition(GKeyFile *pKeyFile, const gchar *sGroup, NSMC__tstTransition *pstTransition,
+                                       gint *pi32From, guint *pu32Event)
+{
+  gboolean boRetVal   = FALSE;
+  gchar   *sFrom      = NULL;
+  gchar   *sEvent     = NULL;
+  gchar   *sSession   = NULL;
+  gint     i32To      = -1;
+  gint     i32Value   = 0;
+  gchar   *sRestart   = NULL;
+
+  sFrom  = g_key_file_get_string(pKeyFile, sGroup, "From",  NULL);
+  sEvent = g_key_file_get_string(pKeyFile, sGroup, "Event", NULL);
+
+  if((sFrom != NULL) && (sEvent != NULL))
+  {
+    *pi32From = (strcmp(sFrom, NSMC_TABLE_ANY_STATE) == 0)
+              ? -1 : NSMC__i32FindName((const gchar * const *) NSMC__asStates, NSMC__u32StateCnt, sFrom);
+    i32To     = (*pi32From >= 0) ? *pi32From : -1;
+
+    boRetVal =    ((*pi32From >= 0) || (strcmp(sFrom, NSMC_TABLE_ANY_STATE) == 0))
+               && (NSMC__boLoadEvent(sEvent, pu32Event) == TRUE);
+  }
+
+  if(boRetVal == FALSE)
+  {
+    printf("NSMC: Transition [%s] has an invalid \"From\" or \"Event\".\n", sGroup);
+  }
+
+  /* Guards */
+  boRetVal =    (boRetVal == TRUE)
+             && (NSMC__boLoadMask(pKeyFile, sGroup, "Guard.NodeState",
+                                  NSMC__asNodeStates, NsmNodeState_Last, &pstTransition->u32NodeStateMask) == TRUE)
+             && (NSMC__boLoadMask(pKeyFile, sGroup, "Guard.ShutdownReason",
+                                  NSMC__asShutdownReasons, NsmShutdownReason_Last,
+                                  &pstTransition->u32ShutdownReasonMask) == TRUE)
+             && (NSMC__boLoadMask(pKeyFile, sGroup, "Guard.SessionState",
+                                  NSMC__asSessionStates, NSMC__SESSION_STATE_CNT,
+                                  &pstTransition->u32SessionStateMask) == TRUE);
+
+  pstTransition->i32Session = -1;
+  sSession = g_key_file_get_string(pKeyFile, sGroup, "Guard.Session", NULL);
+
+  if(sSession != NULL)
+  {
+    pstTransition->i32Session = (gint) NSMC__u32InternSession(sSession);
+  }
+
+  /* Target state. A transition without target stays in its state. A transition from every state needs a target. */
+  boRetVal =    (boRetVal == TRUE)
+             && (NSMC__boLoadValue(pKeyFile, sGroup, "To",
+                                   (const gchar * const *) NSMC__asStates, NSMC__u32StateCnt, &i32To) == TRUE);
+
+  if((boRetVal == TRUE) && (i32To < 0))
+  {
+    printf("NSMC: Transition [%s] from \"%s\" has no target state.\n", sGroup, sFrom);
+    boRetVal = FALSE;
+  }
+
+  pstTransition->u32NextState = (guint) i32To;
+
+  /* Actions */
+  i32Value = NsmNodeState_NotSet;
+  boRetVal =    (boRetVal == TRUE)
+             && (NSMC__boLoadValue(pKeyFile, sGroup, "SetNodeState",
+                                   NSMC__asNodeStates, NsmNodeState_Last, &i32Value) == TRUE);
+  pstTransition->enNodeState = (NsmNodeState_e) i32Value;
+
+  i32Value = NsmApplicationMode_NotSet;
+  boRetVal =    (boRetVal == TRUE)
+             && (NSMC__boLoadValue(pKeyFile, sGroup, "SetAppMode",
+                                   NSMC__asAppModes, NsmApplicationMode_Last, &i32Value) == TRUE);
+  pstTransition->enAppMode = (NsmApplicationMode_e) i32Value;
+
+  i32Value = NsmShutdownReason_NotSet;
+  boRetVal =    (boRetVal == TRUE)
+             && (NSMC__boLoadValue(pKeyFile, sGroup, "SetShutdownReason",
+                                   NSMC__asShutdownReasons, NsmShutdownReason_Last, &i32Value) == TRUE);
+  pstTransition->enShutdownReason = (NsmShutdownReason_e) i32Value;
+
+  /* A restart is a shutdown of the node. The restart itself is done by the platform, after the NSM terminated. */
+  sRestart = g_key_file_get_string(pKeyFile, sGroup, "Restart", NULL);
+
+  if((boRetVal == TRUE) && (sRestart != NULL))
+  {
+    if(strcmp(sRestart, "Normal") == 0)
+    {
+      pstTransition->enNodeState = NsmNodeState_ShuttingDown;
+    }
+    else if(strcmp(sRestart, "Fast") == 0)
+    {
+      pstTransition->enNodeState = NsmNodeState_FastShutdown;
+    }
+    else
+    {
+      printf("NSMC: Unknown restart type \"%s\" in [%s].\n", sRestart, sGroup);
+      boRetVal = FALSE;
+    }
+  }
+
+  g_free(sFrom);
+  g_free(sEvent);
+  g_free(sSession);
+  g_free(sRestart);
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function frees a compiled description and resets the machine, so that a description can be loaded again.
+*
+**********************************************************************************************************************/
+static void NSMC__vFreeDescription(void)
+{
+  if(NSMC__pSessions != NULL)
+  {
+    g_hash_table_destroy(NSMC__pSessions);
+  }
+
+  g_strfreev(NSMC__asStates);
+  g_free(NSMC__pu16Table);
+  g_free(NSMC__pstTransitions);
+  g_free(NSMC__penSessionStates);
+
+  NSMC__pSessions        = NULL;
+  NSMC__asStates         = NULL;
+  NSMC__pu16Table        = NULL;
+  NSMC__pstTransitions   = NULL;
+  NSMC__penSessionStates = NULL;
+  NSMC__u32StateCnt      = 0;
+  NSMC__u32EventCnt      = 0;
+  NSMC__boLucRequired    = TRUE;
+  NSMC__u32State         = 0;
+  NSMC__enNodeState      = NsmNodeState_NotSet;
+  NSMC__enShutdownReason = NsmShutdownReason_NotSet;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function loads the description and compiles it into the transition table.
+*
+* @param sFile: Path of the description
+*
+* @return TRUE: Description compiled. FALSE: The description could not be loaded or is invalid.
+*
+**********************************************************************************************************************/
+static gboolean NSMC__boLoadDescription(const gchar *sFile)
+{
+  gboolean             boRetVal        = FALSE;
+  GKeyFile            *pKeyFile        = NULL;
+  GError              *pError          = NULL;
+  gchar                sGroup[32];
+  guint                u32TransitionCnt = 0;
+  guint                u32Idx          = 0;
+  guint                u32State        = 0;
+  guint                u32Cell         = 0;
+  gint                 i32Initial      = 0;
+  gint                *pi32From        = NULL;
+  guint               *pu32Events      = NULL;
+  guint32              u32Mask         = 0;
+
+  NSMC__vFreeDescription();
+
+  pKeyFile         = g_key_file_new();
+  NSMC__pSessions  = g_hash_table_new_full(&g_str_hash, &g_str_equal, &g_free, NULL);
+
+  if(g_key_file_load_from_file(pKeyFile, sFile, G_KEY_FILE_NONE, &pError) == TRUE)
+  {
+    /* States of the machine */
+    NSMC__asStates    = g_key_file_get_string_list(pKeyFile, NSMC_TABLE_GROUP_MACHINE, "States", NULL, NULL);
+    NSMC__u32StateCnt = (NSMC__asStates != NULL) ? g_strv_length(NSMC__asStates) : 0;
+    boRetVal          =    (NSMC__u32StateCnt > 0)
+                        && (NSMC__boLoadValue(pKeyFile, NSMC_TABLE_GROUP_MACHINE, "InitialState",
+                                              (const gchar * const *) NSMC__asStates, NSMC__u32StateCnt,
+                                              &i32Initial) == TRUE);
+    NSMC__u32State    = (guint) i32Initial;
+
+    if(g_key_file_has_key(pKeyFile, NSMC_TABLE_GROUP_MACHINE, "LucRequired", NULL) == TRUE)
+    {
+      NSMC__boLucRequired = g_key_file_get_boolean(pKeyFile, NSMC_TABLE_GROUP_MACHINE, "LucRequired", NULL);
+    }
+
+    /* Allowed NodeState transitions. A NodeState without key may change to every NodeState. */
+    for(u32Idx = 0; (u32Idx < NsmNodeState_Last) && (boRetVal == TRUE); u32Idx++)
+    {
+      boRetVal = NSMC__boLoadMask(pKeyFile, NSMC_TABLE_GROUP_NODESTATES, NSMC__asNodeStates[u32Idx],
+                                  NSMC__asNodeStates, NsmNodeState_Last, &u32Mask);
+      NSMC__au32NodeStates[u32Idx] = u32Mask | NSMC__MASK(u32Idx);
+    }
+
+    /* Transitions are numbered from 0. Compile them, before the number of events (sessions) is known. */
+    g_snprintf(sGroup, sizeof(sGroup), NSMC_TABLE_GROUP_TRANSITION, u32TransitionCnt);
+
+    while((boRetVal == TRUE) && (g_key_file_has_group(pKeyFile, sGroup) == TRUE))
+    {
+      boRetVal = (u32TransitionCnt < NSMC_TABLE_MAX_TRANSITIONS);
+
+      if(boRetVal == TRUE)
+      {
+        NSMC__pstTransitions = g_renew(NSMC__tstTransition, NSMC__pstTransitions, u32TransitionCnt + 1);
+        pi32From             = g_renew(gint,  pi32From,   u32TransitionCnt + 1);
+        pu32Events           = g_renew(guint, pu32Events, u32TransitionCnt + 1);
+
+        boRetVal = NSMC__boLoadTransition(pKeyFile, sGroup, &NSMC__pstTransitions[u32TransitionCnt],
+                                          &pi32From[u32TransitionCnt], &pu32Events[u32TransitionCnt]);
+      }
+
+      u32TransitionCnt++;
+      g_snprintf(sGroup, sizeof(sGroup), NSMC_TABLE_GROUP_TRANSITION, u32TransitionCnt);
+    }
+
+    /* Fill the dense table. Transitions of a state take precedence over transitions from every state ("*"). */
+    if(boRetVal == TRUE)
+    {
+      NSMC__u32EventCnt      = NSMC__EVENT_SESSION(g_hash_table_size(NSMC__pSessions), 0);
+      NSMC__pu16Table        = g_new0(guint16, NSMC__u32StateCnt * NSMC__u32EventCnt);
+      NSMC__penSessionStates = g_new0(NsmSessionState_e, g_hash_table_size(NSMC__pSessions));
+
+      for(u32Idx = 0; (u32Idx < u32TransitionCnt) && (boRetVal == TRUE); u32Idx++)
+      {
+        if(pi32From[u32Idx] >= 0)
+        {
+          u32Cell  = ((guint) pi32From[u32Idx] * NSMC__u32EventCnt) + pu32Events[u32Idx];
+          boRetVal = (NSMC__pu16Table[u32Cell] == 0);
+          NSMC__pu16Table[u32Cell] = (guint16) (u32Idx + 1);
+
+          if(boRetVal == FALSE)
+          {
+            printf("NSMC: Transition%u has the same state and event as an other transition.\n", u32Idx);
+          }
+        }
+      }
+
+      for(u32Idx = 0; (u32Idx < u32TransitionCnt) && (boRetVal == TRUE); u32Idx++)
+      {
+        for(u32State = 0; (u32State < NSMC__u32StateCnt) && (pi32From[u32Idx] < 0); u32State++)
+        {
+          u32Cell = (u32State * NSMC__u32EventCnt) + pu32Events[u32Idx];
+
+          if(NSMC__pu16Table[u32Cell] == 0)
+          {
+            NSMC__pu16Table[u32Cell] = (guint16) (u32Idx + 1);
+          }
+        }
+      }
+    }
+
+    if(boRetVal == TRUE)
+    {
+      printf("NSMC: Loaded \"%s\". States: %u. Events: %u. Transitions: %u.\n",
+             sFile, NSMC__u32StateCnt, NSMC__u32EventCnt, u32TransitionCnt);
+    }
+    else
+    {
+      printf("NSMC: Description \"%s\" is invalid.\n", sFile);
+    }
+  }
+  else
+  {
+    printf("NSMC: Failed to load description \"%s\". Error: %s\n", sFile, pError->message);
+    g_error_free(pError);
+  }
+
+  g_free(pi32From);
+  g_free(pu32Events);
+  g_key_file_free(pKeyFile);
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function handles an event. It has to be called with the mutex locked. It looks up the transition of the current
+* state and the event in the table and checks its guards. A NodeState that is not allowed in the current NodeState is
+* rejected. Otherwise the transition is taken and its actions are returned. They have to be set with
+* NSMC__enSetActions, after the mutex has been released.
+*
+* @param u32Event:   Number of the event
+* @param pstActions: Actions of the taken transition. pstActions->boTaken is FALSE, if no transition has been taken.
+*
+* @return NsmErrorStatus_Ok:        Event handled (with or without transition).
+*         NsmErrorStatus_Parameter: The transition would set a NodeState, which is not allowed.
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSMC__enHandleEvent(guint u32Event, NSMC__tstActions *pstActions)
+{
+  NsmErrorStatus_e     enRetVal      = NsmErrorStatus_Ok;
+  NSMC__tstTransition *pstTransition = NULL;
+  NsmDataEntry_s      *pstEntry      = NULL;
+  guint16              u16Transition = 0;
+
+  pstActions->boTaken    = FALSE;
+  pstActions->u32Entries = 0;
+  u16Transition          = NSMC__pu16Table[(NSMC__u32State * NSMC__u32EventCnt) + u32Event];
+
+  if(u16Transition != 0)
+  {
+    pstTransition = &NSMC__pstTransitions[u16Transition - 1];
+
+    if(   ((pstTransition->u32NodeStateMask      & NSMC__MASK(NSMC__enNodeState))      != 0)
+       && ((pstTransition->u32ShutdownReasonMask & NSMC__MASK(NSMC__enShutdownReason)) != 0)
+       && (   (pstTransition->i32Session < 0)
+           || ((pstTransition->u32SessionStateMask & NSMC__MASK(NSMC__penSessionStates[pstTransition->i32Session])) != 0)))
+    {
+      if(   (pstTransition->enNodeState != NsmNodeState_NotSet)
+         && ((NSMC__au32NodeStates[NSMC__enNodeState] & NSMC__MASK(pstTransition->enNodeState)) == 0))
+      {
+        printf("NSMC: Transition%u rejected. NodeState %s not allowed in %s.\n", u16Transition - 1,
+               NSMC__asNodeStates[pstTransition->enNodeState], NSMC__asNodeStates[NSMC__enNodeState]);
+        enRetVal = NsmErrorStatus_Parameter;
+      }
+      else
+      {
+        if(pstTransition->enShutdownReason != NsmShutdownReason_NotSet)
+        {
+          pstEntry             = &pstActions->astEntries[pstActions->u32Entries++];
+          pstEntry->enData     = NsmDataType_ShutdownReason;
+          pstEntry->pData      = (unsigned char*) &pstTransition->enShutdownReason;
+          pstEntry->u32DataLen = sizeof(NsmShutdownReason_e);
+        }
+
+        if(pstTransition->enAppMode != NsmApplicationMode_NotSet)
+        {
+          pstEntry             = &pstActions->astEntries[pstActions->u32Entries++];
+          pstEntry->enData     = NsmDataType_AppMode;
+          pstEntry->pData      = (unsigned char*) &pstTransition->enAppMode;
+          pstEntry->u32DataLen = sizeof(NsmApplicationMode_e);
+        }
+
+        if(pstTransition->enNodeState != NsmNodeState_NotSet)
+        {
+          pstEntry             = &pstActions->astEntries[pstActions->u32Entries++];
+          pstEntry->enData     = NsmDataType_NodeState;
+          pstEntry->pData      = (unsigned char*) &pstTransition->enNodeState;
+          pstEntry->u32DataLen = sizeof(NsmNodeState_e);
+        }
+
+        pstActions->boTaken              = TRUE;
+        pstActions->u32Transition        = u16Transition - 1U;
+        pstActions->u32PrevState         = NSMC__u32State;
+        pstActions->enPrevNodeState      = NSMC__enNodeState;
+        pstActions->enPrevShutdownReason = NSMC__enShutdownReason;
+
+        /* Take the transition now, so that events passed while the actions are set, see the new state. The NSM does
+           not inform the NSMC about data it set itself. */
+        NSMC__enNodeState       = (pstTransition->enNodeState      != NsmNodeState_NotSet)
+                                ? pstTransition->enNodeState      : NSMC__enNodeState;
+        NSMC__enShutdownReason  = (pstTransition->enShutdownReason != NsmShutdownReason_NotSet)
+                                ? pstTransition->enShutdownReason : NSMC__enShutdownReason;
+        NSMC__u32State          = pstTransition->u32NextState;
+        pstActions->u32Sequence = ++NSMC__u32Sequence;
+      }
+    }
+  }
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function sets the actions of a taken transition in the NSM as one batch. It has to be called with the mutex
+* released: While the NSM sets the actions, it can call NsmcSetData again (e.g. when the last lifecycle client has
+* been informed about the new NodeState). If the NSM rejects the actions, the machine returns to its state before the
+* transition, unless an other transition has been taken in the meantime.
+*
+* @param pstActions: Actions returned by NSMC__enHandleEvent
+*
+* @return NsmErrorStatus_Ok:    No transition taken or actions set.
+*         NsmErrorStatus_Error: The NSM rejected the actions.
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSMC__enSetActions(NSMC__tstActions *pstActions)
+{
+  NsmErrorStatus_e enRetVal = NsmErrorStatus_Ok;
+
+  if(   (pstActions->boTaken    == TRUE)
+     && (pstActions->u32Entries  > 0   )
+     && (NsmSetDataBatch(pstActions->astEntries, pstActions->u32Entries) != NsmErrorStatus_Ok))
+  {
+    printf("NSMC: Transition%u failed. The NSM rejected the actions.\n", pstActions->u32Transition);
+    enRetVal = NsmErrorStatus_Error;
+
+    g_mutex_lock(NSMC__pMutex);
+
+    if(NSMC__u32Sequence == pstActions->u32Sequence)
+    {
+      NSMC__u32State         = pstActions->u32PrevState;
+      NSMC__enNodeState      = pstActions->enPrevNodeState;
+      NSMC__enShutdownReason = pstActions->enPrevShutdownReason;
+    }
+
+    g_mutex_unlock(NSMC__pMutex);
+  }
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* Interfaces, exported functions. See header for detailed description.
+*
+**********************************************************************************************************************/
+
+unsigned char NsmcInit(void)
+{
+  unsigned char u8RetVal = 0;
+  const gchar  *sFile    = g_getenv(NSMC_TABLE_ENV_FILE);
+
+  if(NSMC__pMutex == NULL)
+  {
+    NSMC__pMutex = g_mutex_new();
+  }
+
+  if(NSMC__boLoadDescription((sFile != NULL) ? sFile : NSMC_TABLE_FILE) == TRUE)
+  {
+    u8RetVal = 1;
+  }
+
+  return u8RetVal;
+}
+
+
+unsigned char NsmcLucRequired(void)
+{
+  return (NSMC__boLucRequired == TRUE) ? 1 : 0;
+}
+
+
+NsmErrorStatus_e NsmcSetData(NsmDataType_e enData, unsigned char *pData, unsigned int u32DataLen)
+{
+  NsmErrorStatus_e enRetVal    = NsmErrorStatus_Parameter;
+  NsmSession_s    *pstSession  = NULL;
+  NsmNodeState_e   enNodeState = NsmNodeState_NotSet;
+  guint            u32Session  = 0;
+  gint             i32Value    = 0;
+  NSMC__tstActions stActions;
+
+  memset(&stActions, 0, sizeof(stActions));
+  g_mutex_lock(NSMC__pMutex);
+
+  switch(enData)
+  {
+    case NsmDataType_NodeState:
+      if(u32DataLen == sizeof(NsmNodeState_e))
+      {
+        enNodeState = *((NsmNodeState_e*) pData);
+
+        if((guint) enNodeState < NsmNodeState_Last)
+        {
+          /* The NSM already changed the NodeState. An illegal change is reported and does not trigger a transition */
+          if((NSMC__au32NodeStates[NSMC__enNodeState] & NSMC__MASK(enNodeState)) != 0)
+          {
+            NSMC__enNodeState = enNodeState;
+            enRetVal          = NSMC__enHandleEvent(NSMC__EVENT_NODESTATE(enNodeState), &stActions);
+          }
+          else
+          {
+            printf("NSMC: NodeState %s not allowed in %s.\n",
+                   NSMC__asNodeStates[enNodeState], NSMC__asNodeStates[NSMC__enNodeState]);
+            NSMC__enNodeState = enNodeState;
+          }
+        }
+      }
+    break;
+
+    case NsmDataType_AppMode:
+      if(u32DataLen == sizeof(NsmApplicationMode_e))
+      {
+        i32Value = (gint) *((NsmApplicationMode_e*) pData);
+
+        if((i32Value >= 0) && (i32Value < NsmApplicationMode_Last))
+        {
+          enRetVal = NSMC__enHandleEvent(NSMC__EVENT_APPMODE(i32Value), &stActions);
+        }
+      }
+    break;
+
+    case NsmDataType_ShutdownReason:
+      if(u32DataLen == sizeof(NsmShutdownReason_e))
+      {
+        i32Value = (gint) *((NsmShutdownReason_e*) pData);
+
+        if((i32Value >= 0) && (i32Value < NsmShutdownReason_Last))
+        {
+          NSMC__enShutdownReason = (NsmShutdownReason_e) i32Value;
+          enRetVal               = NSMC__enHandleEvent(NSMC__EVENT_SHUTDOWNREASON(i32Value), &stActions);
+        }
+      }
+    break;
+
+    case NsmDataType_SessionState:
+      if(u32DataLen == sizeof(NsmSession_s))
+      {
+        pstSession = (NsmSession_s*) pData;
+        enRetVal   = NsmErrorStatus_Ok;
+
+        /* Sessions, which are not used by the description, are ignored */
+        u32Session = GPOINTER_TO_UINT(g_hash_table_lookup(NSMC__pSessions, pstSession->sName));
+
+        if((u32Session != 0) && ((guint) pstSession->enState < NSMC__SESSION_STATE_CNT))
+        {
+          NSMC__penSessionStates[u32Session - 1] = pstSession->enState;
+          enRetVal = NSMC__enHandleEvent(NSMC__EVENT_SESSION(u32Session - 1, pstSession->enState), &stActions);
+        }
+      }
+    break;
+
+    default:
+      /* Other data does not trigger transitions */
+      enRetVal = NsmErrorStatus_Ok;
+    break;
+  }
+
+  g_mutex_unlock(NSMC__pMutex);
+
+  if(enRetVal == NsmErrorStatus_Ok)
+  {
+    enRetVal = NSMC__enSetActions(&stActions);
+  }
+
+  return enRetVal;
+}
+
+
+unsigned char NsmcRequestNodeRestart(NsmRestartReason_e enRestartReason, unsigned int u32RestartType)
+{
+  unsigned char    u8RetVal = 0;
+  NsmErrorStatus_e enRetVal = NsmErrorStatus_Ok;
+  NSMC__tstActions stActions;
+
+  /* The restart type is defined by the action of the transition */
+  (void) u32RestartType;
+
+  if((guint) enRestartReason < NsmRestartReason_Last)
+  {
+    g_mutex_lock(NSMC__pMutex);
+    enRetVal = NSMC__enHandleEvent(NSMC__EVENT_RESTART(enRestartReason), &stActions);
+    g_mutex_unlock(NSMC__pMutex);
+
+    /* The request is accepted, if the description has a transition for it, whose actions the NSM accepted */
+    if(   (enRetVal          == NsmErrorStatus_Ok)
+       && (stActions.boTaken == TRUE)
+       && (NSMC__enSetActions(&stActions) == NsmErrorStatus_Ok))
+    {
+      u8RetVal = 1;
+    }
+  }
+
+  return u8RetVal;
+}
+
+
+unsigned int NsmcGetInterfaceVersion(void)
+{
+  return NSMC_INTERFACE_VERSION;
+}
@@ -0,0 +1,427 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the NodeStateTableTest.
+*
+* The file implements a test for the engine of the table driven NodeStateMachine. It is linked against the table
+* driven NSMC and replaces the NSM by an own NsmSetDataBatch, which records the actions of the NSMC. The test checks:
+*
+*   - Compile: Invalid descriptions are rejected by NsmcInit, a valid description is loaded.
+*   - Guard:   A transition is only taken, if its guards are fulfilled.
+*   - Reject:  A transition, which would set a NodeState that is not allowed, is rejected without setting anything.
+*   - Failure: If the NSM rejects the actions, the machine stays in its state.
+*   - Reentry: The NSM may call NsmcSetData, while it sets the actions of a transition.
+*
+* Usage: NodeStateTableTest
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+#include "NodeStateMachine.h" /* Interfaces of the tested NSMC    */
+#include "NodeStateManager.h" /* NsmSetDataBatch, set by the NSMC */
+#include "NodeStateTypes.h"   /* Types of the NSM                 */
+#include <glib.h>             /* Temporary files and environment  */
+#include <glib/gstdio.h>      /* g_unlink                         */
+#include <stdio.h>            /* printf                           */
+#include <string.h>           /* memset                           */
+#include <unistd.h>           /* alarm                            */
+
+
+/**********************************************************************************************************************
+*
+* Local defines, macros and type definitions.
+*
+**********************************************************************************************************************/
+
+/* Time after which a blocked (deadlocked) test is terminated */
+#define NSMTT__TIMEOUT_S  10
+
+/* Header of every description. The session "Diag" guards Transition1. */
+#define NSMTT__MACHINE    "[Machine]\nStates=Starting;Running;Stopping\nInitialState=Starting\n"
+
+/* Description used by the runtime tests */
+#define NSMTT__DESCRIPTION                                                                           \
+  NSMTT__MACHINE                                                                                     \
+  "[NodeStates]\nFastShutdown=Shutdown\n"                                                            \
+  "[Transition0]\nFrom=Starting\nEvent=NodeState:FullyRunning\nTo=Running\n"                         \
+  "[Transition1]\nFrom=Running\nEvent=ShutdownReason:ThermalBad\nGuard.Session=Diag\n"               \
+  "Guard.SessionState=Unregistered;Inactive\nSetNodeState=FastShutdown\nTo=Stopping\n"               \
+  "[Transition2]\nFrom=Stopping\nEvent=Restart:User\nRestart=Normal\n"                               \
+  "[Transition3]\nFrom=Running\nEvent=Restart:Diagnosis\nGuard.NodeState=FullyOperational\n"         \
+  "SetShutdownReason=Normal\nRestart=Normal\nTo=Stopping\n"                                          \
+  "[Transition4]\nFrom=Stopping\nEvent=AppMode:Normal\nSetNodeState=FullyRunning\n"
+
+/* The type defines a description, which NsmcInit has to reject */
+typedef struct
+{
+  const gchar *sName;          /* Name of the case for the output */
+  const gchar *sDescription;   /* Content of the description      */
+} NSMTT__tstInvalidDescription;
+
+
+/**********************************************************************************************************************
+*
+* Local variables
+*
+**********************************************************************************************************************/
+
+static const NSMTT__tstInvalidDescription NSMTT__astInvalid[] =
+{
+  {"no states",          "[Machine]\nInitialState=Starting\n"},
+  {"unknown initial",    "[Machine]\nStates=Starting\nInitialState=Running\n"},
+  {"unknown NodeState",  NSMTT__MACHINE "[NodeStates]\nShutdown=Flying\n"},
+  {"unknown event",      NSMTT__MACHINE "[Transition0]\nFrom=Starting\nEvent=NodeState:Flying\nTo=Running\n"},
+  {"unknown event type", NSMTT__MACHINE "[Transition0]\nFrom=Starting\nEvent=Weather:Rain\nTo=Running\n"},
+  {"unknown source",     NSMTT__MACHINE "[Transition0]\nFrom=Parking\nEvent=AppMode:Normal\nTo=Running\n"},
+  {"unknown target",     NSMTT__MACHINE "[Transition0]\nFrom=Starting\nEvent=AppMode:Normal\nTo=Parking\n"},
+  {"any without target", NSMTT__MACHINE "[Transition0]\nFrom=*\nEvent=AppMode:Normal\n"},
+  {"unknown guard",      NSMTT__MACHINE "[Transition0]\nFrom=Starting\nEvent=AppMode:Normal\n"
+                                        "Guard.ShutdownReason=Rain\n"},
+  {"unknown action",     NSMTT__MACHINE "[Transition0]\nFrom=Starting\nEvent=AppMode:Normal\nSetAppMode=Flying\n"},
+  {"unknown restart",    NSMTT__MACHINE "[Transition0]\nFrom=Starting\nEvent=Restart:User\nRestart=Slow\n"},
+  {"duplicate",          NSMTT__MACHINE "[Transition0]\nFrom=Starting\nEvent=AppMode:Normal\n"
+                                        "[Transition1]\nFrom=Starting\nEvent=AppMode:Normal\nTo=Running\n"}
+};
+
+/* Recorded actions and behavior of NsmSetDataBatch */
+static guint               NSMTT__u32Batches        = 0;
+static guint               NSMTT__u32LastEntries    = 0;
+static NsmNodeState_e      NSMTT__enLastNodeState   = NsmNodeState_NotSet;
+static NsmErrorStatus_e    NSMTT__enBatchResult     = NsmErrorStatus_Ok;
+static gboolean            NSMTT__boReenter         = FALSE;
+static NsmErrorStatus_e    NSMTT__enReenterResult   = NsmErrorStatus_NotSet;
+
+
+/**********************************************************************************************************************
+*
+* Prototypes for file local functions (see implementation for description)
+*
+**********************************************************************************************************************/
+
+static gboolean NSMTT__boInit(const gchar *sDescription);
+static void     NSMTT__vSetNodeState(NsmNodeState_e enNodeState);
+static void     NSMTT__vSetSession(NsmSessionState_e enState);
+static NsmErrorStatus_e NSMTT__enSetShutdownReason(NsmShutdownReason_e enReason);
+static gboolean NSMTT__boTestCompile(void);
+static gboolean NSMTT__boTestGuard(void);
+static gboolean NSMTT__boTestReject(void);
+static gboolean NSMTT__boTestFailure(void);
+static gboolean NSMTT__boTestReentry(void);
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function writes a description to a temporary file and loads it with NsmcInit. The recorded actions are reset.
+*
+* @param sDescription: Content of the description
+*
+* @return TRUE: NsmcInit loaded the description. FALSE: NsmcInit rejected it.
+*
+**********************************************************************************************************************/
+static gboolean NSMTT__boInit(const gchar *sDescription)
+{
+  gboolean boRetVal = FALSE;
+  gchar   *sFile    = NULL;
+  gint     i32Fd    = -1;
+
+  NSMTT__u32Batches      = 0;
+  NSMTT__u32LastEntries  = 0;
+  NSMTT__enLastNodeState = NsmNodeState_NotSet;
+  NSMTT__enBatchResult   = NsmErrorStatus_Ok;
+  NSMTT__boReenter       = FALSE;
+
+  i32Fd = g_file_open_tmp("NodeStateTableTest-XXXXXX", &sFile, NULL);
+
+  if(i32Fd >= 0)
+  {
+    close(i32Fd);
+
+    if(g_file_set_contents(sFile, sDescription, -1, NULL) == TRUE)
+    {
+      (void) g_setenv("NSMC_TABLE_FILE", sFile, TRUE);
+      boRetVal = (NsmcInit() == 1);
+    }
+
+    (void) g_unlink(sFile);
+    g_free(sFile);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The functions pass data to the NSMC, like the NSM would do after a change.
+*
+**********************************************************************************************************************/
+static void NSMTT__vSetNodeState(NsmNodeState_e enNodeState)
+{
+  (void) NsmcSetData(NsmDataType_NodeState, (unsigned char*) &enNodeState, sizeof(enNodeState));
+}
+
+static void NSMTT__vSetSession(NsmSessionState_e enState)
+{
+  NsmSession_s stSession;
+
+  memset(&stSession, 0, sizeof(stSession));
+  g_strlcpy(stSession.sName, "Diag", sizeof(stSession.sName));
+  stSession.enSeat  = NsmSeat_Driver;
+  stSession.enState = enState;
+
+  (void) NsmcSetData(NsmDataType_SessionState, (unsigned char*) &stSession, sizeof(stSession));
+}
+
+static NsmErrorStatus_e NSMTT__enSetShutdownReason(NsmShutdownReason_e enReason)
+{
+  return NsmcSetData(NsmDataType_ShutdownReason, (unsigned char*) &enReason, sizeof(enReason));
+}
+
+
+/**********************************************************************************************************************
+*
+* The function checks that invalid descriptions are rejected and a valid description is loaded.
+*
+* @return TRUE: Test passed. FALSE: Test failed.
+*
+**********************************************************************************************************************/
+static gboolean NSMTT__boTestCompile(void)
+{
+  gboolean boRetVal = TRUE;
+  gboolean boLoaded = FALSE;
+  guint    u32Idx   = 0;
+
+  for(u32Idx = 0; u32Idx < G_N_ELEMENTS(NSMTT__astInvalid); u32Idx++)
+  {
+    boLoaded = NSMTT__boInit(NSMTT__astInvalid[u32Idx].sDescription);
+    boRetVal = (boLoaded == FALSE) && (boRetVal == TRUE);
+
+    printf("Compile: %-20s -> %s\n", NSMTT__astInvalid[u32Idx].sName, (boLoaded == FALSE) ? "passed" : "failed");
+  }
+
+  (void) g_setenv("NSMC_TABLE_FILE", "/nonexistent/NodeStateMachine.conf", TRUE);
+  boLoaded = (NsmcInit() == 1);
+  boRetVal = (boLoaded == FALSE) && (boRetVal == TRUE);
+  printf("Compile: %-20s -> %s\n", "missing file", (boLoaded == FALSE) ? "passed" : "failed");
+
+  boLoaded = NSMTT__boInit(NSMTT__DESCRIPTION);
+  boRetVal = (boLoaded == TRUE) && (boRetVal == TRUE);
+  printf("Compile: %-20s -> %s\n", "valid", (boLoaded == TRUE) ? "passed" : "failed");
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function checks the guards of a session and of the NodeState.
+*
+* @return TRUE: Test passed. FALSE: Test failed.
+*
+**********************************************************************************************************************/
+static gboolean NSMTT__boTestGuard(void)
+{
+  gboolean boRetVal = FALSE;
+  gboolean boBlocked = FALSE;
+  guint8   u8Restart = 0;
+
+  boRetVal = NSMTT__boInit(NSMTT__DESCRIPTION);
+  NSMTT__vSetNodeState(NsmNodeState_FullyRunning);
+
+  /* Active session and NodeState FullyRunning block Transition1 and Transition3 */
+  NSMTT__vSetSession(NsmSessionState_Active);
+  boBlocked = (NSMTT__enSetShutdownReason(NsmShutdownReason_ThermalBad) == NsmErrorStatus_Ok);
+  u8Restart = NsmcRequestNodeRestart(NsmRestartReason_Diagnosis, NSM_SHUTDOWNTYPE_NORMAL);
+  boBlocked = (boBlocked == TRUE) && (u8Restart == 0) && (NSMTT__u32Batches == 0);
+
+  /* An inactive session allows Transition1 */
+  NSMTT__vSetSession(NsmSessionState_Inactive);
+  boRetVal =    (boRetVal  == TRUE)
+             && (boBlocked == TRUE)
+             && (NSMTT__enSetShutdownReason(NsmShutdownReason_ThermalBad) == NsmErrorStatus_Ok)
+             && (NSMTT__u32Batches      == 1)
+             && (NSMTT__u32LastEntries  == 1)
+             && (NSMTT__enLastNodeState == NsmNodeState_FastShutdown);
+
+  printf("Guard:   blocked %s, batches %u -> %s\n", (boBlocked == TRUE) ? "yes" : "no", NSMTT__u32Batches,
+         (boRetVal == TRUE) ? "passed" : "failed");
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function checks that transitions to NodeStates, which are not allowed, are rejected.
+*
+* @return TRUE: Test passed. FALSE: Test failed.
+*
+**********************************************************************************************************************/
+static gboolean NSMTT__boTestReject(void)
+{
+  gboolean         boRetVal  = FALSE;
+  guint8           u8Restart = 0;
+  NsmErrorStatus_e enResult  = NsmErrorStatus_NotSet;
+  NsmApplicationMode_e enAppMode = NsmApplicationMode_Normal;
+
+  /* Go to Stopping with NodeState FastShutdown, which may only be followed by Shutdown */
+  boRetVal = NSMTT__boInit(NSMTT__DESCRIPTION);
+  NSMTT__vSetNodeState(NsmNodeState_FullyRunning);
+  boRetVal = (boRetVal == TRUE) && (NSMTT__enSetShutdownReason(NsmShutdownReason_ThermalBad) == NsmErrorStatus_Ok);
+
+  u8Restart = NsmcRequestNodeRestart(NsmRestartReason_User, NSM_SHUTDOWNTYPE_NORMAL);
+  enResult  = NsmcSetData(NsmDataType_AppMode, (unsigned char*) &enAppMode, sizeof(enAppMode));
+
+  boRetVal =    (boRetVal  == TRUE)
+             && (u8Restart == 0)
+             && (enResult  == NsmErrorStatus_Parameter)
+             && (NSMTT__u32Batches == 1);
+
+  printf("Reject:  restart %u, AppMode %d, batches %u -> %s\n", u8Restart, enResult, NSMTT__u32Batches,
+         (boRetVal == TRUE) ? "passed" : "failed");
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function checks that the machine stays in its state, if the NSM rejects the actions of a transition.
+*
+* @return TRUE: Test passed. FALSE: Test failed.
+*
+**********************************************************************************************************************/
+static gboolean NSMTT__boTestFailure(void)
+{
+  gboolean boRetVal = FALSE;
+  guint8   u8Failed = 0;
+  guint8   u8Retry  = 0;
+
+  boRetVal = NSMTT__boInit(NSMTT__DESCRIPTION);
+  NSMTT__vSetNodeState(NsmNodeState_FullyRunning);
+  NSMTT__vSetNodeState(NsmNodeState_FullyOperational);
+
+  /* Transition3 is only taken in Running. The retry succeeds, if the failed request did not leave Running. */
+  NSMTT__enBatchResult = NsmErrorStatus_Error;
+  u8Failed = NsmcRequestNodeRestart(NsmRestartReason_Diagnosis, NSM_SHUTDOWNTYPE_NORMAL);
+  NSMTT__enBatchResult = NsmErrorStatus_Ok;
+  u8Retry  = NsmcRequestNodeRestart(NsmRestartReason_Diagnosis, NSM_SHUTDOWNTYPE_NORMAL);
+
+  boRetVal =    (boRetVal == TRUE)
+             && (u8Failed == 0)
+             && (u8Retry  == 1)
+             && (NSMTT__u32Batches      == 2)
+             && (NSMTT__u32LastEntries  == 2)
+             && (NSMTT__enLastNodeState == NsmNodeState_ShuttingDown);
+
+  printf("Failure: rejected %u, retry %u -> %s\n", u8Failed, u8Retry, (boRetVal == TRUE) ? "passed" : "failed");
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function checks that the NSM can pass data to the NSMC, while it sets the actions of a transition. This happens
+* when the last lifecycle client has been informed about the new NodeState. The test is terminated by SIGALRM, if the
+* NSMC blocks.
+*
+* @return TRUE: Test passed. FALSE: Test failed.
+*
+**********************************************************************************************************************/
+static gboolean NSMTT__boTestReentry(void)
+{
+  gboolean boRetVal = FALSE;
+
+  boRetVal = NSMTT__boInit(NSMTT__DESCRIPTION);
+  NSMTT__vSetNodeState(NsmNodeState_FullyRunning);
+
+  NSMTT__boReenter       = TRUE;
+  NSMTT__enReenterResult = NsmErrorStatus_NotSet;
+
+  boRetVal =    (boRetVal == TRUE)
+             && (NSMTT__enSetShutdownReason(NsmShutdownReason_ThermalBad) == NsmErrorStatus_Ok)
+             && (NSMTT__enReenterResult == NsmErrorStatus_Ok);
+
+  printf("Reentry: nested result %d -> %s\n", NSMTT__enReenterResult, (boRetVal == TRUE) ? "passed" : "failed");
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* Replacement of the NSM. The function records the actions and returns the configured result. If configured, it
+* passes the NodeState "Shutdown" to the NSMC, like the NSM does after the last lifecycle client has been informed.
+*
+**********************************************************************************************************************/
+NsmErrorStatus_e NsmSetDataBatch(NsmDataEntry_s *pstEntries, unsigned int u32Entries)
+{
+  NsmNodeState_e enNodeState = NsmNodeState_Shutdown;
+  guint          u32Idx      = 0;
+
+  NSMTT__u32Batches++;
+  NSMTT__u32LastEntries  = u32Entries;
+  NSMTT__enLastNodeState = NsmNodeState_NotSet;
+
+  for(u32Idx = 0; u32Idx < u32Entries; u32Idx++)
+  {
+    if(pstEntries[u32Idx].enData == NsmDataType_NodeState)
+    {
+      NSMTT__enLastNodeState = *((NsmNodeState_e*) pstEntries[u32Idx].pData);
+    }
+  }
+
+  if(NSMTT__boReenter == TRUE)
+  {
+    NSMTT__boReenter       = FALSE;
+    NSMTT__enReenterResult = NsmcSetData(NsmDataType_NodeState, (unsigned char*) &enNodeState, sizeof(enNodeState));
+  }
+
+  return NSMTT__enBatchResult;
+}
+
+
+/**********************************************************************************************************************
+*
+* Main function of the test.
+*
+* @return  0: All engine tests passed
+*         -1: At least one test failed
+*
+**********************************************************************************************************************/
+int main(void)
+{
+  gboolean boPassed = TRUE;
+
+  (void) alarm(NSMTT__TIMEOUT_S);
+
+  boPassed = (NSMTT__boTestCompile() == TRUE) && (boPassed == TRUE);
+  boPassed = (NSMTT__boTestGuard()   == TRUE) && (boPassed == TRUE);
+  boPassed = (NSMTT__boTestReject()  == TRUE) && (boPassed == TRUE);
+  boPassed = (NSMTT__boTestFailure() == TRUE) && (boPassed == TRUE);
+  boPassed = (NSMTT__boTestReentry() == TRUE) && (boPassed == TRUE);
+
+  printf("Result:  %s\n", (boPassed == TRUE) ? "passed" : "failed");
+
+  return (boPassed == TRUE) ? 0 : -1;
+}
@@ -0,0 +1,654 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the NodeStateBenchmark.
+*
+* The file implements a micro-benchmark for the D-Bus dispatch of the NodeStateManager. A method of the Consumer
+* interface is called synchronously a configurable number of times. Afterwards the calls per second and the CPU time
+* per call are printed. The CPU time is measured for the benchmark itself (getrusage) and for the NSM process, whose
+* PID is requested from the bus daemon and whose CPU time is read from "/proc/<pid>/stat".
+*
+* To compare the dispatch via the generated skeleton with the dispatch via the hand-written vtable, the benchmark is
+* run against a NSM configured without and with "--enable-vtable-dispatch".
+*
+* If the NSM has been configured "--with-p2psocket", the address of the socket can be passed. The calls are then
+* measured via the bus and directly via the socket, to compare the round trip latency of both paths.
+*
+* The NSM measures every method handler with the probes of "NodeStateStatistics.h". The benchmark resets these
+* statistics before the measured calls and prints the time the NSM spent in the handler afterwards. Additionally,
+* the cost of the probes themselves is measured locally, to show the overhead of the always enabled statistics.
+*
+* Usage: NodeStateBenchmark [Calls] [Method] [Address]
+*
+* Calls:   Number of measured calls (default NSMBM__DEFAULT_CALLS)
+* Method:  GetNodeState (default), GetApplicationMode, GetSessionState or GetInterfaceVersion
+* Address: D-Bus address of the peer-to-peer socket, e.g. "unix:path=/run/NodeStateManager.socket"
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+/* System header files                                                                          */
+#include <gio/gio.h>                    /* Use glib to access dbus and communicate to NSM       */
+#include <stdio.h>                      /* printf, sscanf                                       */
+#include <stdlib.h>                     /* strtoul                                              */
+#include <string.h>                     /* strrchr                                              */
+#include <unistd.h>                     /* sysconf                                              */
+#include <sys/resource.h>               /* getrusage                                            */
+
+/* Header files offered by NSM                                                                  */
+#include "NodeStateTypes.h"             /* Know type definitions of NSM                         */
+#include "NodeStateStatistics.h"        /* Probes used by the NSM to collect statistics         */
+
+/* Generated header files to access NSM via D-Bus                                               */
+#include "NodeStateConsumer.h"          /* Consumer interface with publicly available functions */
+
+
+/**********************************************************************************************************************
+*
+* Local defines, macros and type definitions.
+*
+**********************************************************************************************************************/
+
+/* Number of measured calls, if not passed on the command line */
+#define NSMBM__DEFAULT_CALLS  10000
+
+/* Number of calls before the measurement starts. Connection and caches of client and NSM are warmed up. */
+#define NSMBM__WARMUP_CALLS   100
+
+/* The type defines a benchmarked method. The function calls the method once and returns TRUE on success. */
+typedef struct
+{
+  const gchar *sMethodName;
+  gboolean   (*pfCall)(NodeStateConsumer *pConsumer);
+} NSMBM__tstMethod;
+
+
+/**********************************************************************************************************************
+*
+* Prototypes for file local functions (see implementation for description)
+*
+**********************************************************************************************************************/
+
+static gboolean NSMBM__boCallGetNodeState       (NodeStateConsumer      *pConsumer);
+static gboolean NSMBM__boCallGetApplicationMode (NodeStateConsumer      *pConsumer);
+static gboolean NSMBM__boCallGetSessionState    (NodeStateConsumer      *pConsumer);
+static gboolean NSMBM__boCallGetInterfaceVersion(NodeStateConsumer      *pConsumer);
+static guint64  NSMBM__u64GetOwnCpuTimeUs       (void);
+static guint64  NSMBM__u64GetProcessCpuTimeUs   (guint                   u32Pid);
+static guint    NSMBM__u32GetNsmPid             (GDBusConnection        *pBusConnection);
+static gboolean NSMBM__boGetNsmStatistics       (NodeStateConsumer      *pConsumer,
+                                                 gboolean                boReset,
+                                                 const gchar            *sMethodName,
+                                                 guint                  *pu32Calls,
+                                                 guint64                *pu64WallSumNs,
+                                                 guint64                *pu64CpuSumNs);
+static void     NSMBM__vMeasureProbes           (guint                   u32Calls);
+static gint     NSMBM__i32LatencyCompare        (gconstpointer           pLatency1,
+                                                 gconstpointer           pLatency2,
+                                                 gpointer                pUserData);
+static gboolean NSMBM__boMeasure                (const gchar            *sPathName,
+                                                 GDBusConnection        *pConnection,
+                                                 const gchar            *sBusName,
+                                                 const NSMBM__tstMethod *pstMethod,
+                                                 guint                   u32Calls,
+                                                 guint                   u32NsmPid);
+
+
+/**********************************************************************************************************************
+*
+* Local variables
+*
+**********************************************************************************************************************/
+
+/* Table of the methods that can be benchmarked. The first entry is the default. */
+static const NSMBM__tstMethod NSMBM__astMethods[] =
+{
+  {"GetNodeState",        &NSMBM__boCallGetNodeState       },
+  {"GetApplicationMode",  &NSMBM__boCallGetApplicationMode },
+  {"GetSessionState",     &NSMBM__boCallGetSessionState    },
+  {"GetInterfaceVersion", &NSMBM__boCallGetInterfaceVersion}
+};
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function calls "GetNodeState" once.
+*
+* @param pConsumer: Proxy of the Consumer interface
+*
+* @return TRUE: The call succeeded. FALSE: D-Bus error.
+*
+**********************************************************************************************************************/
+static gboolean NSMBM__boCallGetNodeState(NodeStateConsumer *pConsumer)
+{
+  gint i32NodeState   = 0;
+  gint i32ErrorStatus = 0;
+
+  return node_state_consumer_call_get_node_state_sync(pConsumer,
+                                                      &i32NodeState,
+                                                      &i32ErrorStatus,
+                                                      NULL,
+                                                      NULL);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function calls "GetApplicationMode" once.
+*
+* @param pConsumer: Proxy of the Consumer interface
+*
+* @return TRUE: The call succeeded. FALSE: D-Bus error.
+*
+**********************************************************************************************************************/
+static gboolean NSMBM__boCallGetApplicationMode(NodeStateConsumer *pConsumer)
+{
+  gint i32ApplicationMode = 0;
+  gint i32ErrorStatus     = 0;
+
+  return node_state_consumer_call_get_application_mode_sync(pConsumer,
+                                                            &i32ApplicationMode,
+                                                            &i32ErrorStatus,
+                                                            NULL,
+                                                            NULL);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function calls "GetSessionState" once for the default "DiagnosisSession" of seat "Driver".
+*
+* @param pConsumer: Proxy of the Consumer interface
+*
+* @return TRUE: The call succeeded. FALSE: D-Bus error.
+*
+**********************************************************************************************************************/
+static gboolean NSMBM__boCallGetSessionState(NodeStateConsumer *pConsumer)
+{
+  gint i32SessionState = 0;
+  gint i32ErrorStatus  = 0;
+
+  return node_state_consumer_call_get_session_state_sync(pConsumer,
+                                                         "DiagnosisSession",
+                                                         (gint) NsmSeat_Driver,
+                                                         &i32SessionState,
+                                                         &i32ErrorStatus,
+                                                         NULL,
+                                                         NULL);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function calls "GetInterfaceVersion" once.
+*
+* @param pConsumer: Proxy of the Consumer interface
+*
+* @return TRUE: The call succeeded. FALSE: D-Bus error.
+*
+**********************************************************************************************************************/
+static gboolean NSMBM__boCallGetInterfaceVersion(NodeStateConsumer *pConsumer)
+{
+  guint u32Version = 0;
+
+  return node_state_consumer_call_get_interface_version_sync(pConsumer, &u32Version, NULL, NULL);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function returns the CPU time (user + system) consumed by the benchmark process.
+*
+* @return CPU time in us
+*
+**********************************************************************************************************************/
+static guint64 NSMBM__u64GetOwnCpuTimeUs(void)
+{
+  struct rusage stUsage;
+
+  (void) getrusage(RUSAGE_SELF, &stUsage);
+
+  return   ((guint64) stUsage.ru_utime.tv_sec + (guint64) stUsage.ru_stime.tv_sec) * G_USEC_PER_SEC
+         +  (guint64) stUsage.ru_utime.tv_usec + (guint64) stUsage.ru_stime.tv_usec;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function returns the CPU time (user + system) consumed by all threads of a process.
+* The values are read from "/proc/<pid>/stat" (fields "utime" and "stime").
+*
+* @param u32Pid: PID of the process
+*
+* @return CPU time in us. 0, if the process could not be found.
+*
+**********************************************************************************************************************/
+static guint64 NSMBM__u64GetProcessCpuTimeUs(guint u32Pid)
+{
+  /* Function local variables                                       */
+  gchar   *sStatPath   = NULL;
+  gchar   *sStat       = NULL;
+  gchar   *sAfterComm  = NULL; /* Stat line behind the command name */
+  guint64  u64UserTime = 0;    /* Clock ticks in user mode          */
+  guint64  u64SysTime  = 0;    /* Clock ticks in kernel mode        */
+  guint64  u64CpuTime  = 0;    /* Return value                      */
+
+  sStatPath = g_strdup_printf("/proc/%u/stat", u32Pid);
+
+  if(g_file_get_contents(sStatPath, &sStat, NULL, NULL) == TRUE)
+  {
+    /* The command name can contain blanks. The fields are counted behind its closing bracket (field 2) */
+    sAfterComm = strrchr(sStat, ')');
+
+    if(   (sAfterComm != NULL)
+       && (sscanf(sAfterComm + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %" G_GUINT64_FORMAT " %" G_GUINT64_FORMAT,
+                  &u64UserTime, &u64SysTime) == 2))
+    {
+      u64CpuTime = (u64UserTime + u64SysTime) * G_USEC_PER_SEC / (guint64) sysconf(_SC_CLK_TCK);
+    }
+
+    g_free(sStat);
+  }
+
+  g_free(sStatPath);
+
+  return u64CpuTime;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function requests the PID of the NSM from the bus daemon.
+*
+* @param pBusConnection: Connection to the bus daemon
+*
+* @return PID of the NSM. 0, if it could not be determined.
+*
+**********************************************************************************************************************/
+static guint NSMBM__u32GetNsmPid(GDBusConnection *pBusConnection)
+{
+  GVariant *pReply = NULL;
+  guint     u32Pid = 0;
+
+  pReply = g_dbus_connection_call_sync(pBusConnection,
+                                       "org.freedesktop.DBus",
+                                       "/org/freedesktop/DBus",
+                                       "org.freedesktop.DBus",
+                                       "GetConnectionUnixProcessID",
+                                       g_variant_new("(s)", NSM_BUS_NAME),
+                                       G_VARIANT_TYPE("(u)"),
+                                       G_DBUS_CALL_FLAGS_NONE,
+                                       -1,
+                                       NULL,
+                                       NULL);
+  if(pReply != NULL)
+  {
+    g_variant_get(pReply, "(u)", &u32Pid);
+    g_variant_unref(pReply);
+  }
+
+  return u32Pid;
+}
+
+
+
+/**********************************************************************************************************************
+*
+* The function reads the statistics of the NSM ("GetStatistics") and returns the entry of one method.
+*
+* @param pConsumer:     Proxy of the Consumer interface
+* @param boReset:       TRUE, if the NSM should reset its statistics after they have been read
+* @param sMethodName:   Method, whose values should be returned
+* @param pu32Calls:     Number of handled calls
+* @param pu64WallSumNs: Sum of the time spent in the handler in ns
+* @param pu64CpuSumNs:  Sum of the CPU time spent in the handler in ns
+*
+* @return TRUE: The method has been found. FALSE: D-Bus error or the NSM does not know the method.
+*
+**********************************************************************************************************************/
+static gboolean NSMBM__boGetNsmStatistics(NodeStateConsumer *pConsumer,
+                                          gboolean           boReset,
+                                          const gchar       *sMethodName,
+                                          guint             *pu32Calls,
+                                          guint64           *pu64WallSumNs,
+                                          guint64           *pu64CpuSumNs)
+{
+  /* Function local variables                                           */
+  gboolean      boFound        = FALSE; /* Return value                */
+  GVariant     *pStatistics    = NULL;  /* Array of all entries        */
+  GVariantIter  stIter;
+  const gchar  *sName          = NULL;  /* Values of one entry         */
+  guint         u32Calls       = 0;
+  guint64       u64WallSumNs   = 0;
+  guint64       u64WallMaxNs   = 0;
+  guint64       u64CpuSumNs    = 0;
+  gint          i32ErrorStatus = 0;
+
+  if(node_state_consumer_call_get_statistics_sync(pConsumer,
+                                                  boReset,
+                                                  &pStatistics,
+                                                  &i32ErrorStatus,
+                                                  NULL,
+                                                  NULL) == TRUE)
+  {
+    g_variant_iter_init(&stIter, pStatistics);
+
+    while(g_variant_iter_loop(&stIter, "(&sutttau)", &sName, &u32Calls, &u64WallSumNs, &u64WallMaxNs, &u64CpuSumNs, NULL))
+    {
+      if(g_strcmp0(sName, sMethodName) == 0)
+      {
+        boFound        = TRUE;
+        *pu32Calls     = u32Calls;
+        *pu64WallSumNs = u64WallSumNs;
+        *pu64CpuSumNs  = u64CpuSumNs;
+      }
+    }
+
+    g_variant_unref(pStatistics);
+  }
+
+  return boFound;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function measures the cost of the probes, with which the NSM collects its statistics. A probe is started and
+* ended the passed number of times without any work in between. The added time per handled call is printed.
+*
+* @param u32Calls: Number of measured probes
+*
+**********************************************************************************************************************/
+static void NSMBM__vMeasureProbes(guint u32Calls)
+{
+  /* Function local variables                                      */
+  NSMA_tstStatCounter stCounter;       /* Local counter of the probes */
+  NSMA_tstStatProbe   stProbe;
+  guint               u32CallIdx  = 0;
+  gint64              i64Start    = 0; /* Monotonic time in us        */
+  gint64              i64Duration = 0;
+
+  memset(&stCounter, 0, sizeof(stCounter));
+
+  i64Start = g_get_monotonic_time();
+
+  for(u32CallIdx = 0; u32CallIdx < u32Calls; u32CallIdx++)
+  {
+    NSMA_vStatProbeBegin(&stProbe);
+    (void) NSMA_u64StatProbeEnd(&stProbe, &stCounter);
+  }
+
+  i64Duration = g_get_monotonic_time() - i64Start;
+
+  printf("Path:              local\n");
+  printf("Method:            statistics probe\n");
+  printf("Probes:            %u\n",     u32Calls);
+  printf("Overhead/call:     %.3f us\n\n", (gdouble) i64Duration / u32Calls);
+}
+
+
+/**********************************************************************************************************************
+*
+* Compare function to sort the measured latencies.
+*
+* @param pLatency1: First latency (gint64)
+* @param pLatency2: Second latency (gint64)
+* @param pUserData: Optionally user data (not used)
+*
+* @return <0, 0 or >0, if the first latency is shorter, equal or longer than the second one.
+*
+**********************************************************************************************************************/
+static gint NSMBM__i32LatencyCompare(gconstpointer pLatency1, gconstpointer pLatency2, gpointer pUserData)
+{
+  return   (*(const gint64*) pLatency1 > *(const gint64*) pLatency2)
+         - (*(const gint64*) pLatency1 < *(const gint64*) pLatency2);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function measures the calls of a method via one connection and prints the results. The calls per second,
+* the median and 99th percentile of the round trip latency and the CPU time per call of client and NSM are printed.
+*
+* @param sPathName:   Name of the measured path for the output ("bus" or "direct")
+* @param pConnection: Bus or peer-to-peer connection
+* @param sBusName:    Bus name of the NSM. NULL for a peer-to-peer connection.
+* @param pstMethod:   Method that is called
+* @param u32Calls:    Number of measured calls
+* @param u32NsmPid:   PID of the NSM to measure its CPU time. 0 if unknown.
+*
+* @return TRUE: All calls succeeded. FALSE: Error.
+*
+**********************************************************************************************************************/
+static gboolean NSMBM__boMeasure(const gchar            *sPathName,
+                                 GDBusConnection        *pConnection,
+                                 const gchar            *sBusName,
+                                 const NSMBM__tstMethod *pstMethod,
+                                 guint                   u32Calls,
+                                 guint                   u32NsmPid)
+{
+  /* Function local variables                                                      */
+  NodeStateConsumer *pConsumer      = NULL;
+  gboolean           boCallsOk      = FALSE; /* Return value                      */
+  guint              u32CallIdx     = 0;
+  gint64            *ai64Latency    = NULL;  /* Round trip time of every call     */
+  gint64             i64CallStart   = 0;     /* Monotonic time in us              */
+  gint64             i64Duration    = 0;     /* Duration of the measured calls    */
+  guint64            u64OwnCpuStart = 0;     /* CPU time of the benchmark in us   */
+  guint64            u64OwnCpu      = 0;
+  guint64            u64NsmCpuStart = 0;     /* CPU time of the NSM in us         */
+  guint64            u64NsmCpu      = 0;
+  guint              u32NsmCalls    = 0;     /* Statistics reported by the NSM    */
+  guint64            u64NsmWallNs   = 0;
+  guint64            u64NsmCpuNs    = 0;
+  gboolean           boNsmStatsOk   = FALSE;
+  GError            *pError         = NULL;
+
+  pConsumer = node_state_consumer_proxy_new_sync(pConnection,
+                                                   G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES
+                                                 | G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
+                                                 sBusName,
+                                                 NSM_CONSUMER_OBJECT,
+                                                 NULL,
+                                                 &pError);
+  if(pError == NULL)
+  {
+    ai64Latency = g_new0(gint64, u32Calls);
+    boCallsOk   = TRUE;
+
+    for(u32CallIdx = 0; (u32CallIdx < NSMBM__WARMUP_CALLS) && (boCallsOk == TRUE); u32CallIdx++)
+    {
+      boCallsOk = pstMethod->pfCall(pConsumer);
+    }
+
+    /* Reset the statistics of the NSM. Like this, they only contain the measured calls. */
+    (void) NSMBM__boGetNsmStatistics(pConsumer, TRUE, pstMethod->sMethodName, &u32NsmCalls, &u64NsmWallNs, &u64NsmCpuNs);
+
+    u64NsmCpuStart = NSMBM__u64GetProcessCpuTimeUs(u32NsmPid);
+    u64OwnCpuStart = NSMBM__u64GetOwnCpuTimeUs();
+
+    for(u32CallIdx = 0; (u32CallIdx < u32Calls) && (boCallsOk == TRUE); u32CallIdx++)
+    {
+      i64CallStart             = g_get_monotonic_time();
+      boCallsOk                = pstMethod->pfCall(pConsumer);
+      ai64Latency[u32CallIdx]  = g_get_monotonic_time() - i64CallStart;
+      i64Duration             += ai64Latency[u32CallIdx];
+    }
+
+    u64OwnCpu = NSMBM__u64GetOwnCpuTimeUs() - u64OwnCpuStart;
+    u64NsmCpu = NSMBM__u64GetProcessCpuTimeUs(u32NsmPid) - u64NsmCpuStart;
+
+    boNsmStatsOk = NSMBM__boGetNsmStatistics(pConsumer,
+                                             FALSE,
+                                             pstMethod->sMethodName,
+                                             &u32NsmCalls,
+                                             &u64NsmWallNs,
+                                             &u64NsmCpuNs);
+
+    if((boCallsOk == TRUE) && (i64Duration > 0))
+    {
+      g_qsort_with_data(ai64Latency, (gint) u32Calls, sizeof(gint64), &NSMBM__i32LatencyCompare, NULL);
+
+      printf("Path:              %s\n",         sPathName);
+      printf("Method:            %s\n",         pstMethod->sMethodName);
+      printf("Calls:             %u\n",         u32Calls);
+      printf("Duration:          %.3f s\n",     (gdouble) i64Duration / G_USEC_PER_SEC);
+      printf("Calls/s:           %.0f\n",       (gdouble) u32Calls * G_USEC_PER_SEC / (gdouble) i64Duration);
+      printf("Latency p50/p99:   %" G_GINT64_FORMAT " / %" G_GINT64_FORMAT " us\n",
+             ai64Latency[u32Calls / 2],
+             ai64Latency[(u32Calls * 99) / 100]);
+      printf("Client CPU/call:   %.1f us\n",    (gdouble) u64OwnCpu / u32Calls);
+
+      if(u32NsmPid != 0)
+      {
+        printf("NSM CPU/call:      %.1f us (pid %u)\n", (gdouble) u64NsmCpu / u32Calls, u32NsmPid);
+      }
+      else
+      {
+        printf("NSM CPU/call:      unknown (pid of %s not available)\n", NSM_BUS_NAME);
+      }
+
+      if((boNsmStatsOk == TRUE) && (u32NsmCalls != 0))
+      {
+        printf("NSM handler/call:  %.1f us, CPU %.1f us (%u calls)\n",
+               (gdouble) u64NsmWallNs / (1000.0 * u32NsmCalls),
+               (gdouble) u64NsmCpuNs  / (1000.0 * u32NsmCalls),
+               u32NsmCalls);
+      }
+
+      printf("\n");
+    }
+    else
+    {
+      boCallsOk = FALSE;
+      printf("Error: Call %u of %s via %s failed.\n", u32CallIdx, pstMethod->sMethodName, sPathName);
+    }
+
+    g_free(ai64Latency);
+    g_object_unref(pConsumer);
+  }
+  else
+  {
+    printf("Error: Failed to create proxy via %s. Error msg.: %s.\n", sPathName, pError->message);
+    g_error_free(pError);
+  }
+
+  return boCallsOk;
+}
+
+
+/**********************************************************************************************************************
+*
+* Main function of the benchmark executable.
+*
+* @return:  0: All calls succeeded and the results have been printed
+*          -1: Invalid arguments, no connection to the NSM or a failed call
+*
+**********************************************************************************************************************/
+int main(int argc, char **argv)
+{
+  /* Function local variables                                                          */
+  int                     iRetVal         = -1;
+  guint                   u32Calls        = NSMBM__DEFAULT_CALLS;
+  const NSMBM__tstMethod *pstMethod       = &NSMBM__astMethods[0];
+  guint                   u32MethodIdx    = 0;
+  guint                   u32NsmPid       = 0;
+  GDBusConnection        *pBusConnection  = NULL; /* Connection to the bus daemon      */
+  GDBusConnection        *pPeerConnection = NULL; /* Direct connection to the NSM      */
+  GError                 *pError          = NULL;
+
+  /* Initialize types in order to use glib */
+  g_type_init();
+
+  if(argc > 1)
+  {
+    u32Calls = (guint) strtoul(argv[1], NULL, 10);
+  }
+
+  if(argc > 2)
+  {
+    pstMethod = NULL;
+
+    for(u32MethodIdx = 0; u32MethodIdx < G_N_ELEMENTS(NSMBM__astMethods); u32MethodIdx++)
+    {
+      if(g_strcmp0(argv[2], NSMBM__astMethods[u32MethodIdx].sMethodName) == 0)
+      {
+        pstMethod = &NSMBM__astMethods[u32MethodIdx];
+      }
+    }
+  }
+
+  if((u32Calls != 0) && (pstMethod != NULL))
+  {
+    pBusConnection = g_bus_get_sync(NSM_BUS_TYPE, NULL, &pError);
+
+    if(pError == NULL)
+    {
+      u32NsmPid = NSMBM__u32GetNsmPid(pBusConnection);
+
+      NSMBM__vMeasureProbes(u32Calls);
+
+      if(NSMBM__boMeasure("bus", pBusConnection, NSM_BUS_NAME, pstMethod, u32Calls, u32NsmPid) == TRUE)
+      {
+        iRetVal = 0;
+      }
+
+      if(argc > 3)
+      {
+        pPeerConnection = g_dbus_connection_new_for_address_sync(argv[3],
+                                                                 G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT,
+                                                                 NULL,
+                                                                 NULL,
+                                                                 &pError);
+        if(pError == NULL)
+        {
+          if(NSMBM__boMeasure("direct", pPeerConnection, NULL, pstMethod, u32Calls, u32NsmPid) != TRUE)
+          {
+            iRetVal = -1;
+          }
+
+          g_object_unref(pPeerConnection);
+        }
+        else
+        {
+          iRetVal = -1;
+          printf("Error: Failed to connect to %s. Error msg.: %s.\n", argv[3], pError->message);
+          g_error_free(pError);
+        }
+      }
+
+      g_object_unref(pBusConnection);
+    }
+    else
+    {
+      printf("Error: Failed to get bus connection. Error msg.: %s.\n", pError->message);
+      g_error_free(pError);
+    }
+  }
+  else
+  {
+    printf("Usage: %s [Calls] [GetNodeState|GetApplicationMode|GetSessionState|GetInterfaceVersion] [Address]\n",
+           argv[0]);
+  }
+
+  return iRetVal;
+}
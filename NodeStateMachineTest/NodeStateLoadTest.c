@@ -0,0 +1,411 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the NodeStateLoadTest.
+*
+* The file implements a load test for the prioritized dispatch of the NodeStateManager. The test registers lifecycle
+* clients for a seat and measures, how long the NSM needs to shut down the seat (time from "RequestSeatLifecycle"
+* until the last client has been called). The shutdown is measured once without load and once, while threads flood
+* the NSM with "SetSessionState" calls via own connections. Lifecycle traffic is dispatched by the NSM before session
+* traffic. Therefore, the shutdown time must stay stable under load. The test fails, if the mean shutdown time under
+* load exceeds NSMLT__MAX_SLOWDOWN times the mean without load (plus NSMLT__SLACK_US for timer granularity).
+*
+* The measurement is only meaningful, if the NSM really handled the load. The test also fails, if less than
+* NSMLT__MIN_LOAD_RATE load calls per second have been admitted or if more load calls have been rejected than
+* admitted. Therefore, the NSM has to be started without NSM_RATE_LIMIT.
+*
+* Usage: NodeStateLoadTest [Sequences] [Clients] [Threads]
+*
+* Sequences: Number of measured shutdowns per phase (default NSMLT__DEFAULT_SEQUENCES)
+* Clients:   Number of lifecycle clients registered for the seat (default NSMLT__DEFAULT_CLIENTS)
+* Threads:   Number of threads calling "SetSessionState" during the loaded phase (default NSMLT__DEFAULT_THREADS)
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+/* System header files                                                                          */
+#include <gio/gio.h>                    /* Use glib to access dbus and communicate to NSM       */
+#include <stdio.h>                      /* printf                                               */
+#include <stdlib.h>                     /* strtoul                                              */
+
+/* Header files offered by NSM                                                                  */
+#include "NodeStateTypes.h"             /* Know type definitions of NSM                         */
+
+/* Generated header files to access NSM via D-Bus                                               */
+#include "NodeStateConsumer.h"          /* Consumer interface with publicly available functions */
+#include "NodeStateLifecycleControl.h"  /* Control  interface to request the seat lifecycle     */
+#include "NodeStateLifecycleConsumer.h" /* Consumer interface to offer life cycle clients       */
+
+/* Own header files                                                                             */
+#include "NodeStateTestFixture.h"       /* Clients, registration and seat requests of the test  */
+
+
+/**********************************************************************************************************************
+*
+* Local defines, macros and type definitions.
+*
+**********************************************************************************************************************/
+
+/* Default values, if not passed on the command line */
+#define NSMLT__DEFAULT_SEQUENCES 20
+#define NSMLT__DEFAULT_CLIENTS   10
+#define NSMLT__DEFAULT_THREADS   4
+
+/* Seat, session and objects used by the test */
+#define NSMLT__SEAT              NsmSeat_Rear3
+#define NSMLT__SESSION_NAME      "NodeStateLoadTest"
+#define NSMLT__SESSION_OWNER     "NodeStateLoadTest"
+#define NSMLT__CLIENT_OBJECT     "/org/genivi/NodeStateLoadTest/Client%u"
+
+/* Timeout of the clients registered at the NSM */
+#define NSMLT__CLIENT_TIMEOUT_MS 1000
+
+/* Max. allowed ratio of the mean shutdown time with and without load, and absolute slack for small times */
+#define NSMLT__MAX_SLOWDOWN      2.0
+#define NSMLT__SLACK_US          1000
+
+/* Min. number of admitted "SetSessionState" calls per second, so that the loaded phase really loaded the NSM */
+#define NSMLT__MIN_LOAD_RATE     1000.0
+
+/* The type defines a thread, which loads the NSM with session traffic */
+typedef struct
+{
+  GThread *pThread;     /* Thread calling "SetSessionState" */
+  guint    u32Calls;    /* Number of successful calls       */
+  guint    u32Rejected; /* Number of calls that failed      */
+} NSMLT__tstLoadThread;
+
+/* The type defines the result of one measured phase */
+typedef struct
+{
+  gint64 i64MinUs;  /* Shortest shutdown of the seat */
+  gint64 i64MaxUs;  /* Longest  shutdown of the seat */
+  gint64 i64MeanUs; /* Mean     shutdown of the seat */
+} NSMLT__tstPhase;
+
+
+/**********************************************************************************************************************
+*
+* Prototypes for file local functions (see implementation for description)
+*
+**********************************************************************************************************************/
+
+static gboolean NSMLT__boMeasurePhase       (NodeStateLifecycleControl  *pLifecycleControl,
+                                             NSMLT__tstPhase            *pstPhase);
+static gpointer NSMLT__pvLoadThread         (gpointer                    pUserData);
+static gboolean NSMLT__boRunTest            (NSMTF_tstFixture           *pstFixture);
+
+
+/**********************************************************************************************************************
+*
+* Local variables
+*
+**********************************************************************************************************************/
+
+static guint             NSMLT__u32Sequences    = NSMLT__DEFAULT_SEQUENCES;
+static guint             NSMLT__u32Threads      = NSMLT__DEFAULT_THREADS;
+
+/* Session and lifecycle clients of the test seat */
+static NSMTF_tstFixture  NSMLT__stFixture       = {NSMLT__SEAT,
+                                                   NSMLT__SESSION_NAME,
+                                                   NSMLT__SESSION_OWNER,
+                                                   NSMLT__CLIENT_OBJECT,
+                                                   NSMLT__DEFAULT_CLIENTS,
+                                                   NSMLT__CLIENT_TIMEOUT_MS,
+                                                   NULL, NULL, NULL, 0};
+
+/* Set to stop the load threads */
+static volatile gint     NSMLT__i32StopLoad     = 0;
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function shuts down and runs up the test seat NSMLT__u32Sequences times. Only the shutdowns are measured.
+*
+* @param pLifecycleControl: Proxy of the LifecycleControl interface
+* @param pstPhase:          Returns min., max. and mean shutdown time
+*
+* @return TRUE: All sequences succeeded. FALSE: Error.
+*
+**********************************************************************************************************************/
+static gboolean NSMLT__boMeasurePhase(NodeStateLifecycleControl *pLifecycleControl, NSMLT__tstPhase *pstPhase)
+{
+  /* Function local variables                          */
+  gboolean boRetVal    = TRUE;
+  guint    u32SeqIdx   = 0;
+  gint64   i64Duration = 0;
+  gint64   i64SumUs    = 0;
+
+  pstPhase->i64MinUs  = G_MAXINT64;
+  pstPhase->i64MaxUs  = 0;
+  pstPhase->i64MeanUs = 0;
+
+  for(u32SeqIdx = 0; (u32SeqIdx < NSMLT__u32Sequences) && (boRetVal == TRUE); u32SeqIdx++)
+  {
+    boRetVal =    (NSMTF_boRequestSeat(&NSMLT__stFixture, pLifecycleControl, NSM_SHUTDOWNTYPE_NORMAL, &i64Duration) == TRUE)
+               && (NSMTF_boRequestSeat(&NSMLT__stFixture, pLifecycleControl, NSM_SHUTDOWNTYPE_RUNUP,  NULL        ) == TRUE);
+
+    pstPhase->i64MinUs  = MIN(pstPhase->i64MinUs, i64Duration);
+    pstPhase->i64MaxUs  = MAX(pstPhase->i64MaxUs, i64Duration);
+    i64SumUs           += i64Duration;
+  }
+
+  if((boRetVal == TRUE) && (NSMLT__u32Sequences != 0))
+  {
+    pstPhase->i64MeanUs = i64SumUs / NSMLT__u32Sequences;
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is the body of a load thread. The thread opens an own connection, so that the NSM accounts it as
+* separate client, and toggles the state of the test session, until NSMLT__i32StopLoad is set.
+*
+* @param pUserData: Load thread (NSMLT__tstLoadThread)
+*
+* @return NULL
+*
+**********************************************************************************************************************/
+static gpointer NSMLT__pvLoadThread(gpointer pUserData)
+{
+  /* Function local variables                                                   */
+  NSMLT__tstLoadThread *pstLoad       = (NSMLT__tstLoadThread*) pUserData;
+  GDBusConnection      *pConnection   = NULL;
+  NodeStateConsumer    *pConsumer     = NULL;
+  gchar                *sAddress      = NULL;
+  NsmErrorStatus_e      enErrorStatus = NsmErrorStatus_NotSet;
+  NsmSessionState_e     enState       = NsmSessionState_Active;
+  GError               *pError        = NULL;
+
+  sAddress = g_dbus_address_get_for_bus_sync(NSM_BUS_TYPE, NULL, &pError);
+
+  if(pError == NULL)
+  {
+    pConnection = g_dbus_connection_new_for_address_sync(sAddress,
+                                                           G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT
+                                                         | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+                                                         NULL,
+                                                         NULL,
+                                                         &pError);
+    g_free(sAddress);
+  }
+
+  if(pError == NULL)
+  {
+    pConsumer = node_state_consumer_proxy_new_sync(pConnection,
+                                                     G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES
+                                                   | G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
+                                                   NSM_BUS_NAME,
+                                                   NSM_CONSUMER_OBJECT,
+                                                   NULL,
+                                                   &pError);
+  }
+
+  if(pError == NULL)
+  {
+    while(g_atomic_int_get(&NSMLT__i32StopLoad) == 0)
+    {
+      enState = (enState == NsmSessionState_Active) ? NsmSessionState_Inactive : NsmSessionState_Active;
+
+      (void) node_state_consumer_call_set_session_state_sync(pConsumer,
+                                                             NSMLT__SESSION_NAME,
+                                                             NSMLT__SESSION_OWNER,
+                                                             (gint) NSMLT__SEAT,
+                                                             (gint) enState,
+                                                             (gint*) &enErrorStatus,
+                                                             NULL,
+                                                             &pError);
+      if(pError == NULL)
+      {
+        pstLoad->u32Calls++;
+      }
+      else
+      {
+        /* The call has been rejected, e.g. by the rate limit of the NSM */
+        pstLoad->u32Rejected++;
+        g_error_free(pError);
+        pError = NULL;
+      }
+    }
+
+    g_object_unref(pConsumer);
+  }
+  else
+  {
+    printf("Error: Load thread failed to connect to NSM. Error msg.: %s.\n", pError->message);
+    g_error_free(pError);
+  }
+
+  if(pConnection != NULL)
+  {
+    g_object_unref(pConnection);
+  }
+
+  return NULL;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function runs the test. It is called by NSMTF_boRun in an own thread, while the main loop dispatches the
+* lifecycle requests to the clients.
+*
+* @param pstFixture: Fixture of the test
+*
+* @return TRUE: The shutdown time stayed stable under load. FALSE: Error or the shutdown slowed down.
+*
+**********************************************************************************************************************/
+static gboolean NSMLT__boRunTest(NSMTF_tstFixture *pstFixture)
+{
+  /* Function local variables                                                      */
+  NodeStateConsumer         *pConsumer         = NULL;
+  NodeStateLifecycleControl *pLifecycleControl = NULL;
+  NSMLT__tstLoadThread      *astLoad           = NULL;
+  NSMLT__tstPhase            stIdle;                    /* Phase without load */
+  NSMLT__tstPhase            stLoaded;                  /* Phase with    load */
+  guint                      u32ThreadIdx      = 0;
+  guint                      u32LoadCalls      = 0;
+  guint                      u32LoadRejected   = 0;
+  gint64                     i64LoadStart      = 0;
+  gint64                     i64LoadDuration   = 0;
+  gdouble                    dLoadRate         = 0.0;  /* Admitted calls/s */
+  gboolean                   boLoaded          = FALSE;
+  gboolean                   boMeasured        = FALSE;
+  gboolean                   boPassed          = FALSE;
+
+  if(   (NSMTF_boCreateProxies(pstFixture, &pConsumer, &pLifecycleControl) == TRUE)
+     && (NSMTF_boRegister(pstFixture, pConsumer)                          == TRUE))
+  {
+    boMeasured = NSMLT__boMeasurePhase(pLifecycleControl, &stIdle);
+
+    /* Start the load and measure again */
+    astLoad = g_new0(NSMLT__tstLoadThread, NSMLT__u32Threads);
+    g_atomic_int_set(&NSMLT__i32StopLoad, 0);
+    i64LoadStart = g_get_monotonic_time();
+
+    for(u32ThreadIdx = 0; u32ThreadIdx < NSMLT__u32Threads; u32ThreadIdx++)
+    {
+      astLoad[u32ThreadIdx].pThread = g_thread_create(&NSMLT__pvLoadThread, &astLoad[u32ThreadIdx], TRUE, NULL);
+    }
+
+    boMeasured = (boMeasured == TRUE) && (NSMLT__boMeasurePhase(pLifecycleControl, &stLoaded) == TRUE);
+
+    g_atomic_int_set(&NSMLT__i32StopLoad, 1);
+
+    for(u32ThreadIdx = 0; u32ThreadIdx < NSMLT__u32Threads; u32ThreadIdx++)
+    {
+      if(astLoad[u32ThreadIdx].pThread != NULL)
+      {
+        (void) g_thread_join(astLoad[u32ThreadIdx].pThread);
+      }
+
+      u32LoadCalls    += astLoad[u32ThreadIdx].u32Calls;
+      u32LoadRejected += astLoad[u32ThreadIdx].u32Rejected;
+    }
+
+    i64LoadDuration = g_get_monotonic_time() - i64LoadStart;
+    dLoadRate       = (i64LoadDuration > 0) ? ((gdouble) u32LoadCalls * G_USEC_PER_SEC / (gdouble) i64LoadDuration) : 0.0;
+    boLoaded        = (dLoadRate >= NSMLT__MIN_LOAD_RATE) && (u32LoadRejected <= u32LoadCalls);
+    g_free(astLoad);
+
+    if(boMeasured == TRUE)
+    {
+      boPassed =    (boLoaded == TRUE)
+                 && (stLoaded.i64MeanUs <= (gint64) (stIdle.i64MeanUs * NSMLT__MAX_SLOWDOWN) + NSMLT__SLACK_US);
+
+      printf("Clients:           %u\n", pstFixture->u32Clients);
+      printf("Sequences:         %u\n", NSMLT__u32Sequences);
+      printf("Shutdown idle:     min %" G_GINT64_FORMAT " / mean %" G_GINT64_FORMAT " / max %" G_GINT64_FORMAT " us\n",
+             stIdle.i64MinUs, stIdle.i64MeanUs, stIdle.i64MaxUs);
+      printf("Shutdown loaded:   min %" G_GINT64_FORMAT " / mean %" G_GINT64_FORMAT " / max %" G_GINT64_FORMAT " us\n",
+             stLoaded.i64MinUs, stLoaded.i64MeanUs, stLoaded.i64MaxUs);
+      printf("Load:              %u threads, %.0f SetSessionState/s, %u rejected\n",
+             NSMLT__u32Threads, dLoadRate, u32LoadRejected);
+
+      if(boLoaded == FALSE)
+      {
+        printf("Result:            failed (load not admitted. Is NSM_RATE_LIMIT set?)\n");
+      }
+      else
+      {
+        printf("Result:            %s\n", (boPassed == TRUE) ? "passed" : "failed (shutdown slowed down by load)");
+      }
+    }
+    else
+    {
+      printf("Error: The seat lifecycle sequence did not complete.\n");
+    }
+
+    NSMTF_vUnRegister(pstFixture, pConsumer);
+  }
+
+  NSMTF_vFreeProxies(&pConsumer, &pLifecycleControl);
+
+  return boPassed;
+}
+
+
+/**********************************************************************************************************************
+*
+* Main function of the load test executable.
+*
+* @return:  0: The shutdown time stayed stable under load
+*          -1: Invalid arguments, no connection to the NSM or the shutdown slowed down under load
+*
+**********************************************************************************************************************/
+int main(int argc, char **argv)
+{
+  /* Function local variables                    */
+  int iRetVal = -1;
+
+  /* Initialize types in order to use glib */
+  g_type_init();
+
+  if(argc > 1)
+  {
+    NSMLT__u32Sequences = (guint) strtoul(argv[1], NULL, 10);
+  }
+
+  if(argc > 2)
+  {
+    NSMLT__stFixture.u32Clients = (guint) strtoul(argv[2], NULL, 10);
+  }
+
+  if(argc > 3)
+  {
+    NSMLT__u32Threads = (guint) strtoul(argv[3], NULL, 10);
+  }
+
+  if((NSMLT__u32Sequences != 0) && (NSMLT__stFixture.u32Clients != 0))
+  {
+    iRetVal = (NSMTF_boRun(&NSMLT__stFixture, &NSMLT__boRunTest) == TRUE) ? 0 : -1;
+  }
+  else
+  {
+    printf("Usage: %s [Sequences] [Clients] [Threads]\n", argv[0]);
+  }
+
+  return iRetVal;
+}
@@ -32,10 +32,12 @@
 **********************************************************************************************************************/
 
 #include <gio/gio.h>                 /* Access dbus using glib          */
+#include <string.h>                  /* memset                          */
 
 #include "NodeStateMachine.h"    /* Own header file                 */
 #include "NodeStateTypes.h"          /* Know the types of the NSM       */
 #include "NodeStateManager.h"	     /* Access inhternal NSM interfaces */
+#include "NodeStateMachinePlugin.h"  /* Loadable as NSMC plugin         */
 
 #include "NodeStateMachineTestApi.h" /* Dbus interface offered by NSMC  */
 
@@ -57,6 +59,11 @@
 
 static NodeStateTest   *TSTMSC__pTestMachine = NULL;
 static GDBusConnection *TSTMSC__pConnection  = NULL;
+static guint            TSTMSC__u32DelayMs   = 0;    /* Artificial delay of NsmcSetData to simulate a slow NSMC */
+static volatile guint   TSTMSC__u32SessionCalls = 0; /* Calls of the session subscription                     */
+
+/* The test NSMC can also be loaded via NSM_NSMC_PLUGIN */
+NSMC_PLUGIN_EXPORT("NodeStateMachineTest", NULL);
 
 
 /**********************************************************************************************************************
@@ -83,6 +90,31 @@ static gboolean NSM__boOnHandleGetNsmInterfaceVersion(NodeStateTest         *pTe
                                                       GDBusMethodInvocation *pInvocation,
                                                       gpointer               pUserData);
 
+static gboolean NSM__boOnHandleSetNsmcDelay(NodeStateTest         *pTestMachine,
+                                            GDBusMethodInvocation *pInvocation,
+                                            const guint            u32DelayMs,
+                                            gpointer               pUserData);
+
+static gboolean NSM__boOnHandleSetNsmDataBatch(NodeStateTest         *pTestMachine,
+                                               GDBusMethodInvocation *pInvocation,
+                                               const gint             i32ShutdownReason,
+                                               const gint             i32BootMode,
+                                               const gint             i32ApplicationMode,
+                                               gpointer               pUserData);
+
+static gboolean NSM__boOnHandleSubscribeSession(NodeStateTest         *pTestMachine,
+                                                GDBusMethodInvocation *pInvocation,
+                                                const gchar           *sSessionName,
+                                                const gint             i32SeatId,
+                                                gpointer               pUserData);
+
+static gboolean NSM__boOnHandleUnsubscribeSession(NodeStateTest         *pTestMachine,
+                                                  GDBusMethodInvocation *pInvocation,
+                                                  const gint             i32Handle,
+                                                  gpointer               pUserData);
+
+static void TSTMSC__vOnSessionChanged(const NsmSession_s *pstSession, void *pUserData);
+
 /**********************************************************************************************************************
 *
 * Local (static) functions
@@ -233,6 +265,162 @@ static gboolean NSM__boOnHandleGetNsmInterfaceVersion(NodeStateTest         *pTe
   return TRUE;
 }
 
+/**********************************************************************************************************************
+*
+* The function is called when the test frame wants to simulate a slow NSMC.
+* Every following call of NsmcSetData will be delayed by the passed time.
+*
+* @param pTestMachine: Pointer to NodeStateTest object
+* @param pInvocation:  Pointer to method invocation object
+* @param u32DelayMs:   Delay in ms for NsmcSetData. 0 disables the delay.
+* @param pUserData:    Optionally user data (not used)
+*
+* @return TRUE:  Tell D-Bus that method succeeded.
+*
+**********************************************************************************************************************/
+static gboolean NSM__boOnHandleSetNsmcDelay(NodeStateTest         *pTestMachine,
+                                            GDBusMethodInvocation *pInvocation,
+                                            const guint            u32DelayMs,
+                                            gpointer               pUserData)
+{
+  TSTMSC__u32DelayMs = u32DelayMs;
+
+  node_state_test_complete_set_nsmc_delay(pTestMachine, pInvocation);
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called when a test frame wants to set the ShutdownReason, BootMode and ApplicationMode in one batch.
+* Afterwards, ShutdownReason and BootMode are read back from one snapshot.
+*
+* @param pTestMachine:       Pointer to NodeStateTest object
+* @param pInvocation:        Pointer to method invocation object
+* @param i32ShutdownReason:  ShutdownReason to set
+* @param i32BootMode:        BootMode to set
+* @param i32ApplicationMode: ApplicationMode to set
+* @param pUserData:          Optionally user data (not used)
+*
+* @return TRUE:  Tell D-Bus that method succeeded.
+*
+**********************************************************************************************************************/
+static gboolean NSM__boOnHandleSetNsmDataBatch(NodeStateTest         *pTestMachine,
+                                               GDBusMethodInvocation *pInvocation,
+                                               const gint             i32ShutdownReason,
+                                               const gint             i32BootMode,
+                                               const gint             i32ApplicationMode,
+                                               gpointer               pUserData)
+{
+  /* Function local variables                                                 */
+  NsmShutdownReason_e  enShutdownReason    = (NsmShutdownReason_e)  i32ShutdownReason;
+  gint                 i32NewBootMode      = i32BootMode;
+  NsmApplicationMode_e enApplicationMode   = (NsmApplicationMode_e) i32ApplicationMode;
+  NsmShutdownReason_e  enShutdownReasonOut = NsmShutdownReason_NotSet;
+  gint                 i32BootModeOut      = 0;
+  NsmErrorStatus_e     enRetVal            = NsmErrorStatus_NotSet;
+
+  NsmDataEntry_s astSet[] =
+  {
+    {NsmDataType_AppMode,        (unsigned char*) &enApplicationMode, sizeof(enApplicationMode), 0},
+    {NsmDataType_ShutdownReason, (unsigned char*) &enShutdownReason,  sizeof(enShutdownReason),  0},
+    {NsmDataType_BootMode,       (unsigned char*) &i32NewBootMode,    sizeof(i32NewBootMode),    0}
+  };
+
+  NsmDataEntry_s astGet[] =
+  {
+    {NsmDataType_ShutdownReason, (unsigned char*) &enShutdownReasonOut, sizeof(enShutdownReasonOut), 0},
+    {NsmDataType_BootMode,       (unsigned char*) &i32BootModeOut,      sizeof(i32BootModeOut),      0}
+  };
+
+  enRetVal = NsmSetDataBatch(astSet, sizeof(astSet) / sizeof(NsmDataEntry_s));
+  (void) NsmGetDataMulti(astGet, sizeof(astGet) / sizeof(NsmDataEntry_s));
+
+  node_state_test_complete_set_nsm_data_batch(pTestMachine,
+                                              pInvocation,
+                                              (gint) enShutdownReasonOut,
+                                              i32BootModeOut,
+                                              (gint) enRetVal);
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called by the NSM for state changes of the subscribed session. It counts the calls.
+*
+* @param pstSession: Changed session
+* @param pUserData:  Optionally user data (not used)
+*
+**********************************************************************************************************************/
+static void TSTMSC__vOnSessionChanged(const NsmSession_s *pstSession, void *pUserData)
+{
+  g_atomic_int_inc((volatile gint*) &TSTMSC__u32SessionCalls);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called when a test frame wants the NSMC to subscribe for the state changes of a session.
+*
+* @param pTestMachine: Pointer to NodeStateTest object
+* @param pInvocation:  Pointer to method invocation object
+* @param sSessionName: Name of the session
+* @param i32SeatId:    Seat of the session
+* @param pUserData:    Optionally user data (not used)
+*
+* @return TRUE:  Tell D-Bus that method succeeded.
+*
+**********************************************************************************************************************/
+static gboolean NSM__boOnHandleSubscribeSession(NodeStateTest         *pTestMachine,
+                                                GDBusMethodInvocation *pInvocation,
+                                                const gchar           *sSessionName,
+                                                const gint             i32SeatId,
+                                                gpointer               pUserData)
+{
+  NsmSubscription_s stSubscription;
+
+  memset(&stSubscription, 0, sizeof(stSubscription));
+  g_strlcpy(stSubscription.sSessionName, sSessionName, sizeof(stSubscription.sSessionName));
+  stSubscription.u32SeatMask       = NSM_SEAT_MASK(i32SeatId);
+  stSubscription.pfSessionCallback = &TSTMSC__vOnSessionChanged;
+
+  g_atomic_int_set((volatile gint*) &TSTMSC__u32SessionCalls, 0);
+
+  node_state_test_complete_subscribe_session(pTestMachine, pInvocation, NsmSubscribe(&stSubscription));
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called when a test frame wants the NSMC to remove its session subscription.
+*
+* @param pTestMachine: Pointer to NodeStateTest object
+* @param pInvocation:  Pointer to method invocation object
+* @param i32Handle:    Handle of the subscription
+* @param pUserData:    Optionally user data (not used)
+*
+* @return TRUE:  Tell D-Bus that method succeeded. The number of session callbacks is returned.
+*
+**********************************************************************************************************************/
+static gboolean NSM__boOnHandleUnsubscribeSession(NodeStateTest         *pTestMachine,
+                                                  GDBusMethodInvocation *pInvocation,
+                                                  const gint             i32Handle,
+                                                  gpointer               pUserData)
+{
+  (void) NsmUnsubscribe(i32Handle);
+
+  node_state_test_complete_unsubscribe_session(pTestMachine,
+                                               pInvocation,
+                                               (guint) g_atomic_int_get((volatile gint*) &TSTMSC__u32SessionCalls));
+
+  return TRUE;
+}
+
 
 /**********************************************************************************************************************
 *
@@ -256,6 +444,10 @@ unsigned char NsmcInit(void)
     (void) g_signal_connect(TSTMSC__pTestMachine, "handle-set-nsm-data",              G_CALLBACK(NSM__boOnHandleSetNsmData),             NULL);
     (void) g_signal_connect(TSTMSC__pTestMachine, "handle-get-nsm-data",              G_CALLBACK(NSM__boOnHandleGetNsmData),             NULL);
     (void) g_signal_connect(TSTMSC__pTestMachine, "handle-get-nsm-interface-version", G_CALLBACK(NSM__boOnHandleGetNsmInterfaceVersion), NULL);
+    (void) g_signal_connect(TSTMSC__pTestMachine, "handle-set-nsmc-delay",            G_CALLBACK(NSM__boOnHandleSetNsmcDelay),           NULL);
+    (void) g_signal_connect(TSTMSC__pTestMachine, "handle-set-nsm-data-batch",        G_CALLBACK(NSM__boOnHandleSetNsmDataBatch),        NULL);
+    (void) g_signal_connect(TSTMSC__pTestMachine, "handle-subscribe-session",         G_CALLBACK(NSM__boOnHandleSubscribeSession),       NULL);
+    (void) g_signal_connect(TSTMSC__pTestMachine, "handle-unsubscribe-session",       G_CALLBACK(NSM__boOnHandleUnsubscribeSession),     NULL);
   }
   else
   {
@@ -274,6 +466,12 @@ unsigned char NsmcLucRequired(void)
 
 NsmErrorStatus_e NsmcSetData(NsmDataType_e enData, unsigned char *pData, unsigned int u32DataLen)
 {
+  /* Simulate a slow NSMC, if requested by the test frame */
+  if(TSTMSC__u32DelayMs > 0)
+  {
+    g_usleep((gulong) TSTMSC__u32DelayMs * 1000);
+  }
+
   return NsmErrorStatus_Ok;
 }
 
@@ -0,0 +1,382 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the NodeStatePluginTest.
+*
+* The file implements a test for NSMC plugins, loaded via the environment variable NSM_NSMC_PLUGIN. The test starts
+* the NSM itself three times:
+*
+*   - Linked: Without plugin, the NSM uses the linked NodeStateMachineTest, which exports its test interface.
+*   - Plugin: With a valid plugin (e.g. NodeStateMachineNull), the NSM answers, but the linked NSMC is not
+*             initialized and its test interface is not exported.
+*   - Mismatch: With a plugin of an other major version, the NSM rejects the plugin and terminates.
+*
+* The test must be started, while no other NSM owns the bus name.
+*
+* Usage: NodeStatePluginTest <NodeStateManager> <Plugin> <MismatchPlugin>
+*
+* NodeStateManager: Path of the NSM executable, linked against the NodeStateMachineTest
+* Plugin:           Path of a valid plugin
+* MismatchPlugin:   Path of a plugin with an other NSMC_PLUGIN_VERSION (NodeStateMachineNullMismatch)
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+/* System header files                                                                          */
+#include <gio/gio.h>                    /* Use glib to access dbus and communicate to NSM       */
+#include <stdio.h>                      /* printf                                               */
+#include <string.h>                     /* strstr                                               */
+#include <signal.h>                     /* kill                                                 */
+#include <sys/wait.h>                   /* waitpid                                              */
+
+/* Header files offered by NSM                                                                  */
+#include "NodeStateTypes.h"             /* Know type definitions of NSM                         */
+
+
+/**********************************************************************************************************************
+*
+* Local defines, macros and type definitions.
+*
+**********************************************************************************************************************/
+
+/* Environment variable of the NSM, which selects the plugin */
+#define NSMPT__PLUGIN_ENV            "NSM_NSMC_PLUGIN"
+
+/* Object and interface exported by the linked NodeStateMachineTest in NsmcInit */
+#define NSMPT__TEST_NSMC_OBJECT      "/com/contiautomotive/NodeStateMachineTest"
+#define NSMPT__TEST_NSMC_INTERFACE   "com.contiautomotive.NodeStateMachineTest.Test"
+
+/* Max. time the NSM may need to start or to terminate after a rejected plugin and poll interval */
+#define NSMPT__START_TIMEOUT_US      5000000
+#define NSMPT__POLL_US               10000
+
+
+/**********************************************************************************************************************
+*
+* Prototypes for file local functions (see implementation for description)
+*
+**********************************************************************************************************************/
+
+static gboolean NSMPT__boStartNsm         (const gchar *sPlugin);
+static gboolean NSMPT__boNsmAnswers       (void);
+static gboolean NSMPT__boNsmTerminated    (void);
+static void     NSMPT__vStopNsm           (void);
+static gboolean NSMPT__boTestNsmcExported (void);
+static gboolean NSMPT__boTestStart        (const gchar *sName,
+                                           const gchar *sPlugin,
+                                           gboolean     boNsmcExported);
+static gboolean NSMPT__boTestMismatch     (const gchar *sPlugin);
+
+
+/**********************************************************************************************************************
+*
+* Local variables
+*
+**********************************************************************************************************************/
+
+static GDBusConnection  *NSMPT__pConnection    = NULL;
+static const gchar      *NSMPT__sNsmPath       = NULL;
+static GPid              NSMPT__pidNsm         = 0;
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function starts the NSM with or without plugin.
+*
+* @param sPlugin: Path of the plugin set in NSM_NSMC_PLUGIN. NULL to start the NSM with the linked NSMC.
+*
+* @return TRUE: The NSM has been started. FALSE: Error.
+*
+**********************************************************************************************************************/
+static gboolean NSMPT__boStartNsm(const gchar *sPlugin)
+{
+  /* Function local variables                                     */
+  gboolean  boRetVal  = FALSE;
+  gchar    *asArgv[2] = {NULL, NULL};
+  GError   *pError    = NULL;
+
+  asArgv[0] = (gchar*) NSMPT__sNsmPath;
+
+  /* The NSM inherits the environment of the test */
+  if(sPlugin != NULL)
+  {
+    (void) g_setenv(NSMPT__PLUGIN_ENV, sPlugin, TRUE);
+  }
+  else
+  {
+    g_unsetenv(NSMPT__PLUGIN_ENV);
+  }
+
+  boRetVal = g_spawn_async(NULL,
+                           asArgv,
+                           NULL,
+                             G_SPAWN_DO_NOT_REAP_CHILD
+                           | G_SPAWN_STDOUT_TO_DEV_NULL
+                           | G_SPAWN_STDERR_TO_DEV_NULL,
+                           NULL,
+                           NULL,
+                           &NSMPT__pidNsm,
+                           &pError);
+
+  g_unsetenv(NSMPT__PLUGIN_ENV);
+
+  if(boRetVal == FALSE)
+  {
+    printf("Error: Failed to start NSM. Error msg.: %s.\n", pError->message);
+    g_error_free(pError);
+    NSMPT__pidNsm = 0;
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function waits, until the started NSM answers calls.
+*
+* @return TRUE: The NSM answers. FALSE: The NSM did not answer in time.
+*
+**********************************************************************************************************************/
+static gboolean NSMPT__boNsmAnswers(void)
+{
+  gint64    i64Deadline = g_get_monotonic_time() + NSMPT__START_TIMEOUT_US;
+  GVariant *pReply      = NULL;
+
+  do
+  {
+    g_usleep(NSMPT__POLL_US);
+
+    pReply = g_dbus_connection_call_sync(NSMPT__pConnection,
+                                         NSM_BUS_NAME,
+                                         NSM_CONSUMER_OBJECT,
+                                         "org.genivi.NodeStateManager.Consumer",
+                                         "GetNodeState",
+                                         NULL,
+                                         G_VARIANT_TYPE("(ii)"),
+                                         G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                                         -1,
+                                         NULL,
+                                         NULL);
+  } while((pReply == NULL) && (g_get_monotonic_time() < i64Deadline));
+
+  if(pReply != NULL)
+  {
+    g_variant_unref(pReply);
+  }
+
+  return (pReply != NULL);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function waits, until the started NSM terminated by itself.
+*
+* @return TRUE: The NSM terminated. FALSE: The NSM still runs after NSMPT__START_TIMEOUT_US.
+*
+**********************************************************************************************************************/
+static gboolean NSMPT__boNsmTerminated(void)
+{
+  gboolean boRetVal    = FALSE;
+  gint64   i64Deadline = g_get_monotonic_time() + NSMPT__START_TIMEOUT_US;
+
+  do
+  {
+    g_usleep(NSMPT__POLL_US);
+    boRetVal = (waitpid(NSMPT__pidNsm, NULL, WNOHANG) == NSMPT__pidNsm);
+  } while((boRetVal == FALSE) && (g_get_monotonic_time() < i64Deadline));
+
+  if(boRetVal == TRUE)
+  {
+    g_spawn_close_pid(NSMPT__pidNsm);
+    NSMPT__pidNsm = 0;
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function stops the NSM started by the test (if it still runs) and waits for its end.
+*
+**********************************************************************************************************************/
+static void NSMPT__vStopNsm(void)
+{
+  if(NSMPT__pidNsm != 0)
+  {
+    (void) kill(NSMPT__pidNsm, SIGTERM);
+    (void) waitpid(NSMPT__pidNsm, NULL, 0);
+    g_spawn_close_pid(NSMPT__pidNsm);
+    NSMPT__pidNsm = 0;
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function checks, if the linked NodeStateMachineTest has been initialized. It exports its test interface in
+* NsmcInit on the connection of the NSM.
+*
+* @return TRUE: The test interface is exported. FALSE: It is not exported.
+*
+**********************************************************************************************************************/
+static gboolean NSMPT__boTestNsmcExported(void)
+{
+  gboolean     boRetVal = FALSE;
+  GVariant    *pReply   = NULL;
+  const gchar *sXml     = NULL;
+
+  pReply = g_dbus_connection_call_sync(NSMPT__pConnection,
+                                       NSM_BUS_NAME,
+                                       NSMPT__TEST_NSMC_OBJECT,
+                                       "org.freedesktop.DBus.Introspectable",
+                                       "Introspect",
+                                       NULL,
+                                       G_VARIANT_TYPE("(s)"),
+                                       G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                                       -1,
+                                       NULL,
+                                       NULL);
+
+  if(pReply != NULL)
+  {
+    g_variant_get(pReply, "(&s)", &sXml);
+    boRetVal = (strstr(sXml, NSMPT__TEST_NSMC_INTERFACE) != NULL);
+    g_variant_unref(pReply);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function starts the NSM, checks that it answers and which NSMC it initialized. Afterwards the NSM is stopped.
+*
+* @param sName:          Name of the case for the output
+* @param sPlugin:        Path of the plugin. NULL for the linked NSMC.
+* @param boNsmcExported: TRUE, if the linked NSMC has to be initialized. FALSE, if the plugin has to be used.
+*
+* @return TRUE: Test passed. FALSE: Test failed.
+*
+**********************************************************************************************************************/
+static gboolean NSMPT__boTestStart(const gchar *sName, const gchar *sPlugin, gboolean boNsmcExported)
+{
+  gboolean boRetVal   = FALSE;
+  gboolean boAnswers  = FALSE;
+  gboolean boExported = FALSE;
+
+  if(NSMPT__boStartNsm(sPlugin) == TRUE)
+  {
+    boAnswers  = NSMPT__boNsmAnswers();
+    boExported = NSMPT__boTestNsmcExported();
+    boRetVal   = (boAnswers == TRUE) && (boExported == boNsmcExported);
+
+    NSMPT__vStopNsm();
+  }
+
+  printf("%-9s NSM answers %s, test NSMC %s -> %s\n", sName,
+         (boAnswers  == TRUE) ? "yes" : "no",
+         (boExported == TRUE) ? "initialized" : "not initialized",
+         (boRetVal   == TRUE) ? "passed" : "failed");
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function starts the NSM with a plugin of an other major version. The NSM has to reject it and terminate.
+*
+* @param sPlugin: Path of the plugin with the wrong version
+*
+* @return TRUE: Test passed. FALSE: Test failed.
+*
+**********************************************************************************************************************/
+static gboolean NSMPT__boTestMismatch(const gchar *sPlugin)
+{
+  gboolean boRetVal = FALSE;
+
+  if(NSMPT__boStartNsm(sPlugin) == TRUE)
+  {
+    boRetVal = NSMPT__boNsmTerminated();
+    NSMPT__vStopNsm();
+  }
+
+  printf("%-9s NSM %s -> %s\n", "Mismatch:",
+         (boRetVal == TRUE) ? "rejected the plugin" : "still runs",
+         (boRetVal == TRUE) ? "passed" : "failed");
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* Main function of the plugin test executable.
+*
+* @return:  0: The NSM loaded the valid plugin and rejected the plugin with the wrong version
+*          -1: Invalid arguments, no bus connection or a check failed
+*
+**********************************************************************************************************************/
+int main(int argc, char **argv)
+{
+  /* Function local variables                                                   */
+  int       iRetVal  = -1;
+  gboolean  boPassed = FALSE;
+  GError   *pError   = NULL;
+
+  /* Initialize types in order to use glib */
+  g_type_init();
+
+  if(argc > 3)
+  {
+    NSMPT__sNsmPath    = argv[1];
+    NSMPT__pConnection = g_bus_get_sync(NSM_BUS_TYPE, NULL, &pError);
+
+    if(pError == NULL)
+    {
+      boPassed = NSMPT__boTestStart("Linked:", NULL, TRUE);
+      boPassed = (NSMPT__boTestStart("Plugin:", argv[2], FALSE) == TRUE) && (boPassed == TRUE);
+      boPassed = (NSMPT__boTestMismatch(argv[3])                == TRUE) && (boPassed == TRUE);
+
+      printf("Result:   %s\n", (boPassed == TRUE) ? "passed" : "failed");
+
+      iRetVal = (boPassed == TRUE) ? 0 : -1;
+
+      g_object_unref(NSMPT__pConnection);
+    }
+    else
+    {
+      printf("Error: Failed to get bus connection. Error msg.: %s.\n", pError->message);
+      g_error_free(pError);
+    }
+  }
+  else
+  {
+    printf("Usage: %s <NodeStateManager> <Plugin> <MismatchPlugin>\n", argv[0]);
+  }
+
+  return iRetVal;
+}
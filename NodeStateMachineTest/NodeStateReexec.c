@@ -0,0 +1,441 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the NodeStateReexec test.
+*
+* The file implements a test for the live re-execution of the NodeStateManager ("Reexec"). The test registers a
+* session and lifecycle clients for a seat. A probe thread calls "GetNodeState" in a loop with a short timeout and
+* measures the longest time between two answered calls (service gap). Then the NSM is re-executed. Afterwards, the
+* test checks that the NSM kept its PID, that the session still exists and that the handed over lifecycle clients are
+* called by the new instance, when the seat is shut down. The test fails, if a check fails or if the service gap
+* exceeds the passed limit.
+*
+* Usage: NodeStateReexec [MaxGapMs] [Clients]
+*
+* MaxGapMs: Max. allowed service gap in ms (default NSMRX__DEFAULT_MAX_GAP_MS)
+* Clients:  Number of lifecycle clients registered for the seat (default NSMRX__DEFAULT_CLIENTS)
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+/* System header files                                                                          */
+#include <gio/gio.h>                    /* Use glib to access dbus and communicate to NSM       */
+#include <stdio.h>                      /* printf                                               */
+#include <stdlib.h>                     /* strtoul                                              */
+
+/* Header files offered by NSM                                                                  */
+#include "NodeStateTypes.h"             /* Know type definitions of NSM                         */
+
+/* Generated header files to access NSM via D-Bus                                               */
+#include "NodeStateConsumer.h"          /* Consumer interface with publicly available functions */
+#include "NodeStateLifecycleControl.h"  /* Control  interface to re-execute the NSM             */
+#include "NodeStateLifecycleConsumer.h" /* Consumer interface to offer life cycle clients       */
+
+/* Own header files                                                                             */
+#include "NodeStateTestFixture.h"       /* Clients, registration and seat requests of the test  */
+
+
+/**********************************************************************************************************************
+*
+* Local defines, macros and type definitions.
+*
+**********************************************************************************************************************/
+
+/* Default values, if not passed on the command line */
+#define NSMRX__DEFAULT_MAX_GAP_MS 200
+#define NSMRX__DEFAULT_CLIENTS    5
+
+/* Seat, session and objects used by the test */
+#define NSMRX__SEAT               NsmSeat_Rear3
+#define NSMRX__SESSION_NAME       "NodeStateReexec"
+#define NSMRX__SESSION_OWNER      "NodeStateReexec"
+#define NSMRX__CLIENT_OBJECT      "/org/genivi/NodeStateReexec/Client%u"
+
+/* Timeout of the clients registered at the NSM and interval, in which the test checks for the new instance */
+#define NSMRX__CLIENT_TIMEOUT_MS  1000
+#define NSMRX__POLL_US            100
+
+/* Timeout of a probe call. It limits the resolution of the measured gap, if a call is lost during the handover */
+#define NSMRX__PROBE_TIMEOUT_MS   20
+
+/* Time the probe runs before and after the re-execution, and max. time the new instance may need */
+#define NSMRX__SETTLE_US          100000
+#define NSMRX__REEXEC_TIMEOUT_US  5000000
+
+
+/**********************************************************************************************************************
+*
+* Prototypes for file local functions (see implementation for description)
+*
+**********************************************************************************************************************/
+
+static gpointer NSMRX__pvProbeThread        (gpointer                    pUserData);
+static gchar   *NSMRX__sGetNsmOwner         (void);
+static guint    NSMRX__u32GetNsmPid         (void);
+static gboolean NSMRX__boReexec             (NodeStateLifecycleControl  *pLifecycleControl,
+                                             const gchar                *sOldOwner);
+static gboolean NSMRX__boRunTest            (NSMTF_tstFixture           *pstFixture);
+
+
+/**********************************************************************************************************************
+*
+* Local variables
+*
+**********************************************************************************************************************/
+
+static guint             NSMRX__u32MaxGapMs     = NSMRX__DEFAULT_MAX_GAP_MS;
+
+/* Session and lifecycle clients of the test seat */
+static NSMTF_tstFixture  NSMRX__stFixture       = {NSMRX__SEAT,
+                                                   NSMRX__SESSION_NAME,
+                                                   NSMRX__SESSION_OWNER,
+                                                   NSMRX__CLIENT_OBJECT,
+                                                   NSMRX__DEFAULT_CLIENTS,
+                                                   NSMRX__CLIENT_TIMEOUT_MS,
+                                                   NULL, NULL, NULL, 0};
+
+/* Set to stop the probe. Answered probe calls are counted, the test thread waits for answers of the new instance */
+static volatile gint     NSMRX__i32StopProbe    = 0;
+static volatile gint     NSMRX__i32ProbeReplies = 0;
+
+/* Results of the probe thread. Only read after the thread has been joined */
+static guint             NSMRX__u32ProbeCalls   = 0;
+static guint             NSMRX__u32ProbeErrors  = 0;
+static gint64            NSMRX__i64MaxGapUs     = 0;
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function is the body of the probe thread. It calls "GetNodeState" of the NSM's bus name, until
+* NSMRX__i32StopProbe is set, and stores the longest time between two answered calls. The calls are sent without a
+* proxy, because a proxy sends to the unique name of the old instance, until it has seen the owner change. The bus
+* daemon must not start the NSM, while it is away.
+*
+* @param pUserData: Optionally user data (not used)
+*
+* @return NULL
+*
+**********************************************************************************************************************/
+static gpointer NSMRX__pvProbeThread(gpointer pUserData)
+{
+  /* Function local variables                                          */
+  GVariant *pReply       = NULL;
+  gint64    i64LastReply = g_get_monotonic_time(); /* Last answer in us */
+  gint64    i64Now       = 0;
+
+  while(g_atomic_int_get(&NSMRX__i32StopProbe) == 0)
+  {
+    pReply = g_dbus_connection_call_sync(NSMRX__stFixture.pConnection,
+                                         NSM_BUS_NAME,
+                                         NSM_CONSUMER_OBJECT,
+                                         "org.genivi.NodeStateManager.Consumer",
+                                         "GetNodeState",
+                                         NULL,
+                                         G_VARIANT_TYPE("(ii)"),
+                                         G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                                         NSMRX__PROBE_TIMEOUT_MS,
+                                         NULL,
+                                         NULL);
+    NSMRX__u32ProbeCalls++;
+
+    if(pReply != NULL)
+    {
+      i64Now             = g_get_monotonic_time();
+      NSMRX__i64MaxGapUs = MAX(NSMRX__i64MaxGapUs, i64Now - i64LastReply);
+      i64LastReply       = i64Now;
+
+      g_variant_unref(pReply);
+      g_atomic_int_inc(&NSMRX__i32ProbeReplies);
+    }
+    else
+    {
+      /* The NSM is away: No owner of the bus name or the call was lost */
+      NSMRX__u32ProbeErrors++;
+      g_usleep(NSMRX__POLL_US);
+    }
+  }
+
+  return NULL;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function requests the unique name of the current owner of the NSM's bus name from the bus daemon.
+*
+* @return Unique name, to be freed with g_free. NULL, if the bus name has no owner.
+*
+**********************************************************************************************************************/
+static gchar *NSMRX__sGetNsmOwner(void)
+{
+  GVariant *pReply = NULL;
+  gchar    *sOwner = NULL;
+
+  pReply = g_dbus_connection_call_sync(NSMRX__stFixture.pConnection,
+                                       "org.freedesktop.DBus",
+                                       "/org/freedesktop/DBus",
+                                       "org.freedesktop.DBus",
+                                       "GetNameOwner",
+                                       g_variant_new("(s)", NSM_BUS_NAME),
+                                       G_VARIANT_TYPE("(s)"),
+                                       G_DBUS_CALL_FLAGS_NONE,
+                                       -1,
+                                       NULL,
+                                       NULL);
+  if(pReply != NULL)
+  {
+    g_variant_get(pReply, "(s)", &sOwner);
+    g_variant_unref(pReply);
+  }
+
+  return sOwner;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function requests the PID of the NSM from the bus daemon.
+*
+* @return PID of the NSM. 0, if it could not be determined.
+*
+**********************************************************************************************************************/
+static guint NSMRX__u32GetNsmPid(void)
+{
+  GVariant *pReply = NULL;
+  guint     u32Pid = 0;
+
+  pReply = g_dbus_connection_call_sync(NSMRX__stFixture.pConnection,
+                                       "org.freedesktop.DBus",
+                                       "/org/freedesktop/DBus",
+                                       "org.freedesktop.DBus",
+                                       "GetConnectionUnixProcessID",
+                                       g_variant_new("(s)", NSM_BUS_NAME),
+                                       G_VARIANT_TYPE("(u)"),
+                                       G_DBUS_CALL_FLAGS_NONE,
+                                       -1,
+                                       NULL,
+                                       NULL);
+  if(pReply != NULL)
+  {
+    g_variant_get(pReply, "(u)", &u32Pid);
+    g_variant_unref(pReply);
+  }
+
+  return u32Pid;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function re-executes the NSM and waits, until the new instance owns the bus name and answered a probe call.
+*
+* @param pLifecycleControl: Proxy of the LifecycleControl interface of the old instance
+* @param sOldOwner:         Unique name of the old instance
+*
+* @return TRUE: The new instance answers. FALSE: The request was rejected or the NSM did not come back.
+*
+**********************************************************************************************************************/
+static gboolean NSMRX__boReexec(NodeStateLifecycleControl *pLifecycleControl, const gchar *sOldOwner)
+{
+  /* Function local variables                                                      */
+  gboolean          boRetVal      = FALSE;
+  gchar            *sOwner        = NULL;   /* Current owner of the bus name       */
+  gint              i32Replies    = 0;      /* Probe answers, when the owner changed */
+  gint64            i64Deadline   = 0;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  GError           *pError        = NULL;
+
+  (void) node_state_lifecycle_control_call_reexec_sync(pLifecycleControl, (gint*) &enErrorStatus, NULL, &pError);
+
+  if((pError == NULL) && (enErrorStatus == NsmErrorStatus_Ok))
+  {
+    i64Deadline = g_get_monotonic_time() + NSMRX__REEXEC_TIMEOUT_US;
+
+    /* Wait for the new owner of the bus name */
+    do
+    {
+      g_free(sOwner);
+      sOwner = NSMRX__sGetNsmOwner();
+
+      if((sOwner == NULL) || (g_strcmp0(sOwner, sOldOwner) == 0))
+      {
+        g_usleep(NSMRX__POLL_US);
+      }
+    } while(((sOwner == NULL) || (g_strcmp0(sOwner, sOldOwner) == 0)) && (g_get_monotonic_time() < i64Deadline));
+
+    /* Wait for the first answer of the new instance */
+    i32Replies = g_atomic_int_get(&NSMRX__i32ProbeReplies);
+
+    while((g_atomic_int_get(&NSMRX__i32ProbeReplies) == i32Replies) && (g_get_monotonic_time() < i64Deadline))
+    {
+      g_usleep(NSMRX__POLL_US);
+    }
+
+    boRetVal = (g_atomic_int_get(&NSMRX__i32ProbeReplies) != i32Replies);
+    g_free(sOwner);
+  }
+  else if(pError != NULL)
+  {
+    printf("Error: Failed to call Reexec. Error msg.: %s.\n", pError->message);
+    g_error_free(pError);
+  }
+  else
+  {
+    printf("Error: The NSM rejected Reexec. Return value: %d.\n", (gint) enErrorStatus);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function runs the test in an own thread, while the main loop dispatches the lifecycle requests to the clients.
+*
+* @param pstFixture: Fixture of the test (NSMRX__stFixture)
+*
+* @return TRUE: The NSM kept its state and the service gap stayed below the limit. FALSE: A check failed.
+*
+**********************************************************************************************************************/
+static gboolean NSMRX__boRunTest(NSMTF_tstFixture *pstFixture)
+{
+  /* Function local variables                                                      */
+  gboolean                   boPassed          = FALSE;
+  NodeStateConsumer         *pConsumer         = NULL;
+  NodeStateLifecycleControl *pLifecycleControl = NULL;
+  gchar                     *sOldOwner         = NULL;  /* Unique name of the old instance */
+  GThread                   *pProbeThread      = NULL;
+  guint                      u32PidBefore      = 0;
+  guint                      u32PidAfter       = 0;
+  gboolean                   boReexecuted      = FALSE;
+  gboolean                   boSession         = FALSE; /* Session survived              */
+  gboolean                   boClients         = FALSE; /* Clients survived              */
+  NsmSessionState_e          enSessionState    = NsmSessionState_Unregistered;
+  NsmErrorStatus_e           enErrorStatus     = NsmErrorStatus_NotSet;
+
+  if(   (NSMTF_boCreateProxies(pstFixture, &pConsumer, &pLifecycleControl) == TRUE)
+     && (NSMTF_boRegister(pstFixture, pConsumer)                          == TRUE))
+  {
+    sOldOwner    = NSMRX__sGetNsmOwner();
+    u32PidBefore = NSMRX__u32GetNsmPid();
+
+    /* Start the probe and give it time to measure the normal distance of the answers */
+    g_atomic_int_set(&NSMRX__i32StopProbe, 0);
+    pProbeThread = g_thread_create(&NSMRX__pvProbeThread, NULL, TRUE, NULL);
+    g_usleep(NSMRX__SETTLE_US);
+
+    boReexecuted = NSMRX__boReexec(pLifecycleControl, sOldOwner);
+
+    g_usleep(NSMRX__SETTLE_US);
+    g_atomic_int_set(&NSMRX__i32StopProbe, 1);
+    (void) g_thread_join(pProbeThread);
+
+    /* The proxies are bound to the old instance */
+    NSMTF_vFreeProxies(&pConsumer, &pLifecycleControl);
+
+    if((boReexecuted == TRUE) && (NSMTF_boCreateProxies(pstFixture, &pConsumer, &pLifecycleControl) == TRUE))
+    {
+      u32PidAfter = NSMRX__u32GetNsmPid();
+
+      (void) node_state_consumer_call_get_session_state_sync(pConsumer,
+                                                             NSMRX__SESSION_NAME,
+                                                             (gint) NSMRX__SEAT,
+                                                             (gint*) &enSessionState,
+                                                             (gint*) &enErrorStatus,
+                                                             NULL,
+                                                             NULL);
+
+      boSession =    (enErrorStatus  == NsmErrorStatus_Ok    )
+                  && (enSessionState == NsmSessionState_Active);
+
+      boClients =    (NSMTF_boRequestSeat(pstFixture, pLifecycleControl, NSM_SHUTDOWNTYPE_NORMAL, NULL) == TRUE)
+                  && (NSMTF_boRequestSeat(pstFixture, pLifecycleControl, NSM_SHUTDOWNTYPE_RUNUP,  NULL) == TRUE);
+
+      boPassed =    (u32PidAfter        == u32PidBefore                        )
+                 && (boSession          == TRUE                                )
+                 && (boClients          == TRUE                                )
+                 && (NSMRX__i64MaxGapUs <= (gint64) NSMRX__u32MaxGapMs * 1000);
+
+      printf("Clients:           %u\n", pstFixture->u32Clients);
+      printf("PID:               %u -> %u\n", u32PidBefore, u32PidAfter);
+      printf("Probe calls:       %u (%u failed)\n", NSMRX__u32ProbeCalls, NSMRX__u32ProbeErrors);
+      printf("Service gap:       %" G_GINT64_FORMAT " us (max. %u ms)\n", NSMRX__i64MaxGapUs, NSMRX__u32MaxGapMs);
+      printf("Session kept:      %s\n", (boSession == TRUE) ? "yes" : "no");
+      printf("Clients kept:      %s\n", (boClients == TRUE) ? "yes" : "no");
+      printf("Result:            %s\n", (boPassed == TRUE) ? "passed" : "failed");
+    }
+    else
+    {
+      printf("Error: The NSM did not come back after Reexec.\n");
+    }
+
+    g_free(sOldOwner);
+  }
+
+  if(pConsumer != NULL)
+  {
+    NSMTF_vUnRegister(pstFixture, pConsumer);
+  }
+
+  NSMTF_vFreeProxies(&pConsumer, &pLifecycleControl);
+
+  return boPassed;
+}
+
+
+/**********************************************************************************************************************
+*
+* Main function of the re-execution test executable.
+*
+* @return:  0: The NSM kept its state and the service gap stayed below the limit
+*          -1: Invalid arguments, no connection to the NSM or a check failed
+*
+**********************************************************************************************************************/
+int main(int argc, char **argv)
+{
+  /* Function local variables                    */
+  int iRetVal = -1;
+
+  /* Initialize types in order to use glib */
+  g_type_init();
+
+  if(argc > 1)
+  {
+    NSMRX__u32MaxGapMs = (guint) strtoul(argv[1], NULL, 10);
+  }
+
+  if(argc > 2)
+  {
+    NSMRX__stFixture.u32Clients = (guint) strtoul(argv[2], NULL, 10);
+  }
+
+  if((NSMRX__u32MaxGapMs != 0) && (NSMRX__stFixture.u32Clients != 0))
+  {
+    iRetVal = (NSMTF_boRun(&NSMRX__stFixture, &NSMRX__boRunTest) == TRUE) ? 0 : -1;
+  }
+  else
+  {
+    printf("Usage: %s [MaxGapMs] [Clients]\n", argv[0]);
+  }
+
+  return iRetVal;
+}
@@ -0,0 +1,978 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the NodeStateReplay tool.
+*
+* The tool replays a timestamped scenario against the NodeStateManager and reports the throughput, the latency
+* percentiles of the calls and the duration of a shutdown. The NSM should use the replay NSMC
+* (NodeStateMachineReplay), which does not restart the node on replayed restart requests and which can capture
+* scenarios. To avoid that the calls are rejected, the NSM should be started without NSM_RATE_LIMIT.
+*
+* A scenario is a text file with one event per line. Empty lines and lines starting with '#' are ignored. Names are
+* URI escaped, so that they can contain white space ("%20" for a space, "%25" for '%'). Numbers are the values of the
+* NSM enumerations:
+*
+*   <ms> NodeState <NodeState>                             LifecycleControl.SetNodeState
+*   <ms> AppMode   <ApplicationMode>                       LifecycleControl.SetApplicationMode
+*   <ms> Session   <Name> <Owner> <Seat> <SessionState>    Consumer.RegisterSession, SetSessionState or, for state
+*                                                          "Unregistered", UnRegisterSession. Sessions the NSM
+*                                                          offered before the replay (platform sessions) are only
+*                                                          set with SetSessionState
+*   <ms> AppHealth <AppName> <0: failed|1: running>        LifecycleControl.SetAppHealthStatus
+*   <ms> Restart   <RestartReason> <RestartType>           LifecycleControl.RequestNodeRestart
+*   <ms> Client    <Name> <ShutdownMode> <TimeoutMs> <DelayMs>
+*                                                          Consumer.RegisterShutdownClient. The client answers its
+*                                                          lifecycle requests after DelayMs (0: at once)
+*
+* <ms> is the time of the event since the start of the replay. The events are replayed in the order of the file.
+* The shutdown duration is the time from the last "NodeState" event that sets "ShuttingDown" or "FastShutdown",
+* until all clients registered for this shutdown type answered.
+*
+* Usage: NodeStateReplay <Scenario> [Speed] [NodeState]
+*
+* Speed:     Factor, how much faster than real time the scenario is replayed (default 1.0). 0 replays without pauses.
+* NodeState: NodeState expected after the replay. If passed, the replay only passes, if no call failed and the NSM
+*            reaches the NodeState within NSMRP__STATE_TIMEOUT_US. Used by "make check" with NodeStateReplay.scenario.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+/* System header files                                                                          */
+#include <gio/gio.h>                    /* Use glib to access dbus and communicate to NSM       */
+#include <stdio.h>                      /* printf                                               */
+#include <stdlib.h>                     /* strtol, strtod, qsort                                */
+#include <string.h>                     /* strcmp                                               */
+
+/* Header files offered by NSM                                                                  */
+#include "NodeStateTypes.h"             /* Know type definitions of NSM                         */
+
+/* Generated header files to access NSM via D-Bus                                               */
+#include "NodeStateConsumer.h"          /* Consumer interface with publicly available functions */
+#include "NodeStateLifecycleControl.h"  /* Control  interface to replay NSMC events             */
+#include "NodeStateLifecycleConsumer.h" /* Consumer interface to offer life cycle clients       */
+
+
+/**********************************************************************************************************************
+*
+* Local defines, macros and type definitions.
+*
+**********************************************************************************************************************/
+
+#define NSMRP__CLIENT_OBJECT     "/org/genivi/NodeStateReplay/Client%u"
+#define NSMRP__CONSUMER_IFACE    "org.genivi.NodeStateManager.Consumer"
+#define NSMRP__POLL_US           1000
+#define NSMRP__MAX_ARGS          4
+#define NSMRP__STATE_TIMEOUT_US  1000000
+
+/* The type defines the events of a scenario */
+typedef enum
+{
+  NSMRP__EVENT_NODESTATE,
+  NSMRP__EVENT_APPMODE,
+  NSMRP__EVENT_SESSION,
+  NSMRP__EVENT_APPHEALTH,
+  NSMRP__EVENT_RESTART,
+  NSMRP__EVENT_CLIENT
+} NSMRP__tenEvent;
+
+/* The type defines a lifecycle client of the scenario */
+typedef struct
+{
+  NodeStateLifeCycleConsumer *pSkeleton;    /* Exported LifecycleConsumer object         */
+  gchar                      *sObjName;     /* Object path of the client                 */
+  guint                       u32Mode;      /* Registered shutdown types                 */
+  guint                       u32TimeoutMs; /* Timeout registered at the NSM             */
+  guint                       u32DelayMs;   /* Time until the client answers a request   */
+} NSMRP__tstClient;
+
+/* The type defines an event of the scenario */
+typedef struct
+{
+  gint64            i64TimeUs;              /* Time since the start of the replay        */
+  NSMRP__tenEvent   enEvent;                /* Type of the event                         */
+  gchar            *sName;                  /* Session, application or client name       */
+  gchar            *sOwner;                 /* Session owner                             */
+  gint              ai32Args[NSMRP__MAX_ARGS]; /* Numeric arguments of the event         */
+  NSMRP__tstClient *pstClient;              /* Client of a "Client" event                */
+} NSMRP__tstEvent;
+
+/* The type defines a lifecycle request, which is answered later */
+typedef struct
+{
+  NSMRP__tstClient *pstClient;              /* Called client                             */
+  guint             u32RequestId;           /* Request ID passed by the NSM              */
+} NSMRP__tstPendingRequest;
+
+
+/**********************************************************************************************************************
+*
+* Prototypes for file local functions (see implementation for description)
+*
+**********************************************************************************************************************/
+
+static gboolean NSMRP__boParseLine          (gchar                      *sLine,
+                                             guint                       u32LineNo);
+static gboolean NSMRP__boLoadScenario       (const gchar                *sFile);
+static gboolean NSMRP__boLoadPlatformSessions(void);
+static void     NSMRP__vRecordAnswer        (NSMRP__tstClient           *pstClient);
+static gboolean NSMRP__boOnAnswerTimer      (gpointer                    pUserData);
+static gboolean NSMRP__boOnLifecycleRequest (NodeStateLifeCycleConsumer *pConsumer,
+                                             GDBusMethodInvocation      *pInvocation,
+                                             const guint32               u32LifeCycleRequest,
+                                             const guint32               u32RequestId,
+                                             gpointer                    pUserData);
+static gboolean NSMRP__boExecute            (NSMRP__tstEvent            *pstEvent);
+static gint     NSMRP__i32CompareLatency    (const void                 *pA,
+                                             const void                 *pB);
+static gint64   NSMRP__i64Percentile        (guint                       u32Percent);
+static void     NSMRP__vReport              (gint64                      i64DurationUs);
+static gboolean NSMRP__boCheckNodeState     (void);
+static gpointer NSMRP__pvReplay             (gpointer                    pUserData);
+
+
+/**********************************************************************************************************************
+*
+* Local variables
+*
+**********************************************************************************************************************/
+
+static GMainLoop                 *NSMRP__pMainLoop         = NULL;
+static GDBusConnection           *NSMRP__pConnection       = NULL;
+static NodeStateConsumer         *NSMRP__pConsumer         = NULL;
+static NodeStateLifecycleControl *NSMRP__pLifecycleControl = NULL;
+static gdouble                    NSMRP__dSpeed            = 1.0;
+static GPtrArray                 *NSMRP__pEvents           = NULL;  /* NSMRP__tstEvent,  in order of the file */
+static GPtrArray                 *NSMRP__pClients          = NULL;  /* NSMRP__tstClient, in order of the file */
+static GHashTable                *NSMRP__pSessions         = NULL;  /* "Name Seat" of registered sessions     */
+static GHashTable                *NSMRP__pPlatformSessions = NULL;  /* "Name Seat" of sessions of the NSM     */
+static gboolean                   NSMRP__boPassed          = FALSE;
+static gint                       NSMRP__i32NodeState      = -1;    /* Expected NodeState. -1: Not checked      */
+
+/* Results of the replay. Written by the replay thread */
+static GArray                    *NSMRP__pLatencies        = NULL;  /* gint64, latency of every call in us    */
+static guint                      NSMRP__u32Failed         = 0;     /* Calls with D-Bus or NSM error          */
+
+/* Shutdown measurement. The start is set by the replay thread, the answers are counted in the main loop */
+static volatile gint              NSMRP__i32ShutdownType   = 0;     /* NSM_SHUTDOWNTYPE_* of the last shutdown */
+static gint64                     NSMRP__i64ShutdownStart  = 0;
+static volatile gint              NSMRP__i32Answers        = 0;     /* Answers since the start of the shutdown */
+static gint64                     NSMRP__i64LastAnswer     = 0;
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function parses a line of the scenario and appends the event to NSMRP__pEvents.
+*
+* @param sLine:     Line of the scenario. The line is modified.
+* @param u32LineNo: Number of the line, for error messages
+*
+* @return TRUE: Line parsed or ignored. FALSE: The line is invalid.
+*
+**********************************************************************************************************************/
+static gboolean NSMRP__boParseLine(gchar *sLine, guint u32LineNo)
+{
+  /* Function local variables                                        */
+  gboolean          boRetVal    = FALSE;
+  gchar           **asTokens    = NULL;
+  gchar            *asArgs[NSMRP__MAX_ARGS + 3];  /* Non-empty tokens */
+  guint             u32ArgCnt   = 0;
+  guint             u32TokenIdx = 0;
+  guint             u32ArgIdx   = 0;
+  guint             u32FirstNum = 0;              /* First numeric argument      */
+  guint             u32NumCnt   = 0;              /* Expected numeric arguments  */
+  NSMRP__tstEvent  *pstEvent    = NULL;
+
+  sLine = g_strstrip(sLine);
+
+  if((sLine[0] == '\0') || (sLine[0] == '#'))
+  {
+    boRetVal = TRUE;
+  }
+  else
+  {
+    asTokens = g_strsplit_set(sLine, " \t", -1);
+
+    for(u32TokenIdx = 0; (asTokens[u32TokenIdx] != NULL) && (u32ArgCnt < G_N_ELEMENTS(asArgs)); u32TokenIdx++)
+    {
+      if(asTokens[u32TokenIdx][0] != '\0')
+      {
+        asArgs[u32ArgCnt] = asTokens[u32TokenIdx];
+        u32ArgCnt++;
+      }
+    }
+
+    pstEvent            = g_new0(NSMRP__tstEvent, 1);
+    pstEvent->i64TimeUs = (u32ArgCnt > 0) ? (g_ascii_strtoll(asArgs[0], NULL, 10) * 1000) : 0;
+
+    if(u32ArgCnt >= 2)
+    {
+      boRetVal = TRUE;
+
+      if(     (strcmp(asArgs[1], "NodeState") == 0) && (u32ArgCnt == 3))
+      {
+        pstEvent->enEvent = NSMRP__EVENT_NODESTATE;
+        u32FirstNum = 2;
+        u32NumCnt   = 1;
+      }
+      else if((strcmp(asArgs[1], "AppMode")   == 0) && (u32ArgCnt == 3))
+      {
+        pstEvent->enEvent = NSMRP__EVENT_APPMODE;
+        u32FirstNum = 2;
+        u32NumCnt   = 1;
+      }
+      else if((strcmp(asArgs[1], "Session")   == 0) && (u32ArgCnt == 6))
+      {
+        pstEvent->enEvent = NSMRP__EVENT_SESSION;
+        pstEvent->sName   = g_uri_unescape_string(asArgs[2], NULL);
+        pstEvent->sOwner  = g_uri_unescape_string(asArgs[3], NULL);
+        u32FirstNum = 4;
+        u32NumCnt   = 2;
+      }
+      else if((strcmp(asArgs[1], "AppHealth") == 0) && (u32ArgCnt == 4))
+      {
+        pstEvent->enEvent = NSMRP__EVENT_APPHEALTH;
+        pstEvent->sName   = g_uri_unescape_string(asArgs[2], NULL);
+        u32FirstNum = 3;
+        u32NumCnt   = 1;
+      }
+      else if((strcmp(asArgs[1], "Restart")   == 0) && (u32ArgCnt == 4))
+      {
+        pstEvent->enEvent = NSMRP__EVENT_RESTART;
+        u32FirstNum = 2;
+        u32NumCnt   = 2;
+      }
+      else if((strcmp(asArgs[1], "Client")    == 0) && (u32ArgCnt == 6))
+      {
+        pstEvent->enEvent = NSMRP__EVENT_CLIENT;
+        pstEvent->sName   = g_uri_unescape_string(asArgs[2], NULL);
+        u32FirstNum = 3;
+        u32NumCnt   = 3;
+      }
+      else
+      {
+        boRetVal = FALSE;
+      }
+
+      for(u32ArgIdx = 0; u32ArgIdx < u32NumCnt; u32ArgIdx++)
+      {
+        pstEvent->ai32Args[u32ArgIdx] = (gint) strtol(asArgs[u32FirstNum + u32ArgIdx], NULL, 0);
+      }
+
+      /* A name with an invalid escape sequence can not be unescaped */
+      boRetVal =    (boRetVal == TRUE)
+                 && (   (pstEvent->enEvent == NSMRP__EVENT_NODESTATE)
+                     || (pstEvent->enEvent == NSMRP__EVENT_APPMODE)
+                     || (pstEvent->enEvent == NSMRP__EVENT_RESTART)
+                     || (pstEvent->sName   != NULL))
+                 && ((pstEvent->enEvent != NSMRP__EVENT_SESSION) || (pstEvent->sOwner != NULL));
+    }
+
+    if(boRetVal == TRUE)
+    {
+      /* Every client gets an own object, which is exported before the replay starts */
+      if(pstEvent->enEvent == NSMRP__EVENT_CLIENT)
+      {
+        pstEvent->pstClient               = g_new0(NSMRP__tstClient, 1);
+        pstEvent->pstClient->sObjName     = g_strdup_printf(NSMRP__CLIENT_OBJECT, NSMRP__pClients->len);
+        pstEvent->pstClient->u32Mode      = (guint) pstEvent->ai32Args[0];
+        pstEvent->pstClient->u32TimeoutMs = (guint) pstEvent->ai32Args[1];
+        pstEvent->pstClient->u32DelayMs   = (guint) pstEvent->ai32Args[2];
+        g_ptr_array_add(NSMRP__pClients, pstEvent->pstClient);
+      }
+
+      g_ptr_array_add(NSMRP__pEvents, pstEvent);
+    }
+    else
+    {
+      printf("Error: Invalid event in line %u: \"%s\".\n", u32LineNo, sLine);
+      g_free(pstEvent->sName);
+      g_free(pstEvent->sOwner);
+      g_free(pstEvent);
+    }
+
+    g_strfreev(asTokens);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function loads the scenario.
+*
+* @param sFile: Path of the scenario
+*
+* @return TRUE: Scenario loaded. FALSE: The file could not be read or contains an invalid line.
+*
+**********************************************************************************************************************/
+static gboolean NSMRP__boLoadScenario(const gchar *sFile)
+{
+  /* Function local variables                        */
+  gboolean   boRetVal   = FALSE;
+  gchar     *sContent   = NULL;
+  gchar    **asLines    = NULL;
+  guint      u32LineIdx = 0;
+  GError    *pError     = NULL;
+
+  if(g_file_get_contents(sFile, &sContent, NULL, &pError) == TRUE)
+  {
+    boRetVal = TRUE;
+    asLines  = g_strsplit(sContent, "\n", -1);
+
+    for(u32LineIdx = 0; (asLines[u32LineIdx] != NULL) && (boRetVal == TRUE); u32LineIdx++)
+    {
+      boRetVal = NSMRP__boParseLine(asLines[u32LineIdx], u32LineIdx + 1);
+    }
+
+    g_strfreev(asLines);
+    g_free(sContent);
+  }
+  else
+  {
+    printf("Error: Failed to read scenario. Error msg.: %s.\n", pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function reads the sessions, which the NSM offers before the replay starts (the platform sessions). They can
+* not be registered or unregistered. Their state is only set with SetSessionState.
+*
+* @return TRUE: Sessions read. FALSE: The "Sessions" property could not be read.
+*
+**********************************************************************************************************************/
+static gboolean NSMRP__boLoadPlatformSessions(void)
+{
+  /* Function local variables                                       */
+  gboolean      boRetVal   = FALSE;
+  GVariant     *pReply     = NULL;
+  GVariant     *pSessions  = NULL;
+  GVariantIter  stIter;
+  const gchar  *sName      = NULL;
+  gint          i32Seat    = 0;
+  gint          i32State   = 0;
+  GError       *pError     = NULL;
+
+  pReply = g_dbus_connection_call_sync(NSMRP__pConnection,
+                                       NSM_BUS_NAME,
+                                       NSM_CONSUMER_OBJECT,
+                                       "org.freedesktop.DBus.Properties",
+                                       "Get",
+                                       g_variant_new("(ss)", NSMRP__CONSUMER_IFACE, "Sessions"),
+                                       G_VARIANT_TYPE("(v)"),
+                                       G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                                       -1,
+                                       NULL,
+                                       &pError);
+
+  if(pError == NULL)
+  {
+    g_variant_get(pReply, "(v)", &pSessions);
+
+    if(g_variant_is_of_type(pSessions, G_VARIANT_TYPE("a(sii)")) == TRUE)
+    {
+      boRetVal = TRUE;
+      (void) g_variant_iter_init(&stIter, pSessions);
+
+      while(g_variant_iter_next(&stIter, "(&sii)", &sName, &i32Seat, &i32State) == TRUE)
+      {
+        g_hash_table_insert(NSMRP__pPlatformSessions, g_strdup_printf("%s %d", sName, i32Seat), GINT_TO_POINTER(1));
+      }
+    }
+    else
+    {
+      printf("Error: The property \"Sessions\" has an unexpected type.\n");
+    }
+
+    g_variant_unref(pSessions);
+    g_variant_unref(pReply);
+  }
+  else
+  {
+    printf("Error: Failed to read sessions of NSM. Error msg.: %s.\n", pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function counts the answer of a client, if the client belongs to the measured shutdown. Called in main loop.
+*
+* @param pstClient: Client, which answered
+*
+**********************************************************************************************************************/
+static void NSMRP__vRecordAnswer(NSMRP__tstClient *pstClient)
+{
+  if((pstClient->u32Mode & (guint) g_atomic_int_get(&NSMRP__i32ShutdownType)) != 0)
+  {
+    NSMRP__i64LastAnswer = g_get_monotonic_time();
+    g_atomic_int_inc(&NSMRP__i32Answers);
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The timer is called, when a client with delay should answer its pending request.
+*
+* @param pUserData: Pending request (NSMRP__tstPendingRequest)
+*
+* @return FALSE: The timer is not called again.
+*
+**********************************************************************************************************************/
+static gboolean NSMRP__boOnAnswerTimer(gpointer pUserData)
+{
+  NSMRP__tstPendingRequest *pstPending = (NSMRP__tstPendingRequest*) pUserData;
+
+  node_state_consumer_call_lifecycle_request_complete(NSMRP__pConsumer,
+                                                      pstPending->u32RequestId,
+                                                      (gint) NsmErrorStatus_Ok,
+                                                      NULL,
+                                                      NULL,
+                                                      NULL);
+  NSMRP__vRecordAnswer(pstPending->pstClient);
+  g_free(pstPending);
+
+  return FALSE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called in the main loop, when the NSM called a lifecycle client of the scenario. The client
+* answers at once or, if it has a delay, returns "ResponsePending" and completes the request later.
+*
+* @param pConsumer:           Skeleton of the called client
+* @param pInvocation:         Method invocation
+* @param u32LifeCycleRequest: Requested shutdown type
+* @param u32RequestId:        Request ID, used to complete a pending request
+* @param pUserData:           Called client (NSMRP__tstClient)
+*
+* @return TRUE: The method has been handled.
+*
+**********************************************************************************************************************/
+static gboolean NSMRP__boOnLifecycleRequest(NodeStateLifeCycleConsumer *pConsumer,
+                                            GDBusMethodInvocation      *pInvocation,
+                                            const guint32               u32LifeCycleRequest,
+                                            const guint32               u32RequestId,
+                                            gpointer                    pUserData)
+{
+  NSMRP__tstClient         *pstClient  = (NSMRP__tstClient*) pUserData;
+  NSMRP__tstPendingRequest *pstPending = NULL;
+
+  if(pstClient->u32DelayMs == 0)
+  {
+    node_state_life_cycle_consumer_complete_lifecycle_request(pConsumer, pInvocation, (gint) NsmErrorStatus_Ok);
+    NSMRP__vRecordAnswer(pstClient);
+  }
+  else
+  {
+    node_state_life_cycle_consumer_complete_lifecycle_request(pConsumer, pInvocation, (gint) NsmErrorStatus_ResponsePending);
+
+    pstPending               = g_new(NSMRP__tstPendingRequest, 1);
+    pstPending->pstClient    = pstClient;
+    pstPending->u32RequestId = u32RequestId;
+    (void) g_timeout_add(pstClient->u32DelayMs, &NSMRP__boOnAnswerTimer, pstPending);
+  }
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function executes an event of the scenario and measures the latency of the call.
+*
+* @param pstEvent: Event to execute
+*
+* @return TRUE: The NSM accepted the call. FALSE: D-Bus or NSM error.
+*
+**********************************************************************************************************************/
+static gboolean NSMRP__boExecute(NSMRP__tstEvent *pstEvent)
+{
+  /* Function local variables                                                   */
+  gboolean          boRetVal      = FALSE;
+  gint64            i64Start      = 0;
+  gint64            i64Latency    = 0;
+  gchar            *sSessionKey   = NULL;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  GError           *pError        = NULL;
+
+  /* A shutdown is measured from the request on. Set the start, before the NSM can call the first client. */
+  if(   (pstEvent->enEvent == NSMRP__EVENT_NODESTATE)
+     && (   (pstEvent->ai32Args[0] == (gint) NsmNodeState_ShuttingDown)
+         || (pstEvent->ai32Args[0] == (gint) NsmNodeState_FastShutdown)))
+  {
+    g_atomic_int_set(&NSMRP__i32Answers, 0);
+    NSMRP__i64ShutdownStart = g_get_monotonic_time();
+    g_atomic_int_set(&NSMRP__i32ShutdownType,   (pstEvent->ai32Args[0] == (gint) NsmNodeState_ShuttingDown)
+                                              ? (gint) NSM_SHUTDOWNTYPE_NORMAL : (gint) NSM_SHUTDOWNTYPE_FAST);
+  }
+
+  i64Start = g_get_monotonic_time();
+
+  switch(pstEvent->enEvent)
+  {
+    case NSMRP__EVENT_NODESTATE:
+      (void) node_state_lifecycle_control_call_set_node_state_sync(NSMRP__pLifecycleControl,
+                                                                   pstEvent->ai32Args[0],
+                                                                   (gint*) &enErrorStatus,
+                                                                   NULL,
+                                                                   &pError);
+    break;
+
+    case NSMRP__EVENT_APPMODE:
+      (void) node_state_lifecycle_control_call_set_application_mode_sync(NSMRP__pLifecycleControl,
+                                                                         pstEvent->ai32Args[0],
+                                                                         (gint*) &enErrorStatus,
+                                                                         NULL,
+                                                                         &pError);
+    break;
+
+    case NSMRP__EVENT_SESSION:
+      sSessionKey = g_strdup_printf("%s %d", pstEvent->sName, pstEvent->ai32Args[0]);
+
+      if(   (pstEvent->ai32Args[1] == (gint) NsmSessionState_Unregistered)
+         && (g_hash_table_lookup(NSMRP__pPlatformSessions, sSessionKey) == NULL))
+      {
+        (void) node_state_consumer_call_un_register_session_sync(NSMRP__pConsumer,
+                                                                 pstEvent->sName,
+                                                                 pstEvent->sOwner,
+                                                                 pstEvent->ai32Args[0],
+                                                                 (gint*) &enErrorStatus,
+                                                                 NULL,
+                                                                 &pError);
+        (void) g_hash_table_remove(NSMRP__pSessions, sSessionKey);
+      }
+      else if(   (g_hash_table_lookup(NSMRP__pSessions,         sSessionKey) == NULL)
+              && (g_hash_table_lookup(NSMRP__pPlatformSessions, sSessionKey) == NULL))
+      {
+        (void) node_state_consumer_call_register_session_sync(NSMRP__pConsumer,
+                                                              pstEvent->sName,
+                                                              pstEvent->sOwner,
+                                                              pstEvent->ai32Args[0],
+                                                              pstEvent->ai32Args[1],
+                                                              (gint*) &enErrorStatus,
+                                                              NULL,
+                                                              &pError);
+        g_hash_table_insert(NSMRP__pSessions, g_strdup(sSessionKey), GINT_TO_POINTER(1));
+      }
+      else
+      {
+        (void) node_state_consumer_call_set_session_state_sync(NSMRP__pConsumer,
+                                                               pstEvent->sName,
+                                                               pstEvent->sOwner,
+                                                               pstEvent->ai32Args[0],
+                                                               pstEvent->ai32Args[1],
+                                                               (gint*) &enErrorStatus,
+                                                               NULL,
+                                                               &pError);
+      }
+
+      g_free(sSessionKey);
+    break;
+
+    case NSMRP__EVENT_APPHEALTH:
+      (void) node_state_lifecycle_control_call_set_app_health_status_sync(NSMRP__pLifecycleControl,
+                                                                          pstEvent->sName,
+                                                                          (pstEvent->ai32Args[0] != 0),
+                                                                          (gint*) &enErrorStatus,
+                                                                          NULL,
+                                                                          &pError);
+    break;
+
+    case NSMRP__EVENT_RESTART:
+      (void) node_state_lifecycle_control_call_request_node_restart_sync(NSMRP__pLifecycleControl,
+                                                                         pstEvent->ai32Args[0],
+                                                                         (guint) pstEvent->ai32Args[1],
+                                                                         (gint*) &enErrorStatus,
+                                                                         NULL,
+                                                                         &pError);
+    break;
+
+    case NSMRP__EVENT_CLIENT:
+      (void) node_state_consumer_call_register_shutdown_client_sync(NSMRP__pConsumer,
+                                                                    g_dbus_connection_get_unique_name(NSMRP__pConnection),
+                                                                    pstEvent->pstClient->sObjName,
+                                                                    pstEvent->pstClient->u32Mode,
+                                                                    pstEvent->pstClient->u32TimeoutMs,
+                                                                    (gint*) &enErrorStatus,
+                                                                    NULL,
+                                                                    &pError);
+    break;
+
+    default:
+      /* Unknown events are rejected by the parser */
+    break;
+  }
+
+  i64Latency = g_get_monotonic_time() - i64Start;
+  g_array_append_val(NSMRP__pLatencies, i64Latency);
+
+  if(pError == NULL)
+  {
+    boRetVal = (enErrorStatus == NsmErrorStatus_Ok);
+  }
+  else
+  {
+    g_error_free(pError);
+  }
+
+  if(boRetVal == FALSE)
+  {
+    NSMRP__u32Failed++;
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function compares two latencies for qsort.
+*
+**********************************************************************************************************************/
+static gint NSMRP__i32CompareLatency(const void *pA, const void *pB)
+{
+  gint64 i64A = *((const gint64*) pA);
+  gint64 i64B = *((const gint64*) pB);
+
+  return (i64A > i64B) - (i64A < i64B);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function returns a percentile of the sorted latencies.
+*
+* @param u32Percent: Percentile (0..100)
+*
+* @return Latency in us
+*
+**********************************************************************************************************************/
+static gint64 NSMRP__i64Percentile(guint u32Percent)
+{
+  gint64 i64RetVal = 0;
+  guint  u32Idx    = 0;
+
+  if(NSMRP__pLatencies->len > 0)
+  {
+    u32Idx    = (guint) (((guint64) (NSMRP__pLatencies->len - 1) * u32Percent) / 100);
+    i64RetVal = g_array_index(NSMRP__pLatencies, gint64, u32Idx);
+  }
+
+  return i64RetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function prints the results of the replay.
+*
+* @param i64DurationUs: Duration of the replay
+*
+**********************************************************************************************************************/
+static void NSMRP__vReport(gint64 i64DurationUs)
+{
+  guint u32Expected = 0;
+  guint u32ClientIdx = 0;
+  NSMRP__tstClient *pstClient = NULL;
+
+  qsort(NSMRP__pLatencies->data, NSMRP__pLatencies->len, sizeof(gint64), &NSMRP__i32CompareLatency);
+
+  printf("Events:            %u (%u failed)\n", NSMRP__pEvents->len, NSMRP__u32Failed);
+  printf("Speed:             %.1fx\n", NSMRP__dSpeed);
+  printf("Duration:          %" G_GINT64_FORMAT " ms\n", i64DurationUs / 1000);
+  printf("Throughput:        %.0f calls/s\n",
+         (i64DurationUs > 0) ? ((gdouble) NSMRP__pLatencies->len * G_USEC_PER_SEC / (gdouble) i64DurationUs) : 0.0);
+  printf("Latency:           p50 %" G_GINT64_FORMAT " / p90 %" G_GINT64_FORMAT " / p99 %" G_GINT64_FORMAT
+         " / max %" G_GINT64_FORMAT " us\n",
+         NSMRP__i64Percentile(50), NSMRP__i64Percentile(90), NSMRP__i64Percentile(99), NSMRP__i64Percentile(100));
+
+  if(g_atomic_int_get(&NSMRP__i32ShutdownType) != 0)
+  {
+    for(u32ClientIdx = 0; u32ClientIdx < NSMRP__pClients->len; u32ClientIdx++)
+    {
+      pstClient    = (NSMRP__tstClient*) g_ptr_array_index(NSMRP__pClients, u32ClientIdx);
+      u32Expected += ((pstClient->u32Mode & (guint) g_atomic_int_get(&NSMRP__i32ShutdownType)) != 0) ? 1 : 0;
+    }
+
+    printf("Shutdown:          %" G_GINT64_FORMAT " ms (%d of %u clients answered)\n",
+           (g_atomic_int_get(&NSMRP__i32Answers) > 0) ? ((NSMRP__i64LastAnswer - NSMRP__i64ShutdownStart) / 1000) : 0,
+           g_atomic_int_get(&NSMRP__i32Answers), u32Expected);
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function checks the result of the replay against the expectation passed on the command line. No call may have
+* failed and the NSM has to reach the expected NodeState. The NodeState is polled, because the NSM may set it after
+* the last client answered (e.g. "Shutdown" after "ShuttingDown").
+*
+* @return TRUE: No NodeState expected or the expectation is met. FALSE: A call failed or the NodeState differs.
+*
+**********************************************************************************************************************/
+static gboolean NSMRP__boCheckNodeState(void)
+{
+  /* Function local variables                                       */
+  gboolean          boRetVal      = TRUE;
+  gint64            i64Deadline   = 0;
+  NsmNodeState_e    enNodeState   = NsmNodeState_NotSet;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+
+  if(NSMRP__i32NodeState >= 0)
+  {
+    i64Deadline = g_get_monotonic_time() + NSMRP__STATE_TIMEOUT_US;
+
+    do
+    {
+      (void) node_state_consumer_call_get_node_state_sync(NSMRP__pConsumer,
+                                                          (gint*) &enNodeState,
+                                                          (gint*) &enErrorStatus,
+                                                          NULL,
+                                                          NULL);
+
+      if((gint) enNodeState != NSMRP__i32NodeState)
+      {
+        g_usleep(NSMRP__POLL_US);
+      }
+    } while(((gint) enNodeState != NSMRP__i32NodeState) && (g_get_monotonic_time() < i64Deadline));
+
+    boRetVal = (NSMRP__u32Failed == 0) && ((gint) enNodeState == NSMRP__i32NodeState);
+
+    printf("NodeState:         %d (expected %d)\n", (gint) enNodeState, NSMRP__i32NodeState);
+    printf("Result:            %s\n", (boRetVal == TRUE) ? "passed" : "failed");
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function replays the scenario in an own thread, while the main loop dispatches the lifecycle requests to the
+* clients. After the last event, it waits for the clients of a shutdown, prints the results, checks the expected
+* NodeState and quits the main loop.
+*
+* @param pUserData: Optionally user data (not used)
+*
+* @return NULL
+*
+**********************************************************************************************************************/
+static gpointer NSMRP__pvReplay(gpointer pUserData)
+{
+  /* Function local variables                                                  */
+  NSMRP__tstEvent  *pstEvent     = NULL;
+  NSMRP__tstClient *pstClient    = NULL;
+  guint             u32EventIdx  = 0;
+  guint             u32ClientIdx = 0;
+  guint             u32Expected  = 0;
+  gint64            i64Start     = 0;
+  gint64            i64Due       = 0;
+  gint64            i64Deadline  = 0;
+  gint64            i64Duration  = 0;
+
+  i64Start = g_get_monotonic_time();
+
+  for(u32EventIdx = 0; u32EventIdx < NSMRP__pEvents->len; u32EventIdx++)
+  {
+    pstEvent = (NSMRP__tstEvent*) g_ptr_array_index(NSMRP__pEvents, u32EventIdx);
+
+    /* Wait, until the event is due. Late events are replayed at once */
+    if(NSMRP__dSpeed > 0.0)
+    {
+      i64Due = i64Start + (gint64) ((gdouble) pstEvent->i64TimeUs / NSMRP__dSpeed);
+
+      if(i64Due > g_get_monotonic_time())
+      {
+        g_usleep((gulong) (i64Due - g_get_monotonic_time()));
+      }
+    }
+
+    (void) NSMRP__boExecute(pstEvent);
+  }
+
+  i64Duration = g_get_monotonic_time() - i64Start;
+
+  /* Wait for the clients of the shutdown. Every client may use its timeout */
+  if(g_atomic_int_get(&NSMRP__i32ShutdownType) != 0)
+  {
+    for(u32ClientIdx = 0; u32ClientIdx < NSMRP__pClients->len; u32ClientIdx++)
+    {
+      pstClient = (NSMRP__tstClient*) g_ptr_array_index(NSMRP__pClients, u32ClientIdx);
+
+      if((pstClient->u32Mode & (guint) g_atomic_int_get(&NSMRP__i32ShutdownType)) != 0)
+      {
+        u32Expected++;
+        i64Deadline += (gint64) MAX(pstClient->u32TimeoutMs, pstClient->u32DelayMs) * 1000;
+      }
+    }
+
+    i64Deadline += g_get_monotonic_time();
+
+    while(   (g_atomic_int_get(&NSMRP__i32Answers) < (gint) u32Expected)
+          && (g_get_monotonic_time() < i64Deadline))
+    {
+      g_usleep(NSMRP__POLL_US);
+    }
+
+    NSMRP__boPassed = (g_atomic_int_get(&NSMRP__i32Answers) >= (gint) u32Expected);
+  }
+  else
+  {
+    NSMRP__boPassed = TRUE;
+  }
+
+  NSMRP__vReport(i64Duration);
+  NSMRP__boPassed = (NSMRP__boCheckNodeState() == TRUE) && (NSMRP__boPassed == TRUE);
+  g_main_loop_quit(NSMRP__pMainLoop);
+
+  return NULL;
+}
+
+
+/**********************************************************************************************************************
+*
+* Main function of the replay executable.
+*
+* @return:  0: The scenario has been replayed, all clients of a shutdown answered and the expected NodeState is met
+*          -1: Invalid arguments or scenario, no connection to the NSM, a shutdown did not complete or the check failed
+*
+**********************************************************************************************************************/
+int main(int argc, char **argv)
+{
+  /* Function local variables                                                          */
+  int               iRetVal      = -1;
+  GThread          *pReplay      = NULL;
+  NSMRP__tstClient *pstClient    = NULL;
+  guint             u32ClientIdx = 0;
+  gboolean          boExported   = TRUE;
+  GError           *pError       = NULL;
+
+  /* Initialize types in order to use glib */
+  g_type_init();
+
+  NSMRP__pEvents           = g_ptr_array_new();
+  NSMRP__pClients          = g_ptr_array_new();
+  NSMRP__pSessions         = g_hash_table_new_full(&g_str_hash, &g_str_equal, &g_free, NULL);
+  NSMRP__pPlatformSessions = g_hash_table_new_full(&g_str_hash, &g_str_equal, &g_free, NULL);
+  NSMRP__pLatencies        = g_array_new(FALSE, FALSE, sizeof(gint64));
+
+  if(argc > 2)
+  {
+    NSMRP__dSpeed = strtod(argv[2], NULL);
+  }
+
+  if(argc > 3)
+  {
+    NSMRP__i32NodeState = (gint) strtol(argv[3], NULL, 10);
+  }
+
+  if(   (argc > 1)
+     && (NSMRP__dSpeed >= 0.0)
+     && (NSMRP__i32NodeState < (gint) NsmNodeState_Last)
+     && (NSMRP__boLoadScenario(argv[1]) == TRUE))
+  {
+    NSMRP__pConnection = g_bus_get_sync(NSM_BUS_TYPE, NULL, &pError);
+
+    if(pError == NULL)
+    {
+      NSMRP__pConsumer = node_state_consumer_proxy_new_sync(NSMRP__pConnection,
+                                                              G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES
+                                                            | G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
+                                                            NSM_BUS_NAME,
+                                                            NSM_CONSUMER_OBJECT,
+                                                            NULL,
+                                                            &pError);
+    }
+
+    if(pError == NULL)
+    {
+      NSMRP__pLifecycleControl = node_state_lifecycle_control_proxy_new_sync(NSMRP__pConnection,
+                                                                               G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES
+                                                                             | G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
+                                                                             NSM_BUS_NAME,
+                                                                             NSM_LIFECYCLE_OBJECT,
+                                                                             NULL,
+                                                                             &pError);
+    }
+
+    if(pError == NULL)
+    {
+      boExported = NSMRP__boLoadPlatformSessions();
+    }
+    else
+    {
+      printf("Error: Failed to connect to NSM. Error msg.: %s.\n", pError->message);
+      g_error_free(pError);
+    }
+
+    if(boExported == TRUE)
+    {
+      NSMRP__pMainLoop = g_main_loop_new(NULL, FALSE);
+
+      /* Export the clients. Their requests are dispatched by the main loop of this thread. */
+      for(u32ClientIdx = 0; (u32ClientIdx < NSMRP__pClients->len) && (boExported == TRUE); u32ClientIdx++)
+      {
+        pstClient            = (NSMRP__tstClient*) g_ptr_array_index(NSMRP__pClients, u32ClientIdx);
+        pstClient->pSkeleton = node_state_life_cycle_consumer_skeleton_new();
+
+        (void) g_signal_connect(pstClient->pSkeleton, "handle-lifecycle-request", G_CALLBACK(NSMRP__boOnLifecycleRequest), pstClient);
+
+        boExported = g_dbus_interface_skeleton_export(G_DBUS_INTERFACE_SKELETON(pstClient->pSkeleton),
+                                                      NSMRP__pConnection,
+                                                      pstClient->sObjName,
+                                                      NULL);
+      }
+
+      if(boExported == TRUE)
+      {
+        pReplay = g_thread_create(&NSMRP__pvReplay, NULL, TRUE, NULL);
+        g_main_loop_run(NSMRP__pMainLoop);
+        (void) g_thread_join(pReplay);
+
+        iRetVal = (NSMRP__boPassed == TRUE) ? 0 : -1;
+      }
+      else
+      {
+        printf("Error: Failed to export lifecycle clients.\n");
+      }
+
+      g_main_loop_unref(NSMRP__pMainLoop);
+    }
+  }
+  else
+  {
+    printf("Usage: %s <Scenario> [Speed] [NodeState]\n", argv[0]);
+  }
+
+  return iRetVal;
+}
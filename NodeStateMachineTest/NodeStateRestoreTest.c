@@ -0,0 +1,454 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the NodeStateRestoreTest.
+*
+* The file implements a test for the restore of the NodeStateManager after a crash. The test starts the NSM itself,
+* registers a product session and a lifecycle client for a seat and kills the NSM with SIGKILL. The restarted NSM
+* has to restore the session and the client from its snapshot: the session is still active and a shutdown of the
+* seat reaches the client.
+* Afterwards, the NSM is killed again and everything behind the header of the snapshot is overwritten with values out
+* of range. The restarted NSM has to start, answer calls and drop the invalid session and client.
+*
+* The test must be started, while no other NSM owns the bus name.
+*
+* Usage: NodeStateRestoreTest <NodeStateManager> [SnapshotFile]
+*
+* NodeStateManager: Path of the NSM executable
+* SnapshotFile:     Snapshot of the NSM (default NSMRT__DEFAULT_SNAPSHOT_FILE)
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+/* System header files                                                                          */
+#include <gio/gio.h>                    /* Use glib to access dbus and communicate to NSM       */
+#include <stdio.h>                      /* printf                                               */
+#include <string.h>                     /* memset                                               */
+#include <fcntl.h>                      /* open                                                 */
+#include <unistd.h>                     /* pwrite, close                                        */
+#include <signal.h>                     /* kill                                                 */
+#include <sys/stat.h>                   /* fstat                                                */
+#include <sys/wait.h>                   /* waitpid                                              */
+
+/* Header files offered by NSM                                                                  */
+#include "NodeStateTypes.h"             /* Know type definitions of NSM                         */
+
+/* Generated header files to access NSM via D-Bus                                               */
+#include "NodeStateConsumer.h"          /* Consumer interface with publicly available functions */
+#include "NodeStateLifecycleControl.h"  /* Control  interface to request the seat lifecycle     */
+#include "NodeStateLifecycleConsumer.h" /* Consumer interface to offer life cycle clients       */
+
+/* Own header files                                                                             */
+#include "NodeStateTestFixture.h"       /* Clients, registration and seat requests of the test  */
+
+
+/**********************************************************************************************************************
+*
+* Local defines, macros and type definitions.
+*
+**********************************************************************************************************************/
+
+/* Default snapshot of the NSM, if not passed on the command line */
+#define NSMRT__DEFAULT_SNAPSHOT_FILE "/run/NodeStateManager.snapshot"
+
+/* Magic, version and size at the start of the snapshot. They are kept, so that the NSM restores the invalid values */
+#define NSMRT__SNAPSHOT_HEADER_SIZE  (3 * sizeof(guint32))
+
+/* Value written behind the header. As signed 32 bit value, it is out of the range of every enumeration */
+#define NSMRT__INVALID_BYTE          0xA5
+
+/* Seat, session and objects used by the test */
+#define NSMRT__SEAT                  NsmSeat_Rear2
+#define NSMRT__SESSION_NAME          "NodeStateRestoreTest"
+#define NSMRT__SESSION_OWNER         "NodeStateRestoreTest"
+#define NSMRT__CLIENT_OBJECT         "/org/genivi/NodeStateRestoreTest/Client%u"
+#define NSMRT__CLIENT_TIMEOUT_MS     1000
+
+/* Max. time the NSM may need to start, time for the asynchronous restore of the clients and poll interval */
+#define NSMRT__START_TIMEOUT_US      5000000
+#define NSMRT__RESTORE_US            500000
+#define NSMRT__POLL_US               10000
+
+
+/**********************************************************************************************************************
+*
+* Prototypes for file local functions (see implementation for description)
+*
+**********************************************************************************************************************/
+
+static gboolean NSMRT__boStartNsm           (void);
+static void     NSMRT__vStopNsm             (const gint                  i32Signal);
+static gboolean NSMRT__boCheckSession       (NodeStateConsumer          *pConsumer);
+static gint     NSMRT__i32ShutdownSeat      (NSMTF_tstFixture           *pstFixture,
+                                             NodeStateLifecycleControl  *pLifecycleControl);
+static gboolean NSMRT__boInvalidateSnapshot (void);
+static gboolean NSMRT__boTestRestore        (NSMTF_tstFixture           *pstFixture);
+static gboolean NSMRT__boTestInvalidValues  (NSMTF_tstFixture           *pstFixture);
+static gboolean NSMRT__boRunTest            (NSMTF_tstFixture           *pstFixture);
+
+
+/**********************************************************************************************************************
+*
+* Local variables
+*
+**********************************************************************************************************************/
+
+static const gchar      *NSMRT__sNsmPath       = NULL;
+static const gchar      *NSMRT__sSnapshotFile  = NSMRT__DEFAULT_SNAPSHOT_FILE;
+static GPid              NSMRT__pidNsm         = 0;
+
+/* Session and lifecycle client of the test seat */
+static NSMTF_tstFixture  NSMRT__stFixture      = {NSMRT__SEAT,
+                                                  NSMRT__SESSION_NAME,
+                                                  NSMRT__SESSION_OWNER,
+                                                  NSMRT__CLIENT_OBJECT,
+                                                  1,
+                                                  NSMRT__CLIENT_TIMEOUT_MS,
+                                                  NULL, NULL, NULL, 0};
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function starts the NSM and waits, until it answers calls. Afterwards, it waits NSMRT__RESTORE_US, so that the
+* NSM can check the bus names of the restored clients.
+*
+* @return TRUE: The NSM answers. FALSE: The NSM could not be started or did not answer in time.
+*
+**********************************************************************************************************************/
+static gboolean NSMRT__boStartNsm(void)
+{
+  /* Function local variables                                     */
+  gboolean  boRetVal    = FALSE;
+  gchar    *asArgv[2]   = {NULL, NULL};
+  gint64    i64Deadline = 0;
+  GVariant *pReply      = NULL;
+  GError   *pError      = NULL;
+
+  asArgv[0] = (gchar*) NSMRT__sNsmPath;
+
+  if(g_spawn_async(NULL,
+                   asArgv,
+                   NULL,
+                     G_SPAWN_DO_NOT_REAP_CHILD
+                   | G_SPAWN_STDOUT_TO_DEV_NULL
+                   | G_SPAWN_STDERR_TO_DEV_NULL,
+                   NULL,
+                   NULL,
+                   &NSMRT__pidNsm,
+                   &pError) == TRUE)
+  {
+    i64Deadline = g_get_monotonic_time() + NSMRT__START_TIMEOUT_US;
+
+    do
+    {
+      g_usleep(NSMRT__POLL_US);
+
+      pReply = g_dbus_connection_call_sync(NSMRT__stFixture.pConnection,
+                                           NSM_BUS_NAME,
+                                           NSM_CONSUMER_OBJECT,
+                                           "org.genivi.NodeStateManager.Consumer",
+                                           "GetNodeState",
+                                           NULL,
+                                           G_VARIANT_TYPE("(ii)"),
+                                           G_DBUS_CALL_FLAGS_NO_AUTO_START,
+                                           -1,
+                                           NULL,
+                                           NULL);
+    } while((pReply == NULL) && (g_get_monotonic_time() < i64Deadline));
+
+    if(pReply != NULL)
+    {
+      g_variant_unref(pReply);
+      g_usleep(NSMRT__RESTORE_US);
+      boRetVal = TRUE;
+    }
+    else
+    {
+      printf("Error: The NSM did not answer after its start.\n");
+    }
+  }
+  else
+  {
+    printf("Error: Failed to start NSM. Error msg.: %s.\n", pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function stops the NSM started by the test and waits for its end.
+*
+* @param i32Signal: SIGKILL to simulate a crash (the snapshot is kept) or SIGTERM to stop the NSM on purpose
+*
+**********************************************************************************************************************/
+static void NSMRT__vStopNsm(const gint i32Signal)
+{
+  if(NSMRT__pidNsm != 0)
+  {
+    (void) kill(NSMRT__pidNsm, i32Signal);
+    (void) waitpid(NSMRT__pidNsm, NULL, 0);
+    g_spawn_close_pid(NSMRT__pidNsm);
+    NSMRT__pidNsm = 0;
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function checks, whether the NSM knows the test session as active session.
+*
+* @param pConsumer: Proxy of the Consumer interface
+*
+* @return TRUE: The session is active. FALSE: The session is unknown or has another state.
+*
+**********************************************************************************************************************/
+static gboolean NSMRT__boCheckSession(NodeStateConsumer *pConsumer)
+{
+  NsmSessionState_e enSessionState = NsmSessionState_Unregistered;
+  NsmErrorStatus_e  enErrorStatus  = NsmErrorStatus_NotSet;
+
+  (void) node_state_consumer_call_get_session_state_sync(pConsumer,
+                                                         NSMRT__SESSION_NAME,
+                                                         (gint) NSMRT__SEAT,
+                                                         (gint*) &enSessionState,
+                                                         (gint*) &enErrorStatus,
+                                                         NULL,
+                                                         NULL);
+
+  return (enErrorStatus == NsmErrorStatus_Ok) && (enSessionState == NsmSessionState_Active);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function shuts down the test seat, counts the calls of the client and runs the seat up again.
+*
+* @param pstFixture:        Fixture of the test
+* @param pLifecycleControl: Proxy of the LifecycleControl interface
+*
+* @return Number of calls the client received for the shutdown
+*
+**********************************************************************************************************************/
+static gint NSMRT__i32ShutdownSeat(NSMTF_tstFixture *pstFixture, NodeStateLifecycleControl *pLifecycleControl)
+{
+  gint i32Calls = 0;
+
+  (void) NSMTF_boRequestSeat(pstFixture, pLifecycleControl, NSM_SHUTDOWNTYPE_NORMAL, NULL);
+  i32Calls = g_atomic_int_get(&pstFixture->i32Requests);
+
+  /* Wait until the NSM finished the sequence. Then run the seat up again */
+  g_usleep(NSMRT__RESTORE_US);
+  (void) NSMTF_boRequestSeat(pstFixture, pLifecycleControl, NSM_SHUTDOWNTYPE_RUNUP, NULL);
+  g_usleep(NSMRT__RESTORE_US);
+
+  return i32Calls;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function overwrites everything behind the header of the snapshot with NSMRT__INVALID_BYTE. The seats, states and
+* the NodeState in the file are then out of their ranges, while magic, version and size are still valid.
+*
+* @return TRUE: The snapshot has been overwritten. FALSE: Error.
+*
+**********************************************************************************************************************/
+static gboolean NSMRT__boInvalidateSnapshot(void)
+{
+  /* Function local variables                         */
+  gboolean     boRetVal = FALSE;
+  gint         i32Fd    = -1;
+  guint8      *pu8Data  = NULL;
+  gsize        u32Size  = 0;     /* Bytes behind header */
+  struct stat  stStat;
+
+  i32Fd = open(NSMRT__sSnapshotFile, O_WRONLY);
+
+  if((i32Fd >= 0) && (fstat(i32Fd, &stStat) == 0) && (stStat.st_size > (off_t) NSMRT__SNAPSHOT_HEADER_SIZE))
+  {
+    u32Size = (gsize) stStat.st_size - NSMRT__SNAPSHOT_HEADER_SIZE;
+    pu8Data = g_malloc(u32Size);
+    memset(pu8Data, NSMRT__INVALID_BYTE, u32Size);
+
+    boRetVal = (pwrite(i32Fd, pu8Data, u32Size, NSMRT__SNAPSHOT_HEADER_SIZE) == (ssize_t) u32Size);
+
+    g_free(pu8Data);
+  }
+
+  if(i32Fd >= 0)
+  {
+    (void) close(i32Fd);
+  }
+
+  if(boRetVal == FALSE)
+  {
+    printf("Error: Failed to overwrite snapshot %s.\n", NSMRT__sSnapshotFile);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function tests the restore after a crash. The session and client registered at the first NSM have to be
+* known by the restarted NSM.
+*
+* @param pstFixture: Fixture of the test
+*
+* @return TRUE: Session and client have been restored. FALSE: Error.
+*
+**********************************************************************************************************************/
+static gboolean NSMRT__boTestRestore(NSMTF_tstFixture *pstFixture)
+{
+  /* Function local variables                                            */
+  gboolean                   boRetVal          = FALSE;
+  gboolean                   boSession         = FALSE; /* Session kept */
+  gint                       i32Calls          = 0;     /* Client kept  */
+  NodeStateConsumer         *pConsumer         = NULL;
+  NodeStateLifecycleControl *pLifecycleControl = NULL;
+
+  if(   (NSMRT__boStartNsm()                                                   == TRUE)
+     && (NSMTF_boCreateProxies(pstFixture, &pConsumer, &pLifecycleControl) == TRUE)
+     && (NSMTF_boRegister(pstFixture, pConsumer)                          == TRUE))
+  {
+    NSMTF_vFreeProxies(&pConsumer, &pLifecycleControl);
+    NSMRT__vStopNsm(SIGKILL);
+
+    if(   (NSMRT__boStartNsm()                                                   == TRUE)
+       && (NSMTF_boCreateProxies(pstFixture, &pConsumer, &pLifecycleControl) == TRUE))
+    {
+      boSession = NSMRT__boCheckSession(pConsumer);
+      i32Calls  = NSMRT__i32ShutdownSeat(pstFixture, pLifecycleControl);
+      boRetVal  = (boSession == TRUE) && (i32Calls == 1);
+
+      printf("Restore:        session %s, client calls %d -> %s\n",
+             (boSession == TRUE) ? "kept" : "lost", i32Calls, (boRetVal == TRUE) ? "passed" : "failed");
+    }
+  }
+
+  NSMTF_vFreeProxies(&pConsumer, &pLifecycleControl);
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function tests the restore of a snapshot with invalid values. The NSM has to start and drop session and client.
+*
+* @param pstFixture: Fixture of the test
+*
+* @return TRUE: The NSM runs and dropped session and client. FALSE: Error.
+*
+**********************************************************************************************************************/
+static gboolean NSMRT__boTestInvalidValues(NSMTF_tstFixture *pstFixture)
+{
+  /* Function local variables                                              */
+  gboolean                   boRetVal          = FALSE;
+  gboolean                   boSession         = TRUE;  /* Session kept  */
+  gint                       i32Calls          = -1;    /* Client kept   */
+  NodeStateConsumer         *pConsumer         = NULL;
+  NodeStateLifecycleControl *pLifecycleControl = NULL;
+
+  NSMRT__vStopNsm(SIGKILL);
+
+  if(   (NSMRT__boInvalidateSnapshot()                                         == TRUE)
+     && (NSMRT__boStartNsm()                                                   == TRUE)
+     && (NSMTF_boCreateProxies(pstFixture, &pConsumer, &pLifecycleControl) == TRUE))
+  {
+    boSession = NSMRT__boCheckSession(pConsumer);
+    i32Calls  = NSMRT__i32ShutdownSeat(pstFixture, pLifecycleControl);
+    boRetVal  = (boSession == FALSE) && (i32Calls <= 0);
+
+    printf("Invalid values: session %s, client calls %d -> %s\n",
+           (boSession == TRUE) ? "kept" : "dropped", i32Calls, (boRetVal == TRUE) ? "passed" : "failed");
+  }
+
+  NSMTF_vFreeProxies(&pConsumer, &pLifecycleControl);
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function runs the test. It is called by NSMTF_boRun in an own thread, while the main loop dispatches the
+* lifecycle requests to the client. Afterwards, the NSM is stopped on purpose.
+*
+* @param pstFixture: Fixture of the test
+*
+* @return TRUE: The NSM restored its state and dropped invalid values. FALSE: A check failed.
+*
+**********************************************************************************************************************/
+static gboolean NSMRT__boRunTest(NSMTF_tstFixture *pstFixture)
+{
+  gboolean boPassed = FALSE;
+
+  boPassed =    (NSMRT__boTestRestore(pstFixture)       == TRUE)
+             && (NSMRT__boTestInvalidValues(pstFixture) == TRUE);
+
+  NSMRT__vStopNsm(SIGTERM);
+
+  printf("Result:         %s\n", (boPassed == TRUE) ? "passed" : "failed");
+
+  return boPassed;
+}
+
+
+/**********************************************************************************************************************
+*
+* Main function of the restore test executable.
+*
+* @return:  0: The NSM restored its state and dropped invalid values
+*          -1: Invalid arguments, no bus connection or a check failed
+*
+**********************************************************************************************************************/
+int main(int argc, char **argv)
+{
+  /* Function local variables                    */
+  int iRetVal = -1;
+
+  /* Initialize types in order to use glib */
+  g_type_init();
+
+  if(argc > 1)
+  {
+    NSMRT__sNsmPath = argv[1];
+
+    if(argc > 2)
+    {
+      NSMRT__sSnapshotFile = argv[2];
+    }
+
+    iRetVal = (NSMTF_boRun(&NSMRT__stFixture, &NSMRT__boRunTest) == TRUE) ? 0 : -1;
+  }
+  else
+  {
+    printf("Usage: %s <NodeStateManager> [SnapshotFile]\n", argv[0]);
+  }
+
+  return iRetVal;
+}
@@ -108,6 +108,28 @@ typedef struct
   gchar* sObjName; /* Object name of the LifecycleClient that should be created */
 } NSMTST__tstTestCreateLifecycleClientParam;
 
+/*
+ * Configures parameters for the latency test with a slow NSMC. A BootMode is set, while the NSMC is delayed.
+ * Meanwhile, the ApplicationMode is queried and the latency of the query is checked.
+ */
+typedef struct
+{
+  gint  i32BootMode;     /* BootMode set via D-Bus while the NSMC is slow   */
+  guint u32NsmcDelayMs;  /* Delay of the test NSMC for NsmcSetData in ms    */
+  guint u32MaxLatencyMs; /* Maximum accepted latency of the query in ms     */
+} NSMTST__tstTestSlowNsmcLatencyParam;
+
+/*
+ * Configures parameters for the query benchmark. For each sample, the NSM core is loaded with a slow NSMC call.
+ * The NodeState then is queried via the Consumer interface (D-Bus thread) and via the test NSMC (core context).
+ */
+typedef struct
+{
+  guint u32NsmcDelayMs;  /* Delay of the test NSMC for NsmcSetData in ms       */
+  guint u32Samples;      /* Number of queries per path                         */
+  guint u32MaxP99Ms;     /* Maximum accepted p99 latency of the Consumer query */
+} NSMTST__tstTestQueryBenchmarkParam;
+
 /* Configures parameters for calling the (internal) NsmSetData interface of the NSM with invalid data types. */
 typedef struct
 {
@@ -159,6 +181,22 @@ typedef struct
   gint  i32BootMode; /* BootMode to be set                   */
 } NSMTST__tstSmSetBootModeParam;
 
+/* Configure parameters for setting several values in one batch using the (internal) NsmSetDataBatch interface. */
+typedef struct
+{
+  NsmShutdownReason_e  enShutdownReason;  /* ShutdownReason to be set  */
+  gint                 i32BootMode;       /* BootMode to be set        */
+  NsmApplicationMode_e enApplicationMode; /* ApplicationMode to be set */
+} NSMTST__tstSmSetDataBatchParam;
+
+/* Configure parameters for a session subscription of the test NSMC (NsmSubscribe interface). */
+typedef struct
+{
+  gchar     sSessionName[NSM_MAX_SESSION_NAME_LENGTH]; /* Session to subscribe and to change             */
+  NsmSeat_e enSubscribedSeat;                          /* Seat of the subscription                        */
+  NsmSeat_e enOtherSeat;                               /* Seat, whose change must not call the subscriber */
+} NSMTST__tstSmSubscribeSessionParam;
+
 /* Configure the parameters for getting different values of the NSM via the (internal) NsmGetData interface */
 typedef struct
 {
@@ -187,6 +225,23 @@ typedef struct
   guint  u32Timeout; /* Timeout for shutdown        */
 } NSMTST__tstDbRegisterShutdownClientParam;
 
+/* Configures parameters for calling the RegisterSeatShutdownClient D-Bus interface of the NSM. */
+typedef struct
+{
+  gchar     *sObjName;   /* Object name                 */
+  guint      u32Mode;    /* Registered shutdown mode(s) */
+  guint      u32Timeout; /* Timeout for shutdown        */
+  NsmSeat_e  enSeat;     /* Seat of the client          */
+} NSMTST__tstDbRegisterSeatShutdownClientParam;
+
+/* Configures parameters for calling the RegisterLoadSheddingClient D-Bus interface of the NSM. */
+typedef struct
+{
+  gchar *sObjName;     /* Object name                 */
+  guint  u32ShedLevel; /* Level in which client shed  */
+  guint  u32Timeout;   /* Timeout for shutdown        */
+} NSMTST__tstDbRegisterLoadSheddingClientParam;
+
 /* Configures parameters for calling the UnRegisterLifecycleClient D-Bus interface of the NSM. */
 typedef struct
 {
@@ -201,6 +256,13 @@ typedef struct
   guint              u32RestartType;  /* RestartType. E.g. NSM_NORMAL_SHUTDOWN */
 } NSMTST__tstDbRequestNodeRestartParam;
 
+/* Configures parameters for calling the RequestSeatLifecycle D-Bus interface of the NSM. */
+typedef struct
+{
+  NsmSeat_e enSeat;         /* Seat whose clients should be informed   */
+  guint     u32RequestType; /* Request type. E.g. NSM_SHUTDOWNTYPE_RUNUP */
+} NSMTST__tstDbRequestSeatLifecycleParam;
+
 /* Configures parameters for calling the SetAppHealthStatus D-Bus interface of the NSM. */
 typedef struct
 {
@@ -220,6 +282,20 @@ typedef struct
   NsmNodeState_e enNodeState; /* NodeState to be set */
 } NSMTST__tstDbSetNodeStateParam;
 
+/* Configures parameters for calling the GetStatistics D-Bus interface of the NSM. */
+typedef struct
+{
+  gboolean     boReset; /* Flag if the statistics should be reset after reading */
+  const gchar *sName;   /* Name of the statistics entry that is checked          */
+} NSMTST__tstDbGetStatisticsParam;
+
+/* Configures parameters for calling the WaitForNodeState D-Bus interface of the NSM. The call is made async. */
+typedef struct
+{
+  guint u32NodeStateMask; /* NSM_NODESTATE_MASK bits of the states to wait for */
+  guint u32TimeoutMs;     /* Max. time to wait                                 */
+} NSMTST__tstDbWaitForNodeStateParam;
+
 /* Configures parameters for setting the ApplicationMode using the D-Bus SetApplicationMode interface of the NSM. */
 typedef struct
 {
@@ -271,12 +347,16 @@ typedef union
   /* Parameters for internal functions that control the test */
   NSMTST__tstTestDummyParam                   stTestDummy;
   NSMTST__tstTestCreateLifecycleClientParam   stTestCreateLcClient;
+  NSMTST__tstTestSlowNsmcLatencyParam         stTestSlowNsmcLatency;
+  NSMTST__tstTestQueryBenchmarkParam          stTestQueryBenchmark;
 
   /* Parameters to control callback functions, which occur because of NSM signals */
   NSMTST__tstTestProcessLifecycleRequestParam stTestProcessLifecycleRequest;
 
   /* Parameters for D-Bus interfaces of the NSM */
   NSMTST__tstDbSetNodeStateParam              stDbSetNodeState;
+  NSMTST__tstDbWaitForNodeStateParam          stDbWaitForNodeState;
+  NSMTST__tstDbGetStatisticsParam             stDbGetStatistics;
   NSMTST__tstDbSetApplicationModeParam        stDbSetApplicationMode;
   NSMTST__tstDbSetBootModeParam               stDbSetBootMode;
   NSMTST__tstDbGetSessionStateParam           stDbGetSessionState;
@@ -288,6 +368,9 @@ typedef union
   NSMTST__tstDbRegisterShutdownClientParam    stDbRegisterShutdownClient;
   NSMTST__tstDbUnRegisterShutdownClientParam  stDbUnRegisterShutdownClient;
   NSMTST__tstDbRequestNodeRestartParam        stDbRequestNodeRestart;
+  NSMTST__tstDbRegisterSeatShutdownClientParam stDbRegisterSeatShutdownClient;
+  NSMTST__tstDbRequestSeatLifecycleParam      stDbRequestSeatLifecycle;
+  NSMTST__tstDbRegisterLoadSheddingClientParam stDbRegisterLoadSheddingClient;
 
   NSMTST__tstDbLifecycleRequestCompleteParam  stDbLifecycleRequestComplete;
 
@@ -300,6 +383,8 @@ typedef union
   NSMTST__tstSmUnRegisterSessionParam         stSmUnRegisterSession;
   NSMTST__tstSmSetShutdownReasonParam         stSmSetShutdownReason;
   NSMTST__tstSmSetBootModeParam               stSmSetBootMode;
+  NSMTST__tstSmSetDataBatchParam              stSmSetDataBatch;
+  NSMTST__tstSmSubscribeSessionParam          stSmSubscribeSession;
 
   NSMTST__tstSmGetBootModeParam               stSmGetBootMode;
   NSMTST__tstSmGetRestartReasonParam          stSmGetRestartReason;
@@ -366,6 +451,20 @@ typedef struct
   gint i32BootMode;     /* BootMode returned by NSM        */
 } NSMTST__tstSmGetBootModeReturn;
 
+/* Configures expected return values when setting a batch via the internal NsmSetDataBatch interface. */
+typedef struct
+{
+  NsmErrorStatus_e    enErrorStatus;    /* ErrorStatus returned by NSM                      */
+  NsmShutdownReason_e enShutdownReason; /* ShutdownReason read back by NsmGetDataMulti      */
+  gint                i32BootMode;      /* BootMode read back from the same snapshot        */
+} NSMTST__tstSmSetDataBatchReturn;
+
+/* Configures expected return values of a session subscription of the test NSMC. */
+typedef struct
+{
+  guint u32Calls; /* Expected calls of the session callback */
+} NSMTST__tstSmSubscribeSessionReturn;
+
 /* Configures expected return values when getting a RunningReason via the internal NsmGetData interface. */
 typedef struct
 {
@@ -424,6 +523,18 @@ typedef struct
   NsmApplicationMode_e enApplicationMode; /* ApplicationMode returned by NSM */
 } NSMTST__tstDbGetApplicationModeReturn;
 
+/* Configures the expected value of the NodeState property of the Consumer interface. */
+typedef struct
+{
+  NsmNodeState_e enNodeState; /* NodeState cached by the proxy */
+} NSMTST__tstDbGetNodeStatePropertyReturn;
+
+/* Configures the expected value of the ApplicationMode property of the Consumer interface. */
+typedef struct
+{
+  NsmApplicationMode_e enApplicationMode; /* ApplicationMode cached by the proxy */
+} NSMTST__tstDbGetApplicationModePropertyReturn;
+
 /*
  * Configures expected return values when getting the interface version using the internal
  * NsmGetInterfaceVersion interface and the GetInterfaceVersion D-Bus interface of the NSM.
@@ -440,6 +551,20 @@ typedef struct
   guint u32AppHealthCount; /* Number fo failed applications returned by NSM */
 } NSMTST__tstDbGetAppHealthCountReturn;
 
+/* Configures expected return values when calling the GetStatistics D-Bus interface of the NSM. */
+typedef struct
+{
+  NsmErrorStatus_e enErrorStatus; /* ErrorStatus returned by NSM                    */
+  gboolean         boCalled;      /* Flag if calls are counted for the checked entry */
+} NSMTST__tstDbGetStatisticsReturn;
+
+/* Configures expected return values when calling the GetClientStatistics D-Bus interface of the NSM. */
+typedef struct
+{
+  NsmErrorStatus_e enErrorStatus; /* ErrorStatus returned by NSM                          */
+  gboolean         boFound;       /* Flag if the test client is listed with admitted calls */
+} NSMTST__tstDbGetClientStatisticsReturn;
+
 /*  Configures expected return value when calling different interface of the NSM. */
 typedef struct
 {
@@ -452,6 +577,9 @@ typedef struct
   NSMTST__tstDbRequestNodeRestartReturn,
   NSMTST__tstDbRegisterShutdownClientReturn,
   NSMTST__tstDbUnRegisterShutdownClientReturn,
+  NSMTST__tstDbRegisterSeatShutdownClientReturn,
+  NSMTST__tstDbRequestSeatLifecycleReturn,
+  NSMTST__tstDbRegisterLoadSheddingClientReturn,
   NSMTST__tstDbRegisterSessionReturn,
   NSMTST__tstDbUnRegisterSessionReturn,
   NSMTST__tstSmSetBootModeReturn,
@@ -480,6 +608,14 @@ typedef struct
   NsmNodeState_e enNodeState; /* NodeState that is expected           */
 } NSMTST__tstCheckNodeStateSignal;
 
+/* Configures the expected values for the return of an async. WaitForNodeState call. */
+typedef struct
+{
+  gboolean         boReceived;    /* Flag if the call is expected to be returned */
+  NsmErrorStatus_e enErrorStatus; /* ErrorStatus returned by NSM                 */
+  NsmNodeState_e   enNodeState;   /* NodeState returned by NSM                   */
+} NSMTST__tstCheckWaitForNodeState;
+
 /* Configures the expected values for the reception of the ApplicationMode signal send by the NSM. */
 typedef struct
 {
@@ -508,6 +644,8 @@ typedef union
 
   NSMTST__tstDbGetNodeStateReturn               stDbGetNodeState;
   NSMTST__tstDbGetApplicationModeReturn         stDbGetApplicationMode;
+  NSMTST__tstDbGetNodeStatePropertyReturn       stDbGetNodeStateProperty;
+  NSMTST__tstDbGetApplicationModePropertyReturn stDbGetApplicationModeProperty;
   NSMTST__tstDbGetBootModeReturn                stDbGetBootMode;
   NSMTST__tstDbGetShutdownReasonReturn          stDbGetShutdownReason;
   NSMTST__tstDbGetRunningReasonReturn           stDbGetRunningReason;
@@ -522,12 +660,19 @@ typedef union
   NSMTST__tstDbRegisterShutdownClientReturn     stDbRegisterShutdownClient;
   NSMTST__tstDbUnRegisterShutdownClientReturn   stDbUnRegisterShutdownClient;
   NSMTST__tstDbRequestNodeRestartReturn         stDbRequestNodeRestart;
+  NSMTST__tstDbRegisterSeatShutdownClientReturn stDbRegisterSeatShutdownClient;
+  NSMTST__tstDbRequestSeatLifecycleReturn       stDbRequestSeatLifecycle;
+  NSMTST__tstDbRegisterLoadSheddingClientReturn stDbRegisterLoadSheddingClient;
   NSMTST__tstDbGetInterfaceVersionReturn        stDbGetInterfaceVersion;
+  NSMTST__tstDbGetStatisticsReturn              stDbGetStatistics;
+  NSMTST__tstDbGetClientStatisticsReturn        stDbGetClientStatistics;
   NSMTST__tstTestLifecycleRequestCompleteReturn stDbLifecycleRequestComplete;
 
   /* Expected return values for NSMC interfaces of the NSM */
   NSMTST__tstSmSetShutdownModeReturn            stSmSetShutdownReason;
   NSMTST__tstSmSetBootModeReturn                stSmSetBootMode;
+  NSMTST__tstSmSetDataBatchReturn               stSmSetDataBatch;
+  NSMTST__tstSmSubscribeSessionReturn           stSmSubscribeSession;
   NSMTST__tstSmSetNodeStateReturn               stSmSetNodeState;
   NSMTST__tstSmSetApplicationModeReturn         stSmSetApplicationMode;
   NSMTST__tstSmSetInvalidDataReturn             stSmSetInvalidData;
@@ -549,6 +694,7 @@ typedef union
   /* Expected signals send by NSM */
   NSMTST__tstCheckSessionSignal                 stCheckSessionSignal;
   NSMTST__tstCheckNodeStateSignal               stCheckNodeStateSignal;
+  NSMTST__tstCheckWaitForNodeState              stCheckWaitForNodeState;
   NSMTST__tstCheckApplicationMode               stCheckApplicationModeSignal;
 } NSMTST__tunReturnValues;
 
@@ -575,6 +721,8 @@ static gboolean NSMTST__boTestCreateNodeStateMachineProxy(void);
 static gboolean NSMTST__boTestRegisterCallbacks          (void);
 static gboolean NSMTST__boTestCreateLcClient             (void);
 static gboolean NSMTST__boTestProcessLifecycleRequest    (void);
+static gboolean NSMTST__boTestSlowNsmcLatency            (void);
+static gboolean NSMTST__boTestQueryBenchmark             (void);
 
 /* Functions to call D-Bus interfaces of the NSM */
 static gboolean NSMTST__boDbSetBootMode                  (void);
@@ -585,6 +733,9 @@ static gboolean NSMTST__boDbSetSessionState              (void);
 static gboolean NSMTST__boDbGetBootMode                  (void);
 static gboolean NSMTST__boDbGetApplicationMode           (void);
 static gboolean NSMTST__boDbGetNodeState                 (void);
+static gboolean NSMTST__boDbGetNodeStateProperty         (void);
+static gboolean NSMTST__boDbGetApplicationModeProperty   (void);
+static gboolean NSMTST__boDbWaitForNodeState             (void);
 static gboolean NSMTST__boDbGetSessionState              (void);
 static gboolean NSMTST__boDbGetRestartReason             (void);
 static gboolean NSMTST__boDbGetShutdownReason            (void);
@@ -597,7 +748,12 @@ static gboolean NSMTST__boDbRegisterShutdownClient       (void);
 static gboolean NSMTST__boDbUnRegisterShutdownClient     (void);
 static gboolean NSMTST__boDbGetAppHealthCount            (void);
 static gboolean NSMTST__boDbGetInterfaceVersion          (void);
+static gboolean NSMTST__boDbGetStatistics                (void);
+static gboolean NSMTST__boDbGetClientStatistics          (void);
 static gboolean NSMTST__boDbRequestNodeRestart           (void);
+static gboolean NSMTST__boDbRegisterSeatShutdownClient   (void);
+static gboolean NSMTST__boDbRequestSeatLifecycle         (void);
+static gboolean NSMTST__boDbRegisterLoadSheddingClient   (void);
 static gboolean NSMTST__boDbSetAppHealthStatus           (void);
 static gboolean NSMTST__boDbLifecycleRequestComplete     (void);
 
@@ -609,6 +765,8 @@ static gboolean NSMTST__boSmRegisterSession              (void);
 static gboolean NSMTST__boSmUnRegisterSession            (void);
 static gboolean NSMTST__boSmSetShutdownReason            (void);
 static gboolean NSMTST__boSmSetBootMode                  (void);
+static gboolean NSMTST__boSmSetDataBatch                 (void);
+static gboolean NSMTST__boSmSubscribeSession             (void);
 static gboolean NSMTST__boSmSetInvalidData               (void);
 
 static gboolean NSMTST__boSmGetApplicationMode           (void);
@@ -626,9 +784,11 @@ static gboolean NSMTST__boSmGetInterfaceVersion          (void);
 static gboolean NSMTST__boCheckSessionSignal             (void);
 static gboolean NSMTST__boCheckNodeStateSignal           (void);
 static gboolean NSMTST__boCheckApplicationModeSignal     (void);
+static gboolean NSMTST__boCheckWaitForNodeState          (void);
 
 /* Internal HelperFunctions */
 static GVariant* NSMTST__pPrepareStateMachineData(guchar *pDataArray, const guint32 u32ArraySize);
+static gint      NSMTST__i32LatencyCompare       (gconstpointer pL1, gconstpointer pL2, gpointer pUserData);
 
 /* Internal callback functions to process signals */
 static gboolean NSMTST__boOnSessionSignal(NodeStateConsumer *pObject,
@@ -645,6 +805,11 @@ static gboolean NSMTST__boOnNodeStateSignal(NodeStateConsumer *pObject,
                                             const gint         i32NodeState,
                                             gpointer           pUserData);
 
+/* Internal callback function to process the async. return of WaitForNodeState */
+static void NSMTST__vOnWaitForNodeStateFinish(GObject      *pSrcObject,
+                                              GAsyncResult *pRes,
+                                              gpointer      pUserData);
+
 static gboolean NSMTST__boOnLifecycleClientCb(NodeStateLifeCycleConsumer *pConsumer,
                                               GDBusMethodInvocation      *pInvocation,
                                               const guint32               u32LifeCycleRequest,
@@ -676,6 +841,7 @@ static NodeStateTest                   *NSMTST__pNodeStateMachine         = NULL
 static NSMTST__tstCheckSessionSignal    NSMTST__stReceivedSessionSignal   = {0};
 static NSMTST__tstCheckNodeStateSignal  NSMTST__stReceivedNodeStateSignal = {0};
 static NSMTST__tstCheckApplicationMode  NSMTST__stApplicationModeSignal   = {0};
+static NSMTST__tstCheckWaitForNodeState NSMTST__stWaitForNodeState        = {0};
 
 static NodeStateLifeCycleConsumer      *NSMTST__pLifecycleConsumer        = NULL;
 static GDBusMethodInvocation           *NSMTST__pLifecycleInvocation      = NULL;
@@ -740,8 +906,19 @@ static NSMTST__tstTestCase NSMTST__astTestCases[] =
   { &NSMTST__boDbSetNodeState,                  .unParameter.stDbSetNodeState              = {NsmNodeState_LucRunning    },                                                                          .unReturnValues.stDbSetNodeState              = {NsmErrorStatus_Ok}                                          },
   { &NSMTST__boCheckNodeStateSignal,            .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckNodeStateSignal        = {TRUE, NsmNodeState_LucRunning}                              },
   { &NSMTST__boDbGetNodeState,                  .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stDbGetNodeState              = {NsmErrorStatus_Ok, NsmNodeState_LucRunning}                 },
+  { &NSMTST__boDbGetNodeStateProperty,          .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stDbGetNodeStateProperty      = {NsmNodeState_LucRunning}                                    },
+  { &NSMTST__boDbWaitForNodeState,              .unParameter.stDbWaitForNodeState          = {0x00, 0},                                                                                              .unReturnValues.stTestDummy                   = {0x00}                                                       },
+  { &NSMTST__boCheckWaitForNodeState,           .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckWaitForNodeState       = {TRUE, NsmErrorStatus_Parameter, NsmNodeState_NotSet}        },
+  { &NSMTST__boDbWaitForNodeState,              .unParameter.stDbWaitForNodeState          = {NSM_NODESTATE_MASK(NsmNodeState_LucRunning), 1000},                                                    .unReturnValues.stTestDummy                   = {0x00}                                                       },
+  { &NSMTST__boCheckWaitForNodeState,           .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckWaitForNodeState       = {TRUE, NsmErrorStatus_Ok, NsmNodeState_LucRunning}           },
+  { &NSMTST__boDbWaitForNodeState,              .unParameter.stDbWaitForNodeState          = {NSM_NODESTATE_MASK(NsmNodeState_Shutdown), 10},                                                        .unReturnValues.stTestDummy                   = {0x00}                                                       },
+  { &NSMTST__boDbGetNodeStateProperty,          .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stDbGetNodeStateProperty      = {NsmNodeState_LucRunning}                                    },
+  { &NSMTST__boCheckWaitForNodeState,           .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckWaitForNodeState       = {TRUE, NsmErrorStatus_Error, NsmNodeState_LucRunning}        },
+  { &NSMTST__boDbWaitForNodeState,              .unParameter.stDbWaitForNodeState          = {NSM_NODESTATE_MASK(NsmNodeState_FullyRunning), 5000},                                                  .unReturnValues.stTestDummy                   = {0x00}                                                       },
+  { &NSMTST__boCheckWaitForNodeState,           .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckWaitForNodeState       = {FALSE, NsmErrorStatus_NotSet, NsmNodeState_NotSet}          },
   { &NSMTST__boSmSetNodeState,                  .unParameter.stSmSetNodeState              = {sizeof(NsmNodeState_e), NsmNodeState_FullyRunning},                                                    .unReturnValues.stSmSetNodeState              = {NsmErrorStatus_Ok}                                          },
   { &NSMTST__boCheckNodeStateSignal,            .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckNodeStateSignal        = {TRUE, NsmNodeState_FullyRunning}                            },
+  { &NSMTST__boCheckWaitForNodeState,           .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckWaitForNodeState       = {TRUE, NsmErrorStatus_Ok, NsmNodeState_FullyRunning}         },
   { &NSMTST__boSmSetNodeState,                  .unParameter.stSmSetNodeState              = {3, NsmNodeState_FullyRunning},                                                                         .unReturnValues.stSmSetNodeState              = {NsmErrorStatus_Parameter}                                   },
   { &NSMTST__boSmSetNodeState,                  .unParameter.stSmSetNodeState              = {5, NsmNodeState_FullyRunning},                                                                         .unReturnValues.stSmSetNodeState              = {NsmErrorStatus_Parameter}                                   },
   { &NSMTST__boSmGetNodeState,                  .unParameter.stSmGetNodeState              = {sizeof(NsmNodeState_e)    },                                                                           .unReturnValues.stSmGetNodeState              = {sizeof(NsmNodeState_e), NsmNodeState_FullyRunning}          },
@@ -753,6 +930,7 @@ static NSMTST__tstTestCase NSMTST__astTestCases[] =
   { &NSMTST__boDbSetApplicationMode,            .unParameter.stDbSetApplicationMode        = {NsmApplicationMode_Factory       },                                                                    .unReturnValues.stDbSetApplicationMode        = {NsmErrorStatus_Ok}                                          },
   { &NSMTST__boCheckApplicationModeSignal,      .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckApplicationModeSignal  = {TRUE, NsmApplicationMode_Factory}                           },
   { &NSMTST__boDbGetApplicationMode,            .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stDbGetApplicationMode        = {NsmErrorStatus_Ok, NsmApplicationMode_Factory}              },
+  { &NSMTST__boDbGetApplicationModeProperty,    .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stDbGetApplicationModeProperty = {NsmApplicationMode_Factory}                                },
   { &NSMTST__boSmSetApplicationMode,            .unParameter.stSmSetApplicationMode        = {sizeof(NsmApplicationMode_e), NsmApplicationMode_Transport},                                           .unReturnValues.stSmSetApplicationMode        = {NsmErrorStatus_Ok}                                          },
   { &NSMTST__boCheckApplicationModeSignal,      .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckApplicationModeSignal  = {TRUE, NsmApplicationMode_Transport}                         },
   { &NSMTST__boSmSetApplicationMode,            .unParameter.stSmSetApplicationMode        = {3, NsmApplicationMode_Transport},                                                                      .unReturnValues.stSmSetApplicationMode        = {NsmErrorStatus_Parameter}                                   },
@@ -760,6 +938,11 @@ static NSMTST__tstTestCase NSMTST__astTestCases[] =
   { &NSMTST__boSmGetApplicationMode,            .unParameter.stSmGetApplicationMode        = {sizeof(NsmApplicationMode_e) + 1},                                                                     .unReturnValues.stSmGetApplicationMode        = {-1, NsmApplicationMode_NotSet}                              },
   { &NSMTST__boSmGetApplicationMode,            .unParameter.stSmGetApplicationMode        = {sizeof(NsmApplicationMode_e)    },                                                                     .unReturnValues.stSmGetApplicationMode        = {sizeof(NsmApplicationMode_e), NsmApplicationMode_Transport} },
   { &NSMTST__boDbGetInterfaceVersion,           .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stDbGetInterfaceVersion       = {NSM_INTERFACE_VERSION}                                      },
+  { &NSMTST__boDbGetStatistics,                 .unParameter.stDbGetStatistics             = {TRUE, "GetInterfaceVersion"},                                                                          .unReturnValues.stDbGetStatistics             = {NsmErrorStatus_Ok, TRUE}                                    },
+  { &NSMTST__boDbGetStatistics,                 .unParameter.stDbGetStatistics             = {FALSE, "GetInterfaceVersion"},                                                                         .unReturnValues.stDbGetStatistics             = {NsmErrorStatus_Ok, FALSE}                                   },
+  { &NSMTST__boDbGetInterfaceVersion,           .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stDbGetInterfaceVersion       = {NSM_INTERFACE_VERSION}                                      },
+  { &NSMTST__boDbGetStatistics,                 .unParameter.stDbGetStatistics             = {FALSE, "GetInterfaceVersion"},                                                                         .unReturnValues.stDbGetStatistics             = {NsmErrorStatus_Ok, TRUE}                                    },
+  { &NSMTST__boDbGetClientStatistics,           .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stDbGetClientStatistics       = {NsmErrorStatus_Ok, TRUE}                                    },
   { &NSMTST__boSmGetInterfaceVersion,           .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stSmGetInterfaceVersion       = {NSM_INTERFACE_VERSION}                                      },
   { &NSMTST__boSmSetInvalidData,                .unParameter.stSmSetInvalidData            = {sizeof(NsmRunningReason_e), NsmDataType_RunningReason},                                                .unReturnValues.stSmSetInvalidData            = {NsmErrorStatus_Parameter}                                   },
   { &NSMTST__boSmSetInvalidData,                .unParameter.stSmSetInvalidData            = {sizeof(NsmRestartReason_e), NsmDataType_RestartReason},                                                .unReturnValues.stSmSetInvalidData            = {NsmErrorStatus_Parameter}                                   },
@@ -863,7 +1046,48 @@ static NSMTST__tstTestCase NSMTST__astTestCases[] =
   { &NSMTST__boSmRegisterSession,               .unParameter.stSmRegisterSession           = {sizeof(NsmSession_s)-1, {"StateMachine", "NodeStateTest", NsmSeat_Driver, NsmSessionState_Active}},    .unReturnValues.stSmRegisterSession           = {NsmErrorStatus_Parameter}                                                 },
   { &NSMTST__boSmUnRegisterSession,             .unParameter.stSmUnRegisterSession         = {sizeof(NsmSession_s)-1, {"StateMachine", "NodeStateTest", NsmSeat_Driver, NsmSessionState_Active}},    .unReturnValues.stSmRegisterSession           = {NsmErrorStatus_Parameter}                                                 },
   { &NSMTST__boSmUnRegisterSession,             .unParameter.stSmUnRegisterSession         = {sizeof(NsmSession_s),   {"StateMachine", "NodeStateTest", NsmSeat_Driver, NsmSessionState_Unregistered}}, .unReturnValues.stSmRegisterSession        = {NsmErrorStatus_Ok}                                                        },
-  { &NSMTST__boCheckSessionSignal,              .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckSessionSignal          = {TRUE, "StateMachine", NsmSeat_Driver, NsmSessionState_Unregistered }      }
+  { &NSMTST__boCheckSessionSignal,              .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckSessionSignal          = {TRUE, "StateMachine", NsmSeat_Driver, NsmSessionState_Unregistered }      },
+  { &NSMTST__boTestCreateLcClient,              .unParameter.stTestCreateLcClient          = {"/org/genivi/NodeStateTest/LcClient08"},                                                               .unReturnValues.stTestDummy                   = {0x00}                                                       },
+  { &NSMTST__boDbRegisterSeatShutdownClient,    .unParameter.stDbRegisterSeatShutdownClient = {"/org/genivi/NodeStateTest/LcClient08", NSM_SHUTDOWNTYPE_NORMAL, 2000, NsmSeat_Last},                  .unReturnValues.stDbRegisterSeatShutdownClient = {NsmErrorStatus_Parameter}                                         },
+  { &NSMTST__boDbRegisterSeatShutdownClient,    .unParameter.stDbRegisterSeatShutdownClient = {"/org/genivi/NodeStateTest/LcClient08", NSM_SHUTDOWNTYPE_NORMAL, 2000, NsmSeat_Rear1},                  .unReturnValues.stDbRegisterSeatShutdownClient = {NsmErrorStatus_Ok}                                         },
+  { &NSMTST__boDbRequestSeatLifecycle,          .unParameter.stDbRequestSeatLifecycle      = {NsmSeat_NotSet, NSM_SHUTDOWNTYPE_NORMAL},                                                              .unReturnValues.stDbRequestSeatLifecycle      = {NsmErrorStatus_Parameter}                                          },
+  { &NSMTST__boDbRequestSeatLifecycle,          .unParameter.stDbRequestSeatLifecycle      = {NsmSeat_Rear1,  0x04                   },                                                              .unReturnValues.stDbRequestSeatLifecycle      = {NsmErrorStatus_Parameter}                                          },
+  { &NSMTST__boDbRequestSeatLifecycle,          .unParameter.stDbRequestSeatLifecycle      = {NsmSeat_Rear1,  NSM_SHUTDOWNTYPE_NORMAL},                                                              .unReturnValues.stDbRequestSeatLifecycle      = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boTestProcessLifecycleRequest,     .unParameter.stTestProcessLifecycleRequest = {NsmErrorStatus_Ok},                                                                                    .unReturnValues.stTestProcessLifecycleRequest = {NSM_SHUTDOWNTYPE_NORMAL}                                     },
+  { &NSMTST__boDbSetNodeState,                  .unParameter.stDbSetNodeState              = {NsmNodeState_FullyRunning},                                                                            .unReturnValues.stDbSetNodeState              = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boDbRequestSeatLifecycle,          .unParameter.stDbRequestSeatLifecycle      = {NsmSeat_Rear1,  NSM_SHUTDOWNTYPE_RUNUP },                                                              .unReturnValues.stDbRequestSeatLifecycle      = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boTestProcessLifecycleRequest,     .unParameter.stTestProcessLifecycleRequest = {NsmErrorStatus_Ok},                                                                                    .unReturnValues.stTestProcessLifecycleRequest = {NSM_SHUTDOWNTYPE_RUNUP }                                     },
+  { &NSMTST__boTestCreateLcClient,              .unParameter.stTestCreateLcClient          = {"/org/genivi/NodeStateTest/LcClient09"},                                                               .unReturnValues.stTestDummy                   = {0x00}                                                       },
+  { &NSMTST__boDbRegisterLoadSheddingClient,    .unParameter.stDbRegisterLoadSheddingClient = {"/org/genivi/NodeStateTest/LcClient09", 1, 2000},                                                     .unReturnValues.stDbRegisterLoadSheddingClient = {NsmErrorStatus_Ok}                                         },
+  { &NSMTST__boDbSetNodeState,                  .unParameter.stDbSetNodeState              = {NsmNodeState_DegradedPower},                                                                           .unReturnValues.stDbSetNodeState              = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boTestProcessLifecycleRequest,     .unParameter.stTestProcessLifecycleRequest = {NsmErrorStatus_Ok},                                                                                    .unReturnValues.stTestProcessLifecycleRequest = {NSM_SHUTDOWNTYPE_DEGRADE}                                    },
+  { &NSMTST__boDbSetNodeState,                  .unParameter.stDbSetNodeState              = {NsmNodeState_FullyRunning},                                                                            .unReturnValues.stDbSetNodeState              = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boTestProcessLifecycleRequest,     .unParameter.stTestProcessLifecycleRequest = {NsmErrorStatus_Ok},                                                                                    .unReturnValues.stTestProcessLifecycleRequest = {NSM_SHUTDOWNTYPE_RUNUP }                                     },
+  { &NSMTST__boTestCreateLcClient,              .unParameter.stTestCreateLcClient          = {"/org/genivi/NodeStateTest/LcClient10"},                                                               .unReturnValues.stTestDummy                   = {0x00}                                                       },
+  { &NSMTST__boDbRegisterShutdownClient,        .unParameter.stDbRegisterShutdownClient    = {"/org/genivi/NodeStateTest/LcClient10", NSM_SHUTDOWNTYPE_SUSPEND, 2000},                               .unReturnValues.stDbRegisterShutdownClient    = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boDbWaitForNodeState,              .unParameter.stDbWaitForNodeState          = {NSM_NODESTATE_MASK(NsmNodeState_Suspended), 5000},                                                     .unReturnValues.stTestDummy                   = {0x00}                                                       },
+  { &NSMTST__boDbSetNodeState,                  .unParameter.stDbSetNodeState              = {NsmNodeState_Suspending},                                                                              .unReturnValues.stDbSetNodeState              = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boTestProcessLifecycleRequest,     .unParameter.stTestProcessLifecycleRequest = {NsmErrorStatus_Ok},                                                                                    .unReturnValues.stTestProcessLifecycleRequest = {NSM_SHUTDOWNTYPE_SUSPEND}                                    },
+  { &NSMTST__boDbGetNodeState,                  .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stDbGetNodeState              = {NsmErrorStatus_Ok, NsmNodeState_Suspended}                  },
+  { &NSMTST__boCheckWaitForNodeState,           .unParameter.stTestDummy                   = {0x00},                                                                                                 .unReturnValues.stCheckWaitForNodeState       = {TRUE, NsmErrorStatus_Ok, NsmNodeState_Suspended}            },
+  { &NSMTST__boDbRequestSeatLifecycle,          .unParameter.stDbRequestSeatLifecycle      = {NsmSeat_Rear1,  NSM_SHUTDOWNTYPE_NORMAL},                                                              .unReturnValues.stDbRequestSeatLifecycle      = {NsmErrorStatus_Error}                                       },
+  { &NSMTST__boDbSetNodeState,                  .unParameter.stDbSetNodeState              = {NsmNodeState_BaseRunning},                                                                             .unReturnValues.stDbSetNodeState              = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boTestProcessLifecycleRequest,     .unParameter.stTestProcessLifecycleRequest = {NsmErrorStatus_Ok},                                                                                    .unReturnValues.stTestProcessLifecycleRequest = {NSM_SHUTDOWNTYPE_RESUME}                                    },
+  { &NSMTST__boDbSetNodeState,                  .unParameter.stDbSetNodeState              = {NsmNodeState_FullyRunning},                                                                            .unReturnValues.stDbSetNodeState              = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boTestCreateLcClient,              .unParameter.stTestCreateLcClient          = {"/org/genivi/NodeStateTest/LcClient11"},                                                               .unReturnValues.stTestDummy                   = {0x00}                                                       },
+  { &NSMTST__boDbRegisterShutdownClient,        .unParameter.stDbRegisterShutdownClient    = {"/org/genivi/NodeStateTest/LcClient11", NSM_SHUTDOWNTYPE_SUSPEND | NSM_SHUTDOWNTYPE_LUC, 2000},        .unReturnValues.stDbRegisterShutdownClient    = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boDbSetNodeState,                  .unParameter.stDbSetNodeState              = {NsmNodeState_Suspending},                                                                              .unReturnValues.stDbSetNodeState              = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boTestProcessLifecycleRequest,     .unParameter.stTestProcessLifecycleRequest = {NsmErrorStatus_Ok},                                                                                    .unReturnValues.stTestProcessLifecycleRequest = {NSM_SHUTDOWNTYPE_SUSPEND}                                    },
+  { &NSMTST__boTestProcessLifecycleRequest,     .unParameter.stTestProcessLifecycleRequest = {NsmErrorStatus_Ok},                                                                                    .unReturnValues.stTestProcessLifecycleRequest = {NSM_SHUTDOWNTYPE_SUSPEND}                                    },
+  { &NSMTST__boDbSetNodeState,                  .unParameter.stDbSetNodeState              = {NsmNodeState_LucRunning},                                                                              .unReturnValues.stDbSetNodeState              = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boTestProcessLifecycleRequest,     .unParameter.stTestProcessLifecycleRequest = {NsmErrorStatus_Ok},                                                                                    .unReturnValues.stTestProcessLifecycleRequest = {NSM_SHUTDOWNTYPE_RESUME}                                    },
+  { &NSMTST__boTestProcessLifecycleRequest,     .unParameter.stTestProcessLifecycleRequest = {NsmErrorStatus_Ok},                                                                                    .unReturnValues.stTestProcessLifecycleRequest = {NSM_SHUTDOWNTYPE_RESUME}                                    },
+  { &NSMTST__boDbSetNodeState,                  .unParameter.stDbSetNodeState              = {NsmNodeState_FullyRunning},                                                                            .unReturnValues.stDbSetNodeState              = {NsmErrorStatus_Ok}                                          },
+  { &NSMTST__boTestSlowNsmcLatency,             .unParameter.stTestSlowNsmcLatency         = {0x5A, 500, 100},                                                                                       .unReturnValues.stTestDummy                   = {0x00}                                                       },
+  { &NSMTST__boTestQueryBenchmark,              .unParameter.stTestQueryBenchmark          = {10, 100, 20},                                                                                          .unReturnValues.stTestDummy                   = {0x00}                                                       },
+  { &NSMTST__boSmSetDataBatch,                  .unParameter.stSmSetDataBatch              = {NsmShutdownReason_SupplyBad,  0x11, NsmApplicationMode_Factory},                                       .unReturnValues.stSmSetDataBatch              = {NsmErrorStatus_Ok,        NsmShutdownReason_SupplyBad, 0x11}},
+  { &NSMTST__boSmSetDataBatch,                  .unParameter.stSmSetDataBatch              = {NsmShutdownReason_ThermalBad, 0x12, NsmApplicationMode_Last   },                                       .unReturnValues.stSmSetDataBatch              = {NsmErrorStatus_Parameter, NsmShutdownReason_SupplyBad, 0x11}},
+  { &NSMTST__boSmSubscribeSession,              .unParameter.stSmSubscribeSession          = {"PdcSession", NsmSeat_Driver, NsmSeat_CoDriver},                                                       .unReturnValues.stSmSubscribeSession          = {1}                                                          }
 };
 
 
@@ -901,6 +1125,26 @@ static GVariant* NSMTST__pPrepareStateMachineData(guchar *pDataArray, const guin
   return g_variant_new_array(G_VARIANT_TYPE_BYTE, aArrayElements, u32ArraySize);
 }
 
+
+/**********************************************************************************************************************
+*
+* Helper function to sort latencies with g_qsort_with_data.
+*
+* @param pL1:       Pointer to first latency (gint64)
+* @param pL2:       Pointer to second latency (gint64)
+* @param pUserData: Optionally user data (not used)
+*
+* @return -1: pL1 < pL2. 0: pL1 == pL2. 1: pL1 > pL2
+*
+**********************************************************************************************************************/
+static gint NSMTST__i32LatencyCompare(gconstpointer pL1, gconstpointer pL2, gpointer pUserData)
+{
+  gint64 i64L1 = *((const gint64*) pL1);
+  gint64 i64L2 = *((const gint64*) pL2);
+
+  return (i64L1 > i64L2) - (i64L1 < i64L2);
+}
+
 /**********************************************************************************************************************
 *
 * Helper function to retrieve StateMachine data from received GVariant.
@@ -1294,6 +1538,83 @@ static gboolean NSMTST__boDbGetBootMode(void)
   return boRetVal;
 }
 
+static gboolean NSMTST__boDbGetNodeStateProperty(void)
+{
+  /* Function local variables                                         */
+  gboolean       boRetVal            = TRUE; /* Return value              */
+  NsmNodeState_e enReceivedNodeState = NsmNodeState_NotSet;
+  NsmNodeState_e enExpectedNodeState = NsmNodeState_NotSet;
+
+  enExpectedNodeState = NSMTST__pstTestCase->unReturnValues.stDbGetNodeStateProperty.enNodeState;
+
+  /* Provide test description */
+  NSMTST__sTestDescription = g_strdup_printf("Get NodeState property. Interface: D-Bus. Expected value: 0x%02X.",
+                                             enExpectedNodeState);
+
+  /* The value is read from the cache of the proxy. It has been updated by "PropertiesChanged" */
+  enReceivedNodeState = (NsmNodeState_e) node_state_consumer_get_node_state(NSMTST__pNodeStateConsumer);
+
+  if(enReceivedNodeState != enExpectedNodeState)
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Did not receive expected value. Received: 0x%02X. Expected: 0x%02X.",
+                                                enReceivedNodeState, enExpectedNodeState);
+  }
+
+  return boRetVal;
+}
+
+static gboolean NSMTST__boDbGetApplicationModeProperty(void)
+{
+  /* Function local variables                                                */
+  gboolean             boRetVal                  = TRUE; /* Return value     */
+  NsmApplicationMode_e enReceivedApplicationMode = NsmApplicationMode_NotSet;
+  NsmApplicationMode_e enExpectedApplicationMode = NsmApplicationMode_NotSet;
+
+  enExpectedApplicationMode = NSMTST__pstTestCase->unReturnValues.stDbGetApplicationModeProperty.enApplicationMode;
+
+  /* Provide test description */
+  NSMTST__sTestDescription = g_strdup_printf("Get ApplicationMode property. Interface: D-Bus. Expected value: 0x%02X.",
+                                             enExpectedApplicationMode);
+
+  /* The value is read from the cache of the proxy. It has been updated by "PropertiesChanged" */
+  enReceivedApplicationMode = (NsmApplicationMode_e) node_state_consumer_get_application_mode(NSMTST__pNodeStateConsumer);
+
+  if(enReceivedApplicationMode != enExpectedApplicationMode)
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Did not receive expected value. Received: 0x%02X. Expected: 0x%02X.",
+                                                enReceivedApplicationMode, enExpectedApplicationMode);
+  }
+
+  return boRetVal;
+}
+
+static gboolean NSMTST__boDbWaitForNodeState(void)
+{
+  /* Values read from parameter config */
+  const guint u32NodeStateMask = NSMTST__pstTestCase->unParameter.stDbWaitForNodeState.u32NodeStateMask;
+  const guint u32TimeoutMs     = NSMTST__pstTestCase->unParameter.stDbWaitForNodeState.u32TimeoutMs;
+
+  /* Create test case description */
+  NSMTST__sTestDescription = g_strdup_printf("Wait for NodeState. Interface: D-Bus. Mask: 0x%04X. Timeout: %u ms.",
+                                             u32NodeStateMask, u32TimeoutMs);
+
+  /* Forget former results. The call is made async. The result is evaluated by NSMTST__boCheckWaitForNodeState */
+  NSMTST__stWaitForNodeState.boReceived    = FALSE;
+  NSMTST__stWaitForNodeState.enErrorStatus = NsmErrorStatus_NotSet;
+  NSMTST__stWaitForNodeState.enNodeState   = NsmNodeState_NotSet;
+
+  node_state_consumer_call_wait_for_node_state(NSMTST__pNodeStateConsumer,
+                                               u32NodeStateMask,
+                                               u32TimeoutMs,
+                                               NULL,
+                                               &NSMTST__vOnWaitForNodeStateFinish,
+                                               NULL);
+
+  return TRUE;
+}
+
 static gboolean NSMTST__boSmGetApplicationMode(void)
 {
   /* Function local variables                                     */
@@ -2407,6 +2728,146 @@ static gboolean NSMTST__boSmSetBootMode(void)
   return boRetVal;
 }
 
+static gboolean NSMTST__boSmSetDataBatch(void)
+{
+  /* Function local variables                                   */
+  gboolean          boRetVal            = TRUE; /* Return value */
+  GError           *pError              = NULL;
+  NsmErrorStatus_e  enReceivedNsmReturn = NsmErrorStatus_NotSet;
+  gint              i32ShutdownReason   = 0;
+  gint              i32BootMode         = 0;
+
+  /* Values read from parameter and return config */
+  const NSMTST__tstSmSetDataBatchParam  *pstParam  = &NSMTST__pstTestCase->unParameter.stSmSetDataBatch;
+  const NSMTST__tstSmSetDataBatchReturn *pstReturn = &NSMTST__pstTestCase->unReturnValues.stSmSetDataBatch;
+
+  /* Create test case description */
+  NSMTST__sTestDescription = g_strdup_printf("Set data batch. Interface: StateMachine. ShutdownReason: %d. BootMode: %d. AppMode: %d.",
+                                             pstParam->enShutdownReason, pstParam->i32BootMode, pstParam->enApplicationMode);
+
+  /* Perform test call */
+  (void) node_state_test_call_set_nsm_data_batch_sync(NSMTST__pNodeStateMachine,
+                                                      (gint) pstParam->enShutdownReason,
+                                                      pstParam->i32BootMode,
+                                                      (gint) pstParam->enApplicationMode,
+                                                      &i32ShutdownReason,
+                                                      &i32BootMode,
+                                                      (gint*) &enReceivedNsmReturn,
+                                                      NULL,
+                                                      &pError);
+
+  /* Evaluate result. Check if a D-Bus error occurred. */
+  if(pError == NULL)
+  {
+    /* An invalid batch must not have changed any value */
+    if(   (enReceivedNsmReturn == pstReturn->enErrorStatus           )
+       && (i32ShutdownReason   == (gint) pstReturn->enShutdownReason)
+       && (i32BootMode         == pstReturn->i32BootMode             ))
+    {
+      boRetVal = TRUE;
+    }
+    else
+    {
+      boRetVal = FALSE;
+      NSMTST__sErrorDescription = g_strdup_printf("Did not receive expected values. Return: 0x%02X. ShutdownReason: %d. BootMode: %d.",
+                                                  enReceivedNsmReturn, i32ShutdownReason, i32BootMode);
+    }
+  }
+  else
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Failed to create access NSMC via D-Bus. Error msg.: %s.",
+                                                pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
+static gboolean NSMTST__boSmSubscribeSession(void)
+{
+  /* Function local variables                                   */
+  gboolean          boRetVal            = TRUE; /* Return value */
+  GError           *pError              = NULL;
+  gint              i32Handle           = -1;
+  guint             u32Calls            = 0;
+  NsmErrorStatus_e  enReceivedNsmReturn = NsmErrorStatus_NotSet;
+
+  /* Values read from parameter and return config */
+  const NSMTST__tstSmSubscribeSessionParam  *pstParam  = &NSMTST__pstTestCase->unParameter.stSmSubscribeSession;
+  const NSMTST__tstSmSubscribeSessionReturn *pstReturn = &NSMTST__pstTestCase->unReturnValues.stSmSubscribeSession;
+
+  /* Create test case description */
+  NSMTST__sTestDescription = g_strdup_printf("Subscribe session. Interface: StateMachine. Session: %s. Seat: %d. Other seat: %d.",
+                                             pstParam->sSessionName, pstParam->enSubscribedSeat, pstParam->enOtherSeat);
+
+  /* Let the test NSMC subscribe. Then activate the session on the other and on the subscribed seat */
+  (void) node_state_test_call_subscribe_session_sync(NSMTST__pNodeStateMachine,
+                                                     pstParam->sSessionName,
+                                                     (gint) pstParam->enSubscribedSeat,
+                                                     &i32Handle,
+                                                     NULL,
+                                                     &pError);
+
+  if((pError == NULL) && (i32Handle > 0))
+  {
+    (void) node_state_consumer_call_set_session_state_sync(NSMTST__pNodeStateConsumer,
+                                                           pstParam->sSessionName,
+                                                           "NodeStateTest",
+                                                           (gint) pstParam->enOtherSeat,
+                                                           (gint) NsmSessionState_Active,
+                                                           (gint*) &enReceivedNsmReturn,
+                                                           NULL,
+                                                           &pError);
+  }
+
+  if((pError == NULL) && (i32Handle > 0))
+  {
+    (void) node_state_consumer_call_set_session_state_sync(NSMTST__pNodeStateConsumer,
+                                                           pstParam->sSessionName,
+                                                           "NodeStateTest",
+                                                           (gint) pstParam->enSubscribedSeat,
+                                                           (gint) NsmSessionState_Active,
+                                                           (gint*) &enReceivedNsmReturn,
+                                                           NULL,
+                                                           &pError);
+  }
+
+  if((pError == NULL) && (i32Handle > 0))
+  {
+    (void) node_state_test_call_unsubscribe_session_sync(NSMTST__pNodeStateMachine,
+                                                         i32Handle,
+                                                         &u32Calls,
+                                                         NULL,
+                                                         &pError);
+  }
+
+  /* Evaluate result. Check if a D-Bus error occurred. */
+  if(pError == NULL)
+  {
+    /* Only the change on the subscribed seat may have called the NSMC */
+    if((i32Handle > 0) && (u32Calls == pstReturn->u32Calls))
+    {
+      boRetVal = TRUE;
+    }
+    else
+    {
+      boRetVal = FALSE;
+      NSMTST__sErrorDescription = g_strdup_printf("Did not receive expected subscription calls. Handle: %d. Received: %u. Expected: %u.",
+                                                  i32Handle, u32Calls, pstReturn->u32Calls);
+    }
+  }
+  else
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Failed to access NSM via D-Bus. Error msg.: %s.",
+                                                pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
 static gboolean NSMTST__boDbSetApplicationMode(void)
 {
   /* Function local variables                                   */
@@ -2844,6 +3305,162 @@ static gboolean NSMTST__boDbGetInterfaceVersion(void)
   return boRetVal;
 }
 
+static gboolean NSMTST__boDbGetStatistics(void)
+{
+  /* Function local variables                                                   */
+  gboolean          boRetVal          = TRUE;  /* Return value                 */
+  gboolean          boFound           = FALSE; /* Entry found in statistics    */
+  gboolean          boCalled          = FALSE; /* Calls counted for the entry  */
+  GError           *pError            = NULL;
+  GVariant         *pStatistics       = NULL;
+  GVariantIter     *pHistogram        = NULL;
+  GVariantIter      stIter;
+  const gchar      *sName             = NULL;
+  guint             u32Calls          = 0;
+  guint64           u64WallSumNs      = 0;
+  guint64           u64WallMaxNs      = 0;
+  guint64           u64CpuSumNs       = 0;
+  guint             u32BucketCalls    = 0;
+  guint             u32HistogramCalls = 0;
+  gint              i32ErrorStatus    = NsmErrorStatus_NotSet;
+  const gboolean    boReset           = NSMTST__pstTestCase->unParameter.stDbGetStatistics.boReset;
+  const gchar      *sCheckedName      = NSMTST__pstTestCase->unParameter.stDbGetStatistics.sName;
+
+  /* Create test case description */
+  NSMTST__sTestDescription = g_strdup_printf("Get statistics of %s. Interface: D-Bus. Reset: %d.", sCheckedName, boReset);
+
+  /* Perform test call */
+  (void) node_state_consumer_call_get_statistics_sync(NSMTST__pNodeStateConsumer,
+                                                      boReset,
+                                                      &pStatistics,
+                                                      &i32ErrorStatus,
+                                                      NULL,
+                                                      &pError);
+
+  /* Evaluate result. Check if a D-Bus error occurred. */
+  if(pError == NULL)
+  {
+    g_variant_iter_init(&stIter, pStatistics);
+
+    while(g_variant_iter_loop(&stIter, "(&sutttau)", &sName, &u32Calls, &u64WallSumNs, &u64WallMaxNs, &u64CpuSumNs, &pHistogram))
+    {
+      if(g_strcmp0(sName, sCheckedName) == 0)
+      {
+        boFound  = TRUE;
+        boCalled = (u32Calls != 0);
+
+        /* Every call has to be counted in exactly one histogram bucket */
+        while(g_variant_iter_next(pHistogram, "u", &u32BucketCalls))
+        {
+          u32HistogramCalls += u32BucketCalls;
+        }
+
+        if((u32HistogramCalls != u32Calls) || (u64WallMaxNs > u64WallSumNs))
+        {
+          boRetVal = FALSE;
+          NSMTST__sErrorDescription = g_strdup_printf("Inconsistent statistics. Calls: %u. Histogram: %u.",
+                                                      u32Calls, u32HistogramCalls);
+        }
+      }
+    }
+
+    g_variant_unref(pStatistics);
+
+    if(boRetVal == TRUE)
+    {
+      if(   (boFound                                                                 == TRUE    )
+         && (i32ErrorStatus == (gint) NSMTST__pstTestCase->unReturnValues.stDbGetStatistics.enErrorStatus)
+         && (boCalled       ==        NSMTST__pstTestCase->unReturnValues.stDbGetStatistics.boCalled     ))
+      {
+        boRetVal = TRUE;
+      }
+      else
+      {
+        boRetVal = FALSE;
+        NSMTST__sErrorDescription = g_strdup_printf("Did not receive expected statistics. Found: %d. ErrorStatus: 0x%02X. Called: %d.",
+                                                    boFound, i32ErrorStatus, boCalled);
+      }
+    }
+  }
+  else
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Failed to access NSM via D-Bus. Error msg.: %s.",
+                                                pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
+static gboolean NSMTST__boDbGetClientStatistics(void)
+{
+  /* Function local variables                                          */
+  gboolean      boRetVal       = TRUE;  /* Return value               */
+  gboolean      boFound        = FALSE; /* Test client found in list  */
+  GError       *pError         = NULL;
+  GVariant     *pClients       = NULL;
+  GVariantIter  stIter;
+  const gchar  *sName          = NULL;
+  const gchar  *sOwnName       = NULL;  /* Unique bus name of the test */
+  guint         u32Pid         = 0;
+  guint         u32Uid         = 0;
+  guint         u32Calls       = 0;
+  guint         u32Rejected    = 0;
+  guint64       u64HandlingNs  = 0;
+  gint          i32ErrorStatus = NsmErrorStatus_NotSet;
+
+  /* Create test case description */
+  NSMTST__sTestDescription = g_strdup_printf("Get client statistics. Interface: D-Bus.");
+
+  sOwnName = g_dbus_connection_get_unique_name(g_dbus_proxy_get_connection(G_DBUS_PROXY(NSMTST__pNodeStateConsumer)));
+
+  /* Perform test call */
+  (void) node_state_consumer_call_get_client_statistics_sync(NSMTST__pNodeStateConsumer,
+                                                             &pClients,
+                                                             &i32ErrorStatus,
+                                                             NULL,
+                                                             &pError);
+
+  /* Evaluate result. Check if a D-Bus error occurred. */
+  if(pError == NULL)
+  {
+    g_variant_iter_init(&stIter, pClients);
+
+    /* The test itself has called the NSM before. It must be listed and must not have been rate limited. */
+    while(g_variant_iter_next(&stIter, "(&suuuut)", &sName, &u32Pid, &u32Uid, &u32Calls, &u32Rejected, &u64HandlingNs))
+    {
+      if(g_strcmp0(sName, sOwnName) == 0)
+      {
+        boFound = (u32Calls != 0) && (u32Rejected == 0) && (u64HandlingNs != 0);
+      }
+    }
+
+    g_variant_unref(pClients);
+
+    if(   (i32ErrorStatus == (gint) NSMTST__pstTestCase->unReturnValues.stDbGetClientStatistics.enErrorStatus)
+       && (boFound        ==        NSMTST__pstTestCase->unReturnValues.stDbGetClientStatistics.boFound      ))
+    {
+      boRetVal = TRUE;
+    }
+    else
+    {
+      boRetVal = FALSE;
+      NSMTST__sErrorDescription = g_strdup_printf("Did not receive expected client statistics. ErrorStatus: 0x%02X. Found: %d.",
+                                                  i32ErrorStatus, boFound);
+    }
+  }
+  else
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Failed to access NSM via D-Bus. Error msg.: %s.",
+                                                pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
 
 /*********************************************** Call methods via D-Bus *********************************************/
 
@@ -3091,6 +3708,154 @@ static gboolean NSMTST__boDbRequestNodeRestart(void)
   return boRetVal;
 }
 
+static gboolean NSMTST__boDbRegisterSeatShutdownClient(void)
+{
+  /* Function local variables                                       */
+  gboolean              boRetVal            = TRUE; /* Return value */
+  GError               *pError              = NULL;
+  NsmErrorStatus_e      enReceivedNsmReturn = NsmErrorStatus_NotSet;
+
+  /* Create test case description */
+  NSMTST__sTestDescription = g_strdup_printf("Register seat shutdown client. Interface: D-Bus. Value: (BusName: %s. ObjName: %s. Mode: 0x%04X. Timeout: %d. Seat: 0x%02X.).",
+                                             NSMTST__sBusName,
+                                             NSMTST__pstTestCase->unParameter.stDbRegisterSeatShutdownClient.sObjName,
+                                             NSMTST__pstTestCase->unParameter.stDbRegisterSeatShutdownClient.u32Mode,
+                                             NSMTST__pstTestCase->unParameter.stDbRegisterSeatShutdownClient.u32Timeout,
+                                             NSMTST__pstTestCase->unParameter.stDbRegisterSeatShutdownClient.enSeat);
+
+  /* Perform test call */
+  (void) node_state_consumer_call_register_seat_shutdown_client_sync(NSMTST__pNodeStateConsumer,
+                                                                     NSMTST__sBusName,
+                                                                     NSMTST__pstTestCase->unParameter.stDbRegisterSeatShutdownClient.sObjName,
+                                                                     NSMTST__pstTestCase->unParameter.stDbRegisterSeatShutdownClient.u32Mode,
+                                                                     NSMTST__pstTestCase->unParameter.stDbRegisterSeatShutdownClient.u32Timeout,
+                                                                     (gint) NSMTST__pstTestCase->unParameter.stDbRegisterSeatShutdownClient.enSeat,
+                                                                     (gint*) &enReceivedNsmReturn,
+                                                                     NULL,
+                                                                     &pError);
+
+  /* Evaluate result. Check if a D-Bus error occurred. */
+  if(pError == NULL)
+  {
+    /* D-Bus communication successful. Check if NSM returned with the expected value. */
+    if(enReceivedNsmReturn == NSMTST__pstTestCase->unReturnValues.stDbRegisterSeatShutdownClient.enErrorStatus)
+    {
+      boRetVal = TRUE;
+    }
+    else
+    {
+      boRetVal = FALSE;
+      NSMTST__sErrorDescription = g_strdup_printf("Did not receive expected NSM return value. Received: 0x%02X. Expected: 0x%02X.",
+                                                  enReceivedNsmReturn, NSMTST__pstTestCase->unReturnValues.stDbRegisterSeatShutdownClient.enErrorStatus);
+    }
+  }
+  else
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Failed to create access NSM via D-Bus. Error msg.: %s.",
+                                                pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
+static gboolean NSMTST__boDbRequestSeatLifecycle(void)
+{
+  /* Function local variables                                       */
+  gboolean              boRetVal            = TRUE; /* Return value */
+  GError               *pError              = NULL;
+  NsmErrorStatus_e      enReceivedNsmReturn = NsmErrorStatus_NotSet;
+
+  /* Create test case description */
+  NSMTST__sTestDescription = g_strdup_printf("Request seat lifecycle. Interface: D-Bus. Value: (Seat: 0x%02X. RequestType: 0x%04X.).",
+                                             NSMTST__pstTestCase->unParameter.stDbRequestSeatLifecycle.enSeat,
+                                             NSMTST__pstTestCase->unParameter.stDbRequestSeatLifecycle.u32RequestType);
+
+  /* Perform test call */
+  (void) node_state_lifecycle_control_call_request_seat_lifecycle_sync(NSMTST__pLifecycleControl,
+                                                                     (gint) NSMTST__pstTestCase->unParameter.stDbRequestSeatLifecycle.enSeat,
+                                                                     NSMTST__pstTestCase->unParameter.stDbRequestSeatLifecycle.u32RequestType,
+                                                                     (gint*) &enReceivedNsmReturn,
+                                                                     NULL,
+                                                                     &pError);
+
+  /* Evaluate result. Check if a D-Bus error occurred. */
+  if(pError == NULL)
+  {
+    /* D-Bus communication successful. Check if NSM returned with the expected value. */
+    if(enReceivedNsmReturn == NSMTST__pstTestCase->unReturnValues.stDbRequestSeatLifecycle.enErrorStatus)
+    {
+      boRetVal = TRUE;
+    }
+    else
+    {
+      boRetVal = FALSE;
+      NSMTST__sErrorDescription = g_strdup_printf("Did not receive expected NSM return value. Received: 0x%02X. Expected: 0x%02X.",
+                                                  enReceivedNsmReturn, NSMTST__pstTestCase->unReturnValues.stDbRequestSeatLifecycle.enErrorStatus);
+    }
+  }
+  else
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Failed to create access NSM via D-Bus. Error msg.: %s.",
+                                                pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
+static gboolean NSMTST__boDbRegisterLoadSheddingClient(void)
+{
+  /* Function local variables                                       */
+  gboolean              boRetVal            = TRUE; /* Return value */
+  GError               *pError              = NULL;
+  NsmErrorStatus_e      enReceivedNsmReturn = NsmErrorStatus_NotSet;
+
+  /* Create test case description */
+  NSMTST__sTestDescription = g_strdup_printf("Register load shedding client. Interface: D-Bus. Value: (BusName: %s. ObjName: %s. Level: %d. Timeout: %d.).",
+                                             NSMTST__sBusName,
+                                             NSMTST__pstTestCase->unParameter.stDbRegisterLoadSheddingClient.sObjName,
+                                             NSMTST__pstTestCase->unParameter.stDbRegisterLoadSheddingClient.u32ShedLevel,
+                                             NSMTST__pstTestCase->unParameter.stDbRegisterLoadSheddingClient.u32Timeout);
+
+  /* Perform test call */
+  (void) node_state_consumer_call_register_load_shedding_client_sync(NSMTST__pNodeStateConsumer,
+                                                                     NSMTST__sBusName,
+                                                                     NSMTST__pstTestCase->unParameter.stDbRegisterLoadSheddingClient.sObjName,
+                                                                     NSMTST__pstTestCase->unParameter.stDbRegisterLoadSheddingClient.u32ShedLevel,
+                                                                     NSMTST__pstTestCase->unParameter.stDbRegisterLoadSheddingClient.u32Timeout,
+                                                                     (gint*) &enReceivedNsmReturn,
+                                                                     NULL,
+                                                                     &pError);
+
+  /* Evaluate result. Check if a D-Bus error occurred. */
+  if(pError == NULL)
+  {
+    /* D-Bus communication successful. Check if NSM returned with the expected value. */
+    if(enReceivedNsmReturn == NSMTST__pstTestCase->unReturnValues.stDbRegisterLoadSheddingClient.enErrorStatus)
+    {
+      boRetVal = TRUE;
+    }
+    else
+    {
+      boRetVal = FALSE;
+      NSMTST__sErrorDescription = g_strdup_printf("Did not receive expected NSM return value. Received: 0x%02X. Expected: 0x%02X.",
+                                                  enReceivedNsmReturn, NSMTST__pstTestCase->unReturnValues.stDbRegisterLoadSheddingClient.enErrorStatus);
+    }
+  }
+  else
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Failed to create access NSM via D-Bus. Error msg.: %s.",
+                                                pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
 static gboolean NSMTST__boDbSetAppHealthStatus(void)
 {
   /* Function local variables                                       */
@@ -3243,6 +4008,33 @@ static gboolean NSMTST__boCheckNodeStateSignal(void)
   return boRetVal;
 }
 
+static gboolean NSMTST__boCheckWaitForNodeState(void)
+{
+  /* Function local variables                */
+  gboolean boRetVal = FALSE; /* Return value */
+
+  NSMTST__sTestDescription = g_strdup("Check for return of WaitForNodeState.");
+
+  /* Compare the received with the expected values  */
+  if(   (NSMTST__pstTestCase->unReturnValues.stCheckWaitForNodeState.boReceived    == NSMTST__stWaitForNodeState.boReceived   )
+     && (NSMTST__pstTestCase->unReturnValues.stCheckWaitForNodeState.enErrorStatus == NSMTST__stWaitForNodeState.enErrorStatus)
+     && (NSMTST__pstTestCase->unReturnValues.stCheckWaitForNodeState.enNodeState   == NSMTST__stWaitForNodeState.enNodeState  ))
+  {
+    /* We found what we expected */
+    boRetVal = TRUE;
+  }
+  else
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Unexpected return of WaitForNodeState. Received: %d, 0x%02X, 0x%02X.",
+                                                NSMTST__stWaitForNodeState.boReceived,
+                                                NSMTST__stWaitForNodeState.enErrorStatus,
+                                                NSMTST__stWaitForNodeState.enNodeState);
+  }
+
+  return boRetVal;
+}
+
 static gboolean NSMTST__boCheckApplicationModeSignal(void)
 {
   /* Function local variables                */
@@ -3342,6 +4134,188 @@ static gboolean NSMTST__boTestProcessLifecycleRequest(void)
   return boRetVal;
 }
 
+
+/**********************************************************************************************************************
+*
+* Test function to check the latency of a query, while the NSMC is slow. The NSMC is delayed and a BootMode is set
+* asynchronously, which makes the NSM core call NsmcSetData. While the core is blocked, the ApplicationMode is
+* queried. The query is served by the D-Bus thread of the NSM and must not wait for the NSMC.
+*
+* @return TRUE: Test case successful. FALSE: Test case failed.
+*
+**********************************************************************************************************************/
+static gboolean NSMTST__boTestSlowNsmcLatency(void)
+{
+  /* Function local variables                                                        */
+  gboolean              boRetVal                  = TRUE;  /* Return value            */
+  GError               *pError                    = NULL;
+  gint64                i64StartTime              = 0;     /* Time before the query    */
+  gint64                i64LatencyMs              = 0;     /* Duration of the query    */
+  NsmErrorStatus_e      enReceivedNsmReturn       = NsmErrorStatus_NotSet;
+  NsmApplicationMode_e  enReceivedApplicationMode = NsmApplicationMode_NotSet;
+  NSMTST__tstTestSlowNsmcLatencyParam *pstParam   = &NSMTST__pstTestCase->unParameter.stTestSlowNsmcLatency;
+
+  NSMTST__sTestDescription = g_strdup_printf("Query latency with slow NSMC. NSMC delay: %dms. Max. latency: %dms.",
+                                             pstParam->u32NsmcDelayMs, pstParam->u32MaxLatencyMs);
+
+  (void) node_state_test_call_set_nsmc_delay_sync(NSMTST__pNodeStateMachine, pstParam->u32NsmcDelayMs, NULL, &pError);
+
+  if(pError == NULL)
+  {
+    /* Make the NSM core call the slow NSMC. Do not wait for the result */
+    node_state_lifecycle_control_call_set_boot_mode(NSMTST__pLifecycleControl, pstParam->i32BootMode, NULL, NULL, NULL);
+
+    /* Give the NSM time to enter NsmcSetData */
+    g_usleep((gulong) pstParam->u32NsmcDelayMs * 1000 / 4);
+
+    i64StartTime = g_get_monotonic_time();
+    (void) node_state_consumer_call_get_application_mode_sync(NSMTST__pNodeStateConsumer,
+                                                              (gint*) &enReceivedApplicationMode,
+                                                              (gint*) &enReceivedNsmReturn,
+                                                              NULL,
+                                                              &pError);
+    i64LatencyMs = (g_get_monotonic_time() - i64StartTime) / 1000;
+
+    if(pError == NULL)
+    {
+      if(i64LatencyMs > (gint64) pstParam->u32MaxLatencyMs)
+      {
+        boRetVal = FALSE;
+        NSMTST__sErrorDescription = g_strdup_printf("Query was blocked by slow NSMC. Latency: %dms.",
+                                                    (gint) i64LatencyMs);
+      }
+    }
+    else
+    {
+      boRetVal = FALSE;
+      NSMTST__sErrorDescription = g_strdup_printf("Failed to access NSM via D-Bus. Error msg.: %s.", pError->message);
+      g_error_free(pError);
+      pError = NULL;
+    }
+
+    /* Remove the delay. The call is processed by the core, after the slow NsmcSetData returned */
+    (void) node_state_test_call_set_nsmc_delay_sync(NSMTST__pNodeStateMachine, 0, NULL, NULL);
+  }
+  else
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Failed to access NSMC via D-Bus. Error msg.: %s.", pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* Benchmark for queries, while the NSM core is busy. For each sample, a BootMode is set asynchronously, which makes the
+* core call the slow NSMC. Afterwards, the NodeState is queried once via the Consumer interface, which is answered by
+* the D-Bus thread of the NSM, and once via the test NSMC, which is answered by the core after the slow call.
+* The p50 and p99 latencies of both paths are added to the test description.
+*
+* @return TRUE: Test case successful. FALSE: Test case failed.
+*
+**********************************************************************************************************************/
+static gboolean NSMTST__boTestQueryBenchmark(void)
+{
+  /* Function local variables                                                          */
+  gboolean            boRetVal            = TRUE;  /* Return value                     */
+  GError             *pError              = NULL;
+  GVariant           *pDataIn             = NULL;
+  GVariant           *pDataOut            = NULL;
+  gint                i32ReceivedNsmReturn = 0;
+  NsmErrorStatus_e    enReceivedNsmReturn = NsmErrorStatus_NotSet;
+  NsmNodeState_e      enReceivedNodeState = NsmNodeState_NotSet;
+  gint64              i64StartTime        = 0;
+  gint64             *ai64Direct          = NULL;  /* Latencies of Consumer queries (us) */
+  gint64             *ai64Core            = NULL;  /* Latencies of NSMC queries (us)     */
+  guint               u32SampleIdx        = 0;
+  guint               u32P50Idx           = 0;
+  guint               u32P99Idx           = 0;
+  NSMTST__tstTestQueryBenchmarkParam *pstParam = &NSMTST__pstTestCase->unParameter.stTestQueryBenchmark;
+
+  NSMTST__sTestDescription = g_strdup_printf("Query benchmark. NSMC delay: %dms. Samples: %d.",
+                                             pstParam->u32NsmcDelayMs, pstParam->u32Samples);
+
+  ai64Direct = g_new0(gint64, pstParam->u32Samples);
+  ai64Core   = g_new0(gint64, pstParam->u32Samples);
+
+  (void) node_state_test_call_set_nsmc_delay_sync(NSMTST__pNodeStateMachine, pstParam->u32NsmcDelayMs, NULL, &pError);
+
+  for(u32SampleIdx = 0; (u32SampleIdx < pstParam->u32Samples) && (pError == NULL); u32SampleIdx++)
+  {
+    /* Load the core. The BootMode alternates, so that the NSMC is called every time */
+    node_state_lifecycle_control_call_set_boot_mode(NSMTST__pLifecycleControl, 0x100 + (u32SampleIdx % 2), NULL, NULL, NULL);
+
+    i64StartTime = g_get_monotonic_time();
+    (void) node_state_consumer_call_get_node_state_sync(NSMTST__pNodeStateConsumer,
+                                                        (gint*) &enReceivedNodeState,
+                                                        (gint*) &enReceivedNsmReturn,
+                                                        NULL,
+                                                        &pError);
+    ai64Direct[u32SampleIdx] = g_get_monotonic_time() - i64StartTime;
+
+    if(pError == NULL)
+    {
+      pDataIn      = g_variant_new_array(G_VARIANT_TYPE_BYTE, NULL, 0);
+      i64StartTime = g_get_monotonic_time();
+      (void) node_state_test_call_get_nsm_data_sync(NSMTST__pNodeStateMachine,
+                                                    NsmDataType_NodeState,
+                                                    pDataIn,
+                                                    sizeof(NsmNodeState_e),
+                                                    &pDataOut,
+                                                    &i32ReceivedNsmReturn,
+                                                    NULL,
+                                                    &pError);
+      ai64Core[u32SampleIdx] = g_get_monotonic_time() - i64StartTime;
+      g_variant_unref(pDataIn);
+
+      if(pDataOut != NULL)
+      {
+        g_variant_unref(pDataOut);
+        pDataOut = NULL;
+      }
+    }
+  }
+
+  /* Remove the delay. The call is processed by the core, after the last slow NsmcSetData returned */
+  (void) node_state_test_call_set_nsmc_delay_sync(NSMTST__pNodeStateMachine, 0, NULL, NULL);
+
+  if(pError == NULL)
+  {
+    g_qsort_with_data(ai64Direct, pstParam->u32Samples, sizeof(gint64), &NSMTST__i32LatencyCompare, NULL);
+    g_qsort_with_data(ai64Core,   pstParam->u32Samples, sizeof(gint64), &NSMTST__i32LatencyCompare, NULL);
+
+    u32P50Idx = (pstParam->u32Samples * 50) / 100;
+    u32P99Idx = MIN((pstParam->u32Samples * 99) / 100, pstParam->u32Samples - 1);
+
+    g_free(NSMTST__sTestDescription);
+    NSMTST__sTestDescription = g_strdup_printf("Query benchmark. NSMC delay: %dms. Samples: %d. "
+                                               "Consumer p50/p99: %d/%dus. Core p50/p99: %d/%dus.",
+                                               pstParam->u32NsmcDelayMs, pstParam->u32Samples,
+                                               (gint) ai64Direct[u32P50Idx], (gint) ai64Direct[u32P99Idx],
+                                               (gint) ai64Core[u32P50Idx],   (gint) ai64Core[u32P99Idx]);
+
+    if(ai64Direct[u32P99Idx] > (gint64) pstParam->u32MaxP99Ms * 1000)
+    {
+      boRetVal = FALSE;
+      NSMTST__sErrorDescription = g_strdup_printf("Consumer queries were blocked by the core.");
+    }
+  }
+  else
+  {
+    boRetVal = FALSE;
+    NSMTST__sErrorDescription = g_strdup_printf("Failed to access NSM via D-Bus. Error msg.: %s.", pError->message);
+    g_error_free(pError);
+  }
+
+  g_free(ai64Direct);
+  g_free(ai64Core);
+
+  return boRetVal;
+}
+
 static gboolean NSMTST__boDbLifecycleRequestComplete(void)
 {
   gboolean          boRetVal            = FALSE;
@@ -3441,6 +4415,41 @@ gboolean NSMTST__boOnNodeStateSignal(NodeStateConsumer *pObject,
 }
 
 
+/**********************************************************************************************************************
+*
+* Callback for the async. return of WaitForNodeState. Store the returned values.
+*
+* @param pSrcObject: Consumer proxy, on which the call has been made.
+* @param pRes:       Result of the call.
+* @param pUserData:  Optional user data (not used).
+*
+**********************************************************************************************************************/
+static void NSMTST__vOnWaitForNodeStateFinish(GObject      *pSrcObject,
+                                              GAsyncResult *pRes,
+                                              gpointer      pUserData)
+{
+  GError *pError         = NULL;
+  gint    i32NodeState   = NsmNodeState_NotSet;
+  gint    i32ErrorStatus = NsmErrorStatus_NotSet;
+
+  if(node_state_consumer_call_wait_for_node_state_finish(NODE_STATE_CONSUMER(pSrcObject),
+                                                         &i32NodeState,
+                                                         &i32ErrorStatus,
+                                                         pRes,
+                                                         &pError) == TRUE)
+  {
+    NSMTST__stWaitForNodeState.boReceived    = TRUE;
+    NSMTST__stWaitForNodeState.enErrorStatus = (NsmErrorStatus_e) i32ErrorStatus;
+    NSMTST__stWaitForNodeState.enNodeState   = (NsmNodeState_e)   i32NodeState;
+  }
+  else
+  {
+    /* D-Bus error. Leave "boReceived" FALSE, so that the check fails */
+    g_error_free(pError);
+  }
+}
+
+
 /**********************************************************************************************************************
 *
 * Callback for the SessionState signal. Store the parameters
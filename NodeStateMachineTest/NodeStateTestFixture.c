@@ -0,0 +1,415 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the fixture of the NSM test executables.
+*
+* The file implements the parts, which NodeStateLoadTest, NodeStateReexec and NodeStateRestoreTest have in common:
+* The lifecycle clients of the test seat, the proxies, the registration at the NSM and the seat lifecycle requests.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+/* System header files                                                                          */
+#include <gio/gio.h>                    /* Use glib to access dbus and communicate to NSM       */
+#include <stdio.h>                      /* printf                                               */
+
+/* Own header files                                                                             */
+#include "NodeStateTestFixture.h"       /* Fixture of the test executables                      */
+
+
+/**********************************************************************************************************************
+*
+* Local defines, macros and type definitions.
+*
+**********************************************************************************************************************/
+
+/* The type passes the test to the test thread */
+typedef struct
+{
+  NSMTF_tstFixture *pstFixture; /* Fixture of the test        */
+  NSMTF_tpfTest     pfTest;     /* Test to run                */
+  gboolean          boPassed;   /* Result. Set by the thread  */
+} NSMTF__tstTestRun;
+
+
+/**********************************************************************************************************************
+*
+* Prototypes for file local functions (see implementation for description)
+*
+**********************************************************************************************************************/
+
+static gboolean NSMTF__boOnLifecycleRequest(NodeStateLifeCycleConsumer *pConsumer,
+                                            GDBusMethodInvocation      *pInvocation,
+                                            const guint32               u32LifeCycleRequest,
+                                            const guint32               u32RequestId,
+                                            gpointer                    pUserData);
+static gboolean NSMTF__boExportClients     (NSMTF_tstFixture           *pstFixture);
+static void     NSMTF__vFreeClients        (NSMTF_tstFixture           *pstFixture);
+static gpointer NSMTF__pvRunTest           (gpointer                    pUserData);
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function is called in the main loop, when the NSM called a lifecycle client of the test. The request is
+* answered at once. Like this, measured times only contain the dispatch in the NSM.
+*
+* @param pConsumer:           Skeleton of the called client
+* @param pInvocation:         Method invocation
+* @param u32LifeCycleRequest: Requested shutdown type
+* @param u32RequestId:        Request ID (not used. The client answers synchronously)
+* @param pUserData:           Fixture of the test (NSMTF_tstFixture)
+*
+* @return TRUE: The method has been handled.
+*
+**********************************************************************************************************************/
+static gboolean NSMTF__boOnLifecycleRequest(NodeStateLifeCycleConsumer *pConsumer,
+                                            GDBusMethodInvocation      *pInvocation,
+                                            const guint32               u32LifeCycleRequest,
+                                            const guint32               u32RequestId,
+                                            gpointer                    pUserData)
+{
+  NSMTF_tstFixture *pstFixture = (NSMTF_tstFixture*) pUserData;
+
+  node_state_life_cycle_consumer_complete_lifecycle_request(pConsumer, pInvocation, (gint) NsmErrorStatus_Ok);
+  g_atomic_int_inc(&pstFixture->i32Requests);
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function exports the lifecycle clients of the test. Their requests are dispatched by the main loop.
+*
+* @param pstFixture: Fixture of the test
+*
+* @return TRUE: All clients have been exported. FALSE: Error. Created clients have to be freed nevertheless.
+*
+**********************************************************************************************************************/
+static gboolean NSMTF__boExportClients(NSMTF_tstFixture *pstFixture)
+{
+  /* Function local variables                       */
+  gboolean  boExported   = TRUE;
+  gchar    *sObjName     = NULL;
+  guint     u32ClientIdx = 0;
+
+  pstFixture->apClients = g_new0(NodeStateLifeCycleConsumer*, pstFixture->u32Clients);
+
+  for(u32ClientIdx = 0; (u32ClientIdx < pstFixture->u32Clients) && (boExported == TRUE); u32ClientIdx++)
+  {
+    sObjName                            = g_strdup_printf(pstFixture->sClientObject, u32ClientIdx);
+    pstFixture->apClients[u32ClientIdx] = node_state_life_cycle_consumer_skeleton_new();
+
+    (void) g_signal_connect(pstFixture->apClients[u32ClientIdx], "handle-lifecycle-request", G_CALLBACK(NSMTF__boOnLifecycleRequest), pstFixture);
+
+    boExported = g_dbus_interface_skeleton_export(G_DBUS_INTERFACE_SKELETON(pstFixture->apClients[u32ClientIdx]),
+                                                  pstFixture->pConnection,
+                                                  sObjName,
+                                                  NULL);
+    g_free(sObjName);
+  }
+
+  return boExported;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function frees the lifecycle clients created by NSMTF__boExportClients.
+*
+* @param pstFixture: Fixture of the test
+*
+**********************************************************************************************************************/
+static void NSMTF__vFreeClients(NSMTF_tstFixture *pstFixture)
+{
+  guint u32ClientIdx = 0;
+
+  for(u32ClientIdx = 0; u32ClientIdx < pstFixture->u32Clients; u32ClientIdx++)
+  {
+    if(pstFixture->apClients[u32ClientIdx] != NULL)
+    {
+      g_object_unref(pstFixture->apClients[u32ClientIdx]);
+    }
+  }
+
+  g_free(pstFixture->apClients);
+  pstFixture->apClients = NULL;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function runs the test in an own thread, while the main loop dispatches the lifecycle requests to the clients.
+* The result is stored in the passed test run. Afterwards, the main loop is quit.
+*
+* @param pUserData: Test run (NSMTF__tstTestRun)
+*
+* @return NULL
+*
+**********************************************************************************************************************/
+static gpointer NSMTF__pvRunTest(gpointer pUserData)
+{
+  NSMTF__tstTestRun *pstRun = (NSMTF__tstTestRun*) pUserData;
+
+  pstRun->boPassed = pstRun->pfTest(pstRun->pstFixture);
+
+  g_main_loop_quit(pstRun->pstFixture->pMainLoop);
+
+  return NULL;
+}
+
+
+/**********************************************************************************************************************
+*
+* Interfaces, exported functions. See header for detailed description.
+*
+**********************************************************************************************************************/
+
+gboolean NSMTF_boRun(NSMTF_tstFixture *pstFixture, NSMTF_tpfTest pfTest)
+{
+  /* Function local variables                     */
+  GThread           *pTestThread = NULL;
+  NSMTF__tstTestRun  stRun;
+  GError            *pError      = NULL;
+
+  stRun.pstFixture = pstFixture;
+  stRun.pfTest     = pfTest;
+  stRun.boPassed   = FALSE;
+
+  pstFixture->i32Requests = 0;
+  pstFixture->pConnection = g_bus_get_sync(NSM_BUS_TYPE, NULL, &pError);
+
+  if(pError == NULL)
+  {
+    pstFixture->pMainLoop = g_main_loop_new(NULL, FALSE);
+
+    if(NSMTF__boExportClients(pstFixture) == TRUE)
+    {
+      pTestThread = g_thread_create(&NSMTF__pvRunTest, &stRun, TRUE, NULL);
+      g_main_loop_run(pstFixture->pMainLoop);
+      (void) g_thread_join(pTestThread);
+    }
+    else
+    {
+      printf("Error: Failed to export lifecycle clients.\n");
+    }
+
+    NSMTF__vFreeClients(pstFixture);
+    g_main_loop_unref(pstFixture->pMainLoop);
+    g_object_unref(pstFixture->pConnection);
+    pstFixture->pMainLoop   = NULL;
+    pstFixture->pConnection = NULL;
+  }
+  else
+  {
+    printf("Error: Failed to get bus connection. Error msg.: %s.\n", pError->message);
+    g_error_free(pError);
+  }
+
+  return stRun.boPassed;
+}
+
+
+gboolean NSMTF_boCreateProxies(NSMTF_tstFixture           *pstFixture,
+                               NodeStateConsumer         **ppConsumer,
+                               NodeStateLifecycleControl **ppLifecycleControl)
+{
+  GError *pError = NULL;
+
+  *ppConsumer = node_state_consumer_proxy_new_sync(pstFixture->pConnection,
+                                                     G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES
+                                                   | G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
+                                                   NSM_BUS_NAME,
+                                                   NSM_CONSUMER_OBJECT,
+                                                   NULL,
+                                                   &pError);
+  if(pError == NULL)
+  {
+    *ppLifecycleControl = node_state_lifecycle_control_proxy_new_sync(pstFixture->pConnection,
+                                                                        G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES
+                                                                      | G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS,
+                                                                      NSM_BUS_NAME,
+                                                                      NSM_LIFECYCLE_OBJECT,
+                                                                      NULL,
+                                                                      &pError);
+  }
+
+  if(pError != NULL)
+  {
+    printf("Error: Failed to create proxies. Error msg.: %s.\n", pError->message);
+    g_error_free(pError);
+  }
+
+  return (*ppConsumer != NULL) && (*ppLifecycleControl != NULL);
+}
+
+
+void NSMTF_vFreeProxies(NodeStateConsumer **ppConsumer, NodeStateLifecycleControl **ppLifecycleControl)
+{
+  if(*ppConsumer != NULL)
+  {
+    g_object_unref(*ppConsumer);
+    *ppConsumer = NULL;
+  }
+
+  if(*ppLifecycleControl != NULL)
+  {
+    g_object_unref(*ppLifecycleControl);
+    *ppLifecycleControl = NULL;
+  }
+}
+
+
+gboolean NSMTF_boRegister(NSMTF_tstFixture *pstFixture, NodeStateConsumer *pConsumer)
+{
+  /* Function local variables                                   */
+  gboolean          boRetVal      = TRUE;
+  guint             u32ClientIdx  = 0;
+  gchar            *sObjName      = NULL;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+  GError           *pError        = NULL;
+
+  (void) node_state_consumer_call_register_session_sync(pConsumer,
+                                                        pstFixture->sSessionName,
+                                                        pstFixture->sSessionOwner,
+                                                        (gint) pstFixture->enSeat,
+                                                        (gint) NsmSessionState_Active,
+                                                        (gint*) &enErrorStatus,
+                                                        NULL,
+                                                        &pError);
+
+  boRetVal = (pError == NULL) && (enErrorStatus == NsmErrorStatus_Ok);
+
+  for(u32ClientIdx = 0; (u32ClientIdx < pstFixture->u32Clients) && (boRetVal == TRUE); u32ClientIdx++)
+  {
+    sObjName = g_strdup_printf(pstFixture->sClientObject, u32ClientIdx);
+
+    (void) node_state_consumer_call_register_seat_shutdown_client_sync(pConsumer,
+                                                                       g_dbus_connection_get_unique_name(pstFixture->pConnection),
+                                                                       sObjName,
+                                                                       NSM_SHUTDOWNTYPE_NORMAL,
+                                                                       pstFixture->u32TimeoutMs,
+                                                                       (gint) pstFixture->enSeat,
+                                                                       (gint*) &enErrorStatus,
+                                                                       NULL,
+                                                                       &pError);
+
+    boRetVal = (pError == NULL) && (enErrorStatus == NsmErrorStatus_Ok);
+    g_free(sObjName);
+  }
+
+  if(pError != NULL)
+  {
+    printf("Error: Failed to register at NSM. Error msg.: %s.\n", pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
+
+
+void NSMTF_vUnRegister(NSMTF_tstFixture *pstFixture, NodeStateConsumer *pConsumer)
+{
+  /* Function local variables                                   */
+  guint             u32ClientIdx  = 0;
+  gchar            *sObjName      = NULL;
+  NsmErrorStatus_e  enErrorStatus = NsmErrorStatus_NotSet;
+
+  for(u32ClientIdx = 0; u32ClientIdx < pstFixture->u32Clients; u32ClientIdx++)
+  {
+    sObjName = g_strdup_printf(pstFixture->sClientObject, u32ClientIdx);
+
+    (void) node_state_consumer_call_un_register_shutdown_client_sync(pConsumer,
+                                                                     g_dbus_connection_get_unique_name(pstFixture->pConnection),
+                                                                     sObjName,
+                                                                     NSM_SHUTDOWNTYPE_NORMAL,
+                                                                     (gint*) &enErrorStatus,
+                                                                     NULL,
+                                                                     NULL);
+    g_free(sObjName);
+  }
+
+  (void) node_state_consumer_call_un_register_session_sync(pConsumer,
+                                                           pstFixture->sSessionName,
+                                                           pstFixture->sSessionOwner,
+                                                           (gint) pstFixture->enSeat,
+                                                           (gint*) &enErrorStatus,
+                                                           NULL,
+                                                           NULL);
+}
+
+
+gboolean NSMTF_boRequestSeat(NSMTF_tstFixture          *pstFixture,
+                             NodeStateLifecycleControl *pLifecycleControl,
+                             guint                      u32RequestType,
+                             gint64                    *pi64DurationUs)
+{
+  /* Function local variables                                                   */
+  gboolean          boRetVal       = FALSE;
+  gint64            i64Start       = 0;     /* Monotonic time in us            */
+  gint64            i64Deadline    = 0;     /* Give up waiting for the clients */
+  NsmErrorStatus_e  enErrorStatus  = NsmErrorStatus_NotSet;
+  GError           *pError         = NULL;
+
+  i64Deadline = g_get_monotonic_time() + ((gint64) pstFixture->u32Clients * pstFixture->u32TimeoutMs * 1000);
+
+  do
+  {
+    g_atomic_int_set(&pstFixture->i32Requests, 0);
+    i64Start = g_get_monotonic_time();
+
+    (void) node_state_lifecycle_control_call_request_seat_lifecycle_sync(pLifecycleControl,
+                                                                         (gint) pstFixture->enSeat,
+                                                                         u32RequestType,
+                                                                         (gint*) &enErrorStatus,
+                                                                         NULL,
+                                                                         &pError);
+    if(enErrorStatus != NsmErrorStatus_Ok)
+    {
+      g_usleep(NSMTF_POLL_US);
+    }
+  } while((pError == NULL) && (enErrorStatus != NsmErrorStatus_Ok) && (g_get_monotonic_time() < i64Deadline));
+
+  if(enErrorStatus == NsmErrorStatus_Ok)
+  {
+    while(   (g_atomic_int_get(&pstFixture->i32Requests) < (gint) pstFixture->u32Clients)
+          && (g_get_monotonic_time() < i64Deadline))
+    {
+      g_usleep(NSMTF_POLL_US);
+    }
+
+    if(pi64DurationUs != NULL)
+    {
+      *pi64DurationUs = g_get_monotonic_time() - i64Start;
+    }
+
+    boRetVal = (g_atomic_int_get(&pstFixture->i32Requests) >= (gint) pstFixture->u32Clients);
+  }
+
+  if(pError != NULL)
+  {
+    printf("Error: Failed to request seat lifecycle. Error msg.: %s.\n", pError->message);
+    g_error_free(pError);
+  }
+
+  return boRetVal;
+}
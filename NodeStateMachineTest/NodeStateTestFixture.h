@@ -0,0 +1,127 @@
+#ifndef NSM_NODESTATETESTFIXTURE_H
+#define NSM_NODESTATETESTFIXTURE_H
+
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Header for the fixture of the NSM test executables.
+*
+* The header file defines the fixture shared by NodeStateLoadTest, NodeStateReexec and NodeStateRestoreTest. The
+* fixture exports lifecycle clients on a bus connection, registers them and a session for a test seat at the NSM and
+* runs the test in an own thread, while the main loop answers the lifecycle requests of the NSM.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**********************************************************************************************************************
+*
+*  HEADER FILE INCLUDES
+*
+**********************************************************************************************************************/
+
+#include <gio/gio.h>                    /* Use glib to access dbus and communicate to NSM       */
+#include "NodeStateTypes.h"             /* Know type definitions of NSM                         */
+#include "NodeStateConsumer.h"          /* Consumer interface with publicly available functions */
+#include "NodeStateLifecycleControl.h"  /* Control  interface to request the seat lifecycle     */
+#include "NodeStateLifecycleConsumer.h" /* Consumer interface to offer life cycle clients       */
+
+
+/**********************************************************************************************************************
+*
+*  CONSTANTS
+*
+**********************************************************************************************************************/
+
+/* Interval, in which the fixture checks for called clients */
+#define NSMTF_POLL_US 100
+
+
+/**********************************************************************************************************************
+*
+*  TYPE
+*
+**********************************************************************************************************************/
+
+/* The type defines the fixture of a test. The test fills the configuration, the fixture the remaining members. */
+typedef struct
+{
+  /* Configuration of the test */
+  NsmSeat_e                    enSeat;        /* Seat of the session and the clients                            */
+  const gchar                 *sSessionName;  /* Name of the test session                                       */
+  const gchar                 *sSessionOwner; /* Owner of the test session                                      */
+  const gchar                 *sClientObject; /* Object path of the clients. "%u" is replaced by the client index */
+  guint                        u32Clients;    /* Number of lifecycle clients registered for the seat            */
+  guint                        u32TimeoutMs;  /* Timeout of the clients registered at the NSM                   */
+
+  /* Set by the fixture */
+  GDBusConnection             *pConnection;   /* Bus connection of the test                                     */
+  GMainLoop                   *pMainLoop;     /* Main loop, which dispatches the lifecycle requests             */
+  NodeStateLifeCycleConsumer **apClients;     /* Skeletons of the lifecycle clients                             */
+  volatile gint                i32Requests;   /* Lifecycle requests received. Written by the main loop          */
+} NSMTF_tstFixture;
+
+/* Test run by NSMTF_boRun in an own thread. The return value is the result of the test */
+typedef gboolean (*NSMTF_tpfTest)(NSMTF_tstFixture *pstFixture);
+
+
+/**********************************************************************************************************************
+*
+*  FUNCTION PROTOTYPE
+*
+**********************************************************************************************************************/
+
+/** \brief Connect to the bus, export the clients and run the test.
+\param[in,out] pstFixture Fixture of the test
+\param[in]     pfTest     Test to run in an own thread
+\retval TRUE: The test passed. FALSE: The test failed or the fixture could not be set up. */
+gboolean NSMTF_boRun(NSMTF_tstFixture *pstFixture, NSMTF_tpfTest pfTest);
+
+/** \brief Create the proxies for the Consumer and LifecycleControl interface of the current owner of the bus name.
+\param[in]  pstFixture         Fixture of the test
+\param[out] ppConsumer         Proxy of the Consumer interface
+\param[out] ppLifecycleControl Proxy of the LifecycleControl interface
+\retval TRUE: Both proxies have been created. FALSE: Error. Created proxies have to be freed nevertheless. */
+gboolean NSMTF_boCreateProxies(NSMTF_tstFixture           *pstFixture,
+                               NodeStateConsumer         **ppConsumer,
+                               NodeStateLifecycleControl **ppLifecycleControl);
+
+/** \brief Free the proxies created by ::NSMTF_boCreateProxies. The pointers are set to NULL. */
+void NSMTF_vFreeProxies(NodeStateConsumer **ppConsumer, NodeStateLifecycleControl **ppLifecycleControl);
+
+/** \brief Register the test session and the lifecycle clients of the test seat at the NSM.
+\retval TRUE: Session and all clients have been registered. FALSE: Error. */
+gboolean NSMTF_boRegister(NSMTF_tstFixture *pstFixture, NodeStateConsumer *pConsumer);
+
+/** \brief Unregister the test session and the lifecycle clients. Errors are ignored. */
+void NSMTF_vUnRegister(NSMTF_tstFixture *pstFixture, NodeStateConsumer *pConsumer);
+
+/** \brief Request a shutdown or run up of the test seat and wait until all clients have been called.
+\param[in]  pstFixture        Fixture of the test
+\param[in]  pLifecycleControl Proxy of the LifecycleControl interface
+\param[in]  u32RequestType    NSM_SHUTDOWNTYPE_NORMAL or NSM_SHUTDOWNTYPE_RUNUP
+\param[out] pi64DurationUs    Time from the accepted request until the last client has been called. May be NULL.
+\retval TRUE: All clients have been called. FALSE: Error or timeout.
+
+A request is retried, while the NSM still finishes the former sequence of the seat. */
+gboolean NSMTF_boRequestSeat(NSMTF_tstFixture          *pstFixture,
+                             NodeStateLifecycleControl *pLifecycleControl,
+                             guint                      u32RequestType,
+                             gint64                    *pi64DurationUs);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NSM_NODESTATETESTFIXTURE_H */
@@ -0,0 +1,229 @@
+#ifndef NODESTATEMACHINEASYNC_H
+#define NODESTATEMACHINEASYNC_H
+
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Optional asynchronous interface between the NodeStateManager (NSM) and the NodeStateMachine (NSMC).
+*
+* With the synchronous interface (NodeStateMachine.h), the NSM calls NsmcSetData and NsmcRequestNodeRestart in its
+* own context. A NSMC that does real work in these functions blocks the NSM. A NSMC can additionally implement
+* NsmcInitAsync. The NSM then passes two bounded single-producer/single-consumer rings to the NSMC:
+*
+* - Events:   The NSM pushes the changes of its data and restart requests. The NSMC drains them in an own thread.
+* - Commands: The NSMC pushes data that should be set in the NSM. The NSM drains them in its main loop and handles
+*             them like calls of NsmSetData. The NSMC also answers restart requests here: The NSM only publishes the
+*             RestartReason, after the NSMC pushed the accepted request back as command.
+*
+* The rings do not use locks. Every ring has exactly one producer and one consumer thread. After a push, the producer
+* increments the eventfd of the ring. The consumer can wait for it with poll() and has to read it before it drains
+* the ring. A full ring does not block the producer. The message is dropped and counted instead.
+*
+* The NSM pushes events only after it released its locks. The NSMC is initialized with NsmcInit as before and can
+* call NsmSetData/NsmGetData directly. NsmcLucRequired and NsmcGetInterfaceVersion stay synchronous.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+/** \ingroup SSW_LCS */
+/** \defgroup SSW_NSM_TEMPLATE Node State Manager
+ *  \{
+ */
+/** \defgroup SSW_NSMC_ASYNC Asynchronous NodeStateMachine interface
+ *  \{
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**********************************************************************************************************************
+*
+*  HEADER FILE INCLUDES
+*
+**********************************************************************************************************************/
+
+#include "NodeStateTypes.h"  /* Types of the transported data */
+#include <stdint.h>          /* uint64_t                      */
+#include <string.h>          /* memcpy()                      */
+#include <unistd.h>          /* read(), write()               */
+
+/**********************************************************************************************************************
+*
+*  CONSTANTS
+*
+**********************************************************************************************************************/
+
+#define NSMC_QUEUE_SIZE          256  /**< Messages per ring. Must be a power of two                         */
+#define NSMC_MESSAGE_DATA_SIZE   sizeof(NsmSession_s) /**< Max. size of the data of a message (largest type)  */
+
+/**********************************************************************************************************************
+*
+*  TYPE
+*
+**********************************************************************************************************************/
+
+/**
+ * The enumeration defines the messages that are exchanged via the rings.
+ */
+typedef enum _NsmcMessageType_e
+{
+  NsmcMessageType_SetData,            /**< Event: Data of the NSM changed. Command: Data should be set in the NSM */
+  NsmcMessageType_RequestNodeRestart  /**< Event: A client requested a node restart. Command: The NSMC accepted it */
+} NsmcMessageType_e;
+
+
+/**
+ * The structure defines a message. The data is typed by enData, like the data of NsmcSetData/NsmSetData.
+ */
+typedef struct _NsmcMessage_s
+{
+  NsmcMessageType_e     enType;                 /**< Type of the message                                  */
+  NsmDataType_e         enData;                 /**< SetData: Type of the data                            */
+  unsigned int          u32DataLen;             /**< SetData: Length of the data in unData                */
+  union
+  {
+    NsmNodeState_e       enNodeState;           /**< NsmDataType_NodeState                                */
+    NsmApplicationMode_e enAppMode;             /**< NsmDataType_AppMode                                  */
+    NsmRestartReason_e   enRestartReason;       /**< NsmDataType_RestartReason                            */
+    NsmShutdownReason_e  enShutdownReason;      /**< NsmDataType_ShutdownReason                           */
+    NsmRunningReason_e   enRunningReason;       /**< NsmDataType_RunningReason                            */
+    int                  i32BootMode;           /**< NsmDataType_BootMode                                 */
+    NsmSession_s         stSession;             /**< NsmDataType_SessionState, (Un)RegisterSession        */
+    struct
+    {
+      NsmRestartReason_e enRestartReason;       /**< Reason of the restart                                */
+      unsigned int       u32RestartType;        /**< NSM_SHUTDOWNTYPE_NORMAL or NSM_SHUTDOWNTYPE_FAST     */
+    } stRestart;                                /**< NsmcMessageType_RequestNodeRestart                   */
+    unsigned char        au8Data[NSMC_MESSAGE_DATA_SIZE]; /**< Raw data                                   */
+  } unData;
+} NsmcMessage_s;
+
+
+/**
+ * The structure defines a single-producer/single-consumer ring.
+ */
+typedef struct _NsmcQueue_s
+{
+  volatile unsigned int u32Head;                       /**< Next message to write. Only written by producer */
+  volatile unsigned int u32Tail;                       /**< Next message to read.  Only written by consumer */
+  unsigned int          u32Dropped;                    /**< Messages dropped, because the ring was full     */
+  int                   i32EventFd;                    /**< eventfd, incremented after every push           */
+  NsmcMessage_s         astMessages[NSMC_QUEUE_SIZE];  /**< Messages                                        */
+} NsmcQueue_s;
+
+
+/**********************************************************************************************************************
+*
+*  FUNCTION PROTOTYPE
+*
+**********************************************************************************************************************/
+
+/** \brief Initialize the asynchronous interface of the NodeStateMachine
+\param[in] pstEvents:   Ring, where the NSM pushes its events. The NSMC is the consumer.
+\param[in] pstCommands: Ring, where the NSMC pushes its commands. The NSM is the consumer.
+\retval 1: The NSMC uses the rings. NsmcSetData and NsmcRequestNodeRestart are no longer called.
+        0: The NSMC uses the synchronous interface.
+
+The function is optional. It is called by the NSM after NsmcInit, if the NSMC implements it. The rings stay valid,
+until the NSM terminates. */
+unsigned char NsmcInitAsync(NsmcQueue_s *pstEvents, NsmcQueue_s *pstCommands);
+
+
+/**********************************************************************************************************************
+*
+* The function pushes a message into a ring. It must only be called by the producer of the ring.
+*
+* @param pstQueue:   Ring
+* @param pstMessage: Message that is copied into the ring
+*
+* @return 1: Message pushed. 0: The ring is full. The message has been dropped.
+*
+**********************************************************************************************************************/
+static inline int NsmcQueuePush(NsmcQueue_s *pstQueue, const NsmcMessage_s *pstMessage)
+{
+  int          i32RetVal = 0;
+  uint64_t     u64Signal = 1;
+  unsigned int u32Head   = pstQueue->u32Head;
+
+  if((u32Head - pstQueue->u32Tail) < NSMC_QUEUE_SIZE)
+  {
+    memcpy(&pstQueue->astMessages[u32Head & (NSMC_QUEUE_SIZE - 1)], pstMessage, sizeof(NsmcMessage_s));
+
+    /* Publish the message, before the head is moved */
+    __sync_synchronize();
+    pstQueue->u32Head = u32Head + 1;
+
+    (void) write(pstQueue->i32EventFd, &u64Signal, sizeof(u64Signal));
+    i32RetVal = 1;
+  }
+  else
+  {
+    pstQueue->u32Dropped++;
+  }
+
+  return i32RetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function pops a message from a ring. It must only be called by the consumer of the ring.
+*
+* @param pstQueue:   Ring
+* @param pstMessage: Pointer, where the message should be copied to
+*
+* @return 1: Message popped. 0: The ring is empty.
+*
+**********************************************************************************************************************/
+static inline int NsmcQueuePop(NsmcQueue_s *pstQueue, NsmcMessage_s *pstMessage)
+{
+  int          i32RetVal = 0;
+  unsigned int u32Tail   = pstQueue->u32Tail;
+
+  if(u32Tail != pstQueue->u32Head)
+  {
+    /* Read the message after the head, which published it */
+    __sync_synchronize();
+    memcpy(pstMessage, &pstQueue->astMessages[u32Tail & (NSMC_QUEUE_SIZE - 1)], sizeof(NsmcMessage_s));
+
+    /* Release the slot, after the message has been copied */
+    __sync_synchronize();
+    pstQueue->u32Tail = u32Tail + 1;
+
+    i32RetVal = 1;
+  }
+
+  return i32RetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function resets the eventfd of a ring. The consumer calls it, when the eventfd is readable, before it drains
+* the ring. Like this, no push is missed.
+*
+* @param pstQueue: Ring
+*
+**********************************************************************************************************************/
+static inline void NsmcQueueAcknowledge(NsmcQueue_s *pstQueue)
+{
+  uint64_t u64Signals = 0;
+
+  (void) read(pstQueue->i32EventFd, &u64Signals, sizeof(u64Signals));
+}
+
+
+#ifdef __cplusplus
+}
+#endif
+/** \} */ /* End of SSW_NSMC_ASYNC     */
+/** \} */ /* End of SSW_NSM_TEMPLATE   */
+#endif /* NODESTATEMACHINEASYNC_H */
@@ -0,0 +1,116 @@
+#ifndef NODESTATEMACHINEPLUGIN_H
+#define NODESTATEMACHINEPLUGIN_H
+
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Plugin interface of the NodeStateMachine (NSMC).
+*
+* By default, the NSM uses the NSMC it has been linked against (see "--with-nsmc"). If the environment variable
+* NSM_NSMC_PLUGIN is set to the path of a shared object, the NSM loads it at start up instead. The shared object
+* exports a constant NsmcPlugin_s named NSMC_PLUGIN_SYMBOL, which points to its NSMC functions. A NSMC that
+* implements the interface of NodeStateMachine.h can export it with NSMC_PLUGIN_EXPORT.
+*
+* The plugin is loaded with RTLD_DEEPBIND. Its functions are bound to its own definitions, even if they have the
+* same names as the functions of the linked NSMC. Calls of the plugin into the NSM (NsmSetData, ...) are resolved
+* against the NSM.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+/** \ingroup SSW_LCS */
+/** \defgroup SSW_NSM_TEMPLATE Node State Manager
+ *  \{
+ */
+/** \defgroup SSW_NSMC_PLUGIN NodeStateMachine plugin interface
+ *  \{
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**********************************************************************************************************************
+*
+*  HEADER FILE INCLUDES
+*
+**********************************************************************************************************************/
+
+#include "NodeStateTypes.h"         /* Types of the NSMC functions */
+#include "NodeStateMachineAsync.h"  /* Rings of NsmcInitAsync      */
+
+/**********************************************************************************************************************
+*
+*  CONSTANTS
+*
+**********************************************************************************************************************/
+
+/**
+ *  Version of NsmcPlugin_s, use SswVersion to interpret the value.
+ *  The NSM only loads plugins with the same major version.
+ */
+#define NSMC_PLUGIN_VERSION  0x01000000U
+
+/**
+ *  Version of the NSMC interface (NsmcGetInterfaceVersion), which the NSM expects from a plugin.
+ *  Plugins without an own NodeStateMachine.h return it. The NSM only loads plugins with the same major version.
+ */
+#define NSMC_PLUGIN_INTERFACE_VERSION  0x01010000U
+
+#define NSMC_PLUGIN_SYMBOL   "NsmcPlugin"   /**< Name of the NsmcPlugin_s exported by a plugin */
+
+/**********************************************************************************************************************
+*
+*  TYPE
+*
+**********************************************************************************************************************/
+
+/**
+ * The structure defines the functions of a NSMC plugin. They have the semantics of the functions with the same
+ * name in NodeStateMachine.h and NodeStateMachineAsync.h.
+ */
+typedef struct _NsmcPlugin_s
+{
+  unsigned int       u32PluginVersion;                                       /**< NSMC_PLUGIN_VERSION          */
+  const char        *sName;                                                  /**< Name of the NSMC, for logs   */
+  unsigned char    (*pfInit)(void);                                          /**< NsmcInit                     */
+  unsigned char    (*pfLucRequired)(void);                                   /**< NsmcLucRequired              */
+  NsmErrorStatus_e (*pfSetData)(NsmDataType_e  enData,
+                                unsigned char *pData,
+                                unsigned int   u32DataLen);                  /**< NsmcSetData                  */
+  unsigned char    (*pfRequestNodeRestart)(NsmRestartReason_e enRestartReason,
+                                           unsigned int       u32RestartType); /**< NsmcRequestNodeRestart     */
+  unsigned int     (*pfGetInterfaceVersion)(void);                           /**< NsmcGetInterfaceVersion      */
+  unsigned char    (*pfInitAsync)(NsmcQueue_s *pstEvents,
+                                  NsmcQueue_s *pstCommands);                 /**< NsmcInitAsync. NULL, if the
+                                                                                  NSMC is synchronous only     */
+} NsmcPlugin_s;
+
+
+/**********************************************************************************************************************
+*
+*  MACROS
+*
+**********************************************************************************************************************/
+
+/**
+ * The macro exports the functions of NodeStateMachine.h as plugin. pfAsync is &NsmcInitAsync or NULL.
+ */
+#define NSMC_PLUGIN_EXPORT(sPluginName, pfAsync)                                                                   \
+  const NsmcPlugin_s NsmcPlugin = { NSMC_PLUGIN_VERSION, (sPluginName), &NsmcInit, &NsmcLucRequired,               \
+                                    &NsmcSetData, &NsmcRequestNodeRestart, &NsmcGetInterfaceVersion, (pfAsync) }
+
+
+#ifdef __cplusplus
+}
+#endif
+/** \} */ /* End of SSW_NSMC_PLUGIN    */
+/** \} */ /* End of SSW_NSM_TEMPLATE   */
+#endif /* NODESTATEMACHINEPLUGIN_H */
@@ -33,8 +33,22 @@
 #include "NodeStateAccess.h"                /* Access the IPC (D-Bus)         */
 #include "syslog.h"                         /* Syslog messages                */
 #include <systemd/sd-daemon.h>              /* Systemd wdog                   */
+#ifdef NSM_PCL_FILE
+#include "NodeStatePclFile.h"               /* File-backed PCL stand-in       */
+#else
 #include <persistence_client_library.h>     /* Init/DeInit PCL                */
 #include <persistence_client_library_key.h> /* Access persistent data         */
+#endif
+#include "NodeStateStatePage.h"             /* Shared memory state page       */
+#include <errno.h>                          /* Error of state page mapping    */
+#include "NodeStateMachineAsync.h"          /* Rings of the async NSMC        */
+#include <sys/eventfd.h>                    /* Signal pushes into the rings   */
+#include "NodeStateMachinePlugin.h"         /* Load the NSMC as plugin        */
+#include <dlfcn.h>                          /* dlopen() the NSMC plugin       */
+#include <sys/syscall.h>                    /* memfd_create for the handover  */
+
+/* The asynchronous interface is optional. The symbol is NULL, if the NSMC does not implement it */
+#pragma weak NsmcInitAsync
 
 
 /**********************************************************************************************************************
@@ -47,6 +61,35 @@
 #define NSM_PERS_APPLICATION_MODE_DB  0xFF
 #define NSM_PERS_APPLICATION_MODE_KEY "ERG_OIP_NSM_NODE_APPMODE"
 
+/* Max. number of suspended clients, which are resumed in parallel */
+#define NSM_RESUME_GROUP_SIZE 8
+
+/* Delay to collect session changes, before the "Sessions" property is rebuilt once for all of them */
+#define NSM_SESSIONS_PUBLISH_DELAY_MS 100
+
+/* Snapshot of sessions, lifecycle clients, failed applications and the progress of a lifecycle sequence. The file
+ * should be on a tmpfs. It is mapped and updated in place on every change, which allows to resume after a restart.
+ */
+#ifndef NSM_SNAPSHOT_FILE
+#define NSM_SNAPSHOT_FILE "/run/NodeStateManager.snapshot"
+#endif
+
+#define NSM_SNAPSHOT_MAGIC          0x534D534E /* "NSMS"                                         */
+#define NSM_SNAPSHOT_VERSION        1          /* Increased, when the layout of the file changes */
+#define NSM_SNAPSHOT_MAX_CLIENTS    64         /* Max. number of stored lifecycle clients        */
+#define NSM_SNAPSHOT_MAX_SESSIONS   64         /* Max. number of stored product sessions         */
+#define NSM_SNAPSHOT_MAX_APPS       32         /* Max. number of stored failed applications      */
+#define NSM_SNAPSHOT_NAME_LENGTH    256        /* Max. length of bus and object names (D-Bus)    */
+
+/* Flags of a lifecycle client in the snapshot */
+#define NSM_SNAPSHOT_CLIENT_SHUTDOWN  0x01
+#define NSM_SNAPSHOT_CLIENT_SHED      0x02
+#define NSM_SNAPSHOT_CLIENT_SUSPENDED 0x04
+
+/* Handover of the state to a re-executed NSM. The new instance finds the memfd with the state in the variable */
+#define NSM_HANDOVER_ENV_FD                "NSM_HANDOVER_FD"
+#define NSM_HANDOVER_MAX_PLATFORM_SESSIONS 128 /* Max. number of platform sessions (names x seats) */
+
 /* The type defines the structure for a lifecycle consumer client                             */
 typedef struct
 {
@@ -55,6 +98,11 @@ typedef struct
   guint32                 u32RegisteredMode; /* Bit array of shutdown modes                   */
   NSMA_tLcConsumerHandle  hClient;           /* Handle for proxy object for lifecycle client  */
   gboolean                boShutdown;        /* Only "run up" clients which are shut down     */
+  NsmSeat_e               enSeat;            /* Seat of the client. NotSet for node clients   */
+  guint32                 u32ShedLevel;      /* Level in which the client is shed             */
+  gboolean                boShed;            /* Only "run up" clients which have been shed    */
+  gboolean                boSuspended;       /* Resume suspended clients in parallel groups   */
+  guint32                 u32SnapshotSlot;   /* Slot in the snapshot + 1. 0: Not stored       */
 } NSM__tstLifecycleClient;
 
 
@@ -65,6 +113,94 @@ typedef struct
 } NSM__tstFailedApplication;
 
 
+/* The type defines a lifecycle client in the snapshot. A slot is only valid, if "u32Used" is set */
+typedef struct
+{
+  guint32 u32Used;                                /* Set last, after the slot has been written    */
+  guint32 u32Order;                               /* Registration order. Order of the sequence    */
+  gchar   sBusName[NSM_SNAPSHOT_NAME_LENGTH];     /* Bus name of the lifecycle client             */
+  gchar   sObjName[NSM_SNAPSHOT_NAME_LENGTH];     /* Object path of the client                    */
+  guint32 u32RegisteredMode;                      /* Bit array of shutdown modes                  */
+  guint32 u32TimeoutMs;                           /* Timeout for calls of the client              */
+  gint32  i32Seat;                                /* Seat of the client                           */
+  guint32 u32ShedLevel;                           /* Level in which the client is shed            */
+  guint32 u32Flags;                               /* NSM_SNAPSHOT_CLIENT_* progress in a sequence */
+} NSM__tstSnapshotClient;
+
+
+/* The type defines a product session in the snapshot. Platform sessions are not stored */
+typedef struct
+{
+  guint32      u32Used;                           /* Set last, after the slot has been written    */
+  NsmSession_s stSession;                         /* Name, owner, seat and state of the session   */
+} NSM__tstSnapshotSession;
+
+
+/* The type defines a failed application in the snapshot */
+typedef struct
+{
+  guint32                   u32Used;              /* Set last, after the slot has been written    */
+  NSM__tstFailedApplication stApplication;        /* Name of the failed application               */
+} NSM__tstSnapshotFailedApp;
+
+
+/* The type defines the layout of the snapshot file. Every part is written under the mutex, which guards its data */
+typedef struct
+{
+  guint32                   u32Magic;             /* NSM_SNAPSHOT_MAGIC. 0: Nothing to restore    */
+  guint32                   u32Version;           /* NSM_SNAPSHOT_VERSION                         */
+  guint32                   u32Size;              /* sizeof(NSM__tstSnapshot)                     */
+  gint32                    i32NodeState;         /* NodeState, when the sequence was stored      */
+  gint32                    i32Seat;              /* Seat of a running seat sequence              */
+  guint32                   u32SeatRequestType;   /* Request type of the seat sequence            */
+  guint8                    au8SeatShutdown[NsmSeat_Last];
+  guint32                   u32NextOrder;         /* Order of the next registered client          */
+  NSM__tstSnapshotClient    astClients[NSM_SNAPSHOT_MAX_CLIENTS];
+  NSM__tstSnapshotSession   astSessions[NSM_SNAPSHOT_MAX_SESSIONS];
+  NSM__tstSnapshotFailedApp astFailedApps[NSM_SNAPSHOT_MAX_APPS];
+} NSM__tstSnapshot;
+
+
+/* The type defines the state handed over to a re-executed NSM. The snapshot holds the sessions, lifecycle clients,
+ * failed applications and the sequence. The values and platform sessions, which a restarted NSM gets from the NSMC,
+ * are handed over in addition.
+ */
+typedef struct
+{
+  NSM__tstSnapshot          stSnapshot;           /* Taken, when the handover was created         */
+  gint32                    i32NodeState;         /* Current NodeState                            */
+  gint32                    i32PreviousNodeState; /* NodeState before the last change             */
+  gint32                    i32ThisApplicationMode;
+  gint32                    i32NextApplicationMode;
+  gint32                    i32BootMode;
+  gint32                    i32RestartReason;
+  gint32                    i32ShutdownReason;
+  gint32                    i32RunningReason;
+  guint32                   u32PlatformSessions;  /* Used entries in astPlatformSessions          */
+  NsmSession_s              astPlatformSessions[NSM_HANDOVER_MAX_PLATFORM_SESSIONS];
+  gint64                    i64ReleaseTime;       /* Monotonic time, when the old instance stopped */
+} NSM__tstHandover;
+
+
+/* The type stores a subscription of the NSMC. The hash of the session name is compiled at subscription time */
+typedef struct
+{
+  gboolean          boUsed;          /* Entry is in use                                  */
+  NsmSubscription_s stSubscription;  /* Filters and callbacks passed by the NSMC         */
+  guint             u32SessionHash;  /* g_str_hash of the session name. 0: all sessions  */
+} NSM__tstSubscription;
+
+
+/* The type stores the callbacks of a matching subscription, which are called after the lock has been released */
+typedef struct
+{
+  NsmDataCallback_f      pfDataCallback;      /* NULL, if the data type does not match */
+  NsmNodeStateCallback_f pfNodeStateCallback; /* NULL, if the transition does not match */
+  NsmSessionCallback_f   pfSessionCallback;   /* NULL, if the session does not match    */
+  void                  *pUserData;           /* User data of the subscription          */
+} NSM__tstSubscriptionCall;
+
+
 /* List of names for the available default sessions, will are automatically provided by NSM    */
 static const gchar* NSM__asDefaultSessions[] = { "DiagnosisSession",
                                                  "HevacSession",
@@ -111,7 +247,44 @@ static NsmErrorStatus_e NSM__enSetAppStateValid    (NSM__tstFailedApplication* p
 
 /* Helper functions to control and start the "lifecycle request" sequence */
 static void NSM__vCallNextLifecycleClient(void);
-static void NSM__vOnLifecycleRequestFinish(const NsmErrorStatus_e enErrorStatus);
+static NSM__tstLifecycleClient* NSM__pstFindNextLifecycleClient(const guint32   u32ShutdownType,
+                                                                const NsmSeat_e enSeat);
+static GList* NSM__pFindNextShedLevelClients(const guint32 u32ShutdownType);
+static GList* NSM__pFindNextResumeClients(void);
+static GList* NSM__pFindLucRunupClients(void);
+
+
+/* Helper functions to store and restore the lifecycle clients and the progress of a lifecycle sequence */
+static void NSM__vStoreLifecycleState  (void);
+static void NSM__vRestoreLifecycleState(void);
+static void NSM__vOnRestoredBusNameChecked(const gchar *sBusName, gboolean boHasOwner, gpointer pUserData);
+static void NSM__vFinishRestore        (void);
+
+/* Helper functions to keep the snapshot up to date and to restore sessions and failed applications from it */
+static void NSM__vOpenSnapshot         (void);
+static void NSM__vRestoreSnapshot      (void);
+static void NSM__vSnapshotClient       (NSM__tstLifecycleClient         *pClient);
+static void NSM__vSnapshotRemoveClient (NSM__tstLifecycleClient         *pClient);
+static void NSM__vSnapshotSession      (NsmSession_s                    *pstSession);
+static void NSM__vSnapshotFailedApp    (const NSM__tstFailedApplication *pstFailedApp,
+                                        const gboolean                   boFailed);
+static void NSM__vSyncSnapshot         (void);
+static void NSM__vDiscardSnapshot      (void);
+static void NSM__vCloseSnapshot        (void);
+static void NSM__vOnHandleBusNameAcquired(void);
+
+/* Helper functions to re-execute the NSM and to hand the state over to the new instance */
+static gboolean NSM__boOnHandleReexecIdle(gpointer pUserData);
+static gboolean NSM__boStartHandover     (void);
+static void     NSM__vReexec             (void);
+static void     NSM__vReadHandover       (void);
+static void     NSM__vApplyHandover      (void);
+static gint32   NSM__i32CheckHandoverValue(const gchar *sValue,
+                                           gint32       i32Value,
+                                           gint32       i32First,
+                                           gint32       i32Last,
+                                           gint32       i32Default);
+static void NSM__vOnLifecycleRequestFinish(NSMA_tLcConsumerHandle hLcClient, const NsmErrorStatus_e enErrorStatus);
 
 
 /* Internal functions, to set and get values. Indirectly used by D-Bus and StateMachine */
@@ -131,7 +304,11 @@ static NsmErrorStatus_e     NSM__enSetApplicationMode    (NsmApplicationMode_e e
                                                           gboolean             boInformMachine);
 static NsmErrorStatus_e     NSM__enSetShutdownReason     (NsmShutdownReason_e  enNewShutdownReason,
                                                           gboolean             boInformMachine);
+static void                 NSM__vMeasureResume          (NsmNodeState_e       enOldNodeState,
+                                                          NsmNodeState_e       enNewNodeState);
 
+static void                 NSM__vPublishSessions        (void);
+static gboolean             NSM__boOnPublishSessions     (gpointer pUserData);
 static void                 NSM__vPublishSessionChange   (NsmSession_s        *pstChangedSession,
                                                           gboolean             boInformBus,
                                                           gboolean             boInformMachine);
@@ -161,6 +338,8 @@ static NsmErrorStatus_e NSM__enOnHandleRequestNodeRestart       (const NsmRestar
 static NsmErrorStatus_e NSM__enOnHandleSetAppHealthStatus       (const gchar                *sAppName,
                                                                  const gboolean              boAppState);
 static gboolean         NSM__boOnHandleCheckLucRequired         (void);
+static NsmErrorStatus_e NSM__enOnHandleRequestSeatLifecycle     (const NsmSeat_e             enSeatId,
+                                                                 const guint                 u32RequestType);
 static NsmErrorStatus_e NSM__enOnHandleRegisterSession          (const gchar                *sSessionName,
                                                                  const gchar                *sSessionOwner,
                                                                  const NsmSeat_e             enSeatId,
@@ -171,6 +350,11 @@ static NsmErrorStatus_e NSM__enOnHandleUnRegisterSession        (const gchar
 static NsmErrorStatus_e NSM__enOnHandleRegisterLifecycleClient  (const gchar                *sBusName,
                                                                  const gchar                *sObjName,
                                                                  const guint                 u32ShutdownMode,
+                                                                 const guint                 u32TimeoutMs,
+                                                                 const NsmSeat_e             enSeatId);
+static NsmErrorStatus_e NSM__enOnHandleRegisterLoadSheddingClient(const gchar               *sBusName,
+                                                                 const gchar                *sObjName,
+                                                                 const guint                 u32ShedLevel,
                                                                  const guint                 u32TimeoutMs);
 static NsmErrorStatus_e NSM__enOnHandleUnRegisterLifecycleClient(const gchar                *sBusName,
                                                                  const gchar                *sObjName,
@@ -184,6 +368,7 @@ static NsmErrorStatus_e NSM__enOnHandleSetSessionState          (const gchar
                                                                  const NsmSessionState_e     enSessionState);
 static guint NSM__u32OnHandleGetAppHealthCount                  (void);
 static guint NSM__u32OnHandleGetInterfaceVersion                (void);
+static NsmErrorStatus_e NSM__enOnHandleReexec                   (void);
 
 /* Functions to simplify internal work flow */
 static void  NSM__vInitializeVariables   (void);
@@ -200,6 +385,48 @@ static void NSM__vSyslogClose(void);
 static gboolean NSM__boOnHandleTimerWdog(gpointer pUserData);
 static void     NSM__vConfigureWdogTimer(void);
 
+/* Functions to configure the rate limit of D-Bus callers */
+static gboolean NSM__boParseRateValue   (const gchar *sValue, guint *pu32Value);
+static void     NSM__vConfigureRateLimit(void);
+
+/* Function to select the linked NSMC or load a NSMC plugin */
+static gboolean NSM__boLoadNsmc(void);
+
+/* Functions for the asynchronous interface of the NSMC */
+static void             NSM__vInitNsmcAsync         (void);
+static NsmErrorStatus_e NSM__enInformMachine        (NsmDataType_e  enData,
+                                                     const void    *pData,
+                                                     guint          u32DataLen,
+                                                     NsmNodeState_e enOldNodeState);
+static gboolean         NSM__boRequestMachineRestart(NsmRestartReason_e enRestartReason, guint u32RestartType);
+static void             NSM__vInformMachineAppHealth(const gchar *sAppName, gboolean boRunning);
+static gboolean         NSM__boOnNsmcCommand        (GIOChannel *pChannel, GIOCondition enCondition, gpointer pUserData);
+
+/* Functions for the subscriptions of the NSMC */
+static void             NSM__vCompileSubscriptionFilter(void);
+static gboolean         NSM__boDispatchSubscriptions   (NsmDataType_e  enData,
+                                                        const void    *pData,
+                                                        guint          u32DataLen,
+                                                        NsmNodeState_e enOldNodeState);
+
+/* Functions to mirror the state of the NSM into the shared memory state page */
+static void NSM__vOpenStatePage  (void);
+static void NSM__vUpdateStatePage(void);
+static void NSM__vCloseStatePage (void);
+
+/* Functions to initialize the PCL, prefetch the persistent data and write the ApplicationMode behind */
+static void     NSM__vReadThisApplicationMode(void);
+static void     NSM__vInitPersistence        (void);
+static void     NSM__vWaitForPrefetch        (void);
+static void     NSM__vStartPersistence       (void);
+static void     NSM__vPersistApplicationMode (NsmApplicationMode_e enApplicationMode);
+static void     NSM__vFlushPersistence       (void);
+static void     NSM__vStopPersistence        (void);
+static gpointer NSM__pvPersistenceThread     (gpointer pUserData);
+
+/* Function to log the duration of the start up phases */
+static void NSM__vLogStartupPhase(const gchar *sPhase);
+
 /**********************************************************************************************************************
 *
 * Local variables and constants
@@ -212,11 +439,14 @@ DLT_DECLARE_CONTEXT(NsmContext);
 /* Variables for "Properties" hosted by the NSM */
 static GMutex                    *NSM__pSessionMutex           = NULL;
 static GSList                    *NSM__pSessions               = NULL;
+static volatile gint              NSM__i32SessionsPending      = 0;    /* Rebuild of "Sessions" property scheduled */
 
 static GList                     *NSM__pLifecycleClients       = NULL;
 
+/* The NodeState is changed under the mutex, but written atomically. Queries can read it without waiting for the lock */
 static GMutex                    *NSM__pNodeStateMutex         = NULL;
 static NsmNodeState_e             NSM__enNodeState             = NsmNodeState_NotSet;
+static NsmNodeState_e             NSM__enPreviousNodeState     = NsmNodeState_NotSet; /* Before the last change */
 
 static GMutex                    *NSM__pNextApplicationModeMutex = NULL;
 static GMutex                    *NSM__pThisApplicationModeMutex = NULL;
@@ -224,10 +454,75 @@ static NsmApplicationMode_e       NSM__enNextApplicationMode     = NsmApplicatio
 static NsmApplicationMode_e       NSM__enThisApplicationMode     = NsmApplicationMode_NotSet;
 static gboolean                   NSM__boThisApplicationModeRead = FALSE;
 
+static GMutex                    *NSM__pFailedApplicationsMutex = NULL;
 static GSList                    *NSM__pFailedApplications     = NULL;
 
-/* Variables for internal state management (of lifecycle requests) */
-static NSM__tstLifecycleClient   *NSM__pCurrentLifecycleClient = NULL;
+/* Variables for internal state management (of lifecycle requests). Clients of a shed level are called in parallel */
+static guint32                    NSM__u32PendingLifecycleRequests = 0;
+
+/* Variables for seat specific lifecycle requests. Only one seat sequence can be active at a time */
+static NsmSeat_e                  NSM__enLifecycleSeat         = NsmSeat_NotSet;
+static guint32                    NSM__u32SeatRequestType      = NSM_SHUTDOWNTYPE_NOT;
+static gboolean                   NSM__aboSeatShutdown[NsmSeat_Last];
+
+/* Start time of the last resume from "Suspended". Used to measure the time until the node is "FullyRunning" */
+static gint64                     NSM__i64ResumeStartTime      = 0;
+
+/* Start time of the parallel run up of 'Last user context' clients. 0, if no run up is pending */
+static gint64                     NSM__i64LucRunupStartTime    = 0;
+
+/* Shared memory page, where the state is mirrored to for readers without IPC. Writers serialize on the mutex */
+static GMutex                    *NSM__pStatePageMutex         = NULL;
+static NsmStatePage_s            *NSM__pstStatePage            = NULL;
+
+/* Write-behind of the ApplicationMode. Only the last value is kept, the worker thread writes it to the PCL */
+static GMutex                    *NSM__pPersistMutex           = NULL;
+static GCond                     *NSM__pPersistCond            = NULL;
+static GThread                   *NSM__pPersistThread          = NULL;
+static NsmApplicationMode_e       NSM__enPersistApplicationMode = NsmApplicationMode_NotSet;
+static gboolean                   NSM__boPersistPending        = FALSE; /* Value waits to be written     */
+static gboolean                   NSM__boPersistBusy           = FALSE; /* Worker is writing to the PCL  */
+static gboolean                   NSM__boPersistStop           = FALSE; /* Worker ends, when it is idle   */
+static gboolean                   NSM__boPersistReady          = FALSE; /* PCL initialized, data fetched  */
+
+/* Start time of the NSM. The start up phases are logged relative to it */
+static gint64                     NSM__i64StartupTime          = 0;
+
+/* Mapped snapshot file and the copy of the previous instance's snapshot, which is restored (NULL: nothing to restore) */
+static NSM__tstSnapshot          *NSM__pstSnapshot             = NULL;
+static NSM__tstSnapshot          *NSM__pstRestoreSnapshot      = NULL;
+static guint                      NSM__u32RestoreChecksPending = 0; /* Bus name checks without answer yet       */
+static guint                      NSM__u32RestoreClients       = 0; /* Restored lifecycle clients               */
+static guint                      NSM__u32RestoreClientsGone   = 0; /* Clients removed, their bus name vanished */
+static NsmNodeState_e             NSM__enRestoreNodeState      = NsmNodeState_NotSet; /* Sequence to go on with */
+
+/* Re-execution of the NSM. The old instance passes the memfd with the handover, the new one keeps a copy of it */
+static gboolean                   NSM__boReexecRequested       = FALSE; /* Handover waits for called clients */
+static gboolean                   NSM__boReexecStarted         = FALSE; /* Handover created, the loop ends   */
+static gint                       NSM__i32HandoverFd           = -1;    /* memfd passed to the new instance  */
+static NSM__tstHandover          *NSM__pstHandover             = NULL;  /* State of the old instance         */
+
+/* Functions of the NSMC. The linked NSMC or a plugin loaded from NSM_NSMC_PLUGIN */
+static NsmcPlugin_s               NSM__stNsmc;
+
+/* Rings of the asynchronous NSMC interface. NULL, if the NSMC is called synchronously. Pushes are serialized */
+static GMutex                    *NSM__pNsmcEventMutex         = NULL;
+static NsmcQueue_s               *NSM__pstNsmcEvents           = NULL;
+static NsmcQueue_s               *NSM__pstNsmcCommands         = NULL;
+static guint                      NSM__u32NsmcCommandsDropped  = 0;
+
+/* Subscriptions of the NSMC. The filters of all subscriptions are compiled into the masks, which are checked first */
+static GMutex                    *NSM__pSubscriptionMutex      = NULL;
+static NSM__tstSubscription       NSM__astSubscriptions[NSM_MAX_SUBSCRIPTIONS];
+static guint                      NSM__u32SubscribedTypes      = 0; /* Types with at least one subscription   */
+static guint                      NSM__u32DataCallbackTypes    = 0; /* Types with a data callback             */
+static guint                      NSM__au32SubscribedTransitions[NsmNodeState_Last]; /* New states per old one */
+static guint64                    NSM__u64SessionNameFilter    = 0; /* Bit (hash % 64) per session name       */
+static gboolean                   NSM__boAllSessionsSubscribed = FALSE;
+static guint                      NSM__u32SubscribedSeats      = 0;
+
+/* Changes of the data (by NSMC or D-Bus, single or batch) and snapshots of NsmGetDataMulti serialize on the mutex */
+static GStaticRecMutex            NSM__stNsmcDataMutex         = G_STATIC_REC_MUTEX_INIT;
 
 /* Constant array of callbacks which are registered at the NodeStateAccess library */
 static const NSMA_tstObjectCallbacks NSM__stObjectCallBacks = { &NSM__enOnHandleSetBootMode,
@@ -236,9 +531,11 @@ static const NSMA_tstObjectCallbacks NSM__stObjectCallBacks = { &NSM__enOnHandle
                                                                 &NSM__enOnHandleRequestNodeRestart,
                                                                 &NSM__enOnHandleSetAppHealthStatus,
                                                                 &NSM__boOnHandleCheckLucRequired,
+                                                                &NSM__enOnHandleRequestSeatLifecycle,
                                                                 &NSM__enOnHandleRegisterSession,
                                                                 &NSM__enOnHandleUnRegisterSession,
                                                                 &NSM__enOnHandleRegisterLifecycleClient,
+                                                                &NSM__enOnHandleRegisterLoadSheddingClient,
                                                                 &NSM__enOnHandleUnRegisterLifecycleClient,
                                                                 &NSM__enGetApplicationMode,
                                                                 &NSM__enOnHandleGetSessionState,
@@ -246,7 +543,9 @@ static const NSMA_tstObjectCallbacks NSM__stObjectCallBacks = { &NSM__enOnHandle
                                                                 &NSM__enOnHandleSetSessionState,
                                                                 &NSM__u32OnHandleGetAppHealthCount,
                                                                 &NSM__u32OnHandleGetInterfaceVersion,
-                                                                &NSM__vOnLifecycleRequestFinish
+                                                                &NSM__vOnLifecycleRequestFinish,
+                                                                &NSM__vOnHandleBusNameAcquired,
+                                                                &NSM__enOnHandleReexec
                                                               };
 
 /**********************************************************************************************************************
@@ -299,6 +598,7 @@ static NsmErrorStatus_e NSM__enRegisterSession(NsmSession_s *session, gboolean b
   NsmErrorStatus_e enRetVal     = NsmErrorStatus_NotSet; /* Return value   */
   NsmSession_s     *pNewSession = NULL;  /* Pointer to new created session */
   GSList           *pListEntry  = NULL;  /* Pointer to list entry          */
+  NsmSession_s      stNewSession;        /* Copy of the session to publish */
 
   if(    (g_strcmp0(session->sOwner, NSM_DEFAULT_SESSION_OWNER) != 0)
       && (session->enState                                      > NsmSessionState_Unregistered))
@@ -324,9 +624,8 @@ static NsmErrorStatus_e NSM__enRegisterSession(NsmSession_s *session, gboolean b
 
 	      /* Return OK and append new object */
 	      NSM__pSessions = g_slist_append(NSM__pSessions, pNewSession);
-
-	      /* Inform D-Bus and StateMachine about the new session. */
-	      NSM__vPublishSessionChange(pNewSession, boInformBus, boInformMachine);
+	      NSM__vSnapshotSession(pNewSession);
+	      memcpy(&stNewSession, pNewSession, sizeof(NsmSession_s));
 	    }
 	    else
 	    {
@@ -340,6 +639,12 @@ static NsmErrorStatus_e NSM__enRegisterSession(NsmSession_s *session, gboolean b
 	    }
 
 	    g_mutex_unlock(NSM__pSessionMutex);
+
+	    /* Inform D-Bus and StateMachine about the new session, after the lock has been released. */
+	    if(enRetVal == NsmErrorStatus_Ok)
+	    {
+	      NSM__vPublishSessionChange(&stNewSession, boInformBus, boInformMachine);
+	    }
 	  }
 	  else
 	  {
@@ -382,6 +687,7 @@ static NsmErrorStatus_e NSM__enUnRegisterSession(NsmSession_s *session, gboolean
   NsmErrorStatus_e  enRetVal         = NsmErrorStatus_NotSet; /* Return value                */
   NsmSession_s     *pExistingSession = NULL;                  /* Pointer to existing session */
   GSList           *pListEntry       = NULL;                  /* Pointer to list entry       */
+  NsmSession_s      stLostSession;                            /* Copy of the session         */
 
   if(NSM__boIsPlatformSession(session) == FALSE)
   {
@@ -403,9 +709,8 @@ static NsmErrorStatus_e NSM__enUnRegisterSession(NsmSession_s *session, gboolean
                                         DLT_STRING(" Last state: "), DLT_INT(   pExistingSession->enState));
 
       pExistingSession->enState = NsmSessionState_Unregistered;
-
-      /* Inform D-Bus and StateMachine about the unregistered session */
-      NSM__vPublishSessionChange(pExistingSession, boInformBus, boInformMachine);
+      NSM__vSnapshotSession(pExistingSession);
+      memcpy(&stLostSession, pExistingSession, sizeof(NsmSession_s));
 
       NSM__vFreeSessionObject(pExistingSession);
       NSM__pSessions = g_slist_remove(NSM__pSessions, pExistingSession);
@@ -421,6 +726,12 @@ static NsmErrorStatus_e NSM__enUnRegisterSession(NsmSession_s *session, gboolean
     }
 
     g_mutex_unlock(NSM__pSessionMutex);
+
+    /* Inform D-Bus and StateMachine about the unregistered session, after the lock has been released */
+    if(enRetVal == NsmErrorStatus_Ok)
+    {
+      NSM__vPublishSessionChange(&stLostSession, boInformBus, boInformMachine);
+    }
   }
   else
   {
@@ -436,6 +747,38 @@ static NsmErrorStatus_e NSM__enUnRegisterSession(NsmSession_s *session, gboolean
 }
 
 
+/**********************************************************************************************************************
+*
+* The function measures the time from leaving "Suspended", until the node is "FullyRunning" again.
+*
+* PLEASE NOTE: The function has to be called with a locked NSM__pNodeStateMutex, before the NodeState is changed.
+*
+* @param enOldNodeState: NodeState before the change
+* @param enNewNodeState: NodeState after the change
+*
+**********************************************************************************************************************/
+static void NSM__vMeasureResume(NsmNodeState_e enOldNodeState, NsmNodeState_e enNewNodeState)
+{
+  guint u32ResumeMs = 0; /* Duration of resume */
+
+  if(enOldNodeState == NsmNodeState_Suspended)
+  {
+    NSM__i64ResumeStartTime = g_get_monotonic_time();
+  }
+  else if((enNewNodeState == NsmNodeState_FullyRunning) && (NSM__i64ResumeStartTime != 0))
+  {
+    u32ResumeMs = (guint) ((g_get_monotonic_time() - NSM__i64ResumeStartTime) / 1000);
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Node is FullyRunning after resume."),
+                                      DLT_STRING(" Duration (ms): "), DLT_UINT(u32ResumeMs));
+
+    syslog(LOG_NOTICE, "LTPROF: resume to FullyRunning: %u ms", u32ResumeMs);
+
+    NSM__i64ResumeStartTime = 0;
+  }
+}
+
+
 /**********************************************************************************************************************
 *
 * The function is called from IPC and StateMachine to set the NodeState.
@@ -449,8 +792,9 @@ static NsmErrorStatus_e NSM__enUnRegisterSession(NsmSession_s *session, gboolean
 **********************************************************************************************************************/
 static NsmErrorStatus_e NSM__enSetNodeState(NsmNodeState_e enNodeState, gboolean boInformBus, gboolean boInformMachine)
 {
-  /* Function local variables                                        */
-  NsmErrorStatus_e enRetVal = NsmErrorStatus_NotSet; /* Return value */
+  /* Function local variables                                                 */
+  NsmErrorStatus_e enRetVal       = NsmErrorStatus_NotSet; /* Return value            */
+  NsmNodeState_e   enOldNodeState = NsmNodeState_NotSet;   /* Replaced, under the lock */
 
   /* Check if the passed parameter is valid */
   if((enNodeState > NsmNodeState_NotSet) && (enNodeState < NsmNodeState_Last))
@@ -458,6 +802,8 @@ static NsmErrorStatus_e NSM__enSetNodeState(NsmNodeState_e enNodeState, gboolean
     /* Assert that the Node not already is shut down. Otherwise it will switch of immediately */
     enRetVal = NsmErrorStatus_Ok;
 
+    /* A snapshot of NsmGetDataMulti must not observe the change half done. Lock order: NSMC data, then NodeState */
+    g_static_rec_mutex_lock(&NSM__stNsmcDataMutex);
     g_mutex_lock(NSM__pNodeStateMutex);
 
     /* Only store the new value and emit a signal, if the new value is different */
@@ -468,9 +814,12 @@ static NsmErrorStatus_e NSM__enSetNodeState(NsmNodeState_e enNodeState, gboolean
                                         DLT_STRING(" Old NodeState: "), DLT_INT((gint) NSM__enNodeState),
                                         DLT_STRING(" New NodeState: "), DLT_INT((gint) enNodeState     ));
 
+      NSM__vMeasureResume(NSM__enNodeState, enNodeState);
 
       /* Store the passed NodeState and emit a signal to inform system that the NodeState changed */
-      NSM__enNodeState = enNodeState;
+      enOldNodeState           = NSM__enNodeState;
+      NSM__enPreviousNodeState = NSM__enNodeState;
+      g_atomic_int_set((gint*) &NSM__enNodeState, (gint) enNodeState);
 
       /* If required, inform the D-Bus about the change (send signal) */
       if(boInformBus == TRUE)
@@ -478,17 +827,29 @@ static NsmErrorStatus_e NSM__enSetNodeState(NsmNodeState_e enNodeState, gboolean
         (void) NSMA_boSendNodeStateSignal(NSM__enNodeState);
       }
 
-      /* If required, inform the StateMachine about the change */
+      /* Leave the lock now, because its not recursive. 'NSM__vCallNextLifecycleClient' may need it. */
+      g_mutex_unlock(NSM__pNodeStateMutex);
+      g_static_rec_mutex_unlock(&NSM__stNsmcDataMutex);
+
+      /* If required, inform the StateMachine about the change. Not under the lock, the NSMC may take its time */
       if(boInformMachine == TRUE)
       {
-        NsmcSetData(NsmDataType_NodeState, (unsigned char*) &NSM__enNodeState,  sizeof(NsmDataType_NodeState));
+        (void) NSM__enInformMachine(NsmDataType_NodeState, &enNodeState, sizeof(NsmNodeState_e), enOldNodeState);
       }
 
-      /* Leave the lock now, because its not recursive. 'NSM__vCallNextLifecycleClient' may need it. */
-      g_mutex_unlock(NSM__pNodeStateMutex);
+      NSM__vUpdateStatePage();
+
+      /* The node can be switched off from now on. Write the last ApplicationMode through */
+      if(enNodeState == NsmNodeState_Shutdown)
+      {
+        NSM__vFlushPersistence();
+      }
+
+      /* Return the calls of clients, which wait for the new NodeState */
+      (void) NSMA_boCompleteNodeStateWaiters(enNodeState);
 
       /* Check if a new life cycle request needs to be started based on the new ShutdownType */
-      if(NSM__pCurrentLifecycleClient == NULL)
+      if(NSM__u32PendingLifecycleRequests == 0)
       {
         NSM__vCallNextLifecycleClient();
       }
@@ -497,6 +858,7 @@ static NsmErrorStatus_e NSM__enSetNodeState(NsmNodeState_e enNodeState, gboolean
     {
       /* NodeState stays the same. Just leave the lock. */
       g_mutex_unlock(NSM__pNodeStateMutex);
+      g_static_rec_mutex_unlock(&NSM__stNsmcDataMutex);
     }
   }
   else
@@ -515,6 +877,7 @@ static NsmErrorStatus_e NSM__enSetNodeState(NsmNodeState_e enNodeState, gboolean
 /**********************************************************************************************************************
 *
 * The function is called from IPC and StateMachine to get the NodeState.
+* The NodeState is read without the lock. Like this, the D-Bus thread is not blocked while the core changes it.
 *
 * @return see NsmNodeState_e
 *
@@ -526,10 +889,7 @@ static NsmErrorStatus_e NSM__enGetNodeState(NsmNodeState_e *penNodeState)
   if(penNodeState != NULL)
   {
     enRetVal = NsmErrorStatus_Ok;
-
-    g_mutex_lock(NSM__pNodeStateMutex);
-    *penNodeState = NSM__enNodeState;
-    g_mutex_unlock(NSM__pNodeStateMutex);
+    *penNodeState = (NsmNodeState_e) g_atomic_int_get((gint*) &NSM__enNodeState);
   }
   else
   {
@@ -557,13 +917,21 @@ static NsmErrorStatus_e NSM__enSetBootMode(const gint i32BootMode, gboolean boIn
   gint             i32CurrentBootMode = 0;
   NsmErrorStatus_e enRetVal           = NsmErrorStatus_NotSet;
 
-  /* The BootMode property should be thread safe by D-Bus. No critical section need.  */
+  /* The BootMode property is thread safe. The lock keeps the change out of snapshots of NsmGetDataMulti */
+  g_static_rec_mutex_lock(&NSM__stNsmcDataMutex);
   (void) NSMA_boGetBootMode(&i32CurrentBootMode);
   enRetVal           = NsmErrorStatus_Ok;
 
   if(i32CurrentBootMode != i32BootMode)
   {
     (void) NSMA_boSetBootMode(i32BootMode);
+  }
+
+  g_static_rec_mutex_unlock(&NSM__stNsmcDataMutex);
+
+  if(i32CurrentBootMode != i32BootMode)
+  {
+    NSM__vUpdateStatePage();
 
     DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Changed BootMode."                      ),
                                       DLT_STRING(" Old BootMode: "), DLT_INT(i32CurrentBootMode),
@@ -572,7 +940,7 @@ static NsmErrorStatus_e NSM__enSetBootMode(const gint i32BootMode, gboolean boIn
     /* Inform the machine if desired. The D-Bus will auto. update, because this is property */
     if(boInformMachine == TRUE)
     {
-       NsmcSetData(NsmDataType_BootMode, (unsigned char*) &i32BootMode,  sizeof(gint));
+       (void) NSM__enInformMachine(NsmDataType_BootMode, &i32BootMode, sizeof(gint), NsmNodeState_NotSet);
     }
   }
 
@@ -598,7 +966,7 @@ NSM__enSetApplicationMode(NsmApplicationMode_e enApplicationMode,
 {
   /* Function local variables                                          */
   NsmErrorStatus_e enRetVal   = NsmErrorStatus_NotSet; /* Return value */
-  int              pcl_return = 0;
+  gboolean         boChanged  = FALSE;
 
   /* Check if the passed parameter is valid */
   if(    (enApplicationMode > NsmApplicationMode_NotSet)
@@ -607,6 +975,7 @@ NSM__enSetApplicationMode(NsmApplicationMode_e enApplicationMode,
     /* The passed parameter is valid. Return OK */
     enRetVal = NsmErrorStatus_Ok;
 
+    g_static_rec_mutex_lock(&NSM__stNsmcDataMutex);
     g_mutex_lock(NSM__pNextApplicationModeMutex);
 
     /* Only store new value and emit signal, if new value is different */
@@ -620,66 +989,28 @@ NSM__enSetApplicationMode(NsmApplicationMode_e enApplicationMode,
               DLT_STRING("New AppMode:"); DLT_INT((int) enApplicationMode));
 
       NSM__enNextApplicationMode = enApplicationMode;
+      boChanged                  = TRUE;
 
-      /* If original persistent value has not been read before, get it now! */
-      g_mutex_lock(NSM__pThisApplicationModeMutex);
-
-      if(NSM__boThisApplicationModeRead == FALSE)
-      {
-        /* Get data from persistence */
-        pcl_return = pclKeyReadData(NSM_PERS_APPLICATION_MODE_DB,
-                                    NSM_PERS_APPLICATION_MODE_KEY,
-                                    0,
-                                    0,
-                                    (unsigned char*) &NSM__enThisApplicationMode,
-                                    sizeof(NSM__enThisApplicationMode));
-
-        if(pcl_return != sizeof(NSM__enThisApplicationMode))
-        {
-          NSM__enThisApplicationMode = NsmApplicationMode_NotSet;
-          DLT_LOG(NsmContext,
-                  DLT_LOG_WARN,
-                  DLT_STRING("NSM: Failed to read ApplicationMode.");
-                  DLT_STRING("Error: Unexpected PCL return.");
-                  DLT_STRING("Return:"); DLT_INT(pcl_return));
-        }
-
-        NSM__boThisApplicationModeRead = TRUE;
-      }
-
-      g_mutex_unlock(NSM__pThisApplicationModeMutex);
-
-      /* Write the new application mode to persistence */
-      pcl_return = pclKeyWriteData(NSM_PERS_APPLICATION_MODE_DB,
-                                   NSM_PERS_APPLICATION_MODE_KEY,
-                                   0,
-                                   0,
-                                   (unsigned char*) &NSM__enNextApplicationMode,
-                                   sizeof(NSM__enNextApplicationMode));
-
-      if(pcl_return != sizeof(NSM__enNextApplicationMode))
-      {
-        DLT_LOG(NsmContext,
-                DLT_LOG_ERROR,
-                DLT_STRING("NSM: Failed to persist ApplicationMode.");
-                DLT_STRING("Error: Unexpected PCL return.");
-                DLT_STRING("Return:"); DLT_INT(pcl_return));
-      }
+      /* Hand the new value to the persistence worker. The PCL is not accessed under the lock */
+      NSM__vPersistApplicationMode(NSM__enNextApplicationMode);
 
       if(boInformBus == TRUE)
       {
         NSMA_boSendApplicationModeSignal(NSM__enNextApplicationMode);
       }
-
-      if(boInformMachine == TRUE)
-      {
-         NsmcSetData(NsmDataType_AppMode,
-                     (unsigned char*) &NSM__enNextApplicationMode,
-                     sizeof(NsmApplicationMode_e));
-      }
     }
 
     g_mutex_unlock(NSM__pNextApplicationModeMutex);
+    g_static_rec_mutex_unlock(&NSM__stNsmcDataMutex);
+
+    /* Inform the StateMachine, after the lock has been released */
+    if((boChanged == TRUE) && (boInformMachine == TRUE))
+    {
+      (void) NSM__enInformMachine(NsmDataType_AppMode,
+                                  &enApplicationMode,
+                                  sizeof(NsmApplicationMode_e),
+                                  NsmNodeState_NotSet);
+    }
   }
   else
   {
@@ -708,43 +1039,19 @@ static NsmErrorStatus_e
 NSM__enGetApplicationMode(NsmApplicationMode_e *penApplicationMode)
 {
   NsmErrorStatus_e enRetVal   = NsmErrorStatus_NotSet;
-  int              pcl_return = 0;
 
   if(penApplicationMode != NULL)
   {
-    g_mutex_lock(NSM__pThisApplicationModeMutex);
-
-    /* Check if value already was obtained from persistence */
-    if(NSM__boThisApplicationModeRead == FALSE)
+    /* The value does not change after it has been read. Only the first read needs the lock. */
+    if(g_atomic_int_get(&NSM__boThisApplicationModeRead) == FALSE)
     {
-      /* There was no read attempt before. Read from persistence */
-      pcl_return = pclKeyReadData(NSM_PERS_APPLICATION_MODE_DB,
-                                  NSM_PERS_APPLICATION_MODE_KEY,
-                                  0,
-                                  0,
-                                  (unsigned char*) &NSM__enThisApplicationMode,
-                                  sizeof(NSM__enThisApplicationMode));
-
-      /* Check the PCL return */
-      if(pcl_return != sizeof(NSM__enThisApplicationMode))
-      {
-        /* Read failed. From now on always return 'NsmApplicationMode_NotSet' */
-        NSM__enThisApplicationMode = NsmApplicationMode_NotSet;
-        DLT_LOG(NsmContext,
-                DLT_LOG_WARN,
-                DLT_STRING("NSM: Failed to read ApplicationMode.");
-                DLT_STRING("Error: Unexpected PCL return.");
-                DLT_STRING("Return:"); DLT_INT(pcl_return));
-      }
-
-      /* There was a first read attempt from persistence */
-      NSM__boThisApplicationModeRead = TRUE;
+      /* The worker prefetches the value. Only callers, which are faster than the prefetch, wait */
+      NSM__vWaitForPrefetch();
+      NSM__vReadThisApplicationMode();
     }
 
     enRetVal = NsmErrorStatus_Ok;
     *penApplicationMode = NSM__enThisApplicationMode;
-
-    g_mutex_unlock(NSM__pThisApplicationModeMutex);
   }
   else
   {
@@ -757,549 +1064,942 @@ NSM__enGetApplicationMode(NsmApplicationMode_e *penApplicationMode)
 
 /**********************************************************************************************************************
 *
-* The function is called from the StateMachine. There is no D-Bus interface to set the ShutdownReason,
-* because it is a property.
-*
-* @param enNewShutdownReason: New ShutdownReason that should be stored.
-* @param boInformMachine:     Determines if StateMachine needs to be called on a successful change.
-*                             Most of the time this should be false, because the machine sets the
-*                             value and can check the return value for errors.
-*
-* @return see NsmErrorStatus_e
+* The function reads the ApplicationMode of this lifecycle from the PCL, if it has not been read before.
+* It must be read, before the worker persists the first new ApplicationMode.
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enSetShutdownReason(NsmShutdownReason_e enNewShutdownReason, gboolean boInformMachine)
+static void NSM__vReadThisApplicationMode(void)
 {
-  /* Function local variables                                                          */
-  NsmErrorStatus_e    enRetVal                = NsmErrorStatus_NotSet; /* Return value */
-  NsmShutdownReason_e enCurrentShutdownReason = NsmShutdownReason_NotSet;
+  int pcl_return = 0;
 
-  /* Check if the passed parameter is valid */
-  if((enNewShutdownReason > NsmShutdownReason_NotSet) && (enNewShutdownReason < NsmShutdownReason_Last))
-  {
-    /* The passed parameter is valid. Return OK */
-    enRetVal = NsmErrorStatus_Ok;
-    (void) NSMA_boGetShutdownReason(&enCurrentShutdownReason);
+  g_mutex_lock(NSM__pThisApplicationModeMutex);
 
-    /* Only store the new value and emit a signal, if the new value is different */
-    if(enNewShutdownReason != enCurrentShutdownReason)
+  /* Check if value already was obtained from persistence */
+  if(NSM__boThisApplicationModeRead == FALSE)
+  {
+    /* There was no read attempt before. Read from persistence */
+    pcl_return = pclKeyReadData(NSM_PERS_APPLICATION_MODE_DB,
+                                NSM_PERS_APPLICATION_MODE_KEY,
+                                0,
+                                0,
+                                (unsigned char*) &NSM__enThisApplicationMode,
+                                sizeof(NSM__enThisApplicationMode));
+
+    /* Check the PCL return */
+    if(pcl_return != sizeof(NSM__enThisApplicationMode))
     {
-      /* Store new value and emit signal with new application mode */
-      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Changed ShutdownReason."),
-                                        DLT_STRING(" Old ShutdownReason: "), DLT_INT((gint) enCurrentShutdownReason),
-                                        DLT_STRING(" New ShutdownReason: "), DLT_INT((gint) enNewShutdownReason    ));
-
-      (void) NSMA_boSetShutdownReason(enNewShutdownReason);
-
-      if(boInformMachine == TRUE)
-      {
-         NsmcSetData(NsmDataType_ShutdownReason, (unsigned char*) &enNewShutdownReason, sizeof(NsmShutdownReason_e));
-      }
+      /* Read failed. From now on always return 'NsmApplicationMode_NotSet' */
+      NSM__enThisApplicationMode = NsmApplicationMode_NotSet;
+      DLT_LOG(NsmContext,
+              DLT_LOG_WARN,
+              DLT_STRING("NSM: Failed to read ApplicationMode.");
+              DLT_STRING("Error: Unexpected PCL return.");
+              DLT_STRING("Return:"); DLT_INT(pcl_return));
     }
+
+    /* There was a first read attempt from persistence */
+    g_atomic_int_set(&NSM__boThisApplicationModeRead, TRUE);
   }
-  else
+
+  g_mutex_unlock(NSM__pThisApplicationModeMutex);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function initializes the PCL and prefetches the persistent data of the NSM. Currently, this only is the
+* ApplicationMode of this lifecycle. Called by the worker thread, while the NSM acquires its bus name. Afterwards,
+* the ApplicationMode is published in the state page.
+*
+**********************************************************************************************************************/
+static void NSM__vInitPersistence(void)
+{
+  int pcl_return = 0;
+
+  pcl_return = pclInitLibrary("NodeStateManager",   PCL_SHUTDOWN_TYPE_NORMAL
+                                                  | PCL_SHUTDOWN_TYPE_FAST);
+  if(pcl_return < 0)
   {
-    /* Error: The passed application mode is invalid. Return an error. */
-    enRetVal = NsmErrorStatus_Parameter;
-    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to change ShutdownReason. Invalid parameter."          ),
-                                       DLT_STRING(" Old ShutdownReason: "),     DLT_INT((gint) enCurrentShutdownReason),
-                                       DLT_STRING(" Desired ShutdownReason: "), DLT_INT((gint) enNewShutdownReason    ));
+    DLT_LOG(NsmContext,
+            DLT_LOG_WARN,
+            DLT_STRING("NSM: Failed to initialize PCL.");
+            DLT_STRING("Error: Unexpected PCL return.");
+            DLT_STRING("Return:"); DLT_INT(pcl_return));
   }
 
-  return enRetVal;
+  NSM__vLogStartupPhase("PCL initialized");
+
+  NSM__vReadThisApplicationMode();
+
+  NSM__vLogStartupPhase("Persistent data prefetched");
+
+  /* The state page may have been published before the ApplicationMode was known */
+  NSM__vUpdateStatePage();
 }
 
+
 /**********************************************************************************************************************
 *
-* The function is called when a session state changed. It informs the system (IPC and StateMachine) about
-* the changed session state.
-*
-* @param pstSession:      Pointer to structure with updated session information.
-* @param boInformBus:     Defines whether a D-Bus signal should be send on session change.
-* @param boInformMachine: Defines whether the StateMachine should be informed about session change.
+* The function returns, when the PCL has been initialized and the persistent data has been prefetched.
 *
 **********************************************************************************************************************/
-static void NSM__vPublishSessionChange(NsmSession_s *pstChangedSession, gboolean boInformBus, gboolean boInformMachine)
+static void NSM__vWaitForPrefetch(void)
 {
-  NsmErrorStatus_e enStateMachineReturn = NsmErrorStatus_NotSet;
+  g_mutex_lock(NSM__pPersistMutex);
 
-  if(boInformBus == TRUE)
+  while(NSM__boPersistReady == FALSE)
   {
-    NSMA_boSendSessionSignal(pstChangedSession);
+    g_cond_wait(NSM__pPersistCond, NSM__pPersistMutex);
   }
 
-  if(boInformMachine == TRUE)
+  g_mutex_unlock(NSM__pPersistMutex);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function starts the worker thread. It initializes the PCL, prefetches the persistent data and afterwards writes
+* the ApplicationMode behind to the PCL. If the thread cannot be started, the PCL is initialized synchronously.
+*
+**********************************************************************************************************************/
+static void NSM__vStartPersistence(void)
+{
+  NSM__pPersistCond   = g_cond_new();
+  NSM__pPersistThread = g_thread_create(&NSM__pvPersistenceThread, NULL, TRUE, NULL);
+
+  if(NSM__pPersistThread == NULL)
   {
-    enStateMachineReturn = NsmcSetData(NsmDataType_SessionState, (unsigned char*) pstChangedSession, sizeof(NsmSession_s));
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to start persistence thread. ApplicationMode is written synchronously."));
 
-    if(enStateMachineReturn != NsmErrorStatus_Ok)
-    {
-      DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to inform state machine about changed session state."       ),
-                                         DLT_STRING(" State machine returned: "),      DLT_INT(   enStateMachineReturn       ),
-                                         DLT_STRING(" Application: "),                 DLT_STRING(pstChangedSession->sOwner  ),
-                                         DLT_STRING(" Session: "),                     DLT_STRING(pstChangedSession->sName   ),
-                                         DLT_STRING(" Seat: "),                        DLT_INT(   pstChangedSession->enSeat  ),
-                                         DLT_STRING(" Desired state: "),               DLT_INT(   pstChangedSession->enState));
-    }
+    NSM__vInitPersistence();
+    NSM__boPersistReady = TRUE;
   }
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is called when the state of a product session should be changed.
-*
-* @param pstSession:      Pointer to structure where session name, owner, seat and desired SessionState are defined.
-* @param boInformBus:     Defines whether a D-Bus signal should be send on session change.
-* @param boInformMachine: Defines whether the StateMachine should be informed about session change.
+* The function passes a new ApplicationMode to the worker thread. If the worker did not write the previous value yet,
+* it is replaced. Only the last ApplicationMode has to be persistent.
 *
-* @return see NsmErrorStatus_e
+* @param enApplicationMode: ApplicationMode to persist
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enSetProductSessionState(NsmSession_s *pstSession, gboolean boInformBus, gboolean boInformMachine)
+static void NSM__vPersistApplicationMode(NsmApplicationMode_e enApplicationMode)
 {
-  /* Function local variables                                         */
-  NsmErrorStatus_e  enRetVal = NsmErrorStatus_NotSet; /* Return value */
-  GSList           *pListEntry                   = NULL;
-  NsmSession_s     *pExistingSession             = NULL;
-
-  g_mutex_lock(NSM__pSessionMutex);
+  g_mutex_lock(NSM__pPersistMutex);
 
-  pListEntry = g_slist_find_custom(NSM__pSessions, pstSession, &NSM__i32SessionOwnerNameSeatCompare);
+  NSM__enPersistApplicationMode = enApplicationMode;
+  NSM__boPersistPending         = TRUE;
 
-  if(pListEntry != NULL)
+  if(NSM__pPersistThread != NULL)
   {
-    enRetVal = NsmErrorStatus_Ok;
-    pExistingSession = (NsmSession_s*) pListEntry->data;
-
-    if(pExistingSession->enState != pstSession->enState)
-    {
-      pExistingSession->enState = pstSession->enState;
-      NSM__vPublishSessionChange(pExistingSession, boInformBus, boInformMachine);
-    }
+    g_cond_broadcast(NSM__pPersistCond);
+    g_mutex_unlock(NSM__pPersistMutex);
   }
   else
   {
-    enRetVal = NsmErrorStatus_WrongSession;
-    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to set session state. Session unknown."),
-                                       DLT_STRING(" Application: "),   DLT_STRING(pstSession->sOwner  ),
-                                       DLT_STRING(" Session: "),       DLT_STRING(pstSession->sName   ),
-                                       DLT_STRING(" Seat: "),          DLT_INT(   pstSession->enSeat  ),
-                                       DLT_STRING(" Desired state: "), DLT_INT(   pstSession->enState));
+    /* Without worker, the calling thread writes the value */
+    g_mutex_unlock(NSM__pPersistMutex);
+    NSM__vFlushPersistence();
   }
-
-  g_mutex_unlock(NSM__pSessionMutex);
-
-  return enRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is called when the state of a default session should be changed.
-*
-* @param pstSession:      Pointer to structure where session name, owner, seat and desired SessionState are defined.
-* @param boInformBus:     Defines whether a D-Bus signal should be send on session change.
-* @param boInformMachine: Defines whether the StateMachine should be informed about session change.
-*
-* @return see NsmErrorStatus_e
+* The function returns, when the last ApplicationMode has been written to the PCL. It is called, when the node
+* reaches "Shutdown". If there is no worker thread, the calling thread writes the pending value.
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enSetDefaultSessionState(NsmSession_s *pstSession, gboolean boInformBus, gboolean boInformMachine)
+static void NSM__vFlushPersistence(void)
 {
-  /* Function local variables                                                  */
-  NsmErrorStatus_e  enRetVal          = NsmErrorStatus_NotSet; /* Return value */
-  GSList           *pListEntry        = NULL;
-  NsmSession_s     *pExistingSession  = NULL;
+  gint64               i64Start          = g_get_monotonic_time();
+  gboolean             boWaited          = FALSE;
+  gboolean             boWrite           = FALSE;
+  NsmApplicationMode_e enApplicationMode = NsmApplicationMode_NotSet;
+  int                  pcl_return        = 0;
 
-  /* Lock the sessions to be able to change them! */
-  g_mutex_lock(NSM__pSessionMutex);
-
-  pListEntry = g_slist_find_custom(NSM__pSessions, pstSession, &NSM__i32SessionNameSeatCompare);
+  g_mutex_lock(NSM__pPersistMutex);
 
-  if(pListEntry != NULL)
+  if(NSM__pPersistThread != NULL)
   {
-    pExistingSession = (NsmSession_s*) pListEntry->data;
-
-    /* Check that the caller owns the session */
-    if(g_strcmp0(pExistingSession->sOwner, pstSession->sOwner) == 0)
+    while((NSM__boPersistPending == TRUE) || (NSM__boPersistBusy == TRUE))
     {
-      enRetVal = NsmErrorStatus_Ok;
+      boWaited = TRUE;
+      g_cond_wait(NSM__pPersistCond, NSM__pPersistMutex);
+    }
+  }
+  else if(NSM__boPersistPending == TRUE)
+  {
+    enApplicationMode     = NSM__enPersistApplicationMode;
+    NSM__boPersistPending = FALSE;
+    boWrite               = TRUE;
+  }
 
-      if(pExistingSession->enState != pstSession->enState)
-      {
-        DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Changed default session's state."),
-                                          DLT_STRING(" Application: "), DLT_STRING(pExistingSession->sOwner ),
-                                          DLT_STRING(" Session: "),     DLT_STRING(pExistingSession->sName  ),
-                                          DLT_STRING(" Seat: "),        DLT_INT(   pExistingSession->enSeat ),
-                                          DLT_STRING(" Old state: "),   DLT_INT(   pExistingSession->enState),
-                                          DLT_STRING(" New state: "),   DLT_INT(   pstSession->enState      ));
+  g_mutex_unlock(NSM__pPersistMutex);
 
-        pExistingSession->enState = pstSession->enState;
+  if(boWrite == TRUE)
+  {
+    NSM__vReadThisApplicationMode();
 
-        NSM__vPublishSessionChange(pExistingSession, boInformBus, boInformMachine);
+    pcl_return = pclKeyWriteData(NSM_PERS_APPLICATION_MODE_DB,
+                                 NSM_PERS_APPLICATION_MODE_KEY,
+                                 0,
+                                 0,
+                                 (unsigned char*) &enApplicationMode,
+                                 sizeof(enApplicationMode));
 
-        if(pstSession->enState == NsmSessionState_Inactive)
-        {
-          g_strlcpy(pExistingSession->sOwner, NSM_DEFAULT_SESSION_OWNER, sizeof(pExistingSession->sOwner));
-        }
-      }
-    }
-    else
+    if(pcl_return != sizeof(enApplicationMode))
     {
-      /* The caller does not own the session. Check if he can become the owner. */
-      if(g_strcmp0(pExistingSession->sOwner, NSM_DEFAULT_SESSION_OWNER) == 0)
-      {
-        /* The session has no owner. The new owner can obtain the session by setting it to an "active" state */
-        if(pstSession->enState != NsmSessionState_Inactive)
-        {
-          /* The session has been activated. Overtake the owner. Broadcast new state. */
-          enRetVal = NsmErrorStatus_Ok;
-          g_strlcpy(pExistingSession->sOwner, pstSession->sOwner, sizeof(pExistingSession->sOwner));
+      DLT_LOG(NsmContext,
+              DLT_LOG_ERROR,
+              DLT_STRING("NSM: Failed to persist ApplicationMode.");
+              DLT_STRING("Error: Unexpected PCL return.");
+              DLT_STRING("Return:"); DLT_INT(pcl_return));
+    }
+  }
 
-          DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Changed default session's state."),
-                                            DLT_STRING(" Application: "), DLT_STRING(pExistingSession->sOwner ),
-                                            DLT_STRING(" Session: "),     DLT_STRING(pExistingSession->sName  ),
-                                            DLT_STRING(" Seat: "),        DLT_INT(   pExistingSession->enSeat ),
-                                            DLT_STRING(" Old state: "),   DLT_INT(   pExistingSession->enState),
-                                            DLT_STRING(" New state: "),   DLT_INT(   pstSession->enState      ));
+  if(boWaited == TRUE)
+  {
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Flushed ApplicationMode to persistence."),
+                                      DLT_STRING(" Duration (us): "), DLT_UINT((guint) (g_get_monotonic_time() - i64Start)));
+  }
+}
 
-          pExistingSession->enState = pstSession->enState;
 
-          NSM__vPublishSessionChange(pExistingSession, boInformBus, boInformMachine);
-        }
-        else
-        {
-          /* The session has no owner, but could not be activated because the passed state is "inactive". */
-          enRetVal = NsmErrorStatus_Parameter;
+/**********************************************************************************************************************
+*
+* The function stops the worker thread. A pending ApplicationMode is written before the thread ends.
+*
+**********************************************************************************************************************/
+static void NSM__vStopPersistence(void)
+{
+  if(NSM__pPersistThread != NULL)
+  {
+    g_mutex_lock(NSM__pPersistMutex);
+    NSM__boPersistStop = TRUE;
+    g_cond_broadcast(NSM__pPersistCond);
+    g_mutex_unlock(NSM__pPersistMutex);
 
-          DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to enable default session. Passed state is 'inactive'. "),
-                                             DLT_STRING(" Session: "),                DLT_STRING(pstSession->sName           ),
-                                             DLT_STRING(" Seat: "),                   DLT_INT(   pstSession->enSeat          ),
-                                             DLT_STRING(" Owning     application: "), DLT_STRING(pExistingSession->sOwner    ),
-                                             DLT_STRING(" Requesting application: "), DLT_STRING(pstSession->sOwner          ));
-        }
+    (void) g_thread_join(NSM__pPersistThread);
+    NSM__pPersistThread = NULL;
+  }
+
+  g_cond_free(NSM__pPersistCond);
+  NSM__pPersistCond = NULL;
+}
+
+
+/**********************************************************************************************************************
+*
+* The worker thread initializes the PCL and prefetches the persistent data. Afterwards, it writes the ApplicationMode
+* to the PCL. Values set while a write is running are coalesced, so that the thread only writes the last one
+* afterwards. Waiting flushes are woken after every write.
+*
+* @param pUserData: Optionally user data (not used)
+*
+* @return NULL
+*
+**********************************************************************************************************************/
+static gpointer NSM__pvPersistenceThread(gpointer pUserData)
+{
+  NsmApplicationMode_e enApplicationMode = NsmApplicationMode_NotSet;
+  int                  pcl_return        = 0;
+  gint64               i64Start          = 0;
+
+  /* Initialize the PCL and fetch the data, before the first value is written */
+  NSM__vInitPersistence();
+
+  g_mutex_lock(NSM__pPersistMutex);
+
+  NSM__boPersistReady = TRUE;
+  g_cond_broadcast(NSM__pPersistCond);
+
+  while((NSM__boPersistStop == FALSE) || (NSM__boPersistPending == TRUE))
+  {
+    if(NSM__boPersistPending == TRUE)
+    {
+      enApplicationMode     = NSM__enPersistApplicationMode;
+      NSM__boPersistPending = FALSE;
+      NSM__boPersistBusy    = TRUE;
+      g_mutex_unlock(NSM__pPersistMutex);
+
+      /* The value of this lifecycle has to be read, before it is overwritten */
+      NSM__vReadThisApplicationMode();
+
+      i64Start   = g_get_monotonic_time();
+      pcl_return = pclKeyWriteData(NSM_PERS_APPLICATION_MODE_DB,
+                                   NSM_PERS_APPLICATION_MODE_KEY,
+                                   0,
+                                   0,
+                                   (unsigned char*) &enApplicationMode,
+                                   sizeof(enApplicationMode));
+
+      if(pcl_return != sizeof(enApplicationMode))
+      {
+        DLT_LOG(NsmContext,
+                DLT_LOG_ERROR,
+                DLT_STRING("NSM: Failed to persist ApplicationMode.");
+                DLT_STRING("Error: Unexpected PCL return.");
+                DLT_STRING("Return:"); DLT_INT(pcl_return));
       }
       else
       {
-        /* The session owners do not match and the existing session has an owner */
-        enRetVal = NsmErrorStatus_Error;
-
-        DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to set default session state. Session has another owner."),
-                                           DLT_STRING(" Session: "),                DLT_STRING(pstSession->sName            ),
-                                           DLT_STRING(" Seat: "),                   DLT_INT(   pstSession->enSeat           ),
-                                           DLT_STRING(" Owning     application: "), DLT_STRING(pExistingSession->sOwner     ),
-                                           DLT_STRING(" Requesting application: "), DLT_STRING(pstSession->sOwner           ));
+        DLT_LOG(NsmContext, DLT_LOG_DEBUG, DLT_STRING("NSM: Persisted ApplicationMode."),
+                                           DLT_STRING(" AppMode: "),        DLT_INT((gint) enApplicationMode),
+                                           DLT_STRING(" Duration (us): "), DLT_UINT((guint) (g_get_monotonic_time() - i64Start)));
       }
+
+      g_mutex_lock(NSM__pPersistMutex);
+      NSM__boPersistBusy = FALSE;
+      g_cond_broadcast(NSM__pPersistCond);
+    }
+    else
+    {
+      g_cond_wait(NSM__pPersistCond, NSM__pPersistMutex);
     }
-  }
-  else
-  {
-    /* This should never happen, because the function is only called for default sessions! */
-    enRetVal = NsmErrorStatus_Internal;
-    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Critical error. Default session not found in session list!"),
-                                       DLT_STRING(" Application: "),   DLT_STRING(pstSession->sOwner               ),
-                                       DLT_STRING(" Session: "),       DLT_STRING(pstSession->sName                ),
-                                       DLT_STRING(" Seat: "),          DLT_INT(   pstSession->enSeat               ),
-                                       DLT_STRING(" Desired state: "), DLT_INT(   pstSession->enState              ));
   }
 
-  /* Unlock the sessions again. */
-  g_mutex_unlock(NSM__pSessionMutex);
+  g_mutex_unlock(NSM__pPersistMutex);
 
-  return enRetVal;
+  return NULL;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is called from IPC and StateMachine to set a session state.
+* The function is called from the StateMachine. There is no D-Bus interface to set the ShutdownReason,
+* because it is a property.
 *
-* @param pstSession:      Pointer to structure where session name, owner, seat and desired SessionState are defined.
-* @param boInformBus:     Defines whether a D-Bus signal should be send on session change.
-* @param boInformMachine: Defines whether the StateMachine should be informed about session change.
+* @param enNewShutdownReason: New ShutdownReason that should be stored.
+* @param boInformMachine:     Determines if StateMachine needs to be called on a successful change.
+*                             Most of the time this should be false, because the machine sets the
+*                             value and can check the return value for errors.
 *
 * @return see NsmErrorStatus_e
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enSetSessionState(NsmSession_s *pstSession, gboolean boInformBus, gboolean boInformMachine)
+static NsmErrorStatus_e NSM__enSetShutdownReason(NsmShutdownReason_e enNewShutdownReason, gboolean boInformMachine)
 {
-  /* Function local variables                                           */
-  NsmErrorStatus_e    enRetVal = NsmErrorStatus_NotSet; /* Return value */
+  /* Function local variables                                                          */
+  NsmErrorStatus_e    enRetVal                = NsmErrorStatus_NotSet; /* Return value */
+  NsmShutdownReason_e enCurrentShutdownReason = NsmShutdownReason_NotSet;
 
-  /* Check if the passed parameters are valid. */
-  if(   (g_strcmp0(pstSession->sOwner, NSM_DEFAULT_SESSION_OWNER) != 0)
-     && (pstSession->enState > NsmSessionState_Unregistered           )
-     && (pstSession->enSeat  >  NsmSeat_NotSet                        )
-     && (pstSession->enSeat  <  NsmSeat_Last                          ))
+  /* Check if the passed parameter is valid */
+  if((enNewShutdownReason > NsmShutdownReason_NotSet) && (enNewShutdownReason < NsmShutdownReason_Last))
   {
-    /* Parameters are valid. Check if a platform session state is set */
-    if(NSM__boIsPlatformSession(pstSession) == TRUE)
+    /* The passed parameter is valid. Return OK. The lock keeps the change out of snapshots of NsmGetDataMulti */
+    enRetVal = NsmErrorStatus_Ok;
+    g_static_rec_mutex_lock(&NSM__stNsmcDataMutex);
+    (void) NSMA_boGetShutdownReason(&enCurrentShutdownReason);
+
+    if(enNewShutdownReason != enCurrentShutdownReason)
     {
-      enRetVal = NSM__enSetDefaultSessionState(pstSession, boInformBus, boInformMachine);
+      (void) NSMA_boSetShutdownReason(enNewShutdownReason);
     }
-    else
+
+    g_static_rec_mutex_unlock(&NSM__stNsmcDataMutex);
+
+    /* Only emit a signal, if the new value is different */
+    if(enNewShutdownReason != enCurrentShutdownReason)
     {
-      enRetVal = NSM__enSetProductSessionState(pstSession, boInformBus, boInformMachine);
+      /* Store new value and emit signal with new application mode */
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Changed ShutdownReason."),
+                                        DLT_STRING(" Old ShutdownReason: "), DLT_INT((gint) enCurrentShutdownReason),
+                                        DLT_STRING(" New ShutdownReason: "), DLT_INT((gint) enNewShutdownReason    ));
+
+      NSM__vUpdateStatePage();
+
+      if(boInformMachine == TRUE)
+      {
+         (void) NSM__enInformMachine(NsmDataType_ShutdownReason,
+                                     &enNewShutdownReason,
+                                     sizeof(NsmShutdownReason_e),
+                                     NsmNodeState_NotSet);
+      }
     }
   }
   else
   {
-    /* Error: An invalid parameter has been passed. */
+    /* Error: The passed application mode is invalid. Return an error. */
     enRetVal = NsmErrorStatus_Parameter;
-    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to change session state. Invalid paramter."),
-                                       DLT_STRING(" Application: "),   DLT_STRING(pstSession->sOwner      ),
-                                       DLT_STRING(" Session: "),       DLT_STRING(pstSession->sName       ),
-                                       DLT_STRING(" Seat: "),          DLT_INT(   pstSession->enSeat      ),
-                                       DLT_STRING(" Desired state: "), DLT_INT(   pstSession->enState     ));
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to change ShutdownReason. Invalid parameter."          ),
+                                       DLT_STRING(" Old ShutdownReason: "),     DLT_INT((gint) enCurrentShutdownReason),
+                                       DLT_STRING(" Desired ShutdownReason: "), DLT_INT((gint) enNewShutdownReason    ));
   }
 
   return enRetVal;
 }
 
+/**********************************************************************************************************************
+*
+* The function schedules the rebuild of the "Sessions" property. Changes within NSM_SESSIONS_PUBLISH_DELAY_MS are
+* published with one rebuild. Clients that need every change use the SessionStateChanged signal.
+*
+**********************************************************************************************************************/
+static void NSM__vPublishSessions(void)
+{
+  if(g_atomic_int_compare_and_exchange(&NSM__i32SessionsPending, 0, 1) == TRUE)
+  {
+    (void) g_timeout_add(NSM_SESSIONS_PUBLISH_DELAY_MS, &NSM__boOnPublishSessions, NULL);
+  }
+}
+
 
 /**********************************************************************************************************************
 *
-* The function is called from IPC and StateMachine to get the session state.
+* The function copies all sessions and sets them as "Sessions" property. Clients can get the summary of the
+* sessions via the properties of the Consumer interface, without calling GetSessionState for each session.
 *
-* @param pstSession: Pointer to structure where session name, owner and seat are defined and SessionState will be set.
+* @param pUserData: Optionally user data (not used)
 *
-* @return see NsmErrorStatus_e
+* @return FALSE: Remove the timeout source.
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enGetSessionState(NsmSession_s *pstSession)
+static gboolean NSM__boOnPublishSessions(gpointer pUserData)
 {
-  /* Function local variables                                                                  */
-  NsmErrorStatus_e    enRetVal         = NsmErrorStatus_NotSet; /* Return value                */
-  NsmSession_s       *pExistingSession = NULL;                  /* Pointer to existing session */
-  GSList             *pListEntry       = NULL;
+  NsmSession_s *pstSessions   = NULL;
+  GSList       *pListEntry    = NULL;
+  guint         u32SessionCnt = 0;
 
+  /* Changes from now on schedule a new rebuild. Copy the sessions, so that the lock is not held for the property */
+  g_atomic_int_set(&NSM__i32SessionsPending, 0);
   g_mutex_lock(NSM__pSessionMutex);
 
-  /* Search for session with name, seat and owner. */
-  pListEntry = g_slist_find_custom(NSM__pSessions, pstSession, &NSM__i32SessionNameSeatCompare);
+  pstSessions = g_new(NsmSession_s, g_slist_length(NSM__pSessions));
 
-  if(pListEntry != NULL)
-  {
-    /* Found the session in the list. Return its state. */
-    enRetVal            = NsmErrorStatus_Ok;
-    pExistingSession    = (NsmSession_s*) pListEntry->data;
-    pstSession->enState = pExistingSession->enState;
-  }
-  else
+  for(pListEntry = NSM__pSessions; pListEntry != NULL; pListEntry = g_slist_next(pListEntry))
   {
-    /* Error: The session is unknown. */
-    enRetVal = NsmErrorStatus_WrongSession;
-    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to retrieve session state. Unknown session."),
-                                      DLT_STRING(" Session: "),       DLT_STRING(pstSession->sName        ),
-                                      DLT_STRING(" Seat: "),          DLT_INT(   pstSession->enSeat       ));
+    memcpy(&pstSessions[u32SessionCnt], pListEntry->data, sizeof(NsmSession_s));
+    u32SessionCnt++;
   }
 
   g_mutex_unlock(NSM__pSessionMutex);
 
-  return enRetVal;
-}
-
+  (void) NSMA_boSetSessions(pstSessions, u32SessionCnt);
 
-static void NSM__vFreeFailedApplicationObject(gpointer pFailedApplication)
-{
-  /* Function local variables. Cast the passed object */
-  NSM__tstFailedApplication *pstFailedApplication = (NSM__tstFailedApplication*) pFailedApplication;
+  g_free(pstSessions);
 
-  g_free(pstFailedApplication);
+  return FALSE;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is called either manually for one object or for every "session object", when the list of registered
-* sessions is destroyed with "g_slist_free_full". All memory occupied by the "session object" is released.
-*
-* @param pSession: Pointer to the session object
+* The function is called when a session state changed. It informs the system (IPC and StateMachine) about
+* the changed session state.
 *
-* @return void
+* @param pstSession:      Pointer to structure with updated session information.
+* @param boInformBus:     Defines whether a D-Bus signal should be send on session change.
+* @param boInformMachine: Defines whether the StateMachine should be informed about session change.
 *
 **********************************************************************************************************************/
-static void NSM__vFreeSessionObject(gpointer pSession)
+static void NSM__vPublishSessionChange(NsmSession_s *pstChangedSession, gboolean boInformBus, gboolean boInformMachine)
 {
-  /* Function local variables. Cast the passed object */
-  NsmSession_s *pstSession = (NsmSession_s*) pSession;
+  NsmErrorStatus_e enStateMachineReturn = NsmErrorStatus_NotSet;
 
-  /* Free the session object */
-  g_free(pstSession);
+  NSM__vUpdateStatePage();
+  NSM__vPublishSessions();
+
+  if(boInformBus == TRUE)
+  {
+    NSMA_boSendSessionSignal(pstChangedSession);
+  }
+
+  if(boInformMachine == TRUE)
+  {
+    enStateMachineReturn = NSM__enInformMachine(NsmDataType_SessionState,
+                                                pstChangedSession,
+                                                sizeof(NsmSession_s),
+                                                NsmNodeState_NotSet);
+
+    if(enStateMachineReturn != NsmErrorStatus_Ok)
+    {
+      DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to inform state machine about changed session state."       ),
+                                         DLT_STRING(" State machine returned: "),      DLT_INT(   enStateMachineReturn       ),
+                                         DLT_STRING(" Application: "),                 DLT_STRING(pstChangedSession->sOwner  ),
+                                         DLT_STRING(" Session: "),                     DLT_STRING(pstChangedSession->sName   ),
+                                         DLT_STRING(" Seat: "),                        DLT_INT(   pstChangedSession->enSeat  ),
+                                         DLT_STRING(" Desired state: "),               DLT_INT(   pstChangedSession->enState));
+    }
+  }
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is called either manually for one object or for every "lifecycle client object", when the list of
-* registered lifecycle clients is destroyed with "g_slist_free_full".
-* All memory occupied by the "lifecycle client object" is released.
+* The function is called when the state of a product session should be changed.
 *
-* @param pLifecycleClient: Pointer to the lifecycle client object
+* @param pstSession:      Pointer to structure where session name, owner, seat and desired SessionState are defined.
+* @param boInformBus:     Defines whether a D-Bus signal should be send on session change.
+* @param boInformMachine: Defines whether the StateMachine should be informed about session change.
 *
-* @return void
+* @return see NsmErrorStatus_e
 *
 **********************************************************************************************************************/
-static void NSM__vFreeLifecycleClientObject(gpointer pLifecycleClient)
+static NsmErrorStatus_e NSM__enSetProductSessionState(NsmSession_s *pstSession, gboolean boInformBus, gboolean boInformMachine)
 {
-  /* Function local variables. Cast the passed object */
-  NSM__tstLifecycleClient *pstLifecycleClient = (NSM__tstLifecycleClient*) pLifecycleClient;
+  /* Function local variables                                         */
+  NsmErrorStatus_e  enRetVal = NsmErrorStatus_NotSet; /* Return value */
+  GSList           *pListEntry                   = NULL;
+  NsmSession_s     *pExistingSession             = NULL;
+  NsmSession_s      stChangedSession;
+  gboolean          boSessionChanged             = FALSE;
 
-  /* Free internal strings and objects */
-  g_free(pstLifecycleClient->sBusName);
-  g_free(pstLifecycleClient->sObjName);
+  g_mutex_lock(NSM__pSessionMutex);
 
-  /* No need to check for NULL. Only valid clients come here */
-  NSMA_boFreeLcConsumerProxy(pstLifecycleClient->hClient);
+  pListEntry = g_slist_find_custom(NSM__pSessions, pstSession, &NSM__i32SessionOwnerNameSeatCompare);
 
-  /* Free the shutdown client object */
-  g_free(pstLifecycleClient);
+  if(pListEntry != NULL)
+  {
+    enRetVal = NsmErrorStatus_Ok;
+    pExistingSession = (NsmSession_s*) pListEntry->data;
+
+    if(pExistingSession->enState != pstSession->enState)
+    {
+      pExistingSession->enState = pstSession->enState;
+      NSM__vSnapshotSession(pExistingSession);
+      memcpy(&stChangedSession, pExistingSession, sizeof(NsmSession_s));
+      boSessionChanged = TRUE;
+    }
+  }
+  else
+  {
+    enRetVal = NsmErrorStatus_WrongSession;
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to set session state. Session unknown."),
+                                       DLT_STRING(" Application: "),   DLT_STRING(pstSession->sOwner  ),
+                                       DLT_STRING(" Session: "),       DLT_STRING(pstSession->sName   ),
+                                       DLT_STRING(" Seat: "),          DLT_INT(   pstSession->enSeat  ),
+                                       DLT_STRING(" Desired state: "), DLT_INT(   pstSession->enState));
+  }
+
+  g_mutex_unlock(NSM__pSessionMutex);
+
+  if(boSessionChanged == TRUE)
+  {
+    NSM__vPublishSessionChange(&stChangedSession, boInformBus, boInformMachine);
+  }
+
+  return enRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is used to "custom compare" and identify a lifecycle client in the list of clients.
-* Because the function is not used for sorting, the return value 1 is not used.
+* The function is called when the state of a default session should be changed.
 *
-* @param pS1: Lifecycle client from list
-* @param pS2: Lifecycle client to compare
+* @param pstSession:      Pointer to structure where session name, owner, seat and desired SessionState are defined.
+* @param boInformBus:     Defines whether a D-Bus signal should be send on session change.
+* @param boInformMachine: Defines whether the StateMachine should be informed about session change.
 *
-* @return -1: pL1 < pL2
-*          0: pL1 = pL2
-*          1: pL1 > pL2 (unused, because function not used for sorting)
+* @return see NsmErrorStatus_e
 *
 **********************************************************************************************************************/
-static gint NSM__i32LifecycleClientCompare(gconstpointer pL1, gconstpointer pL2)
+static NsmErrorStatus_e NSM__enSetDefaultSessionState(NsmSession_s *pstSession, gboolean boInformBus, gboolean boInformMachine)
 {
-  /* Function local variables. Cast the passed objects */
-  NSM__tstLifecycleClient *pListClient    = NULL;
-  NSM__tstLifecycleClient *pCompareClient = NULL;
-  gint                     i32RetVal      = 1;
+  /* Function local variables                                                  */
+  NsmErrorStatus_e  enRetVal          = NsmErrorStatus_NotSet; /* Return value */
+  GSList           *pListEntry        = NULL;
+  NsmSession_s     *pExistingSession  = NULL;
+  NsmSession_s      stChangedSession;
+  gboolean          boSessionChanged  = FALSE;
 
-  pListClient    = (NSM__tstLifecycleClient*) pL1;
-  pCompareClient = (NSM__tstLifecycleClient*) pL2;
+  /* Lock the sessions to be able to change them! */
+  g_mutex_lock(NSM__pSessionMutex);
 
-  /* Compare the bus name of the client */
-  if(g_strcmp0(pListClient->sBusName, pCompareClient->sBusName) == 0)
+  pListEntry = g_slist_find_custom(NSM__pSessions, pstSession, &NSM__i32SessionNameSeatCompare);
+
+  if(pListEntry != NULL)
   {
-    /* Bus names are equal. Now compare object name */
-    if(g_strcmp0(pListClient->sObjName, pCompareClient->sObjName) == 0)
+    pExistingSession = (NsmSession_s*) pListEntry->data;
+
+    /* Check that the caller owns the session */
+    if(g_strcmp0(pExistingSession->sOwner, pstSession->sOwner) == 0)
     {
-      i32RetVal = 0;  /* Clients are identical. Return 0.       */
+      enRetVal = NsmErrorStatus_Ok;
+
+      if(pExistingSession->enState != pstSession->enState)
+      {
+        DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Changed default session's state."),
+                                          DLT_STRING(" Application: "), DLT_STRING(pExistingSession->sOwner ),
+                                          DLT_STRING(" Session: "),     DLT_STRING(pExistingSession->sName  ),
+                                          DLT_STRING(" Seat: "),        DLT_INT(   pExistingSession->enSeat ),
+                                          DLT_STRING(" Old state: "),   DLT_INT(   pExistingSession->enState),
+                                          DLT_STRING(" New state: "),   DLT_INT(   pstSession->enState      ));
+
+        pExistingSession->enState = pstSession->enState;
+
+        memcpy(&stChangedSession, pExistingSession, sizeof(NsmSession_s));
+        boSessionChanged = TRUE;
+
+        if(pstSession->enState == NsmSessionState_Inactive)
+        {
+          g_strlcpy(pExistingSession->sOwner, NSM_DEFAULT_SESSION_OWNER, sizeof(pExistingSession->sOwner));
+        }
+      }
     }
     else
     {
-      i32RetVal = -1; /* Object names are different. Return -1. */
-    }
-  }
-  else
-  {
-    i32RetVal = -1;   /* Bus names are different. Return -1.    */
-  }
+      /* The caller does not own the session. Check if he can become the owner. */
+      if(g_strcmp0(pExistingSession->sOwner, NSM_DEFAULT_SESSION_OWNER) == 0)
+      {
+        /* The session has no owner. The new owner can obtain the session by setting it to an "active" state */
+        if(pstSession->enState != NsmSessionState_Inactive)
+        {
+          /* The session has been activated. Overtake the owner. Broadcast new state. */
+          enRetVal = NsmErrorStatus_Ok;
+          g_strlcpy(pExistingSession->sOwner, pstSession->sOwner, sizeof(pExistingSession->sOwner));
 
-  return i32RetVal;   /* Return result of comparison.           */
-}
+          DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Changed default session's state."),
+                                            DLT_STRING(" Application: "), DLT_STRING(pExistingSession->sOwner ),
+                                            DLT_STRING(" Session: "),     DLT_STRING(pExistingSession->sName  ),
+                                            DLT_STRING(" Seat: "),        DLT_INT(   pExistingSession->enSeat ),
+                                            DLT_STRING(" Old state: "),   DLT_INT(   pExistingSession->enState),
+                                            DLT_STRING(" New state: "),   DLT_INT(   pstSession->enState      ));
 
+          pExistingSession->enState = pstSession->enState;
 
-/**********************************************************************************************************************
-*
-* The function is used to "custom compare" and identify a session in the list of sessions.
-* It compares the "session name", the "session owner" and "seat".
-* Because the function is not used for sorting, the return value 1 is not used.
-*
-* @param pS1: Session from list
-* @param pS2: Session to compare
-*
-* @return -1: pS1 < pS2
-*          0: pS1 = pS2
-*          1: pS1 > pS2 (unused, because function not used for sorting)
-*
-**********************************************************************************************************************/
-static gint NSM__i32SessionOwnerNameSeatCompare(gconstpointer pS1, gconstpointer pS2)
-{
-  /* Function local variables. Cast the passed objects */
-  NsmSession_s *pListSession   = NULL;
-  NsmSession_s *pSearchSession = NULL;
-  gint          i32RetVal      = 1;
+          memcpy(&stChangedSession, pExistingSession, sizeof(NsmSession_s));
+          boSessionChanged = TRUE;
+        }
+        else
+        {
+          /* The session has no owner, but could not be activated because the passed state is "inactive". */
+          enRetVal = NsmErrorStatus_Parameter;
 
-  pListSession   = (NsmSession_s*) pS1;
-  pSearchSession = (NsmSession_s*) pS2;
+          DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to enable default session. Passed state is 'inactive'. "),
+                                             DLT_STRING(" Session: "),                DLT_STRING(pstSession->sName           ),
+                                             DLT_STRING(" Seat: "),                   DLT_INT(   pstSession->enSeat          ),
+                                             DLT_STRING(" Owning     application: "), DLT_STRING(pExistingSession->sOwner    ),
+                                             DLT_STRING(" Requesting application: "), DLT_STRING(pstSession->sOwner          ));
+        }
+      }
+      else
+      {
+        /* The session owners do not match and the existing session has an owner */
+        enRetVal = NsmErrorStatus_Error;
 
-  if(g_strcmp0(pListSession->sOwner,  pSearchSession->sOwner) == 0)
-  {
-    i32RetVal = NSM__i32SessionNameSeatCompare(pS1, pS2);
+        DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to set default session state. Session has another owner."),
+                                           DLT_STRING(" Session: "),                DLT_STRING(pstSession->sName            ),
+                                           DLT_STRING(" Seat: "),                   DLT_INT(   pstSession->enSeat           ),
+                                           DLT_STRING(" Owning     application: "), DLT_STRING(pExistingSession->sOwner     ),
+                                           DLT_STRING(" Requesting application: "), DLT_STRING(pstSession->sOwner           ));
+      }
+    }
   }
   else
   {
-    i32RetVal = -1;    /* Session owners differ. Return -1.  */
+    /* This should never happen, because the function is only called for default sessions! */
+    enRetVal = NsmErrorStatus_Internal;
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Critical error. Default session not found in session list!"),
+                                       DLT_STRING(" Application: "),   DLT_STRING(pstSession->sOwner               ),
+                                       DLT_STRING(" Session: "),       DLT_STRING(pstSession->sName                ),
+                                       DLT_STRING(" Seat: "),          DLT_INT(   pstSession->enSeat               ),
+                                       DLT_STRING(" Desired state: "), DLT_INT(   pstSession->enState              ));
   }
 
-  return i32RetVal;    /* Return result of comparison        */
+  /* Unlock the sessions again. Inform D-Bus and StateMachine afterwards, so that queries are not blocked */
+  g_mutex_unlock(NSM__pSessionMutex);
+
+  if(boSessionChanged == TRUE)
+  {
+    NSM__vPublishSessionChange(&stChangedSession, boInformBus, boInformMachine);
+  }
+
+  return enRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is used to "custom compare" and identify a session in the list of sessions.
-* It compares the "session name" and "seat".
-* Because the function is not used for sorting, the return value 1 is not used.
+* The function is called from IPC and StateMachine to set a session state.
 *
-* @param pS1: Session from list
-* @param pS2: Session to compare
+* @param pstSession:      Pointer to structure where session name, owner, seat and desired SessionState are defined.
+* @param boInformBus:     Defines whether a D-Bus signal should be send on session change.
+* @param boInformMachine: Defines whether the StateMachine should be informed about session change.
 *
-* @return -1: pS1 < pS2
-*          0: pS1 = pS2
-*          1: pS1 > pS2 (unused, because function not used for sorting)
+* @return see NsmErrorStatus_e
 *
 **********************************************************************************************************************/
-static gint NSM__i32SessionNameSeatCompare(gconstpointer pS1, gconstpointer pS2)
+static NsmErrorStatus_e NSM__enSetSessionState(NsmSession_s *pstSession, gboolean boInformBus, gboolean boInformMachine)
 {
-  /* Function local variables. Cast the passed objects */
-  NsmSession_s *pListSession   = NULL;
-  NsmSession_s *pSearchSession = NULL;
-  gint          i32RetVal      = 1;
-
-  pListSession   = (NsmSession_s*) pS1;
-  pSearchSession = (NsmSession_s*) pS2;
+  /* Function local variables                                           */
+  NsmErrorStatus_e    enRetVal = NsmErrorStatus_NotSet; /* Return value */
 
-  /* Compare seats of the sessions. */
-  if(pListSession->enSeat == pSearchSession->enSeat)
+  /* Check if the passed parameters are valid. */
+  if(   (g_strcmp0(pstSession->sOwner, NSM_DEFAULT_SESSION_OWNER) != 0)
+     && (pstSession->enState > NsmSessionState_Unregistered           )
+     && (pstSession->enSeat  >  NsmSeat_NotSet                        )
+     && (pstSession->enSeat  <  NsmSeat_Last                          ))
   {
-    /* Seats are equal. Compare session names. */
-    if(g_strcmp0(pListSession->sName,  pSearchSession->sName)  == 0)
+    /* Parameters are valid. Check if a platform session state is set */
+    if(NSM__boIsPlatformSession(pstSession) == TRUE)
     {
-      i32RetVal = 0;  /* Session are equal. Return 0.      */
+      enRetVal = NSM__enSetDefaultSessionState(pstSession, boInformBus, boInformMachine);
     }
     else
     {
-      i32RetVal = -1; /* Session names differ. Return -1.  */
+      enRetVal = NSM__enSetProductSessionState(pstSession, boInformBus, boInformMachine);
     }
   }
   else
   {
-    i32RetVal = -1;   /* Session seats differ. Return -1.  */
+    /* Error: An invalid parameter has been passed. */
+    enRetVal = NsmErrorStatus_Parameter;
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to change session state. Invalid paramter."),
+                                       DLT_STRING(" Application: "),   DLT_STRING(pstSession->sOwner      ),
+                                       DLT_STRING(" Session: "),       DLT_STRING(pstSession->sName       ),
+                                       DLT_STRING(" Seat: "),          DLT_INT(   pstSession->enSeat      ),
+                                       DLT_STRING(" Desired state: "), DLT_INT(   pstSession->enState     ));
   }
 
-  return i32RetVal;
+  return enRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is used to "custom compare" and identify an application name.
-* Because the function is not used for sorting, the return value 1 is not used.
+* The function is called from IPC and StateMachine to get the session state.
 *
-* @param pA1: Application object from list
-* @param pA2: Application object to compare
+* @param pstSession: Pointer to structure where session name, owner and seat are defined and SessionState will be set.
 *
-* @return -1: pA1 < pA2
-*          0: pA1 = pA2
-*          1: pA1 > pA2 (unused, because function not used for sorting)
+* @return see NsmErrorStatus_e
 *
 **********************************************************************************************************************/
-static gint NSM__i32ApplicationCompare(gconstpointer pA1, gconstpointer pA2)
+static NsmErrorStatus_e NSM__enGetSessionState(NsmSession_s *pstSession)
+{
+  /* Function local variables                                                                  */
+  NsmErrorStatus_e    enRetVal         = NsmErrorStatus_NotSet; /* Return value                */
+  NsmSession_s       *pExistingSession = NULL;                  /* Pointer to existing session */
+  GSList             *pListEntry       = NULL;
+
+  g_mutex_lock(NSM__pSessionMutex);
+
+  /* Search for session with name, seat and owner. */
+  pListEntry = g_slist_find_custom(NSM__pSessions, pstSession, &NSM__i32SessionNameSeatCompare);
+
+  if(pListEntry != NULL)
+  {
+    /* Found the session in the list. Return its state. */
+    enRetVal            = NsmErrorStatus_Ok;
+    pExistingSession    = (NsmSession_s*) pListEntry->data;
+    pstSession->enState = pExistingSession->enState;
+  }
+  else
+  {
+    /* Error: The session is unknown. */
+    enRetVal = NsmErrorStatus_WrongSession;
+    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to retrieve session state. Unknown session."),
+                                      DLT_STRING(" Session: "),       DLT_STRING(pstSession->sName        ),
+                                      DLT_STRING(" Seat: "),          DLT_INT(   pstSession->enSeat       ));
+  }
+
+  g_mutex_unlock(NSM__pSessionMutex);
+
+  return enRetVal;
+}
+
+
+static void NSM__vFreeFailedApplicationObject(gpointer pFailedApplication)
+{
+  /* Function local variables. Cast the passed object */
+  NSM__tstFailedApplication *pstFailedApplication = (NSM__tstFailedApplication*) pFailedApplication;
+
+  g_free(pstFailedApplication);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called either manually for one object or for every "session object", when the list of registered
+* sessions is destroyed with "g_slist_free_full". All memory occupied by the "session object" is released.
+*
+* @param pSession: Pointer to the session object
+*
+* @return void
+*
+**********************************************************************************************************************/
+static void NSM__vFreeSessionObject(gpointer pSession)
+{
+  /* Function local variables. Cast the passed object */
+  NsmSession_s *pstSession = (NsmSession_s*) pSession;
+
+  /* Free the session object */
+  g_free(pstSession);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called either manually for one object or for every "lifecycle client object", when the list of
+* registered lifecycle clients is destroyed with "g_slist_free_full".
+* All memory occupied by the "lifecycle client object" is released.
+*
+* @param pLifecycleClient: Pointer to the lifecycle client object
+*
+* @return void
+*
+**********************************************************************************************************************/
+static void NSM__vFreeLifecycleClientObject(gpointer pLifecycleClient)
+{
+  /* Function local variables. Cast the passed object */
+  NSM__tstLifecycleClient *pstLifecycleClient = (NSM__tstLifecycleClient*) pLifecycleClient;
+
+  /* Free internal strings and objects */
+  g_free(pstLifecycleClient->sBusName);
+  g_free(pstLifecycleClient->sObjName);
+
+  /* No need to check for NULL. Only valid clients come here */
+  NSMA_boFreeLcConsumerProxy(pstLifecycleClient->hClient);
+
+  /* Free the shutdown client object */
+  g_free(pstLifecycleClient);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is used to "custom compare" and identify a lifecycle client in the list of clients.
+* Because the function is not used for sorting, the return value 1 is not used.
+*
+* @param pS1: Lifecycle client from list
+* @param pS2: Lifecycle client to compare
+*
+* @return -1: pL1 < pL2
+*          0: pL1 = pL2
+*          1: pL1 > pL2 (unused, because function not used for sorting)
+*
+**********************************************************************************************************************/
+static gint NSM__i32LifecycleClientCompare(gconstpointer pL1, gconstpointer pL2)
+{
+  /* Function local variables. Cast the passed objects */
+  NSM__tstLifecycleClient *pListClient    = NULL;
+  NSM__tstLifecycleClient *pCompareClient = NULL;
+  gint                     i32RetVal      = 1;
+
+  pListClient    = (NSM__tstLifecycleClient*) pL1;
+  pCompareClient = (NSM__tstLifecycleClient*) pL2;
+
+  /* Compare the bus name of the client */
+  if(g_strcmp0(pListClient->sBusName, pCompareClient->sBusName) == 0)
+  {
+    /* Bus names are equal. Now compare object name */
+    if(g_strcmp0(pListClient->sObjName, pCompareClient->sObjName) == 0)
+    {
+      i32RetVal = 0;  /* Clients are identical. Return 0.       */
+    }
+    else
+    {
+      i32RetVal = -1; /* Object names are different. Return -1. */
+    }
+  }
+  else
+  {
+    i32RetVal = -1;   /* Bus names are different. Return -1.    */
+  }
+
+  return i32RetVal;   /* Return result of comparison.           */
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is used to "custom compare" and identify a session in the list of sessions.
+* It compares the "session name", the "session owner" and "seat".
+* Because the function is not used for sorting, the return value 1 is not used.
+*
+* @param pS1: Session from list
+* @param pS2: Session to compare
+*
+* @return -1: pS1 < pS2
+*          0: pS1 = pS2
+*          1: pS1 > pS2 (unused, because function not used for sorting)
+*
+**********************************************************************************************************************/
+static gint NSM__i32SessionOwnerNameSeatCompare(gconstpointer pS1, gconstpointer pS2)
+{
+  /* Function local variables. Cast the passed objects */
+  NsmSession_s *pListSession   = NULL;
+  NsmSession_s *pSearchSession = NULL;
+  gint          i32RetVal      = 1;
+
+  pListSession   = (NsmSession_s*) pS1;
+  pSearchSession = (NsmSession_s*) pS2;
+
+  if(g_strcmp0(pListSession->sOwner,  pSearchSession->sOwner) == 0)
+  {
+    i32RetVal = NSM__i32SessionNameSeatCompare(pS1, pS2);
+  }
+  else
+  {
+    i32RetVal = -1;    /* Session owners differ. Return -1.  */
+  }
+
+  return i32RetVal;    /* Return result of comparison        */
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is used to "custom compare" and identify a session in the list of sessions.
+* It compares the "session name" and "seat".
+* Because the function is not used for sorting, the return value 1 is not used.
+*
+* @param pS1: Session from list
+* @param pS2: Session to compare
+*
+* @return -1: pS1 < pS2
+*          0: pS1 = pS2
+*          1: pS1 > pS2 (unused, because function not used for sorting)
+*
+**********************************************************************************************************************/
+static gint NSM__i32SessionNameSeatCompare(gconstpointer pS1, gconstpointer pS2)
+{
+  /* Function local variables. Cast the passed objects */
+  NsmSession_s *pListSession   = NULL;
+  NsmSession_s *pSearchSession = NULL;
+  gint          i32RetVal      = 1;
+
+  pListSession   = (NsmSession_s*) pS1;
+  pSearchSession = (NsmSession_s*) pS2;
+
+  /* Compare seats of the sessions. */
+  if(pListSession->enSeat == pSearchSession->enSeat)
+  {
+    /* Seats are equal. Compare session names. */
+    if(g_strcmp0(pListSession->sName,  pSearchSession->sName)  == 0)
+    {
+      i32RetVal = 0;  /* Session are equal. Return 0.      */
+    }
+    else
+    {
+      i32RetVal = -1; /* Session names differ. Return -1.  */
+    }
+  }
+  else
+  {
+    i32RetVal = -1;   /* Session seats differ. Return -1.  */
+  }
+
+  return i32RetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is used to "custom compare" and identify an application name.
+* Because the function is not used for sorting, the return value 1 is not used.
+*
+* @param pA1: Application object from list
+* @param pA2: Application object to compare
+*
+* @return -1: pA1 < pA2
+*          0: pA1 = pA2
+*          1: pA1 > pA2 (unused, because function not used for sorting)
+*
+**********************************************************************************************************************/
+static gint NSM__i32ApplicationCompare(gconstpointer pA1, gconstpointer pA2)
 {
   /* Function local variables. Cast the passed objects */
   NSM__tstFailedApplication *pListApp   = NULL;
@@ -1363,372 +2063,2545 @@ static gint NSM__i32SessionOwnerCompare(gconstpointer pS1, gconstpointer pS2)
 /**********************************************************************************************************************
 *
 * The function is called after a lifecycle client was informed about the changed life cycle.
-* The return value of the last informed client will be evaluated and the next lifecycle client
-* to inform will be determined and called.
+* The return value of the client will be evaluated. If all clients that have been called in parallel returned,
+* the next lifecycle client(s) to inform will be determined and called.
 * If there is no client left, the lifecycle sequence will be finished.
 *
-* @param pSrcObject: Source object (lifecycle client proxy)
-* @param pRes:       Result of asynchronous call
-* @param pUserData:  Pointer to the current lifecycle client object
+* @param hLcClient:     Handle of the lifecycle client that returned
+* @param enErrorStatus: Return value of the lifecycle client
 *
 * @return void
 *
 **********************************************************************************************************************/
-static void NSM__vOnLifecycleRequestFinish(const NsmErrorStatus_e enErrorStatus)
+static void NSM__vOnLifecycleRequestFinish(NSMA_tLcConsumerHandle hLcClient, const NsmErrorStatus_e enErrorStatus)
 {
+  /* Function local variables                                                                 */
+  GList                   *pListEntry    = NULL;  /* Iterate through list entries             */
+  NSM__tstLifecycleClient *pClient       = NULL;  /* Client that returned                     */
+  gboolean                 boCallNext    = FALSE; /* All parallel called clients returned     */
+  gint64                   i64LucRunupUs = -1;    /* Duration of a finished LUC run up in us  */
+
+  /* Find the client that returned. It may have unregistered, while it was called. */
+  for(pListEntry = g_list_first(NSM__pLifecycleClients);
+      (pListEntry != NULL) && (pClient == NULL);
+      pListEntry = g_list_next(pListEntry))
+  {
+    if(((NSM__tstLifecycleClient*) pListEntry->data)->hClient == hLcClient)
+    {
+      pClient = (NSM__tstLifecycleClient*) pListEntry->data;
+    }
+  }
+
   if(enErrorStatus == NsmErrorStatus_Ok)
   {
     /* The clients "LifecycleRequest" has been successfully processed. */
-	NSM__vLtProf(NSM__pCurrentLifecycleClient->sBusName, NSM__pCurrentLifecycleClient->sObjName, 0, "leave: ", 0);
-    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Successfully called lifecycle client."));
+    if(pClient != NULL)
+    {
+      NSM__vLtProf(pClient->sBusName, pClient->sObjName, 0, "leave: ", 0);
+    }
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Successfully called lifecycle client."),
+                                      DLT_STRING(" Client: "), DLT_UINT((guint) hLcClient   ));
   }
   else
   {
     /* Error: The method of the lifecycle client returned an error */
-    NSM__vLtProf(NSM__pCurrentLifecycleClient->sBusName, NSM__pCurrentLifecycleClient->sObjName, 0, "leave: error: ", enErrorStatus);
+    if(pClient != NULL)
+    {
+      NSM__vLtProf(pClient->sBusName, pClient->sObjName, 0, "leave: error: ", enErrorStatus);
+    }
+
     DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to call life cycle client."       ),
+                                      DLT_STRING(" Client: "),       DLT_UINT((guint) hLcClient   ),
                                       DLT_STRING(" Return Value: "), DLT_INT((gint) enErrorStatus));
   }
 
-  NSM__vCallNextLifecycleClient();
-}
+  /* Only go on with the sequence, when the last of the parallel called clients returned */
+  g_mutex_lock(NSM__pNodeStateMutex);
 
+  if(NSM__u32PendingLifecycleRequests > 0)
+  {
+    NSM__u32PendingLifecycleRequests--;
+  }
 
-/**********************************************************************************************************************
-*
-* The function is called when:
-*    - The NodeState changes (NSM__boHandleSetNodeState), to initiate a lifecycle sequence
-*    - A client returned and the next client has to be called (NSM__vOnLifecycleRequestFinish)
-*
-* If the clients need to "run up" or shut down for the current NodeState, the function
-* searches the list forward or backward until a client is found, which needs to be informed.
-*
-* PLEASE NOTE: If all clients have been informed about a "shut down", this function will quit the
-*              "g_main_loop", which leads to the the termination of the NSM!
+  boCallNext = (NSM__u32PendingLifecycleRequests == 0);
+
+  /* Measure when the last 'Last user context' client finished its run up. This is the perceived wake-up latency */
+  if((boCallNext == TRUE) && (NSM__i64LucRunupStartTime != 0))
+  {
+    i64LucRunupUs = g_get_monotonic_time() - NSM__i64LucRunupStartTime;
+    NSM__i64LucRunupStartTime = 0;
+  }
+
+  g_mutex_unlock(NSM__pNodeStateMutex);
+
+  if(i64LucRunupUs >= 0)
+  {
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: All LUC clients have been run up."),
+                                      DLT_STRING(" Duration (ms): "), DLT_UINT((guint) (i64LucRunupUs / 1000)));
+
+    syslog(LOG_NOTICE, "LTPROF: luc runup: %u ms", (guint) (i64LucRunupUs / 1000));
+
+    /* Reported by "GetStatistics" */
+    (void) NSMA_boAddLucRunupTime((guint64) i64LucRunupUs * 1000);
+  }
+
+  /* A requested re-execution takes place between two clients. The new instance calls the next one */
+  if(   (boCallNext             == TRUE )
+     && (   (NSM__boReexecRequested == FALSE)
+         || (NSM__boStartHandover() == FALSE)))
+  {
+    NSM__vCallNextLifecycleClient();
+  }
+}
+
+
+/**********************************************************************************************************************
 *
-* @return void
+* The function searches the list of lifecycle clients for the next client that needs to be informed about
+* the passed shutdown type.
+* For a shutdown the list is searched backward for a client that is registered for the shutdown type and has not
+* been shut down. For a "run up" the list is searched forward for a client that has been shut down.
+*
+* @param u32ShutdownType: Shutdown type for which a client should be found.
+* @param enSeat:          Seat for which a client should be found. If NsmSeat_NotSet is passed, the clients of
+*                         all seats are considered, except "run up" calls for clients of a seat that is shut down.
+*
+* @return Pointer to the next client to inform. NULL if there is no client left.
 *
 **********************************************************************************************************************/
-static void NSM__vCallNextLifecycleClient(void)
+static NSM__tstLifecycleClient* NSM__pstFindNextLifecycleClient(const guint32 u32ShutdownType, const NsmSeat_e enSeat)
 {
-  /* Function local variables                                                                      */
-  GList                   *pListEntry      = NULL;                 /* Iterate through list entries */
-  NSM__tstLifecycleClient *pClient         = NULL;                 /* Client object from list      */
-  guint32                  u32ShutdownType = NSM_SHUTDOWNTYPE_NOT; /* Return value                 */
-  gboolean                 boShutdown      = FALSE;
-
-  NSM__pCurrentLifecycleClient = NULL;
-
-  g_mutex_lock(NSM__pNodeStateMutex);
+  /* Function local variables                                                                */
+  GList                   *pListEntry  = NULL; /* Iterate through list entries               */
+  NSM__tstLifecycleClient *pClient     = NULL; /* Client object from list                    */
+  NSM__tstLifecycleClient *pNextClient = NULL; /* Return value. Next client that is informed */
 
-  /* Based on NodeState determine if clients have to shutdown or run up. Find a client that has not been informed */
-  switch(NSM__enNodeState)
+  if(u32ShutdownType != NSM_SHUTDOWNTYPE_RUNUP)
   {
     /* For "shutdown" search backward in the list, until there is a client that has not been shut down */
-    case NsmNodeState_ShuttingDown:
-      u32ShutdownType = NSM_SHUTDOWNTYPE_NORMAL;
-      for( pListEntry = g_list_last(NSM__pLifecycleClients);
-          (pListEntry != NULL) && (NSM__pCurrentLifecycleClient == NULL);
-          pListEntry = g_list_previous(pListEntry))
-      {
-        /* Check if client has not been shut down and is registered for "normal shutdown" */
-        pClient = (NSM__tstLifecycleClient*) pListEntry->data;
-        if(   (  pClient->boShutdown                           == FALSE)
-           && ( (pClient->u32RegisteredMode & u32ShutdownType) != 0    ))
-        {
-          /* Found a "running" previous client, registered for the shutdown mode */
-          NSM__pCurrentLifecycleClient = (NSM__tstLifecycleClient*) pListEntry->data;
-        }
+    for( pListEntry = g_list_last(NSM__pLifecycleClients);
+        (pListEntry != NULL) && (pNextClient == NULL);
+        pListEntry = g_list_previous(pListEntry))
+    {
+      /* Check if client has not been shut down or suspended, is registered for the shutdown type and belongs to
+         the seat */
+      pClient = (NSM__tstLifecycleClient*) pListEntry->data;
+      if(   (  pClient->boShutdown                           == FALSE)
+         && (  pClient->boSuspended                          == FALSE)
+         && ( (pClient->u32RegisteredMode & u32ShutdownType) != 0    )
+         && ( (enSeat == NsmSeat_NotSet) || (pClient->enSeat == enSeat)))
+      {
+        /* Found a "running" previous client, registered for the shutdown mode */
+        pNextClient = pClient;
       }
-    break;
-
-    /* For "fast shutdown" search backward in the list, until there is a client that has not been shut down */
-    case NsmNodeState_FastShutdown:
-      u32ShutdownType = NSM_SHUTDOWNTYPE_FAST;
-      for( pListEntry = g_list_last(NSM__pLifecycleClients);
-          (pListEntry != NULL) && (NSM__pCurrentLifecycleClient == NULL);
-          pListEntry = g_list_previous(pListEntry))
-      {
-        /* Check if client has not been shut down and is registered for "fast shutdown" */
-        pClient = (NSM__tstLifecycleClient*) pListEntry->data;
-        if(   (  pClient->boShutdown                           == FALSE)
-           && ( (pClient->u32RegisteredMode & u32ShutdownType) != 0    ))
-        {
-          /* Found a "running" previous client, registered for the shutdown mode */
-          NSM__pCurrentLifecycleClient = (NSM__tstLifecycleClient*) pListEntry->data;
-        }
+    }
+  }
+  else
+  {
+    /* For a "run up" search forward in the list (get next), until there is a client that is shut down */
+    for(pListEntry = g_list_first(NSM__pLifecycleClients);
+        (pListEntry != NULL) && (pNextClient == NULL);
+        pListEntry = g_list_next(pListEntry))
+    {
+      /* Check if client is shut down. Clients of a shut down seat only run up with their seat. */
+      pClient = (NSM__tstLifecycleClient*) pListEntry->data;
+      if(   (pClient->boShutdown == TRUE)
+         && (   ((enSeat == NsmSeat_NotSet) && (NSM__aboSeatShutdown[pClient->enSeat] == FALSE))
+             || ((enSeat != NsmSeat_NotSet) && (pClient->enSeat                       == enSeat))))
+      {
+        /* The client was shutdown. It should run up, because we are in a running mode */
+        pNextClient = pClient;
       }
-    break;
+    }
+  }
 
-    /* For a "running" mode search forward in the list (get next), until there is a client that is shut down */
-    default:
-      u32ShutdownType = NSM_SHUTDOWNTYPE_RUNUP;
-      for(pListEntry = g_list_first(NSM__pLifecycleClients);
-          (pListEntry != NULL) && (NSM__pCurrentLifecycleClient == NULL);
-          pListEntry = g_list_next(pListEntry))
+  return pNextClient;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function determines the next group of load shedding clients that needs to be informed about the passed
+* shutdown type. All clients of the group are on the same shed level and will be called in parallel.
+* When the node enters "DegradedPower", running clients are shed starting with the lowest level. When the node
+* returns to a running state, the shed clients run up again starting with the highest level.
+*
+* @param u32ShutdownType: NSM_SHUTDOWNTYPE_DEGRADE or NSM_SHUTDOWNTYPE_RUNUP
+*
+* @return List of clients to inform. NULL if there is no client left. The list has to be freed by the caller.
+*
+**********************************************************************************************************************/
+static GList* NSM__pFindNextShedLevelClients(const guint32 u32ShutdownType)
+{
+  /* Function local variables                                                                     */
+  GList                   *pListEntry   = NULL;  /* Iterate through list entries                  */
+  NSM__tstLifecycleClient *pClient      = NULL;  /* Client object from list                       */
+  GList                   *pLevelList   = NULL;  /* Return value. Clients of the next shed level  */
+  guint32                  u32ShedLevel = 0;     /* Shed level of the next clients                */
+  gboolean                 boLevelFound = FALSE; /* At least one client needs to be informed      */
+
+  /* Find the level that needs to be informed next */
+  for(pListEntry = g_list_first(NSM__pLifecycleClients); pListEntry != NULL; pListEntry = g_list_next(pListEntry))
+  {
+    pClient = (NSM__tstLifecycleClient*) pListEntry->data;
+
+    if(u32ShutdownType == NSM_SHUTDOWNTYPE_DEGRADE)
+    {
+      /* Shed running clients, which are registered for load shedding. Start with the lowest level */
+      if(   ((pClient->u32RegisteredMode & NSM_SHUTDOWNTYPE_DEGRADE) != 0    )
+         && ( pClient->boShed                                         == FALSE)
+         && ( pClient->boShutdown                                     == FALSE)
+         && ( pClient->boSuspended                                    == FALSE)
+         && ((boLevelFound == FALSE) || (pClient->u32ShedLevel < u32ShedLevel)))
       {
-        /* Check if client is shut down */
-        pClient = (NSM__tstLifecycleClient*) pListEntry->data;
-        if(pClient->boShutdown == TRUE)
-        {
-          /* The client was shutdown. It should run up, because we are in a running mode */
-          NSM__pCurrentLifecycleClient = (NSM__tstLifecycleClient*) pListEntry->data;
-        }
+        u32ShedLevel = pClient->u32ShedLevel;
+        boLevelFound = TRUE;
       }
-    break;
+    }
+    else
+    {
+      /* Run up the shed clients. Start with the highest level */
+      if(   (pClient->boShed == TRUE)
+         && ((boLevelFound == FALSE) || (pClient->u32ShedLevel > u32ShedLevel)))
+      {
+        u32ShedLevel = pClient->u32ShedLevel;
+        boLevelFound = TRUE;
+      }
+    }
   }
 
-  /* Check if a client could be found that needs to be informed */
-  if(NSM__pCurrentLifecycleClient != NULL)
+  /* Collect the clients of the level */
+  for(pListEntry = g_list_first(NSM__pLifecycleClients);
+      (pListEntry != NULL) && (boLevelFound == TRUE);
+      pListEntry = g_list_next(pListEntry))
   {
-    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Call lifecycle client."                                                  ),
-                                      DLT_STRING(" Bus name: "),         DLT_STRING(NSM__pCurrentLifecycleClient->sBusName      ),
-                                      DLT_STRING(" Obj name: "),         DLT_STRING(NSM__pCurrentLifecycleClient->sObjName      ),
-                                      DLT_STRING(" Registered types: "), DLT_INT(NSM__pCurrentLifecycleClient->u32RegisteredMode),
-                                      DLT_STRING(" Client: "),           DLT_INT( (guint) NSM__pCurrentLifecycleClient->hClient ),
-                                      DLT_STRING(" ShutdownType: "),     DLT_UINT(u32ShutdownType                               ));
+    pClient = (NSM__tstLifecycleClient*) pListEntry->data;
+
+    if(   (pClient->u32ShedLevel == u32ShedLevel)
+       && (   (   (u32ShutdownType                                   == NSM_SHUTDOWNTYPE_DEGRADE)
+               && ((pClient->u32RegisteredMode & NSM_SHUTDOWNTYPE_DEGRADE) != 0                 )
+               && (pClient->boShed                                   == FALSE                   )
+               && (pClient->boShutdown                               == FALSE                   )
+               && (pClient->boSuspended                              == FALSE                   ))
+           || (   (u32ShutdownType                                   == NSM_SHUTDOWNTYPE_RUNUP  )
+               && (pClient->boShed                                   == TRUE                    ))))
+    {
+      pLevelList = g_list_append(pLevelList, pClient);
+    }
+  }
 
-    /* Remember that client received a run-up or shutdown call */
-    pClient->boShutdown = (u32ShutdownType != NSM_SHUTDOWNTYPE_RUNUP);
+  return pLevelList;
+}
 
-    NSM__vLtProf(NSM__pCurrentLifecycleClient->sBusName, NSM__pCurrentLifecycleClient->sObjName, u32ShutdownType, "enter: ", 0);
 
-    NSMA_boCallLcClientRequest(NSM__pCurrentLifecycleClient->hClient, u32ShutdownType);
-    boShutdown = FALSE;
-  }
-  else
+/**********************************************************************************************************************
+*
+* The function determines the next group of suspended clients that needs to be resumed. The list is searched
+* forward and at most NSM_RESUME_GROUP_SIZE clients are returned, which will be called in parallel.
+* Clients of a seat that is shut down are only resumed with their seat.
+*
+* @return List of clients to resume. NULL if there is no client left. The list has to be freed by the caller.
+*
+**********************************************************************************************************************/
+static GList* NSM__pFindNextResumeClients(void)
+{
+  /* Function local variables                                                              */
+  GList                   *pListEntry  = NULL; /* Iterate through list entries             */
+  NSM__tstLifecycleClient *pClient     = NULL; /* Client object from list                  */
+  GList                   *pGroupList  = NULL; /* Return value. Clients of the next group  */
+  guint32                  u32GroupLen = 0;    /* Number of clients in the group           */
+
+  for(pListEntry = g_list_first(NSM__pLifecycleClients);
+      (pListEntry != NULL) && (u32GroupLen < NSM_RESUME_GROUP_SIZE);
+      pListEntry = g_list_next(pListEntry))
   {
-    /* The last client was called. Depending on the NodeState check if we can end. */
-    switch(NSM__enNodeState)
+    pClient = (NSM__tstLifecycleClient*) pListEntry->data;
+
+    if(   (pClient->boSuspended                  == TRUE )
+       && (NSM__aboSeatShutdown[pClient->enSeat] == FALSE))
     {
-      /* All registered clients have been 'fast shutdown'. Set NodeState to "shutdown" */
-      case NsmNodeState_FastShutdown:
-        DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Informed all registered clients about 'fast shutdown'. Set NodeState to 'shutdown'"));
+      pGroupList = g_list_append(pGroupList, pClient);
+      u32GroupLen++;
+    }
+  }
 
-        NSM__enNodeState = NsmNodeState_Shutdown;
-        NsmcSetData(NsmDataType_NodeState, (unsigned char*) &NSM__enNodeState, sizeof(NsmNodeState_e));
-        NSMA_boSendNodeStateSignal(NSM__enNodeState);
-        boShutdown = TRUE;
-      break;
+  return pGroupList;
+}
 
-      /* All registered clients have been 'shutdown'. Set NodeState to "shutdown" */
-      case NsmNodeState_ShuttingDown:
-        DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Informed all registered clients about 'shutdown'. Set NodeState to 'shutdown'."));
 
-        NSM__enNodeState = NsmNodeState_Shutdown;
-        NsmcSetData(NsmDataType_NodeState, (unsigned char*) &NSM__enNodeState, sizeof(NsmNodeState_e));
-        NSMA_boSendNodeStateSignal(NSM__enNodeState);
-        boShutdown = TRUE;
-      break;
+/**********************************************************************************************************************
+*
+* The function determines the clients of the 'Last user context' (registered with NSM_SHUTDOWNTYPE_LUC), which have
+* been shut down or suspended and need to run up or resume. The clients are called in parallel, before other clients.
+* Clients of a seat that is shut down are only run up with their seat.
+*
+* @return List of LUC clients to run up. NULL if there is no client left. The list has to be freed by the caller.
+*
+**********************************************************************************************************************/
+static GList* NSM__pFindLucRunupClients(void)
+{
+  /* Function local variables                                                              */
+  GList                   *pListEntry  = NULL; /* Iterate through list entries             */
+  NSM__tstLifecycleClient *pClient     = NULL; /* Client object from list                  */
+  GList                   *pLucList    = NULL; /* Return value. LUC clients to run up      */
 
-      /* We are in a running state. Nothing to do */
-      default:
-        boShutdown = FALSE;
-      break;
+  for(pListEntry = g_list_first(NSM__pLifecycleClients); pListEntry != NULL; pListEntry = g_list_next(pListEntry))
+  {
+    pClient = (NSM__tstLifecycleClient*) pListEntry->data;
+
+    if(   ((pClient->u32RegisteredMode & NSM_SHUTDOWNTYPE_LUC) != 0    )
+       && ((pClient->boShutdown == TRUE) || (pClient->boSuspended == TRUE))
+       && ( NSM__aboSeatShutdown[pClient->enSeat]               == FALSE))
+    {
+      pLucList = g_list_append(pLucList, pClient);
     }
   }
 
-  g_mutex_unlock(NSM__pNodeStateMutex);
+  return pLucList;
+}
 
-  if(boShutdown == TRUE)
+
+/**********************************************************************************************************************
+*
+* The function stores the NodeState, the seat sequence and the progress of the registered lifecycle clients in the
+* current lifecycle sequence to the snapshot. The clients keep their slots, only the changed values are written.
+*
+* PLEASE NOTE: The function has to be called with a locked NSM__pNodeStateMutex.
+*
+* @return void
+*
+**********************************************************************************************************************/
+static void NSM__vStoreLifecycleState(void)
+{
+  /* Function local variables                                          */
+  GList     *pListEntry = NULL;           /* Iterate through list entries */
+  NsmSeat_e  enSeatIdx  = NsmSeat_NotSet;
+
+  if(NSM__pstSnapshot != NULL)
   {
-    NSMA_boQuitEventLoop();
+    NSM__pstSnapshot->i32NodeState       = (gint32) NSM__enNodeState;
+    NSM__pstSnapshot->i32Seat            = (gint32) NSM__enLifecycleSeat;
+    NSM__pstSnapshot->u32SeatRequestType = NSM__u32SeatRequestType;
+
+    for(enSeatIdx = NsmSeat_NotSet; enSeatIdx < NsmSeat_Last; enSeatIdx++)
+    {
+      NSM__pstSnapshot->au8SeatShutdown[enSeatIdx] = (guint8) NSM__aboSeatShutdown[enSeatIdx];
+    }
+
+    for(pListEntry = g_list_first(NSM__pLifecycleClients); pListEntry != NULL; pListEntry = g_list_next(pListEntry))
+    {
+      NSM__vSnapshotClient((NSM__tstLifecycleClient*) pListEntry->data);
+    }
   }
 }
 
 
 /**********************************************************************************************************************
 *
-* The callback is called when a check for LUC is required.
-* It uses the NodeStateMachine to determine whether LUC is required.
+* The function restores the lifecycle clients and the progress of a lifecycle sequence from the snapshot of the
+* previous NSM instance. Clients keep their registration, their order and the information if they have been shut
+* down, shed or suspended. The proxies are created without asking the clients. Afterwards, the bus daemon is asked
+* asynchronously, if the bus names of the clients still have an owner. Clients whose bus name vanished are removed.
+* When all bus names have been checked, a shutdown or suspend sequence goes on with the next client, which has not
+* been informed yet (see NSM__vFinishRestore). A client, which was called when the NSM stopped, is not called again.
+* The values are read from a file. Values out of their range are not restored and client slots with an invalid seat
+* are released.
 *
-* @param pboRetVal: Pointer, where to store the StateMAchine's return value
+* @return void
 *
 **********************************************************************************************************************/
-static gboolean NSM__boOnHandleCheckLucRequired(void)
+static void NSM__vRestoreLifecycleState(void)
 {
-  /* Determine if LUC is required by asking the NodeStateMachine */
-  return (NsmcLucRequired() == 0x01) ? TRUE : FALSE;
+  /* Function local variables                                                                           */
+  NSM__tstSnapshotClient  *pstSlot          = NULL;   /* Slot of a client in the restored snapshot      */
+  NSM__tstLifecycleClient  stSearchClient   = {0};    /* Client to search existing clients              */
+  NSM__tstLifecycleClient *pClient          = NULL;   /* Restored client object                         */
+  NSMA_tLcConsumerHandle   hConsumer        = NULL;   /* Proxy of the restored client                   */
+  GHashTable              *pBusNames        = NULL;   /* Bus names, which are already checked           */
+  GList                   *pListEntry       = NULL;   /* Iterate through list entries                   */
+  guint32                  au32Slots[NSM_SNAPSHOT_MAX_CLIENTS]; /* Used slots in the order of the clients */
+  guint32                  u32SlotCnt       = 0;      /* Number of used slots                           */
+  guint32                  u32SlotIdx       = 0;
+  guint32                  u32SortIdx       = 0;
+  guint32                  u32Dropped       = 0;      /* Slots with invalid values                      */
+  NsmSeat_e                enSeatIdx        = NsmSeat_NotSet;
+  gint32                   i32NodeState     = 0;      /* Values of the snapshot, checked before use     */
+  gint32                   i32Seat          = 0;
+  guint32                  u32RequestType   = 0;
+
+  if(NSM__pstRestoreSnapshot != NULL)
+  {
+    g_mutex_lock(NSM__pNodeStateMutex);
+
+    i32NodeState   = NSM__pstRestoreSnapshot->i32NodeState;
+    i32Seat        = NSM__pstRestoreSnapshot->i32Seat;
+    u32RequestType = NSM__pstRestoreSnapshot->u32SeatRequestType;
+
+    if((i32NodeState > (gint32) NsmNodeState_NotSet) && (i32NodeState < (gint32) NsmNodeState_Last))
+    {
+      NSM__enRestoreNodeState = (NsmNodeState_e) i32NodeState;
+    }
+
+    /* A seat sequence is only continued for a valid seat and request */
+    if(   (i32Seat > (gint32) NsmSeat_NotSet)
+       && (i32Seat < (gint32) NsmSeat_Last  )
+       && (   (u32RequestType == NSM_SHUTDOWNTYPE_NORMAL)
+           || (u32RequestType == NSM_SHUTDOWNTYPE_FAST  )
+           || (u32RequestType == NSM_SHUTDOWNTYPE_RUNUP )))
+    {
+      NSM__enLifecycleSeat    = (NsmSeat_e) i32Seat;
+      NSM__u32SeatRequestType = u32RequestType;
+    }
+
+    for(enSeatIdx = NsmSeat_NotSet; enSeatIdx < NsmSeat_Last; enSeatIdx++)
+    {
+      NSM__aboSeatShutdown[enSeatIdx] = (NSM__pstRestoreSnapshot->au8SeatShutdown[enSeatIdx] != 0);
+    }
+
+    /* Sort the used slots by the registration order (insertion sort), because the order defines the sequence */
+    for(u32SlotIdx = 0; u32SlotIdx < NSM_SNAPSHOT_MAX_CLIENTS; u32SlotIdx++)
+    {
+      pstSlot = &NSM__pstRestoreSnapshot->astClients[u32SlotIdx];
+
+      /* The seat of the client is used as index. Release slots with an invalid seat */
+      if(   (pstSlot->u32Used != 0)
+         && (   (pstSlot->i32Seat <  (gint32) NsmSeat_NotSet)
+             || (pstSlot->i32Seat >= (gint32) NsmSeat_Last  )))
+      {
+        if(NSM__pstSnapshot != NULL)
+        {
+          g_atomic_int_set((gint*) &NSM__pstSnapshot->astClients[u32SlotIdx].u32Used, 0);
+        }
+
+        u32Dropped++;
+      }
+      else if(pstSlot->u32Used != 0)
+      {
+        for(u32SortIdx = u32SlotCnt;
+               (u32SortIdx > 0)
+            && (NSM__pstRestoreSnapshot->astClients[au32Slots[u32SortIdx - 1]].u32Order > pstSlot->u32Order);
+            u32SortIdx--)
+        {
+          au32Slots[u32SortIdx] = au32Slots[u32SortIdx - 1];
+        }
+
+        au32Slots[u32SortIdx] = u32SlotIdx;
+        u32SlotCnt++;
+      }
+    }
+
+    /* Restore the clients, which did not register again, in their original order */
+    for(u32SortIdx = 0; u32SortIdx < u32SlotCnt; u32SortIdx++)
+    {
+      pstSlot   = &NSM__pstRestoreSnapshot->astClients[au32Slots[u32SortIdx]];
+      hConsumer = NULL;
+
+      pstSlot->sBusName[NSM_SNAPSHOT_NAME_LENGTH - 1] = '\0';
+      pstSlot->sObjName[NSM_SNAPSHOT_NAME_LENGTH - 1] = '\0';
+      stSearchClient.sBusName = pstSlot->sBusName;
+      stSearchClient.sObjName = pstSlot->sObjName;
+
+      if(g_list_find_custom(NSM__pLifecycleClients, &stSearchClient, &NSM__i32LifecycleClientCompare) == NULL)
+      {
+        hConsumer = NSMA_hCreateLcConsumer(pstSlot->sBusName, pstSlot->sObjName, pstSlot->u32TimeoutMs);
+      }
+
+      if(hConsumer != NULL)
+      {
+        /* The client keeps its slot in the snapshot */
+        pClient                    = g_new0(NSM__tstLifecycleClient, 1);
+        pClient->sBusName          = g_strdup(pstSlot->sBusName);
+        pClient->sObjName          = g_strdup(pstSlot->sObjName);
+        pClient->hClient           = hConsumer;
+        pClient->u32RegisteredMode = pstSlot->u32RegisteredMode;
+        pClient->enSeat            = (NsmSeat_e) pstSlot->i32Seat;
+        pClient->u32ShedLevel      = pstSlot->u32ShedLevel;
+        pClient->boShutdown        = ((pstSlot->u32Flags & NSM_SNAPSHOT_CLIENT_SHUTDOWN ) != 0);
+        pClient->boShed            = ((pstSlot->u32Flags & NSM_SNAPSHOT_CLIENT_SHED     ) != 0);
+        pClient->boSuspended       = ((pstSlot->u32Flags & NSM_SNAPSHOT_CLIENT_SUSPENDED) != 0);
+        pClient->u32SnapshotSlot   = au32Slots[u32SortIdx] + 1;
+
+        NSM__pLifecycleClients = g_list_append(NSM__pLifecycleClients, pClient);
+        NSM__u32RestoreClients++;
+      }
+      else if(NSM__pstSnapshot != NULL)
+      {
+        /* The client registered again (with an own slot) or could not be restored. Release its old slot */
+        g_atomic_int_set((gint*) &NSM__pstSnapshot->astClients[au32Slots[u32SortIdx]].u32Used, 0);
+      }
+    }
+
+    g_mutex_unlock(NSM__pNodeStateMutex);
+
+    if(u32Dropped != 0)
+    {
+      DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Dropped invalid lifecycle clients of snapshot."),
+                                        DLT_STRING(" Clients: "), DLT_UINT(u32Dropped                  ));
+    }
+
+    /* Check every bus name of the restored clients once. The answers arrive in this (the core) context */
+    pBusNames = g_hash_table_new(&g_str_hash, &g_str_equal);
+
+    for(pListEntry = g_list_first(NSM__pLifecycleClients); pListEntry != NULL; pListEntry = g_list_next(pListEntry))
+    {
+      pClient = (NSM__tstLifecycleClient*) pListEntry->data;
+
+      if(   (g_hash_table_lookup(pBusNames, pClient->sBusName) == NULL)
+         && (NSMA_boCheckBusName(pClient->sBusName, &NSM__vOnRestoredBusNameChecked, NULL) == TRUE))
+      {
+        g_hash_table_insert(pBusNames, pClient->sBusName, pClient->sBusName);
+        NSM__u32RestoreChecksPending++;
+      }
+    }
+
+    g_hash_table_destroy(pBusNames);
+
+    g_free(NSM__pstRestoreSnapshot);
+    NSM__pstRestoreSnapshot = NULL;
+
+    /* Without clients to check, the restore is finished at once */
+    if(NSM__u32RestoreChecksPending == 0)
+    {
+      NSM__vFinishRestore();
+    }
+  }
 }
 
 
 /**********************************************************************************************************************
 *
-* The callback is called when the "boot mode" should be set.
-* It sets the BootMode using an internal function.
+* The function is called, when the bus daemon answered, whether the bus name of restored lifecycle clients still has
+* an owner. If the name vanished while the NSM was down, the clients of the bus name are unregistered. When the last
+* bus name has been checked, the restore is finished.
 *
-* @param i32BootMode: New boot mode
-* @param penRetVal:   Pointer, where to store the return value
+* @param sBusName:   Checked bus name
+* @param boHasOwner: TRUE, if the bus name has an owner (or the bus daemon could not be asked)
+* @param pUserData:  Not used
+*
+* @return void
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enOnHandleSetBootMode(const gint i32BootMode)
+static void NSM__vOnRestoredBusNameChecked(const gchar *sBusName, gboolean boHasOwner, gpointer pUserData)
 {
-  /* Use internal setter to set the BootMode and inform the StateMachine */
-  return NSM__enSetBootMode(i32BootMode, TRUE);
+  /* Function local variables                                                          */
+  GList                   *pListEntry   = NULL;  /* Iterate through list entries        */
+  NSM__tstLifecycleClient *pClient      = NULL;  /* Client of the vanished bus name     */
+  gchar                   *sObjName     = NULL;  /* Copy, the client is freed on removal */
+  guint32                  u32Mode      = NSM_SHUTDOWNTYPE_NOT;
+
+  if(boHasOwner == FALSE)
+  {
+    /* Unregistering removes the client from the list. Therefore, search from the start after every removal */
+    do
+    {
+      pClient = NULL;
+
+      for(pListEntry = g_list_first(NSM__pLifecycleClients);
+          (pListEntry != NULL) && (pClient == NULL);
+          pListEntry = g_list_next(pListEntry))
+      {
+        if(g_strcmp0(((NSM__tstLifecycleClient*) pListEntry->data)->sBusName, sBusName) == 0)
+        {
+          pClient = (NSM__tstLifecycleClient*) pListEntry->data;
+        }
+      }
+
+      if(pClient != NULL)
+      {
+        DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Removed restored lifecycle consumer. Bus name vanished."),
+                                          DLT_STRING(" Bus name: "), DLT_STRING(pClient->sBusName                 ),
+                                          DLT_STRING(" Obj name: "), DLT_STRING(pClient->sObjName                 ));
+
+        sObjName = g_strdup(pClient->sObjName);
+        u32Mode  = pClient->u32RegisteredMode;
+        (void) NSM__enOnHandleUnRegisterLifecycleClient(sBusName, sObjName, u32Mode);
+        g_free(sObjName);
+
+        NSM__u32RestoreClientsGone++;
+      }
+    } while(pClient != NULL);
+  }
+
+  NSM__u32RestoreChecksPending--;
+
+  if(NSM__u32RestoreChecksPending == 0)
+  {
+    NSM__vFinishRestore();
+  }
 }
 
 
 /**********************************************************************************************************************
 *
-* The callback is called when the "node state" should be set.
-* It sets the NodeState using an internal function.
+* The function is called, when all restored lifecycle clients have been revalidated. It logs the time from the start
+* of the NSM until it was fully restored and goes on with an interrupted shutdown or suspend sequence.
+* Otherwise the NSMC decides about the NodeState.
 *
-* @param enNodeStateId: New node state
-* @param penRetVal:     Pointer, where to store the return value
+* @return void
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enOnHandleSetNodeState(const NsmNodeState_e  enNodeState)
+static void NSM__vFinishRestore(void)
 {
-  return NSM__enSetNodeState(enNodeState, TRUE, TRUE);
+  gboolean boSequence = FALSE; /* NSM was restarted during a sequence */
+
+  boSequence =    (NSM__enRestoreNodeState == NsmNodeState_ShuttingDown)
+               || (NSM__enRestoreNodeState == NsmNodeState_FastShutdown)
+               || (NSM__enRestoreNodeState == NsmNodeState_Suspending  );
+
+  NSM__vLogStartupPhase("Snapshot restored");
+
+  DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Restored lifecycle state."                           ),
+                                    DLT_STRING(" Clients: "),         DLT_UINT(NSM__u32RestoreClients     ),
+                                    DLT_STRING(" Removed clients: "), DLT_UINT(NSM__u32RestoreClientsGone ),
+                                    DLT_STRING(" NodeState: "),       DLT_INT((gint) NSM__enRestoreNodeState),
+                                    DLT_STRING(" Seat: "),            DLT_INT((gint) NSM__enLifecycleSeat ));
+
+  /* Go on with the sequence, where it stopped. A handover already set the NodeState and may contain a seat sequence */
+  if(   (boSequence == TRUE)
+     && ((NsmNodeState_e) g_atomic_int_get((gint*) &NSM__enNodeState) != NSM__enRestoreNodeState))
+  {
+    (void) NSM__enSetNodeState(NSM__enRestoreNodeState, TRUE, TRUE);
+  }
+  else if((boSequence == TRUE) || ((NSM__pstHandover != NULL) && (NSM__enLifecycleSeat != NsmSeat_NotSet)))
+  {
+    NSM__vCallNextLifecycleClient();
+  }
+  else
+  {
+    /* No sequence to go on with */
+  }
 }
 
 
-/**********************************************************************************************************************
-*
-* The callback is called when the "application mode" should be set.
-* It sets the ApplicationMode using an internal function.
-*
-* @param enApplicationModeId: New application mode
-* @param penRetVal:           Pointer, where to store the return value
-*
-**********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enOnHandleSetApplicationMode(const NsmApplicationMode_e enApplMode)
-{
-  return NSM__enSetApplicationMode(enApplMode, TRUE, TRUE);
+/**********************************************************************************************************************
+*
+* The function maps the snapshot file (NSM_SNAPSHOT_FILE). If it contains a valid snapshot of a previous instance,
+* a copy is kept for the restore and the mapped slots are taken over by the restored objects. Otherwise, the
+* snapshot is initialized empty. The snapshot of a handover replaces the file content.
+*
+**********************************************************************************************************************/
+static void NSM__vOpenSnapshot(void)
+{
+  gint        i32Fd     = -1;
+  gpointer    pMap      = MAP_FAILED;
+  gboolean    boValid   = FALSE;
+  struct stat stStat;
+
+  i32Fd = open(NSM_SNAPSHOT_FILE, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+
+  if(i32Fd >= 0)
+  {
+    /* Only a file of the expected size can contain a snapshot of this layout */
+    boValid = (fstat(i32Fd, &stStat) == 0) && (stStat.st_size == (off_t) sizeof(NSM__tstSnapshot));
+
+    if(ftruncate(i32Fd, sizeof(NSM__tstSnapshot)) == 0)
+    {
+      pMap = mmap(NULL, sizeof(NSM__tstSnapshot), PROT_READ | PROT_WRITE, MAP_SHARED, i32Fd, 0);
+    }
+
+    (void) close(i32Fd);
+  }
+
+  if((pMap != MAP_FAILED) && (NSM__pstHandover != NULL))
+  {
+    NSM__pstSnapshot = (NSM__tstSnapshot*) pMap;
+    memcpy(NSM__pstSnapshot, &NSM__pstHandover->stSnapshot, sizeof(NSM__tstSnapshot));
+
+    NSM__pstRestoreSnapshot = (NSM__tstSnapshot*) g_memdup(NSM__pstSnapshot, sizeof(NSM__tstSnapshot));
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Mapped snapshot of handover."),
+                                      DLT_STRING(" File: "), DLT_STRING(NSM_SNAPSHOT_FILE));
+  }
+  else if(pMap != MAP_FAILED)
+  {
+    NSM__pstSnapshot = (NSM__tstSnapshot*) pMap;
+
+    boValid =    (boValid                      == TRUE                    )
+              && (NSM__pstSnapshot->u32Magic   == NSM_SNAPSHOT_MAGIC      )
+              && (NSM__pstSnapshot->u32Version == NSM_SNAPSHOT_VERSION    )
+              && (NSM__pstSnapshot->u32Size    == sizeof(NSM__tstSnapshot));
+
+    if(boValid == TRUE)
+    {
+      NSM__pstRestoreSnapshot = (NSM__tstSnapshot*) g_memdup(NSM__pstSnapshot, sizeof(NSM__tstSnapshot));
+    }
+    else
+    {
+      memset(NSM__pstSnapshot, 0, sizeof(NSM__tstSnapshot));
+      NSM__pstSnapshot->u32Version   = NSM_SNAPSHOT_VERSION;
+      NSM__pstSnapshot->u32Size      = sizeof(NSM__tstSnapshot);
+      NSM__pstSnapshot->i32NodeState = (gint32) NsmNodeState_NotSet;
+      g_atomic_int_set((gint*) &NSM__pstSnapshot->u32Magic, NSM_SNAPSHOT_MAGIC);
+    }
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Mapped snapshot."),
+                                      DLT_STRING(" File: "),    DLT_STRING(NSM_SNAPSHOT_FILE),
+                                      DLT_STRING(" Restore: "), DLT_BOOL(boValid            ));
+  }
+  else
+  {
+    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to map snapshot."),
+                                      DLT_STRING(" File: "),  DLT_STRING(NSM_SNAPSHOT_FILE),
+                                      DLT_STRING(" Error: "), DLT_STRING(g_strerror(errno)));
+
+    /* The handed over state is restored nevertheless. Changes can not be stored anymore */
+    if(NSM__pstHandover != NULL)
+    {
+      NSM__pstRestoreSnapshot = (NSM__tstSnapshot*) g_memdup(&NSM__pstHandover->stSnapshot, sizeof(NSM__tstSnapshot));
+    }
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function restores the product sessions and the failed applications from the snapshot of the previous instance.
+* It is called at start up, before the sessions are published. Therefore, D-Bus and NSMC are not informed about
+* single sessions. The lifecycle clients are restored, when the bus name has been acquired.
+* Only sessions, which could be registered via D-Bus, are restored. The slots of other sessions are released.
+*
+**********************************************************************************************************************/
+static void NSM__vRestoreSnapshot(void)
+{
+  /* Function local variables                                                          */
+  NSM__tstSnapshotSession   *pstSessionSlot = NULL; /* Slot of a session in the snapshot */
+  NSM__tstSnapshotFailedApp *pstAppSlot     = NULL; /* Slot of an app in the snapshot    */
+  guint32                    u32SlotIdx     = 0;
+  guint                      u32Sessions    = 0;    /* Number of restored sessions       */
+  guint                      u32Apps        = 0;    /* Number of restored failed apps    */
+  guint                      u32Dropped     = 0;    /* Sessions with invalid values      */
+  NsmSession_s              *pstSession     = NULL; /* Session of a slot                 */
+
+  if(NSM__pstRestoreSnapshot != NULL)
+  {
+    g_mutex_lock(NSM__pSessionMutex);
+
+    for(u32SlotIdx = 0; u32SlotIdx < NSM_SNAPSHOT_MAX_SESSIONS; u32SlotIdx++)
+    {
+      pstSessionSlot = &NSM__pstRestoreSnapshot->astSessions[u32SlotIdx];
+      pstSession     = &pstSessionSlot->stSession;
+      pstSession->sName [NSM_MAX_SESSION_NAME_LENGTH  - 1] = '\0';
+      pstSession->sOwner[NSM_MAX_SESSION_OWNER_LENGTH - 1] = '\0';
+
+      if(   (pstSessionSlot->u32Used != 0)
+         && (   ((gint) pstSession->enSeat  <= (gint) NsmSeat_NotSet              )
+             || ((gint) pstSession->enSeat  >= (gint) NsmSeat_Last                )
+             || ((gint) pstSession->enState <= (gint) NsmSessionState_Unregistered)
+             || (g_strcmp0(pstSession->sOwner, NSM_DEFAULT_SESSION_OWNER) == 0    )
+             || (NSM__boIsPlatformSession(pstSession)                     == TRUE )))
+      {
+        if(NSM__pstSnapshot != NULL)
+        {
+          g_atomic_int_set((gint*) &NSM__pstSnapshot->astSessions[u32SlotIdx].u32Used, 0);
+        }
+
+        u32Dropped++;
+      }
+      else if(   (pstSessionSlot->u32Used != 0)
+              && (g_slist_find_custom(NSM__pSessions, pstSession, &NSM__i32SessionNameSeatCompare) == NULL))
+      {
+        NSM__pSessions = g_slist_append(NSM__pSessions, g_memdup(pstSession, sizeof(NsmSession_s)));
+        u32Sessions++;
+      }
+    }
+
+    g_mutex_unlock(NSM__pSessionMutex);
+
+    g_mutex_lock(NSM__pFailedApplicationsMutex);
+
+    for(u32SlotIdx = 0; u32SlotIdx < NSM_SNAPSHOT_MAX_APPS; u32SlotIdx++)
+    {
+      pstAppSlot = &NSM__pstRestoreSnapshot->astFailedApps[u32SlotIdx];
+      pstAppSlot->stApplication.sName[NSM_MAX_SESSION_OWNER_LENGTH - 1] = '\0';
+
+      if(   (pstAppSlot->u32Used != 0)
+         && (g_slist_find_custom(NSM__pFailedApplications, &pstAppSlot->stApplication, &NSM__i32ApplicationCompare) == NULL))
+      {
+        NSM__pFailedApplications = g_slist_append(NSM__pFailedApplications,
+                                                  g_memdup(&pstAppSlot->stApplication, sizeof(NSM__tstFailedApplication)));
+        u32Apps++;
+      }
+    }
+
+    g_mutex_unlock(NSM__pFailedApplicationsMutex);
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Restored sessions and failed applications."),
+                                      DLT_STRING(" Sessions: "),            DLT_UINT(u32Sessions  ),
+                                      DLT_STRING(" Invalid sessions: "),    DLT_UINT(u32Dropped   ),
+                                      DLT_STRING(" Failed applications: "), DLT_UINT(u32Apps      ));
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function writes a lifecycle client to its slot in the snapshot. A new client gets a free slot and the next
+* registration order. The slot is invalid while it is written, so that a restarted NSM never sees half a client.
+*
+* PLEASE NOTE: The function has to be called with a locked NSM__pNodeStateMutex.
+*
+* @param pClient: Lifecycle client, which has been registered or changed
+*
+**********************************************************************************************************************/
+static void NSM__vSnapshotClient(NSM__tstLifecycleClient *pClient)
+{
+  /* Function local variables                                               */
+  NSM__tstSnapshotClient *pstSlot      = NULL; /* Slot of the client         */
+  guint32                 u32SlotIdx   = 0;
+  guint                   u32TimeoutMs = 0;    /* Timeout of the client       */
+
+  if(   (NSM__pstSnapshot          != NULL                    )
+     && (strlen(pClient->sBusName) <  NSM_SNAPSHOT_NAME_LENGTH)
+     && (strlen(pClient->sObjName) <  NSM_SNAPSHOT_NAME_LENGTH))
+  {
+    for(u32SlotIdx = 0; (u32SlotIdx < NSM_SNAPSHOT_MAX_CLIENTS) && (pClient->u32SnapshotSlot == 0); u32SlotIdx++)
+    {
+      if(NSM__pstSnapshot->astClients[u32SlotIdx].u32Used == 0)
+      {
+        pClient->u32SnapshotSlot = u32SlotIdx + 1;
+        NSM__pstSnapshot->astClients[u32SlotIdx].u32Order = NSM__pstSnapshot->u32NextOrder++;
+      }
+    }
+
+    if(pClient->u32SnapshotSlot != 0)
+    {
+      pstSlot = &NSM__pstSnapshot->astClients[pClient->u32SnapshotSlot - 1];
+      (void) NSMA_boGetLcClientTimeout(pClient->hClient, &u32TimeoutMs);
+
+      g_atomic_int_set((gint*) &pstSlot->u32Used, 0);
+
+      g_strlcpy(pstSlot->sBusName, pClient->sBusName, sizeof(pstSlot->sBusName));
+      g_strlcpy(pstSlot->sObjName, pClient->sObjName, sizeof(pstSlot->sObjName));
+      pstSlot->u32RegisteredMode = pClient->u32RegisteredMode;
+      pstSlot->u32TimeoutMs      = u32TimeoutMs;
+      pstSlot->i32Seat           = (gint32) pClient->enSeat;
+      pstSlot->u32ShedLevel      = pClient->u32ShedLevel;
+      pstSlot->u32Flags          =   ((pClient->boShutdown  == TRUE) ? NSM_SNAPSHOT_CLIENT_SHUTDOWN  : 0)
+                                   | ((pClient->boShed      == TRUE) ? NSM_SNAPSHOT_CLIENT_SHED      : 0)
+                                   | ((pClient->boSuspended == TRUE) ? NSM_SNAPSHOT_CLIENT_SUSPENDED : 0);
+
+      g_atomic_int_set((gint*) &pstSlot->u32Used, 1);
+    }
+    else
+    {
+      DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to store lifecycle consumer in snapshot. No free slot."),
+                                        DLT_STRING(" Bus name: "), DLT_STRING(pClient->sBusName),
+                                        DLT_STRING(" Obj name: "), DLT_STRING(pClient->sObjName));
+    }
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function releases the slot of a lifecycle client, which has been unregistered.
+*
+* PLEASE NOTE: The function has to be called with a locked NSM__pNodeStateMutex.
+*
+* @param pClient: Lifecycle client, which is removed
+*
+**********************************************************************************************************************/
+static void NSM__vSnapshotRemoveClient(NSM__tstLifecycleClient *pClient)
+{
+  if((NSM__pstSnapshot != NULL) && (pClient->u32SnapshotSlot != 0))
+  {
+    g_atomic_int_set((gint*) &NSM__pstSnapshot->astClients[pClient->u32SnapshotSlot - 1].u32Used, 0);
+  }
+
+  pClient->u32SnapshotSlot = 0;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function writes a product session to the snapshot. The slot of the session is searched by name and seat.
+* A session with the state "Unregistered" releases its slot. Platform sessions are not stored.
+*
+* PLEASE NOTE: The function has to be called with a locked NSM__pSessionMutex.
+*
+* @param pstSession: Session, which has been registered, changed or unregistered
+*
+**********************************************************************************************************************/
+static void NSM__vSnapshotSession(NsmSession_s *pstSession)
+{
+  /* Function local variables                                                   */
+  NSM__tstSnapshotSession *pstSlot     = NULL; /* Slot of the session          */
+  NSM__tstSnapshotSession *pstFreeSlot = NULL; /* First free slot             */
+  guint32                  u32SlotIdx  = 0;
+
+  if((NSM__pstSnapshot != NULL) && (NSM__boIsPlatformSession(pstSession) == FALSE))
+  {
+    for(u32SlotIdx = 0; (u32SlotIdx < NSM_SNAPSHOT_MAX_SESSIONS) && (pstSlot == NULL); u32SlotIdx++)
+    {
+      if(NSM__pstSnapshot->astSessions[u32SlotIdx].u32Used == 0)
+      {
+        pstFreeSlot = (pstFreeSlot == NULL) ? &NSM__pstSnapshot->astSessions[u32SlotIdx] : pstFreeSlot;
+      }
+      else if(NSM__i32SessionNameSeatCompare(&NSM__pstSnapshot->astSessions[u32SlotIdx].stSession, pstSession) == 0)
+      {
+        pstSlot = &NSM__pstSnapshot->astSessions[u32SlotIdx];
+      }
+    }
+
+    if(pstSession->enState == NsmSessionState_Unregistered)
+    {
+      if(pstSlot != NULL)
+      {
+        g_atomic_int_set((gint*) &pstSlot->u32Used, 0);
+      }
+    }
+    else
+    {
+      pstSlot = (pstSlot == NULL) ? pstFreeSlot : pstSlot;
+
+      if(pstSlot != NULL)
+      {
+        g_atomic_int_set((gint*) &pstSlot->u32Used, 0);
+        memcpy(&pstSlot->stSession, pstSession, sizeof(NsmSession_s));
+        g_atomic_int_set((gint*) &pstSlot->u32Used, 1);
+      }
+      else
+      {
+        DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to store session in snapshot. No free slot."),
+                                          DLT_STRING(" Name: "), DLT_STRING(pstSession->sName          ),
+                                          DLT_STRING(" Seat: "), DLT_INT((gint) pstSession->enSeat     ));
+      }
+    }
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function adds a failed application to the snapshot or removes it, when it has become valid again.
+*
+* PLEASE NOTE: The function has to be called with a locked NSM__pFailedApplicationsMutex.
+*
+* @param pstFailedApp: Application, whose state changed
+* @param boFailed:     TRUE: The application failed. FALSE: The application is valid again.
+*
+**********************************************************************************************************************/
+static void NSM__vSnapshotFailedApp(const NSM__tstFailedApplication *pstFailedApp, const gboolean boFailed)
+{
+  /* Function local variables                                                    */
+  NSM__tstSnapshotFailedApp *pstSlot     = NULL; /* Slot of the application     */
+  NSM__tstSnapshotFailedApp *pstFreeSlot = NULL; /* First free slot            */
+  guint32                    u32SlotIdx  = 0;
+
+  if(NSM__pstSnapshot != NULL)
+  {
+    for(u32SlotIdx = 0; (u32SlotIdx < NSM_SNAPSHOT_MAX_APPS) && (pstSlot == NULL); u32SlotIdx++)
+    {
+      if(NSM__pstSnapshot->astFailedApps[u32SlotIdx].u32Used == 0)
+      {
+        pstFreeSlot = (pstFreeSlot == NULL) ? &NSM__pstSnapshot->astFailedApps[u32SlotIdx] : pstFreeSlot;
+      }
+      else if(g_strcmp0(NSM__pstSnapshot->astFailedApps[u32SlotIdx].stApplication.sName, pstFailedApp->sName) == 0)
+      {
+        pstSlot = &NSM__pstSnapshot->astFailedApps[u32SlotIdx];
+      }
+    }
+
+    if(boFailed == FALSE)
+    {
+      if(pstSlot != NULL)
+      {
+        g_atomic_int_set((gint*) &pstSlot->u32Used, 0);
+      }
+    }
+    else if((pstSlot == NULL) && (pstFreeSlot != NULL))
+    {
+      memcpy(&pstFreeSlot->stApplication, pstFailedApp, sizeof(NSM__tstFailedApplication));
+      g_atomic_int_set((gint*) &pstFreeSlot->u32Used, 1);
+    }
+    else if(pstSlot == NULL)
+    {
+      DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to store failed application in snapshot. No free slot."),
+                                        DLT_STRING(" Application: "), DLT_STRING(pstFailedApp->sName));
+    }
+    else
+    {
+      /* The application already is stored */
+    }
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called periodically (with the wdog) and schedules the write back of the snapshot. On a tmpfs,
+* the changes are already visible to a restarted NSM, when they have been written to the mapping.
+*
+**********************************************************************************************************************/
+static void NSM__vSyncSnapshot(void)
+{
+  if(NSM__pstSnapshot != NULL)
+  {
+    (void) msync(NSM__pstSnapshot, sizeof(NSM__tstSnapshot), MS_ASYNC);
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function invalidates the snapshot. It is called, when the node has been shut down completely or the NSM has
+* been stopped on purpose. A new instance then starts without restoring the state.
+*
+**********************************************************************************************************************/
+static void NSM__vDiscardSnapshot(void)
+{
+  if(NSM__pstSnapshot != NULL)
+  {
+    g_atomic_int_set((gint*) &NSM__pstSnapshot->u32Magic, 0);
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function unmaps the snapshot. The file stays, so that a restarted NSM can restore the state.
+*
+**********************************************************************************************************************/
+static void NSM__vCloseSnapshot(void)
+{
+  if(NSM__pstSnapshot != NULL)
+  {
+    (void) munmap(NSM__pstSnapshot, sizeof(NSM__tstSnapshot));
+    NSM__pstSnapshot = NULL;
+  }
+
+  g_free(NSM__pstRestoreSnapshot);
+  NSM__pstRestoreSnapshot = NULL;
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called, when the NSM acquired its bus name. Lifecycle clients can be called from now on. Therefore,
+* the lifecycle state of a previous NSM instance is restored.
+*
+* @return void
+*
+**********************************************************************************************************************/
+static void NSM__vOnHandleBusNameAcquired(void)
+{
+  guint u32GapUs = 0; /* Time without NSM on the bus during a re-execution */
+
+  NSM__vLogStartupPhase("Bus name acquired");
+
+  if(NSM__pstHandover != NULL)
+  {
+    u32GapUs = (guint) (g_get_monotonic_time() - NSM__pstHandover->i64ReleaseTime);
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Took over the bus name after re-execution."),
+                                      DLT_STRING(" Gap (us): "), DLT_UINT(u32GapUs));
+
+    syslog(LOG_NOTICE, "LTPROF: reexec gap: %u us", u32GapUs);
+  }
+
+  NSM__vRestoreLifecycleState();
+}
+
+
+/**********************************************************************************************************************
+*
+* The idle callback starts a requested re-execution, if no lifecycle client is called at the moment. Otherwise, the
+* handover is started by NSM__vOnLifecycleRequestFinish, when the called clients returned.
+*
+* @param pUserData: Not used
+*
+* @return FALSE: Remove the callback
+*
+**********************************************************************************************************************/
+static gboolean NSM__boOnHandleReexecIdle(gpointer pUserData)
+{
+  gboolean boClientsIdle = FALSE; /* No lifecycle client is called */
+
+  g_mutex_lock(NSM__pNodeStateMutex);
+  boClientsIdle = (NSM__u32PendingLifecycleRequests == 0);
+  g_mutex_unlock(NSM__pNodeStateMutex);
+
+  if(boClientsIdle == TRUE)
+  {
+    (void) NSM__boStartHandover();
+  }
+  else
+  {
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Re-execution waits for called lifecycle clients."));
+  }
+
+  return FALSE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function writes the state of the NSM into a memfd and ends the event loop. The memfd is inherited by the new
+* instance, which is executed by main (NSM__vReexec) after the NSMA has been deinitialized. The snapshot is stored
+* before it is copied, so that it contains the current position of the lifecycle sequence. Each part is copied
+* under the mutex, which guards its data.
+*
+* @return TRUE:  The handover has been created. The event loop ends.
+*         FALSE: Failed to create the handover. The NSM goes on.
+*
+**********************************************************************************************************************/
+static gboolean NSM__boStartHandover(void)
+{
+  /* Function local variables                                                                             */
+  NSM__tstHandover     *pstHandover       = NULL;                       /* State for the new instance     */
+  GSList               *pListEntry        = NULL;                       /* Iterate through the sessions   */
+  NsmSession_s         *pstSession        = NULL;
+  gsize                 u32SessionsOff    = G_STRUCT_OFFSET(NSM__tstSnapshot, astSessions);   /* Header, clients */
+  gsize                 u32AppsOff        = G_STRUCT_OFFSET(NSM__tstSnapshot, astFailedApps); /* Sessions before */
+  gint                  i32BootMode       = 0;
+  NsmRestartReason_e    enRestartReason   = NsmRestartReason_NotSet;
+  NsmShutdownReason_e   enShutdownReason  = NsmShutdownReason_NotSet;
+  NsmRunningReason_e    enRunningReason   = NsmRunningReason_NotSet;
+  NsmApplicationMode_e  enApplicationMode = NsmApplicationMode_NotSet;
+
+  if(NSM__boReexecStarted == FALSE)
+  {
+    pstHandover = g_new0(NSM__tstHandover, 1);
+
+    /* Header, sequence and lifecycle clients */
+    g_mutex_lock(NSM__pNodeStateMutex);
+    NSM__vStoreLifecycleState();
+    memcpy(&pstHandover->stSnapshot, NSM__pstSnapshot, u32SessionsOff);
+    pstHandover->i32NodeState         = (gint32) NSM__enNodeState;
+    pstHandover->i32PreviousNodeState = (gint32) NSM__enPreviousNodeState;
+    g_mutex_unlock(NSM__pNodeStateMutex);
+
+    /* Product sessions from the snapshot, the platform sessions from the list */
+    g_mutex_lock(NSM__pSessionMutex);
+    memcpy(((guint8*) &pstHandover->stSnapshot) + u32SessionsOff, ((guint8*) NSM__pstSnapshot) + u32SessionsOff,
+           u32AppsOff - u32SessionsOff);
+
+    for(pListEntry = NSM__pSessions; pListEntry != NULL; pListEntry = g_slist_next(pListEntry))
+    {
+      pstSession = (NsmSession_s*) pListEntry->data;
+
+      if(   (NSM__boIsPlatformSession(pstSession)   == TRUE                              )
+         && (pstHandover->u32PlatformSessions        <  NSM_HANDOVER_MAX_PLATFORM_SESSIONS))
+      {
+        memcpy(&pstHandover->astPlatformSessions[pstHandover->u32PlatformSessions], pstSession, sizeof(NsmSession_s));
+        pstHandover->u32PlatformSessions++;
+      }
+    }
+
+    g_mutex_unlock(NSM__pSessionMutex);
+
+    /* Failed applications */
+    g_mutex_lock(NSM__pFailedApplicationsMutex);
+    memcpy(((guint8*) &pstHandover->stSnapshot) + u32AppsOff, ((guint8*) NSM__pstSnapshot) + u32AppsOff,
+           sizeof(NSM__tstSnapshot) - u32AppsOff);
+    g_mutex_unlock(NSM__pFailedApplicationsMutex);
+
+    /* Values, which a restarted NSM would get from the NSMC or the PCL */
+    (void) NSM__enGetApplicationMode(&enApplicationMode);
+    pstHandover->i32ThisApplicationMode = (gint32) enApplicationMode;
+
+    g_mutex_lock(NSM__pNextApplicationModeMutex);
+    pstHandover->i32NextApplicationMode = (gint32) NSM__enNextApplicationMode;
+    g_mutex_unlock(NSM__pNextApplicationModeMutex);
+
+    (void) NSMA_boGetBootMode(&i32BootMode);
+    (void) NSMA_boGetRestartReason(&enRestartReason);
+    (void) NSMA_boGetShutdownReason(&enShutdownReason);
+    (void) NSMA_boGetRunningReason(&enRunningReason);
+    pstHandover->i32BootMode       = (gint32) i32BootMode;
+    pstHandover->i32RestartReason  = (gint32) enRestartReason;
+    pstHandover->i32ShutdownReason = (gint32) enShutdownReason;
+    pstHandover->i32RunningReason  = (gint32) enRunningReason;
+
+    pstHandover->i64ReleaseTime = g_get_monotonic_time();
+
+#ifdef SYS_memfd_create
+    /* The memfd is not closed on exec. The new instance inherits it */
+    NSM__i32HandoverFd = (gint) syscall(SYS_memfd_create, "NodeStateManager.handover", 0);
+#endif
+
+    if(   (NSM__i32HandoverFd >= 0)
+       && (write(NSM__i32HandoverFd, pstHandover, sizeof(NSM__tstHandover)) == (ssize_t) sizeof(NSM__tstHandover)))
+    {
+      NSM__boReexecStarted = TRUE;
+
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Created handover for re-execution."),
+                                        DLT_STRING(" NodeState: "), DLT_INT((gint) pstHandover->i32NodeState),
+                                        DLT_STRING(" Seat: "),      DLT_INT((gint) pstHandover->stSnapshot.i32Seat));
+
+      (void) NSMA_boQuitEventLoop();
+    }
+    else
+    {
+      DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to create handover for re-execution."),
+                                         DLT_STRING(" Error: "), DLT_STRING(g_strerror(errno)));
+
+      if(NSM__i32HandoverFd >= 0)
+      {
+        (void) close(NSM__i32HandoverFd);
+        NSM__i32HandoverFd = -1;
+      }
+
+      /* Allow a new request */
+      NSM__boReexecRequested = FALSE;
+    }
+
+    g_free(pstHandover);
+  }
+
+  return NSM__boReexecStarted;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function executes the binary of the NSM again and passes the memfd of the handover. The PID stays the same,
+* therefore systemd keeps supervising the NSM. The function only returns, if the binary could not be executed. The
+* snapshot then still is valid and a restarted NSM restores it.
+*
+**********************************************************************************************************************/
+static void NSM__vReexec(void)
+{
+  /* Function local variables                                                        */
+  gchar *sPath     = NULL;  /* Path of the binary. It may have been replaced (update) */
+  gchar *sDeleted  = NULL;  /* Suffix of a replaced binary in /proc/self/exe        */
+  gchar *sFd       = NULL;
+  gchar *asArgv[2] = {NULL, NULL};
+
+  if(NSM__i32HandoverFd >= 0)
+  {
+    sPath = g_file_read_link("/proc/self/exe", NULL);
+
+    if(sPath != NULL)
+    {
+      sDeleted = g_strrstr(sPath, " (deleted)");
+
+      if(sDeleted != NULL)
+      {
+        *sDeleted = '\0';
+      }
+
+      sFd = g_strdup_printf("%d", NSM__i32HandoverFd);
+      (void) g_setenv(NSM_HANDOVER_ENV_FD, sFd, TRUE);
+      g_free(sFd);
+
+      asArgv[0] = sPath;
+      (void) execv(sPath, asArgv);
+    }
+
+    /* Only reached, if the binary could not be executed. DLT already is deregistered */
+    syslog(LOG_ERR, "NSM: Failed to re-execute \"%s\": %s", (sPath != NULL) ? sPath : "", g_strerror(errno));
+
+    g_unsetenv(NSM_HANDOVER_ENV_FD);
+    (void) close(NSM__i32HandoverFd);
+    NSM__i32HandoverFd = -1;
+    g_free(sPath);
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function reads the handover of a previous instance, if the NSM has been re-executed. The memfd is closed and
+* the variable is removed, so that processes started by the NSM do not inherit them.
+*
+**********************************************************************************************************************/
+static void NSM__vReadHandover(void)
+{
+  /* Function local variables                                            */
+  const gchar *sFd     = g_getenv(NSM_HANDOVER_ENV_FD);
+  gint         i32Fd   = -1;
+  gboolean     boValid = FALSE;
+  struct stat  stStat;
+
+  if(sFd != NULL)
+  {
+    i32Fd            = (gint) g_ascii_strtoll(sFd, NULL, 10);
+    NSM__pstHandover = g_new0(NSM__tstHandover, 1);
+
+    boValid =    (fstat(i32Fd, &stStat) == 0)
+              && (stStat.st_size == (off_t) sizeof(NSM__tstHandover))
+              && (pread(i32Fd, NSM__pstHandover, sizeof(NSM__tstHandover), 0) == (ssize_t) sizeof(NSM__tstHandover))
+              && (NSM__pstHandover->stSnapshot.u32Magic   == NSM_SNAPSHOT_MAGIC      )
+              && (NSM__pstHandover->stSnapshot.u32Version == NSM_SNAPSHOT_VERSION    )
+              && (NSM__pstHandover->stSnapshot.u32Size    == sizeof(NSM__tstSnapshot))
+              && (NSM__pstHandover->u32PlatformSessions   <= NSM_HANDOVER_MAX_PLATFORM_SESSIONS);
+
+    if(boValid == FALSE)
+    {
+      g_free(NSM__pstHandover);
+      NSM__pstHandover = NULL;
+    }
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Read handover of re-execution."),
+                                      DLT_STRING(" Fd: "),    DLT_INT(i32Fd    ),
+                                      DLT_STRING(" Valid: "), DLT_BOOL(boValid ));
+
+    (void) close(i32Fd);
+    g_unsetenv(NSM_HANDOVER_ENV_FD);
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function checks a value of the handover. The handover has been written by another binary, which may have been
+* built with other enumerations. A value out of range is replaced by the initial value.
+*
+* @param sValue:     Name of the value, for the log
+* @param i32Value:   Value of the handover
+* @param i32First:   First valid value
+* @param i32Last:    First invalid value after the valid ones
+* @param i32Default: Value used instead of an invalid one
+*
+* @return Value to apply
+*
+**********************************************************************************************************************/
+static gint32 NSM__i32CheckHandoverValue(const gchar *sValue,
+                                         gint32       i32Value,
+                                         gint32       i32First,
+                                         gint32       i32Last,
+                                         gint32       i32Default)
+{
+  gint32 i32RetVal = i32Value;
+
+  if((i32Value < i32First) || (i32Value >= i32Last))
+  {
+    i32RetVal = i32Default;
+    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Invalid value in handover of re-execution."),
+                                      DLT_STRING(" Value: "),   DLT_STRING(sValue  ),
+                                      DLT_STRING(" Handover: "), DLT_INT(i32Value  ),
+                                      DLT_STRING(" Applied: "), DLT_INT(i32Default));
+  }
+
+  return i32RetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function applies the values of the handover, which are not part of the snapshot. It is called at start up,
+* after the snapshot has been restored and before the values are published. The NodeState is set without starting a
+* sequence. The lifecycle clients go on with it, when they have been restored (NSM__vFinishRestore).
+*
+**********************************************************************************************************************/
+static void NSM__vApplyHandover(void)
+{
+  /* Function local variables                                                     */
+  GSList       *pListEntry = NULL;  /* Platform session in the list               */
+  guint32       u32Idx     = 0;
+  NsmSession_s *pstSession = NULL;  /* Handed over platform session              */
+
+  if(NSM__pstHandover != NULL)
+  {
+    /* Replace values out of range. The reasons are applied by main, after the NSMA has been initialized */
+    NSM__pstHandover->i32NodeState           = NSM__i32CheckHandoverValue("NodeState",
+                                                                          NSM__pstHandover->i32NodeState,
+                                                                          NsmNodeState_NotSet, NsmNodeState_Last,
+                                                                          NsmNodeState_NotSet);
+    NSM__pstHandover->i32PreviousNodeState   = NSM__i32CheckHandoverValue("PreviousNodeState",
+                                                                          NSM__pstHandover->i32PreviousNodeState,
+                                                                          NsmNodeState_NotSet, NsmNodeState_Last,
+                                                                          NsmNodeState_NotSet);
+    NSM__pstHandover->i32ThisApplicationMode = NSM__i32CheckHandoverValue("ThisApplicationMode",
+                                                                          NSM__pstHandover->i32ThisApplicationMode,
+                                                                          NsmApplicationMode_NotSet, NsmApplicationMode_Last,
+                                                                          NsmApplicationMode_NotSet);
+    NSM__pstHandover->i32NextApplicationMode = NSM__i32CheckHandoverValue("NextApplicationMode",
+                                                                          NSM__pstHandover->i32NextApplicationMode,
+                                                                          NsmApplicationMode_NotSet, NsmApplicationMode_Last,
+                                                                          NsmApplicationMode_NotSet);
+    NSM__pstHandover->i32RestartReason       = NSM__i32CheckHandoverValue("RestartReason",
+                                                                          NSM__pstHandover->i32RestartReason,
+                                                                          NsmRestartReason_NotSet, NsmRestartReason_Last,
+                                                                          NsmRestartReason_NotSet);
+    NSM__pstHandover->i32ShutdownReason      = NSM__i32CheckHandoverValue("ShutdownReason",
+                                                                          NSM__pstHandover->i32ShutdownReason,
+                                                                          NsmShutdownReason_NotSet, NsmShutdownReason_Last,
+                                                                          NsmShutdownReason_NotSet);
+    /* Products define running reasons after the platform ones. Only negative values are invalid */
+    NSM__pstHandover->i32RunningReason       = NSM__i32CheckHandoverValue("RunningReason",
+                                                                          NSM__pstHandover->i32RunningReason,
+                                                                          NsmRunningReason_NotSet, G_MAXINT32,
+                                                                          NsmRunningReason_WakeupCan);
+
+    g_mutex_lock(NSM__pSessionMutex);
+
+    for(u32Idx = 0; u32Idx < NSM__pstHandover->u32PlatformSessions; u32Idx++)
+    {
+      pstSession = &NSM__pstHandover->astPlatformSessions[u32Idx];
+      pstSession->sName [NSM_MAX_SESSION_NAME_LENGTH  - 1] = '\0';
+      pstSession->sOwner[NSM_MAX_SESSION_OWNER_LENGTH - 1] = '\0';
+
+      pListEntry = g_slist_find_custom(NSM__pSessions, pstSession, &NSM__i32SessionNameSeatCompare);
+
+      /* A platform session always has a state. "Unregistered" or less would remove it for the clients */
+      if((pListEntry != NULL) && ((gint) pstSession->enState > (gint) NsmSessionState_Unregistered))
+      {
+        memcpy(pListEntry->data, pstSession, sizeof(NsmSession_s));
+      }
+    }
+
+    g_mutex_unlock(NSM__pSessionMutex);
+
+    g_mutex_lock(NSM__pNodeStateMutex);
+    NSM__enPreviousNodeState = (NsmNodeState_e) NSM__pstHandover->i32PreviousNodeState;
+    g_atomic_int_set((gint*) &NSM__enNodeState, NSM__pstHandover->i32NodeState);
+    g_mutex_unlock(NSM__pNodeStateMutex);
+
+    /* The ApplicationMode of this lifecycle is not read from the PCL again. It already contains the next one */
+    g_mutex_lock(NSM__pThisApplicationModeMutex);
+    NSM__enThisApplicationMode = (NsmApplicationMode_e) NSM__pstHandover->i32ThisApplicationMode;
+    g_atomic_int_set(&NSM__boThisApplicationModeRead, TRUE);
+    g_mutex_unlock(NSM__pThisApplicationModeMutex);
+
+    g_mutex_lock(NSM__pNextApplicationModeMutex);
+    NSM__enNextApplicationMode = (NsmApplicationMode_e) NSM__pstHandover->i32NextApplicationMode;
+    g_mutex_unlock(NSM__pNextApplicationModeMutex);
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Applied handover of re-execution."),
+                                      DLT_STRING(" NodeState: "),         DLT_INT(NSM__pstHandover->i32NodeState       ),
+                                      DLT_STRING(" Platform sessions: "), DLT_UINT(NSM__pstHandover->u32PlatformSessions));
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is called when:
+*    - The NodeState changes (NSM__boHandleSetNodeState), to initiate a lifecycle sequence
+*    - A seat should be shut down or run up (NSM__enOnHandleRequestSeatLifecycle)
+*    - All called clients returned and the next client has to be called (NSM__vOnLifecycleRequestFinish)
+*
+* If the clients need to "run up" or shut down for the current NodeState, the function
+* searches the list forward or backward until a client is found, which needs to be informed.
+* An active seat sequence is finished, before the clients are informed about the NodeState.
+* Load shedding clients are informed level by level. The clients of a level are called in parallel.
+* Suspended clients are resumed in parallel groups. The NSM keeps all its data, while the node is suspended.
+* Clients of the 'Last user context' are run up in parallel, before all other clients.
+*
+* PLEASE NOTE: If all clients have been informed about a "shut down", this function will quit the
+*              "g_main_loop", which leads to the the termination of the NSM!
+*
+* @return void
+*
+**********************************************************************************************************************/
+static void NSM__vCallNextLifecycleClient(void)
+{
+  /* Function local variables                                                                      */
+  guint32                  u32ShutdownType = NSM_SHUTDOWNTYPE_NOT; /* Return value                 */
+  gboolean                 boShutdown      = FALSE;
+  NSM__tstLifecycleClient *pClient         = NULL;                 /* Client that is informed      */
+  GList                   *pClients        = NULL;                 /* Clients informed in parallel */
+  GList                   *pListEntry      = NULL;                 /* Iterate through list entries */
+  NsmNodeState_e           enFinalState    = NsmNodeState_NotSet;  /* NodeState set at the end     */
+  NsmNodeState_e           enOldNodeState  = NsmNodeState_NotSet;  /* NodeState before final state */
+  gboolean                 boCallNext      = FALSE;                /* No client could be called    */
+  guint32                  u32ClientType   = NSM_SHUTDOWNTYPE_NOT; /* Request for a single client  */
+  gboolean                 boLucRunup      = FALSE;                /* Clients are LUC clients      */
+  gint64                   i64CallTime     = 0;                    /* Time the clients were called */
+
+  g_mutex_lock(NSM__pNodeStateMutex);
+
+  /* If a seat sequence is active, find the next client of the seat */
+  if(NSM__enLifecycleSeat != NsmSeat_NotSet)
+  {
+    u32ShutdownType = NSM__u32SeatRequestType;
+    pClient         = NSM__pstFindNextLifecycleClient(u32ShutdownType, NSM__enLifecycleSeat);
+
+    if(pClient == NULL)
+    {
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Informed all lifecycle clients of seat."           ),
+                                        DLT_STRING(" Seat: "),        DLT_INT((gint) NSM__enLifecycleSeat),
+                                        DLT_STRING(" ShutdownType: "), DLT_UINT(NSM__u32SeatRequestType  ));
+
+      NSM__enLifecycleSeat    = NsmSeat_NotSet;
+      NSM__u32SeatRequestType = NSM_SHUTDOWNTYPE_NOT;
+    }
+  }
+
+  /* Based on NodeState determine if clients have to shutdown or run up. Find a client that has not been informed */
+  if(pClient == NULL)
+  {
+    switch(NSM__enNodeState)
+    {
+      case NsmNodeState_ShuttingDown:
+        u32ShutdownType = NSM_SHUTDOWNTYPE_NORMAL;
+        pClient         = NSM__pstFindNextLifecycleClient(u32ShutdownType, NsmSeat_NotSet);
+      break;
+
+      case NsmNodeState_FastShutdown:
+        u32ShutdownType = NSM_SHUTDOWNTYPE_FAST;
+        pClient         = NSM__pstFindNextLifecycleClient(u32ShutdownType, NsmSeat_NotSet);
+      break;
+
+      case NsmNodeState_Suspending:
+        u32ShutdownType = NSM_SHUTDOWNTYPE_SUSPEND;
+        pClient         = NSM__pstFindNextLifecycleClient(u32ShutdownType, NsmSeat_NotSet);
+      break;
+
+      /* All clients are suspended. They are resumed, when the node leaves the state */
+      case NsmNodeState_Suspended:
+        u32ShutdownType = NSM_SHUTDOWNTYPE_NOT;
+      break;
+
+      /* Run up clients that have been shut down, before the running clients are shed level by level */
+      case NsmNodeState_DegradedPower:
+        u32ShutdownType = NSM_SHUTDOWNTYPE_RUNUP;
+        pClients        = NSM__pFindLucRunupClients();
+        boLucRunup      = (pClients != NULL);
+
+        if(pClients == NULL)
+        {
+          pClient = NSM__pstFindNextLifecycleClient(u32ShutdownType, NsmSeat_NotSet);
+        }
+
+        if((pClients == NULL) && (pClient == NULL))
+        {
+          u32ShutdownType = NSM_SHUTDOWNTYPE_DEGRADE;
+          pClients        = NSM__pFindNextShedLevelClients(u32ShutdownType);
+        }
+      break;
+
+      /* Run up 'Last user context' clients first. Then run up shed clients level by level and resume suspended
+         clients in groups, before clients run up that have been shut down */
+      default:
+        u32ShutdownType = NSM_SHUTDOWNTYPE_RUNUP;
+        pClients        = NSM__pFindLucRunupClients();
+        boLucRunup      = (pClients != NULL);
+
+        if(pClients == NULL)
+        {
+          pClients = NSM__pFindNextShedLevelClients(u32ShutdownType);
+        }
+
+        if(pClients == NULL)
+        {
+          u32ShutdownType = NSM_SHUTDOWNTYPE_RESUME;
+          pClients        = NSM__pFindNextResumeClients();
+        }
+
+        if(pClients == NULL)
+        {
+          u32ShutdownType = NSM_SHUTDOWNTYPE_RUNUP;
+          pClient         = NSM__pstFindNextLifecycleClient(u32ShutdownType, NsmSeat_NotSet);
+        }
+      break;
+    }
+  }
+
+  /* A single client is called like a group with one member */
+  if(pClient != NULL)
+  {
+    pClients = g_list_append(pClients, pClient);
+  }
+
+  /* Check if clients could be found that need to be informed */
+  if(pClients != NULL)
+  {
+    NSM__u32PendingLifecycleRequests = 0;
+    i64CallTime                      = g_get_monotonic_time();
+
+    for(pListEntry = g_list_first(pClients); pListEntry != NULL; pListEntry = g_list_next(pListEntry))
+    {
+      pClient = (NSM__tstLifecycleClient*) pListEntry->data;
+
+      /* Suspended clients of the 'Last user context' are resumed, while the other LUC clients run up */
+      u32ClientType = (   (u32ShutdownType      == NSM_SHUTDOWNTYPE_RUNUP)
+                       && (pClient->boSuspended == TRUE                  )) ? NSM_SHUTDOWNTYPE_RESUME : u32ShutdownType;
+
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Call lifecycle client."                             ),
+                                        DLT_STRING(" Bus name: "),         DLT_STRING(pClient->sBusName      ),
+                                        DLT_STRING(" Obj name: "),         DLT_STRING(pClient->sObjName      ),
+                                        DLT_STRING(" Registered types: "), DLT_INT(pClient->u32RegisteredMode),
+                                        DLT_STRING(" Client: "),           DLT_INT( (guint) pClient->hClient ),
+                                        DLT_STRING(" Seat: "),             DLT_INT( (gint) pClient->enSeat   ),
+                                        DLT_STRING(" Shed level: "),       DLT_UINT(pClient->u32ShedLevel    ),
+                                        DLT_STRING(" ShutdownType: "),     DLT_UINT(u32ClientType            ));
+
+      /* Remember that client received a run-up, resume, degrade, suspend or shutdown call */
+      pClient->boShed      = (u32ClientType == NSM_SHUTDOWNTYPE_DEGRADE);
+      pClient->boSuspended = (u32ClientType == NSM_SHUTDOWNTYPE_SUSPEND);
+      pClient->boShutdown  =    (u32ClientType == NSM_SHUTDOWNTYPE_NORMAL)
+                             || (u32ClientType == NSM_SHUTDOWNTYPE_FAST  );
+
+      NSM__vLtProf(pClient->sBusName, pClient->sObjName, u32ClientType, "enter: ", 0);
+
+      /* Only clients that could be called will return. Wait for them. */
+      if(NSMA_boCallLcClientRequest(pClient->hClient, u32ClientType) == TRUE)
+      {
+        NSM__u32PendingLifecycleRequests++;
+      }
+      else
+      {
+        DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to call lifecycle client."      ),
+                                          DLT_STRING(" Bus name: "), DLT_STRING(pClient->sBusName),
+                                          DLT_STRING(" Obj name: "), DLT_STRING(pClient->sObjName));
+      }
+    }
+
+    g_list_free(pClients);
+    boShutdown = FALSE;
+    boCallNext = (NSM__u32PendingLifecycleRequests == 0);
+
+    /* The LUC run up is measured, until the last LUC client returned. Only if at least one could be called */
+    if((boLucRunup == TRUE) && (boCallNext == FALSE))
+    {
+      NSM__i64LucRunupStartTime = i64CallTime;
+    }
+  }
+  else
+  {
+    /* The last client was called. Depending on the NodeState check if we can end. */
+    switch(NSM__enNodeState)
+    {
+      /* All registered clients have been 'fast shutdown'. Set NodeState to "shutdown" */
+      case NsmNodeState_FastShutdown:
+        DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Informed all registered clients about 'fast shutdown'. Set NodeState to 'shutdown'"));
+
+        NSM__enPreviousNodeState = NSM__enNodeState;
+        g_atomic_int_set((gint*) &NSM__enNodeState, (gint) NsmNodeState_Shutdown);
+        NSMA_boSendNodeStateSignal(NSM__enNodeState);
+        enFinalState = NSM__enNodeState;
+        boShutdown = TRUE;
+      break;
+
+      /* All registered clients have been 'shutdown'. Set NodeState to "shutdown" */
+      case NsmNodeState_ShuttingDown:
+        DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Informed all registered clients about 'shutdown'. Set NodeState to 'shutdown'."));
+
+        NSM__enPreviousNodeState = NSM__enNodeState;
+        g_atomic_int_set((gint*) &NSM__enNodeState, (gint) NsmNodeState_Shutdown);
+        NSMA_boSendNodeStateSignal(NSM__enNodeState);
+        enFinalState = NSM__enNodeState;
+        boShutdown = TRUE;
+      break;
+
+      /* All registered clients have been suspended. Set NodeState to "suspended". The NSM keeps running. */
+      case NsmNodeState_Suspending:
+        DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Informed all registered clients about 'suspend'. Set NodeState to 'suspended'."));
+
+        NSM__enPreviousNodeState = NSM__enNodeState;
+        g_atomic_int_set((gint*) &NSM__enNodeState, (gint) NsmNodeState_Suspended);
+        NSMA_boSendNodeStateSignal(NSM__enNodeState);
+        enFinalState = NSM__enNodeState;
+        boShutdown = FALSE;
+      break;
+
+      /* We are in a running state. Nothing to do */
+      default:
+        boShutdown = FALSE;
+      break;
+    }
+  }
+
+  /* Store the progress. After a complete shutdown, there is nothing left to resume. */
+  if(boShutdown == FALSE)
+  {
+    NSM__vStoreLifecycleState();
+  }
+  else
+  {
+    NSM__vDiscardSnapshot();
+  }
+
+  /* The transition is passed to the NSMC. Another change may replace the previous NodeState after the unlock */
+  enOldNodeState = NSM__enPreviousNodeState;
+
+  g_mutex_unlock(NSM__pNodeStateMutex);
+
+  /* Inform the StateMachine about the final NodeState, after the lock has been released */
+  if(enFinalState != NsmNodeState_NotSet)
+  {
+    (void) NSM__enInformMachine(NsmDataType_NodeState, &enFinalState, sizeof(NsmNodeState_e), enOldNodeState);
+
+    /* Readers of the state page see "Suspended" or "Shutdown", not the state of the finished sequence */
+    NSM__vUpdateStatePage();
+
+    /* Callers of WaitForNodeState, which wait for the final NodeState, are answered */
+    (void) NSMA_boCompleteNodeStateWaiters(enFinalState);
+  }
+
+  if(boShutdown == TRUE)
+  {
+    /* The node is shut down. The last ApplicationMode must be persistent, before the NSM ends */
+    NSM__vFlushPersistence();
+    NSMA_boQuitEventLoop();
+  }
+
+  /* No finish callback will arrive for the clients. Go on with the next client(s) at once. */
+  if(boCallNext == TRUE)
+  {
+    NSM__vCallNextLifecycleClient();
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called when a check for LUC is required.
+* It uses the NodeStateMachine to determine whether LUC is required.
+*
+* @param pboRetVal: Pointer, where to store the StateMAchine's return value
+*
+**********************************************************************************************************************/
+static gboolean NSM__boOnHandleCheckLucRequired(void)
+{
+  /* Determine if LUC is required by asking the NodeStateMachine */
+  return (NSM__stNsmc.pfLucRequired() == 0x01) ? TRUE : FALSE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called when the lifecycle clients of a seat should be shut down or run up.
+* The seat sequence is started immediately, if no other lifecycle client is called at the moment. Otherwise,
+* it will be started as soon as the current client returned.
+*
+* @param enSeatId:       Seat whose clients should be informed
+* @param u32RequestType: Request for the clients (NSM_SHUTDOWNTYPE_NORMAL, NSM_SHUTDOWNTYPE_FAST or
+*                        NSM_SHUTDOWNTYPE_RUNUP)
+*
+* @return see NsmErrorStatus_e
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleRequestSeatLifecycle(const NsmSeat_e enSeatId, const guint u32RequestType)
+{
+  /* Function local variables                                                         */
+  NsmErrorStatus_e enRetVal        = NsmErrorStatus_NotSet; /* Return value           */
+  gboolean         boStartSequence = FALSE;                 /* Start calling clients  */
+
+  if(   (enSeatId > NsmSeat_NotSet)
+     && (enSeatId < NsmSeat_Last  )
+     && (   (u32RequestType == NSM_SHUTDOWNTYPE_NORMAL)
+         || (u32RequestType == NSM_SHUTDOWNTYPE_FAST  )
+         || (u32RequestType == NSM_SHUTDOWNTYPE_RUNUP )))
+  {
+    g_mutex_lock(NSM__pNodeStateMutex);
+
+    /* A seat can only be controlled while the node runs and no other seat sequence is active */
+    if(   (NSM__enLifecycleSeat == NsmSeat_NotSet           )
+       && (NSM__enNodeState     != NsmNodeState_ShuttingDown)
+       && (NSM__enNodeState     != NsmNodeState_FastShutdown)
+       && (NSM__enNodeState     != NsmNodeState_Shutdown    )
+       && (NSM__enNodeState     != NsmNodeState_Suspending  )
+       && (NSM__enNodeState     != NsmNodeState_Suspended   ))
+    {
+      enRetVal = NsmErrorStatus_Ok;
+
+      NSM__enLifecycleSeat           = enSeatId;
+      NSM__u32SeatRequestType        = u32RequestType;
+      NSM__aboSeatShutdown[enSeatId] = (u32RequestType != NSM_SHUTDOWNTYPE_RUNUP);
+      boStartSequence                = (NSM__u32PendingLifecycleRequests == 0);
+
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Started lifecycle sequence for seat."),
+                                        DLT_STRING(" Seat: "),         DLT_INT((gint) enSeatId ),
+                                        DLT_STRING(" ShutdownType: "), DLT_UINT(u32RequestType ));
+    }
+    else
+    {
+      enRetVal = NsmErrorStatus_Error;
+      DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to start lifecycle sequence for seat. Node shuts down or seat sequence active."),
+                                        DLT_STRING(" Seat: "),         DLT_INT((gint) enSeatId                     ),
+                                        DLT_STRING(" ShutdownType: "), DLT_UINT(u32RequestType                     ),
+                                        DLT_STRING(" Active seat: "),  DLT_INT((gint) NSM__enLifecycleSeat         ),
+                                        DLT_STRING(" NodeState: "),    DLT_INT((gint) NSM__enNodeState             ));
+    }
+
+    /* Leave the lock now, because its not recursive. 'NSM__vCallNextLifecycleClient' needs it. */
+    g_mutex_unlock(NSM__pNodeStateMutex);
+
+    if(boStartSequence == TRUE)
+    {
+      NSM__vCallNextLifecycleClient();
+    }
+  }
+  else
+  {
+    enRetVal = NsmErrorStatus_Parameter;
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to start lifecycle sequence for seat. Invalid parameter."),
+                                       DLT_STRING(" Seat: "),         DLT_INT((gint) enSeatId                          ),
+                                       DLT_STRING(" ShutdownType: "), DLT_UINT(u32RequestType                          ));
+  }
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called when the NSM should re-execute its binary ("Reexec" or SIGHUP). The handover is created in
+* an idle callback, so that the caller gets the reply from this instance. If lifecycle clients are called at the
+* moment, the handover waits until they returned. The request is rejected, if the state can not be handed over.
+*
+* @return see NsmErrorStatus_e
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleReexec(void)
+{
+  NsmErrorStatus_e enRetVal = NsmErrorStatus_NotSet;
+
+#ifdef SYS_memfd_create
+  /* The lifecycle state is handed over via the snapshot. A restore still running would be lost */
+  if(   (NSM__pstSnapshot             != NULL )
+     && (NSM__boReexecRequested       == FALSE)
+     && (NSM__u32RestoreChecksPending == 0    ))
+  {
+    enRetVal = NsmErrorStatus_Ok;
+    NSM__boReexecRequested = TRUE;
+    (void) g_idle_add(&NSM__boOnHandleReexecIdle, NULL);
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Re-execution requested."));
+  }
+  else
+  {
+    enRetVal = NsmErrorStatus_Error;
+    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to request re-execution. No snapshot or already requested."),
+                                      DLT_STRING(" Requested: "), DLT_BOOL(NSM__boReexecRequested));
+  }
+#else
+  enRetVal = NsmErrorStatus_Error;
+  DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to request re-execution. No memfd support."));
+#endif
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called when the "boot mode" should be set.
+* It sets the BootMode using an internal function.
+*
+* @param i32BootMode: New boot mode
+* @param penRetVal:   Pointer, where to store the return value
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleSetBootMode(const gint i32BootMode)
+{
+  /* Use internal setter to set the BootMode and inform the StateMachine */
+  return NSM__enSetBootMode(i32BootMode, TRUE);
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called when the "node state" should be set.
+* It sets the NodeState using an internal function.
+*
+* @param enNodeStateId: New node state
+* @param penRetVal:     Pointer, where to store the return value
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleSetNodeState(const NsmNodeState_e  enNodeState)
+{
+  return NSM__enSetNodeState(enNodeState, TRUE, TRUE);
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called when the "application mode" should be set.
+* It sets the ApplicationMode using an internal function.
+*
+* @param enApplicationModeId: New application mode
+* @param penRetVal:           Pointer, where to store the return value
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleSetApplicationMode(const NsmApplicationMode_e enApplMode)
+{
+  return NSM__enSetApplicationMode(enApplMode, TRUE, TRUE);
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called when the node reset is requested.
+* It passes the request to the NodestateMachine.
+*
+* @param i32RestartReason:     Restart reason
+* @param i32RestartType:       Restart type
+* @param penRetVal:            Pointer, where to store the return value
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleRequestNodeRestart(const NsmRestartReason_e enRestartReason,
+                                                          const guint              u32RestartType)
+{
+  NsmErrorStatus_e enRetVal = NsmErrorStatus_NotSet;
+
+  DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Node restart has been requested."));
+
+  if(NSM__boRequestMachineRestart(enRestartReason, u32RestartType) == TRUE)
+  {
+    enRetVal = NsmErrorStatus_Ok;
+
+    /* An asynchronous NSMC only queued the request. The reason is set, when the NSMC accepts it */
+    if(NSM__pstNsmcEvents == NULL)
+    {
+      (void) NSMA_boSetRestartReason(enRestartReason);
+      NSM__vUpdateStatePage();
+    }
+  }
+  else
+  {
+    enRetVal = NsmErrorStatus_Error;
+  }
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The called is called when a new session should be registered.
+* It checks the passed parameters and creates a NsmSession_s structure of them.
+* If everything is ok, the new session will be created and the system and StateMachine will be informed.
+*
+* @param sSessionName:   Name of the new session
+* @param sSessionOwner:  Owner of the new session
+* @param enSeatId:       Seat which belongs to the new session
+* @param enSessionState: Initial state of the new session
+* @param penRetVal:      Pointer, where to store the return value
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleRegisterSession(const gchar             *sSessionName,
+                                                       const gchar             *sSessionOwner,
+                                                       const NsmSeat_e          enSeatId,
+                                                       const NsmSessionState_e  enSessionState)
+{
+  /* Function local variables                                                     */
+  glong             u32SessionNameLen  = 0;     /* Length of passed session owner */
+  glong             u32SessionOwnerLen = 0;     /* Length of passed session name  */
+  NsmSession_s      stSession;                  /* To search for existing session */
+  NsmErrorStatus_e  enRetVal           = NsmErrorStatus_NotSet;
+
+  /* Check if the passed parameters are valid */
+  u32SessionNameLen  = g_utf8_strlen(sSessionName,  -1);
+  u32SessionOwnerLen = g_utf8_strlen(sSessionOwner, -1);
+
+  if(   (u32SessionNameLen  <  NSM_MAX_SESSION_NAME_LENGTH )
+     && (u32SessionOwnerLen <  NSM_MAX_SESSION_OWNER_LENGTH)
+     && (enSeatId           >  NsmSeat_NotSet              )
+     && (enSeatId           <  NsmSeat_Last                ))
+  {
+    /* Initialize temporary session object to check if session already exists */
+    g_strlcpy((gchar*) stSession.sName,  sSessionName,  sizeof(stSession.sName) );
+    g_strlcpy((gchar*) stSession.sOwner, sSessionOwner, sizeof(stSession.sOwner));
+    stSession.enSeat  = enSeatId;
+    stSession.enState = enSessionState;
+
+    enRetVal = NSM__enRegisterSession(&stSession, TRUE, TRUE);
+  }
+  else
+  {
+    /* Error: A parameter with an invalid value has been passed */
+    enRetVal = NsmErrorStatus_Parameter;
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to register session. Invalid parameter."),
+                                       DLT_STRING("Name:"         ), DLT_STRING(sSessionName           ),
+                                       DLT_STRING("Owner:"        ), DLT_STRING(sSessionOwner          ),
+                                       DLT_STRING("Seat:"         ), DLT_INT((gint) enSeatId           ),
+                                       DLT_STRING("Initial state:"), DLT_INT((gint) enSessionState     ));
+  }
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called when a session should be unregistered.
+* It checks the passed parameters and creates a NsmSession_s structure of them.
+* If everything is ok, the new session will be removed and the system and StateMachine will be informed.
+*
+* @param sSessionName:  Name of the new session that should be unregistered.
+* @param sSessionOwner: Current owner of the session that should be unregistered.
+* @param enSeat:        Seat for which the session should be unregistered.
+* @param penRetVal:     Pointer, where to store the return value
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleUnRegisterSession(const gchar     *sSessionName,
+                                                         const gchar     *sSessionOwner,
+                                                         const NsmSeat_e  enSeatId)
+{
+  /* Function local variables                                                                   */
+  glong             u32SessionNameLen  = 0;                   /* Length of passed session owner */
+  glong             u32SessionOwnerLen = 0;                   /* Length of passed session name  */
+  NsmSession_s      stSearchSession    = {0};                 /* To search for existing session */
+  NsmErrorStatus_e  enRetVal           = NsmErrorStatus_NotSet;
+
+  /* Check if the passed parameters are valid */
+  u32SessionNameLen  = g_utf8_strlen(sSessionName,  -1);
+  u32SessionOwnerLen = g_utf8_strlen(sSessionOwner, -1);
+
+  if(   (u32SessionNameLen   < NSM_MAX_SESSION_NAME_LENGTH )
+     && (u32SessionOwnerLen  < NSM_MAX_SESSION_OWNER_LENGTH))
+  {
+    /* Assign seat, session name and owner to search for session */
+    stSearchSession.enSeat = enSeatId;
+    g_strlcpy((gchar*) stSearchSession.sName,  sSessionName,  sizeof(stSearchSession.sName) );
+    g_strlcpy((gchar*) stSearchSession.sOwner, sSessionOwner, sizeof(stSearchSession.sOwner));
+
+    enRetVal = NSM__enUnRegisterSession(&stSearchSession, TRUE, TRUE);
+  }
+  else
+  {
+    /* Error: Invalid parameter. The session or owner name is to long. */
+    enRetVal = NsmErrorStatus_Parameter;
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to unregister session. The session or owner name is to long."),
+                                       DLT_STRING(" Name: "      ), DLT_STRING(sSessionName                                 ),
+                                       DLT_STRING(" Owner: "     ), DLT_STRING(sSessionOwner                                ),
+                                       DLT_STRING(" Seat: "      ), DLT_INT((gint) enSeatId                                 ));
+  }
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called when a lifecycle client should be registered.
+* In the list of lifecycle clients it will be checked if the client already exists.
+* If it exists, it's settings will be updated. Otherwise a new client will be created.
+*
+* @param sBusName:        Bus name of the remote application that hosts the lifecycle client interface
+* @param sObjName:        Object name of the lifecycle client
+* @param u32ShutdownMode: Shutdown mode for which the client wants to be informed
+* @param u32TimeoutMs:    Timeout in ms. If the client does not return after the specified time, the NSM
+*                         aborts its shutdown and calls the next client.
+* @param enSeatId:        Seat the client belongs to. NsmSeat_NotSet, if the client belongs to the node.
+* @param penRetVal:       Pointer, where to store the return value
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleRegisterLifecycleClient(const gchar     *sBusName,
+                                                               const gchar     *sObjName,
+                                                               const guint      u32ShutdownMode,
+                                                               const guint      u32TimeoutMs,
+                                                               const NsmSeat_e  enSeatId)
+{
+  NSM__tstLifecycleClient     stTestLifecycleClient = {0};
+  NSM__tstLifecycleClient    *pstNewClient          = NULL;
+  NSM__tstLifecycleClient    *pstExistingClient     = NULL;
+  GList                      *pListEntry            = NULL;
+  NSMA_tLcConsumerHandle     *hConsumer             = NULL;
+  GError                     *pError                = NULL;
+  NsmErrorStatus_e            enRetVal              = NsmErrorStatus_NotSet;
+  NsmShutdownClient_s         stShutdownClient;
+
+  /* Create a temporary client to search the list */
+  stTestLifecycleClient.sBusName = (gchar*) sBusName;
+  stTestLifecycleClient.sObjName = (gchar*) sObjName;
+
+  /* Check if the lifecycle client already is registered */
+  pListEntry = g_list_find_custom(NSM__pLifecycleClients, &stTestLifecycleClient, &NSM__i32LifecycleClientCompare);
+
+  /* Check if the passed seat is valid. NsmSeat_NotSet is used for clients that belong to the node */
+  if((enSeatId < NsmSeat_NotSet) || (enSeatId >= NsmSeat_Last))
+  {
+    enRetVal = NsmErrorStatus_Parameter;
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to register lifecycle consumer. Invalid seat."),
+                                       DLT_STRING(" Bus name: "), DLT_STRING(sBusName                     ),
+                                       DLT_STRING(" Obj name: "), DLT_STRING(sObjName                     ),
+                                       DLT_STRING(" Seat: "    ), DLT_INT((gint) enSeatId                ));
+  }
+  else if(pListEntry == NULL)
+  {
+    /* The client does not exist. Try to create a new proxy */
+    hConsumer = NSMA_hCreateLcConsumer(sBusName, sObjName, u32TimeoutMs);
+
+    /* The new proxy could be created. Create and store new client */
+    if(hConsumer != NULL)
+    {
+      enRetVal = NsmErrorStatus_Ok;
+
+      /* Create client object and copies of the strings. */
+      pstNewClient = g_new0(NSM__tstLifecycleClient, 1);
+      pstNewClient->u32RegisteredMode = u32ShutdownMode;
+      pstNewClient->sBusName          = g_strdup(sBusName);
+      pstNewClient->sObjName          = g_strdup(sObjName);
+      pstNewClient->boShutdown        = FALSE;
+      pstNewClient->hClient           = hConsumer;
+      pstNewClient->enSeat            = enSeatId;
+
+
+      /* Append the new client to the list */
+      NSM__pLifecycleClients = g_list_append(NSM__pLifecycleClients, pstNewClient);
+
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Registered new lifecycle consumer."                 ),
+                                        DLT_STRING(" Bus name: "), DLT_STRING(pstNewClient->sBusName         ),
+                                        DLT_STRING(" Obj name: "), DLT_STRING(pstNewClient->sObjName         ),
+                                        DLT_STRING(" Timeout: " ), DLT_UINT(  u32TimeoutMs                   ),
+                                        DLT_STRING(" Mode(s): "),  DLT_INT(   pstNewClient->u32RegisteredMode),
+                                        DLT_STRING(" Seat: "),     DLT_INT((gint) pstNewClient->enSeat      ),
+                                        DLT_STRING(" Client: "),   DLT_UINT((guint) pstNewClient->hClient    ));
+    }
+    else
+    {
+      enRetVal = NsmErrorStatus_Dbus;
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Failed to register new lifecycle consumer. D-Bus error."),
+                                        DLT_STRING(" Bus name: "),           DLT_STRING(sBusName                 ),
+                                        DLT_STRING(" Obj name: "),           DLT_STRING(sObjName                 ),
+                                        DLT_STRING(" Timeout: " ),           DLT_UINT(  u32TimeoutMs             ),
+                                        DLT_STRING(" Registered mode(s): "), DLT_INT(   u32ShutdownMode          ),
+                                        DLT_STRING(" Error: "),              DLT_STRING(   ((pError          != NULL)
+                                                                                             && (pError->message != NULL))
+                                                                                           ? pError->message
+                                                                                           : "Unknown"));
+
+      if(pError != NULL)
+      {
+        g_error_free(pError);
+      }
+    }
+  }
+  else
+  {
+    /* The client already exists. Assert to update the values for timeout and mode */
+    enRetVal = NsmErrorStatus_Ok;
+    pstExistingClient = (NSM__tstLifecycleClient*) pListEntry->data;
+    pstExistingClient->u32RegisteredMode |= u32ShutdownMode;
+
+    /* Keep the seat of the client, if the registration is updated without seat */
+    if(enSeatId != NsmSeat_NotSet)
+    {
+      pstExistingClient->enSeat = enSeatId;
+    }
+
+    NSMA_boSetLcClientTimeout(pstExistingClient->hClient, u32TimeoutMs);
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Changed lifecycle consumer registration."                          ),
+                                      DLT_STRING(" Bus name: "),           DLT_STRING(pstExistingClient->sBusName         ),
+                                      DLT_STRING(" Obj name: "),           DLT_STRING(pstExistingClient->sObjName         ),
+                                      DLT_STRING(" Timeout: " ),           DLT_UINT(  u32TimeoutMs                        ),
+                                      DLT_STRING(" Registered mode(s): "), DLT_INT(   pstExistingClient->u32RegisteredMode),
+                                      DLT_STRING(" Seat: "),               DLT_INT((gint) pstExistingClient->enSeat       ));
+  }
+
+  /* Store the new registration, to be able to restore it after a restart. Then inform the StateMachine. */
+  if(enRetVal == NsmErrorStatus_Ok)
+  {
+    g_mutex_lock(NSM__pNodeStateMutex);
+    NSM__vSnapshotClient((pstNewClient != NULL) ? pstNewClient : pstExistingClient);
+    g_mutex_unlock(NSM__pNodeStateMutex);
+
+    memset(&stShutdownClient, 0, sizeof(stShutdownClient));
+    g_strlcpy(stShutdownClient.sBusName, sBusName, sizeof(stShutdownClient.sBusName));
+    g_strlcpy(stShutdownClient.sObjName, sObjName, sizeof(stShutdownClient.sObjName));
+    stShutdownClient.u32ShutdownMode = u32ShutdownMode;
+    stShutdownClient.u32TimeoutMs    = u32TimeoutMs;
+
+    (void) NSM__enInformMachine(NsmDataType_ShutdownClient, &stShutdownClient, sizeof(NsmShutdownClient_s),
+                                NsmNodeState_NotSet);
+  }
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called when a lifecycle client should be registered for load shedding.
+* The client is registered for the shutdown type "NSM_SHUTDOWNTYPE_DEGRADE" and its shed level is stored.
+*
+* @param sBusName:     Bus name of the remote application that hosts the lifecycle client interface
+* @param sObjName:     Object name of the lifecycle client
+* @param u32ShedLevel: Level in which the client is shed. Clients with lower levels are shed first.
+* @param u32TimeoutMs: Timeout in ms. If the client does not return after the specified time, the NSM
+*                      goes on with the next level.
+*
+* @return see NsmErrorStatus_e
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleRegisterLoadSheddingClient(const gchar *sBusName,
+                                                                  const gchar *sObjName,
+                                                                  const guint  u32ShedLevel,
+                                                                  const guint  u32TimeoutMs)
+{
+  NSM__tstLifecycleClient  stSearchClient = {0};
+  NSM__tstLifecycleClient *pstClient      = NULL;
+  GList                   *pListEntry     = NULL;
+  NsmErrorStatus_e         enRetVal       = NsmErrorStatus_NotSet;
+
+  enRetVal = NSM__enOnHandleRegisterLifecycleClient(sBusName,
+                                                    sObjName,
+                                                    NSM_SHUTDOWNTYPE_DEGRADE,
+                                                    u32TimeoutMs,
+                                                    NsmSeat_NotSet);
+
+  if(enRetVal == NsmErrorStatus_Ok)
+  {
+    stSearchClient.sBusName = (gchar*) sBusName;
+    stSearchClient.sObjName = (gchar*) sObjName;
+
+    /* The client has been created or updated. Store its shed level */
+    pListEntry = g_list_find_custom(NSM__pLifecycleClients, &stSearchClient, &NSM__i32LifecycleClientCompare);
+    pstClient  = (NSM__tstLifecycleClient*) pListEntry->data;
+    pstClient->u32ShedLevel = u32ShedLevel;
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Registered lifecycle consumer for load shedding."),
+                                      DLT_STRING(" Bus name: "),   DLT_STRING(sBusName                 ),
+                                      DLT_STRING(" Obj name: "),   DLT_STRING(sObjName                 ),
+                                      DLT_STRING(" Shed level: "), DLT_UINT(u32ShedLevel               ));
+
+    g_mutex_lock(NSM__pNodeStateMutex);
+    NSM__vSnapshotClient(pstClient);
+    g_mutex_unlock(NSM__pNodeStateMutex);
+  }
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The callback is called when a lifecycle client should be unregistered or a shutdown
+* mode should be removed. In the list of lifecycle clients will be checked if the client exists. If the
+* client is found, the registration for the passed shutdown modes will be removed. If the client finally
+* is not registered for any shutdown mode, its entry will be removed from the list.
+*
+* @param sBusName:        Bus name of the remote application that hosts the lifecycle client interface
+* @param sObjName:        Object name of the lifecycle client
+* @param u32ShutdownMode: Shutdown mode for which the client wants to unregister
+* @param penRetVal:       Pointer, where to store the return value
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleUnRegisterLifecycleClient(const gchar *sBusName,
+                                                                 const gchar *sObjName,
+                                                                 const guint  u32ShutdownMode)
+{
+  NSM__tstLifecycleClient *pstExistingClient = NULL;
+  NSM__tstLifecycleClient  stSearchClient    = {0};
+  GList                   *pListEntry        = NULL;
+  NsmErrorStatus_e         enRetVal          = NsmErrorStatus_NotSet;
+
+  stSearchClient.sBusName = (gchar*) sBusName;
+  stSearchClient.sObjName = (gchar*) sObjName;
+
+  /* Check if the lifecycle client already is registered */
+  pListEntry = g_list_find_custom(NSM__pLifecycleClients, &stSearchClient, &NSM__i32LifecycleClientCompare);
+
+  /* Check if an existing client could be found */
+  if(pListEntry != NULL)
+  {
+    /* The client could be found in the list. Change the registered shutdown mode */
+    enRetVal = NsmErrorStatus_Ok;
+    pstExistingClient = (NSM__tstLifecycleClient*) pListEntry->data;
+    pstExistingClient->u32RegisteredMode &= ~(u32ShutdownMode);
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Unregistered lifecycle consumer for mode(s)."                ),
+                                      DLT_STRING(" Bus name: "),     DLT_STRING(pstExistingClient->sBusName         ),
+                                      DLT_STRING(" Obj name: "),     DLT_STRING(pstExistingClient->sObjName         ),
+                                      DLT_STRING(" New mode: "),     DLT_INT(   pstExistingClient->u32RegisteredMode),
+                                      DLT_STRING(" Client: "  ),     DLT_UINT((guint) pstExistingClient->hClient)   );
+
+    /* Store the changed registration, to be able to restore it after a restart */
+    g_mutex_lock(NSM__pNodeStateMutex);
+
+    if(pstExistingClient->u32RegisteredMode == NSM_SHUTDOWNTYPE_NOT)
+    {
+      /* The client is not registered for at least one mode. Remove it from the list */
+      NSM__vSnapshotRemoveClient(pstExistingClient);
+      NSM__vFreeLifecycleClientObject(pstExistingClient);
+      NSM__pLifecycleClients = g_list_remove(NSM__pLifecycleClients, pstExistingClient);
+    }
+    else
+    {
+      NSM__vSnapshotClient(pstExistingClient);
+    }
+
+    g_mutex_unlock(NSM__pNodeStateMutex);
+  }
+  else
+  {
+    /* Warning: The client could not be found in the list of clients. */
+    enRetVal = NsmErrorStatus_Parameter;
+    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to unregister lifecycle consumer."),
+                                      DLT_STRING(" Bus name: "),             DLT_STRING(sBusName),
+                                      DLT_STRING(" Obj name: "),             DLT_STRING(sObjName),
+                                      DLT_STRING(" Unregistered mode(s): "), DLT_INT(   u32ShutdownMode));
+  }
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function is used to get the state of the passed session.
+* It checks the passed parameters and creates a NsmSession_s structure of them.
+* If everything is ok, the state of the session will be determined and written to penSessionState.
+*
+* @param sSessionName:    Name  of the session whose state just be returned
+* @param sSessionName:    Owner of the session whose state just be returned
+* @param enSeatId:        Seat of the session
+* @param penSessionState: Pointer where to store the session state
+* @param penRetVal:       Pointer where to store the return value
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleGetSessionState(const gchar       *sSessionName,
+                                                       const NsmSeat_e    enSeatId,
+                                                       NsmSessionState_e *penSessionState)
+{
+  /* Function local variables                                                                     */
+  NsmErrorStatus_e  enRetVal           = NsmErrorStatus_NotSet;
+  glong             u32SessionNameLen  = 0;                     /* Length of passed session owner */
+  NsmSession_s      stSearchSession    = {0};                   /* To search for existing session */
+
+  /* Check if the passed parameters are valid */
+  u32SessionNameLen = g_utf8_strlen(sSessionName, -1);
+
+  if(u32SessionNameLen < NSM_MAX_SESSION_OWNER_LENGTH)
+  {
+    /* Search for session with name, seat and owner. */
+    stSearchSession.enSeat = enSeatId;
+    g_strlcpy((gchar*) stSearchSession.sName,  sSessionName,  sizeof(stSearchSession.sName) );
+
+    enRetVal = NSM__enGetSessionState(&stSearchSession);
+    *penSessionState = stSearchSession.enState;
+  }
+  else
+  {
+    /* Error: Invalid parameter. The session or owner name is to long. */
+    enRetVal = NsmErrorStatus_Parameter;
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to get session state. The session name is to long."),
+                                       DLT_STRING(" Name: "      ), DLT_STRING(sSessionName                       ),
+                                       DLT_STRING(" Seat: "      ), DLT_INT((gint) enSeatId                       ));
+  }
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function sets the state of a session to a passed value.
+* It checks the passed parameters and creates a NsmSession_s structure of them.
+* If everything is ok, the state of the session will be set accordingly.
+*
+* @param sSessionName:   Name of the session whose state just be set
+* @param sSessionOwner:  Owner of the session
+* @param enSeatId:       Seat of the session
+* @param enSessionState: New state of the session
+* @param penRetVal:      Pointer where to store the return value
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enOnHandleSetSessionState(const gchar             *sSessionName,
+                                                       const gchar             *sSessionOwner,
+                                                       const NsmSeat_e          enSeatId,
+                                                       const NsmSessionState_e  enSessionState)
+{
+  /* Function local variables                                                                       */
+  NsmErrorStatus_e enRetVal           = NsmErrorStatus_NotSet;
+  glong            u32SessionNameLen  = 0;            /* Length of passed session owner             */
+  glong            u32SessionOwnerLen = 0;            /* Length of passed session name              */
+  NsmSession_s     stSession          = {0};          /* Session object passed to internal function */
+
+  /* Check if the passed parameters are valid */
+  u32SessionNameLen  = g_utf8_strlen(sSessionName,  -1);
+  u32SessionOwnerLen = g_utf8_strlen(sSessionOwner, -1);
+
+  if(   (u32SessionNameLen  < NSM_MAX_SESSION_NAME_LENGTH )
+     && (u32SessionOwnerLen < NSM_MAX_SESSION_OWNER_LENGTH))
+  {
+    /* Build session object to pass it internally */
+    g_strlcpy((gchar*) stSession.sName,  sSessionName,  sizeof(stSession.sName) );
+    g_strlcpy((gchar*) stSession.sOwner, sSessionOwner, sizeof(stSession.sOwner));
+
+    stSession.enSeat  = enSeatId;
+    stSession.enState = enSessionState;
+
+    enRetVal = NSM__enSetSessionState(&stSession, TRUE, TRUE);
+  }
+  else
+  {
+    /* Error: Invalid parameter. The session or owner name is to long. */
+    enRetVal = NsmErrorStatus_Parameter;
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to set session state. Invalid parameter."),
+                                       DLT_STRING(" Name: "      ), DLT_STRING(sSessionName             ),
+                                       DLT_STRING(" Owner: "     ), DLT_STRING(sSessionOwner            ),
+                                       DLT_STRING(" Seat: "      ), DLT_INT((gint) enSeatId             ));
+  }
+
+  return enRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The callback is called when the node reset is requested.
-* It passes the request to the NodestateMachine.
+* The helper function is called by 'NSM__boOnHandleSetAppHealthStatus', when an application became valid again.
+* It removes the application from the list of invalid apps.
 *
-* @param i32RestartReason:     Restart reason
-* @param i32RestartType:       Restart type
-* @param penRetVal:            Pointer, where to store the return value
+* @param pstFailedApp: Pointer to structure with information about the failed application.
+*
+* @return NsmErrorStatus_Ok:           The application has been removed from the list of failed apps.
+*         NsmErrorStatus_WrongSession: The application has never been on the list of failed apps.
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enOnHandleRequestNodeRestart(const NsmRestartReason_e enRestartReason,
-                                                          const guint              u32RestartType)
+static NsmErrorStatus_e NSM__enSetAppStateValid(NSM__tstFailedApplication* pstFailedApp)
 {
-  NsmErrorStatus_e enRetVal = NsmErrorStatus_NotSet;
+  /* Function local variables                                                                             */
+  GSList                    *pAppListEntry          = NULL;                  /* List entry of application */
+  NsmErrorStatus_e           enRetVal               = NsmErrorStatus_NotSet; /* Return value              */
+  NSM__tstFailedApplication *pstExistingApplication = NULL;
 
-  DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Node restart has been requested."));
+  g_mutex_lock(NSM__pFailedApplicationsMutex);
+
+  /* An application has become valid again. Check if it really was invalid before. */
+  pAppListEntry = g_slist_find_custom(NSM__pFailedApplications, pstFailedApp, &NSM__i32ApplicationCompare);
 
-  if(NsmcRequestNodeRestart(enRestartReason, u32RestartType) == 0x01)
+  if(pAppListEntry != NULL)
   {
+    /* We found at least one entry for the application. Remove it from the list */
     enRetVal = NsmErrorStatus_Ok;
-    (void) NSMA_boSetRestartReason(enRestartReason);
+    pstExistingApplication = (NSM__tstFailedApplication*) pAppListEntry->data;
+    NSM__vSnapshotFailedApp(pstExistingApplication, FALSE);
+    NSM__pFailedApplications = g_slist_remove(NSM__pFailedApplications, pstExistingApplication);
+    NSM__vFreeFailedApplicationObject(pstExistingApplication);
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: An application has become valid again."    ),
+                                      DLT_STRING(" Application: "), DLT_STRING(pstFailedApp->sName));
   }
   else
   {
+    /* Error: There was no session registered for the application that failed. */
     enRetVal = NsmErrorStatus_Error;
+    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to set application valid. Application was never invalid."),
+                                      DLT_STRING(" Application: "), DLT_STRING(pstFailedApp->sName                     ));
   }
 
+  g_mutex_unlock(NSM__pFailedApplicationsMutex);
+
   return enRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The called is called when a new session should be registered.
-* It checks the passed parameters and creates a NsmSession_s structure of them.
-* If everything is ok, the new session will be created and the system and StateMachine will be informed.
+* The helper function is called by 'NSM__enSetAppStateFailed', when an application failed.
+* It looks for sessions that have been registered by the app.
 *
-* @param sSessionName:   Name of the new session
-* @param sSessionOwner:  Owner of the new session
-* @param enSeatId:       Seat which belongs to the new session
-* @param enSessionState: Initial state of the new session
-* @param penRetVal:      Pointer, where to store the return value
+* @param pstFailedApp: Pointer to structure with information about the failed application.
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enOnHandleRegisterSession(const gchar             *sSessionName,
-                                                       const gchar             *sSessionOwner,
-                                                       const NsmSeat_e          enSeatId,
-                                                       const NsmSessionState_e  enSessionState)
+static void NSM__vDisableSessionsForApp(NSM__tstFailedApplication* pstFailedApp)
 {
-  /* Function local variables                                                     */
-  glong             u32SessionNameLen  = 0;     /* Length of passed session owner */
-  glong             u32SessionOwnerLen = 0;     /* Length of passed session name  */
-  NsmSession_s      stSession;                  /* To search for existing session */
-  NsmErrorStatus_e  enRetVal           = NsmErrorStatus_NotSet;
+  /* Function local variables */
+  GSList       *pSessionListEntry  = NULL;
+  NsmSession_s *pstExistingSession = NULL;
+  NsmSession_s  stSearchSession    = {0};
+  GSList       *pLostSessions      = NULL; /* Copies of the sessions to publish after the lock */
+  GSList       *pLostListEntry     = NULL;
 
-  /* Check if the passed parameters are valid */
-  u32SessionNameLen  = g_utf8_strlen(sSessionName,  -1);
-  u32SessionOwnerLen = g_utf8_strlen(sSessionOwner, -1);
+  /* Only set the "owner" of the session (to the AppName) to search for all sessions of the app. */
+  g_strlcpy(stSearchSession.sOwner, pstFailedApp->sName, sizeof(stSearchSession.sOwner));
 
-  if(   (u32SessionNameLen  <  NSM_MAX_SESSION_NAME_LENGTH )
-     && (u32SessionOwnerLen <  NSM_MAX_SESSION_OWNER_LENGTH)
-     && (enSeatId           >  NsmSeat_NotSet              )
-     && (enSeatId           <  NsmSeat_Last                ))
+  g_mutex_lock(NSM__pSessionMutex);
+  pSessionListEntry = g_slist_find_custom(NSM__pSessions, &stSearchSession, &NSM__i32SessionOwnerCompare);
+
+  if(pSessionListEntry != NULL)
   {
-    /* Initialize temporary session object to check if session already exists */
-    g_strlcpy((gchar*) stSession.sName,  sSessionName,  sizeof(stSession.sName) );
-    g_strlcpy((gchar*) stSession.sOwner, sSessionOwner, sizeof(stSession.sOwner));
-    stSession.enSeat  = enSeatId;
-    stSession.enState = enSessionState;
+    /* Found at least one session. */
+    do
+    {
+      /* Get the session object for the list entry */
+      pstExistingSession = (NsmSession_s*) pSessionListEntry->data;
+      pstExistingSession->enState = NsmSessionState_Unregistered;
+      NSM__vSnapshotSession(pstExistingSession);
 
-    enRetVal = NSM__enRegisterSession(&stSession, TRUE, TRUE);
+      /* Remember the session. D-Bus and StateMachine are informed, when the lock has been released */
+      pLostSessions = g_slist_append(pLostSessions, g_memdup(pstExistingSession, sizeof(NsmSession_s)));
+
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: A session has become invalid, because an application failed."),
+                                        DLT_STRING(" Application: "), DLT_STRING(pstExistingSession->sOwner           ),
+                                        DLT_STRING(" Session: "),     DLT_STRING(pstExistingSession->sName            ),
+                                        DLT_STRING(" Seat: "),        DLT_INT(   pstExistingSession->enSeat           ),
+                                        DLT_STRING(" State: "),       DLT_INT(   pstExistingSession->enState          ));
+
+      /* Remove or "reset" session */
+      if(NSM__boIsPlatformSession(pstExistingSession) == TRUE)
+      {
+        /* It is a default session. Don't remove it. Set owner to NSM again. */
+        g_strlcpy(pstExistingSession->sOwner, NSM_DEFAULT_SESSION_OWNER, sizeof(pstExistingSession->sOwner));
+      }
+      else
+      {
+        /* The session has been registered by a failed app. Remove it. */
+        NSM__pSessions = g_slist_remove(NSM__pSessions, pstExistingSession);
+        NSM__vFreeSessionObject(pstExistingSession);
+      }
+
+      /* Try to find the next session that had been registered for the app. */
+      pSessionListEntry = g_slist_find_custom(NSM__pSessions, &stSearchSession, &NSM__i32SessionOwnerCompare);
+
+    } while(pSessionListEntry != NULL);
   }
   else
   {
-    /* Error: A parameter with an invalid value has been passed */
-    enRetVal = NsmErrorStatus_Parameter;
-    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to register session. Invalid parameter."),
-                                       DLT_STRING("Name:"         ), DLT_STRING(sSessionName           ),
-                                       DLT_STRING("Owner:"        ), DLT_STRING(sSessionOwner          ),
-                                       DLT_STRING("Seat:"         ), DLT_INT((gint) enSeatId           ),
-                                       DLT_STRING("Initial state:"), DLT_INT((gint) enSessionState     ));
+    /* There have been no session registered for this application. */
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: There had been no registered sessions."    ),
+                                      DLT_STRING(" Application: "), DLT_STRING(pstFailedApp->sName));
   }
 
-  return enRetVal;
+  g_mutex_unlock(NSM__pSessionMutex);
+
+  /* Inform D-Bus and StateMachine that the sessions became invalid */
+  for(pLostListEntry = pLostSessions; pLostListEntry != NULL; pLostListEntry = g_slist_next(pLostListEntry))
+  {
+    NSM__vPublishSessionChange((NsmSession_s*) pLostListEntry->data, TRUE, TRUE);
+  }
+
+  g_slist_free_full(pLostSessions, &g_free);
 }
 
 
 /**********************************************************************************************************************
 *
-* The callback is called when a session should be unregistered.
-* It checks the passed parameters and creates a NsmSession_s structure of them.
-* If everything is ok, the new session will be removed and the system and StateMachine will be informed.
+* The helper function is called by 'NSM__boOnHandleSetAppHealthStatus', when an application failed.
 *
-* @param sSessionName:  Name of the new session that should be unregistered.
-* @param sSessionOwner: Current owner of the session that should be unregistered.
-* @param enSeat:        Seat for which the session should be unregistered.
-* @param penRetVal:     Pointer, where to store the return value
+* @param pstFailedApp: Pointer to structure with information about the failed application.
+*
+* @return always "NsmErrorStatus_Ok"
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enOnHandleUnRegisterSession(const gchar     *sSessionName,
-                                                         const gchar     *sSessionOwner,
-                                                         const NsmSeat_e  enSeatId)
+static NsmErrorStatus_e NSM__enSetAppStateFailed(NSM__tstFailedApplication* pstFailedApp)
 {
-  /* Function local variables                                                                   */
-  glong             u32SessionNameLen  = 0;                   /* Length of passed session owner */
-  glong             u32SessionOwnerLen = 0;                   /* Length of passed session name  */
-  NsmSession_s      stSearchSession    = {0};                 /* To search for existing session */
-  NsmErrorStatus_e  enRetVal           = NsmErrorStatus_NotSet;
+  /* Function local variables                                                                            */
+  GSList                    *pFailedAppListEntry   = NULL;                  /* List entry of application */
+  NsmErrorStatus_e           enRetVal              = NsmErrorStatus_NotSet; /* Return value              */
+  NSM__tstFailedApplication *pstFailedApplication  = NULL;
 
-  /* Check if the passed parameters are valid */
-  u32SessionNameLen  = g_utf8_strlen(sSessionName,  -1);
-  u32SessionOwnerLen = g_utf8_strlen(sSessionOwner, -1);
+  g_mutex_lock(NSM__pFailedApplicationsMutex);
 
-  if(   (u32SessionNameLen   < NSM_MAX_SESSION_NAME_LENGTH )
-     && (u32SessionOwnerLen  < NSM_MAX_SESSION_OWNER_LENGTH))
+  /* An application failed. Check if the application already is known as 'failed'. */
+  pFailedAppListEntry = g_slist_find_custom(NSM__pFailedApplications, pstFailedApp, &NSM__i32ApplicationCompare);
+
+  if(pFailedAppListEntry == NULL)
   {
-    /* Assign seat, session name and owner to search for session */
-    stSearchSession.enSeat = enSeatId;
-    g_strlcpy((gchar*) stSearchSession.sName,  sSessionName,  sizeof(stSearchSession.sName) );
-    g_strlcpy((gchar*) stSearchSession.sOwner, sSessionOwner, sizeof(stSearchSession.sOwner));
+    /* The application is not on the list yet. Create it. */
+    enRetVal = NsmErrorStatus_Ok;
 
-    enRetVal = NSM__enUnRegisterSession(&stSearchSession, TRUE, TRUE);
+    pstFailedApplication  = g_new(NSM__tstFailedApplication, 1);
+    g_strlcpy(pstFailedApplication->sName, pstFailedApp->sName, sizeof(pstFailedApplication->sName));
+    NSM__pFailedApplications = g_slist_append(NSM__pFailedApplications, pstFailedApplication);
+    NSM__vSnapshotFailedApp(pstFailedApplication, TRUE);
   }
   else
   {
-    /* Error: Invalid parameter. The session or owner name is to long. */
-    enRetVal = NsmErrorStatus_Parameter;
-    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to unregister session. The session or owner name is to long."),
-                                       DLT_STRING(" Name: "      ), DLT_STRING(sSessionName                                 ),
-                                       DLT_STRING(" Owner: "     ), DLT_STRING(sSessionOwner                                ),
-                                       DLT_STRING(" Seat: "      ), DLT_INT((gint) enSeatId                                 ));
+    /* Warning: The application is already in the list of failed session. */
+    enRetVal = NsmErrorStatus_Ok;
+    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: The application has already been marked as 'failed'."),
+                                      DLT_STRING(" Application: "), DLT_STRING(pstFailedApp->sName          ));
+  }
+
+  g_mutex_unlock(NSM__pFailedApplicationsMutex);
+
+  /* Disable all session that have been registered by the application. Done without the lock of the failed apps,
+   * because D-Bus and StateMachine are informed about the sessions. The StateMachine learns about the failure first.
+   */
+  if(pstFailedApplication != NULL)
+  {
+    NSM__vInformMachineAppHealth(pstFailedApp->sName, FALSE);
+    NSM__vDisableSessionsForApp(pstFailedApp);
   }
 
   return enRetVal;
@@ -1737,93 +4610,51 @@ static NsmErrorStatus_e NSM__enOnHandleUnRegisterSession(const gchar     *sSessi
 
 /**********************************************************************************************************************
 *
-* The callback is called when a lifecycle client should be registered.
-* In the list of lifecycle clients it will be checked if the client already exists.
-* If it exists, it's settings will be updated. Otherwise a new client will be created.
+* The function is called when an application has become invalid or valid again.
+* If an application became inactive, it will be added to the list of failed applications
+* and signals for the session registered by the application will be emitted.
+* If an application became valid again, it will only be removed from the list of failed sessions.
 *
-* @param sBusName:        Bus name of the remote application that hosts the lifecycle client interface
-* @param sObjName:        Object name of the lifecycle client
-* @param u32ShutdownMode: Shutdown mode for which the client wants to be informed
-* @param u32TimeoutMs:    Timeout in ms. If the client does not return after the specified time, the NSM
-*                         aborts its shutdown and calls the next client.
-* @param penRetVal:       Pointer, where to store the return value
+* @param sAppName:   Application which changed its state.
+* @param boAppState: Indicates if the application became invalid or valid again.
+* @param penRetVal:  Pointer where to store the return value
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enOnHandleRegisterLifecycleClient(const gchar *sBusName,
-                                                               const gchar *sObjName,
-                                                               const guint  u32ShutdownMode,
-                                                               const guint  u32TimeoutMs)
+static NsmErrorStatus_e NSM__enOnHandleSetAppHealthStatus(const gchar    *sAppName,
+                                                          const gboolean  boAppState)
 {
-  NSM__tstLifecycleClient     stTestLifecycleClient = {0};
-  NSM__tstLifecycleClient    *pstNewClient          = NULL;
-  NSM__tstLifecycleClient    *pstExistingClient     = NULL;
-  GList                      *pListEntry            = NULL;
-  NSMA_tLcConsumerHandle     *hConsumer             = NULL;
-  GError                     *pError                = NULL;
-  NsmErrorStatus_e            enRetVal              = NsmErrorStatus_NotSet;
-
-  /* The parameters are valid. Create a temporary client to search the list */
-  stTestLifecycleClient.sBusName = (gchar*) sBusName;
-  stTestLifecycleClient.sObjName = (gchar*) sObjName;
-
-  /* Check if the lifecycle client already is registered */
-  pListEntry = g_list_find_custom(NSM__pLifecycleClients, &stTestLifecycleClient, &NSM__i32LifecycleClientCompare);
-
-  if(pListEntry == NULL)
-  {
-    /* The client does not exist. Try to create a new proxy */
-    hConsumer = NSMA_hCreateLcConsumer(sBusName, sObjName, u32TimeoutMs);
-
-    /* The new proxy could be created. Create and store new client */
-    if(hConsumer != NULL)
-    {
-      enRetVal = NsmErrorStatus_Ok;
-
-      /* Create client object and copies of the strings. */
-      pstNewClient = g_new0(NSM__tstLifecycleClient, 1);
-      pstNewClient->u32RegisteredMode = u32ShutdownMode;
-      pstNewClient->sBusName          = g_strdup(sBusName);
-      pstNewClient->sObjName          = g_strdup(sObjName);
-      pstNewClient->boShutdown        = FALSE;
-      pstNewClient->hClient           = hConsumer;
+  /* Function local variables                                                                     */
+  NSM__tstFailedApplication stSearchApplication = {0}; /* Temporary application object for search */
+  NsmErrorStatus_e          enRetVal            = NsmErrorStatus_NotSet;
 
+  /* Check if passed parameters are valid */
+  if(strlen(sAppName) < NSM_MAX_SESSION_OWNER_LENGTH)
+  {
+    /* The application name is valid. Copy it for further checks. */
+    g_strlcpy((gchar*) stSearchApplication.sName, sAppName, sizeof(stSearchApplication.sName));
 
-      /* Append the new client to the list */
-      NSM__pLifecycleClients = g_list_append(NSM__pLifecycleClients, pstNewClient);
+    if(boAppState == TRUE)
+    {
+      enRetVal = NSM__enSetAppStateValid(&stSearchApplication);
 
-      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Registered new lifecycle consumer."                 ),
-                                        DLT_STRING(" Bus name: "), DLT_STRING(pstNewClient->sBusName         ),
-                                        DLT_STRING(" Obj name: "), DLT_STRING(pstNewClient->sObjName         ),
-                                        DLT_STRING(" Timeout: " ), DLT_UINT(  u32TimeoutMs                   ),
-                                        DLT_STRING(" Mode(s): "),  DLT_INT(   pstNewClient->u32RegisteredMode),
-                                        DLT_STRING(" Client: "),   DLT_UINT((guint) pstNewClient->hClient    ));
+      if(enRetVal == NsmErrorStatus_Ok)
+      {
+        NSM__vInformMachineAppHealth(stSearchApplication.sName, TRUE);
+      }
     }
     else
     {
-      enRetVal = NsmErrorStatus_Dbus;
-      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Failed to register new lifecycle consumer. D-Bus error."),
-                                        DLT_STRING(" Bus name: "),           DLT_STRING(sBusName                 ),
-                                        DLT_STRING(" Obj name: "),           DLT_STRING(sObjName                 ),
-                                        DLT_STRING(" Timeout: " ),           DLT_UINT(  u32TimeoutMs             ),
-                                        DLT_STRING(" Registered mode(s): "), DLT_INT(   u32ShutdownMode          ),
-                                        DLT_STRING(" Error: "),              DLT_STRING(pError->message          ));
-
-      g_error_free(pError);
+      enRetVal = NSM__enSetAppStateFailed(&stSearchApplication);
     }
   }
   else
   {
-    /* The client already exists. Assert to update the values for timeout and mode */
-    enRetVal = NsmErrorStatus_Ok;
-    pstExistingClient = (NSM__tstLifecycleClient*) pListEntry->data;
-    pstExistingClient->u32RegisteredMode |= u32ShutdownMode;
-    NSMA_boSetLcClientTimeout(pstExistingClient->hClient, u32TimeoutMs);
+    /* Error: The passed application name is too long. */
+    enRetVal = NsmErrorStatus_Parameter;
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to set application health status. The application name is too long."),
+                                       DLT_STRING(" Owner: "     ), DLT_STRING(sAppName                                            ),
+                                       DLT_STRING(" State: "     ), DLT_INT(boAppState                                             ));
 
-    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Changed lifecycle consumer registration."                          ),
-                                      DLT_STRING(" Bus name: "),           DLT_STRING(pstExistingClient->sBusName         ),
-                                      DLT_STRING(" Obj name: "),           DLT_STRING(pstExistingClient->sObjName         ),
-                                      DLT_STRING(" Timeout: " ),           DLT_UINT(  u32TimeoutMs                        ),
-                                      DLT_STRING(" Registered mode(s): "), DLT_INT(   pstExistingClient->u32RegisteredMode));
   }
 
   return enRetVal;
@@ -1832,455 +4663,831 @@ static NsmErrorStatus_e NSM__enOnHandleRegisterLifecycleClient(const gchar *sBus
 
 /**********************************************************************************************************************
 *
-* The callback is called when a lifecycle client should be unregistered or a shutdown
-* mode should be removed. In the list of lifecycle clients will be checked if the client exists. If the
-* client is found, the registration for the passed shutdown modes will be removed. If the client finally
-* is not registered for any shutdown mode, its entry will be removed from the list.
+* The function returns the current AppHealthCount, which is stored in local variable.
 *
-* @param sBusName:        Bus name of the remote application that hosts the lifecycle client interface
-* @param sObjName:        Object name of the lifecycle client
-* @param u32ShutdownMode: Shutdown mode for which the client wants to unregister
-* @param penRetVal:       Pointer, where to store the return value
+* @param pu32AppHealthCount: Pointer where to store the AppHealthCount (number of failed applications).
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enOnHandleUnRegisterLifecycleClient(const gchar *sBusName,
-                                                                 const gchar *sObjName,
-                                                                 const guint  u32ShutdownMode)
+static guint NSM__u32OnHandleGetAppHealthCount(void)
 {
-  NSM__tstLifecycleClient *pstExistingClient = NULL;
-  NSM__tstLifecycleClient  stSearchClient    = {0};
-  GList                   *pListEntry        = NULL;
-  NsmErrorStatus_e         enRetVal          = NsmErrorStatus_NotSet;
+  guint u32AppHealthCount = 0;
 
-  stSearchClient.sBusName = (gchar*) sBusName;
-  stSearchClient.sObjName = (gchar*) sObjName;
+  /* The query is served from the D-Bus thread. Protect the list against concurrent changes of the core */
+  g_mutex_lock(NSM__pFailedApplicationsMutex);
+  u32AppHealthCount = g_slist_length(NSM__pFailedApplications);
+  g_mutex_unlock(NSM__pFailedApplicationsMutex);
 
-  /* Check if the lifecycle client already is registered */
-  pListEntry = g_list_find_custom(NSM__pLifecycleClients, &stSearchClient, &NSM__i32LifecycleClientCompare);
+  return u32AppHealthCount;
+}
 
-  /* Check if an existing client could be found */
-  if(pListEntry != NULL)
-  {
-    /* The client could be found in the list. Change the registered shutdown mode */
-    enRetVal = NsmErrorStatus_Ok;
-    pstExistingClient = (NSM__tstLifecycleClient*) pListEntry->data;
-    pstExistingClient->u32RegisteredMode &= ~(u32ShutdownMode);
 
-    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Unregistered lifecycle consumer for mode(s)."                ),
-                                      DLT_STRING(" Bus name: "),     DLT_STRING(pstExistingClient->sBusName         ),
-                                      DLT_STRING(" Obj name: "),     DLT_STRING(pstExistingClient->sObjName         ),
-                                      DLT_STRING(" New mode: "),     DLT_INT(   pstExistingClient->u32RegisteredMode),
-                                      DLT_STRING(" Client: "  ),     DLT_UINT((guint) pstExistingClient->hClient)   );
+/**********************************************************************************************************************
+*
+* The function returns the current interface version of the NodeStateManager.
+*
+* @param pu32InterfaceVersion: Pointer where to store the interface version.
+*
+**********************************************************************************************************************/
+static guint NSM__u32OnHandleGetInterfaceVersion(void)
+{
+  /* Return interface version to caller. */
+  return NSM_INTERFACE_VERSION;
+}
 
-    if(pstExistingClient->u32RegisteredMode == NSM_SHUTDOWNTYPE_NOT)
+
+/**********************************************************************************************************************
+*
+* The function is called cyclically and triggers the systemd wdog.
+*
+* @param pUserData: Pointer to optional user data
+*
+* @return Always TRUE to keep timer callback alive.
+*
+**********************************************************************************************************************/
+static gboolean NSM__boOnHandleTimerWdog(gpointer pUserData)
+{
+  (void) sd_notify(0, "WATCHDOG=1");
+  DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Triggered systemd WDOG."));
+
+  /* Write the snapshot back periodically, in case it is not on a tmpfs */
+  NSM__vSyncSnapshot();
+
+  return TRUE;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function checks if the NSM is observed by a systemd wdog and installs a timer if necessary.
+*
+**********************************************************************************************************************/
+static void NSM__vConfigureWdogTimer(void)
+{
+  const gchar *sWdogSec   = NULL;
+  guint        u32WdogSec = 0;
+
+  sWdogSec = g_getenv("WATCHDOG_USEC");
+
+  if(sWdogSec != NULL)
+  {
+    u32WdogSec = strtoul(sWdogSec, NULL, 10);
+
+    /* The min. valid value for systemd is 1 s => WATCHDOG_USEC at least needs to contain 1.000.000 us */
+    if(u32WdogSec >= 1000000)
     {
-      /* The client is not registered for at least one mode. Remove it from the list */
-      NSM__vFreeLifecycleClientObject(pstExistingClient);
-      NSM__pLifecycleClients = g_list_remove(NSM__pLifecycleClients, pstExistingClient);
+      /* Convert us timeout in ms and divide by two to trigger wdog every half timeout interval */
+      u32WdogSec /= 2000;
+      (void) g_timeout_add_full(G_PRIORITY_DEFAULT,
+                                u32WdogSec,
+                                &NSM__boOnHandleTimerWdog,
+                                NULL,
+                                NULL);
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Started wdog timer."            ),
+                                        DLT_STRING("Interval [ms]:"), DLT_UINT(u32WdogSec));
+    }
+    else
+    {
+      DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Error. Invalid wdog config."    ),
+                                         DLT_STRING("WATCHDOG_USEC:"), DLT_STRING(sWdogSec));
     }
   }
   else
   {
-    /* Warning: The client could not be found in the list of clients. */
-    enRetVal = NsmErrorStatus_Parameter;
-    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to unregister lifecycle consumer."),
-                                      DLT_STRING(" Bus name: "),             DLT_STRING(sBusName),
-                                      DLT_STRING(" Obj name: "),             DLT_STRING(sObjName),
-                                      DLT_STRING(" Unregistered mode(s): "), DLT_INT(   u32ShutdownMode));
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Daemon not observed by wdog"));
   }
-
-  return enRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is used to get the state of the passed session.
-* It checks the passed parameters and creates a NsmSession_s structure of them.
-* If everything is ok, the state of the session will be determined and written to penSessionState.
+* The function parses a value of the rate limit configuration. Only a decimal number without sign or trailing
+* characters is accepted.
 *
-* @param sSessionName:    Name  of the session whose state just be returned
-* @param sSessionName:    Owner of the session whose state just be returned
-* @param enSeatId:        Seat of the session
-* @param penSessionState: Pointer where to store the session state
-* @param penRetVal:       Pointer where to store the return value
+* @param sValue:    Value of the environment variable
+* @param pu32Value: Returns the parsed value
+*
+* @return TRUE: The value is a valid number. FALSE: The value is malformed or too large.
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enOnHandleGetSessionState(const gchar       *sSessionName,
-                                                       const NsmSeat_e    enSeatId,
-                                                       NsmSessionState_e *penSessionState)
+static gboolean NSM__boParseRateValue(const gchar *sValue, guint *pu32Value)
 {
-  /* Function local variables                                                                     */
-  NsmErrorStatus_e  enRetVal           = NsmErrorStatus_NotSet;
-  glong             u32SessionNameLen  = 0;                     /* Length of passed session owner */
-  NsmSession_s      stSearchSession    = {0};                   /* To search for existing session */
-
-  /* Check if the passed parameters are valid */
-  u32SessionNameLen = g_utf8_strlen(sSessionName, -1);
+  gboolean  boRetVal = FALSE;
+  gchar    *sEnd     = NULL;
+  guint64   u64Value = 0;
 
-  if(u32SessionNameLen < NSM_MAX_SESSION_OWNER_LENGTH)
+  if(g_ascii_isdigit(sValue[0]) == TRUE)
   {
-    /* Search for session with name, seat and owner. */
-    stSearchSession.enSeat = enSeatId;
-    g_strlcpy((gchar*) stSearchSession.sName,  sSessionName,  sizeof(stSearchSession.sName) );
+    errno    = 0;
+    u64Value = g_ascii_strtoull(sValue, &sEnd, 10);
 
-    enRetVal = NSM__enGetSessionState(&stSearchSession);
-    *penSessionState = stSearchSession.enState;
-  }
-  else
-  {
-    /* Error: Invalid parameter. The session or owner name is to long. */
-    enRetVal = NsmErrorStatus_Parameter;
-    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to get session state. The session name is to long."),
-                                       DLT_STRING(" Name: "      ), DLT_STRING(sSessionName                       ),
-                                       DLT_STRING(" Seat: "      ), DLT_INT((gint) enSeatId                       ));
+    if((errno == 0) && (*sEnd == '\0') && (u64Value <= (G_MAXUINT / 2)))
+    {
+      *pu32Value = (guint) u64Value;
+      boRetVal   = TRUE;
+    }
   }
 
-  return enRetVal;
+  return boRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function sets the state of a session to a passed value.
-* It checks the passed parameters and creates a NsmSession_s structure of them.
-* If everything is ok, the state of the session will be set accordingly.
-*
-* @param sSessionName:   Name of the session whose state just be set
-* @param sSessionOwner:  Owner of the session
-* @param enSeatId:       Seat of the session
-* @param enSessionState: New state of the session
-* @param penRetVal:      Pointer where to store the return value
+* The function configures the rate limit of D-Bus callers in the NSMA. The limit is disabled by default. It is enabled
+* via the environment variables NSM_RATE_LIMIT (calls/s, 0 disables the limit) and NSM_RATE_BURST (calls at once).
+* A malformed configuration is rejected and the limit stays disabled.
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enOnHandleSetSessionState(const gchar             *sSessionName,
-                                                       const gchar             *sSessionOwner,
-                                                       const NsmSeat_e          enSeatId,
-                                                       const NsmSessionState_e  enSessionState)
+static void NSM__vConfigureRateLimit(void)
 {
-  /* Function local variables                                                                       */
-  NsmErrorStatus_e enRetVal           = NsmErrorStatus_NotSet;
-  glong            u32SessionNameLen  = 0;            /* Length of passed session owner             */
-  glong            u32SessionOwnerLen = 0;            /* Length of passed session name              */
-  NsmSession_s     stSession          = {0};          /* Session object passed to internal function */
+  /* Function local variables                                   */
+  const gchar *sRateLimit   = NULL;
+  const gchar *sRateBurst   = NULL;
+  gboolean     boValid      = FALSE;  /* Configuration well formed */
+  guint        u32RateLimit = 0;
+  guint        u32RateBurst = 0;
 
-  /* Check if the passed parameters are valid */
-  u32SessionNameLen  = g_utf8_strlen(sSessionName,  -1);
-  u32SessionOwnerLen = g_utf8_strlen(sSessionOwner, -1);
+  sRateLimit = g_getenv("NSM_RATE_LIMIT");
+  sRateBurst = g_getenv("NSM_RATE_BURST");
 
-  if(   (u32SessionNameLen  < NSM_MAX_SESSION_NAME_LENGTH )
-     && (u32SessionOwnerLen < NSM_MAX_SESSION_OWNER_LENGTH))
+  if(sRateLimit != NULL)
   {
-    /* Build session object to pass it internally */
-    g_strlcpy((gchar*) stSession.sName,  sSessionName,  sizeof(stSession.sName) );
-    g_strlcpy((gchar*) stSession.sOwner, sSessionOwner, sizeof(stSession.sOwner));
+    boValid = NSM__boParseRateValue(sRateLimit, &u32RateLimit);
 
-    stSession.enSeat  = enSeatId;
-    stSession.enState = enSessionState;
+    /* Without configured burst, a caller may send the calls of two seconds at once */
+    if((boValid == TRUE) && (sRateBurst != NULL))
+    {
+      boValid = NSM__boParseRateValue(sRateBurst, &u32RateBurst);
+    }
+    else
+    {
+      u32RateBurst = 2 * u32RateLimit;
+    }
 
-    enRetVal = NSM__enSetSessionState(&stSession, TRUE, TRUE);
+    if((boValid == TRUE) && (NSMA_boSetRateLimit(u32RateLimit, u32RateBurst) == TRUE))
+    {
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Configured rate limit."),
+                                        DLT_STRING("Calls/s:"), DLT_UINT(u32RateLimit),
+                                        DLT_STRING("Burst:"  ), DLT_UINT(u32RateBurst));
+    }
+    else
+    {
+      DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Error. Invalid rate limit config. Rate limit disabled."),
+                                         DLT_STRING("NSM_RATE_LIMIT:"), DLT_STRING(sRateLimit),
+                                         DLT_STRING("NSM_RATE_BURST:"), DLT_STRING((sRateBurst != NULL) ? sRateBurst : "-"));
+    }
   }
   else
   {
-    /* Error: Invalid parameter. The session or owner name is to long. */
-    enRetVal = NsmErrorStatus_Parameter;
-    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to set session state. Invalid parameter."),
-                                       DLT_STRING(" Name: "      ), DLT_STRING(sSessionName             ),
-                                       DLT_STRING(" Owner: "     ), DLT_STRING(sSessionOwner            ),
-                                       DLT_STRING(" Seat: "      ), DLT_INT((gint) enSeatId             ));
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Rate limit disabled"));
   }
-
-  return enRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The helper function is called by 'NSM__boOnHandleSetAppHealthStatus', when an application became valid again.
-* It removes the application from the list of invalid apps.
-*
-* @param pstFailedApp: Pointer to structure with information about the failed application.
+* The function selects the NSMC. If the environment variable NSM_NSMC_PLUGIN is set, the shared object is loaded
+* and its NsmcPlugin_s is used. Otherwise, the functions of the NSMC linked to the NSM are used.
 *
-* @return NsmErrorStatus_Ok:           The application has been removed from the list of failed apps.
-*         NsmErrorStatus_WrongSession: The application has never been on the list of failed apps.
+* @return TRUE: NSMC selected. FALSE: The configured plugin could not be loaded.
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enSetAppStateValid(NSM__tstFailedApplication* pstFailedApp)
+static gboolean NSM__boLoadNsmc(void)
 {
-  /* Function local variables                                                                             */
-  GSList                    *pAppListEntry          = NULL;                  /* List entry of application */
-  NsmErrorStatus_e           enRetVal               = NsmErrorStatus_NotSet; /* Return value              */
-  NSM__tstFailedApplication *pstExistingApplication = NULL;
-
-  /* An application has become valid again. Check if it really was invalid before. */
-  pAppListEntry = g_slist_find_custom(NSM__pFailedApplications, pstFailedApp, &NSM__i32ApplicationCompare);
+  gboolean            boRetVal   = TRUE;
+  const gchar        *sPlugin    = NULL;
+  void               *pHandle    = NULL;
+  const NsmcPlugin_s *pstPlugin  = NULL;
+
+  /* Default: The linked NSMC. The asynchronous interface is a weak symbol and may be NULL */
+  NSM__stNsmc.u32PluginVersion      = NSMC_PLUGIN_VERSION;
+  NSM__stNsmc.sName                 = "linked";
+  NSM__stNsmc.pfInit                = &NsmcInit;
+  NSM__stNsmc.pfLucRequired         = &NsmcLucRequired;
+  NSM__stNsmc.pfSetData             = &NsmcSetData;
+  NSM__stNsmc.pfRequestNodeRestart  = &NsmcRequestNodeRestart;
+  NSM__stNsmc.pfGetInterfaceVersion = &NsmcGetInterfaceVersion;
+  NSM__stNsmc.pfInitAsync           = &NsmcInitAsync;
+
+  sPlugin = g_getenv("NSM_NSMC_PLUGIN");
+
+  if(sPlugin != NULL)
+  {
+    /* Bind the plugin to its own functions, even if the linked NSMC has functions with the same names */
+    pHandle   = dlopen(sPlugin, RTLD_NOW | RTLD_LOCAL | RTLD_DEEPBIND);
+    pstPlugin = (pHandle != NULL) ? (const NsmcPlugin_s*) dlsym(pHandle, NSMC_PLUGIN_SYMBOL) : NULL;
+
+    if(   (pstPlugin                        != NULL)
+       && ((pstPlugin->u32PluginVersion >> 24) == (NSMC_PLUGIN_VERSION >> 24))
+       && (pstPlugin->pfInit                != NULL)
+       && (pstPlugin->pfLucRequired         != NULL)
+       && (pstPlugin->pfSetData             != NULL)
+       && (pstPlugin->pfRequestNodeRestart  != NULL)
+       && (pstPlugin->pfGetInterfaceVersion != NULL)
+       && ((pstPlugin->pfGetInterfaceVersion() >> 24) == (NSMC_PLUGIN_INTERFACE_VERSION >> 24)))
+    {
+      /* The plugin is never unloaded. The NSMC may run threads until the NSM terminates */
+      NSM__stNsmc = *pstPlugin;
+    }
+    else
+    {
+      DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Error. Failed to load NSMC plugin."),
+                                         DLT_STRING("Plugin:"), DLT_STRING(sPlugin),
+                                         DLT_STRING("Error:"),  DLT_STRING((pstPlugin == NULL) ? dlerror() : "Invalid version or function"));
 
-  if(pAppListEntry != NULL)
-  {
-    /* We found at least one entry for the application. Remove it from the list */
-    enRetVal = NsmErrorStatus_Ok;
-    pstExistingApplication = (NSM__tstFailedApplication*) pAppListEntry->data;
-    NSM__pFailedApplications = g_slist_remove(NSM__pFailedApplications, pstExistingApplication);
-    NSM__vFreeFailedApplicationObject(pstExistingApplication);
+      if(pHandle != NULL)
+      {
+        (void) dlclose(pHandle);
+      }
 
-    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: An application has become valid again."    ),
-                                      DLT_STRING(" Application: "), DLT_STRING(pstFailedApp->sName));
+      boRetVal = FALSE;
+    }
   }
-  else
+
+  if(boRetVal == TRUE)
   {
-    /* Error: There was no session registered for the application that failed. */
-    enRetVal = NsmErrorStatus_Error;
-    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to set application valid. Application was never invalid."),
-                                      DLT_STRING(" Application: "), DLT_STRING(pstFailedApp->sName                     ));
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Using NSMC."),
+                                      DLT_STRING("Name:"),    DLT_STRING(NSM__stNsmc.sName),
+                                      DLT_STRING("Version:"), DLT_UINT(NSM__stNsmc.pfGetInterfaceVersion()));
   }
 
-  return enRetVal;
+  return boRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The helper function is called by 'NSM__enSetAppStateFailed', when an application failed.
-* It looks for sessions that have been registered by the app.
-*
-* @param pstFailedApp: Pointer to structure with information about the failed application.
+* The function offers the asynchronous interface to the NSMC, if the NSMC implements NsmcInitAsync. Then the NSM
+* pushes its events into a ring, instead of calling NsmcSetData and NsmcRequestNodeRestart. The commands of the NSMC
+* are drained in the main loop.
 *
 **********************************************************************************************************************/
-static void NSM__vDisableSessionsForApp(NSM__tstFailedApplication* pstFailedApp)
+static void NSM__vInitNsmcAsync(void)
 {
-  /* Function local variables */
-  GSList       *pSessionListEntry  = NULL;
-  NsmSession_s *pstExistingSession = NULL;
-  NsmSession_s  stSearchSession    = {0};
+  NsmcQueue_s *pstEvents       = NULL;
+  NsmcQueue_s *pstCommands     = NULL;
+  GIOChannel  *pCommandChannel = NULL;
 
-  /* Only set the "owner" of the session (to the AppName) to search for all sessions of the app. */
-  g_strlcpy(stSearchSession.sOwner, pstFailedApp->sName, sizeof(stSearchSession.sOwner));
+  if(NSM__stNsmc.pfInitAsync != NULL)
+  {
+    pstEvents   = g_new0(NsmcQueue_s, 1);
+    pstCommands = g_new0(NsmcQueue_s, 1);
 
-  g_mutex_lock(NSM__pSessionMutex);
-  pSessionListEntry = g_slist_find_custom(NSM__pSessions, &stSearchSession, &NSM__i32SessionOwnerCompare);
+    pstEvents->i32EventFd   = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    pstCommands->i32EventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
 
-  if(pSessionListEntry != NULL)
-  {
-    /* Found at least one session. */
-    do
+    if(   (pstEvents->i32EventFd   >= 0)
+       && (pstCommands->i32EventFd >= 0)
+       && (NSM__stNsmc.pfInitAsync(pstEvents, pstCommands) == 0x01))
     {
-      /* Get the session object for the list entry */
-      pstExistingSession = (NsmSession_s*) pSessionListEntry->data;
-      pstExistingSession->enState = NsmSessionState_Unregistered;
+      /* The rings stay valid until the NSM terminates, because the NSMC may still access them */
+      NSM__pstNsmcEvents   = pstEvents;
+      NSM__pstNsmcCommands = pstCommands;
 
-      /* Inform D-Bus and StateMachine that a session became invalid */
-      NSM__vPublishSessionChange(pstExistingSession, TRUE, TRUE);
+      pCommandChannel = g_io_channel_unix_new(pstCommands->i32EventFd);
+      (void) g_io_add_watch(pCommandChannel, G_IO_IN, &NSM__boOnNsmcCommand, NULL);
+      g_io_channel_unref(pCommandChannel);
 
-      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: A session has become invalid, because an application failed."),
-                                        DLT_STRING(" Application: "), DLT_STRING(pstExistingSession->sOwner           ),
-                                        DLT_STRING(" Session: "),     DLT_STRING(pstExistingSession->sName            ),
-                                        DLT_STRING(" Seat: "),        DLT_INT(   pstExistingSession->enSeat           ),
-                                        DLT_STRING(" State: "),       DLT_INT(   pstExistingSession->enState          ));
-
-      /* Remove or "reset" session */
-      if(NSM__boIsPlatformSession(pstExistingSession) == TRUE)
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: NSMC uses asynchronous interface."),
+                                        DLT_STRING("Ring size:"), DLT_UINT(NSMC_QUEUE_SIZE));
+    }
+    else
+    {
+      if(pstEvents->i32EventFd >= 0)
       {
-        /* It is a default session. Don't remove it. Set owner to NSM again. */
-        g_strlcpy(pstExistingSession->sOwner, NSM_DEFAULT_SESSION_OWNER, sizeof(pstExistingSession->sOwner));
+        (void) close(pstEvents->i32EventFd);
       }
-      else
+
+      if(pstCommands->i32EventFd >= 0)
       {
-        /* The session has been registered by a failed app. Remove it. */
-        NSM__pSessions = g_slist_remove(NSM__pSessions, pstExistingSession);
-        NSM__vFreeSessionObject(pstExistingSession);
+        (void) close(pstCommands->i32EventFd);
       }
 
-      /* Try to find the next session that had been registered for the app. */
-      pSessionListEntry = g_slist_find_custom(NSM__pSessions, &stSearchSession, &NSM__i32SessionOwnerCompare);
+      g_free(pstEvents);
+      g_free(pstCommands);
 
-    } while(pSessionListEntry != NULL);
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: NSMC uses synchronous interface."));
+    }
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function informs the NSMC about changed data. If the NSMC subscribed for the data type, only the matching
+* subscriptions are called. If the NSMC uses the asynchronous interface, the data is pushed into the event ring and the function
+* returns at once. Otherwise, NsmcSetData is called.
+*
+* PLEASE NOTE: The function must not be called with a locked mutex of the NSM, because the NSMC may take its time.
+*
+* @param enData:         Type of the data
+* @param pData:          Pointer to the data
+* @param u32DataLen:     Length of the data
+* @param enOldNodeState: NsmDataType_NodeState: NodeState before the change, read under the lock. Otherwise NotSet.
+*
+* @return NsmErrorStatus_Ok:    NSMC informed or event queued.
+*         NsmErrorStatus_Error: Event ring full. The event has been dropped.
+*         Any other value:      Return value of NsmcSetData
+*
+**********************************************************************************************************************/
+static NsmErrorStatus_e NSM__enInformMachine(NsmDataType_e  enData,
+                                             const void    *pData,
+                                             guint          u32DataLen,
+                                             NsmNodeState_e enOldNodeState)
+{
+  NsmErrorStatus_e enRetVal   = NsmErrorStatus_NotSet;
+  NsmcMessage_s    stEvent;
+  guint            u32Dropped = 0;
+
+  if(NSM__boDispatchSubscriptions(enData, pData, u32DataLen, enOldNodeState) == TRUE)
+  {
+    /* The change matched subscriptions. They have been called */
+    enRetVal = NsmErrorStatus_Ok;
+  }
+  else if(NSM__pstNsmcEvents != NULL)
+  {
+    if(u32DataLen <= sizeof(stEvent.unData))
+    {
+      memset(&stEvent, 0, sizeof(stEvent));
+      stEvent.enType     = NsmcMessageType_SetData;
+      stEvent.enData     = enData;
+      stEvent.u32DataLen = u32DataLen;
+      memcpy(stEvent.unData.au8Data, pData, u32DataLen);
+
+      /* The ring has a single producer. Serialize threads that change data of the NSM */
+      g_mutex_lock(NSM__pNsmcEventMutex);
+      enRetVal   = (NsmcQueuePush(NSM__pstNsmcEvents, &stEvent) == 1) ? NsmErrorStatus_Ok : NsmErrorStatus_Error;
+      u32Dropped = NSM__pstNsmcEvents->u32Dropped;
+      g_mutex_unlock(NSM__pNsmcEventMutex);
+
+      if(enRetVal != NsmErrorStatus_Ok)
+      {
+        DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: NSMC event ring full. Dropped event."),
+                                          DLT_STRING("Data:"),    DLT_INT((gint) enData),
+                                          DLT_STRING("Dropped:"), DLT_UINT(u32Dropped  ));
+      }
+    }
+    else
+    {
+      enRetVal = NsmErrorStatus_Parameter;
+    }
   }
   else
   {
-    /* There have been no session registered for this application. */
-    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: There had been no registered sessions."    ),
-                                      DLT_STRING(" Application: "), DLT_STRING(pstFailedApp->sName));
+    enRetVal = NSM__stNsmc.pfSetData(enData, (unsigned char*) pData, u32DataLen);
   }
 
-  g_mutex_unlock(NSM__pSessionMutex);
+  return enRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The helper function is called by 'NSM__boOnHandleSetAppHealthStatus', when an application failed.
-*
-* @param pstFailedApp: Pointer to structure with information about the failed application.
+* The function informs the NSMC, that the health of an application changed. The NSMC can not set the health.
 *
-* @return always "NsmErrorStatus_Ok"
+* @param sAppName:  Name of the application
+* @param boRunning: TRUE: The application runs again. FALSE: The application failed.
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enSetAppStateFailed(NSM__tstFailedApplication* pstFailedApp)
+static void NSM__vInformMachineAppHealth(const gchar *sAppName, gboolean boRunning)
 {
-  /* Function local variables                                                                            */
-  GSList                    *pFailedAppListEntry   = NULL;                  /* List entry of application */
-  NsmErrorStatus_e           enRetVal              = NsmErrorStatus_NotSet; /* Return value              */
-  NSM__tstFailedApplication *pstFailedApplication  = NULL;
+  NsmAppHealth_s stAppHealth;
 
-  /* An application failed. Check if the application already is known as 'failed'. */
-  pFailedAppListEntry = g_slist_find_custom(NSM__pFailedApplications, pstFailedApp, &NSM__i32ApplicationCompare);
+  memset(&stAppHealth, 0, sizeof(stAppHealth));
+  g_strlcpy(stAppHealth.sAppName, sAppName, sizeof(stAppHealth.sAppName));
+  stAppHealth.u32Running = (boRunning == TRUE) ? 1 : 0;
 
-  if(pFailedAppListEntry == NULL)
-  {
-    /* The application is not on the list yet. Create it. */
-    enRetVal = NsmErrorStatus_Ok;
+  (void) NSM__enInformMachine(NsmDataType_AppHealth, &stAppHealth, sizeof(NsmAppHealth_s), NsmNodeState_NotSet);
+}
 
-    pstFailedApplication  = g_new(NSM__tstFailedApplication, 1);
-    g_strlcpy(pstFailedApplication->sName, pstFailedApp->sName, sizeof(pstFailedApplication->sName));
-    NSM__pFailedApplications = g_slist_append(NSM__pFailedApplications, pstFailedApplication);
 
-    /* Disable all session that have been registered by the application */
-    NSM__vDisableSessionsForApp(pstFailedApplication);
+/**********************************************************************************************************************
+*
+* The function passes a restart request to the NSMC. If the NSMC uses the asynchronous interface, the request is
+* pushed into the event ring. The NSMC answers an accepted request with a command.
+*
+* @param enRestartReason: Restart reason
+* @param u32RestartType:  Restart type
+*
+* @return TRUE: The NSMC accepted or queued the request. FALSE: The request has been rejected or dropped.
+*
+**********************************************************************************************************************/
+static gboolean NSM__boRequestMachineRestart(NsmRestartReason_e enRestartReason, guint u32RestartType)
+{
+  gboolean      boRetVal = FALSE;
+  NsmcMessage_s stEvent;
+
+  if(NSM__pstNsmcEvents != NULL)
+  {
+    memset(&stEvent, 0, sizeof(stEvent));
+    stEvent.enType                            = NsmcMessageType_RequestNodeRestart;
+    stEvent.unData.stRestart.enRestartReason  = enRestartReason;
+    stEvent.unData.stRestart.u32RestartType   = u32RestartType;
+
+    g_mutex_lock(NSM__pNsmcEventMutex);
+    boRetVal = (NsmcQueuePush(NSM__pstNsmcEvents, &stEvent) == 1) ? TRUE : FALSE;
+    g_mutex_unlock(NSM__pNsmcEventMutex);
   }
   else
   {
-    /* Warning: The application is already in the list of failed session. */
-    enRetVal = NsmErrorStatus_Ok;
-    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: The application has already been marked as 'failed'."),
-                                      DLT_STRING(" Application: "), DLT_STRING(pstFailedApp->sName          ));
+    boRetVal = (NSM__stNsmc.pfRequestNodeRestart(enRestartReason, u32RestartType) == 0x01) ? TRUE : FALSE;
   }
 
-  return enRetVal;
+  return boRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is called when an application has become invalid or valid again.
-* If an application became inactive, it will be added to the list of failed applications
-* and signals for the session registered by the application will be emitted.
-* If an application became valid again, it will only be removed from the list of failed sessions.
+* The callback is called in the main loop, when the NSMC pushed commands. The commands are handled like NsmSetData.
+* An accepted restart request sets the RestartReason, like the synchronous NsmcRequestNodeRestart returning 0x01.
 *
-* @param sAppName:   Application which changed its state.
-* @param boAppState: Indicates if the application became invalid or valid again.
-* @param penRetVal:  Pointer where to store the return value
+* @param pChannel:    Channel of the eventfd of the command ring
+* @param enCondition: G_IO_IN
+* @param pUserData:   Not used
+*
+* @return TRUE: Keep the watch
 *
 **********************************************************************************************************************/
-static NsmErrorStatus_e NSM__enOnHandleSetAppHealthStatus(const gchar    *sAppName,
-                                                          const gboolean  boAppState)
+static gboolean NSM__boOnNsmcCommand(GIOChannel *pChannel, GIOCondition enCondition, gpointer pUserData)
 {
-  /* Function local variables                                                                     */
-  NSM__tstFailedApplication stSearchApplication = {0}; /* Temporary application object for search */
-  NsmErrorStatus_e          enRetVal            = NsmErrorStatus_NotSet;
+  NsmcMessage_s    stCommand;
+  NsmErrorStatus_e enRetVal   = NsmErrorStatus_NotSet;
+  guint            u32Dropped = 0;
 
-  /* Check if passed parameters are valid */
-  if(strlen(sAppName) < NSM_MAX_SESSION_OWNER_LENGTH)
-  {
-    /* The application name is valid. Copy it for further checks. */
-    g_strlcpy((gchar*) stSearchApplication.sName, sAppName, sizeof(stSearchApplication.sName));
+  /* Reset the eventfd before draining. A command pushed meanwhile signals the eventfd again */
+  NsmcQueueAcknowledge(NSM__pstNsmcCommands);
 
-    if(boAppState == TRUE)
+  while(NsmcQueuePop(NSM__pstNsmcCommands, &stCommand) == 1)
+  {
+    if(stCommand.enType == NsmcMessageType_SetData)
     {
-      enRetVal = NSM__enSetAppStateValid(&stSearchApplication);
+      enRetVal = NsmSetData(stCommand.enData, stCommand.unData.au8Data, stCommand.u32DataLen);
+    }
+    else if(   (stCommand.enType                           == NsmcMessageType_RequestNodeRestart)
+            && (stCommand.unData.stRestart.enRestartReason >  NsmRestartReason_NotSet            )
+            && (stCommand.unData.stRestart.enRestartReason <  NsmRestartReason_Last              )
+            && (NSMA_boSetRestartReason(stCommand.unData.stRestart.enRestartReason) == TRUE))
+    {
+      NSM__vUpdateStatePage();
+      enRetVal = NsmErrorStatus_Ok;
     }
     else
     {
-      enRetVal = NSM__enSetAppStateFailed(&stSearchApplication);
+      enRetVal = NsmErrorStatus_Parameter;
+    }
+
+    if(enRetVal != NsmErrorStatus_Ok)
+    {
+      DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to handle NSMC command."),
+                                        DLT_STRING("Type:"),   DLT_INT((gint) stCommand.enType),
+                                        DLT_STRING("Data:"),   DLT_INT((gint) stCommand.enData),
+                                        DLT_STRING("Return:"), DLT_INT((gint) enRetVal        ));
     }
   }
-  else
-  {
-    /* Error: The passed application name is too long. */
-    enRetVal = NsmErrorStatus_Parameter;
-    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to set application health status. The application name is too long."),
-                                       DLT_STRING(" Owner: "     ), DLT_STRING(sAppName                                            ),
-                                       DLT_STRING(" State: "     ), DLT_INT(boAppState                                             ));
 
+  u32Dropped = g_atomic_int_get((gint*) &NSM__pstNsmcCommands->u32Dropped);
+
+  if(u32Dropped != NSM__u32NsmcCommandsDropped)
+  {
+    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: NSMC command ring was full. Commands dropped."),
+                                      DLT_STRING("Dropped:"), DLT_UINT(u32Dropped - NSM__u32NsmcCommandsDropped));
+    NSM__u32NsmcCommandsDropped = u32Dropped;
   }
 
-  return enRetVal;
+  return TRUE;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function returns the current AppHealthCount, which is stored in local variable.
+* The function compiles the filters of all subscriptions into the masks, which are checked before a subscription is
+* looked at. A session name is represented by one bit (hash % 64). Different names may share a bit. Then the exact
+* filter of the subscriptions decides.
 *
-* @param pu32AppHealthCount: Pointer where to store the AppHealthCount (number of failed applications).
+* PLEASE NOTE: The function has to be called with a locked NSM__pSubscriptionMutex.
 *
 **********************************************************************************************************************/
-static guint NSM__u32OnHandleGetAppHealthCount(void)
+static void NSM__vCompileSubscriptionFilter(void)
 {
-  return g_slist_length(NSM__pFailedApplications);
+  guint                 u32SubscriptionIdx = 0;
+  guint                 u32SubscribedTypes = 0;
+  NsmNodeState_e        enOldNodeState     = NsmNodeState_NotSet;
+  NSM__tstSubscription *pstSubscription    = NULL;
+
+  NSM__u32DataCallbackTypes    = 0;
+  NSM__u64SessionNameFilter    = 0;
+  NSM__boAllSessionsSubscribed = FALSE;
+  NSM__u32SubscribedSeats      = 0;
+  memset(NSM__au32SubscribedTransitions, 0, sizeof(NSM__au32SubscribedTransitions));
+
+  for(u32SubscriptionIdx = 0; u32SubscriptionIdx < NSM_MAX_SUBSCRIPTIONS; u32SubscriptionIdx++)
+  {
+    pstSubscription = &NSM__astSubscriptions[u32SubscriptionIdx];
+
+    if(pstSubscription->boUsed == TRUE)
+    {
+      if(pstSubscription->stSubscription.pfDataCallback != NULL)
+      {
+        NSM__u32DataCallbackTypes |= pstSubscription->stSubscription.u32DataMask;
+      }
+
+      if(pstSubscription->stSubscription.pfNodeStateCallback != NULL)
+      {
+        u32SubscribedTypes |= NSM_DATATYPE_MASK(NsmDataType_NodeState);
+
+        for(enOldNodeState = NsmNodeState_NotSet; enOldNodeState < NsmNodeState_Last; enOldNodeState++)
+        {
+          if((pstSubscription->stSubscription.u32FromNodeStateMask & NSM_NODESTATE_MASK(enOldNodeState)) != 0)
+          {
+            NSM__au32SubscribedTransitions[enOldNodeState] |= pstSubscription->stSubscription.u32ToNodeStateMask;
+          }
+        }
+      }
+
+      if(pstSubscription->stSubscription.pfSessionCallback != NULL)
+      {
+        u32SubscribedTypes |= NSM_DATATYPE_MASK(NsmDataType_SessionState);
+        NSM__u32SubscribedSeats |= pstSubscription->stSubscription.u32SeatMask;
+
+        if(pstSubscription->u32SessionHash == 0)
+        {
+          NSM__boAllSessionsSubscribed = TRUE;
+        }
+        else
+        {
+          NSM__u64SessionNameFilter |= G_GUINT64_CONSTANT(1) << (pstSubscription->u32SessionHash % 64);
+        }
+      }
+    }
+  }
+
+  /* The mask is read without lock. Publish it once */
+  g_atomic_int_set((gint*) &NSM__u32SubscribedTypes, (gint) (u32SubscribedTypes | NSM__u32DataCallbackTypes));
 }
 
 
 /**********************************************************************************************************************
 *
-* The function returns the current interface version of the NodeStateManager.
+* The function passes changed data to the matching subscriptions. The compiled masks are checked first. Only if they
+* match, the subscriptions are looked at. The callbacks are called after the lock has been released, so that they
+* can subscribe or unsubscribe. Once the NSMC subscribed for a data type, it only receives the changes of the type
+* that match a subscription. The other changes of the type are dropped.
 *
-* @param pu32InterfaceVersion: Pointer where to store the interface version.
+* @param enData:         Type of the data
+* @param pData:          Pointer to the data
+* @param u32DataLen:     Length of the data
+* @param enOldNodeState: NsmDataType_NodeState: NodeState before the change. Otherwise NotSet.
+*
+* @return TRUE:  The data type is subscribed. The matching subscriptions (if any) have been called. The NSMC must
+*                not be informed via NsmcSetData.
+*         FALSE: The data type is not subscribed. The NSMC is informed via NsmcSetData.
 *
 **********************************************************************************************************************/
-static guint NSM__u32OnHandleGetInterfaceVersion(void)
+static gboolean NSM__boDispatchSubscriptions(NsmDataType_e  enData,
+                                             const void    *pData,
+                                             guint          u32DataLen,
+                                             NsmNodeState_e enOldNodeState)
 {
-  /* Return interface version to caller. */
-  return NSM_INTERFACE_VERSION;
+  gboolean                    boRetVal           = FALSE;
+  gboolean                    boFilterMatch      = FALSE;
+  guint                       u32SubscriptionIdx = 0;
+  guint                       u32Calls           = 0;
+  guint                       u32SessionHash     = 0;
+  NsmNodeState_e              enNewNodeState     = NsmNodeState_NotSet;
+  const NsmSession_s         *pstSession         = NULL;
+  const NSM__tstSubscription *pstSubscription    = NULL;
+  NSM__tstSubscriptionCall    astCalls[NSM_MAX_SUBSCRIPTIONS]; /* Callbacks to call after unlock */
+
+  /* Without a subscription for the type, the NSM does not need the lock */
+  if((g_atomic_int_get((gint*) &NSM__u32SubscribedTypes) & NSM_DATATYPE_MASK(enData)) != 0)
+  {
+    boRetVal = TRUE;
+
+    memset(astCalls, 0, sizeof(astCalls));
+
+    if((enData == NsmDataType_NodeState) && (u32DataLen == sizeof(NsmNodeState_e)))
+    {
+      enNewNodeState = *((const NsmNodeState_e*) pData);
+    }
+    else if((enData == NsmDataType_SessionState) && (u32DataLen == sizeof(NsmSession_s)))
+    {
+      pstSession     = (const NsmSession_s*) pData;
+      u32SessionHash = g_str_hash(pstSession->sName);
+    }
+
+    g_mutex_lock(NSM__pSubscriptionMutex);
+
+    /* Check the compiled masks, before the subscriptions are looked at */
+    boFilterMatch =    ((NSM__u32DataCallbackTypes & NSM_DATATYPE_MASK(enData)) != 0)
+                    || (   (enNewNodeState != NsmNodeState_NotSet)
+                        && (enOldNodeState < NsmNodeState_Last)
+                        && ((NSM__au32SubscribedTransitions[enOldNodeState] & NSM_NODESTATE_MASK(enNewNodeState)) != 0))
+                    || (   (pstSession != NULL)
+                        && ((NSM__u32SubscribedSeats & NSM_SEAT_MASK(pstSession->enSeat)) != 0)
+                        && (   (NSM__boAllSessionsSubscribed == TRUE)
+                            || ((NSM__u64SessionNameFilter & (G_GUINT64_CONSTANT(1) << (u32SessionHash % 64))) != 0)));
+
+    for(u32SubscriptionIdx = 0; (boFilterMatch == TRUE) && (u32SubscriptionIdx < NSM_MAX_SUBSCRIPTIONS); u32SubscriptionIdx++)
+    {
+      pstSubscription = &NSM__astSubscriptions[u32SubscriptionIdx];
+
+      if(pstSubscription->boUsed == TRUE)
+      {
+        if((pstSubscription->stSubscription.u32DataMask & NSM_DATATYPE_MASK(enData)) != 0)
+        {
+          astCalls[u32Calls].pfDataCallback = pstSubscription->stSubscription.pfDataCallback;
+        }
+
+        if(   (enNewNodeState != NsmNodeState_NotSet)
+           && ((pstSubscription->stSubscription.u32FromNodeStateMask & NSM_NODESTATE_MASK(enOldNodeState)) != 0)
+           && ((pstSubscription->stSubscription.u32ToNodeStateMask   & NSM_NODESTATE_MASK(enNewNodeState)) != 0))
+        {
+          astCalls[u32Calls].pfNodeStateCallback = pstSubscription->stSubscription.pfNodeStateCallback;
+        }
+
+        /* The name is only compared, if the hash matches */
+        if(   (pstSession != NULL)
+           && ((pstSubscription->stSubscription.u32SeatMask & NSM_SEAT_MASK(pstSession->enSeat)) != 0)
+           && (   (pstSubscription->u32SessionHash == 0)
+               || (   (pstSubscription->u32SessionHash == u32SessionHash)
+                   && (g_strcmp0(pstSubscription->stSubscription.sSessionName, pstSession->sName) == 0))))
+        {
+          astCalls[u32Calls].pfSessionCallback = pstSubscription->stSubscription.pfSessionCallback;
+        }
+
+        if(   (astCalls[u32Calls].pfDataCallback      != NULL)
+           || (astCalls[u32Calls].pfNodeStateCallback != NULL)
+           || (astCalls[u32Calls].pfSessionCallback   != NULL))
+        {
+          astCalls[u32Calls].pUserData = pstSubscription->stSubscription.pUserData;
+          u32Calls++;
+        }
+      }
+    }
+
+    g_mutex_unlock(NSM__pSubscriptionMutex);
+
+    for(u32SubscriptionIdx = 0; u32SubscriptionIdx < u32Calls; u32SubscriptionIdx++)
+    {
+      if(astCalls[u32SubscriptionIdx].pfDataCallback != NULL)
+      {
+        astCalls[u32SubscriptionIdx].pfDataCallback(enData,
+                                                    (const unsigned char*) pData,
+                                                    u32DataLen,
+                                                    astCalls[u32SubscriptionIdx].pUserData);
+      }
+
+      if(astCalls[u32SubscriptionIdx].pfNodeStateCallback != NULL)
+      {
+        astCalls[u32SubscriptionIdx].pfNodeStateCallback(enOldNodeState,
+                                                         enNewNodeState,
+                                                         astCalls[u32SubscriptionIdx].pUserData);
+      }
+
+      if(astCalls[u32SubscriptionIdx].pfSessionCallback != NULL)
+      {
+        astCalls[u32SubscriptionIdx].pfSessionCallback(pstSession, astCalls[u32SubscriptionIdx].pUserData);
+      }
+    }
+  }
+
+  return boRetVal;
 }
 
 
 /**********************************************************************************************************************
 *
-* The function is called cyclically and triggers the systemd wdog.
-*
-* @param pUserData: Pointer to optional user data
-*
-* @return Always TRUE to keep timer callback alive.
+* The function maps the state page (NSM_STATE_PAGE_FILE) and publishes the initial values.
+* An existing file is not truncated. Like this, readers which mapped the page of a former instance see the update.
 *
 **********************************************************************************************************************/
-static gboolean NSM__boOnHandleTimerWdog(gpointer pUserData)
+static void NSM__vOpenStatePage(void)
 {
-  (void) sd_notify(0, "WATCHDOG=1");
-  DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Triggered systemd WDOG."));
+  gint     i32Fd = -1;
+  gpointer pMap  = MAP_FAILED;
+
+  i32Fd = open(NSM_STATE_PAGE_FILE, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+  if(i32Fd >= 0)
+  {
+    /* The page is read by all clients. Make sure that the umask did not restrict the access */
+    if(   (fchmod(i32Fd, 0644)                      == 0)
+       && (ftruncate(i32Fd, sizeof(NsmStatePage_s)) == 0))
+    {
+      pMap = mmap(NULL, sizeof(NsmStatePage_s), PROT_READ | PROT_WRITE, MAP_SHARED, i32Fd, 0);
+    }
+
+    (void) close(i32Fd);
+  }
+
+  if(pMap != MAP_FAILED)
+  {
+    NSM__pstStatePage = (NsmStatePage_s*) pMap;
 
-  return TRUE;
+    /* A former instance may have stopped while writing. Make the sequence even, before the first update */
+    if((NSM__pstStatePage->u32Sequence & 0x01) != 0)
+    {
+      g_atomic_int_inc((gint*) &NSM__pstStatePage->u32Sequence);
+    }
+
+    NSM__vUpdateStatePage();
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Mapped state page."), DLT_STRING(" File: "), DLT_STRING(NSM_STATE_PAGE_FILE));
+  }
+  else
+  {
+    DLT_LOG(NsmContext, DLT_LOG_WARN, DLT_STRING("NSM: Failed to map state page."),
+                                      DLT_STRING(" File: "),  DLT_STRING(NSM_STATE_PAGE_FILE),
+                                      DLT_STRING(" Error: "), DLT_STRING(g_strerror(errno)  ));
+  }
 }
 
 
 /**********************************************************************************************************************
 *
-* The function checks if the NSM is observed by a systemd wdog and installs a timer if necessary.
+* The function mirrors the current values and sessions into the state page.
+* The sequence is odd while the page is written. Afterwards, readers waiting on the sequence are woken up.
+* The ApplicationMode is "NotSet", until it has been prefetched. The function never waits for the PCL.
+* The function must not be called while the session or the ApplicationMode mutex is locked.
 *
 **********************************************************************************************************************/
-static void NSM__vConfigureWdogTimer(void)
+static void NSM__vUpdateStatePage(void)
 {
-  const gchar *sWdogSec   = NULL;
-  guint        u32WdogSec = 0;
+  GSList       *pListEntry = NULL;
+  NsmSession_s *pstSession = NULL;
+  guint         u32Count   = 0;
+  guint         u32Dropped = 0;
 
-  sWdogSec = g_getenv("WATCHDOG_USEC");
+  g_mutex_lock(NSM__pStatePageMutex);
 
-  if(sWdogSec != NULL)
+  if(NSM__pstStatePage != NULL)
   {
-    u32WdogSec = strtoul(sWdogSec, NULL, 10);
+    /* Start writing. The atomic increment is a full barrier */
+    g_atomic_int_inc((gint*) &NSM__pstStatePage->u32Sequence);
 
-    /* The min. valid value for systemd is 1 s => WATCHDOG_USEC at least needs to contain 1.000.000 us */
-    if(u32WdogSec >= 1000000)
-    {
-      /* Convert us timeout in ms and divide by two to trigger wdog every half timeout interval */
-      u32WdogSec /= 2000;
-      (void) g_timeout_add_full(G_PRIORITY_DEFAULT,
-                                u32WdogSec,
-                                &NSM__boOnHandleTimerWdog,
-                                NULL,
-                                NULL);
-      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Started wdog timer."            ),
-                                        DLT_STRING("Interval [ms]:"), DLT_UINT(u32WdogSec));
-    }
-    else
+    NSM__pstStatePage->u32Version           = NSM_STATE_PAGE_VERSION;
+    NSM__pstStatePage->stValues.enNodeState = (NsmNodeState_e) g_atomic_int_get((gint*) &NSM__enNodeState);
+
+    /* Don't wait for the prefetch. The persistence worker updates the page, when the ApplicationMode has been read */
+    NSM__pstStatePage->stValues.enApplicationMode = (g_atomic_int_get(&NSM__boThisApplicationModeRead) == TRUE)
+                                                  ? NSM__enThisApplicationMode
+                                                  : NsmApplicationMode_NotSet;
+
+    (void) NSMA_boGetBootMode       (&NSM__pstStatePage->stValues.i32BootMode      );
+    (void) NSMA_boGetRestartReason  (&NSM__pstStatePage->stValues.enRestartReason  );
+    (void) NSMA_boGetShutdownReason (&NSM__pstStatePage->stValues.enShutdownReason );
+    (void) NSMA_boGetRunningReason  (&NSM__pstStatePage->stValues.enWakeUpReason   );
+
+    g_mutex_lock(NSM__pSessionMutex);
+
+    for(pListEntry = NSM__pSessions; pListEntry != NULL; pListEntry = g_slist_next(pListEntry))
     {
-      DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Error. Invalid wdog config."    ),
-                                         DLT_STRING("WATCHDOG_USEC:"), DLT_STRING(sWdogSec));
+      pstSession = (NsmSession_s*) pListEntry->data;
+
+      if(u32Count < NSM_STATE_PAGE_MAX_SESSIONS)
+      {
+        g_strlcpy(NSM__pstStatePage->astSessions[u32Count].sName, pstSession->sName, NSM_MAX_SESSION_NAME_LENGTH);
+        NSM__pstStatePage->astSessions[u32Count].enSeat  = pstSession->enSeat;
+        NSM__pstStatePage->astSessions[u32Count].enState = pstSession->enState;
+        u32Count++;
+      }
+      else
+      {
+        u32Dropped++;
+      }
     }
+
+    g_mutex_unlock(NSM__pSessionMutex);
+
+    NSM__pstStatePage->u32SessionCount    = u32Count;
+    NSM__pstStatePage->u32SessionsDropped = u32Dropped;
+
+    /* Finish writing and wake up readers, which wait for a change */
+    g_atomic_int_inc((gint*) &NSM__pstStatePage->u32Sequence);
+    (void) syscall(SYS_futex, &NSM__pstStatePage->u32Sequence, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
   }
-  else
+
+  g_mutex_unlock(NSM__pStatePageMutex);
+}
+
+
+/**********************************************************************************************************************
+*
+* The function unmaps the state page.
+*
+**********************************************************************************************************************/
+static void NSM__vCloseStatePage(void)
+{
+  g_mutex_lock(NSM__pStatePageMutex);
+
+  if(NSM__pstStatePage != NULL)
   {
-    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Daemon not observed by wdog"));
+    (void) munmap(NSM__pstStatePage, sizeof(NsmStatePage_s));
+    NSM__pstStatePage = NULL;
   }
+
+  g_mutex_unlock(NSM__pStatePageMutex);
 }
 
 
@@ -2297,13 +5504,46 @@ static void  NSM__vInitializeVariables(void)
   NSM__pLifecycleClients       = NULL;
   NSM__pNodeStateMutex         = NULL;
   NSM__enNodeState             = NsmNodeState_NotSet;
+  NSM__enPreviousNodeState     = NsmNodeState_NotSet;
   NSM__pNextApplicationModeMutex = NULL;
   NSM__pThisApplicationModeMutex = NULL;
   NSM__pFailedApplications     = NULL;
-  NSM__pCurrentLifecycleClient = NULL;
+  NSM__u32PendingLifecycleRequests = 0;
+  NSM__enLifecycleSeat         = NsmSeat_NotSet;
+  NSM__u32SeatRequestType      = NSM_SHUTDOWNTYPE_NOT;
+  memset(NSM__aboSeatShutdown, 0, sizeof(NSM__aboSeatShutdown));
+  NSM__i64ResumeStartTime      = 0;
+  NSM__i64LucRunupStartTime    = 0;
   NSM__enNextApplicationMode   = NsmApplicationMode_NotSet;
   NSM__enThisApplicationMode   = NsmApplicationMode_NotSet;
   NSM__boThisApplicationModeRead = FALSE;
+  NSM__pPersistMutex           = NULL;
+  NSM__pPersistCond            = NULL;
+  NSM__pPersistThread          = NULL;
+  NSM__enPersistApplicationMode = NsmApplicationMode_NotSet;
+  NSM__boPersistPending        = FALSE;
+  NSM__boPersistBusy           = FALSE;
+  NSM__boPersistStop           = FALSE;
+  NSM__boPersistReady          = FALSE;
+  NSM__pStatePageMutex         = NULL;
+  NSM__pstStatePage            = NULL;
+  NSM__pstSnapshot             = NULL;
+  NSM__pstRestoreSnapshot      = NULL;
+  NSM__u32RestoreChecksPending = 0;
+  NSM__u32RestoreClients       = 0;
+  NSM__u32RestoreClientsGone   = 0;
+  NSM__enRestoreNodeState      = NsmNodeState_NotSet;
+  NSM__boReexecRequested       = FALSE;
+  NSM__boReexecStarted         = FALSE;
+  NSM__i32HandoverFd           = -1;
+  NSM__pstHandover             = NULL;
+  NSM__pNsmcEventMutex         = NULL;
+  NSM__pstNsmcEvents           = NULL;
+  NSM__pstNsmcCommands         = NULL;
+  NSM__u32NsmcCommandsDropped  = 0;
+  NSM__pSubscriptionMutex      = NULL;
+  memset(NSM__astSubscriptions, 0, sizeof(NSM__astSubscriptions));
+  NSM__vCompileSubscriptionFilter();
 }
 
 
@@ -2350,6 +5590,11 @@ static void NSM__vCreateMutexes(void)
   NSM__pThisApplicationModeMutex = g_mutex_new();
   NSM__pNextApplicationModeMutex = g_mutex_new();
   NSM__pSessionMutex         = g_mutex_new();
+  NSM__pFailedApplicationsMutex = g_mutex_new();
+  NSM__pStatePageMutex       = g_mutex_new();
+  NSM__pNsmcEventMutex       = g_mutex_new();
+  NSM__pSubscriptionMutex    = g_mutex_new();
+  NSM__pPersistMutex         = g_mutex_new();
 }
 
 
@@ -2365,6 +5610,11 @@ static void NSM__vDeleteMutexes(void)
   g_mutex_free(NSM__pNextApplicationModeMutex);
   g_mutex_free(NSM__pThisApplicationModeMutex);
   g_mutex_free(NSM__pSessionMutex);
+  g_mutex_free(NSM__pFailedApplicationsMutex);
+  g_mutex_free(NSM__pStatePageMutex);
+  g_mutex_free(NSM__pNsmcEventMutex);
+  g_mutex_free(NSM__pSubscriptionMutex);
+  g_mutex_free(NSM__pPersistMutex);
 }
 
 
@@ -2392,6 +5642,18 @@ static void NSM__vLtProf(gchar *sBus, gchar *sObj, guint32 u32Reason, gchar *sIn
         {
           g_strlcat(pszLtprof, "runup", dwLength);
         }
+        else if(u32Reason == NSM_SHUTDOWNTYPE_RESUME)
+        {
+          g_strlcat(pszLtprof, "resume", dwLength);
+        }
+        else if(u32Reason == NSM_SHUTDOWNTYPE_SUSPEND)
+        {
+          g_strlcat(pszLtprof, "suspend", dwLength);
+        }
+        else if(u32Reason == NSM_SHUTDOWNTYPE_DEGRADE)
+        {
+          g_strlcat(pszLtprof, "degrade", dwLength);
+        }
         else
         {
           g_strlcat(pszLtprof, "shutdown", dwLength);
@@ -2437,6 +5699,9 @@ NsmErrorStatus_e NsmSetData(NsmDataType_e enData, unsigned char *pData, unsigned
   /* Function local variables                                        */
   NsmErrorStatus_e enRetVal = NsmErrorStatus_NotSet; /* Return value */
 
+  /* A snapshot of NsmGetDataMulti must not observe the change half done */
+  g_static_rec_mutex_lock(&NSM__stNsmcDataMutex);
+
   /* Check which data the NSMC wants to set */
   switch(enData)
   {
@@ -2497,6 +5762,220 @@ NsmErrorStatus_e NsmSetData(NsmDataType_e enData, unsigned char *pData, unsigned
     break;
   }
 
+  g_static_rec_mutex_unlock(&NSM__stNsmcDataMutex);
+
+  return enRetVal;
+}
+
+
+/* The function is called by the NodeStateMachine to set several "properties" of the NSM at once. */
+NsmErrorStatus_e NsmSetDataBatch(NsmDataEntry_s *pstEntries, unsigned int u32Entries)
+{
+  /* Function local variables                                                                      */
+  NsmErrorStatus_e      enRetVal           = NsmErrorStatus_NotSet; /* Return value               */
+  guint                 u32EntryIdx        = 0;
+  NsmDataEntry_s       *pstEntry           = NULL;
+  NsmDataEntry_s      **ppstSlot           = NULL;                  /* Slot of the entry's type   */
+  gboolean              boValid            = FALSE;
+  NsmDataEntry_s       *pstShutdownReason  = NULL;                  /* Valid entries by type      */
+  NsmDataEntry_s       *pstBootMode        = NULL;
+  NsmDataEntry_s       *pstAppMode         = NULL;
+  NsmDataEntry_s       *pstNodeState       = NULL;
+  gboolean              boChanged          = FALSE;                 /* Publish afterwards         */
+  gboolean              boAppModeChanged   = FALSE;
+  gboolean              boNodeStateChanged = FALSE;
+  NsmShutdownReason_e   enShutdownReason   = NsmShutdownReason_NotSet;  /* Values of the batch     */
+  NsmShutdownReason_e   enPrevReason       = NsmShutdownReason_NotSet;  /* Values before the batch */
+  gint                  i32BootMode        = 0;
+  gint                  i32PrevBootMode    = 0;
+  NsmApplicationMode_e  enAppMode          = NsmApplicationMode_NotSet;
+  NsmNodeState_e        enNodeState        = NsmNodeState_NotSet;
+  NsmNodeState_e        enOldNodeState     = NsmNodeState_NotSet;
+
+  /* Validate all entries, before anything is applied */
+  if((pstEntries != NULL) && (u32Entries > 0))
+  {
+    enRetVal = NsmErrorStatus_Ok;
+
+    for(u32EntryIdx = 0; u32EntryIdx < u32Entries; u32EntryIdx++)
+    {
+      pstEntry = &pstEntries[u32EntryIdx];
+      ppstSlot = NULL;
+      boValid  = FALSE;
+
+      /* Check the length and the range of the data. Without data, the entry is invalid */
+      if(pstEntry->pData != NULL)
+      {
+        switch(pstEntry->enData)
+        {
+          case NsmDataType_ShutdownReason:
+            ppstSlot = &pstShutdownReason;
+            boValid  =    (pstEntry->u32DataLen == sizeof(NsmShutdownReason_e))
+                       && (*((NsmShutdownReason_e*) pstEntry->pData) > NsmShutdownReason_NotSet)
+                       && (*((NsmShutdownReason_e*) pstEntry->pData) < NsmShutdownReason_Last  );
+          break;
+
+          case NsmDataType_BootMode:
+            ppstSlot = &pstBootMode;
+            boValid  = (pstEntry->u32DataLen == sizeof(gint));
+          break;
+
+          case NsmDataType_AppMode:
+            ppstSlot = &pstAppMode;
+            boValid  =    (pstEntry->u32DataLen == sizeof(NsmApplicationMode_e))
+                       && (*((NsmApplicationMode_e*) pstEntry->pData) > NsmApplicationMode_NotSet)
+                       && (*((NsmApplicationMode_e*) pstEntry->pData) < NsmApplicationMode_Last  );
+          break;
+
+          case NsmDataType_NodeState:
+            ppstSlot = &pstNodeState;
+            boValid  =    (pstEntry->u32DataLen == sizeof(NsmNodeState_e))
+                       && (*((NsmNodeState_e*) pstEntry->pData) > NsmNodeState_NotSet)
+                       && (*((NsmNodeState_e*) pstEntry->pData) < NsmNodeState_Last  );
+          break;
+
+          /* Sessions are not part of a batch. Their setters can fail after the validation */
+          default:
+            boValid = FALSE;
+          break;
+        }
+      }
+
+      /* Every type may only occur once */
+      if((boValid == TRUE) && (*ppstSlot == NULL))
+      {
+        *ppstSlot           = pstEntry;
+        pstEntry->i32Result = 0;
+      }
+      else
+      {
+        pstEntry->i32Result = -1;
+        enRetVal            = NsmErrorStatus_Parameter;
+      }
+    }
+  }
+  else
+  {
+    enRetVal = NsmErrorStatus_Parameter;
+  }
+
+  if(enRetVal == NsmErrorStatus_Ok)
+  {
+    /* All values are valid. Assign them under the locks, so that NsmGetDataMulti sees all or none of them.
+     * Lock order: NSMC data, then ApplicationMode and NodeState.
+     */
+    g_static_rec_mutex_lock(&NSM__stNsmcDataMutex);
+
+    if(pstShutdownReason != NULL)
+    {
+      enShutdownReason = *((NsmShutdownReason_e*) pstShutdownReason->pData);
+      (void) NSMA_boGetShutdownReason(&enPrevReason);
+
+      if(enShutdownReason != enPrevReason)
+      {
+        (void) NSMA_boSetShutdownReason(enShutdownReason);
+        boChanged = TRUE;
+      }
+    }
+
+    if(pstBootMode != NULL)
+    {
+      i32BootMode = *((gint*) pstBootMode->pData);
+      (void) NSMA_boGetBootMode(&i32PrevBootMode);
+
+      if(i32BootMode != i32PrevBootMode)
+      {
+        (void) NSMA_boSetBootMode(i32BootMode);
+        boChanged = TRUE;
+      }
+    }
+
+    if(pstAppMode != NULL)
+    {
+      enAppMode = *((NsmApplicationMode_e*) pstAppMode->pData);
+      g_mutex_lock(NSM__pNextApplicationModeMutex);
+
+      if(NSM__enNextApplicationMode != enAppMode)
+      {
+        NSM__enNextApplicationMode = enAppMode;
+        boAppModeChanged           = TRUE;
+
+        /* Hand the new value to the persistence worker. The PCL is not accessed under the lock */
+        NSM__vPersistApplicationMode(enAppMode);
+      }
+
+      g_mutex_unlock(NSM__pNextApplicationModeMutex);
+    }
+
+    /* The NodeState is assigned last, because it can start a lifecycle sequence */
+    if(pstNodeState != NULL)
+    {
+      enNodeState = *((NsmNodeState_e*) pstNodeState->pData);
+      g_mutex_lock(NSM__pNodeStateMutex);
+
+      if(NSM__enNodeState != enNodeState)
+      {
+        NSM__vMeasureResume(NSM__enNodeState, enNodeState);
+
+        enOldNodeState           = NSM__enNodeState;
+        NSM__enPreviousNodeState = NSM__enNodeState;
+        g_atomic_int_set((gint*) &NSM__enNodeState, (gint) enNodeState);
+        boNodeStateChanged       = TRUE;
+      }
+
+      g_mutex_unlock(NSM__pNodeStateMutex);
+    }
+
+    g_static_rec_mutex_unlock(&NSM__stNsmcDataMutex);
+
+    /* Publish the complete batch once, after the locks have been released. The NSMC set the values itself. */
+    if(boAppModeChanged == TRUE)
+    {
+      (void) NSMA_boSendApplicationModeSignal(enAppMode);
+    }
+
+    if(boNodeStateChanged == TRUE)
+    {
+      (void) NSMA_boSendNodeStateSignal(enNodeState);
+    }
+
+    if((boChanged == TRUE) || (boAppModeChanged == TRUE) || (boNodeStateChanged == TRUE))
+    {
+      NSM__vUpdateStatePage();
+    }
+
+    if(boNodeStateChanged == TRUE)
+    {
+      DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Changed NodeState."                          ),
+                                        DLT_STRING(" Old NodeState: "), DLT_INT((gint) enOldNodeState),
+                                        DLT_STRING(" New NodeState: "), DLT_INT((gint) enNodeState   ));
+
+      /* The node can be switched off from now on. Write the last ApplicationMode through */
+      if(enNodeState == NsmNodeState_Shutdown)
+      {
+        NSM__vFlushPersistence();
+      }
+
+      /* Return the calls of clients, which wait for the new NodeState */
+      (void) NSMA_boCompleteNodeStateWaiters(enNodeState);
+
+      /* Check if a new life cycle request needs to be started based on the new ShutdownType */
+      if(NSM__u32PendingLifecycleRequests == 0)
+      {
+        NSM__vCallNextLifecycleClient();
+      }
+    }
+
+    DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Applied data batch."),
+                                      DLT_STRING("Entries:"), DLT_UINT(u32Entries     ),
+                                      DLT_STRING("Return:" ), DLT_INT((gint) enRetVal));
+  }
+  else
+  {
+    DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Failed to apply data batch. Invalid entry."),
+                                       DLT_STRING("Entries:"), DLT_UINT(u32Entries));
+  }
+
   return enRetVal;
 }
 
@@ -2598,6 +6077,131 @@ int NsmGetData(NsmDataType_e enData, unsigned char *pData, unsigned int u32DataL
 }
 
 
+/* The function is called by the NodeStateMachine to get several "properties" of the NSM from one snapshot. */
+int NsmGetDataMulti(NsmDataEntry_s *pstEntries, unsigned int u32Entries)
+{
+  /* Function local variables                                             */
+  int   i32RetVal   = -1; /* Return value. Positive: Amount of read items.
+                                           Negative: An error occurred.   */
+  guint u32EntryIdx = 0;
+
+  if(pstEntries != NULL)
+  {
+    i32RetVal = 0;
+
+    g_static_rec_mutex_lock(&NSM__stNsmcDataMutex);
+
+    for(u32EntryIdx = 0; u32EntryIdx < u32Entries; u32EntryIdx++)
+    {
+      pstEntries[u32EntryIdx].i32Result = NsmGetData(pstEntries[u32EntryIdx].enData,
+                                                     pstEntries[u32EntryIdx].pData,
+                                                     pstEntries[u32EntryIdx].u32DataLen);
+
+      i32RetVal += (pstEntries[u32EntryIdx].i32Result > 0) ? 1 : 0;
+    }
+
+    g_static_rec_mutex_unlock(&NSM__stNsmcDataMutex);
+  }
+
+  return i32RetVal;
+}
+
+
+/* The function is called by the NodeStateMachine to subscribe for changes of data of the NSM. */
+int NsmSubscribe(const NsmSubscription_s *pstSubscription)
+{
+  /* Function local variables                                               */
+  int   i32RetVal          = -1; /* Return value. Positive: Handle.
+                                                 Negative: An error occurred. */
+  guint u32SubscriptionIdx = 0;
+
+  if(   (pstSubscription != NULL)
+     && (   (pstSubscription->pfDataCallback      != NULL)
+         || (pstSubscription->pfNodeStateCallback != NULL)
+         || (pstSubscription->pfSessionCallback   != NULL)))
+  {
+    g_mutex_lock(NSM__pSubscriptionMutex);
+
+    for(u32SubscriptionIdx = 0; (i32RetVal < 0) && (u32SubscriptionIdx < NSM_MAX_SUBSCRIPTIONS); u32SubscriptionIdx++)
+    {
+      if(NSM__astSubscriptions[u32SubscriptionIdx].boUsed == FALSE)
+      {
+        NSM__astSubscriptions[u32SubscriptionIdx].boUsed         = TRUE;
+        NSM__astSubscriptions[u32SubscriptionIdx].stSubscription = *pstSubscription;
+        NSM__astSubscriptions[u32SubscriptionIdx].stSubscription.sSessionName[NSM_MAX_SESSION_NAME_LENGTH - 1] = '\0';
+
+        /* Compile the session name. A hash of 0 stands for all sessions */
+        NSM__astSubscriptions[u32SubscriptionIdx].u32SessionHash =
+          (pstSubscription->sSessionName[0] != '\0')
+          ? (g_str_hash(NSM__astSubscriptions[u32SubscriptionIdx].stSubscription.sSessionName) | 0x01)
+          : 0;
+
+        i32RetVal = (int) u32SubscriptionIdx + 1;
+      }
+    }
+
+    NSM__vCompileSubscriptionFilter();
+
+    g_mutex_unlock(NSM__pSubscriptionMutex);
+  }
+
+  DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: NSMC subscribed."), DLT_STRING("Handle:"), DLT_INT(i32RetVal));
+
+  return i32RetVal;
+}
+
+
+/* The function is called by the NodeStateMachine to remove a subscription. */
+NsmErrorStatus_e NsmUnsubscribe(int i32Handle)
+{
+  /* Function local variables                                        */
+  NsmErrorStatus_e enRetVal = NsmErrorStatus_NotSet; /* Return value */
+
+  if((i32Handle > 0) && (i32Handle <= NSM_MAX_SUBSCRIPTIONS))
+  {
+    g_mutex_lock(NSM__pSubscriptionMutex);
+
+    if(NSM__astSubscriptions[i32Handle - 1].boUsed == TRUE)
+    {
+      memset(&NSM__astSubscriptions[i32Handle - 1], 0, sizeof(NSM__tstSubscription));
+      NSM__vCompileSubscriptionFilter();
+      enRetVal = NsmErrorStatus_Ok;
+    }
+    else
+    {
+      enRetVal = NsmErrorStatus_Parameter;
+    }
+
+    g_mutex_unlock(NSM__pSubscriptionMutex);
+  }
+  else
+  {
+    enRetVal = NsmErrorStatus_Parameter;
+  }
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function logs the end of a start up phase with the time since the start of the NSM.
+*
+* @param sPhase: Name of the phase
+*
+**********************************************************************************************************************/
+static void NSM__vLogStartupPhase(const gchar *sPhase)
+{
+  guint u32TimeUs = (guint) (g_get_monotonic_time() - NSM__i64StartupTime);
+
+  DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Start up phase finished."),
+                                    DLT_STRING(" Phase: "),     DLT_STRING(sPhase),
+                                    DLT_STRING(" Time (us): "), DLT_UINT(u32TimeUs));
+
+  syslog(LOG_NOTICE, "LTPROF: startup %s: %u us", sPhase, u32TimeUs);
+}
+
+
 unsigned int NsmGetInterfaceVersion(void)
 {
 	return NSM_INTERFACE_VERSION;
@@ -2610,6 +6214,9 @@ int main(void)
   gboolean  boEndByUser = FALSE;
   int       pcl_return  = 0;
 
+  /* The start up phases are measured from here */
+  NSM__i64StartupTime = g_get_monotonic_time();
+
   /* Initialize glib for using "g" types */
   g_type_init();
 
@@ -2624,45 +6231,78 @@ int main(void)
   /* Print first msg. to show that NSM is going to start */
   DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: NodeStateManager started."), DLT_STRING("Version:"), DLT_STRING(VERSION));
 
-  /* Initialize PCL before initializing variables */
-  pcl_return = pclInitLibrary("NodeStateManager",   PCL_SHUTDOWN_TYPE_NORMAL
-                                                  | PCL_SHUTDOWN_TYPE_FAST);
-  if(pcl_return < 0)
-  {
-    DLT_LOG(NsmContext,
-            DLT_LOG_WARN,
-            DLT_STRING("NSM: Failed to initialize PCL.");
-            DLT_STRING("Error: Unexpected PCL return.");
-            DLT_STRING("Return:"); DLT_INT(pcl_return));
-  }
-
   /* Currently no other resources accessing the NSM. Prepare it now! */
   NSM__vInitializeVariables();     /* Initialize file local variables*/
   NSM__vCreatePlatformSessions();  /* Create platform sessions       */
   NSM__vCreateMutexes();           /* Create mutexes                 */
 
+  /* Map the snapshot and restore sessions and failed applications of a previous instance, before they are published */
+  NSM__vReadHandover();
+  NSM__vOpenSnapshot();
+  NSM__vRestoreSnapshot();
+  NSM__vApplyHandover();
+
+  /* Initialize the PCL and prefetch the persistent data in parallel to the NSMA and the bus name acquisition */
+  NSM__vStartPersistence();
+
+  /* A re-executed NSM takes the bus name over from the old instance */
+  (void) NSMA_boSetReplaceBusName(NSM__pstHandover != NULL);
+
   /* Initialize the NSMA before the NSMC, because the NSMC can access properties */
   if(NSMA_boInit(&NSM__stObjectCallBacks) == TRUE)
   {
-    /* Set the properties to initial values */
-    (void) NSMA_boSetBootMode(0);
-    (void) NSMA_boSetRestartReason(NsmRestartReason_NotSet);
-    (void) NSMA_boSetShutdownReason(NsmShutdownReason_NotSet);
-    (void) NSMA_boSetRunningReason(NsmRunningReason_WakeupCan);
+    NSM__vLogStartupPhase("NSMA initialized");
+
+    /* Set the properties to initial values or to the values of the old instance */
+    if(NSM__pstHandover != NULL)
+    {
+      (void) NSMA_boSetBootMode(NSM__pstHandover->i32BootMode);
+      (void) NSMA_boSetRestartReason((NsmRestartReason_e) NSM__pstHandover->i32RestartReason);
+      (void) NSMA_boSetShutdownReason((NsmShutdownReason_e) NSM__pstHandover->i32ShutdownReason);
+      (void) NSMA_boSetRunningReason((NsmRunningReason_e) NSM__pstHandover->i32RunningReason);
+    }
+    else
+    {
+      (void) NSMA_boSetBootMode(0);
+      (void) NSMA_boSetRestartReason(NsmRestartReason_NotSet);
+      (void) NSMA_boSetShutdownReason(NsmShutdownReason_NotSet);
+      (void) NSMA_boSetRunningReason(NsmRunningReason_WakeupCan);
+    }
+
+    /* Limit the calls per D-Bus client, before the bus name is owned */
+    NSM__vConfigureRateLimit();
+
+    /* Publish the initial values in the state page and the platform sessions, before clients can change them */
+    NSM__vOpenStatePage();
+    (void) NSM__boOnPublishSessions(NULL);
 
     /* Initialize/start the NSMC */
-    if(NsmcInit() == 0x01)
+    if((NSM__boLoadNsmc() == TRUE) && (NSM__stNsmc.pfInit() == 0x01))
     {
+      /* Pass the rings to the NSMC, if it implements the asynchronous interface */
+      NSM__vInitNsmcAsync();
+
+      NSM__vLogStartupPhase("NSMC initialized");
+
       /* Start timer to satisfy wdog */
       NSM__vConfigureWdogTimer();
       
       /* The event loop is only canceled if the Node is completely shut down or there is an internal error. */
       boEndByUser = NSMA_boWaitForEvents();
 
-      if(boEndByUser == TRUE)
+      if((boEndByUser == TRUE) && (NSM__boReexecStarted == TRUE))
+      {
+        /* The state has been handed over. The snapshot stays valid, in case the binary can not be executed */
+        DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Successfully canceled event loop. "),
+                                          DLT_STRING("Re-executing NodeStateManager."         ));
+      }
+      else if(boEndByUser == TRUE)
       {
         DLT_LOG(NsmContext, DLT_LOG_INFO, DLT_STRING("NSM: Successfully canceled event loop. "),
                                           DLT_STRING("Shutting down NodeStateManager."        ));
+
+        /* The NSM has been stopped on purpose. A new instance should not resume the state. */
+        NSM__vDiscardSnapshot();
       }
       else
       {
@@ -2686,6 +6326,15 @@ int main(void)
     DLT_LOG(NsmContext, DLT_LOG_ERROR, DLT_STRING("NSM: Error. Failed to initialize the NSMA."));
   }
 
+  /* Unmap the state page. The file stays, so that readers still see the last state */
+  NSM__vCloseStatePage();
+
+  /* Unmap the snapshot. If the NSM stopped by an error, a restarted instance restores from it */
+  NSM__vCloseSnapshot();
+
+  /* Write a pending ApplicationMode and end the persistence worker, before the PCL is deinitialized */
+  NSM__vStopPersistence();
+
   /* Free the mutexes */
   NSM__vDeleteMutexes();
 
@@ -2693,6 +6342,7 @@ int main(void)
   g_slist_free_full(NSM__pSessions,           &NSM__vFreeSessionObject);
   g_slist_free_full(NSM__pFailedApplications, &NSM__vFreeFailedApplicationObject);
   g_list_free_full (NSM__pLifecycleClients,   &NSM__vFreeLifecycleClientObject);
+  g_free(NSM__pstHandover);
 
   /* Deinitialize the PCL */
   pcl_return = pclDeinitLibrary();
@@ -2715,5 +6365,8 @@ int main(void)
   DLT_UNREGISTER_CONTEXT(NsmContext);
   DLT_UNREGISTER_APP();
 
+  /* Execute the new binary, if the state has been handed over. Only returns on error */
+  NSM__vReexec();
+
   return 0;
 }
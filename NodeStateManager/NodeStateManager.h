@@ -60,7 +60,10 @@ extern "C"
  *  The lower significant byte is equal 0 for released version only
  */
 
-#define NSM_INTERFACE_VERSION    0x01020100U
+#define NSM_INTERFACE_VERSION    0x01030000U
+
+/** Max. number of concurrent subscriptions of ::NsmSubscribe */
+#define NSM_MAX_SUBSCRIPTIONS    32
 
 /**********************************************************************************************************************
 *
@@ -68,7 +71,43 @@ extern "C"
 *
 **********************************************************************************************************************/
 
-/* There are no types defined here */
+/**
+ * The structure defines one data item for ::NsmSetDataBatch and ::NsmGetDataMulti.
+ */
+typedef struct _NsmDataEntry_s
+{
+  NsmDataType_e  enData;      /**< Type of the data (see ::NsmDataType_e)                               */
+  unsigned char *pData;       /**< Pointer to the data to set or to the memory where it should be stored */
+  unsigned int   u32DataLen;  /**< Length of the data (in byte)                                         */
+  int            i32Result;   /**< Out: Set: 0 or -1 for an invalid entry. Get: bytes written or -1     */
+} NsmDataEntry_s;
+
+
+/** Callback for the data types of a subscription. pData points to the new value of the type enData. */
+typedef void (*NsmDataCallback_f)(NsmDataType_e enData, const unsigned char *pData, unsigned int u32DataLen, void *pUserData);
+
+/** Callback for NodeState transitions of a subscription. */
+typedef void (*NsmNodeStateCallback_f)(NsmNodeState_e enOldNodeState, NsmNodeState_e enNewNodeState, void *pUserData);
+
+/** Callback for session state changes of a subscription. */
+typedef void (*NsmSessionCallback_f)(const NsmSession_s *pstSession, void *pUserData);
+
+
+/**
+ * The structure defines a subscription of ::NsmSubscribe. Every callback may be NULL.
+ */
+typedef struct _NsmSubscription_s
+{
+  unsigned int           u32DataMask;                        /**< NSM_DATATYPE_MASK() bits for pfDataCallback      */
+  NsmDataCallback_f      pfDataCallback;                     /**< Called for changes of the types in u32DataMask   */
+  unsigned int           u32FromNodeStateMask;               /**< NSM_NODESTATE_MASK() bits of the old NodeState   */
+  unsigned int           u32ToNodeStateMask;                 /**< NSM_NODESTATE_MASK() bits of the new NodeState   */
+  NsmNodeStateCallback_f pfNodeStateCallback;                /**< Called for transitions matching both masks       */
+  char                   sSessionName[NSM_MAX_SESSION_NAME_LENGTH]; /**< Session to observe. Empty: all sessions   */
+  unsigned int           u32SeatMask;                        /**< NSM_SEAT_MASK() bits of the seats to observe     */
+  NsmSessionCallback_f   pfSessionCallback;                  /**< Called for state changes of matching sessions    */
+  void                  *pUserData;                          /**< Passed to the callbacks                          */
+} NsmSubscription_s;
 
 /**********************************************************************************************************************
 *
@@ -106,6 +145,55 @@ This is a generic interface that can be used by the NSMc to read a specific data
 int NsmGetData(NsmDataType_e enData, unsigned char *pData, unsigned int u32DataLen);
 
 
+/** \brief Set several data items (properties) of the NodeStateManager at once.
+\param[in,out] pstEntries Array of the data items to set. The result of every entry is written to i32Result.
+\param[in]     u32Entries Number of entries in pstEntries.
+\retval NsmErrorStatus_Ok:        All data items have been set.
+        NsmErrorStatus_Parameter: An entry is invalid. No data item has been set.
+        See ::NsmErrorStatus_e for other values. No data item has been set.
+
+The batch supports NsmDataType_ShutdownReason, NsmDataType_BootMode, NsmDataType_AppMode and
+NsmDataType_NodeState. Every type may occur only once. All entries are validated first. Then they are assigned
+under one lock, without that ::NsmGetDataMulti can observe a part of the batch. The batch is published once
+afterwards: The signals for the ApplicationMode and the NodeState (in this order), the state page and the
+clients waiting for the NodeState. A new NodeState is applied last and can start a lifecycle sequence. */
+NsmErrorStatus_e NsmSetDataBatch(NsmDataEntry_s *pstEntries, unsigned int u32Entries);
+
+
+/** \brief Get several data items (properties) of the NodeStateManager from one snapshot.
+\param[in,out] pstEntries Array of the data items to get. The result of every entry is written to i32Result.
+\param[in]     u32Entries Number of entries in pstEntries.
+\retval     A positive value or zero indicates the number of entries that could be read.
+            A negative value indicates an error.
+
+The function supports the same data types as ::NsmGetData. The items are read under the lock, which is held while
+the NodeState, ApplicationMode, BootMode or ShutdownReason is changed, either by ::NsmSetData, ::NsmSetDataBatch or
+via D-Bus. These items are consistent. Session states are read one by one and may change between them. */
+int NsmGetDataMulti(NsmDataEntry_s *pstEntries, unsigned int u32Entries);
+
+
+/** \brief Subscribe for changes of data of the NodeStateManager.
+\param[in] pstSubscription Filters and callbacks of the subscription. The structure is copied.
+\retval     A positive value is the handle of the subscription.
+            A negative value indicates an error (no callback or too many subscriptions).
+
+A change that matches a subscription (data type, NodeState transition or session and seat) is passed to the callbacks
+of the matching subscriptions only. Once a data type is subscribed, its changes are no longer passed to NsmcSetData
+or the event ring. Changes of the type that no subscription matches are dropped. Changes of other types are passed to
+NsmcSetData as before. The filters of all subscriptions are compiled into bit masks, which are checked before
+a subscription is looked at. The callbacks are called in the thread that changed the data, after the NSM released
+its locks. They must return quickly. */
+int NsmSubscribe(const NsmSubscription_s *pstSubscription);
+
+
+/** \brief Remove a subscription.
+\param[in] i32Handle Handle returned by ::NsmSubscribe.
+\retval see ::NsmErrorStatus_e
+
+Running callbacks of the subscription may still complete after the function returned. */
+NsmErrorStatus_e NsmUnsubscribe(int i32Handle);
+
+
 /** \brief Get version of the interface
 \retval Version of the interface as defined in ::SswVersion_t
 
@@ -119,7 +207,11 @@ unsigned int NsmGetInterfaceVersion(void);
 *
 **********************************************************************************************************************/
 
-/* There are no macros defined */
+/** Bit of a data type in NsmSubscription_s.u32DataMask */
+#define NSM_DATATYPE_MASK(enData) (1U << (unsigned int) (enData))
+
+/** Bit of a seat in NsmSubscription_s.u32SeatMask */
+#define NSM_SEAT_MASK(enSeat)     (1U << (unsigned int) (enSeat))
 
 
 #ifdef __cplusplus
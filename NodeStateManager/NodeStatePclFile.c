@@ -0,0 +1,150 @@
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Implementation of the file-backed PCL stand-in. See header for a description.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+
+/**********************************************************************************************************************
+*
+* Header includes
+*
+**********************************************************************************************************************/
+
+#include "NodeStatePclFile.h"       /* Own header file                */
+#include <glib.h>                   /* File access, sleep             */
+#include <glib/gstdio.h>            /* g_mkdir_with_parents           */
+#include <stdlib.h>                 /* strtoul                        */
+#include <string.h>                 /* memcpy                         */
+
+
+/**********************************************************************************************************************
+*
+* Local variables
+*
+**********************************************************************************************************************/
+
+static gchar *NSMPF__sDir         = NULL;  /* Directory of the key files        */
+static guint  NSMPF__u32LatencyUs = 0;     /* Delay of every read and write (us) */
+
+
+/**********************************************************************************************************************
+*
+* Prototypes for file local functions (see implementation for description)
+*
+**********************************************************************************************************************/
+
+static gchar *NSMPF__sGetKeyFile(unsigned int ldbid, const char *resource_id, unsigned int user_no, unsigned int seat_no);
+
+
+/**********************************************************************************************************************
+*
+* Local (static) functions
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function returns the path of the file, where a key is stored. The result has to be freed with g_free().
+*
+**********************************************************************************************************************/
+static gchar *NSMPF__sGetKeyFile(unsigned int ldbid, const char *resource_id, unsigned int user_no, unsigned int seat_no)
+{
+  gchar *sFile = g_strdup_printf("%s/%02X_%u_%u_%s", NSMPF__sDir, ldbid, user_no, seat_no, resource_id);
+
+  return sFile;
+}
+
+
+/**********************************************************************************************************************
+*
+* Interfaces, exported functions. See header for detailed description.
+*
+**********************************************************************************************************************/
+
+int pclInitLibrary(const char *appname, int shutdownMode)
+{
+  int          iRetVal   = 1;
+  const gchar *sDir      = g_getenv(NSM_PCL_FILE_ENV_DIR);
+  const gchar *sLatency  = g_getenv(NSM_PCL_FILE_ENV_LATENCY);
+
+  NSMPF__sDir         = g_strdup((sDir != NULL) ? sDir : NSM_PCL_FILE_DEFAULT_DIR);
+  NSMPF__u32LatencyUs = (sLatency != NULL) ? ((guint) strtoul(sLatency, NULL, 10) * 1000) : 0;
+
+  if(g_mkdir_with_parents(NSMPF__sDir, 0700) != 0)
+  {
+    iRetVal = -1;
+  }
+
+  return iRetVal;
+}
+
+
+int pclDeinitLibrary(void)
+{
+  g_free(NSMPF__sDir);
+  NSMPF__sDir = NULL;
+
+  return 1;
+}
+
+
+int pclKeyReadData(unsigned int ldbid, const char *resource_id, unsigned int user_no, unsigned int seat_no,
+                   unsigned char *buffer, int buffer_size)
+{
+  int     iRetVal  = -1;
+  gchar  *sFile    = NULL;
+  gchar  *sContent = NULL;
+  gsize   u32Len   = 0;
+
+  if((NSMPF__sDir != NULL) && (resource_id != NULL) && (buffer != NULL) && (buffer_size >= 0))
+  {
+    g_usleep(NSMPF__u32LatencyUs);
+
+    sFile = NSMPF__sGetKeyFile(ldbid, resource_id, user_no, seat_no);
+
+    if(g_file_get_contents(sFile, &sContent, &u32Len, NULL) == TRUE)
+    {
+      iRetVal = (int) MIN(u32Len, (gsize) buffer_size);
+      memcpy(buffer, sContent, (gsize) iRetVal);
+      g_free(sContent);
+    }
+
+    g_free(sFile);
+  }
+
+  return iRetVal;
+}
+
+
+int pclKeyWriteData(unsigned int ldbid, const char *resource_id, unsigned int user_no, unsigned int seat_no,
+                    unsigned char *buffer, int buffer_size)
+{
+  int     iRetVal = -1;
+  gchar  *sFile   = NULL;
+
+  if((NSMPF__sDir != NULL) && (resource_id != NULL) && (buffer != NULL) && (buffer_size >= 0))
+  {
+    g_usleep(NSMPF__u32LatencyUs);
+
+    sFile = NSMPF__sGetKeyFile(ldbid, resource_id, user_no, seat_no);
+
+    /* The content is written to a temporary file, which replaces the old one */
+    if(g_file_set_contents(sFile, (const gchar*) buffer, buffer_size, NULL) == TRUE)
+    {
+      iRetVal = buffer_size;
+    }
+
+    g_free(sFile);
+  }
+
+  return iRetVal;
+}
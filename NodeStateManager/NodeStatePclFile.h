@@ -0,0 +1,101 @@
+#ifndef NODESTATEPCLFILE_H
+#define NODESTATEPCLFILE_H
+
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* File-backed stand-in for the persistence client library (PCL).
+*
+* If the NSM is configured with "--enable-pcl-file", it uses these functions instead of the PCL. Every key is stored
+* in an own file in the directory NSM_PCL_FILE_DIR (default NSM_PCL_FILE_DEFAULT_DIR). Each read and write is
+* delayed by NSM_PCL_FILE_LATENCY_MS milliseconds (default 0), to simulate the latency of a flash device in tests.
+* Only the functions used by the NSM are offered.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+/** \ingroup SSW_LCS */
+/** \defgroup SSW_NSM_TEMPLATE Node State Manager
+ *  \{
+ */
+/** \defgroup SSW_NSM_PCLFILE File-backed PCL stand-in
+ *  \{
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**********************************************************************************************************************
+*
+*  CONSTANTS
+*
+**********************************************************************************************************************/
+
+/* Shutdown types passed to pclInitLibrary. The values are the ones of the PCL */
+#define PCL_SHUTDOWN_TYPE_NORMAL  1
+#define PCL_SHUTDOWN_TYPE_FAST    2
+
+#define NSM_PCL_FILE_ENV_DIR      "NSM_PCL_FILE_DIR"           /**< Directory of the key files           */
+#define NSM_PCL_FILE_ENV_LATENCY  "NSM_PCL_FILE_LATENCY_MS"    /**< Delay of every read and write        */
+#define NSM_PCL_FILE_DEFAULT_DIR  "/tmp/NodeStateManager.pcl"  /**< Used, if NSM_PCL_FILE_DIR is not set */
+
+/**********************************************************************************************************************
+*
+*  FUNCTION PROTOTYPES
+*
+**********************************************************************************************************************/
+
+/**
+ * \brief Creates the directory of the key files and reads the configured latency.
+ * \param appname Name of the application (not used)
+ * \param shutdownMode Shutdown types the application is registered for (not used)
+ * \return 1: Success. <0: The directory could not be created.
+ */
+int pclInitLibrary(const char *appname, int shutdownMode);
+
+/**
+ * \brief Deinitializes the stand-in.
+ * \return 1: Success
+ */
+int pclDeinitLibrary(void);
+
+/**
+ * \brief Reads the data of a key.
+ * \param ldbid Logical database ID
+ * \param resource_id Name of the key
+ * \param user_no User number
+ * \param seat_no Seat number
+ * \param buffer Buffer for the data
+ * \param buffer_size Size of the buffer
+ * \return Number of bytes read. <0: The key does not exist or could not be read.
+ */
+int pclKeyReadData(unsigned int ldbid, const char *resource_id, unsigned int user_no, unsigned int seat_no,
+                   unsigned char *buffer, int buffer_size);
+
+/**
+ * \brief Writes the data of a key. The file is replaced atomically.
+ * \param ldbid Logical database ID
+ * \param resource_id Name of the key
+ * \param user_no User number
+ * \param seat_no Seat number
+ * \param buffer Data to write
+ * \param buffer_size Size of the data
+ * \return Number of bytes written. <0: The key could not be written.
+ */
+int pclKeyWriteData(unsigned int ldbid, const char *resource_id, unsigned int user_no, unsigned int seat_no,
+                    unsigned char *buffer, int buffer_size);
+
+#ifdef __cplusplus
+}
+#endif
+/** \} */ /* End of SSW_NSM_PCLFILE    */
+/** \} */ /* End of SSW_NSM_TEMPLATE   */
+#endif /* NODESTATEPCLFILE_H */
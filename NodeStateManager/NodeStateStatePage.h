@@ -0,0 +1,310 @@
+#ifndef NODESTATESTATEPAGE_H
+#define NODESTATESTATEPAGE_H
+
+/**********************************************************************************************************************
+*
+* Copyright (C) 2012 Continental Automotive Systems, Inc.
+*
+* Author: Jean-Pierre.Bogler@continental-corporation.com
+*
+* Interface to read the state of the NSM from a shared memory page.
+*
+* The NSM mirrors the NodeState, the ApplicationMode, the reasons, the BootMode and the states of the sessions into
+* a file mapped page (NSM_STATE_PAGE_FILE). Clients can map the page read only and read the values without any IPC.
+* The page is protected by a sequence counter. It is odd, while the NSM updates the page. Readers copy the values
+* and retry, if the counter changed in between. The counter also is a futex word, which allows to wait for changes.
+*
+* The functions use syscall(). Clients compiled in a strict ISO C mode need to define _DEFAULT_SOURCE.
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/.
+*
+**********************************************************************************************************************/
+
+/** \ingroup SSW_LCS */
+/** \defgroup SSW_NSM_TEMPLATE Node State Manager
+ *  \{
+ */
+/** \defgroup SSW_NSM_STATEPAGE State page
+ *  \{
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**********************************************************************************************************************
+*
+*  HEADER FILE INCLUDES
+*
+**********************************************************************************************************************/
+
+#include "NodeStateTypes.h"  /* Types of the values in the page */
+#include <fcntl.h>           /* open()                          */
+#include <limits.h>          /* INT_MAX                         */
+#include <sched.h>           /* sched_yield()                   */
+#include <string.h>          /* memcpy(), strcmp()              */
+#include <time.h>            /* struct timespec                 */
+#include <unistd.h>          /* close(), syscall()              */
+#include <linux/futex.h>     /* FUTEX_WAIT, FUTEX_WAKE          */
+#include <sys/mman.h>        /* mmap(), munmap()                */
+#include <sys/stat.h>        /* fstat()                         */
+#include <sys/syscall.h>     /* SYS_futex                       */
+
+/**********************************************************************************************************************
+*
+*  CONSTANTS
+*
+**********************************************************************************************************************/
+
+#ifndef NSM_STATE_PAGE_FILE
+#define NSM_STATE_PAGE_FILE         "/run/NodeStateManager.state" /**< File, which is mapped as state page           */
+#endif
+
+#define NSM_STATE_PAGE_VERSION      1                             /**< Layout version. Changes when page changes     */
+#define NSM_STATE_PAGE_MAX_SESSIONS 128                           /**< Max. number of sessions stored in the page    */
+
+/**********************************************************************************************************************
+*
+*  TYPE
+*
+**********************************************************************************************************************/
+
+/**
+ * The structure defines the scalar values of the NSM, which are mirrored into the state page.
+ */
+typedef struct _NsmStatePageValues_s
+{
+  NsmNodeState_e       enNodeState;        /**< NodeState                                              */
+  NsmApplicationMode_e enApplicationMode;  /**< ApplicationMode of the current lifecycle. NotSet, until the
+                                                NSM has read it from the persistence                   */
+  int                  i32BootMode;        /**< BootMode                                               */
+  NsmRestartReason_e   enRestartReason;    /**< RestartReason                                          */
+  NsmShutdownReason_e  enShutdownReason;   /**< ShutdownReason                                         */
+  NsmRunningReason_e   enWakeUpReason;     /**< WakeUpReason (RunningReason)                           */
+} NsmStatePageValues_s;
+
+
+/**
+ * The structure defines a session, as it is stored in the state page.
+ */
+typedef struct _NsmStatePageSession_s
+{
+  char               sName[NSM_MAX_SESSION_NAME_LENGTH]; /**< Name  of the session                     */
+  NsmSeat_e          enSeat;                             /**< Seat  of the session                     */
+  NsmSessionState_e  enState;                            /**< State of the session                     */
+} NsmStatePageSession_s;
+
+
+/**
+ * The structure defines the layout of the state page.
+ */
+typedef struct _NsmStatePage_s
+{
+  volatile unsigned int  u32Sequence;                                /**< Odd while NSM writes. Futex word     */
+  unsigned int           u32Version;                                 /**< NSM_STATE_PAGE_VERSION               */
+  NsmStatePageValues_s   stValues;                                   /**< Scalar values of the NSM             */
+  unsigned int           u32SessionCount;                            /**< Number of valid entries in sessions  */
+  unsigned int           u32SessionsDropped;                         /**< Sessions, which did not fit in page  */
+  NsmStatePageSession_s  astSessions[NSM_STATE_PAGE_MAX_SESSIONS];   /**< Sessions known by the NSM            */
+} NsmStatePage_s;
+
+
+/**********************************************************************************************************************
+*
+*  GLOBAL FUNCTIONS
+*
+**********************************************************************************************************************/
+
+/**********************************************************************************************************************
+*
+* The function maps the state page of the NSM read only.
+*
+* @return Pointer to the page or NULL, if the page is not available or has an incompatible version.
+*
+**********************************************************************************************************************/
+static inline const NsmStatePage_s* NsmStatePageOpen(void)
+{
+  const NsmStatePage_s *pstPage = NULL;
+  void                 *pvMap   = MAP_FAILED;
+  struct stat           stStat;
+  int                   i32Fd   = open(NSM_STATE_PAGE_FILE, O_RDONLY);
+
+  if(i32Fd >= 0)
+  {
+    /* Only map the file, if it is big enough. Otherwise an access beyond its end would raise SIGBUS */
+    if(   (fstat(i32Fd, &stStat) == 0                              )
+       && (stStat.st_size        >= (off_t) sizeof(NsmStatePage_s)))
+    {
+      pvMap = mmap(NULL, sizeof(NsmStatePage_s), PROT_READ, MAP_SHARED, i32Fd, 0);
+    }
+
+    (void) close(i32Fd);
+
+    if(pvMap != MAP_FAILED)
+    {
+      pstPage = (const NsmStatePage_s*) pvMap;
+
+      if(pstPage->u32Version != NSM_STATE_PAGE_VERSION)
+      {
+        (void) munmap(pvMap, sizeof(NsmStatePage_s));
+        pstPage = NULL;
+      }
+    }
+  }
+
+  return pstPage;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function unmaps the state page.
+*
+* @param pstPage: Page returned by NsmStatePageOpen.
+*
+**********************************************************************************************************************/
+static inline void NsmStatePageClose(const NsmStatePage_s *pstPage)
+{
+  if(pstPage != NULL)
+  {
+    (void) munmap((void*) pstPage, sizeof(NsmStatePage_s));
+  }
+}
+
+
+/**********************************************************************************************************************
+*
+* The function reads a consistent copy of the scalar values of the page.
+*
+* @param pstPage:   Page returned by NsmStatePageOpen.
+* @param pstValues: Pointer, where the values should be copied to.
+*
+* @return Sequence of the page, the values belong to. Can be passed to NsmStatePageWait.
+*
+**********************************************************************************************************************/
+static inline unsigned int NsmStatePageRead(const NsmStatePage_s *pstPage, NsmStatePageValues_s *pstValues)
+{
+  unsigned int u32Sequence = 0;
+  unsigned int u32Check    = 0;
+
+  do
+  {
+    u32Sequence = pstPage->u32Sequence;
+
+    if((u32Sequence & 0x01) != 0)
+    {
+      /* The NSM currently writes. Give it the chance to finish. */
+      (void) sched_yield();
+      u32Check = u32Sequence + 1;
+    }
+    else
+    {
+      __sync_synchronize();
+      memcpy(pstValues, (const void*) &pstPage->stValues, sizeof(NsmStatePageValues_s));
+      __sync_synchronize();
+      u32Check = pstPage->u32Sequence;
+    }
+  } while(u32Check != u32Sequence);
+
+  return u32Sequence;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function reads the state of a session from the page.
+*
+* @param pstPage:      Page returned by NsmStatePageOpen.
+* @param sSessionName: Name of the session.
+* @param enSeatId:     Seat of the session.
+* @param penState:     Pointer, where the state should be stored.
+*
+* @return NsmErrorStatus_Ok:           Session found.
+*         NsmErrorStatus_WrongSession: Session is not known by the NSM.
+*         NsmErrorStatus_Error:        Session not found, but not all sessions fit into the page. Use D-Bus instead.
+*
+**********************************************************************************************************************/
+static inline NsmErrorStatus_e NsmStatePageGetSessionState(const NsmStatePage_s *pstPage,
+                                                           const char           *sSessionName,
+                                                           NsmSeat_e             enSeatId,
+                                                           NsmSessionState_e    *penState)
+{
+  NsmErrorStatus_e  enRetVal    = NsmErrorStatus_NotSet;
+  NsmSessionState_e enState     = NsmSessionState_Unregistered;
+  unsigned int      u32Sequence = 0;
+  unsigned int      u32Count    = 0;
+  unsigned int      u32Idx      = 0;
+
+  do
+  {
+    u32Sequence = pstPage->u32Sequence;
+
+    if((u32Sequence & 0x01) != 0)
+    {
+      (void) sched_yield();
+    }
+    else
+    {
+      __sync_synchronize();
+
+      enRetVal = (pstPage->u32SessionsDropped == 0) ? NsmErrorStatus_WrongSession : NsmErrorStatus_Error;
+      u32Count = pstPage->u32SessionCount;
+      u32Count = (u32Count < NSM_STATE_PAGE_MAX_SESSIONS) ? u32Count : NSM_STATE_PAGE_MAX_SESSIONS;
+
+      for(u32Idx = 0; (u32Idx < u32Count) && (enRetVal != NsmErrorStatus_Ok); u32Idx++)
+      {
+        if(   (pstPage->astSessions[u32Idx].enSeat == enSeatId)
+           && (strncmp(pstPage->astSessions[u32Idx].sName, sSessionName, NSM_MAX_SESSION_NAME_LENGTH) == 0))
+        {
+          enState  = pstPage->astSessions[u32Idx].enState;
+          enRetVal = NsmErrorStatus_Ok;
+        }
+      }
+
+      __sync_synchronize();
+    }
+  } while(((u32Sequence & 0x01) != 0) || (pstPage->u32Sequence != u32Sequence));
+
+  *penState = enState;
+
+  return enRetVal;
+}
+
+
+/**********************************************************************************************************************
+*
+* The function waits until the page changed.
+*
+* @param pstPage:      Page returned by NsmStatePageOpen.
+* @param u32Sequence:  Sequence returned by NsmStatePageRead.
+* @param u32TimeoutMs: Max. time to wait in ms.
+*
+* @return 1, if the page changed since u32Sequence. 0, if the timeout elapsed.
+*
+**********************************************************************************************************************/
+static inline int NsmStatePageWait(const NsmStatePage_s *pstPage, unsigned int u32Sequence, unsigned int u32TimeoutMs)
+{
+  struct timespec stTimeout;
+
+  stTimeout.tv_sec  = u32TimeoutMs / 1000;
+  stTimeout.tv_nsec = (long) (u32TimeoutMs % 1000) * 1000000L;
+
+  if(pstPage->u32Sequence == u32Sequence)
+  {
+    /* The page is shared between processes. Therefore, the futex must not be private. */
+    (void) syscall(SYS_futex, &pstPage->u32Sequence, FUTEX_WAIT, u32Sequence, &stTimeout, NULL, 0);
+  }
+
+  return (pstPage->u32Sequence != u32Sequence) ? 1 : 0;
+}
+
+
+#ifdef __cplusplus
+}
+#endif
+/** \} */ /* End of SSW_NSM_STATEPAGE */
+/** \} */ /* End of SSW_NSM_TEMPLATE   */
+#endif /* NODESTATESTATEPAGE_H */
@@ -56,6 +56,9 @@ extern "C"
 #define NSM_MAX_SESSION_NAME_LENGTH  256                       /**< Max. number of chars a session name can have     */
 #define NSM_MAX_SESSION_OWNER_LENGTH 256                       /**< Max. number of chars for name of session owner   */
 
+/* Bit of a NodeState in the mask passed to "WaitForNodeState" */
+#define NSM_NODESTATE_MASK(enNodeState) (1U << (unsigned int) (enNodeState))
+
 /*
  * Defines for shutdown handling as bit masks. Used to register for multiple shutdown types and as parameter to
  * inform clients about the shutdown type via the LifecycleConsumer interface.
@@ -63,6 +66,18 @@ extern "C"
 #define NSM_SHUTDOWNTYPE_NOT      0x00000000U                  /**< Client not registered for any shutdown           */
 #define NSM_SHUTDOWNTYPE_NORMAL   0x00000001U                  /**< Client registered for normal shutdown            */
 #define NSM_SHUTDOWNTYPE_FAST     0x00000002U                  /**< Client registered for fast shutdown              */
+#define NSM_SHUTDOWNTYPE_SUSPEND  0x00000004U                  /**< Client registered for suspend to RAM             */
+#define NSM_SHUTDOWNTYPE_RESUME   0x10000000U                  /**< The shutdown type "resume" can not be used for
+                                                                    registration. Clients which are registered for
+                                                                    and have been suspended, will automatically be
+                                                                    informed about the "resume", when the node leaves
+                                                                    the "Suspended" state.                          */
+#define NSM_SHUTDOWNTYPE_LUC      0x20000000U                  /**< Flag, which can be added to the registered modes.
+                                                                    Clients belonging to the 'Last user context' run
+                                                                    up in parallel, before other clients run up.    */
+#define NSM_SHUTDOWNTYPE_DEGRADE  0x40000000U                  /**< Client registered for load shedding. Clients are
+                                                                    informed, when the node enters "DegradedPower".
+                                                                    Registration via "RegisterLoadSheddingClient".  */
 #define NSM_SHUTDOWNTYPE_RUNUP    0x80000000U                  /**< The shutdown type "run up" can not be used for
                                                                     registration. Clients which are registered and
                                                                     have been shut down, will automatically be
@@ -90,7 +105,9 @@ typedef enum _NsmDataType_e
   NsmDataType_BootMode,                /**< A BootMode should be set or get         */
   NsmDataType_RunningReason,           /**< A RunningReason should be set or get    */
   NsmDataType_RegisterSession,         /**< A Session should be registered          */
-  NsmDataType_UnRegisterSession        /**< A Session should be unregistered        */
+  NsmDataType_UnRegisterSession,       /**< A Session should be unregistered        */
+  NsmDataType_AppHealth,               /**< The health of an app. changed (to NSMC) */
+  NsmDataType_ShutdownClient           /**< A shutdown client registered  (to NSMC) */
 } NsmDataType_e;
 
 
@@ -233,6 +250,8 @@ typedef enum _NsmNodeState_e
   NsmNodeState_FastShutdown,           /**< Fast shutdown active                                 */
   NsmNodeState_DegradedPower,          /**< Node is in degraded power state                      */
   NsmNodeState_Shutdown,               /**< Node is completely shut down                         */
+  NsmNodeState_Suspending,             /**< The system is preparing for suspend to RAM           */
+  NsmNodeState_Suspended,              /**< All clients are suspended. Node can enter suspend    */
   NsmNodeState_Last                    /**< Last valid entry to identify valid node states       */
 } NsmNodeState_e;
 
@@ -247,6 +266,24 @@ typedef struct _NsmSession_s
 } NsmSession_s, *pNsmSession_s;
 
 
+/** The type defines the health of an application. It is passed to the NSMC (NsmDataType_AppHealth) only.    */
+typedef struct _NsmAppHealth_s
+{
+  char               sAppName[NSM_MAX_SESSION_OWNER_LENGTH]; /**< Name of the application          */
+  unsigned int       u32Running;                             /**< 0: Failed. 1: Runs (again)       */
+} NsmAppHealth_s;
+
+
+/** The type defines a registered shutdown client. It is passed to the NSMC (NsmDataType_ShutdownClient) only. */
+typedef struct _NsmShutdownClient_s
+{
+  char               sBusName[NSM_MAX_SESSION_OWNER_LENGTH]; /**< Bus name of the client           */
+  char               sObjName[NSM_MAX_SESSION_NAME_LENGTH];   /**< Object path of the client        */
+  unsigned int       u32ShutdownMode;                        /**< Registered NSM_SHUTDOWNTYPE_*    */
+  unsigned int       u32TimeoutMs;                           /**< Timeout of the client in ms      */
+} NsmShutdownClient_s;
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,6 +3,9 @@
 export $(dbus-launch)
 export DBUS_SYSTEM_BUS_ADDRESS=$DBUS_SESSION_BUS_ADDRESS
 
+# NodeStateLoadTest needs an NSM, which admits the whole load
+unset NSM_RATE_LIMIT
+
 ./NodeStateManager/NodeStateManager > /dev/null 2>&1 &
 pid_nsm=$!
 
@@ -12,6 +15,24 @@ sleep 1
 ret_val=$?
 sleep 1
 
+# Seat shutdown time with and without a flood of session traffic
+if [ $ret_val -eq 0 ]; then
+  ./NodeStateMachineTest/NodeStateLoadTest
+  ret_val=$?
+fi
+
+# Live re-execution of the running NSM. Checks the handed over state and the service gap
+if [ $ret_val -eq 0 ]; then
+  ./NodeStateMachineTest/NodeStateReexec
+  ret_val=$?
+fi
+
+# Replay of a checked-in scenario. It ends with a shutdown, so it runs last on this NSM
+if [ $ret_val -eq 0 ]; then
+  ./NodeStateMachineTest/NodeStateReplay ./NodeStateMachineTest/NodeStateReplay.scenario 0 10
+  ret_val=$?
+fi
+
 # Terminate NSM
 kill -15 $pid_nsm
 
@@ -20,6 +41,21 @@ kill -15 $pid_nsm
 killerPid=$!
 wait $pid_nsm
 kill $killerPid
+
+# Restore of the NSM after a crash. The test starts the NSM itself
+if [ $ret_val -eq 0 ]; then
+  ./NodeStateMachineTest/NodeStateRestoreTest ./NodeStateManager/NodeStateManager
+  ret_val=$?
+fi
+
+# Loading of NSMC plugins via NSM_NSMC_PLUGIN. The test starts the NSM itself
+if [ $ret_val -eq 0 ]; then
+  ./NodeStateMachineTest/NodeStatePluginTest ./NodeStateManager/NodeStateManager                \
+                                             ./NodeStateMachineNull/.libs/NodeStateMachineNull.so \
+                                             ./NodeStateMachineNull/.libs/NodeStateMachineNullMismatch.so
+  ret_val=$?
+fi
+
 kill $DBUS_SESSION_BUS_PID
 
 exit $ret_val